@@ -13,6 +13,8 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include <stdarg.h>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
 
@@ -48,7 +50,11 @@ void DebuggerPrintf( char const* messageFormat, ... )
 	char messageLiteral[ MESSAGE_MAX_LENGTH ];
 	va_list variableArgumentList;
 	va_start( variableArgumentList, messageFormat );
+#if defined( PLATFORM_WINDOWS )
 	vsnprintf_s( messageLiteral, MESSAGE_MAX_LENGTH, _TRUNCATE, messageFormat, variableArgumentList );
+#else
+	vsnprintf( messageLiteral, MESSAGE_MAX_LENGTH, messageFormat, variableArgumentList );
+#endif
 	va_end( variableArgumentList );
 	messageLiteral[ MESSAGE_MAX_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -182,7 +188,7 @@ int SystemDialogue_YesNoCancel( std::string const& messageTitle, std::string con
 
 
 //-----------------------------------------------------------------------------------------------
-__declspec( noreturn ) void FatalError( char const* filePath, char const* functionName, int lineNum, std::string const& reasonForError, char const* conditionText )
+[[noreturn]] void FatalError( char const* filePath, char const* functionName, int lineNum, std::string const& reasonForError, char const* conditionText )
 {
 	std::string errorMessage = reasonForError;
 	if( reasonForError.empty() )
@@ -198,7 +204,11 @@ __declspec( noreturn ) void FatalError( char const* filePath, char const* functi
 	std::string fullMessageTitle = appName + " :: Error";
 	std::string fullMessageText = errorMessage;
 	fullMessageText += "\n\nThe application will now close.\n";
+#if defined( PLATFORM_WINDOWS )
 	bool isDebuggerPresent = (IsDebuggerPresent() == TRUE);
+#else
+	bool isDebuggerPresent = false;
+#endif
 	if( isDebuggerPresent )
 	{
 		fullMessageText += "\nDEBUGGER DETECTED!\nWould you like to break and debug?\n  (Yes=debug, No=quit)\n";
@@ -221,6 +231,7 @@ __declspec( noreturn ) void FatalError( char const* filePath, char const* functi
 	DebuggerPrintf( "%s(%d): %s\n", filePath, lineNum, errorMessage.c_str() ); // Use this specific format so Visual Studio users can double-click to jump to file-and-line of error
 	DebuggerPrintf( "==============================================================================\n\n" );
 
+#if defined( PLATFORM_WINDOWS )
 	if( isDebuggerPresent )
 	{
 		bool isAnswerYes = SystemDialogue_YesNo( fullMessageTitle, fullMessageText, MsgSeverityLevel::FATAL );
@@ -237,6 +248,10 @@ __declspec( noreturn ) void FatalError( char const* filePath, char const* functi
 	}
 
 	exit( 0 );
+#else
+	// No dialogue to show, and a console program has to fail with a non zero exit code
+	abort();
+#endif
 }
 
 
@@ -257,7 +272,11 @@ void RecoverableWarning( char const* filePath, char const* functionName, int lin
 	std::string fullMessageTitle = appName + " :: Warning";
 	std::string fullMessageText = errorMessage;
 
+#if defined( PLATFORM_WINDOWS )
 	bool isDebuggerPresent = (IsDebuggerPresent() == TRUE);
+#else
+	bool isDebuggerPresent = false;
+#endif
 	if( isDebuggerPresent )
 	{
 		fullMessageText += "\n\nDEBUGGER DETECTED!\nWould you like to continue running?\n  (Yes=continue, No=quit, Cancel=debug)\n";
@@ -284,6 +303,7 @@ void RecoverableWarning( char const* filePath, char const* functionName, int lin
 	DebuggerPrintf( "%s(%d): %s\n", filePath, lineNum, errorMessage.c_str() ); // Use this specific format so Visual Studio users can double-click to jump to file-and-line of error
 	DebuggerPrintf( "------------------------------------------------------------------------------\n\n" );
 
+#if defined( PLATFORM_WINDOWS )
 	if( isDebuggerPresent )
 	{
 		int answerCode = SystemDialogue_YesNoCancel( fullMessageTitle, fullMessageText, MsgSeverityLevel::WARNING );
@@ -306,6 +326,7 @@ void RecoverableWarning( char const* filePath, char const* functionName, int lin
 			exit( 0 );
 		}
 	}
+#endif
 }
 
 
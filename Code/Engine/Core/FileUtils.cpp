@@ -1,11 +1,25 @@
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cstdio>
 
-int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename)
+//fopen_s only exists with the Microsoft CRT
+static FILE* OpenFile(const std::string& filePath, const char* mode)
 {
+#if defined(_WIN32)
 	FILE* file = nullptr;
-	errno_t err = fopen_s(&file, filename.c_str(), "rb");
-	if (err == 0 && file) {
+	if (fopen_s(&file, filePath.c_str(), mode) != 0) {
+		return nullptr;
+	}
+	return file;
+#else
+	return fopen(filePath.c_str(), mode);
+#endif
+}
+
+int FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename)
+{
+	FILE* file = OpenFile(filename, "rb");
+	if (file) {
 		fseek(file, 0, SEEK_END);
 		long fileSize = ftell(file);
 		fseek(file, 0, SEEK_SET);
@@ -37,9 +51,8 @@ int FileReadToString(std::string& outString, const std::string& filename)
 
 bool FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& fileName)
 {
-	FILE* file;
-	errno_t err = fopen_s(&file, fileName.c_str(), "wb");
-	if (err == 0 && file) {
+	FILE* file = OpenFile(fileName, "wb");
+	if (file) {
 		size_t bytesWritten = fwrite(inBuffer.data(), 1, inBuffer.size(), file);
 		fclose(file);
 
@@ -59,9 +72,8 @@ bool FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& file
 
 bool DoesFileExistOnDisk(const std::string& filePath)
 {
-	FILE* file;
-	errno_t err = fopen_s(&file, filePath.c_str(), "rb");
-	if (err == 0 && file) {
+	FILE* file = OpenFile(filePath, "rb");
+	if (file) {
 		fclose(file);
 		return true;
 	}
@@ -5,6 +5,7 @@
 #include "Engine/Renderer/IndexBuffer.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/IntRange.hpp"
 #include <vector>
 
 struct GPUMeshConfig {
@@ -19,12 +20,17 @@ public:
 	GPUMesh(const GPUMeshConfig& config, const std::vector<VertexType>& vertices, bool isTriangleList = true);
 	~GPUMesh();
 	void UpdateVerticesData(const std::vector<VertexType>& vertices);
+	//Only uploads vertices m_min through m_max of every dirty range, which must be all that changed since the last update.
+	//The first one moves the vertices to a D3D11_USAGE_DEFAULT vertex buffer, which every update after it writes with UpdateSubresource
+	void UpdateVerticesData(const std::vector<VertexType>& vertices, const std::vector<IntRange>& dirtyRanges);
 	void Render() const;
 
 private:
 	GPUMeshConfig m_config;
 	VertexBuffer* m_vbo = nullptr;
 	IndexBuffer* m_ibo = nullptr;
+	bool m_isVBOUpdatedInRanges = false;
+	bool m_isTriangleList = true;
 
 	/*
 	//For debugging
@@ -38,7 +44,7 @@ private:
 };
 
 template<typename VertexType>
-GPUMesh<VertexType>::GPUMesh(const GPUMeshConfig& config, const std::vector<VertexType>& vertices, const std::vector<unsigned int>& indices, bool isTriangleList) : m_config(config), m_vertices(vertices), m_indices(indices)
+GPUMesh<VertexType>::GPUMesh(const GPUMeshConfig& config, const std::vector<VertexType>& vertices, const std::vector<unsigned int>& indices, bool isTriangleList) : m_config(config), m_vertices(vertices), m_indices(indices), m_isTriangleList(isTriangleList)
 {
 	m_vbo = config.m_renderer.CreateVertexBuffer(vertices.size() * sizeof(VertexType), sizeof(VertexType), Stringf("GPUMesh::m_vbo of %d vertices", (int)vertices.size()), isTriangleList);
 	m_ibo = config.m_renderer.CreateIndexBuffer(indices.size() * sizeof(unsigned int));
@@ -48,7 +54,7 @@ GPUMesh<VertexType>::GPUMesh(const GPUMeshConfig& config, const std::vector<Vert
 }
 
 template<typename VertexType>
-inline GPUMesh<VertexType>::GPUMesh(const GPUMeshConfig& config, const std::vector<VertexType>& vertices, bool isTriangleList) : m_config(config), m_vertices(vertices)
+inline GPUMesh<VertexType>::GPUMesh(const GPUMeshConfig& config, const std::vector<VertexType>& vertices, bool isTriangleList) : m_config(config), m_vertices(vertices), m_isTriangleList(isTriangleList)
 {
 	m_vbo = config.m_renderer.CreateVertexBuffer(vertices.size() * sizeof(VertexType), sizeof(VertexType), Stringf("GPUMesh::m_vbo of %d vertices", (int)vertices.size()), isTriangleList);
 	config.m_renderer.CopyCPUToGPU(vertices.data(), vertices.size() * sizeof(VertexType), sizeof(VertexType), m_vbo);
@@ -69,6 +75,22 @@ inline void GPUMesh<VertexType>::UpdateVerticesData(const std::vector<VertexType
 	m_config.m_renderer.CopyCPUToGPU(vertices.data(), vertices.size() * sizeof(VertexType), sizeof(VertexType), m_vbo);
 }
 
+template<typename VertexType>
+inline void GPUMesh<VertexType>::UpdateVerticesData(const std::vector<VertexType>& vertices, const std::vector<IntRange>& dirtyRanges)
+{
+	if (dirtyRanges.empty()) {
+		return;
+	}
+	if (!m_isVBOUpdatedInRanges) {
+		delete m_vbo;
+		m_vbo = m_config.m_renderer.CreateVertexBuffer(vertices.size() * sizeof(VertexType), sizeof(VertexType), Stringf("GPUMesh::m_vbo of %d vertices", (int)vertices.size()), m_isTriangleList, true);
+		m_config.m_renderer.CopyCPUToGPU(vertices.data(), vertices.size() * sizeof(VertexType), sizeof(VertexType), m_vbo);
+		m_isVBOUpdatedInRanges = true;
+		return;
+	}
+	m_config.m_renderer.CopyCPUToGPU(vertices.data(), sizeof(VertexType), dirtyRanges, m_vbo);
+}
+
 template<typename VertexType>
 void GPUMesh<VertexType>::Render() const
 {
@@ -0,0 +1,25 @@
+#pragma once
+#include <string>
+#include <cstdint>
+
+//Read only view of a whole file. The pages are loaded by the OS on first touch, so opening is cheap no matter the file size
+class MemoryMappedFile {
+public:
+	MemoryMappedFile() = default;
+	MemoryMappedFile(const MemoryMappedFile& copyFrom) = delete;
+	MemoryMappedFile& operator=(const MemoryMappedFile& copyFrom) = delete;
+	~MemoryMappedFile();
+
+	bool Open(const std::string& filePath);	//False if the file doesn't exist, is empty or can't be mapped
+	void Close();
+
+	bool IsOpen() const { return m_data != nullptr; };
+	const uint8_t* GetData() const { return m_data; };
+	size_t GetSize() const { return m_size; };
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+	void* m_fileHandle = nullptr;
+	void* m_mappingHandle = nullptr;
+};
@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <sstream>
 #include <iomanip>
+#include <cctype>
 
 
 //-----------------------------------------------------------------------------------------------
@@ -15,7 +16,11 @@ const std::string Stringf( char const* format, ... )
 	char textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH ];
 	va_list variableArgumentList;
 	va_start( variableArgumentList, format );
+#if defined( _WIN32 )
 	vsnprintf_s( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, _TRUNCATE, format, variableArgumentList );	
+#else
+	vsnprintf( textLiteral, STRINGF_STACK_LOCAL_TEMP_LENGTH, format, variableArgumentList );
+#endif
 	va_end( variableArgumentList );
 	textLiteral[ STRINGF_STACK_LOCAL_TEMP_LENGTH - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -33,7 +38,11 @@ const std::string Stringf( int maxLength, char const* format, ... )
 
 	va_list variableArgumentList;
 	va_start( variableArgumentList, format );
+#if defined( _WIN32 )
 	vsnprintf_s( textLiteral, maxLength, _TRUNCATE, format, variableArgumentList );	
+#else
+	vsnprintf( textLiteral, maxLength, format, variableArgumentList );
+#endif
 	va_end( variableArgumentList );
 	textLiteral[ maxLength - 1 ] = '\0'; // In case vsnprintf overran (doesn't auto-terminate)
 
@@ -156,4 +165,17 @@ int ConvertStringToInt(const std::string& text, bool& wasSuccessful)
 	}
 	wasSuccessful = (text.size() == pos);
 	return returnVal;
+}
+
+bool AreStringsEqualCaseInsensitive(const std::string& a, const std::string& b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t charIdx = 0; charIdx < a.size(); charIdx++) {
+		if (std::tolower((unsigned char)a[charIdx]) != std::tolower((unsigned char)b[charIdx])) {
+			return false;
+		}
+	}
+	return true;
 }
\ No newline at end of file
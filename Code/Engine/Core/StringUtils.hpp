@@ -15,4 +15,5 @@ std::string FormatFloatWithSign(float value);
 std::string RemoveAllSubstringsIfExists(const std::string& originalString, const std::string& substringToErase);
 void TrimString(std::string& stringToTrim, char delimiterToTrim);	//Removes any occurene of delimiter from the front and back of the string
 
-int ConvertStringToInt(const std::string& text, bool& wasSuccessful);
\ No newline at end of file
+int ConvertStringToInt(const std::string& text, bool& wasSuccessful);
+bool AreStringsEqualCaseInsensitive(const std::string& a, const std::string& b);	//ASCII only, unlike _stricmp it builds on every platform
\ No newline at end of file
@@ -4,10 +4,15 @@
 
 //-----------------------------------------------------------------------------------------------
 #include "Engine/Core/Time.hpp"
+#if defined( _WIN32 )
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
+#else
+#include <chrono>
+#endif
 
 
+#if defined( _WIN32 )
 //-----------------------------------------------------------------------------------------------
 double InitializeTime( LARGE_INTEGER& out_initialTime )
 {
@@ -30,5 +35,15 @@ double GetCurrentTimeSeconds()
 	double currentSeconds = static_cast< double >( elapsedCountsSinceInitialTime ) * secondsPerCount;
 	return currentSeconds;
 }
+#else
+//-----------------------------------------------------------------------------------------------
+// steady_clock is the monotonic counter QueryPerformanceCounter is on Windows
+//
+double GetCurrentTimeSeconds()
+{
+	static const std::chrono::steady_clock::time_point initialTime = std::chrono::steady_clock::now();
+	return std::chrono::duration< double >( std::chrono::steady_clock::now() - initialTime ).count();
+}
+#endif
 
 
@@ -8,9 +8,9 @@ FBXAnimManager::FBXAnimManager(FBXModel& fbxModel, Clock& parentClock): m_fbxMod
 	m_animClock.Pause();
 }
 
-std::vector<FBXPose>& FBXAnimManager::GetFBXPoseSequence()
+const std::vector<FBXPose>& FBXAnimManager::GetFBXPoseSequence() const
 {
-	return m_poseSequence;
+	return *m_poseSequence;
 }
 
 float FBXAnimManager::GetAnimStartTime() const
@@ -65,7 +65,8 @@ void FBXAnimManager::Update()
 	float lerpAlpha = 0.0f;
 	GetKeyframeIndexAndLerpAlphaFromElapsedTime(m_keyframeIdx0ToPlay, lerpAlpha);
 
-	unsigned int numPoseSequence = (unsigned int)m_poseSequence.size();
+	const std::vector<FBXPose>& poseSequence = *m_poseSequence;
+	unsigned int numPoseSequence = (unsigned int)poseSequence.size();
 	GUARANTEE_OR_DIE(numPoseSequence > 0, "m_poseSequence.size() == 0!");
 
 	if (m_keyframeIdx0ToPlay >= numPoseSequence - 1 || m_animClock.GetTotalSeconds() > m_fbxModel->GetAnimTimeSpan()) {
@@ -74,7 +75,8 @@ void FBXAnimManager::Update()
 		lerpAlpha = 0.0f;
 	}
 
-	m_poseForThisFrame.CopyFrom(FBXPose::LerpPoses(m_poseSequence[m_keyframeIdx0ToPlay], m_poseSequence[m_keyframeIdx0ToPlay + 1], lerpAlpha));
+	m_poseForThisFrame.CopyFrom(FBXPose::LerpPoses(poseSequence[m_keyframeIdx0ToPlay], poseSequence[m_keyframeIdx0ToPlay + 1], lerpAlpha));
+	m_poseForThisFrame.SetRootJoint(m_fbxModel->GetRootJoint());	//The shared poses might have been parsed for another copy
 
 	if (m_fbxModel->IsRootMotionXYFixed()) {
 		m_poseForThisFrame.FixRootMotionXY();
@@ -97,7 +99,7 @@ unsigned int FBXAnimManager::GetAnimFPS() const
 
 bool FBXAnimManager::HasAnimationData() const
 {
-	return m_poseSequence.size() != 0;
+	return m_poseSequence->size() != 0;
 }
 
 const FBXPose& FBXAnimManager::GetPoseForThisFrame() const
@@ -116,10 +118,11 @@ void FBXAnimManager::SetAnimDataFromParser(float animStartTime, float animEndTim
 	m_animEndTime = animEndTime;
 	m_animTimeMode = animTimeMode;
 
-	m_poseSequence.resize(poseSequence.size());
-	for (int i = 0; i < m_poseSequence.size(); i++) {
-		m_poseSequence[i].CopyFrom(poseSequence[i]);
+	std::shared_ptr<std::vector<FBXPose>> newPoseSequence = std::make_shared<std::vector<FBXPose>>(poseSequence.size());
+	for (int i = 0; i < newPoseSequence->size(); i++) {
+		(*newPoseSequence)[i].CopyFrom(poseSequence[i]);
 	}
+	m_poseSequence = newPoseSequence;
 }
 
 bool FBXAnimManager::IsActive() const
@@ -132,11 +135,7 @@ FBXAnimManager* FBXAnimManager::CreateCopy() const
 	FBXAnimManager* copy = new FBXAnimManager(*m_fbxModel, *m_animClock.GetParent());
 	copy->m_isActivated = m_isActivated;
 	copy->m_isMotionMatching = m_isMotionMatching;
-	copy->m_poseSequence.resize(m_poseSequence.size());
-
-	for (int poseIdx = 0; poseIdx < m_poseSequence.size(); poseIdx++) {
-		copy->m_poseSequence[poseIdx].CopyFrom(m_poseSequence[poseIdx]);
-	}
+	copy->m_poseSequence = m_poseSequence;
 
 	copy->m_keyframeIdx0ToPlay = m_keyframeIdx0ToPlay;
 	copy->m_alpha = m_alpha;
@@ -157,6 +156,7 @@ FBXAnimManager* FBXAnimManager::CreateCopy() const
 void FBXAnimManager::SetFBXModel(FBXModel& model)
 {
 	m_fbxModel = &model;
+	m_poseForThisFrame.SetRootJoint(model.GetRootJoint());
 }
 
 void FBXAnimManager::GetKeyframeIndexAndLerpAlphaFromElapsedTime(unsigned int& out_keyframeIdx0, float& out_blendAlpha) const
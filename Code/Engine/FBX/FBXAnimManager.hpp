@@ -3,6 +3,7 @@
 #include "Engine/FBX/FBxPose.hpp"
 #include "ThirdParty/fbxsdk/fbxsdk.h"
 #include <vector>
+#include <memory>
 
 class FBXModel;
 
@@ -11,7 +12,7 @@ public:
 	FBXAnimManager(FBXModel& fbxModel, Clock& parentClock);
 	FBXAnimManager(const FBXAnimManager& rhs) = delete;
 
-	std::vector<FBXPose>& GetFBXPoseSequence();
+	const std::vector<FBXPose>& GetFBXPoseSequence() const;
 	float GetAnimStartTime() const;
 	float GetAnimEndTime() const;
 	FbxTime::EMode GetAnimTimeMode() const;
@@ -46,7 +47,7 @@ private:
 	bool m_isActivated = false;	//Model should toggle this on/off in FBXModel::ToggleAnimationMode();
 	bool m_isMotionMatching = false;	//There's two modes. Either play the animation from bvh, fbx. Or do motion matching
 
-	std::vector<FBXPose> m_poseSequence;
+	std::shared_ptr<const std::vector<FBXPose>> m_poseSequence = std::make_shared<const std::vector<FBXPose>>();	//Shared with every CreateCopy. Its poses keep the root joint of the model they were parsed for
 
 	FBXModel* m_fbxModel = nullptr;
 	
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+//Keys and payload checksums of the on disk caches (FBXDDMPrecomputeCache, FBXCookedModel).
+//xxHash64's round and avalanche over 8 byte words, though not its digest. Every word is multiplied and rotated on its own before it is folded in,
+//so no bit of the hash is a plain XOR of input bits and a mesh mirrored in x, which only flips sign bits, gets another key
+class FBXCacheHasher {
+public:
+	void Append(const void* data, size_t numBytes)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		size_t byteIdx = 0;
+		for (; byteIdx + 8 <= numBytes; byteIdx += 8) {
+			uint64_t word;
+			memcpy(&word, bytes + byteIdx, 8);
+			AppendWord(word);
+		}
+		for (; byteIdx < numBytes; byteIdx++) {
+			m_hash ^= bytes[byteIdx] * PRIME_5;
+			m_hash = RotateLeft(m_hash, 11) * PRIME_1;
+		}
+		AppendWord((uint64_t)numBytes);
+	}
+
+	template<typename T>
+	void AppendValue(const T& value)
+	{
+		Append(&value, sizeof(T));
+	}
+
+	uint64_t GetHash() const
+	{
+		uint64_t hash = m_hash;
+		hash ^= hash >> 33;
+		hash *= PRIME_2;
+		hash ^= hash >> 29;
+		hash *= PRIME_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+private:
+	static uint64_t RotateLeft(uint64_t value, int numBits)
+	{
+		return (value << numBits) | (value >> (64 - numBits));
+	}
+
+	void AppendWord(uint64_t word)
+	{
+		word *= PRIME_2;
+		word = RotateLeft(word, 31);
+		word *= PRIME_1;
+		m_hash ^= word;
+		m_hash = RotateLeft(m_hash, 27) * PRIME_1 + PRIME_4;
+	}
+
+private:
+	static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+	static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+	static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+	static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+	uint64_t m_hash = PRIME_5;
+};
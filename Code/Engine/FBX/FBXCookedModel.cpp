@@ -0,0 +1,485 @@
+#include "Engine/Fbx/FBXCookedModel.hpp"
+#include "Engine/Fbx/FBXCacheHasher.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+
+static constexpr char FBX_COOKED_MODEL_MAGIC[4] = { 'F', 'B', 'X', 'C' };
+
+struct FBXCookedModelHeader {
+	char m_magic[4];
+	uint32_t m_version = 0;
+	int32_t m_numJoints = 0;
+	int32_t m_numPoseJoints = 0;
+	int32_t m_numPoses = 0;
+	int32_t m_numMeshes = 0;
+	int32_t m_numTexturePaths = 0;
+	int32_t m_animTimeMode = 0;
+	float m_animStartTime = 0.0f;
+	float m_animEndTime = 0.0f;
+	FBXCookedStringRef m_sourceFileName;
+	uint64_t m_numStringBytes = 0;
+	uint64_t m_payloadNumBytes = 0;
+	uint64_t m_payloadChecksum = 0;
+};
+
+//Everything below is written as is and read in place from the mapped file
+static_assert(sizeof(FBXCookedModelHeader) == 72, "The header can't have compiler dependent padding");
+static_assert(sizeof(FBXCookedJoint) == 176, "FBXCookedJoint can't have compiler dependent padding");
+static_assert(sizeof(FBXCookedJointPose) == 48, "FBXCookedJointPose can't have compiler dependent padding");
+static_assert(sizeof(FBXCookedSkinWeights) == 32 && sizeof(FBXCookedMesh) == 216, "FBXCookedMesh can't have compiler dependent padding");
+static_assert(sizeof(FBXCookedJointWeightPair) == 8 && sizeof(FBXCookedStringRef) == 8, "Pairs and string refs are two 32 bit words");
+static_assert(sizeof(Vertex_FBX) == 128 && sizeof(Vec3) == 12, "Render vertices and control points are mapped straight into their arrays");
+static_assert(sizeof(unsigned int) == 4 && sizeof(int) == 4, "Indices are 32 bit on disk");
+
+//Byte offsets of the fixed sections after the header. The mesh arrays come after them, wherever their FBXCookedMesh says
+struct FBXCookedModelLayout {
+	size_t m_jointsOffset = 0;
+	size_t m_jointPosesOffset = 0;
+	size_t m_meshesOffset = 0;
+	size_t m_texturePathsOffset = 0;
+	size_t m_stringBytesOffset = 0;
+	size_t m_meshArraysOffset = 0;
+};
+
+static size_t AlignTo8Bytes(size_t numBytes)
+{
+	return (numBytes + 7) & ~(size_t)7;
+}
+
+static FBXCookedModelLayout GetFBXCookedModelLayout(const FBXCookedModelHeader& header)
+{
+	FBXCookedModelLayout layout;
+	layout.m_jointsOffset = 0;
+	layout.m_jointPosesOffset = AlignTo8Bytes(layout.m_jointsOffset + (size_t)header.m_numJoints * sizeof(FBXCookedJoint));
+	layout.m_meshesOffset = AlignTo8Bytes(layout.m_jointPosesOffset + (size_t)header.m_numPoses * (size_t)header.m_numPoseJoints * sizeof(FBXCookedJointPose));
+	layout.m_texturePathsOffset = AlignTo8Bytes(layout.m_meshesOffset + (size_t)header.m_numMeshes * sizeof(FBXCookedMesh));
+	layout.m_stringBytesOffset = AlignTo8Bytes(layout.m_texturePathsOffset + (size_t)header.m_numTexturePaths * sizeof(FBXCookedStringRef));
+	layout.m_meshArraysOffset = AlignTo8Bytes(layout.m_stringBytesOffset + header.m_numStringBytes);
+	return layout;
+}
+
+class FBXCookedModelWriter {
+public:
+	FBXCookedStringRef AppendString(const std::string& str)
+	{
+		FBXCookedStringRef stringRef;
+		stringRef.m_offset = (uint32_t)m_stringBytes.size();
+		stringRef.m_numChars = (uint32_t)str.size();
+		m_stringBytes.insert(m_stringBytes.end(), str.begin(), str.end());
+		return stringRef;
+	}
+
+	FBXCookedSkinWeights AppendSkinWeights(const FBXCookedSkinWeightsData& skinWeights)
+	{
+		FBXCookedSkinWeights cookedSkinWeights;
+		cookedSkinWeights.m_numWeights = (int32_t)skinWeights.m_weights.size();
+		cookedSkinWeights.m_rowStartsOffset = AppendMeshArray(skinWeights.m_rowStarts);
+		cookedSkinWeights.m_jointIndicesOffset = AppendMeshArray(skinWeights.m_jointIndices);
+		cookedSkinWeights.m_weightsOffset = AppendMeshArray(skinWeights.m_weights);
+		return cookedSkinWeights;
+	}
+
+	template<typename T>
+	uint64_t AppendMeshArray(const std::vector<T>& values)
+	{
+		uint64_t offset = AlignTo8Bytes(m_meshArrays.size());
+		m_meshArrays.resize(offset + values.size() * sizeof(T), 0);
+		if (!values.empty()) {
+			memcpy(m_meshArrays.data() + offset, values.data(), values.size() * sizeof(T));
+		}
+		return offset;
+	}
+
+public:
+	std::vector<char> m_stringBytes;
+	std::vector<uint8_t> m_meshArrays;	//Offsets are relative to these until the layout is known
+};
+
+bool SaveFBXCookedModel(const std::string& filePath, const FBXCookedModelData& data, std::string* errorStr)
+{
+	auto fail = [errorStr](const std::string& error) {
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+
+	int numJoints = (int)data.m_joints.size();
+	if ((int)data.m_jointNames.size() != numJoints) {
+		return fail(Stringf("%d joints whereas %d joint names", numJoints, (int)data.m_jointNames.size()));
+	}
+	if (data.m_numPoseJoints < 0 || data.m_numPoseJoints > numJoints || (data.m_numPoseJoints == 0 && !data.m_jointPoses.empty())
+		|| (data.m_numPoseJoints > 0 && data.m_jointPoses.size() % data.m_numPoseJoints != 0)) {
+		return fail(Stringf("%d joint poses don't split into poses of %d joints", (int)data.m_jointPoses.size(), data.m_numPoseJoints));
+	}
+
+	FBXCookedModelWriter writer;
+	FBXCookedStringRef sourceFileName = writer.AppendString(data.m_sourceFileName);
+	std::vector<FBXCookedJoint> joints = data.m_joints;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		joints[jointIdx].m_name = writer.AppendString(data.m_jointNames[jointIdx]);
+	}
+	std::vector<FBXCookedMesh> meshes(data.m_meshes.size());
+	std::vector<FBXCookedStringRef> texturePaths;
+	for (int meshIdx = 0; meshIdx < (int)data.m_meshes.size(); meshIdx++) {
+		const FBXCookedMeshData& meshData = data.m_meshes[meshIdx];
+		if (meshData.m_firstJointWeightPairIndices.size() != meshData.m_controlPoints.size() + 1 || meshData.m_faceControlPointIndices.size() % 3 != 0
+			|| meshData.m_renderVertexToControlPointMap.size() != meshData.m_renderVertices.size()
+			|| meshData.m_skinWeights.m_rowStarts.size() != meshData.m_controlPoints.size() + 1 || meshData.m_skinWeights.m_jointIndices.size() != meshData.m_skinWeights.m_weights.size()
+			|| meshData.m_rigidSkinWeights.m_rowStarts.size() != meshData.m_controlPoints.size() + 1 || meshData.m_rigidSkinWeights.m_jointIndices.size() != meshData.m_rigidSkinWeights.m_weights.size()) {
+			return fail(Stringf("Mesh %s has inconsistent array sizes", meshData.m_name.c_str()));
+		}
+		FBXCookedMesh& mesh = meshes[meshIdx];
+		mesh.m_name = writer.AppendString(meshData.m_name);
+		mesh.m_nodeIdx = meshData.m_nodeIdx;
+		mesh.m_numControlPoints = (int32_t)meshData.m_controlPoints.size();
+		mesh.m_numJointWeightPairs = (int32_t)meshData.m_jointWeightPairs.size();
+		mesh.m_numFaces = (int32_t)(meshData.m_faceControlPointIndices.size() / 3);
+		mesh.m_numRenderVertices = (int32_t)meshData.m_renderVertices.size();
+		mesh.m_numRenderIndices = (int32_t)meshData.m_renderIndices.size();
+		for (int slotIdx = 0; slotIdx < (int)FBXCookedTextureSlot::COUNT; slotIdx++) {
+			mesh.m_firstTexturePathIdx[slotIdx] = (uint32_t)texturePaths.size();
+			mesh.m_numTexturePaths[slotIdx] = (uint32_t)meshData.m_texturePaths[slotIdx].size();
+			for (const std::string& texturePath : meshData.m_texturePaths[slotIdx]) {
+				texturePaths.push_back(writer.AppendString(texturePath));
+			}
+		}
+		mesh.m_boundingBoxMins = meshData.m_boundingBoxMins;
+		mesh.m_boundingBoxMaxs = meshData.m_boundingBoxMaxs;
+		mesh.m_controlPointsOffset = writer.AppendMeshArray(meshData.m_controlPoints);
+		mesh.m_firstJointWeightPairIndicesOffset = writer.AppendMeshArray(meshData.m_firstJointWeightPairIndices);
+		mesh.m_jointWeightPairsOffset = writer.AppendMeshArray(meshData.m_jointWeightPairs);
+		mesh.m_faceControlPointIndicesOffset = writer.AppendMeshArray(meshData.m_faceControlPointIndices);
+		mesh.m_renderVerticesOffset = writer.AppendMeshArray(meshData.m_renderVertices);
+		mesh.m_renderIndicesOffset = writer.AppendMeshArray(meshData.m_renderIndices);
+		mesh.m_renderVertexToControlPointMapOffset = writer.AppendMeshArray(meshData.m_renderVertexToControlPointMap);
+		mesh.m_skinWeights = writer.AppendSkinWeights(meshData.m_skinWeights);
+		mesh.m_rigidSkinWeights = writer.AppendSkinWeights(meshData.m_rigidSkinWeights);
+	}
+	if (writer.m_stringBytes.size() > UINT32_MAX) {
+		return fail("Names and texture paths don't fit in 4GB");
+	}
+
+	FBXCookedModelHeader header;
+	memcpy(header.m_magic, FBX_COOKED_MODEL_MAGIC, sizeof(header.m_magic));
+	header.m_version = FBX_COOKED_MODEL_VERSION;
+	header.m_numJoints = numJoints;
+	header.m_numPoseJoints = data.m_numPoseJoints;
+	header.m_numPoses = data.m_numPoseJoints > 0 ? (int32_t)(data.m_jointPoses.size() / data.m_numPoseJoints) : 0;
+	header.m_numMeshes = (int32_t)meshes.size();
+	header.m_numTexturePaths = (int32_t)texturePaths.size();
+	header.m_animTimeMode = data.m_animTimeMode;
+	header.m_animStartTime = data.m_animStartTime;
+	header.m_animEndTime = data.m_animEndTime;
+	header.m_sourceFileName = sourceFileName;
+	header.m_numStringBytes = writer.m_stringBytes.size();
+	FBXCookedModelLayout layout = GetFBXCookedModelLayout(header);
+	header.m_payloadNumBytes = layout.m_meshArraysOffset + writer.m_meshArrays.size();
+	for (FBXCookedMesh& mesh : meshes) {
+		uint64_t* offsets[] = { &mesh.m_controlPointsOffset, &mesh.m_firstJointWeightPairIndicesOffset, &mesh.m_jointWeightPairsOffset, &mesh.m_faceControlPointIndicesOffset,
+			&mesh.m_renderVerticesOffset, &mesh.m_renderIndicesOffset, &mesh.m_renderVertexToControlPointMapOffset,
+			&mesh.m_skinWeights.m_rowStartsOffset, &mesh.m_skinWeights.m_jointIndicesOffset, &mesh.m_skinWeights.m_weightsOffset,
+			&mesh.m_rigidSkinWeights.m_rowStartsOffset, &mesh.m_rigidSkinWeights.m_jointIndicesOffset, &mesh.m_rigidSkinWeights.m_weightsOffset };
+		for (uint64_t* offset : offsets) {
+			*offset += layout.m_meshArraysOffset;
+		}
+	}
+
+	std::vector<uint8_t> buffer(sizeof(FBXCookedModelHeader) + header.m_payloadNumBytes, 0);
+	uint8_t* payload = buffer.data() + sizeof(FBXCookedModelHeader);
+	auto copyToPayload = [payload](size_t offset, const void* source, size_t numBytes) {
+		if (numBytes > 0) {
+			memcpy(payload + offset, source, numBytes);
+		}
+	};
+	copyToPayload(layout.m_jointsOffset, joints.data(), joints.size() * sizeof(FBXCookedJoint));
+	copyToPayload(layout.m_jointPosesOffset, data.m_jointPoses.data(), data.m_jointPoses.size() * sizeof(FBXCookedJointPose));
+	copyToPayload(layout.m_meshesOffset, meshes.data(), meshes.size() * sizeof(FBXCookedMesh));
+	copyToPayload(layout.m_texturePathsOffset, texturePaths.data(), texturePaths.size() * sizeof(FBXCookedStringRef));
+	copyToPayload(layout.m_stringBytesOffset, writer.m_stringBytes.data(), writer.m_stringBytes.size());
+	copyToPayload(layout.m_meshArraysOffset, writer.m_meshArrays.data(), writer.m_meshArrays.size());
+
+	FBXCacheHasher checksumHasher;
+	checksumHasher.Append(payload, header.m_payloadNumBytes);
+	header.m_payloadChecksum = checksumHasher.GetHash();
+	memcpy(buffer.data(), &header, sizeof(FBXCookedModelHeader));
+
+	std::error_code errorCode;
+	std::filesystem::path parentPath = std::filesystem::path(filePath).parent_path();
+	if (!parentPath.empty()) {
+		std::filesystem::create_directories(parentPath, errorCode);
+	}
+	std::string tempFilePath = filePath + ".tmp";
+	if (!FileWriteFromBuffer(buffer, tempFilePath)) {
+		return fail(Stringf("Unable to write %s", tempFilePath.c_str()));
+	}
+	std::remove(filePath.c_str());
+	if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0) {
+		std::remove(tempFilePath.c_str());
+		return fail(Stringf("Unable to rename %s to %s", tempFilePath.c_str(), filePath.c_str()));
+	}
+	return true;
+}
+
+bool FBXCookedModel::Load(const std::string& filePath, std::string* errorStr)
+{
+	Unload();
+	auto fail = [this, errorStr](const std::string& error) {
+		Unload();
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+
+	if (!m_file.Open(filePath)) {
+		return fail(Stringf("No cooked model %s", filePath.c_str()));
+	}
+	if (m_file.GetSize() < sizeof(FBXCookedModelHeader)) {
+		return fail("File is smaller than the header");
+	}
+
+	const FBXCookedModelHeader& header = *reinterpret_cast<const FBXCookedModelHeader*>(m_file.GetData());
+	if (memcmp(header.m_magic, FBX_COOKED_MODEL_MAGIC, sizeof(header.m_magic)) != 0) {
+		return fail("Not a cooked FBX model");
+	}
+	if (header.m_version != FBX_COOKED_MODEL_VERSION) {
+		return fail(Stringf("Cooked model version is %u whereas the current version is %u", header.m_version, FBX_COOKED_MODEL_VERSION));
+	}
+	if (header.m_numJoints < 0 || header.m_numPoseJoints < 0 || header.m_numPoses < 0 || header.m_numMeshes < 0 || header.m_numTexturePaths < 0
+		|| header.m_numPoseJoints > header.m_numJoints || header.m_numStringBytes > UINT32_MAX) {
+		return fail("Invalid counts in the header");
+	}
+	FBXCookedModelLayout layout = GetFBXCookedModelLayout(header);
+	uint64_t payloadNumBytes = m_file.GetSize() - sizeof(FBXCookedModelHeader);
+	if (header.m_payloadNumBytes != payloadNumBytes || payloadNumBytes < layout.m_meshArraysOffset) {
+		return fail(Stringf("File is %llu bytes whereas the header describes %llu bytes", (unsigned long long)m_file.GetSize(),
+			(unsigned long long)(sizeof(FBXCookedModelHeader) + header.m_payloadNumBytes)));
+	}
+
+	const uint8_t* payload = m_file.GetData() + sizeof(FBXCookedModelHeader);
+	FBXCacheHasher checksumHasher;
+	checksumHasher.Append(payload, payloadNumBytes);
+	if (checksumHasher.GetHash() != header.m_payloadChecksum) {
+		return fail("Payload checksum doesn't match");
+	}
+
+	//The only fixups: offsets become pointers into the mapping
+	m_header = &header;
+	m_payload = payload;
+	m_joints = reinterpret_cast<const FBXCookedJoint*>(payload + layout.m_jointsOffset);
+	m_jointPoses = reinterpret_cast<const FBXCookedJointPose*>(payload + layout.m_jointPosesOffset);
+	m_meshes = reinterpret_cast<const FBXCookedMesh*>(payload + layout.m_meshesOffset);
+	m_texturePaths = reinterpret_cast<const FBXCookedStringRef*>(payload + layout.m_texturePathsOffset);
+	m_stringBytes = reinterpret_cast<const char*>(payload + layout.m_stringBytesOffset);
+
+	//A matching checksum only rules out corruption, so every index still gets checked once here instead of on every use
+	auto isStringValid = [&header](const FBXCookedStringRef& stringRef) {
+		return (uint64_t)stringRef.m_offset + stringRef.m_numChars <= header.m_numStringBytes;
+	};
+	if (!isStringValid(header.m_sourceFileName)) {
+		return fail("Source file name is out of the string bytes");
+	}
+	for (int jointIdx = 0; jointIdx < header.m_numJoints; jointIdx++) {
+		const FBXCookedJoint& joint = m_joints[jointIdx];
+		if (joint.m_parentJointIdx < -1 || joint.m_parentJointIdx >= jointIdx || !isStringValid(joint.m_name)) {
+			return fail(Stringf("Joint %d has an invalid parent or name", jointIdx));
+		}
+	}
+	for (int texturePathIdx = 0; texturePathIdx < header.m_numTexturePaths; texturePathIdx++) {
+		if (!isStringValid(m_texturePaths[texturePathIdx])) {
+			return fail(Stringf("Texture path %d is out of the string bytes", texturePathIdx));
+		}
+	}
+
+	auto isArrayValid = [&](uint64_t offset, int32_t numValues, size_t valueNumBytes) {
+		return numValues >= 0 && offset % 8 == 0 && offset >= layout.m_meshArraysOffset && offset <= payloadNumBytes
+			&& (uint64_t)numValues * valueNumBytes <= payloadNumBytes - offset;
+	};
+	auto areSkinWeightArraysValid = [&](const FBXCookedSkinWeights& skinWeights, int32_t numControlPoints) {
+		return isArrayValid(skinWeights.m_rowStartsOffset, numControlPoints + 1, sizeof(int)) && isArrayValid(skinWeights.m_jointIndicesOffset, skinWeights.m_numWeights, sizeof(int))
+			&& isArrayValid(skinWeights.m_weightsOffset, skinWeights.m_numWeights, sizeof(double));
+	};
+	auto areSkinWeightIndicesValid = [&header](const FBXCookedSkinWeightsView& skinWeights, int numControlPoints) {
+		if (skinWeights.m_rowStarts[0] != 0 || skinWeights.m_rowStarts[numControlPoints] != skinWeights.m_numWeights) {
+			return false;
+		}
+		for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+			if (skinWeights.m_rowStarts[ctrlPointIdx] > skinWeights.m_rowStarts[ctrlPointIdx + 1]) {
+				return false;
+			}
+			for (int weightIdx = skinWeights.m_rowStarts[ctrlPointIdx]; weightIdx < skinWeights.m_rowStarts[ctrlPointIdx + 1]; weightIdx++) {
+				bool isAscending = weightIdx == skinWeights.m_rowStarts[ctrlPointIdx] || skinWeights.m_jointIndices[weightIdx - 1] < skinWeights.m_jointIndices[weightIdx];
+				if (skinWeights.m_jointIndices[weightIdx] < 0 || skinWeights.m_jointIndices[weightIdx] >= header.m_numJoints || !isAscending) {
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+	for (int meshIdx = 0; meshIdx < header.m_numMeshes; meshIdx++) {
+		const FBXCookedMesh& mesh = m_meshes[meshIdx];
+		bool areArraysValid = isStringValid(mesh.m_name)
+			&& isArrayValid(mesh.m_controlPointsOffset, mesh.m_numControlPoints, sizeof(Vec3))
+			&& isArrayValid(mesh.m_firstJointWeightPairIndicesOffset, mesh.m_numControlPoints + 1, sizeof(unsigned int))
+			&& isArrayValid(mesh.m_jointWeightPairsOffset, mesh.m_numJointWeightPairs, sizeof(FBXCookedJointWeightPair))
+			&& isArrayValid(mesh.m_faceControlPointIndicesOffset, mesh.m_numFaces, 3 * sizeof(int))
+			&& isArrayValid(mesh.m_renderVerticesOffset, mesh.m_numRenderVertices, sizeof(Vertex_FBX))
+			&& isArrayValid(mesh.m_renderIndicesOffset, mesh.m_numRenderIndices, sizeof(unsigned int))
+			&& isArrayValid(mesh.m_renderVertexToControlPointMapOffset, mesh.m_numRenderVertices, sizeof(unsigned int))
+			&& areSkinWeightArraysValid(mesh.m_skinWeights, mesh.m_numControlPoints) && areSkinWeightArraysValid(mesh.m_rigidSkinWeights, mesh.m_numControlPoints);
+		for (int slotIdx = 0; slotIdx < (int)FBXCookedTextureSlot::COUNT; slotIdx++) {
+			areArraysValid = areArraysValid && (uint64_t)mesh.m_firstTexturePathIdx[slotIdx] + mesh.m_numTexturePaths[slotIdx] <= (uint64_t)header.m_numTexturePaths;
+		}
+		if (!areArraysValid) {
+			return fail(Stringf("Mesh %d has arrays out of the payload", meshIdx));
+		}
+
+		FBXCookedMeshView meshView = GetMesh(meshIdx);
+		unsigned int numControlPoints = (unsigned int)mesh.m_numControlPoints;
+		bool areIndicesValid = meshView.m_firstJointWeightPairIndices[0] == 0 && meshView.m_firstJointWeightPairIndices[numControlPoints] == (unsigned int)mesh.m_numJointWeightPairs;
+		for (unsigned int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints && areIndicesValid; ctrlPointIdx++) {
+			areIndicesValid = meshView.m_firstJointWeightPairIndices[ctrlPointIdx] <= meshView.m_firstJointWeightPairIndices[ctrlPointIdx + 1];
+		}
+		for (int pairIdx = 0; pairIdx < mesh.m_numJointWeightPairs && areIndicesValid; pairIdx++) {
+			areIndicesValid = meshView.m_jointWeightPairs[pairIdx].m_jointIdx < (uint32_t)header.m_numJoints;
+		}
+		for (int cornerIdx = 0; cornerIdx < 3 * mesh.m_numFaces && areIndicesValid; cornerIdx++) {
+			areIndicesValid = (unsigned int)meshView.m_faceControlPointIndices[cornerIdx] < numControlPoints;
+		}
+		for (int indexIdx = 0; indexIdx < mesh.m_numRenderIndices && areIndicesValid; indexIdx++) {
+			areIndicesValid = meshView.m_renderIndices[indexIdx] < (unsigned int)mesh.m_numRenderVertices;
+		}
+		for (int renderVertexIdx = 0; renderVertexIdx < mesh.m_numRenderVertices && areIndicesValid; renderVertexIdx++) {
+			areIndicesValid = meshView.m_renderVertexToControlPointMap[renderVertexIdx] < numControlPoints;
+		}
+		areIndicesValid = areIndicesValid && areSkinWeightIndicesValid(meshView.m_skinWeights, mesh.m_numControlPoints) && areSkinWeightIndicesValid(meshView.m_rigidSkinWeights, mesh.m_numControlPoints);
+		if (!areIndicesValid) {
+			return fail(Stringf("Mesh %d has indices out of range", meshIdx));
+		}
+	}
+	return true;
+}
+
+void FBXCookedModel::Unload()
+{
+	m_file.Close();
+	m_header = nullptr;
+	m_payload = nullptr;
+	m_joints = nullptr;
+	m_jointPoses = nullptr;
+	m_meshes = nullptr;
+	m_texturePaths = nullptr;
+	m_stringBytes = nullptr;
+}
+
+bool FBXCookedModel::IsLoaded() const
+{
+	return m_header != nullptr;
+}
+
+size_t FBXCookedModel::GetNumBytes() const
+{
+	return m_file.GetSize();
+}
+
+int FBXCookedModel::GetNumJoints() const
+{
+	return m_header ? m_header->m_numJoints : 0;
+}
+
+const FBXCookedJoint& FBXCookedModel::GetJoint(int jointIdx) const
+{
+	GUARANTEE_OR_DIE(jointIdx >= 0 && jointIdx < GetNumJoints(), "jointIdx is out of range");
+	return m_joints[jointIdx];
+}
+
+std::string FBXCookedModel::GetString(const FBXCookedStringRef& stringRef) const
+{
+	GUARANTEE_OR_DIE(m_header != nullptr, "Cooked model isn't loaded");
+	return std::string(m_stringBytes + stringRef.m_offset, stringRef.m_numChars);
+}
+
+std::string FBXCookedModel::GetSourceFileName() const
+{
+	return GetString(m_header->m_sourceFileName);
+}
+
+int FBXCookedModel::GetAnimTimeMode() const
+{
+	return m_header ? m_header->m_animTimeMode : 0;
+}
+
+float FBXCookedModel::GetAnimStartTime() const
+{
+	return m_header ? m_header->m_animStartTime : 0.0f;
+}
+
+float FBXCookedModel::GetAnimEndTime() const
+{
+	return m_header ? m_header->m_animEndTime : 0.0f;
+}
+
+int FBXCookedModel::GetNumPoses() const
+{
+	return m_header ? m_header->m_numPoses : 0;
+}
+
+int FBXCookedModel::GetNumPoseJoints() const
+{
+	return m_header ? m_header->m_numPoseJoints : 0;
+}
+
+const FBXCookedJointPose* FBXCookedModel::GetPoseJoints(int poseIdx) const
+{
+	GUARANTEE_OR_DIE(poseIdx >= 0 && poseIdx < GetNumPoses(), "poseIdx is out of range");
+	return m_jointPoses + (size_t)poseIdx * m_header->m_numPoseJoints;
+}
+
+int FBXCookedModel::GetNumMeshes() const
+{
+	return m_header ? m_header->m_numMeshes : 0;
+}
+
+FBXCookedMeshView FBXCookedModel::GetMesh(int meshIdx) const
+{
+	GUARANTEE_OR_DIE(meshIdx >= 0 && meshIdx < GetNumMeshes(), "meshIdx is out of range");
+	const FBXCookedMesh& mesh = m_meshes[meshIdx];
+	FBXCookedMeshView meshView;
+	meshView.m_mesh = &mesh;
+	meshView.m_controlPoints = reinterpret_cast<const Vec3*>(m_payload + mesh.m_controlPointsOffset);
+	meshView.m_firstJointWeightPairIndices = reinterpret_cast<const unsigned int*>(m_payload + mesh.m_firstJointWeightPairIndicesOffset);
+	meshView.m_jointWeightPairs = reinterpret_cast<const FBXCookedJointWeightPair*>(m_payload + mesh.m_jointWeightPairsOffset);
+	meshView.m_faceControlPointIndices = reinterpret_cast<const int*>(m_payload + mesh.m_faceControlPointIndicesOffset);
+	meshView.m_renderVertices = reinterpret_cast<const Vertex_FBX*>(m_payload + mesh.m_renderVerticesOffset);
+	meshView.m_renderIndices = reinterpret_cast<const unsigned int*>(m_payload + mesh.m_renderIndicesOffset);
+	meshView.m_renderVertexToControlPointMap = reinterpret_cast<const unsigned int*>(m_payload + mesh.m_renderVertexToControlPointMapOffset);
+	meshView.m_skinWeights = GetSkinWeights(mesh.m_skinWeights);
+	meshView.m_rigidSkinWeights = GetSkinWeights(mesh.m_rigidSkinWeights);
+	return meshView;
+}
+
+FBXCookedSkinWeightsView FBXCookedModel::GetSkinWeights(const FBXCookedSkinWeights& skinWeights) const
+{
+	FBXCookedSkinWeightsView skinWeightsView;
+	skinWeightsView.m_numWeights = skinWeights.m_numWeights;
+	skinWeightsView.m_rowStarts = reinterpret_cast<const int*>(m_payload + skinWeights.m_rowStartsOffset);
+	skinWeightsView.m_jointIndices = reinterpret_cast<const int*>(m_payload + skinWeights.m_jointIndicesOffset);
+	skinWeightsView.m_weights = reinterpret_cast<const double*>(m_payload + skinWeights.m_weightsOffset);
+	return skinWeightsView;
+}
+
+std::vector<std::string> FBXCookedModel::GetTexturePaths(const FBXCookedMesh& mesh, FBXCookedTextureSlot slot) const
+{
+	std::vector<std::string> texturePaths;
+	int slotIdx = (int)slot;
+	texturePaths.reserve(mesh.m_numTexturePaths[slotIdx]);
+	for (uint32_t pathIdx = 0; pathIdx < mesh.m_numTexturePaths[slotIdx]; pathIdx++) {
+		texturePaths.push_back(GetString(m_texturePaths[mesh.m_firstTexturePathIdx[slotIdx] + pathIdx]));
+	}
+	return texturePaths;
+}
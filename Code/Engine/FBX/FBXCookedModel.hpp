@@ -0,0 +1,192 @@
+#pragma once
+#include "Engine/Core/MemoryMappedFile.hpp"
+#include "Engine/Fbx/Vertex_FBX.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+//Engine native cooked FBX models: everything FBXParser::ParseFile leaves behind (processed render vertices and indices of every FBXMesh, control points and their skin bindings,
+//the joint hierarchy and the animation poses) as flat arrays in one file. Loading maps the file and points into it, and nothing here includes fbxsdk.h
+
+constexpr uint32_t FBX_COOKED_MODEL_VERSION = 2;	//Bump whenever the file layout or what ParseFile produces changes
+
+enum class FBXCookedTextureSlot {
+	DIFFUSE,
+	SPECULAR,
+	NORMAL,
+	GLOSS,
+	AMBIENT,
+	COUNT
+};
+
+//The records below are written and mapped as is, so they only hold fixed size fields
+struct FBXCookedStringRef {
+	uint32_t m_offset = 0;	//Into the string bytes of the file
+	uint32_t m_numChars = 0;
+};
+
+struct FBXCookedJointWeightPair {
+	uint32_t m_jointIdx = 0;
+	float m_weight = 0.0f;
+};
+
+struct FBXCookedJointPose {	//One joint of one FBXPose
+	Vec4 m_localScaling;
+	Quaternion m_localQuat;
+	Vec4 m_localLoc;
+};
+
+struct FBXCookedJoint {
+	Mat44 m_globalBindPose;
+	Mat44 m_globalBindPoseInverse;
+	Quaternion m_originalLocalRotate;
+	Vec3 m_originalLocalTranslate;
+	int32_t m_parentJointIdx = -1;	//Joints are in the parser's depth first order, so a parent always comes first
+	uint32_t m_stencilRef = 0;
+	FBXCookedStringRef m_name;	//Filled in by SaveFBXCookedModel
+	uint8_t m_isRoot = 0;
+	uint8_t m_isEndJoint = 0;
+	uint8_t m_padding[2] = {};
+};
+
+struct FBXCookedSkinWeights {	//One DDMSkinWeights matrix in compressed rows, numControlPoints x numJoints
+	int32_t m_numWeights = 0;
+	uint32_t m_padding = 0;
+	uint64_t m_rowStartsOffset = 0;	//numControlPoints + 1 entries
+	uint64_t m_jointIndicesOffset = 0;	//Ascending within a row
+	uint64_t m_weightsOffset = 0;
+};
+
+struct FBXCookedMesh {
+	FBXCookedStringRef m_name;
+	int32_t m_nodeIdx = -1;
+	int32_t m_numControlPoints = 0;
+	int32_t m_numJointWeightPairs = 0;
+	int32_t m_numFaces = 0;
+	int32_t m_numRenderVertices = 0;
+	int32_t m_numRenderIndices = 0;
+	uint32_t m_firstTexturePathIdx[(int)FBXCookedTextureSlot::COUNT] = {};
+	uint32_t m_numTexturePaths[(int)FBXCookedTextureSlot::COUNT] = {};
+	Vec3 m_boundingBoxMins;
+	Vec3 m_boundingBoxMaxs;
+
+	//Byte offsets into the payload, 8 byte aligned
+	uint64_t m_controlPointsOffset = 0;
+	uint64_t m_firstJointWeightPairIndicesOffset = 0;
+	uint64_t m_jointWeightPairsOffset = 0;
+	uint64_t m_faceControlPointIndicesOffset = 0;
+	uint64_t m_renderVerticesOffset = 0;
+	uint64_t m_renderIndicesOffset = 0;
+	uint64_t m_renderVertexToControlPointMapOffset = 0;
+	FBXCookedSkinWeights m_skinWeights;
+	FBXCookedSkinWeights m_rigidSkinWeights;
+};
+
+struct FBXCookedSkinWeightsData {
+	std::vector<int> m_rowStarts;
+	std::vector<int> m_jointIndices;
+	std::vector<double> m_weights;
+};
+
+//What the parser fills in before cooking. Same arrays as the file, just owned
+struct FBXCookedMeshData {
+	std::string m_name;
+	int m_nodeIdx = -1;
+	std::vector<Vec3> m_controlPoints;
+	std::vector<unsigned int> m_firstJointWeightPairIndices;	//numControlPoints + 1 entries, the pairs of control point i are [first[i], first[i + 1])
+	std::vector<FBXCookedJointWeightPair> m_jointWeightPairs;
+	std::vector<int> m_faceControlPointIndices;	//3 per face, the rows of FBXMesh::m_facesMatrix
+	std::vector<Vertex_FBX> m_renderVertices;
+	std::vector<unsigned int> m_renderIndices;
+	std::vector<unsigned int> m_renderVertexToControlPointMap;
+	FBXCookedSkinWeightsData m_skinWeights;	//FBXMesh::m_weightsMatrix and m_rigidWeightsMatrix, so that loading doesn't rebuild them from the pairs
+	FBXCookedSkinWeightsData m_rigidSkinWeights;
+	std::vector<std::string> m_texturePaths[(int)FBXCookedTextureSlot::COUNT];
+	Vec3 m_boundingBoxMins;
+	Vec3 m_boundingBoxMaxs;
+};
+
+struct FBXCookedModelData {
+	std::string m_sourceFileName;	//The .fbx it was parsed from, for whatever names outputs after it
+	std::vector<FBXCookedJoint> m_joints;
+	std::vector<std::string> m_jointNames;
+	int m_animTimeMode = 0;	//FbxTime::EMode
+	float m_animStartTime = 0.0f;
+	float m_animEndTime = 0.0f;
+	int m_numPoseJoints = 0;	//Joints under the root of the poses
+	std::vector<FBXCookedJointPose> m_jointPoses;	//m_numPoseJoints per pose
+	std::vector<FBXCookedMeshData> m_meshes;
+};
+
+//Pointers into the mapped file
+struct FBXCookedSkinWeightsView {
+	int m_numWeights = 0;
+	const int* m_rowStarts = nullptr;
+	const int* m_jointIndices = nullptr;
+	const double* m_weights = nullptr;
+};
+
+struct FBXCookedMeshView {
+	const FBXCookedMesh* m_mesh = nullptr;
+	const Vec3* m_controlPoints = nullptr;
+	const unsigned int* m_firstJointWeightPairIndices = nullptr;
+	const FBXCookedJointWeightPair* m_jointWeightPairs = nullptr;
+	const int* m_faceControlPointIndices = nullptr;
+	const Vertex_FBX* m_renderVertices = nullptr;
+	const unsigned int* m_renderIndices = nullptr;
+	const unsigned int* m_renderVertexToControlPointMap = nullptr;
+	FBXCookedSkinWeightsView m_skinWeights;
+	FBXCookedSkinWeightsView m_rigidSkinWeights;
+};
+
+struct FBXCookedModelHeader;
+
+//A loaded cooked file. Every getter points into the mapped file, so they are only valid while this stays loaded
+class FBXCookedModel {
+public:
+	FBXCookedModel() = default;
+	FBXCookedModel(const FBXCookedModel& copyFrom) = delete;
+
+	//Checks the header, the payload checksum and every count, offset and index a caller could run off the end with before it points anything into the file.
+	//Stays unloaded on failure
+	bool Load(const std::string& filePath, std::string* errorStr = nullptr);
+	void Unload();
+	bool IsLoaded() const;
+	size_t GetNumBytes() const;
+
+	int GetNumJoints() const;
+	const FBXCookedJoint& GetJoint(int jointIdx) const;
+	std::string GetString(const FBXCookedStringRef& stringRef) const;
+	std::string GetSourceFileName() const;
+
+	int GetAnimTimeMode() const;
+	float GetAnimStartTime() const;
+	float GetAnimEndTime() const;
+	int GetNumPoses() const;
+	int GetNumPoseJoints() const;
+	const FBXCookedJointPose* GetPoseJoints(int poseIdx) const;	//GetNumPoseJoints() entries
+
+	int GetNumMeshes() const;
+	FBXCookedMeshView GetMesh(int meshIdx) const;
+	std::vector<std::string> GetTexturePaths(const FBXCookedMesh& mesh, FBXCookedTextureSlot slot) const;
+
+private:
+	FBXCookedSkinWeightsView GetSkinWeights(const FBXCookedSkinWeights& skinWeights) const;
+
+private:
+	MemoryMappedFile m_file;
+	const FBXCookedModelHeader* m_header = nullptr;
+	const uint8_t* m_payload = nullptr;
+	const FBXCookedJoint* m_joints = nullptr;
+	const FBXCookedJointPose* m_jointPoses = nullptr;
+	const FBXCookedMesh* m_meshes = nullptr;
+	const FBXCookedStringRef* m_texturePaths = nullptr;
+	const char* m_stringBytes = nullptr;
+};
+
+//Writes to a temporary file first and renames it, so a crash never leaves a half written model behind
+bool SaveFBXCookedModel(const std::string& filePath, const FBXCookedModelData& data, std::string* errorStr = nullptr);
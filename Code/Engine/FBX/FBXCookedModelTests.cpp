@@ -0,0 +1,319 @@
+#include "Engine/Fbx/FBXCookedModelTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXCookedModel.hpp"
+#include "Engine/Fbx/FBXVertexDedup.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <filesystem>
+
+//The skinning data of the synthetic mesh as FBX clusters hand it over: one pair per joint with a weight that isn't negligible
+static void GetSyntheticCookedJointWeightPairs(const DDMSyntheticSkinnedMesh& mesh, FBXCookedMeshData& outCookedMesh)
+{
+	constexpr double MIN_WEIGHT = 1e-3;
+	int numControlPoints = (int)mesh.m_weights.rows();
+	outCookedMesh.m_firstJointWeightPairIndices.resize((size_t)numControlPoints + 1);
+	outCookedMesh.m_jointWeightPairs.clear();
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		outCookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx] = (unsigned int)outCookedMesh.m_jointWeightPairs.size();
+		for (int jointIdx = 0; jointIdx < (int)mesh.m_weights.cols(); jointIdx++) {
+			if (mesh.m_weights(ctrlPointIdx, jointIdx) >= MIN_WEIGHT) {
+				FBXCookedJointWeightPair jointWeightPair;
+				jointWeightPair.m_jointIdx = (uint32_t)jointIdx;
+				jointWeightPair.m_weight = (float)mesh.m_weights(ctrlPointIdx, jointIdx);
+				outCookedMesh.m_jointWeightPairs.push_back(jointWeightPair);
+			}
+		}
+	}
+	outCookedMesh.m_firstJointWeightPairIndices[numControlPoints] = (unsigned int)outCookedMesh.m_jointWeightPairs.size();
+}
+
+//FBXControlPoints and both weight matrices, which ProcessFbxMesh builds from the joint weight pairs
+static void BuildCookedMeshSkinWeights(const FBXCookedMeshData& cookedMesh, int numJoints, DDMSkinWeights& outWeights, DDMSkinWeights& outRigidWeights)
+{
+	std::vector<FBXControlPoint*> controlPoints;
+	controlPoints.reserve(cookedMesh.m_controlPoints.size());
+	for (int ctrlPointIdx = 0; ctrlPointIdx < (int)cookedMesh.m_controlPoints.size(); ctrlPointIdx++) {
+		FBXControlPoint* controlPoint = new FBXControlPoint(cookedMesh.m_controlPoints[ctrlPointIdx]);
+		for (unsigned int pairIdx = cookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx]; pairIdx < cookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx + 1]; pairIdx++) {
+			controlPoint->m_jointWeightPairs.emplace_back(cookedMesh.m_jointWeightPairs[pairIdx].m_jointIdx, cookedMesh.m_jointWeightPairs[pairIdx].m_weight);
+		}
+		controlPoints.push_back(controlPoint);
+	}
+	outWeights = GetDDMSkinWeights(controlPoints, numJoints, false);
+	outRigidWeights = GetDDMSkinWeights(controlPoints, numJoints, true);
+	for (FBXControlPoint* controlPoint : controlPoints) {
+		delete controlPoint;
+	}
+}
+
+//What FBXParser::LoadCookedFile copies out of a loaded model, without the FBXJoints and FBXMeshes that need a renderer
+static void ReadCookedModelData(const FBXCookedModel& cookedModel, FBXCookedModelData& outData)
+{
+	outData.m_sourceFileName = cookedModel.GetSourceFileName();
+	outData.m_joints.resize(cookedModel.GetNumJoints());
+	outData.m_jointNames.resize(cookedModel.GetNumJoints());
+	for (int jointIdx = 0; jointIdx < cookedModel.GetNumJoints(); jointIdx++) {
+		outData.m_joints[jointIdx] = cookedModel.GetJoint(jointIdx);
+		outData.m_joints[jointIdx].m_name = FBXCookedStringRef();
+		outData.m_jointNames[jointIdx] = cookedModel.GetString(cookedModel.GetJoint(jointIdx).m_name);
+	}
+	outData.m_animTimeMode = cookedModel.GetAnimTimeMode();
+	outData.m_animStartTime = cookedModel.GetAnimStartTime();
+	outData.m_animEndTime = cookedModel.GetAnimEndTime();
+	outData.m_numPoseJoints = cookedModel.GetNumPoseJoints();
+	outData.m_jointPoses.clear();
+	for (int poseIdx = 0; poseIdx < cookedModel.GetNumPoses(); poseIdx++) {
+		const FBXCookedJointPose* jointPoses = cookedModel.GetPoseJoints(poseIdx);
+		outData.m_jointPoses.insert(outData.m_jointPoses.end(), jointPoses, jointPoses + cookedModel.GetNumPoseJoints());
+	}
+
+	outData.m_meshes.resize(cookedModel.GetNumMeshes());
+	for (int meshIdx = 0; meshIdx < cookedModel.GetNumMeshes(); meshIdx++) {
+		FBXCookedMeshView meshView = cookedModel.GetMesh(meshIdx);
+		const FBXCookedMesh& mesh = *meshView.m_mesh;
+		FBXCookedMeshData& meshData = outData.m_meshes[meshIdx];
+		meshData.m_name = cookedModel.GetString(mesh.m_name);
+		meshData.m_nodeIdx = mesh.m_nodeIdx;
+		meshData.m_controlPoints.assign(meshView.m_controlPoints, meshView.m_controlPoints + mesh.m_numControlPoints);
+		meshData.m_firstJointWeightPairIndices.assign(meshView.m_firstJointWeightPairIndices, meshView.m_firstJointWeightPairIndices + mesh.m_numControlPoints + 1);
+		meshData.m_jointWeightPairs.assign(meshView.m_jointWeightPairs, meshView.m_jointWeightPairs + mesh.m_numJointWeightPairs);
+		meshData.m_faceControlPointIndices.assign(meshView.m_faceControlPointIndices, meshView.m_faceControlPointIndices + 3 * mesh.m_numFaces);
+		meshData.m_renderVertices.assign(meshView.m_renderVertices, meshView.m_renderVertices + mesh.m_numRenderVertices);
+		meshData.m_renderIndices.assign(meshView.m_renderIndices, meshView.m_renderIndices + mesh.m_numRenderIndices);
+		meshData.m_renderVertexToControlPointMap.assign(meshView.m_renderVertexToControlPointMap, meshView.m_renderVertexToControlPointMap + mesh.m_numRenderVertices);
+		FBXCookedSkinWeightsData* skinWeightsData[2] = { &meshData.m_skinWeights, &meshData.m_rigidSkinWeights };
+		const FBXCookedSkinWeightsView* skinWeightsViews[2] = { &meshView.m_skinWeights, &meshView.m_rigidSkinWeights };
+		for (int weightsIdx = 0; weightsIdx < 2; weightsIdx++) {
+			const FBXCookedSkinWeightsView& skinWeights = *skinWeightsViews[weightsIdx];
+			skinWeightsData[weightsIdx]->m_rowStarts.assign(skinWeights.m_rowStarts, skinWeights.m_rowStarts + mesh.m_numControlPoints + 1);
+			skinWeightsData[weightsIdx]->m_jointIndices.assign(skinWeights.m_jointIndices, skinWeights.m_jointIndices + skinWeights.m_numWeights);
+			skinWeightsData[weightsIdx]->m_weights.assign(skinWeights.m_weights, skinWeights.m_weights + skinWeights.m_numWeights);
+		}
+		for (int slotIdx = 0; slotIdx < (int)FBXCookedTextureSlot::COUNT; slotIdx++) {
+			meshData.m_texturePaths[slotIdx] = cookedModel.GetTexturePaths(mesh, (FBXCookedTextureSlot)slotIdx);
+		}
+		meshData.m_boundingBoxMins = mesh.m_boundingBoxMins;
+		meshData.m_boundingBoxMaxs = mesh.m_boundingBoxMaxs;
+	}
+}
+
+static bool AreCookedSkinWeightsBitIdentical(const FBXCookedSkinWeightsData& a, const FBXCookedSkinWeightsData& b)
+{
+	return AreVectorsBitIdentical(a.m_rowStarts, b.m_rowStarts) && AreVectorsBitIdentical(a.m_jointIndices, b.m_jointIndices) && AreVectorsBitIdentical(a.m_weights, b.m_weights);
+}
+
+static bool AreCookedModelsBitIdentical(const FBXCookedModelData& a, const FBXCookedModelData& b)
+{
+	if (a.m_sourceFileName != b.m_sourceFileName || a.m_jointNames != b.m_jointNames || a.m_animTimeMode != b.m_animTimeMode || a.m_numPoseJoints != b.m_numPoseJoints
+		|| memcmp(&a.m_animStartTime, &b.m_animStartTime, sizeof(float)) != 0 || memcmp(&a.m_animEndTime, &b.m_animEndTime, sizeof(float)) != 0
+		|| !AreVectorsBitIdentical(a.m_joints, b.m_joints) || !AreVectorsBitIdentical(a.m_jointPoses, b.m_jointPoses) || a.m_meshes.size() != b.m_meshes.size()) {
+		return false;
+	}
+	for (int meshIdx = 0; meshIdx < (int)a.m_meshes.size(); meshIdx++) {
+		const FBXCookedMeshData& meshA = a.m_meshes[meshIdx];
+		const FBXCookedMeshData& meshB = b.m_meshes[meshIdx];
+		bool isMeshIdentical = meshA.m_name == meshB.m_name && meshA.m_nodeIdx == meshB.m_nodeIdx && AreVectorsBitIdentical(meshA.m_controlPoints, meshB.m_controlPoints)
+			&& AreVectorsBitIdentical(meshA.m_firstJointWeightPairIndices, meshB.m_firstJointWeightPairIndices) && AreVectorsBitIdentical(meshA.m_jointWeightPairs, meshB.m_jointWeightPairs)
+			&& AreVectorsBitIdentical(meshA.m_faceControlPointIndices, meshB.m_faceControlPointIndices) && AreVectorsBitIdentical(meshA.m_renderVertices, meshB.m_renderVertices)
+			&& AreVectorsBitIdentical(meshA.m_renderIndices, meshB.m_renderIndices) && AreVectorsBitIdentical(meshA.m_renderVertexToControlPointMap, meshB.m_renderVertexToControlPointMap)
+			&& AreCookedSkinWeightsBitIdentical(meshA.m_skinWeights, meshB.m_skinWeights) && AreCookedSkinWeightsBitIdentical(meshA.m_rigidSkinWeights, meshB.m_rigidSkinWeights)
+			&& memcmp(&meshA.m_boundingBoxMins, &meshB.m_boundingBoxMins, sizeof(Vec3)) == 0 && memcmp(&meshA.m_boundingBoxMaxs, &meshB.m_boundingBoxMaxs, sizeof(Vec3)) == 0;
+		for (int slotIdx = 0; slotIdx < (int)FBXCookedTextureSlot::COUNT; slotIdx++) {
+			isMeshIdentical = isMeshIdentical && meshA.m_texturePaths[slotIdx] == meshB.m_texturePaths[slotIdx];
+		}
+		if (!isMeshIdentical) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//Load and read back, what FBXParser::LoadCookedFile costs on top of creating the FBXJoints and FBXMeshes
+static bool LoadCookedModelTimed(const std::string& filePath, FBXCookedModelData& outData, double& outLoadSeconds, double& outReadSeconds, double& outSkinWeightsSeconds, std::string& outErrorStr)
+{
+	FBXCookedModel cookedModel;
+	double startTime = GetCurrentTimeSeconds();
+	if (!cookedModel.Load(filePath, &outErrorStr)) {
+		return false;
+	}
+	outLoadSeconds = GetCurrentTimeSeconds() - startTime;
+	startTime = GetCurrentTimeSeconds();
+	ReadCookedModelData(cookedModel, outData);
+	outReadSeconds = GetCurrentTimeSeconds() - startTime;
+	startTime = GetCurrentTimeSeconds();
+	for (int meshIdx = 0; meshIdx < cookedModel.GetNumMeshes(); meshIdx++) {
+		FBXCookedMeshView meshView = cookedModel.GetMesh(meshIdx);
+		const FBXCookedSkinWeightsView& skinWeights = meshView.m_skinWeights;
+		const FBXCookedSkinWeightsView& rigidSkinWeights = meshView.m_rigidSkinWeights;
+		DDMSkinWeights weights = GetDDMSkinWeightsFromArrays(meshView.m_mesh->m_numControlPoints, cookedModel.GetNumJoints(), skinWeights.m_numWeights, skinWeights.m_rowStarts,
+			skinWeights.m_jointIndices, skinWeights.m_weights);
+		DDMSkinWeights rigidWeights = GetDDMSkinWeightsFromArrays(meshView.m_mesh->m_numControlPoints, cookedModel.GetNumJoints(), rigidSkinWeights.m_numWeights, rigidSkinWeights.m_rowStarts,
+			rigidSkinWeights.m_jointIndices, rigidSkinWeights.m_weights);
+	}
+	outSkinWeightsSeconds = GetCurrentTimeSeconds() - startTime;
+	return true;
+}
+
+bool Command_FBXCookedModelTest(EventArgs& args)
+{
+	std::string existingFilePath = args.GetValue("File", std::string(""));
+	if (!existingFilePath.empty()) {
+		FBXCookedModelData data;
+		double loadSeconds = 0.0;
+		double readSeconds = 0.0;
+		double skinWeightsSeconds = 0.0;
+		std::string errorStr;
+		if (!LoadCookedModelTimed(existingFilePath, data, loadSeconds, readSeconds, skinWeightsSeconds, errorStr)) {
+			PrintBenchmarkLine(Stringf("FBXCookedModelTest: %s FAILED to load: %s", existingFilePath.c_str(), errorStr.c_str()));
+			return false;
+		}
+		int numRenderVertices = 0;
+		for (const FBXCookedMeshData& meshData : data.m_meshes) {
+			numRenderVertices += (int)meshData.m_renderVertices.size();
+		}
+		PrintBenchmarkLine(Stringf("FBXCookedModelTest: %s (cooked from %s), %d meshes, %d render vertices, %d joints, %d poses", existingFilePath.c_str(), data.m_sourceFileName.c_str(),
+			(int)data.m_meshes.size(), numRenderVertices, (int)data.m_joints.size(), data.m_numPoseJoints > 0 ? (int)data.m_jointPoses.size() / data.m_numPoseJoints : 0));
+		PrintBenchmarkLine(Stringf("  Map and check %.3lf ms, read %.3lf ms, skin weights %.3lf ms", loadSeconds * 1000.0, readSeconds * 1000.0, skinWeightsSeconds * 1000.0));
+		return true;
+	}
+
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("200000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("50")).c_str());
+	int numPoses = atoi(args.GetValue("NumPoses", std::string("300")).c_str());
+	std::string filePath = args.GetValue("Path", std::string("Data/Cache/FBXCookedTest/Synthetic.fbxcooked"));
+	GUARANTEE_OR_DIE(numControlPoints > 0 && numJoints > 0 && numPoses >= 0, "FBXCookedModelTest needs positive NumControlPoints and NumJoints");
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "FBXCookedModelTest needs g_theJobSystem");
+
+	//What ParseFile ends up with for the vertex dedup benchmark's tube, timing the processing that doesn't need the fbx sdk: deduplication and the skin weights
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	std::vector<Vertex_FBX> polygonVertices;
+	std::vector<int> polygonVertexControlPointIndices;
+	GetSyntheticPolygonVertices(mesh, polygonVertices, polygonVertexControlPointIndices);
+	FBXCookedModelData data;
+	data.m_sourceFileName = "Data/Models/Synthetic.fbx";
+	data.m_meshes.resize(1);
+	FBXCookedMeshData& meshData = data.m_meshes[0];
+	meshData.m_name = "SyntheticTube";
+	meshData.m_nodeIdx = 1;
+	meshData.m_texturePaths[(int)FBXCookedTextureSlot::DIFFUSE].push_back("Data/Images/SyntheticTube_Diffuse.png");
+	meshData.m_texturePaths[(int)FBXCookedTextureSlot::NORMAL].push_back("Data/Images/SyntheticTube_Normal.png");
+	meshData.m_controlPoints.resize(mesh.m_restPositions.rows());
+	for (int ctrlPointIdx = 0; ctrlPointIdx < (int)mesh.m_restPositions.rows(); ctrlPointIdx++) {
+		meshData.m_controlPoints[ctrlPointIdx] = Vec3((float)mesh.m_restPositions(ctrlPointIdx, 0), (float)mesh.m_restPositions(ctrlPointIdx, 1), (float)mesh.m_restPositions(ctrlPointIdx, 2));
+	}
+	meshData.m_boundingBoxMins = Vec3((float)mesh.m_restPositions.col(0).minCoeff(), (float)mesh.m_restPositions.col(1).minCoeff(), (float)mesh.m_restPositions.col(2).minCoeff());
+	meshData.m_boundingBoxMaxs = Vec3((float)mesh.m_restPositions.col(0).maxCoeff(), (float)mesh.m_restPositions.col(1).maxCoeff(), (float)mesh.m_restPositions.col(2).maxCoeff());
+	Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> facesRowMajor = mesh.m_faces;
+	meshData.m_faceControlPointIndices.assign(facesRowMajor.data(), facesRowMajor.data() + facesRowMajor.size());
+	GetSyntheticCookedJointWeightPairs(mesh, meshData);
+
+	double startTime = GetCurrentTimeSeconds();
+	std::vector<unsigned int> firstPolygonVertexIndices;
+	DeduplicateFBXVertices(g_theJobSystem, polygonVertices, 65536, meshData.m_renderIndices, firstPolygonVertexIndices);
+	meshData.m_renderVertices.resize(firstPolygonVertexIndices.size());
+	meshData.m_renderVertexToControlPointMap.resize(firstPolygonVertexIndices.size());
+	for (int renderVertexIdx = 0; renderVertexIdx < (int)firstPolygonVertexIndices.size(); renderVertexIdx++) {
+		meshData.m_renderVertices[renderVertexIdx] = polygonVertices[firstPolygonVertexIndices[renderVertexIdx]];
+		meshData.m_renderVertexToControlPointMap[renderVertexIdx] = (unsigned int)polygonVertexControlPointIndices[firstPolygonVertexIndices[renderVertexIdx]];
+	}
+	DDMSkinWeights weights;
+	DDMSkinWeights rigidWeights;
+	BuildCookedMeshSkinWeights(meshData, numJoints, weights, rigidWeights);
+	double processSeconds = GetCurrentTimeSeconds() - startTime;
+	GetDDMSkinWeightsArrays(weights, meshData.m_skinWeights.m_rowStarts, meshData.m_skinWeights.m_jointIndices, meshData.m_skinWeights.m_weights);
+	GetDDMSkinWeightsArrays(rigidWeights, meshData.m_rigidSkinWeights.m_rowStarts, meshData.m_rigidSkinWeights.m_jointIndices, meshData.m_rigidSkinWeights.m_weights);
+
+	//A chain up the y axis like the synthetic weights assume, bending a little more with every pose
+	data.m_joints.resize(numJoints);
+	data.m_jointNames.resize(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		FBXCookedJoint& joint = data.m_joints[jointIdx];
+		float height = (float)mesh.m_jointHeights[jointIdx];
+		float parentHeight = jointIdx > 0 ? (float)mesh.m_jointHeights[jointIdx - 1] : 0.0f;
+		joint.m_globalBindPose = Mat44::CreateTranslation3D(Vec3(0.0f, height, 0.0f));
+		joint.m_globalBindPoseInverse = Mat44::CreateTranslation3D(Vec3(0.0f, -height, 0.0f));
+		joint.m_originalLocalTranslate = Vec3(0.0f, height - parentHeight, 0.0f);
+		joint.m_parentJointIdx = jointIdx - 1;
+		joint.m_stencilRef = (uint32_t)jointIdx + 1;
+		joint.m_isRoot = jointIdx == 0 ? 1 : 0;
+		joint.m_isEndJoint = jointIdx == numJoints - 1 ? 1 : 0;
+		data.m_jointNames[jointIdx] = Stringf("Joint%d", jointIdx);
+	}
+	data.m_animTimeMode = 6;	//FbxTime::eFrames30
+	data.m_animEndTime = (float)numPoses / 30.0f;
+	data.m_numPoseJoints = numJoints;
+	data.m_jointPoses.resize((size_t)numPoses * numJoints);
+	for (int poseIdx = 0; poseIdx < numPoses; poseIdx++) {
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			FBXCookedJointPose& jointPose = data.m_jointPoses[(size_t)poseIdx * numJoints + jointIdx];
+			jointPose.m_localScaling = Vec4(1.0f, 1.0f, 1.0f, 0.0f);
+			jointPose.m_localQuat = Quaternion::CreateFromAxisAndDegrees(0.1f * (float)poseIdx, Vec3(1.0f, 0.0f, 0.0f));
+			jointPose.m_localLoc = Vec4(0.0f, data.m_joints[jointIdx].m_originalLocalTranslate.y, 0.0f, 0.0f);
+		}
+	}
+
+	BenchmarkCheckList report;
+	PrintBenchmarkLine(Stringf("FBXCookedModelTest: %d control points, %d render vertices, %d joints, %d poses, %s", numControlPoints, (int)meshData.m_renderVertices.size(),
+		numJoints, numPoses, filePath.c_str()));
+
+	std::string errorStr;
+	startTime = GetCurrentTimeSeconds();
+	bool hasSaved = SaveFBXCookedModel(filePath, data, &errorStr);
+	double saveSeconds = GetCurrentTimeSeconds() - startTime;
+	report.Check("Save", hasSaved);
+	if (!hasSaved) {
+		PrintBenchmarkLine("  " + errorStr);
+		return false;
+	}
+
+	FBXCookedModelData loadedData;
+	double loadSeconds = 0.0;
+	double readSeconds = 0.0;
+	double skinWeightsSeconds = 0.0;
+	bool hasLoaded = LoadCookedModelTimed(filePath, loadedData, loadSeconds, readSeconds, skinWeightsSeconds, errorStr);
+	report.Check("Load", hasLoaded);
+	if (hasLoaded) {
+		report.Check("Everything is bit identical", AreCookedModelsBitIdentical(data, loadedData));
+	}
+	else {
+		PrintBenchmarkLine("  " + errorStr);
+	}
+
+	//Every way a file can go stale or bad has to fail instead of handing out garbage
+	FBXCookedModel cookedModel;
+	std::vector<uint8_t> fileBuffer;
+	FileReadToBuffer(fileBuffer, filePath);
+	std::string corruptFilePath = filePath + ".corrupt";
+	std::vector<uint8_t> truncatedBuffer(fileBuffer.begin(), fileBuffer.begin() + fileBuffer.size() / 2);
+	FileWriteFromBuffer(truncatedBuffer, corruptFilePath);
+	report.Check("Truncated file fails", !cookedModel.Load(corruptFilePath));
+	std::vector<uint8_t> flippedBuffer = fileBuffer;
+	flippedBuffer[flippedBuffer.size() - 1] ^= 0x01;
+	FileWriteFromBuffer(flippedBuffer, corruptFilePath);
+	report.Check("Flipped payload byte fails", !cookedModel.Load(corruptFilePath));
+	std::vector<uint8_t> otherVersionBuffer = fileBuffer;
+	otherVersionBuffer[4] ^= 0xFF;	//The version follows the 4 byte magic
+	FileWriteFromBuffer(otherVersionBuffer, corruptFilePath);
+	report.Check("Other version fails", !cookedModel.Load(corruptFilePath));
+	FBXCookedModelData badIndexData = std::move(loadedData);
+	if (!badIndexData.m_meshes.empty() && !badIndexData.m_meshes[0].m_renderIndices.empty()) {
+		badIndexData.m_meshes[0].m_renderIndices.back() = (unsigned int)badIndexData.m_meshes[0].m_renderVertices.size();
+	}
+	SaveFBXCookedModel(corruptFilePath, badIndexData);
+	report.Check("Index out of range with valid checksum fails", !cookedModel.Load(corruptFilePath));
+
+	const double bytesToMB = 1.0 / (1024.0 * 1024.0);
+	double cookedSeconds = loadSeconds + readSeconds + skinWeightsSeconds;
+	PrintBenchmarkLine(Stringf("  %.1lf MB file, save %.3lf ms", (double)fileBuffer.size() * bytesToMB, saveSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("  Processing      : %8.3lf ms (dedup and skin weights, on top of the fbx sdk import)", processSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("  Cooked          : %8.3lf ms (x%.2lf): map and check %.3lf ms, read %.3lf ms, skin weights %.3lf ms", cookedSeconds * 1000.0, processSeconds / cookedSeconds,
+		loadSeconds * 1000.0, readSeconds * 1000.0, skinWeightsSeconds * 1000.0));
+
+	std::error_code errorCode;
+	std::filesystem::remove(filePath, errorCode);
+	std::filesystem::remove(corruptFilePath, errorCode);
+	return report.m_hasPassed;
+}
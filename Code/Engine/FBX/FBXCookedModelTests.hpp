@@ -0,0 +1,4 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+bool Command_FBXCookedModelTest(EventArgs& args);	//Round trips a synthetic model and checks that bad files fail, or times loading File=<cooked model>
@@ -0,0 +1,438 @@
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static constexpr int CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE = 64;
+static constexpr int NUM_RANDOM_ROLLS_PER_JOINT = 3;
+static constexpr int CANDIDATE_PARALLEL_FOR_GRAIN_SIZE = 256;
+
+static const char* s_solveModeNames[] = { "QR", "NormalEquations" };
+static_assert(sizeof(s_solveModeNames) / sizeof(s_solveModeNames[0]) == (size_t)DDMBakerSolveMode::COUNT, "Every DDMBakerSolveMode needs a name");
+
+const char* GetDDMBakerSolveModeName(DDMBakerSolveMode solveMode)
+{
+	GUARANTEE_OR_DIE(solveMode >= DDMBakerSolveMode::COLUMN_PIVOTING_QR && solveMode < DDMBakerSolveMode::COUNT, "Invalid DDMBakerSolveMode");
+	return s_solveModeNames[(int)solveMode];
+}
+
+bool GetDDMBakerSolveModeFromName(const std::string& name, DDMBakerSolveMode& outSolveMode)
+{
+	for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+		if (AreStringsEqualCaseInsensitive(name, s_solveModeNames[solveModeIdx])) {
+			outSolveMode = (DDMBakerSolveMode)solveModeIdx;
+			return true;
+		}
+	}
+	return false;
+}
+
+void DDMBakerSkeleton::ComputeEvaluationOrder()
+{
+	int numJoints = GetNumJoints();
+	std::vector<int> depths(numJoints, 0);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		for (int ancestorIdx = m_parentIndices[jointIdx]; ancestorIdx >= 0; ancestorIdx = m_parentIndices[ancestorIdx]) {
+			GUARANTEE_OR_DIE(depths[jointIdx] < numJoints, "DDMBakerSkeleton::m_parentIndices has a cycle");
+			depths[jointIdx]++;
+		}
+	}
+	m_evaluationOrder.resize(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		m_evaluationOrder[jointIdx] = jointIdx;
+	}
+	std::stable_sort(m_evaluationOrder.begin(), m_evaluationOrder.end(), [&](int jointIdx0, int jointIdx1) { return depths[jointIdx0] < depths[jointIdx1]; });
+}
+
+void DDMBakerSkeleton::GetBakingPoseSkinningMatrices(unsigned int seed, int poseIdx, float twistLimit, std::vector<Mat44>& scratchGlobalTransforms,
+	std::vector<Mat44>& outSkinningMatrices) const
+{
+	int numJoints = GetNumJoints();
+	GUARANTEE_OR_DIE((int)m_evaluationOrder.size() == numJoints, "Call DDMBakerSkeleton::ComputeEvaluationOrder() first");
+	scratchGlobalTransforms.resize(numJoints);
+	outSkinningMatrices.resize(numJoints);
+
+	RandomNumberGenerator rng(seed);
+	for (int jointIdx : m_evaluationOrder) {
+		Mat44 localTransform = m_localTransformsWithoutDeltaRotate[jointIdx];
+		if (jointIdx > 0) {
+			rng.m_position = ((poseIdx * (numJoints - 1)) + (jointIdx - 1)) * NUM_RANDOM_ROLLS_PER_JOINT;
+			Quaternion randomDeltaRotate = Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-twistLimit, twistLimit), Vec3(0.0f, 0.0f, 1.0f));
+			randomDeltaRotate = randomDeltaRotate * Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-twistLimit, twistLimit), Vec3(1.0f, 0.0f, 0.0f));
+			randomDeltaRotate = randomDeltaRotate * Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-twistLimit, twistLimit), Vec3(0.0f, 1.0f, 0.0f));
+			localTransform.Append(randomDeltaRotate.GetRotationMatrix());
+		}
+		int parentIdx = m_parentIndices[jointIdx];
+		scratchGlobalTransforms[jointIdx] = parentIdx >= 0 ? scratchGlobalTransforms[parentIdx] : Mat44();
+		scratchGlobalTransforms[jointIdx].Append(localTransform);
+		outSkinningMatrices[jointIdx] = scratchGlobalTransforms[jointIdx];
+		outSkinningMatrices[jointIdx].Append(m_globalBindPoseInverses[jointIdx]);
+	}
+}
+
+int DDMBakerJointCandidates::GetMaxNumCandidates() const
+{
+	int maxNumCandidates = 0;
+	for (int cpIdx = 0; cpIdx < GetNumControlPoints(); cpIdx++) {
+		maxNumCandidates = std::max(maxNumCandidates, GetNumCandidates(cpIdx));
+	}
+	return maxNumCandidates;
+}
+
+void DDMBakerJointCandidates::SetToEveryJoint(int numControlPoints, int numJoints)
+{
+	m_offsets.resize((size_t)numControlPoints + 1);
+	m_jointIndices.resize((size_t)numControlPoints * (size_t)numJoints);
+	for (int cpIdx = 0; cpIdx <= numControlPoints; cpIdx++) {
+		m_offsets[cpIdx] = cpIdx * numJoints;
+	}
+	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			m_jointIndices[(size_t)cpIdx * (size_t)numJoints + jointIdx] = jointIdx;
+		}
+	}
+}
+
+//Compressed rows of the control points sharing an edge with each control point, ascending
+static void GetControlPointNeighbors(const Eigen::MatrixX3i& faces, int numControlPoints, std::vector<int>& outOffsets, std::vector<int>& outNeighbors)
+{
+	std::vector<std::vector<int>> neighbors(numControlPoints);
+	for (int faceIdx = 0; faceIdx < (int)faces.rows(); faceIdx++) {
+		for (int cornerIdx = 0; cornerIdx < 3; cornerIdx++) {
+			int cpIdx0 = faces(faceIdx, cornerIdx);
+			int cpIdx1 = faces(faceIdx, (cornerIdx + 1) % 3);
+			GUARANTEE_OR_DIE(cpIdx0 >= 0 && cpIdx0 < numControlPoints && cpIdx1 >= 0 && cpIdx1 < numControlPoints, "Face index out of range");
+			neighbors[cpIdx0].push_back(cpIdx1);
+			neighbors[cpIdx1].push_back(cpIdx0);
+		}
+	}
+	outOffsets.assign(1, 0);
+	outNeighbors.clear();
+	for (std::vector<int>& cpNeighbors : neighbors) {
+		std::sort(cpNeighbors.begin(), cpNeighbors.end());
+		cpNeighbors.erase(std::unique(cpNeighbors.begin(), cpNeighbors.end()), cpNeighbors.end());
+		outNeighbors.insert(outNeighbors.end(), cpNeighbors.begin(), cpNeighbors.end());
+		outOffsets.push_back((int)outNeighbors.size());
+	}
+}
+
+void ComputeDDMBakerJointCandidates(JobSystem& jobSystem, const Eigen::MatrixX3i& faces, const DDMSkinWeights& restWeights, const std::vector<int>& parentIndices,
+	const DDMBakerCandidateParameters& parameters, DDMBakerJointCandidates& outCandidates)
+{
+	int numControlPoints = (int)restWeights.rows();
+	int numJoints = (int)restWeights.cols();
+	GUARANTEE_OR_DIE(numJoints == (int)parentIndices.size(), "restWeights.cols() != parentIndices.size()");
+	GUARANTEE_OR_DIE(parameters.m_numMeshRings >= 0 && parameters.m_numSkeletonRings >= 0 && parameters.m_maxNumCandidates >= 0 && parameters.m_minRestWeight >= 0.0,
+		"Negative DDMBakerCandidateParameters");
+
+	std::vector<int> neighborOffsets;
+	std::vector<int> neighbors;
+	GetControlPointNeighbors(faces, numControlPoints, neighborOffsets, neighbors);
+	std::vector<std::vector<int>> skeletonNeighbors(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		int parentIdx = parentIndices[jointIdx];
+		if (parentIdx >= 0) {
+			GUARANTEE_OR_DIE(parentIdx < numJoints, "parentIndices out of range");
+			skeletonNeighbors[jointIdx].push_back(parentIdx);
+			skeletonNeighbors[parentIdx].push_back(jointIdx);
+		}
+	}
+
+	//Ring weights as (jointIdx, weight) lists, ascending. Every ring takes the largest weight of each joint over the control point and its neighbors.
+	//A max does not depend on the order things come in, so neither do the candidates
+	typedef std::vector<std::pair<int, double>> JointWeights;
+	std::vector<JointWeights> ringWeights(numControlPoints);
+	jobSystem.ParallelForRange(0, numControlPoints, CANDIDATE_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			for (DDMSkinWeights::InnerIterator weightIter(restWeights, cpIdx); weightIter; ++weightIter) {
+				if (weightIter.value() > parameters.m_minRestWeight) {
+					ringWeights[cpIdx].push_back(std::make_pair((int)weightIter.index(), weightIter.value()));
+				}
+			}
+		}
+	});
+	std::vector<JointWeights> nextRingWeights(numControlPoints);
+	for (int ringIdx = 0; ringIdx < parameters.m_numMeshRings; ringIdx++) {
+		jobSystem.ParallelForRange(0, numControlPoints, CANDIDATE_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+			std::vector<double> jointWeights(numJoints, 0.0);
+			std::vector<int> touchedJointIndices;
+			for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+				for (int neighborIdx = neighborOffsets[cpIdx] - 1; neighborIdx < neighborOffsets[cpIdx + 1]; neighborIdx++) {
+					int sourceCPIdx = neighborIdx < neighborOffsets[cpIdx] ? cpIdx : neighbors[neighborIdx];	//The control point itself first
+					for (const std::pair<int, double>& jointWeight : ringWeights[sourceCPIdx]) {
+						if (jointWeights[jointWeight.first] == 0.0) {
+							touchedJointIndices.push_back(jointWeight.first);
+						}
+						jointWeights[jointWeight.first] = std::max(jointWeights[jointWeight.first], jointWeight.second);
+					}
+				}
+				std::sort(touchedJointIndices.begin(), touchedJointIndices.end());
+				nextRingWeights[cpIdx].clear();
+				for (int jointIdx : touchedJointIndices) {
+					nextRingWeights[cpIdx].push_back(std::make_pair(jointIdx, jointWeights[jointIdx]));
+					jointWeights[jointIdx] = 0.0;
+				}
+				touchedJointIndices.clear();
+			}
+		});
+		ringWeights.swap(nextRingWeights);
+	}
+
+	std::vector<std::vector<int>> cpCandidates(numControlPoints);
+	jobSystem.ParallelForRange(0, numControlPoints, CANDIDATE_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+		std::vector<int> skeletonDistances(numJoints, -1);
+		std::vector<double> jointWeights(numJoints, 0.0);
+		std::vector<int> reachedJointIndices;
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			if (ringWeights[cpIdx].empty()) {
+				for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+					cpCandidates[cpIdx].push_back(jointIdx);
+				}
+				continue;
+			}
+
+			//Breadth first over the bones, starting from every weighted joint at once
+			for (const std::pair<int, double>& jointWeight : ringWeights[cpIdx]) {
+				skeletonDistances[jointWeight.first] = 0;
+				jointWeights[jointWeight.first] = jointWeight.second;
+				reachedJointIndices.push_back(jointWeight.first);
+			}
+			for (size_t reachedIdx = 0; reachedIdx < reachedJointIndices.size(); reachedIdx++) {
+				int jointIdx = reachedJointIndices[reachedIdx];
+				if (skeletonDistances[jointIdx] >= parameters.m_numSkeletonRings) {
+					continue;
+				}
+				for (int neighborJointIdx : skeletonNeighbors[jointIdx]) {
+					if (skeletonDistances[neighborJointIdx] < 0) {
+						skeletonDistances[neighborJointIdx] = skeletonDistances[jointIdx] + 1;
+						reachedJointIndices.push_back(neighborJointIdx);
+					}
+				}
+			}
+
+			std::sort(reachedJointIndices.begin(), reachedJointIndices.end(), [&](int jointIdx0, int jointIdx1) {
+				if (jointWeights[jointIdx0] != jointWeights[jointIdx1]) {
+					return jointWeights[jointIdx0] > jointWeights[jointIdx1];
+				}
+				if (skeletonDistances[jointIdx0] != skeletonDistances[jointIdx1]) {
+					return skeletonDistances[jointIdx0] < skeletonDistances[jointIdx1];
+				}
+				return jointIdx0 < jointIdx1;
+			});
+			int numCandidates = (int)reachedJointIndices.size();
+			if (parameters.m_maxNumCandidates > 0) {
+				numCandidates = std::min(numCandidates, parameters.m_maxNumCandidates);
+			}
+			cpCandidates[cpIdx].assign(reachedJointIndices.begin(), reachedJointIndices.begin() + numCandidates);
+			std::sort(cpCandidates[cpIdx].begin(), cpCandidates[cpIdx].end());
+
+			for (int jointIdx : reachedJointIndices) {
+				skeletonDistances[jointIdx] = -1;
+				jointWeights[jointIdx] = 0.0;
+			}
+			reachedJointIndices.clear();
+		}
+	});
+
+	outCandidates.m_offsets.assign(1, 0);
+	outCandidates.m_jointIndices.clear();
+	for (const std::vector<int>& candidates : cpCandidates) {
+		outCandidates.m_jointIndices.insert(outCandidates.m_jointIndices.end(), candidates.begin(), candidates.end());
+		outCandidates.m_offsets.push_back((int)outCandidates.m_jointIndices.size());
+	}
+}
+
+void DDMBakerLinearSystems::Prepare(DDMBakerSolveMode solveMode, const std::vector<Vec3>& restPositions, int numJoints, int numPoses, const DDMBakerJointCandidates* candidates)
+{
+	GUARANTEE_OR_DIE(numPoses > 0, "numPoses <= 0");
+	GUARANTEE_OR_DIE(numJoints > 0, "numJoints <= 0");
+	Clear();
+	m_solveMode = solveMode;
+	m_numJoints = numJoints;
+	m_numPoses = numPoses;
+	m_restPositions = restPositions;
+	int numControlPoints = (int)restPositions.size();
+	if (candidates != nullptr) {
+		GUARANTEE_OR_DIE(candidates->GetNumControlPoints() == numControlPoints, "candidates->GetNumControlPoints() != restPositions.size()");
+		m_candidates = *candidates;
+	}
+	else {
+		m_candidates.SetToEveryJoint(numControlPoints, numJoints);
+	}
+
+	if (solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR) {
+		m_lhsMatrices.resize(numControlPoints);
+		m_rhsVectors.resize(numControlPoints);
+		for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+			m_lhsMatrices[cpIdx].setZero(3 * numPoses, m_candidates.GetNumCandidates(cpIdx));
+			m_rhsVectors[cpIdx].setZero(3 * numPoses);
+		}
+	}
+	else {
+		m_jointPairGrams.setZero(numJoints * (numJoints + 1) / 2, 10);
+		m_candidateAtbs.setZero((Eigen::Index)m_candidates.m_jointIndices.size());
+	}
+}
+
+int DDMBakerLinearSystems::GetJointPairIdx(int jointIdx0, int jointIdx1) const
+{
+	//Rows of joint j start after the j rows of length numJoints, numJoints - 1, ... of the joints before it
+	return jointIdx0 * m_numJoints - jointIdx0 * (jointIdx0 - 1) / 2 + (jointIdx1 - jointIdx0);
+}
+
+void DDMBakerLinearSystems::AddPoseLHS(JobSystem& jobSystem, int poseIdx, const std::vector<Mat44>& allJointSkinningMatrices)
+{
+	GUARANTEE_OR_DIE(poseIdx >= 0 && poseIdx < m_numPoses, "poseIdx out of range");
+	GUARANTEE_OR_DIE(m_numJoints == (int)allJointSkinningMatrices.size(), "m_numJoints != allJointSkinningMatrices.size()");
+	int numControlPoints = GetNumControlPoints();
+
+	if (m_solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR) {
+		jobSystem.ParallelForRange(0, numControlPoints, CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+			for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+				const int* candidates = m_candidates.GetCandidates(cpIdx);
+				for (int candidateIdx = 0; candidateIdx < m_candidates.GetNumCandidates(cpIdx); candidateIdx++) {
+					Vec3 transformedPos = allJointSkinningMatrices[candidates[candidateIdx]].TransformPosition3D(m_restPositions[cpIdx]);
+					m_lhsMatrices[cpIdx].block(poseIdx * 3, candidateIdx, 3, 1) << transformedPos.x, transformedPos.y, transformedPos.z;
+				}
+			}
+		});
+		return;
+	}
+
+	//Nothing here depends on the control points, so a pose costs numJointPairs 4x4 products however big the mesh is. Pairs no control point has as candidates are cheap enough to keep
+	std::vector<Eigen::Matrix<double, 3, 4>> topRows(m_numJoints);
+	for (int jointIdx = 0; jointIdx < m_numJoints; jointIdx++) {
+		topRows[jointIdx] = FBXDDMModifier::ConvertMat44ToEigen(allJointSkinningMatrices[jointIdx]).topRows<3>();
+	}
+	jobSystem.ParallelForRange(0, m_numJoints, 1, [&](int beginJointIdx, int endJointIdx) {
+		for (int jointIdx0 = beginJointIdx; jointIdx0 < endJointIdx; jointIdx0++) {
+			for (int jointIdx1 = jointIdx0; jointIdx1 < m_numJoints; jointIdx1++) {
+				Eigen::Matrix<double, 4, 4> gram = topRows[jointIdx0].transpose() * topRows[jointIdx1];
+				Eigen::Matrix<double, 4, 4> symmetricGram = 0.5 * (gram + gram.transpose());
+				m_jointPairGrams.row(GetJointPairIdx(jointIdx0, jointIdx1)) += FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(symmetricGram).transpose();
+			}
+		}
+	});
+}
+
+void DDMBakerLinearSystems::AddPoseRHS(JobSystem& jobSystem, int poseIdx, const std::vector<Mat44>& allJointSkinningMatrices, const Eigen::MatrixX3f& deformedPositions)
+{
+	GUARANTEE_OR_DIE(poseIdx >= 0 && poseIdx < m_numPoses, "poseIdx out of range");
+	GUARANTEE_OR_DIE(m_numJoints == (int)allJointSkinningMatrices.size(), "m_numJoints != allJointSkinningMatrices.size()");
+	int numControlPoints = GetNumControlPoints();
+	GUARANTEE_OR_DIE(numControlPoints == (int)deformedPositions.rows(), "numControlPoints != deformedPositions.rows()");
+
+	if (m_solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR) {
+		for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+			m_rhsVectors[cpIdx].segment<3>(3 * poseIdx) = deformedPositions.row(cpIdx).transpose();	//A copy, not worth the threads
+		}
+		return;
+	}
+
+	std::vector<Eigen::Matrix<double, 3, 4>> topRows(m_numJoints);
+	for (int jointIdx = 0; jointIdx < m_numJoints; jointIdx++) {
+		topRows[jointIdx] = FBXDDMModifier::ConvertMat44ToEigen(allJointSkinningMatrices[jointIdx]).topRows<3>();
+	}
+	jobSystem.ParallelForRange(0, numControlPoints, CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			const Vec3& restPosition = m_restPositions[cpIdx];
+			Eigen::Vector4d restPositionHomogeneous(restPosition.x, restPosition.y, restPosition.z, 1.0);
+			Eigen::Vector3d deformedPosition = deformedPositions.row(cpIdx).transpose().cast<double>();
+			const int* candidates = m_candidates.GetCandidates(cpIdx);
+			double* Atb = m_candidateAtbs.data() + m_candidates.m_offsets[cpIdx];
+			for (int candidateIdx = 0; candidateIdx < m_candidates.GetNumCandidates(cpIdx); candidateIdx++) {
+				Atb[candidateIdx] += (topRows[candidates[candidateIdx]] * restPositionHomogeneous).dot(deformedPosition);
+			}
+		}
+	});
+}
+
+void DDMBakerLinearSystems::Solve(int ctrlPointIdx, Eigen::VectorXf& outWeights) const
+{
+	GUARANTEE_OR_DIE(ctrlPointIdx >= 0 && ctrlPointIdx < GetNumControlPoints(), "ctrlPointIdx out of range");
+	const int* candidates = m_candidates.GetCandidates(ctrlPointIdx);
+	int numCandidates = m_candidates.GetNumCandidates(ctrlPointIdx);
+	outWeights.setZero(m_numJoints);
+	if (m_solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR) {
+		Eigen::VectorXf candidateWeights = m_lhsMatrices[ctrlPointIdx].colPivHouseholderQr().solve(m_rhsVectors[ctrlPointIdx]);
+		for (int candidateIdx = 0; candidateIdx < numCandidates; candidateIdx++) {
+			outWeights(candidates[candidateIdx]) = candidateWeights(candidateIdx);
+		}
+		return;
+	}
+
+	const Vec3& restPosition = m_restPositions[ctrlPointIdx];
+	Eigen::Vector4d restPositionHomogeneous(restPosition.x, restPosition.y, restPosition.z, 1.0);
+	Eigen::Matrix<double, 4, 4> restPositionOuterProduct = restPositionHomogeneous * restPositionHomogeneous.transpose();
+	Eigen::Matrix<double, 10, 1> monomials = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(restPositionOuterProduct);
+	monomials(1) *= 2.0;	//The off diagonal entries of u~ * u~^T appear twice in the quadratic form
+	monomials(2) *= 2.0;
+	monomials(3) *= 2.0;
+	monomials(5) *= 2.0;
+	monomials(6) *= 2.0;
+	monomials(8) *= 2.0;
+
+	Eigen::MatrixXd AtA(numCandidates, numCandidates);
+	for (int candidateIdx0 = 0; candidateIdx0 < numCandidates; candidateIdx0++) {
+		for (int candidateIdx1 = candidateIdx0; candidateIdx1 < numCandidates; candidateIdx1++) {
+			double value = m_jointPairGrams.row(GetJointPairIdx(candidates[candidateIdx0], candidates[candidateIdx1])).dot(monomials.transpose());
+			AtA(candidateIdx0, candidateIdx1) = value;
+			AtA(candidateIdx1, candidateIdx0) = value;
+		}
+	}
+
+	//A^T * A is only semidefinite when joints move together over every pose, or with fewer than numCandidates / 3 poses. Eigen's LDLT::solve only skips exactly zero pivots,
+	//but squaring A turns rounding into pivots of max |D| * epsilon or so, so pivots below a relative threshold are skipped too, much like the rank threshold of colPivHouseholderQr
+	Eigen::LDLT<Eigen::MatrixXd> ldlt(AtA);
+	const Eigen::VectorXd& D = ldlt.vectorD();
+	double pivotTolerance = D.cwiseAbs().maxCoeff() * (double)numCandidates * std::numeric_limits<double>::epsilon();
+	Eigen::VectorXd weights = ldlt.transpositionsP() * m_candidateAtbs.segment(m_candidates.m_offsets[ctrlPointIdx], numCandidates);
+	ldlt.matrixL().solveInPlace(weights);
+	for (int candidateIdx = 0; candidateIdx < numCandidates; candidateIdx++) {
+		weights(candidateIdx) = fabs(D(candidateIdx)) > pivotTolerance ? weights(candidateIdx) / D(candidateIdx) : 0.0;
+	}
+	ldlt.matrixU().solveInPlace(weights);
+	weights = ldlt.transpositionsP().transpose() * weights;
+	for (int candidateIdx = 0; candidateIdx < numCandidates; candidateIdx++) {
+		outWeights(candidates[candidateIdx]) = (float)weights(candidateIdx);
+	}
+}
+
+void DDMBakerLinearSystems::Clear()
+{
+	m_numJoints = 0;
+	m_numPoses = 0;
+	m_restPositions.clear();
+	m_candidates.m_offsets.clear();
+	m_candidates.m_jointIndices.clear();
+	m_lhsMatrices.clear();
+	m_rhsVectors.clear();
+	m_jointPairGrams.resize(0, 10);
+	m_candidateAtbs.resize(0);
+}
+
+size_t DDMBakerLinearSystems::GetNumBytes() const
+{
+	size_t numCandidateListBytes = (m_candidates.m_offsets.size() + m_candidates.m_jointIndices.size()) * sizeof(int);
+	return m_restPositions.size() * sizeof(Vec3) + numCandidateListBytes + GetNumBytesForCandidates(m_solveMode, GetNumControlPoints(), m_numJoints, m_numPoses, m_candidates.m_jointIndices.size());
+}
+
+size_t DDMBakerLinearSystems::GetNumBytes(DDMBakerSolveMode solveMode, int numControlPoints, int numJoints, int numPoses, int numCandidatesPerControlPoint)
+{
+	int numCandidates = (numCandidatesPerControlPoint > 0) ? std::min(numCandidatesPerControlPoint, numJoints) : numJoints;
+	return GetNumBytesForCandidates(solveMode, numControlPoints, numJoints, numPoses, (size_t)numControlPoints * (size_t)numCandidates);
+}
+
+size_t DDMBakerLinearSystems::GetNumBytesForCandidates(DDMBakerSolveMode solveMode, int numControlPoints, int numJoints, int numPoses, size_t numCandidatesOverAllControlPoints)
+{
+	if (solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR) {
+		return (size_t)(3 * numPoses) * (numCandidatesOverAllControlPoints + (size_t)numControlPoints) * sizeof(float);
+	}
+	return ((size_t)(numJoints * (numJoints + 1) / 2) * 10 + numCandidatesOverAllControlPoints) * sizeof(double);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+//The least squares systems of the DDM baker. For every control point u, the linear blend skinning weights w minimizing sum over poses of |sum_j w_j * M_j * u - v|^2,
+//where v is the direct delta mush position of that pose. Row 3 * poseIdx + c of A holds component c of M_j * u in column j, b holds v.
+//Only the candidate joints of a control point get columns in A, the others get weight 0 without being looked at.
+//Kept apart from FBXMesh so benchmarks can bake synthetic rigs. Every stage runs in parallel over control points (or joint pairs) with a fixed order per control point,
+//so the results are bit identical for any thread count
+
+enum class DDMBakerSolveMode {
+	COLUMN_PIVOTING_QR,	//Stores A and b of every control point and solves them with colPivHouseholderQr. Memory grows with the number of poses
+	NORMAL_EQUATIONS,	//Accumulates A^T * A and A^T * b while the poses come in and solves with LDLT. Memory does not depend on the number of poses
+	COUNT
+};
+
+const char* GetDDMBakerSolveModeName(DDMBakerSolveMode solveMode);
+bool GetDDMBakerSolveModeFromName(const std::string& name, DDMBakerSolveMode& outSolveMode);	//Case insensitive
+
+//The joint hierarchy flattened for generating baking poses. Each caller evaluates into its own transforms, so poses can be generated on any number of threads
+//without touching the FBXJoints
+struct DDMBakerSkeleton {
+	std::vector<int> m_parentIndices;	//-1 for roots
+	std::vector<int> m_evaluationOrder;	//Parents before their children
+	std::vector<Mat44> m_localTransformsWithoutDeltaRotate;	//See FBXJoint::GetLocalBindPoseTransformWithoutDeltaRotate
+	std::vector<Mat44> m_globalBindPoseInverses;
+
+	int GetNumJoints() const { return (int)m_parentIndices.size(); };
+	void ComputeEvaluationOrder();	//From m_parentIndices
+
+	//Pose poseIdx of a bake: every joint but joint 0 gets a random delta rotate about z, x and y of up to twistLimit degrees. The random numbers of a pose only depend on
+	//seed and poseIdx, and they are the ones a single RandomNumberGenerator(seed) would roll generating the poses one after the other.
+	//scratchGlobalTransforms is resized to the number of joints
+	void GetBakingPoseSkinningMatrices(unsigned int seed, int poseIdx, float twistLimit, std::vector<Mat44>& scratchGlobalTransforms, std::vector<Mat44>& outSkinningMatrices) const;
+};
+
+struct DDMBakerCandidateParameters {
+	int m_numMeshRings = 2;	//Rest weights of control points up to this many edges away count as the control point's own
+	int m_numSkeletonRings = 1;	//Parents and children up to this many bones away from a weighted joint become candidates too
+	int m_maxNumCandidates = 8;	//Highest ring weights first, then the closest in the skeleton. 0 keeps them all
+	double m_minRestWeight = 1.0e-4;	//Rest weights at or below this are ignored
+};
+
+//Which joints the system of each control point solves for, so a control point costs O(k) instead of O(numJoints)
+struct DDMBakerJointCandidates {
+	std::vector<int> m_offsets;	//numControlPoints + 1. Candidates of control point i are m_jointIndices[m_offsets[i]] up to m_jointIndices[m_offsets[i + 1]]
+	std::vector<int> m_jointIndices;	//Ascending per control point
+
+	int GetNumControlPoints() const { return m_offsets.empty() ? 0 : (int)m_offsets.size() - 1; };
+	int GetNumCandidates(int ctrlPointIdx) const { return m_offsets[ctrlPointIdx + 1] - m_offsets[ctrlPointIdx]; };
+	const int* GetCandidates(int ctrlPointIdx) const { return m_jointIndices.data() + m_offsets[ctrlPointIdx]; };
+	int GetMaxNumCandidates() const;
+	void SetToEveryJoint(int numControlPoints, int numJoints);	//The full solve
+};
+
+//restWeights: like FBXMesh::GetWeightsMatrix. parentIndices: -1 for roots, like DDMBakerSkeleton.
+//The rest weights are dilated over the mesh edges, taking the largest weight of every joint within m_numMeshRings edges, and then grown along the skeleton.
+//Control points without a rest weight above the minimum keep every joint
+void ComputeDDMBakerJointCandidates(JobSystem& jobSystem, const Eigen::MatrixX3i& faces, const DDMSkinWeights& restWeights, const std::vector<int>& parentIndices,
+	const DDMBakerCandidateParameters& parameters, DDMBakerJointCandidates& outCandidates);
+
+class DDMBakerLinearSystems {
+public:
+	void Prepare(DDMBakerSolveMode solveMode, const std::vector<Vec3>& restPositions, int numJoints, int numPoses, const DDMBakerJointCandidates* candidates = nullptr);	//nullptr: every joint
+	void AddPoseLHS(JobSystem& jobSystem, int poseIdx, const std::vector<Mat44>& allJointSkinningMatrices);
+	void AddPoseRHS(JobSystem& jobSystem, int poseIdx, const std::vector<Mat44>& allJointSkinningMatrices, const Eigen::MatrixX3f& deformedPositions);	//deformedPositions: one row per control point
+	void Solve(int ctrlPointIdx, Eigen::VectorXf& outWeights) const;	//numJoints weights, 0 for non candidates, not pruned or normalized. Safe to call from several threads at once
+	void Clear();
+
+	DDMBakerSolveMode GetSolveMode() const { return m_solveMode; };
+	int GetNumControlPoints() const { return (int)m_restPositions.size(); };
+	int GetNumJoints() const { return m_numJoints; };
+	const DDMBakerJointCandidates& GetCandidates() const { return m_candidates; };
+	size_t GetNumBytes() const;
+	//What Prepare allocates, without the rest positions and the candidate lists. numCandidatesPerControlPoint 0: every joint
+	static size_t GetNumBytes(DDMBakerSolveMode solveMode, int numControlPoints, int numJoints, int numPoses, int numCandidatesPerControlPoint = 0);
+
+private:
+	int GetJointPairIdx(int jointIdx0, int jointIdx1) const;	//jointIdx0 <= jointIdx1
+	static size_t GetNumBytesForCandidates(DDMBakerSolveMode solveMode, int numControlPoints, int numJoints, int numPoses, size_t numCandidatesOverAllControlPoints);
+
+	DDMBakerSolveMode m_solveMode = DDMBakerSolveMode::COLUMN_PIVOTING_QR;
+	int m_numJoints = 0;
+	int m_numPoses = 0;
+	std::vector<Vec3> m_restPositions;
+	DDMBakerJointCandidates m_candidates;
+
+	//COLUMN_PIVOTING_QR. Column c of A is candidate c
+	std::vector<Eigen::MatrixXf> m_lhsMatrices;
+	std::vector<Eigen::VectorXf> m_rhsVectors;
+
+	//NORMAL_EQUATIONS. (A^T * A)(j, k) is u~^T * G_jk * u~ with u~ = (u, 1) and G_jk the sum over poses of the top 3 rows of M_j^T times those of M_k. That quadratic form only needs
+	//the symmetric part of G_jk, which is 10 numbers in the order of FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix, so A^T * A of every control point comes from
+	//one numJointPairs x 10 matrix shared by the whole mesh
+	Eigen::Matrix<double, Eigen::Dynamic, 10> m_jointPairGrams;	//Row per joint pair j <= k
+	Eigen::VectorXd m_candidateAtbs;	//A^T * b of every control point, laid out like m_candidates.m_jointIndices
+};
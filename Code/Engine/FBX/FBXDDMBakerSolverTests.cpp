@@ -0,0 +1,93 @@
+#include "Engine/Fbx/FBXDDMBakerSolverTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+//FBXDDMBakingJob on a synthetic rig, with the CPU v0 kernel standing in for the GPU deformation
+static void BakeSyntheticRig(JobSystem& jobSystem, const DDMControlPointPackets& packets, const DDMBakerSkeleton& skeleton, const std::vector<Vec3>& restPositions,
+	DDMBakerSolveMode solveMode, int numPoses, float twistLimit, unsigned int seed, Eigen::MatrixXf& outWeights)
+{
+	constexpr int POSE_BATCH_SIZE = 64;
+	int numJoints = skeleton.GetNumJoints();
+	DDMBakerLinearSystems bakerSystems;
+	bakerSystems.Prepare(solveMode, restPositions, numJoints, numPoses);
+	std::vector<std::vector<Mat44>> batchSkinningMatrices((size_t)std::min(numPoses, POSE_BATCH_SIZE));
+	Eigen::MatrixX3f ddmPositions;
+	for (int batchBeginPoseIdx = 0; batchBeginPoseIdx < numPoses; batchBeginPoseIdx += POSE_BATCH_SIZE) {
+		int batchEndPoseIdx = std::min(batchBeginPoseIdx + POSE_BATCH_SIZE, numPoses);
+		jobSystem.ParallelForRange(batchBeginPoseIdx, batchEndPoseIdx, 1, [&](int beginPoseIdx, int endPoseIdx) {
+			std::vector<Mat44> globalTransforms;
+			for (int poseIdx = beginPoseIdx; poseIdx < endPoseIdx; poseIdx++) {
+				skeleton.GetBakingPoseSkinningMatrices(seed, poseIdx, twistLimit, globalTransforms, batchSkinningMatrices[poseIdx - batchBeginPoseIdx]);
+			}
+		});
+		for (int poseIdx = batchBeginPoseIdx; poseIdx < batchEndPoseIdx; poseIdx++) {
+			const std::vector<Mat44>& pose = batchSkinningMatrices[poseIdx - batchBeginPoseIdx];
+			ComputeDDMv0Positions(jobSystem, packets, pose, ddmPositions);
+			bakerSystems.AddPoseLHS(jobSystem, poseIdx, pose);
+			bakerSystems.AddPoseRHS(jobSystem, poseIdx, pose, ddmPositions);
+		}
+	}
+
+	outWeights.resize(numJoints, bakerSystems.GetNumControlPoints());
+	jobSystem.ParallelForRange(0, bakerSystems.GetNumControlPoints(), 16, [&](int beginCPIdx, int endCPIdx) {
+		Eigen::VectorXf weights;
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			bakerSystems.Solve(cpIdx, weights);
+			outWeights.col(cpIdx) = weights;
+		}
+	});
+}
+
+bool Command_DDMBakerThreadTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("3000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	int numPoses = atoi(args.GetValue("NumPoses", std::string("150")).c_str());
+	float twistLimit = (float)atof(args.GetValue("TwistLimit", std::string("30")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	std::vector<int> numThreadsToRun = { 1, 2, 4, 8, 16 };	//The job system caps the workers at the hardware threads
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	numControlPoints = (int)mesh.m_restPositions.rows();
+	std::vector<Vec3> restPositions(numControlPoints);
+	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+		restPositions[cpIdx] = Vec3((float)mesh.m_restPositions(cpIdx, 0), (float)mesh.m_restPositions(cpIdx, 1), (float)mesh.m_restPositions(cpIdx, 2));
+	}
+	DDMBakerSkeleton skeleton = GetSyntheticBakerSkeleton(mesh);
+
+	PrintBenchmarkLine(Stringf("DDMBakerThreadTest: %d control points, %d joints, %d poses", numControlPoints, numJoints, numPoses));
+	bool hasPassed = true;
+	for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+		DDMBakerSolveMode solveMode = (DDMBakerSolveMode)solveModeIdx;
+		Eigen::MatrixXf firstWeights;
+		for (int numThreads : numThreadsToRun) {
+			JobSystem jobSystem(JobSystemConfig(numThreads - 1));
+			jobSystem.Startup();
+			DDMSparseOmegas omegas;
+			Eigen::MatrixXd v1ConstantMatrix;
+			ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+			DDMControlPointPackets packets;
+			packets.Build(omegas, mesh.m_restPositions);
+
+			double startTime = GetCurrentTimeSeconds();
+			Eigen::MatrixXf weights;
+			BakeSyntheticRig(jobSystem, packets, skeleton, restPositions, solveMode, numPoses, twistLimit, seed, weights);
+			double bakeSeconds = GetCurrentTimeSeconds() - startTime;
+			int numThreadsUsed = jobSystem.GetNumWorkerThreads() + 1;
+			jobSystem.Shutdown();
+
+			if (firstWeights.size() == 0) {
+				firstWeights = weights;
+			}
+			bool isIdentical = weights.size() == firstWeights.size() && memcmp(weights.data(), firstWeights.data(), (size_t)weights.size() * sizeof(float)) == 0;
+			hasPassed = hasPassed && isIdentical;
+			PrintBenchmarkLine(Stringf("  %-15s %2d threads asked, %2d used: %9.1lf ms, bit identical %s", GetDDMBakerSolveModeName(solveMode), numThreads, numThreadsUsed, bakeSeconds * 1000.0,
+				GetBenchmarkCheckString(isIdentical)));
+		}
+	}
+	return hasPassed;
+}
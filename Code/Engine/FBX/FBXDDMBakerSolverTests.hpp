@@ -0,0 +1,4 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+bool Command_DDMBakerThreadTest(EventArgs& args);	//Bakes with 1 to 16 threads and checks the weights stay bit identical
@@ -3,50 +3,68 @@
 #include "Engine/Fbx/FBxParser.hpp"
 #include "Engine/Fbx/FBXMesh.hpp"
 #include "Engine/Fbx/FBXJoint.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include <algorithm>
+#include <map>
 
-FBXDDMBakingJob::FBXDDMBakingJob(FBXModel& model, FBXParser& parser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold)
-	: m_model(model), m_parser(parser), m_exportFileName(exportFileName), m_numPoses(numPoses), m_numMaxBones(numMaxBones), m_twistLimit(twistLimit), m_pruneThreshold(pruneThreshold)
+FBXDDMBakingJob::FBXDDMBakingJob(FBXModel& model, FBXParser& parser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold,
+	DDMBakerSolveMode solveMode, unsigned int seed, int maxNumCandidateJoints)
+	: m_model(model), m_parser(parser), m_exportFileName(exportFileName), m_numPoses(numPoses), m_numMaxBones(numMaxBones), m_twistLimit(twistLimit), m_pruneThreshold(pruneThreshold),
+	m_solveMode(solveMode), m_seed(seed), m_maxNumCandidateJoints(maxNumCandidateJoints)
 {
+	//Taken on the main thread, so the job never reads joints the gizmos or the animation might be changing
+	int numJoints = (int)m_model.m_joints.size();
+	std::map<const FBXJoint*, int> jointIndices;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		GUARANTEE_OR_DIE(m_model.m_joints[jointIdx] != nullptr, "FBXModel::m_joints[i] == nullptr");
+		jointIndices[m_model.m_joints[jointIdx]] = jointIdx;
+	}
+	m_skeleton.m_parentIndices.resize(numJoints);
+	m_skeleton.m_localTransformsWithoutDeltaRotate.resize(numJoints);
+	m_skeleton.m_globalBindPoseInverses.resize(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		const FBXJoint* joint = m_model.m_joints[jointIdx];
+		auto parentIter = jointIndices.find(joint->GetParentJoint());
+		m_skeleton.m_parentIndices[jointIdx] = (jointIdx == 0 || parentIter == jointIndices.end()) ? -1 : parentIter->second;	//Joint 0 is where the model's updates start from
+		m_skeleton.m_localTransformsWithoutDeltaRotate[jointIdx] = joint->GetLocalBindPoseTransformWithoutDeltaRotate();
+		m_skeleton.m_globalBindPoseInverses[jointIdx] = joint->GetGlobalBindPoseInverse();
+	}
+	m_skeleton.ComputeEvaluationOrder();
 }
 
 void FBXDDMBakingJob::Execute()
 {
-	RandomNumberGenerator rng;
-	int numJoints = (int)m_model.GetNumJoints();
-
+	DDMBakerCandidateParameters candidateParameters;
+	candidateParameters.m_maxNumCandidates = std::max(m_maxNumCandidateJoints, m_numMaxBones);	//Fewer candidates than kept bones would waste the bones
 	for (int meshIdx = 0; meshIdx < m_model.m_meshes.size(); meshIdx++) {
 		GUARANTEE_OR_DIE(m_model.m_meshes[meshIdx] != nullptr, "FBXModel::m_meshes[i] == nullptr");
-		m_model.m_meshes[meshIdx]->PrepareDDMBaker(m_numPoses);
+		m_model.m_meshes[meshIdx]->PrepareDDMBaker(m_numPoses, m_solveMode, m_maxNumCandidateJoints > 0 ? &candidateParameters : nullptr, m_skeleton.m_parentIndices);
 	}
 
-	//m_model.m_joints[0]->ResetLocalDeltaTranslate();
-	m_model.m_joints[0]->ResetLocalDeltaRotate();
-	for (int poseIdx = 0; poseIdx < m_numPoses; poseIdx++) {
-		for (int jointIdx = 1; jointIdx < numJoints; jointIdx++) {
-			Quaternion randomDeltaRotate = Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-m_twistLimit, m_twistLimit), Vec3(0.0f, 0.0f, 1.0f));
-			randomDeltaRotate = randomDeltaRotate * Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-m_twistLimit, m_twistLimit), Vec3(1.0f, 0.0f, 0.0f));
-			randomDeltaRotate = randomDeltaRotate * Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-m_twistLimit, m_twistLimit), Vec3(0.0f, 1.0f, 0.0f));
-			m_model.m_joints[jointIdx]->SetLocalDeltaRotate(randomDeltaRotate);
-		}
-		m_model.m_joints[0]->RecursivelyUpdateGlobalTransformBindPoseForThisFrame(Mat44());
-		std::vector<Mat44> allJointSkinningMatrices;
-		for (int i = 0; i < m_model.m_joints.size(); i++) {
-			if (m_model.m_joints[i]) {
-				allJointSkinningMatrices.emplace_back(m_model.m_joints[i]->GetSkinningMatrixForThisFrame());
+	//Poses are generated a batch at a time on every thread, each one into its own transforms. The DDM deformation runs on the GPU, so the meshes then take the poses
+	//one after the other, with their fills spread over the control points
+	std::vector<std::vector<Mat44>> batchSkinningMatrices((size_t)std::min(m_numPoses, POSE_BATCH_SIZE));
+	for (int batchBeginPoseIdx = 0; batchBeginPoseIdx < m_numPoses; batchBeginPoseIdx += POSE_BATCH_SIZE) {
+		int batchEndPoseIdx = std::min(batchBeginPoseIdx + POSE_BATCH_SIZE, m_numPoses);
+		g_theJobSystem->ParallelForRange(batchBeginPoseIdx, batchEndPoseIdx, 1, [&](int beginPoseIdx, int endPoseIdx) {
+			std::vector<Mat44> globalTransforms;
+			for (int poseIdx = beginPoseIdx; poseIdx < endPoseIdx; poseIdx++) {
+				m_skeleton.GetBakingPoseSkinningMatrices(m_seed, poseIdx, m_twistLimit, globalTransforms, batchSkinningMatrices[poseIdx - batchBeginPoseIdx]);
 			}
-		}
+		});
 
-		for (int meshIdx = 0; meshIdx < m_model.m_meshes.size(); meshIdx++) {
-			GUARANTEE_OR_DIE(m_model.m_meshes[meshIdx] != nullptr, "FBXModel::m_meshes[i] == nullptr");
-			m_model.m_meshes[meshIdx]->FillLHSMatForDDMBaker(allJointSkinningMatrices, poseIdx);
-			m_model.m_meshes[meshIdx]->FillRHSMatForDDMBaker(allJointSkinningMatrices, poseIdx);
+		for (int poseIdx = batchBeginPoseIdx; poseIdx < batchEndPoseIdx; poseIdx++) {
+			const std::vector<Mat44>& allJointSkinningMatrices = batchSkinningMatrices[poseIdx - batchBeginPoseIdx];
+			for (int meshIdx = 0; meshIdx < m_model.m_meshes.size(); meshIdx++) {
+				m_model.m_meshes[meshIdx]->FillLHSMatForDDMBaker(allJointSkinningMatrices, poseIdx);
+				m_model.m_meshes[meshIdx]->FillRHSMatForDDMBaker(allJointSkinningMatrices, poseIdx);
+			}
 		}
 	}
 
 	for (int meshIdx = 0; meshIdx < m_model.m_meshes.size(); meshIdx++) {
-		GUARANTEE_OR_DIE(m_model.m_meshes[meshIdx] != nullptr, "FBXModel::m_meshes[i] == nullptr");
 		m_model.m_meshes[meshIdx]->SolveDDMBakerLinearSystems(m_numMaxBones, m_pruneThreshold);
 		m_model.m_meshes[meshIdx]->UpdateSceneBakedSkinningData();
 	}
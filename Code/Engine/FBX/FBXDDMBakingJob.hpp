@@ -1,12 +1,16 @@
 #pragma once
 #include "Engine/Multithread/Job.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
 #include <vector>
 #include <string>
 #include <Eigen/Dense>
 
 class FBXDDMBakingJob : public Job {
 public:
-	FBXDDMBakingJob(class FBXModel& model, class FBXParser& parser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold);
+	//Copies the joint hierarchy, so has to be constructed on the thread that owns the model. The same seed bakes the same weights on any number of threads.
+	//maxNumCandidateJoints 0 solves for every joint at every control point
+	FBXDDMBakingJob(class FBXModel& model, class FBXParser& parser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold,
+		DDMBakerSolveMode solveMode, unsigned int seed, int maxNumCandidateJoints);
 	void Execute() override;
 	void OnComplete() override;
 
@@ -18,4 +22,10 @@ public:
 	int m_numMaxBones = 0;
 	float m_twistLimit = 0.0f;
 	float m_pruneThreshold = 0.0f;
+	DDMBakerSolveMode m_solveMode = DDMBakerSolveMode::COLUMN_PIVOTING_QR;
+	unsigned int m_seed = 0;
+	int m_maxNumCandidateJoints = 0;
+	DDMBakerSkeleton m_skeleton;
+
+	static constexpr int POSE_BATCH_SIZE = 64;	//Poses whose skinning matrices are generated together
 };
\ No newline at end of file
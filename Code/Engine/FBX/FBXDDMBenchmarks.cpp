@@ -0,0 +1,1693 @@
+#include "Engine/Fbx/FBXDDMBenchmarks.hpp"
+#include "Engine/Fbx/FBXCookedModelTests.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolverTests.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPUTests.hpp"
+#include "Engine/Fbx/FBXDDMModifierTests.hpp"
+#include "Engine/Fbx/FBXDDMPrecomputeCacheTests.hpp"
+#include "Engine/Fbx/FBXDDMPrecomputeTests.hpp"
+#include "Engine/Fbx/FBXDDMVertexWritebackTests.hpp"
+#include "Engine/Fbx/FBXSkeletonTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMHeadlessBenchmark.hpp"
+#include "Engine/Fbx/FBXControlPoint.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXDDMPrecomputeCache.hpp"
+#include "Engine/Fbx/FBXMeshAsset.hpp"
+#include "Engine/Fbx/FBXSkeleton.hpp"
+#include "Engine/Fbx/FBXVertexDedup.hpp"
+#include "Engine/Fbx/Vertex_FBX.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <Eigen/SparseCholesky>
+
+DDMv0KernelBenchmarkResult RunDDMv0KernelBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, double omegaEpsilon, int maxNumReferenceControlPoints, unsigned int seed)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0, "numControlPoints <= 0");
+	GUARANTEE_OR_DIE(numJoints > 0, "numJoints <= 0");
+
+	DDMv0KernelBenchmarkResult result;
+	result.m_numControlPoints = numControlPoints;
+	result.m_numJoints = numJoints;
+	result.m_numReferenceControlPoints = std::min(numControlPoints, std::max(maxNumReferenceControlPoints, 0));
+
+	RandomNumberGenerator rng(seed);
+	std::vector<Mat44> jointTransforms = GetSyntheticJointTransforms(numJoints, rng);
+	std::vector<float> jointTransformsFloats;
+	ConvertJointTransformsToFloats(jointTransforms, jointTransformsFloats);
+	SyntheticDDMMesh mesh = GetSyntheticMesh(numControlPoints, numJoints, rng);
+
+	DDMSparseOmegas omegas;
+	BuildSyntheticOmegas(mesh, numControlPoints, omegaEpsilon, omegas);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions);
+	result.m_numDenseOmegaBytes = DDMSparseOmegas::GetNumDenseBytes(numControlPoints, numJoints);
+	result.m_numSparseOmegaBytes = omegas.GetNumBytes();
+	result.m_numPacketBytes = packets.GetNumBytes();
+	result.m_numInfluences = omegas.GetNumInfluences();
+	for (int packetIdx = 0; packetIdx < packets.GetNumPackets(); packetIdx++) {
+		result.m_numPacketJoints += packets.GetNumJointsOfPacket(packetIdx);
+	}
+
+	//The reference keeps every joint, so its error also covers what the epsilon cut off
+	DDMSparseOmegas referenceOmegas;
+	BuildSyntheticOmegas(mesh, result.m_numReferenceControlPoints, -1.0, referenceOmegas);
+	std::vector<Eigen::Matrix<double, 4, 4>> jointTransformsEigen;
+	for (const Mat44& jointTransform : jointTransforms) {
+		jointTransformsEigen.push_back(FBXDDMModifier::ConvertMat44ToEigen(jointTransform));
+	}
+	Eigen::MatrixX3f referencePositions(result.m_numReferenceControlPoints, 3);
+	double startTime = GetCurrentTimeSeconds();
+	for (int ctrlPointIdx = 0; ctrlPointIdx < result.m_numReferenceControlPoints; ctrlPointIdx++) {
+		referencePositions.row(ctrlPointIdx) = ComputeDDMv0DeformedControlPointReference(referenceOmegas, ctrlPointIdx, mesh.m_restPositions.row(ctrlPointIdx), jointTransformsEigen);
+	}
+	result.m_referenceSeconds = GetCurrentTimeSeconds() - startTime;
+
+	std::vector<float> deformedPositions((size_t)numControlPoints * 3);
+	DDMSimdLevel highestSimdLevel = GetHighestSupportedDDMSimdLevel();
+	for (int simdLevelIdx = 0; simdLevelIdx < (int)DDMSimdLevel::COUNT; simdLevelIdx++) {
+		DDMSimdLevel simdLevel = (DDMSimdLevel)simdLevelIdx;
+		if (simdLevel > highestSimdLevel) {
+			continue;
+		}
+		result.m_isSimdLevelSupported[simdLevelIdx] = true;
+
+		std::fill(deformedPositions.begin(), deformedPositions.end(), 0.0f);
+		startTime = GetCurrentTimeSeconds();
+		ComputeDDMv0DeformedControlPoints(packets, jointTransformsFloats.data(), 0, packets.GetNumPackets(), deformedPositions.data(), 3, 1, simdLevel);
+		result.m_singleThreadSeconds[simdLevelIdx] = GetCurrentTimeSeconds() - startTime;
+
+		for (int ctrlPointIdx = 0; ctrlPointIdx < result.m_numReferenceControlPoints; ctrlPointIdx++) {
+			const float* deformedPosition = deformedPositions.data() + (size_t)ctrlPointIdx * 3;
+			Eigen::Vector3d difference((double)deformedPosition[0] - referencePositions(ctrlPointIdx, 0), (double)deformedPosition[1] - referencePositions(ctrlPointIdx, 1),
+				(double)deformedPosition[2] - referencePositions(ctrlPointIdx, 2));
+			result.m_maxErrorToReference[simdLevelIdx] = std::max(result.m_maxErrorToReference[simdLevelIdx], difference.norm());
+		}
+	}
+
+	result.m_numParallelThreads = jobSystem.GetNumWorkerThreads() + 1;
+	startTime = GetCurrentTimeSeconds();
+	jobSystem.ParallelForRange(0, packets.GetNumPackets(), 8, [&](int beginPacketIdx, int endPacketIdx) {
+		ComputeDDMv0DeformedControlPoints(packets, jointTransformsFloats.data(), beginPacketIdx, endPacketIdx, deformedPositions.data(), 3, 1, highestSimdLevel);
+	});
+	result.m_parallelSeconds = GetCurrentTimeSeconds() - startTime;
+
+	return result;
+}
+
+//What the precompute stores for variant 1: P_i - p_i * p_i^T divided by its determinant, from the neighborhood the synthetic omegas are built from
+static Eigen::MatrixXd GetSyntheticV1ConstantMatrix(const SyntheticDDMMesh& mesh, int numControlPoints)
+{
+	Eigen::MatrixXd v1ConstantMatrix(numControlPoints, 6);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		Eigen::Matrix<double, 1, 10> neighborhood10 = Eigen::Map<const Eigen::Matrix<double, 1, 10>>(mesh.m_neighborhoods.data() + (size_t)ctrlPointIdx * 10);
+		Eigen::Matrix<double, 4, 4> neighborhood = FBXDDMModifier::GetSymmetricMatrix4x4From10Floats(neighborhood10) / neighborhood10(9);
+		Eigen::Matrix<double, 3, 1> p_i = neighborhood.block(0, 3, 3, 1);
+		Eigen::Matrix<double, 3, 3> P_i_matrix = neighborhood.block(0, 0, 3, 3) - p_i * p_i.transpose();
+		P_i_matrix /= P_i_matrix.determinant();
+		v1ConstantMatrix.row(ctrlPointIdx) = FBXDDMModifier::GetUpperTriangleOfSymmetric3x3Matrix(P_i_matrix);
+	}
+	return v1ConstantMatrix;
+}
+
+//FBXDDMModifierCPU's variant 1 as it was before ComputeDDMv1DeformedControlPoints: double precision Eigen per control point, a general inverse and determinant,
+//and R_i used as it comes out, without making it a rotation. Kept as the baseline the benchmark compares against
+static Eigen::Matrix<float, 1, 3> ComputeDDMv1DeformedControlPointLegacy(const DDMSparseOmegas& omegas, int ctrlPointIdx, const Eigen::Matrix<double, 1, 3>& restPosition,
+	const Eigen::Matrix<double, 1, 6>& v1Constants, const std::vector<Eigen::Matrix<double, 4, 4>>& allJointTransformsEigen)
+{
+	Eigen::Matrix<double, 4, 4> QMatrix_i;
+	QMatrix_i.setZero();
+	int endInfluenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx) + omegas.GetNumInfluencesOfControlPoint(ctrlPointIdx);
+	for (int influenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx); influenceIdx < endInfluenceIdx; influenceIdx++) {
+		Eigen::Matrix<double, 1, 10> omega = Eigen::Map<const Eigen::Matrix<float, 1, 10>>(omegas.GetOmega(influenceIdx)).cast<double>();
+		QMatrix_i += allJointTransformsEigen[omegas.GetJointIdx(influenceIdx)] * FBXDDMModifier::GetSymmetricMatrix4x4From10Floats(omega);
+	}
+	QMatrix_i /= QMatrix_i(QMatrix_i.rows() - 1, QMatrix_i.cols() - 1);
+
+	Eigen::Matrix<double, 3, 3> Q_i = QMatrix_i.block(0, 0, 3, 3);
+	Eigen::Matrix<double, 3, 1> q_i = QMatrix_i.block(0, 3, 3, 1);
+	Eigen::Matrix<double, 3, 1> p_i = QMatrix_i.block(3, 0, 1, 3).transpose();
+	Eigen::Matrix<double, 3, 3> Q_qp = Q_i - q_i * p_i.transpose();
+
+	Eigen::Matrix<double, 3, 3> R_i = Q_qp.determinant() * (Q_qp).transpose().inverse() * FBXDDMModifier::GetSymmetricMatrix3x3From6Floats(v1Constants);
+	Eigen::Matrix<double, 3, 1> t_i = q_i - R_i * p_i;
+
+	Eigen::Matrix<double, 4, 4> gamma_i;
+	gamma_i.block(0, 0, 3, 3) = R_i;
+	gamma_i.block(3, 0, 1, 3).setZero();
+	gamma_i.block(3, 3, 1, 1).setOnes();
+	gamma_i.block(0, 3, 3, 1) = t_i;
+
+	Eigen::Matrix<double, 4, 1> affineCurrentControlPoint;
+	affineCurrentControlPoint.block(0, 0, 3, 1) = restPosition.transpose();
+	affineCurrentControlPoint.block(3, 0, 1, 1).setOnes();
+
+	return (gamma_i * affineCurrentControlPoint).block(0, 0, 3, 1).transpose().cast<float>();
+}
+
+DDMv1KernelBenchmarkResult RunDDMv1KernelBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, double omegaEpsilon, int maxNumReferenceControlPoints, unsigned int seed)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0, "numControlPoints <= 0");
+	GUARANTEE_OR_DIE(numJoints > 0, "numJoints <= 0");
+
+	DDMv1KernelBenchmarkResult result;
+	result.m_numControlPoints = numControlPoints;
+	result.m_numJoints = numJoints;
+	result.m_numReferenceControlPoints = std::min(numControlPoints, std::max(maxNumReferenceControlPoints, 0));
+
+	RandomNumberGenerator rng(seed);
+	std::vector<Mat44> jointTransforms = GetSyntheticJointTransforms(numJoints, rng);
+	std::vector<float> jointTransformsFloats;
+	ConvertJointTransformsToFloats(jointTransforms, jointTransformsFloats);
+	std::vector<Eigen::Matrix<double, 4, 4>> jointTransformsEigen;
+	for (const Mat44& jointTransform : jointTransforms) {
+		jointTransformsEigen.push_back(FBXDDMModifier::ConvertMat44ToEigen(jointTransform));
+	}
+	SyntheticDDMMesh mesh = GetSyntheticMesh(numControlPoints, numJoints, rng);
+	Eigen::MatrixXd v1ConstantMatrix = GetSyntheticV1ConstantMatrix(mesh, numControlPoints);
+
+	DDMSparseOmegas omegas;
+	BuildSyntheticOmegas(mesh, numControlPoints, omegaEpsilon, omegas);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions, &v1ConstantMatrix);
+
+	//The old path already skipped the joints that don't influence a control point, so it gets the same sparse omegas
+	Eigen::MatrixX3f legacyPositions(numControlPoints, 3);
+	double startTime = GetCurrentTimeSeconds();
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		legacyPositions.row(ctrlPointIdx) = ComputeDDMv1DeformedControlPointLegacy(omegas, ctrlPointIdx, mesh.m_restPositions.row(ctrlPointIdx), v1ConstantMatrix.row(ctrlPointIdx),
+			jointTransformsEigen);
+	}
+	result.m_legacySeconds = GetCurrentTimeSeconds() - startTime;
+
+	DDMSparseOmegas referenceOmegas;
+	BuildSyntheticOmegas(mesh, result.m_numReferenceControlPoints, -1.0, referenceOmegas);
+	Eigen::MatrixX3f referencePositions(result.m_numReferenceControlPoints, 3);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < result.m_numReferenceControlPoints; ctrlPointIdx++) {
+		referencePositions.row(ctrlPointIdx) = ComputeDDMv1DeformedControlPointReference(referenceOmegas, ctrlPointIdx, mesh.m_restPositions.row(ctrlPointIdx),
+			v1ConstantMatrix.row(ctrlPointIdx), jointTransformsEigen);
+	}
+
+	std::vector<float> deformedPositions((size_t)numControlPoints * 3);
+	DDMSimdLevel highestSimdLevel = GetHighestSupportedDDMSimdLevel();
+	for (int simdLevelIdx = 0; simdLevelIdx < (int)DDMSimdLevel::COUNT; simdLevelIdx++) {
+		DDMSimdLevel simdLevel = (DDMSimdLevel)simdLevelIdx;
+		if (simdLevel > highestSimdLevel) {
+			continue;
+		}
+		result.m_isSimdLevelSupported[simdLevelIdx] = true;
+
+		std::fill(deformedPositions.begin(), deformedPositions.end(), 0.0f);
+		startTime = GetCurrentTimeSeconds();
+		ComputeDDMv1DeformedControlPoints(packets, jointTransformsFloats.data(), 0, packets.GetNumPackets(), deformedPositions.data(), 3, 1, simdLevel);
+		result.m_singleThreadSeconds[simdLevelIdx] = GetCurrentTimeSeconds() - startTime;
+
+		for (int ctrlPointIdx = 0; ctrlPointIdx < result.m_numReferenceControlPoints; ctrlPointIdx++) {
+			Eigen::Map<const Eigen::Matrix<float, 1, 3>> deformedPosition(deformedPositions.data() + (size_t)ctrlPointIdx * 3);
+			result.m_maxErrorToReference[simdLevelIdx] = std::max(result.m_maxErrorToReference[simdLevelIdx], (double)(deformedPosition - referencePositions.row(ctrlPointIdx)).norm());
+		}
+	}
+
+	//Where the old R_i was far from a rotation, the old result shears and scales the rest position. This is how far that moved it
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		Eigen::Map<const Eigen::Matrix<float, 1, 3>> deformedPosition(deformedPositions.data() + (size_t)ctrlPointIdx * 3);
+		result.m_maxDistanceToLegacy = std::max(result.m_maxDistanceToLegacy, (double)(deformedPosition - legacyPositions.row(ctrlPointIdx)).norm());
+	}
+
+	result.m_numParallelThreads = jobSystem.GetNumWorkerThreads() + 1;
+	startTime = GetCurrentTimeSeconds();
+	jobSystem.ParallelForRange(0, packets.GetNumPackets(), 8, [&](int beginPacketIdx, int endPacketIdx) {
+		ComputeDDMv1DeformedControlPoints(packets, jointTransformsFloats.data(), beginPacketIdx, endPacketIdx, deformedPositions.data(), 3, 1, highestSimdLevel);
+	});
+	result.m_parallelSeconds = GetCurrentTimeSeconds() - startTime;
+
+	return result;
+}
+
+//FBXDDMModifier::Precompute as it was before ComputeDDMPrecompute: a new LDLT per solver, one thread, and Psi as the dense n x 10m matrix turned sparse.
+//Kept as the baseline the benchmark compares against
+static void ComputeDDMPrecomputeSerial(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const Eigen::MatrixXd& weightsMatrix,
+	bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha, double omegaEpsilon,
+	DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix, DDMPrecomputeStageTimings& outTimings)
+{
+	int numControlPoints = (int)restPositions.rows();
+	int numJoints = (int)weightsMatrix.cols();
+
+	double startTime = GetCurrentTimeSeconds();
+	Eigen::SparseMatrix<double> normalizedLaplacian;
+	ComputeDDMNormalizedLaplacian(restPositions, faces, useCotangentLaplacian, normalizedLaplacian);
+	outTimings.m_laplacianSeconds = GetCurrentTimeSeconds() - startTime;
+
+	startTime = GetCurrentTimeSeconds();
+	Eigen::SparseMatrix<double> identity(normalizedLaplacian.rows(), normalizedLaplacian.cols());
+	identity.setIdentity();
+	Eigen::SparseMatrix<double> c = (identity + kappa * normalizedLaplacian);
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldltSolverC(c.transpose());
+	Eigen::MatrixXd weightsPrimeMatrix(weightsMatrix);
+	for (int iter = 0; iter < numLaplacianIterations; iter++) {
+		weightsPrimeMatrix = ldltSolverC.solve(weightsPrimeMatrix);
+	}
+	outTimings.m_smoothedWeightsSeconds = GetCurrentTimeSeconds() - startTime;
+
+	startTime = GetCurrentTimeSeconds();
+	Eigen::Matrix<double, Eigen::Dynamic, 10> UxUCached(numControlPoints, 10);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		Eigen::Matrix<double, 1, 4> affineCtrlPoint(restPositions(ctrlPointIdx, 0), restPositions(ctrlPointIdx, 1), restPositions(ctrlPointIdx, 2), 1.0);
+		Eigen::Matrix<double, 4, 4> u_k_x_u_k_transpose = (affineCtrlPoint.transpose() * affineCtrlPoint);
+		UxUCached.row(ctrlPointIdx) = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(u_k_x_u_k_transpose);
+	}
+	Eigen::MatrixXd UxUMultipliedWithW(numControlPoints, 10 * numJoints);
+	for (int jointIndex = 0; jointIndex < numJoints; jointIndex++) {
+		for (int x = 0; x < 10; x++) {
+			UxUMultipliedWithW.col(10 * jointIndex + x) = weightsMatrix.col(jointIndex).array() * UxUCached.col(x).array();
+		}
+	}
+	Eigen::SparseMatrix<double> PsiMatrix = UxUMultipliedWithW.sparseView();
+	UxUMultipliedWithW.resize(0, 0);
+	Eigen::SparseMatrix<double> b = (identity + lambda * normalizedLaplacian);
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldltSolverB(b.transpose());
+	for (int iter = 0; iter < numLaplacianIterations; iter++) {
+		PsiMatrix = ldltSolverB.solve(PsiMatrix);
+	}
+
+	Eigen::Matrix<double, Eigen::Dynamic, 10> PMatrix(numControlPoints, 10);
+	outV1ConstantMatrix.resize(numControlPoints, 6);
+	for (int ctrlPointIndex = 0; ctrlPointIndex < numControlPoints; ctrlPointIndex++) {
+		Eigen::Matrix<double, 3, 1> p_i;
+		p_i.setZero();
+		Eigen::Matrix<double, 3, 3> P_i;
+		P_i.setZero();
+		double normalizerValue = 0.0;
+		for (int jointIndex = 0; jointIndex < numJoints; jointIndex++) {
+			p_i += Eigen::Matrix<double, 3, 1>(PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 3), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 6), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 8));
+			Eigen::Matrix<double, 3, 3> tempToAddToP_i;
+			tempToAddToP_i << PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 1), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 2),
+				PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 1), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 4), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 5),
+				PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 2), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 5), PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 7);
+			P_i += tempToAddToP_i;
+			normalizerValue += PsiMatrix.coeff(ctrlPointIndex, jointIndex * 10 + 9);
+		}
+		p_i /= normalizerValue;
+		P_i /= normalizerValue;
+
+		Eigen::Matrix<double, 4, 4> p_i_matrix;
+		p_i_matrix.block(0, 0, 3, 3) = p_i * p_i.transpose();
+		p_i_matrix.block(0, 3, 3, 1) = p_i;
+		p_i_matrix.block(3, 0, 1, 3) = p_i.transpose();
+		p_i_matrix(3, 3) = 1.0;
+		PMatrix.row(ctrlPointIndex) = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(p_i_matrix);
+
+		Eigen::Matrix<double, 3, 3> P_i_matrix = P_i - (p_i * p_i.transpose());
+		if (P_i_matrix.determinant() != 0.0) {
+			P_i_matrix = P_i_matrix / P_i_matrix.determinant();
+		}
+		else {
+			P_i_matrix += P_i_matrix + 1e-6 * Eigen::Matrix<double, 3, 3>::Identity();
+			P_i_matrix = P_i_matrix / P_i_matrix.determinant();
+		}
+		outV1ConstantMatrix.row(ctrlPointIndex) = FBXDDMModifier::GetUpperTriangleOfSymmetric3x3Matrix(P_i_matrix);
+	}
+	outTimings.m_pMatrixSeconds = GetCurrentTimeSeconds() - startTime;
+
+	startTime = GetCurrentTimeSeconds();
+	std::vector<std::vector<int>> influencingJointsPerControlPoint(numControlPoints);
+	std::vector<int> numInfluencesPerControlPoint(numControlPoints);
+	std::vector<double> omegaWeights(numJoints);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			omegaWeights[jointIdx] = ((1.0 - alpha) * PsiMatrix.coeff(ctrlPointIdx, jointIdx * 10 + DDMSparseOmegas::OMEGA_WEIGHT_IDX)) + (alpha * weightsPrimeMatrix(ctrlPointIdx, jointIdx));
+		}
+		DDMSparseOmegas::GetInfluencingJoints(omegaWeights.data(), numJoints, omegaEpsilon, influencingJointsPerControlPoint[ctrlPointIdx]);
+		numInfluencesPerControlPoint[ctrlPointIdx] = (int)influencingJointsPerControlPoint[ctrlPointIdx].size();
+	}
+	outOmegas.Resize(numJoints, numInfluencesPerControlPoint);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		Eigen::Matrix<double, 1, 10> pRow = PMatrix.row(ctrlPointIdx);
+		int influenceIdx = outOmegas.GetFirstInfluenceIdx(ctrlPointIdx);
+		for (int jointIdx : influencingJointsPerControlPoint[ctrlPointIdx]) {
+			Eigen::Matrix<double, 1, 10> currentPsi = PsiMatrix.block(ctrlPointIdx, jointIdx * 10, 1, 10);
+			Eigen::Matrix<double, 1, 10> currentOmega = ((1.0 - alpha) * currentPsi) + (alpha * weightsPrimeMatrix(ctrlPointIdx, jointIdx) * pRow);
+			outOmegas.SetInfluence(influenceIdx, jointIdx, currentOmega.data());
+			influenceIdx++;
+		}
+	}
+	outTimings.m_omegasSeconds = GetCurrentTimeSeconds() - startTime;
+}
+
+DDMPrecomputeBenchmarkResult RunDDMPrecomputeBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numLaplacianIterations, bool runSerialPipeline)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0, "numControlPoints <= 0");
+	GUARANTEE_OR_DIE(numJoints > 0, "numJoints <= 0");
+	constexpr double LAMBDA = 0.5;
+	constexpr double KAPPA = 0.1;
+	constexpr double ALPHA = 0.5;
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	DDMPrecomputeBenchmarkResult result;
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	result.m_numJoints = numJoints;
+	result.m_numSerialPsiBytes = (size_t)result.m_numControlPoints * 10 * numJoints * sizeof(double);
+
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, numLaplacianIterations, LAMBDA, KAPPA, ALPHA, DDMSparseOmegas::DEFAULT_EPSILON,
+		omegas, v1ConstantMatrix, &result.m_timings);
+	if (!runSerialPipeline) {
+		return result;
+	}
+
+	DDMSparseOmegas serialOmegas;
+	Eigen::MatrixXd serialV1ConstantMatrix;
+	ComputeDDMPrecomputeSerial(mesh.m_restPositions, mesh.m_faces, mesh.m_weights, true, numLaplacianIterations, LAMBDA, KAPPA, ALPHA, DDMSparseOmegas::DEFAULT_EPSILON,
+		serialOmegas, serialV1ConstantMatrix, result.m_serialTimings);
+
+	result.m_doInfluencesMatch = omegas.GetFirstInfluenceIndices() == serialOmegas.GetFirstInfluenceIndices() && omegas.GetJointIndices() == serialOmegas.GetJointIndices();
+	if (result.m_doInfluencesMatch) {
+		for (size_t i = 0; i < omegas.GetOmegas().size(); i++) {
+			result.m_maxOmegaError = std::max(result.m_maxOmegaError, (double)fabsf(omegas.GetOmegas()[i] - serialOmegas.GetOmegas()[i]));
+		}
+	}
+	for (int ctrlPointIdx = 0; ctrlPointIdx < result.m_numControlPoints; ctrlPointIdx++) {
+		double v1ConstantError = (v1ConstantMatrix.row(ctrlPointIdx) - serialV1ConstantMatrix.row(ctrlPointIdx)).norm();
+		result.m_maxV1ConstantRelativeError = std::max(result.m_maxV1ConstantRelativeError, v1ConstantError / std::max(serialV1ConstantMatrix.row(ctrlPointIdx).norm(), 1.0e-12));
+	}
+	return result;
+}
+
+void RegisterFBXDDMBenchmarkCommands()
+{
+	static bool s_areCommandsRegistered = false;	//Every FBXParser calls this with ENGINE_ENABLE_BENCHMARK_COMMANDS
+	if (s_areCommandsRegistered || g_theEventSystem == nullptr) {
+		return;
+	}
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMv0KernelBenchmark", Command_DDMv0KernelBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMSparseOmegaReport", Command_DDMSparseOmegaReport);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMPrecomputeCacheTest", Command_DDMPrecomputeCacheTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMPrecomputeCacheRoundTripTest", Command_DDMPrecomputeCacheRoundTripTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMPrecomputeBenchmark", Command_DDMPrecomputeBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMIncrementalPrecomputeTest", Command_DDMIncrementalPrecomputeTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMv1KernelBenchmark", Command_DDMv1KernelBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMPolarDecompositionTest", Command_DDMPolarDecompositionTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMHeadlessBenchmark", Command_DDMHeadlessBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMBakerBenchmark", Command_DDMBakerBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMBakerThreadTest", Command_DDMBakerThreadTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMBakerCandidateBenchmark", Command_DDMBakerCandidateBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMSkinWeightsBenchmark", Command_DDMSkinWeightsBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMVertexWritebackTest", Command_DDMVertexWritebackTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("CPUSkinningBenchmark", Command_CPUSkinningBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("FBXVertexDedupBenchmark", Command_FBXVertexDedupBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("FBXCookedModelTest", Command_FBXCookedModelTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("FBXSkeletonBenchmark", Command_FBXSkeletonBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("FBXSkeletonPartialUpdateTest", Command_FBXSkeletonPartialUpdateTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("FBXModelInstancingBenchmark", Command_FBXModelInstancingBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("DDMModifierSharingTest", Command_DDMModifierSharingTest);
+	s_areCommandsRegistered = true;
+}
+
+bool Command_DDMv0KernelBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("0")).c_str());	//0: 10k, 50k, 100k and 500k
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("8")).c_str());
+	double omegaEpsilon = atof(args.GetValue("Epsilon", Stringf("%g", DDMSparseOmegas::DEFAULT_EPSILON)).c_str());
+	int maxNumReferenceControlPoints = atoi(args.GetValue("NumReferencePoints", std::string("20000")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.001")).c_str());	//The synthetic mesh spans [-1, 1]
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMv0KernelBenchmark needs g_theJobSystem");
+	std::vector<int> numControlPointsToRun = { 10000, 50000, 100000, 500000 };
+	if (numControlPoints > 0) {
+		numControlPointsToRun = { numControlPoints };
+	}
+
+	bool hasPassed = true;
+	for (int numControlPointsOfRun : numControlPointsToRun) {
+		DDMv0KernelBenchmarkResult result = RunDDMv0KernelBenchmark(*g_theJobSystem, numControlPointsOfRun, numJoints, omegaEpsilon, maxNumReferenceControlPoints, seed);
+		PrintBenchmarkLine(Stringf("DDMv0KernelBenchmark: %d control points, %d joints, %.1lf MB of packed omegas", result.m_numControlPoints, result.m_numJoints,
+			(double)result.m_numPacketBytes / (1024.0 * 1024.0)));
+		double referenceNanosecondsPerPoint = result.m_referenceSeconds * 1.0e9 / (double)std::max(result.m_numReferenceControlPoints, 1);
+		PrintBenchmarkLine(Stringf("  Double precision path: %.1lf ns per control point (over %d control points)", referenceNanosecondsPerPoint, result.m_numReferenceControlPoints));
+		for (int simdLevelIdx = 0; simdLevelIdx < (int)DDMSimdLevel::COUNT; simdLevelIdx++) {
+			const char* simdLevelName = GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx);
+			if (!result.m_isSimdLevelSupported[simdLevelIdx]) {
+				PrintBenchmarkLine(Stringf("  %-6s: not supported on this CPU", simdLevelName));
+				continue;
+			}
+			double nanosecondsPerPoint = result.m_singleThreadSeconds[simdLevelIdx] * 1.0e9 / (double)result.m_numControlPoints;
+			bool isWithinTolerance = result.m_maxErrorToReference[simdLevelIdx] <= tolerance;
+			hasPassed = hasPassed && isWithinTolerance;
+			PrintBenchmarkLine(Stringf("  %-6s: %.3lf ms, %.1lf ns per control point (x%.2lf), max error %.2e %s", simdLevelName, result.m_singleThreadSeconds[simdLevelIdx] * 1000.0,
+				nanosecondsPerPoint, referenceNanosecondsPerPoint / nanosecondsPerPoint, result.m_maxErrorToReference[simdLevelIdx], GetBenchmarkCheckString(isWithinTolerance)));
+		}
+		PrintBenchmarkLine(Stringf("  %s on %d threads: %.3lf ms (%.1lf M control points/s)", GetDDMSimdLevelName(GetHighestSupportedDDMSimdLevel()), result.m_numParallelThreads,
+			result.m_parallelSeconds * 1000.0, (double)result.m_numControlPoints / result.m_parallelSeconds * 1.0e-6));
+	}
+	return hasPassed;
+}
+
+bool Command_DDMSparseOmegaReport(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("100000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("0")).c_str());	//0: 10, 25, 50 and 100
+	double omegaEpsilon = atof(args.GetValue("Epsilon", Stringf("%g", DDMSparseOmegas::DEFAULT_EPSILON)).c_str());
+	int maxNumReferenceControlPoints = atoi(args.GetValue("NumReferencePoints", std::string("2000")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.001")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMSparseOmegaReport needs g_theJobSystem");
+	std::vector<int> numJointsToRun = { 10, 25, 50, 100 };
+	if (numJoints > 0) {
+		numJointsToRun = { numJoints };
+	}
+
+	bool hasPassed = true;
+	int simdLevelIdx = (int)GetHighestSupportedDDMSimdLevel();
+	const double bytesToMB = 1.0 / (1024.0 * 1024.0);
+	PrintBenchmarkLine(Stringf("DDMSparseOmegaReport: %d control points, epsilon %g, %s kernel on one thread", numControlPoints, omegaEpsilon, GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx)));
+	for (int numJointsOfRun : numJointsToRun) {
+		DDMv0KernelBenchmarkResult allJointsResult = RunDDMv0KernelBenchmark(*g_theJobSystem, numControlPoints, numJointsOfRun, -1.0, maxNumReferenceControlPoints, seed);
+		DDMv0KernelBenchmarkResult sparseResult = RunDDMv0KernelBenchmark(*g_theJobSystem, numControlPoints, numJointsOfRun, omegaEpsilon, maxNumReferenceControlPoints, seed);
+		double allJointsNanosecondsPerPoint = allJointsResult.m_singleThreadSeconds[simdLevelIdx] * 1.0e9 / (double)numControlPoints;
+		double sparseNanosecondsPerPoint = sparseResult.m_singleThreadSeconds[simdLevelIdx] * 1.0e9 / (double)numControlPoints;
+		bool isWithinTolerance = sparseResult.m_maxErrorToReference[simdLevelIdx] <= tolerance;
+		hasPassed = hasPassed && isWithinTolerance;
+
+		PrintBenchmarkLine(Stringf("  %3d joints: dense omega matrix %.1lf MB, sparse omegas %.1lf MB (%.2lf influences per control point), packets %.1lf MB (%.2lf joints per packet)",
+			numJointsOfRun, (double)sparseResult.m_numDenseOmegaBytes * bytesToMB, (double)sparseResult.m_numSparseOmegaBytes * bytesToMB,
+			(double)sparseResult.m_numInfluences / (double)numControlPoints, (double)sparseResult.m_numPacketBytes * bytesToMB,
+			(double)sparseResult.m_numPacketJoints * DDMControlPointPackets::PACKET_SIZE / (double)numControlPoints));
+		PrintBenchmarkLine(Stringf("             every joint %.1lf ns per control point, sparse %.1lf ns per control point (x%.2lf), max error to every joint %.2e %s",
+			allJointsNanosecondsPerPoint, sparseNanosecondsPerPoint, allJointsNanosecondsPerPoint / sparseNanosecondsPerPoint,
+			sparseResult.m_maxErrorToReference[simdLevelIdx], GetBenchmarkCheckString(isWithinTolerance)));
+	}
+	return hasPassed;
+}
+
+bool Command_DDMPrecomputeBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("0")).c_str());	//0: 5k, 50k and 200k
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	int numLaplacianIterations = atoi(args.GetValue("Iterations", std::string("8")).c_str());
+	bool runSerialPipeline = args.GetValue("Serial", std::string("true")) == "true";
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.000001")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMPrecomputeBenchmark needs g_theJobSystem");
+	std::vector<int> numControlPointsToRun = { 5000, 50000, 200000 };
+	if (numControlPoints > 0) {
+		numControlPointsToRun = { numControlPoints };
+	}
+
+	bool hasPassed = true;
+	for (int numControlPointsOfRun : numControlPointsToRun) {
+		DDMPrecomputeBenchmarkResult result = RunDDMPrecomputeBenchmark(*g_theJobSystem, numControlPointsOfRun, numJoints, numLaplacianIterations, runSerialPipeline);
+		const DDMPrecomputeStageTimings& timings = result.m_timings;
+		PrintBenchmarkLine(Stringf("DDMPrecomputeBenchmark: %d control points, %d joints, %d iterations, %d threads", result.m_numControlPoints, result.m_numJoints, numLaplacianIterations,
+			g_theJobSystem->GetNumWorkerThreads() + 1));
+		if (!runSerialPipeline) {
+			PrintBenchmarkLine(Stringf("  Laplacian %.1lf ms, smoothed weights %.1lf ms, P matrix %.1lf ms, omegas %.1lf ms, total %.1lf ms", timings.m_laplacianSeconds * 1000.0,
+				timings.m_smoothedWeightsSeconds * 1000.0, timings.m_pMatrixSeconds * 1000.0, timings.m_omegasSeconds * 1000.0, timings.GetTotalSeconds() * 1000.0));
+			continue;
+		}
+
+		const DDMPrecomputeStageTimings& serialTimings = result.m_serialTimings;
+		const char* stageNames[] = { "Laplacian", "Smoothed weights", "P matrix", "Omegas", "Total" };
+		double stageSeconds[] = { timings.m_laplacianSeconds, timings.m_smoothedWeightsSeconds, timings.m_pMatrixSeconds, timings.m_omegasSeconds, timings.GetTotalSeconds() };
+		double serialStageSeconds[] = { serialTimings.m_laplacianSeconds, serialTimings.m_smoothedWeightsSeconds, serialTimings.m_pMatrixSeconds, serialTimings.m_omegasSeconds,
+			serialTimings.GetTotalSeconds() };
+		for (int stageIdx = 0; stageIdx < 5; stageIdx++) {
+			PrintBenchmarkLine(Stringf("  %-16s serial %9.1lf ms, now %9.1lf ms (x%.2lf)", stageNames[stageIdx], serialStageSeconds[stageIdx] * 1000.0, stageSeconds[stageIdx] * 1000.0,
+				serialStageSeconds[stageIdx] / std::max(stageSeconds[stageIdx], 1.0e-9)));
+		}
+		bool isWithinTolerance = result.m_doInfluencesMatch && result.m_maxOmegaError <= tolerance && result.m_maxV1ConstantRelativeError <= tolerance;
+		hasPassed = hasPassed && isWithinTolerance;
+		PrintBenchmarkLine(Stringf("  Serial Psi needed a %.1lf MB dense matrix. Influences %s, max omega error %.2e, max v1 constant relative error %.2e %s",
+			(double)result.m_numSerialPsiBytes / (1024.0 * 1024.0), result.m_doInfluencesMatch ? "match" : "differ", result.m_maxOmegaError, result.m_maxV1ConstantRelativeError,
+			GetBenchmarkCheckString(isWithinTolerance)));
+	}
+	return hasPassed;
+}
+
+bool Command_DDMv1KernelBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("0")).c_str());	//0: 10k, 100k and 500k
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("8")).c_str());
+	double omegaEpsilon = atof(args.GetValue("Epsilon", Stringf("%g", DDMSparseOmegas::DEFAULT_EPSILON)).c_str());
+	int maxNumReferenceControlPoints = atoi(args.GetValue("NumReferencePoints", std::string("20000")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.001")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMv1KernelBenchmark needs g_theJobSystem");
+	std::vector<int> numControlPointsToRun = { 10000, 100000, 500000 };
+	if (numControlPoints > 0) {
+		numControlPointsToRun = { numControlPoints };
+	}
+
+	bool hasPassed = true;
+	for (int numControlPointsOfRun : numControlPointsToRun) {
+		DDMv1KernelBenchmarkResult result = RunDDMv1KernelBenchmark(*g_theJobSystem, numControlPointsOfRun, numJoints, omegaEpsilon, maxNumReferenceControlPoints, seed);
+		PrintBenchmarkLine(Stringf("DDMv1KernelBenchmark: %d control points, %d joints", result.m_numControlPoints, result.m_numJoints));
+		double legacyNanosecondsPerPoint = result.m_legacySeconds * 1.0e9 / (double)result.m_numControlPoints;
+		PrintBenchmarkLine(Stringf("  Before (Eigen, inverse and determinant): %.3lf ms, %.1lf ns per control point", result.m_legacySeconds * 1000.0, legacyNanosecondsPerPoint));
+		for (int simdLevelIdx = 0; simdLevelIdx < (int)DDMSimdLevel::COUNT; simdLevelIdx++) {
+			const char* simdLevelName = GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx);
+			if (!result.m_isSimdLevelSupported[simdLevelIdx]) {
+				PrintBenchmarkLine(Stringf("  %-6s: not supported on this CPU", simdLevelName));
+				continue;
+			}
+			double nanosecondsPerPoint = result.m_singleThreadSeconds[simdLevelIdx] * 1.0e9 / (double)result.m_numControlPoints;
+			bool isWithinTolerance = result.m_maxErrorToReference[simdLevelIdx] <= tolerance;
+			hasPassed = hasPassed && isWithinTolerance;
+			PrintBenchmarkLine(Stringf("  %-6s: %.3lf ms, %.1lf ns per control point (x%.2lf), max error %.2e %s", simdLevelName, result.m_singleThreadSeconds[simdLevelIdx] * 1000.0,
+				nanosecondsPerPoint, legacyNanosecondsPerPoint / nanosecondsPerPoint, result.m_maxErrorToReference[simdLevelIdx], GetBenchmarkCheckString(isWithinTolerance)));
+		}
+		PrintBenchmarkLine(Stringf("  Largest move against the unorthogonalized R_i of before: %.2e", result.m_maxDistanceToLegacy));
+		PrintBenchmarkLine(Stringf("  %s on %d threads: %.3lf ms (%.1lf M control points/s)", GetDDMSimdLevelName(GetHighestSupportedDDMSimdLevel()), result.m_numParallelThreads,
+			result.m_parallelSeconds * 1000.0, (double)result.m_numControlPoints / result.m_parallelSeconds * 1.0e-6));
+	}
+	return hasPassed;
+}
+
+bool Command_DDMHeadlessBenchmark(EventArgs& args)
+{
+	DDMHeadlessBenchmarkConfig config;
+	for (const std::string& optionName : GetDDMHeadlessBenchmarkOptionNames()) {
+		std::string value = args.GetValue(optionName, std::string());
+		std::string errorStr;
+		if (!value.empty() && !SetDDMHeadlessBenchmarkOption(config, optionName, value, &errorStr)) {
+			PrintBenchmarkLine(Stringf("DDMHeadlessBenchmark: %s", errorStr.c_str()));
+			return false;
+		}
+	}
+
+	DDMHeadlessBenchmarkReport report = RunDDMHeadlessBenchmark(config);
+	for (const std::string& line : GetDDMHeadlessBenchmarkSummaryLines(report)) {
+		PrintBenchmarkLine(line);
+	}
+	if (!config.m_outputPath.empty()) {
+		std::string errorStr;
+		if (!SaveDDMHeadlessBenchmarkJson(config.m_outputPath, report, &errorStr)) {
+			PrintBenchmarkLine(errorStr);
+			return false;
+		}
+		PrintBenchmarkLine(Stringf("  Wrote %s", config.m_outputPath.c_str()));
+	}
+	return report.HasPassed();
+}
+
+//weights: numJoints x numControlPoints
+static double GetLBSRMSError(const Eigen::MatrixXf& weights, const std::vector<Mat44>& pose, const std::vector<Vec3>& restPositions, const Eigen::MatrixX3f& targetPositions)
+{
+	int numControlPoints = (int)restPositions.size();
+	double sumSquaredErrors = 0.0;
+	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+		Vec3 lbsPosition;
+		for (int jointIdx = 0; jointIdx < (int)weights.rows(); jointIdx++) {
+			if (weights(jointIdx, cpIdx) != 0.0f) {
+				lbsPosition += weights(jointIdx, cpIdx) * pose[jointIdx].TransformPosition3D(restPositions[cpIdx]);
+			}
+		}
+		Vec3 error = lbsPosition - Vec3(targetPositions(cpIdx, 0), targetPositions(cpIdx, 1), targetPositions(cpIdx, 2));
+		sumSquaredErrors += (double)error.GetLengthSquared();
+	}
+	return sqrt(sumSquaredErrors / (double)std::max(numControlPoints, 1));
+}
+
+DDMBakerBenchmarkResult RunDDMBakerBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, float twistLimit, size_t maxNumQRBytes, unsigned int seed)
+{
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	DDMBakerBenchmarkResult result;
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	result.m_numJoints = numJoints;
+	result.m_numPoses = numPoses;
+
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions);
+
+	std::vector<Vec3> restPositions(result.m_numControlPoints);
+	for (int cpIdx = 0; cpIdx < result.m_numControlPoints; cpIdx++) {
+		restPositions[cpIdx] = Vec3((float)mesh.m_restPositions(cpIdx, 0), (float)mesh.m_restPositions(cpIdx, 1), (float)mesh.m_restPositions(cpIdx, 2));
+	}
+
+	DDMBakerLinearSystems bakerSystems[(int)DDMBakerSolveMode::COUNT];
+	for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+		DDMBakerSolveMode solveMode = (DDMBakerSolveMode)solveModeIdx;
+		if (solveMode == DDMBakerSolveMode::COLUMN_PIVOTING_QR && DDMBakerLinearSystems::GetNumBytes(solveMode, result.m_numControlPoints, numJoints, numPoses) > maxNumQRBytes) {
+			continue;
+		}
+		result.m_didRunSolveMode[solveModeIdx] = true;
+		double startTime = GetCurrentTimeSeconds();
+		bakerSystems[solveModeIdx].Prepare(solveMode, restPositions, numJoints, numPoses);
+		result.m_fillSeconds[solveModeIdx] += GetCurrentTimeSeconds() - startTime;
+		result.m_numBakerBytes[solveModeIdx] = bakerSystems[solveModeIdx].GetNumBytes();
+	}
+
+	DDMBakerSkeleton skeleton = GetSyntheticBakerSkeleton(mesh);
+	std::vector<Mat44> globalTransforms;
+	std::vector<Mat44> pose;
+	Eigen::MatrixX3f ddmPositions;
+	for (int poseIdx = 0; poseIdx < numPoses; poseIdx++) {
+		skeleton.GetBakingPoseSkinningMatrices(seed, poseIdx, twistLimit, globalTransforms, pose);
+		double startTime = GetCurrentTimeSeconds();
+		ComputeDDMv0Positions(jobSystem, packets, pose, ddmPositions);
+		result.m_ddmSeconds += GetCurrentTimeSeconds() - startTime;
+		for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+			if (result.m_didRunSolveMode[solveModeIdx]) {
+				startTime = GetCurrentTimeSeconds();
+				bakerSystems[solveModeIdx].AddPoseLHS(jobSystem, poseIdx, pose);
+				bakerSystems[solveModeIdx].AddPoseRHS(jobSystem, poseIdx, pose, ddmPositions);
+				result.m_fillSeconds[solveModeIdx] += GetCurrentTimeSeconds() - startTime;
+			}
+		}
+	}
+
+	std::vector<Mat44> heldOutPose;
+	skeleton.GetBakingPoseSkinningMatrices(seed, numPoses, twistLimit, globalTransforms, heldOutPose);	//The pose after the last baked one
+	ComputeDDMv0Positions(jobSystem, packets, heldOutPose, ddmPositions);
+	Eigen::MatrixXf bakedWeights[(int)DDMBakerSolveMode::COUNT];
+	for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+		if (!result.m_didRunSolveMode[solveModeIdx]) {
+			continue;
+		}
+		bakedWeights[solveModeIdx].resize(numJoints, result.m_numControlPoints);
+		double startTime = GetCurrentTimeSeconds();
+		jobSystem.ParallelForRange(0, result.m_numControlPoints, 16, [&](int beginCPIdx, int endCPIdx) {
+			Eigen::VectorXf weights;
+			for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+				bakerSystems[solveModeIdx].Solve(cpIdx, weights);
+				bakedWeights[solveModeIdx].col(cpIdx) = weights;
+			}
+		});
+		result.m_solveSeconds[solveModeIdx] = GetCurrentTimeSeconds() - startTime;
+		bakerSystems[solveModeIdx].Clear();
+
+		result.m_heldOutRMSError[solveModeIdx] = GetLBSRMSError(bakedWeights[solveModeIdx], heldOutPose, restPositions, ddmPositions);
+	}
+	if (result.m_didRunSolveMode[(int)DDMBakerSolveMode::COLUMN_PIVOTING_QR] && result.m_didRunSolveMode[(int)DDMBakerSolveMode::NORMAL_EQUATIONS]) {
+		result.m_maxWeightDifference = (double)(bakedWeights[(int)DDMBakerSolveMode::COLUMN_PIVOTING_QR] - bakedWeights[(int)DDMBakerSolveMode::NORMAL_EQUATIONS]).cwiseAbs().maxCoeff();
+	}
+	return result;
+}
+
+bool Command_DDMBakerBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("5000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	int numPoses = atoi(args.GetValue("NumPoses", std::string("0")).c_str());	//0: 50, 200, 1000 and 4000
+	float twistLimit = (float)atof(args.GetValue("TwistLimit", std::string("30")).c_str());
+	double maxQRMegabytes = atof(args.GetValue("MaxQRMegabytes", std::string("2048")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.001")).c_str());	//Held out RMS error the normal equations may add on top of QR's
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMBakerBenchmark needs g_theJobSystem");
+	std::vector<int> numPosesToRun = { 50, 200, 1000, 4000 };
+	if (numPoses > 0) {
+		numPosesToRun = { numPoses };
+	}
+
+	bool hasPassed = true;
+	for (int numPosesOfRun : numPosesToRun) {
+		DDMBakerBenchmarkResult result = RunDDMBakerBenchmark(*g_theJobSystem, numControlPoints, numJoints, numPosesOfRun, twistLimit, (size_t)(maxQRMegabytes * 1024.0 * 1024.0), seed);
+		PrintBenchmarkLine(Stringf("DDMBakerBenchmark: %d control points, %d joints, %d poses, DDM of every pose %.1lf ms", result.m_numControlPoints, result.m_numJoints, result.m_numPoses,
+			result.m_ddmSeconds * 1000.0));
+		for (int solveModeIdx = 0; solveModeIdx < (int)DDMBakerSolveMode::COUNT; solveModeIdx++) {
+			const char* solveModeName = GetDDMBakerSolveModeName((DDMBakerSolveMode)solveModeIdx);
+			if (!result.m_didRunSolveMode[solveModeIdx]) {
+				PrintBenchmarkLine(Stringf("  %-15s skipped, it would need %.1lf MB", solveModeName,
+					(double)DDMBakerLinearSystems::GetNumBytes((DDMBakerSolveMode)solveModeIdx, result.m_numControlPoints, numJoints, numPosesOfRun) / (1024.0 * 1024.0)));
+				continue;
+			}
+			PrintBenchmarkLine(Stringf("  %-15s %9.1lf MB, fill %9.1lf ms, solve %9.1lf ms, held out pose RMS error %.3e", solveModeName,
+				(double)result.m_numBakerBytes[solveModeIdx] / (1024.0 * 1024.0), result.m_fillSeconds[solveModeIdx] * 1000.0, result.m_solveSeconds[solveModeIdx] * 1000.0,
+				result.m_heldOutRMSError[solveModeIdx]));
+		}
+
+		//Negated comparisons, so a Nan error fails
+		double normalEquationsError = result.m_heldOutRMSError[(int)DDMBakerSolveMode::NORMAL_EQUATIONS];
+		bool isWithinTolerance = std::isfinite(normalEquationsError);
+		if (result.m_didRunSolveMode[(int)DDMBakerSolveMode::COLUMN_PIVOTING_QR]) {
+			isWithinTolerance = isWithinTolerance && !(normalEquationsError > result.m_heldOutRMSError[(int)DDMBakerSolveMode::COLUMN_PIVOTING_QR] + tolerance);
+			PrintBenchmarkLine(Stringf("  Max weight difference %.3e %s", result.m_maxWeightDifference, GetBenchmarkCheckString(isWithinTolerance)));
+		}
+		else {
+			PrintBenchmarkLine(Stringf("  Nothing to compare against %s", GetBenchmarkCheckString(isWithinTolerance)));
+		}
+		hasPassed = hasPassed && isWithinTolerance;
+	}
+	return hasPassed;
+}
+
+//What FBXMesh::SolveDDMBakerLinearSystems does with the solved weights: the numMaxBones largest of every control point, normalized
+static void KeepLargestWeights(Eigen::MatrixXf& inOutWeights, int numMaxBones)
+{
+	std::vector<float> sortedWeights;
+	for (int cpIdx = 0; cpIdx < (int)inOutWeights.cols(); cpIdx++) {
+		auto weights = inOutWeights.col(cpIdx);
+		if (numMaxBones < (int)weights.size()) {
+			sortedWeights.assign(weights.data(), weights.data() + weights.size());
+			std::nth_element(sortedWeights.begin(), sortedWeights.begin() + (numMaxBones - 1), sortedWeights.end(), std::greater<float>());
+			float minKeptWeight = sortedWeights[numMaxBones - 1];
+			for (int jointIdx = 0; jointIdx < (int)weights.size(); jointIdx++) {
+				if (weights(jointIdx) < minKeptWeight) {
+					weights(jointIdx) = 0.0f;
+				}
+			}
+		}
+		weights = weights.cwiseMax(0.0f);
+		float sum = weights.sum();
+		if (sum > 0.0f) {
+			weights /= sum;
+		}
+	}
+}
+
+std::vector<DDMBakerCandidateBenchmarkResult> RunDDMBakerCandidateBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, float twistLimit,
+	DDMBakerSolveMode solveMode, int numMaxBones, const std::vector<int>& maxNumCandidatesToRun, unsigned int seed)
+{
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	numControlPoints = (int)mesh.m_restPositions.rows();
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions);
+	std::vector<Vec3> restPositions(numControlPoints);
+	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+		restPositions[cpIdx] = Vec3((float)mesh.m_restPositions(cpIdx, 0), (float)mesh.m_restPositions(cpIdx, 1), (float)mesh.m_restPositions(cpIdx, 2));
+	}
+
+	//Every run bakes the same poses, so they are deformed once. The last one is held out
+	DDMBakerSkeleton skeleton = GetSyntheticBakerSkeleton(mesh);
+	std::vector<Mat44> globalTransforms;
+	std::vector<std::vector<Mat44>> poses(numPoses + 1);
+	std::vector<Eigen::MatrixX3f> ddmPositions(numPoses + 1);
+	for (int poseIdx = 0; poseIdx <= numPoses; poseIdx++) {
+		skeleton.GetBakingPoseSkinningMatrices(seed, poseIdx, twistLimit, globalTransforms, poses[poseIdx]);
+		ComputeDDMv0Positions(jobSystem, packets, poses[poseIdx], ddmPositions[poseIdx]);
+	}
+
+	std::vector<DDMBakerCandidateBenchmarkResult> results;
+	Eigen::MatrixXf fullWeights;
+	std::vector<int> maxNumCandidatesOfRuns = { 0 };	//The full solve first, the others are compared against it
+	for (int maxNumCandidates : maxNumCandidatesToRun) {
+		if (maxNumCandidates > 0) {
+			maxNumCandidatesOfRuns.push_back(maxNumCandidates);
+		}
+	}
+	for (int maxNumCandidates : maxNumCandidatesOfRuns) {
+		DDMBakerCandidateBenchmarkResult result;
+		result.m_numControlPoints = numControlPoints;
+		result.m_numJoints = numJoints;
+		result.m_numPoses = numPoses;
+		result.m_maxNumCandidates = maxNumCandidates;
+
+		DDMBakerJointCandidates candidates;
+		double startTime = GetCurrentTimeSeconds();
+		if (maxNumCandidates > 0) {
+			DDMBakerCandidateParameters candidateParameters;
+			candidateParameters.m_maxNumCandidates = maxNumCandidates;
+			ComputeDDMBakerJointCandidates(jobSystem, mesh.m_faces, mesh.m_weights.sparseView(), skeleton.m_parentIndices, candidateParameters, candidates);
+		}
+		else {
+			candidates.SetToEveryJoint(numControlPoints, numJoints);
+		}
+		result.m_candidateSeconds = GetCurrentTimeSeconds() - startTime;
+		result.m_averageNumCandidates = (double)candidates.m_jointIndices.size() / (double)std::max(numControlPoints, 1);
+
+		DDMBakerLinearSystems bakerSystems;
+		startTime = GetCurrentTimeSeconds();
+		bakerSystems.Prepare(solveMode, restPositions, numJoints, numPoses, &candidates);
+		for (int poseIdx = 0; poseIdx < numPoses; poseIdx++) {
+			bakerSystems.AddPoseLHS(jobSystem, poseIdx, poses[poseIdx]);
+			bakerSystems.AddPoseRHS(jobSystem, poseIdx, poses[poseIdx], ddmPositions[poseIdx]);
+		}
+		result.m_fillSeconds = GetCurrentTimeSeconds() - startTime;
+		result.m_numBakerBytes = bakerSystems.GetNumBytes();
+
+		Eigen::MatrixXf weights(numJoints, numControlPoints);
+		startTime = GetCurrentTimeSeconds();
+		jobSystem.ParallelForRange(0, numControlPoints, 16, [&](int beginCPIdx, int endCPIdx) {
+			Eigen::VectorXf cpWeights;
+			for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+				bakerSystems.Solve(cpIdx, cpWeights);
+				weights.col(cpIdx) = cpWeights;
+			}
+		});
+		result.m_solveSeconds = GetCurrentTimeSeconds() - startTime;
+		bakerSystems.Clear();
+
+		result.m_heldOutRMSError = GetLBSRMSError(weights, poses[numPoses], restPositions, ddmPositions[numPoses]);
+		KeepLargestWeights(weights, numMaxBones);
+		result.m_heldOutRMSErrorLargestWeights = GetLBSRMSError(weights, poses[numPoses], restPositions, ddmPositions[numPoses]);
+		if (maxNumCandidates == 0) {
+			fullWeights = weights;
+		}
+		result.m_maxWeightDifferenceToFull = (double)(weights - fullWeights).cwiseAbs().maxCoeff();
+		results.push_back(result);
+	}
+	return results;
+}
+
+bool Command_DDMBakerCandidateBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("5000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("64")).c_str());
+	int numPoses = atoi(args.GetValue("NumPoses", std::string("200")).c_str());
+	float twistLimit = (float)atof(args.GetValue("TwistLimit", std::string("30")).c_str());
+	int numMaxBones = atoi(args.GetValue("NumMaxBones", std::string("4")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.1")).c_str());	//Relative increase of the held out error after keeping the largest weights
+	std::string solveModeName = args.GetValue("SolveMode", std::string("NormalEquations"));
+	DDMBakerSolveMode solveMode = DDMBakerSolveMode::NORMAL_EQUATIONS;
+	if (!GetDDMBakerSolveModeFromName(solveModeName, solveMode)) {
+		PrintBenchmarkLine(Stringf("DDMBakerCandidateBenchmark: unknown SolveMode %s", solveModeName.c_str()));
+		return false;
+	}
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMBakerCandidateBenchmark needs g_theJobSystem");
+	std::vector<DDMBakerCandidateBenchmarkResult> results = RunDDMBakerCandidateBenchmark(*g_theJobSystem, numControlPoints, numJoints, numPoses, twistLimit, solveMode, numMaxBones,
+		{ 4, 6, 8, 12 }, seed);
+	PrintBenchmarkLine(Stringf("DDMBakerCandidateBenchmark: %s, %d control points, %d joints, %d poses, %d bones kept", GetDDMBakerSolveModeName(solveMode),
+		results[0].m_numControlPoints, numJoints, numPoses, numMaxBones));
+	bool hasPassed = true;
+	for (const DDMBakerCandidateBenchmarkResult& result : results) {
+		//Negated comparison, so a Nan error fails
+		bool isWithinTolerance = !(result.m_heldOutRMSErrorLargestWeights > results[0].m_heldOutRMSErrorLargestWeights * (1.0 + tolerance));
+		hasPassed = hasPassed && isWithinTolerance;
+		PrintBenchmarkLine(Stringf("  %-4s %5.2lf candidates: %8.1lf MB, candidates %7.1lf ms, fill %8.1lf ms, solve %8.1lf ms, held out RMS %.3e, %d largest %.3e, max weight difference %.3e %s",
+			result.m_maxNumCandidates > 0 ? Stringf("<=%d", result.m_maxNumCandidates).c_str() : "all", result.m_averageNumCandidates, (double)result.m_numBakerBytes / (1024.0 * 1024.0),
+			result.m_candidateSeconds * 1000.0, result.m_fillSeconds * 1000.0, result.m_solveSeconds * 1000.0, result.m_heldOutRMSError, numMaxBones,
+			result.m_heldOutRMSErrorLargestWeights, result.m_maxWeightDifferenceToFull, GetBenchmarkCheckString(isWithinTolerance)));
+	}
+	return hasPassed;
+}
+
+//FBXMesh::GetWeightsMatrix before the weights were cached: a dense matrix filled from the joint weight pairs on every call
+static Eigen::MatrixXd GetDenseWeightsMatrix(const std::vector<FBXControlPoint*>& controlPoints, int numJoints)
+{
+	Eigen::MatrixXd weightsMatrix;
+	weightsMatrix.resize((Eigen::Index)controlPoints.size(), numJoints);
+	weightsMatrix.setZero();
+	for (int rowIdx = 0; rowIdx < (int)controlPoints.size(); rowIdx++) {
+		for (const JointWeightPair& jointWeightPair : controlPoints[rowIdx]->m_jointWeightPairs) {
+			weightsMatrix(rowIdx, jointWeightPair.m_jointIndex) = jointWeightPair.m_weight;
+		}
+	}
+	return weightsMatrix;
+}
+
+DDMSkinWeightsBenchmarkResult RunDDMSkinWeightsBenchmark(int numControlPoints, int numJoints, int numWeightsPerControlPoint, int numRepeats)
+{
+	DDMSkinWeightsBenchmarkResult result;
+	result.m_numControlPoints = numControlPoints;
+	result.m_numJoints = numJoints;
+	numWeightsPerControlPoint = std::min(numWeightsPerControlPoint, numJoints);
+	numRepeats = std::max(numRepeats, 1);
+
+	//Control points walk along the joints, each one weighted to a few consecutive joints with falling weights
+	std::vector<FBXControlPoint*> controlPoints((size_t)numControlPoints);
+	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+		controlPoints[cpIdx] = new FBXControlPoint(Vec3((float)cpIdx, 0.0f, 0.0f));
+		int firstJointIdx = (int)(((int64_t)cpIdx * numJoints) / std::max(numControlPoints, 1));
+		float weightSum = 0.0f;
+		for (int weightIdx = 0; weightIdx < numWeightsPerControlPoint; weightIdx++) {
+			weightSum += 1.0f / (float)(weightIdx + 1);
+		}
+		for (int weightIdx = 0; weightIdx < numWeightsPerControlPoint; weightIdx++) {
+			controlPoints[cpIdx]->m_jointWeightPairs.emplace_back((unsigned int)((firstJointIdx + weightIdx) % numJoints), 1.0f / ((float)(weightIdx + 1) * weightSum));
+		}
+	}
+	Eigen::MatrixX3d restPositions = Eigen::MatrixX3d::Random(numControlPoints, 3);
+
+	double startTime = GetCurrentTimeSeconds();
+	DDMSkinWeights skinWeights = GetDDMSkinWeights(controlPoints, numJoints, false);
+	result.m_sparseBuildSeconds = GetCurrentTimeSeconds() - startTime;
+	result.m_numSparseBytes = (size_t)skinWeights.nonZeros() * (sizeof(double) + sizeof(int)) + (size_t)(skinWeights.outerSize() + 1) * sizeof(int);
+	result.m_numDenseBytes = (size_t)numControlPoints * (size_t)numJoints * sizeof(double);
+
+	//Every call to the old accessors paid for a full copy, so they are timed as such. The new ones hand out references
+	double checksum = 0.0;
+	for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+		startTime = GetCurrentTimeSeconds();
+		Eigen::MatrixXd denseWeights = GetDenseWeightsMatrix(controlPoints, numJoints);
+		result.m_denseAccessorSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		checksum += denseWeights(numControlPoints / 2, 0);
+
+		startTime = GetCurrentTimeSeconds();
+		Eigen::MatrixX3d restPositionsCopy = restPositions;
+		result.m_restPositionCopySeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		checksum += restPositionsCopy(numControlPoints / 2, 0);
+
+		//What a consumer pays to visit every weight: the dense rows scan all joints, the compressed ones only the stored weights
+		startTime = GetCurrentTimeSeconds();
+		double denseSum = 0.0;
+		for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+			for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+				denseSum += denseWeights(cpIdx, jointIdx) * (double)jointIdx;
+			}
+		}
+		result.m_denseScanSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+
+		startTime = GetCurrentTimeSeconds();
+		const DDMSkinWeights& skinWeightsRef = skinWeights;
+		double sparseSum = 0.0;
+		for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
+			for (DDMSkinWeights::InnerIterator weightIter(skinWeightsRef, cpIdx); weightIter; ++weightIter) {
+				sparseSum += weightIter.value() * (double)weightIter.index();
+			}
+		}
+		result.m_sparseScanSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		checksum += denseSum - sparseSum;
+
+		if (repeatIdx == 0) {
+			result.m_doWeightsMatch = Eigen::MatrixXd(skinWeights) == denseWeights;
+		}
+	}
+	result.m_checksum = checksum;
+
+	for (FBXControlPoint* controlPoint : controlPoints) {
+		delete controlPoint;
+	}
+	return result;
+}
+
+bool Command_DDMSkinWeightsBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("100000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("150")).c_str());
+	int numWeightsPerControlPoint = atoi(args.GetValue("NumWeights", std::string("4")).c_str());
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("5")).c_str());
+
+	DDMSkinWeightsBenchmarkResult result = RunDDMSkinWeightsBenchmark(numControlPoints, numJoints, numWeightsPerControlPoint, numRepeats);
+	PrintBenchmarkLine(Stringf("DDMSkinWeightsBenchmark: %d control points, %d joints, %d weights each", result.m_numControlPoints, result.m_numJoints, numWeightsPerControlPoint));
+	PrintBenchmarkLine(Stringf("  Dense  %9.2lf MB, built on every GetWeightsMatrix call %8.2lf ms, scanning it %8.2lf ms", (double)result.m_numDenseBytes / (1024.0 * 1024.0),
+		result.m_denseAccessorSeconds * 1000.0, result.m_denseScanSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("  Sparse %9.2lf MB, built once at load %8.2lf ms, accessors return references, scanning it %8.2lf ms", (double)result.m_numSparseBytes / (1024.0 * 1024.0),
+		result.m_sparseBuildSeconds * 1000.0, result.m_sparseScanSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("  GetControlPointsMatrixRestPose used to copy %.2lf ms per call. Weights %s", result.m_restPositionCopySeconds * 1000.0,
+		result.m_doWeightsMatch ? "match PASSED" : "differ FAILED"));
+	return result.m_doWeightsMatch;
+}
+
+//One ParallelForRange over the blocks of every character, so a few characters still spread over every thread. The chunks never cross from one character into the next
+static void ParallelForCharacterBlocks(JobSystem& jobSystem, int numCharacters, int numBlocksPerCharacter, int grainSize, const std::function<void(int characterIdx, int beginBlockIdx, int endBlockIdx)>& function)
+{
+	jobSystem.ParallelForRange(0, numCharacters * numBlocksPerCharacter, grainSize, [&](int beginIdx, int endIdx) {
+		for (int idx = beginIdx; idx < endIdx;) {
+			int characterIdx = idx / numBlocksPerCharacter;
+			int beginBlockIdx = idx - characterIdx * numBlocksPerCharacter;
+			int endBlockIdx = std::min(numBlocksPerCharacter, beginBlockIdx + endIdx - idx);
+			function(characterIdx, beginBlockIdx, endBlockIdx);
+			idx += endBlockIdx - beginBlockIdx;
+		}
+	});
+}
+
+CPUSkinningBenchmarkResult RunCPUSkinningBenchmark(JobSystem& jobSystem, int numVertices, int numJoints, const std::vector<int>& numCharactersToRun, int numRepeats)
+{
+	constexpr int BLOCK_GRAIN_SIZE = 32;
+	constexpr int PACKET_GRAIN_SIZE = 8;
+	numRepeats = std::max(numRepeats, 1);
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numVertices, numJoints);
+	std::vector<Vertex_FBX> restVertices;
+	GetSyntheticSkinnedRenderVertices(mesh, restVertices);
+	CPUSkinningVertexBlocks blocks;
+	blocks.Build(restVertices);
+
+	CPUSkinningBenchmarkResult result;
+	result.m_numVertices = blocks.GetNumVertices();
+	result.m_numJoints = numJoints;
+	result.m_numBlockBytes = blocks.GetNumBytes();
+	for (int blockIdx = 0; blockIdx < blocks.GetNumBlocks(); blockIdx++) {
+		result.m_averageNumInfluences += (double)blocks.GetNumInfluencesOfBlock(blockIdx) / (double)blocks.GetNumBlocks();
+	}
+
+	//Correctness and single thread cost of one character
+	std::vector<Mat44> checkPose = GetDDMSyntheticPose(mesh, 25.0f);
+	std::vector<float> positions((size_t)result.m_numVertices * 3);
+	std::vector<float> normals((size_t)result.m_numVertices * 3);
+	std::vector<float> jointData;
+	DDMSimdLevel highestSimdLevel = GetHighestSupportedDDMSimdLevel();
+	for (int methodIdx = 0; methodIdx < (int)CPUSkinningMethod::COUNT; methodIdx++) {
+		CPUSkinningMethod method = (CPUSkinningMethod)methodIdx;
+		ConvertJointTransformsForCPUSkinning(method, checkPose, jointData);
+		std::vector<Vec3> referencePositions(result.m_numVertices);
+		std::vector<Vec3> referenceNormals(result.m_numVertices);
+		for (int vertexIdx = 0; vertexIdx < result.m_numVertices; vertexIdx++) {
+			ComputeCPUSkinnedVertexReference(method, restVertices[vertexIdx], checkPose, referencePositions[vertexIdx], referenceNormals[vertexIdx]);
+		}
+
+		for (int simdLevelIdx = 0; simdLevelIdx <= (int)highestSimdLevel; simdLevelIdx++) {
+			DDMSimdLevel simdLevel = (DDMSimdLevel)simdLevelIdx;
+			result.m_isSimdLevelSupported[simdLevelIdx] = true;
+			std::fill(positions.begin(), positions.end(), 0.0f);
+			std::fill(normals.begin(), normals.end(), 0.0f);
+			double startTime = GetCurrentTimeSeconds();
+			for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+				ComputeCPUSkinnedVertices(blocks, method, jointData.data(), 0, blocks.GetNumBlocks(), positions.data(), nullptr, 3, simdLevel);
+			}
+			result.m_singleThreadSeconds[methodIdx][simdLevelIdx] = (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+
+			ComputeCPUSkinnedVertices(blocks, method, jointData.data(), 0, blocks.GetNumBlocks(), positions.data(), normals.data(), 3, simdLevel);
+			for (int vertexIdx = 0; vertexIdx < result.m_numVertices; vertexIdx++) {
+				const float* position = positions.data() + (size_t)vertexIdx * 3;
+				const float* normal = normals.data() + (size_t)vertexIdx * 3;
+				double positionError = (double)(Vec3(position[0], position[1], position[2]) - referencePositions[vertexIdx]).GetLength();
+				double normalError = (double)(Vec3(normal[0], normal[1], normal[2]) - referenceNormals[vertexIdx]).GetLength();
+				result.m_maxPositionError[methodIdx][simdLevelIdx] = std::max(result.m_maxPositionError[methodIdx][simdLevelIdx], positionError);
+				result.m_maxNormalError[methodIdx][simdLevelIdx] = std::max(result.m_maxNormalError[methodIdx][simdLevelIdx], normalError);
+			}
+		}
+	}
+
+	//DDM v0 on the same tube and weights, what the throughput gets compared against
+	Eigen::MatrixXd ddmWeights = Eigen::MatrixXd::Zero(result.m_numVertices, numJoints);
+	for (int vertexIdx = 0; vertexIdx < result.m_numVertices; vertexIdx++) {
+		Vertex_FBX vertex = restVertices[vertexIdx];
+		for (int influenceIdx = 0; influenceIdx < 4; influenceIdx++) {
+			ddmWeights(vertexIdx, vertex.m_jointIndices1[influenceIdx]) += vertex.m_jointWeights1[influenceIdx];
+			ddmWeights(vertexIdx, vertex.m_jointIndices2[influenceIdx]) += vertex.m_jointWeights2[influenceIdx];
+		}
+	}
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, ddmWeights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions, nullptr);
+
+	//Every character has its own pose, joint data and output, like separate FBXModel copies
+	result.m_numParallelThreads = jobSystem.GetNumWorkerThreads() + 1;
+	for (int numCharacters : numCharactersToRun) {
+		CPUSkinningThroughputResult throughput;
+		throughput.m_numCharacters = std::max(numCharacters, 1);
+		std::vector<std::vector<Mat44>> characterPoses(throughput.m_numCharacters);
+		for (int characterIdx = 0; characterIdx < throughput.m_numCharacters; characterIdx++) {
+			characterPoses[characterIdx] = GetDDMSyntheticPose(mesh, 5.0f + (float)(characterIdx % 10) * 2.0f);
+		}
+		std::vector<std::vector<float>> characterJointData(throughput.m_numCharacters);
+		std::vector<float> characterPositions((size_t)throughput.m_numCharacters * result.m_numVertices * 3);
+
+		for (int methodIdx = 0; methodIdx < (int)CPUSkinningMethod::COUNT; methodIdx++) {
+			CPUSkinningMethod method = (CPUSkinningMethod)methodIdx;
+			double startTime = GetCurrentTimeSeconds();
+			for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+				for (int characterIdx = 0; characterIdx < throughput.m_numCharacters; characterIdx++) {
+					ConvertJointTransformsForCPUSkinning(method, characterPoses[characterIdx], characterJointData[characterIdx]);
+				}
+				ParallelForCharacterBlocks(jobSystem, throughput.m_numCharacters, blocks.GetNumBlocks(), BLOCK_GRAIN_SIZE, [&](int characterIdx, int beginBlockIdx, int endBlockIdx) {
+					float* outPositions = characterPositions.data() + (size_t)characterIdx * result.m_numVertices * 3;
+					ComputeCPUSkinnedVertices(blocks, method, characterJointData[characterIdx].data(), beginBlockIdx, endBlockIdx, outPositions, nullptr, 3, highestSimdLevel);
+				});
+			}
+			throughput.m_skinningSeconds[methodIdx] = (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		}
+
+		double startTime = GetCurrentTimeSeconds();
+		for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+			for (int characterIdx = 0; characterIdx < throughput.m_numCharacters; characterIdx++) {
+				ConvertJointTransformsToFloats(characterPoses[characterIdx], characterJointData[characterIdx]);
+			}
+			ParallelForCharacterBlocks(jobSystem, throughput.m_numCharacters, packets.GetNumPackets(), PACKET_GRAIN_SIZE, [&](int characterIdx, int beginPacketIdx, int endPacketIdx) {
+				float* outPositions = characterPositions.data() + (size_t)characterIdx * result.m_numVertices * 3;
+				ComputeDDMv0DeformedControlPoints(packets, characterJointData[characterIdx].data(), beginPacketIdx, endPacketIdx, outPositions, 3, 1, highestSimdLevel);
+			});
+		}
+		throughput.m_ddmSeconds = (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		result.m_throughputs.push_back(throughput);
+	}
+	return result;
+}
+
+bool Command_CPUSkinningBenchmark(EventArgs& args)
+{
+	int numVertices = atoi(args.GetValue("NumVertices", std::string("20000")).c_str());	//Per character
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("32")).c_str());
+	int numCharacters = atoi(args.GetValue("NumCharacters", std::string("0")).c_str());	//0: 1, 2, 5, 10, 20, 50 and 100
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("5")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.0001")).c_str());	//The synthetic mesh spans [-1, 1]
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "CPUSkinningBenchmark needs g_theJobSystem");
+	std::vector<int> numCharactersToRun = { 1, 2, 5, 10, 20, 50, 100 };
+	if (numCharacters > 0) {
+		numCharactersToRun = { numCharacters };
+	}
+
+	CPUSkinningBenchmarkResult result = RunCPUSkinningBenchmark(*g_theJobSystem, numVertices, numJoints, numCharactersToRun, numRepeats);
+	PrintBenchmarkLine(Stringf("CPUSkinningBenchmark: %d vertices, %d joints, %.1lf influences per block, %.2lf MB of vertex blocks", result.m_numVertices, result.m_numJoints,
+		result.m_averageNumInfluences, (double)result.m_numBlockBytes / (1024.0 * 1024.0)));
+	bool hasPassed = true;
+	for (int methodIdx = 0; methodIdx < (int)CPUSkinningMethod::COUNT; methodIdx++) {
+		for (int simdLevelIdx = 0; simdLevelIdx < (int)DDMSimdLevel::COUNT; simdLevelIdx++) {
+			const char* simdLevelName = GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx);
+			if (!result.m_isSimdLevelSupported[simdLevelIdx]) {
+				PrintBenchmarkLine(Stringf("  %s %-6s: not supported on this CPU", GetCPUSkinningMethodName((CPUSkinningMethod)methodIdx), simdLevelName));
+				continue;
+			}
+			double nanosecondsPerVertex = result.m_singleThreadSeconds[methodIdx][simdLevelIdx] * 1.0e9 / (double)result.m_numVertices;
+			bool isWithinTolerance = result.m_maxPositionError[methodIdx][simdLevelIdx] <= tolerance && result.m_maxNormalError[methodIdx][simdLevelIdx] <= tolerance;
+			hasPassed = hasPassed && isWithinTolerance;
+			PrintBenchmarkLine(Stringf("  %s %-6s: %.3lf ms, %.2lf ns per vertex, max error position %.2e normal %.2e %s", GetCPUSkinningMethodName((CPUSkinningMethod)methodIdx),
+				simdLevelName, result.m_singleThreadSeconds[methodIdx][simdLevelIdx] * 1000.0, nanosecondsPerVertex, result.m_maxPositionError[methodIdx][simdLevelIdx],
+				result.m_maxNormalError[methodIdx][simdLevelIdx], GetBenchmarkCheckString(isWithinTolerance)));
+		}
+	}
+
+	PrintBenchmarkLine(Stringf("  %s on %d threads, per frame (M vertices/s):", GetDDMSimdLevelName(GetHighestSupportedDDMSimdLevel()), result.m_numParallelThreads));
+	for (const CPUSkinningThroughputResult& throughput : result.m_throughputs) {
+		double numVertices = (double)throughput.m_numCharacters * (double)result.m_numVertices;
+		PrintBenchmarkLine(Stringf("  %3d characters: LBS %8.3lf ms (%7.1lf), DQS %8.3lf ms (%7.1lf), DDM v0 %8.3lf ms (%7.1lf)", throughput.m_numCharacters,
+			throughput.m_skinningSeconds[(int)CPUSkinningMethod::LINEAR_BLEND] * 1000.0, numVertices / throughput.m_skinningSeconds[(int)CPUSkinningMethod::LINEAR_BLEND] * 1.0e-6,
+			throughput.m_skinningSeconds[(int)CPUSkinningMethod::DUAL_QUATERNION] * 1000.0, numVertices / throughput.m_skinningSeconds[(int)CPUSkinningMethod::DUAL_QUATERNION] * 1.0e-6,
+			throughput.m_ddmSeconds * 1000.0, numVertices / throughput.m_ddmSeconds * 1.0e-6));
+	}
+	return hasPassed;
+}
+
+//What FBXMesh::ProcessFbxMesh did before DeduplicateFBXVertices, one corner at a time
+static void DeduplicateFBXVerticesWithMap(const std::vector<Vertex_FBX>& polygonVertices, std::vector<unsigned int>& outIndices, std::vector<unsigned int>& outFirstPolygonVertexIndices)
+{
+	std::map<Vertex_FBX, unsigned int> verticesToIndicesMap;
+	outIndices.clear();
+	outFirstPolygonVertexIndices.clear();
+	for (int polygonVertexIdx = 0; polygonVertexIdx < (int)polygonVertices.size(); polygonVertexIdx++) {
+		auto foundNewVertexIndexPair = verticesToIndicesMap.find(polygonVertices[polygonVertexIdx]);
+		if (foundNewVertexIndexPair == verticesToIndicesMap.end()) {
+			verticesToIndicesMap[polygonVertices[polygonVertexIdx]] = (unsigned int)outFirstPolygonVertexIndices.size();
+			outIndices.push_back((unsigned int)outFirstPolygonVertexIndices.size());
+			outFirstPolygonVertexIndices.push_back((unsigned int)polygonVertexIdx);
+		}
+		else {
+			outIndices.push_back(foundNewVertexIndexPair->second);
+		}
+	}
+}
+
+static bool AreDedupedVerticesIdentical(const std::vector<Vertex_FBX>& polygonVertices, const std::vector<int>& polygonVertexControlPointIndices,
+	const std::vector<unsigned int>& firstPolygonVertexIndices, const std::vector<unsigned int>& referenceFirstPolygonVertexIndices)
+{
+	if (firstPolygonVertexIndices.size() != referenceFirstPolygonVertexIndices.size()) {
+		return false;
+	}
+	for (int renderVertexIdx = 0; renderVertexIdx < (int)firstPolygonVertexIndices.size(); renderVertexIdx++) {
+		unsigned int polygonVertexIdx = firstPolygonVertexIndices[renderVertexIdx];
+		unsigned int referencePolygonVertexIdx = referenceFirstPolygonVertexIndices[renderVertexIdx];
+		if (memcmp(&polygonVertices[polygonVertexIdx], &polygonVertices[referencePolygonVertexIdx], sizeof(Vertex_FBX)) != 0
+			|| polygonVertexControlPointIndices[polygonVertexIdx] != polygonVertexControlPointIndices[referencePolygonVertexIdx]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+FBXVertexDedupBenchmarkResult RunFBXVertexDedupBenchmark(JobSystem& jobSystem, int numControlPoints, int chunkSize, int numRepeats)
+{
+	constexpr int NUM_JOINTS = 16;
+	numRepeats = std::max(numRepeats, 1);
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, NUM_JOINTS);
+	std::vector<Vertex_FBX> polygonVertices;
+	std::vector<int> polygonVertexControlPointIndices;
+	GetSyntheticPolygonVertices(mesh, polygonVertices, polygonVertexControlPointIndices);
+
+	FBXVertexDedupBenchmarkResult result;
+	result.m_numPolygonVertices = (int)polygonVertices.size();
+	result.m_numChunks = (result.m_numPolygonVertices + chunkSize - 1) / chunkSize;
+	result.m_numParallelThreads = jobSystem.GetNumWorkerThreads() + 1;
+	std::vector<unsigned int> referenceIndices;
+	std::vector<unsigned int> referenceFirstPolygonVertexIndices;
+	std::vector<unsigned int> serialIndices;
+	std::vector<unsigned int> serialFirstPolygonVertexIndices;
+	std::vector<unsigned int> parallelIndices;
+	std::vector<unsigned int> parallelFirstPolygonVertexIndices;
+	for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+		double startTime = GetCurrentTimeSeconds();
+		DeduplicateFBXVerticesWithMap(polygonVertices, referenceIndices, referenceFirstPolygonVertexIndices);
+		result.m_mapSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+
+		startTime = GetCurrentTimeSeconds();
+		DeduplicateFBXVertices(nullptr, polygonVertices, chunkSize, serialIndices, serialFirstPolygonVertexIndices);
+		result.m_hashSerialSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+
+		startTime = GetCurrentTimeSeconds();
+		DeduplicateFBXVertices(&jobSystem, polygonVertices, chunkSize, parallelIndices, parallelFirstPolygonVertexIndices);
+		result.m_hashParallelSeconds += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+	}
+
+	result.m_numRenderVertices = (int)referenceFirstPolygonVertexIndices.size();
+	result.m_areIndicesIdentical = serialIndices == referenceIndices && parallelIndices == referenceIndices;
+	result.m_areVerticesIdentical = AreDedupedVerticesIdentical(polygonVertices, polygonVertexControlPointIndices, serialFirstPolygonVertexIndices, referenceFirstPolygonVertexIndices)
+		&& AreDedupedVerticesIdentical(polygonVertices, polygonVertexControlPointIndices, parallelFirstPolygonVertexIndices, referenceFirstPolygonVertexIndices);
+	return result;
+}
+
+bool Command_FBXVertexDedupBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("200000")).c_str());	//About 6 polygon vertices each
+	int chunkSize = atoi(args.GetValue("ChunkSize", std::string("65536")).c_str());
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("3")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "FBXVertexDedupBenchmark needs g_theJobSystem");
+	FBXVertexDedupBenchmarkResult result = RunFBXVertexDedupBenchmark(*g_theJobSystem, numControlPoints, std::max(chunkSize, 1), numRepeats);
+	PrintBenchmarkLine(Stringf("FBXVertexDedupBenchmark: %d polygon vertices, %d render vertices, %d chunks", result.m_numPolygonVertices, result.m_numRenderVertices, result.m_numChunks));
+	PrintBenchmarkLine(Stringf("  std::map         : %8.2lf ms", result.m_mapSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("  Hash, 1 thread   : %8.2lf ms (x%.2lf)", result.m_hashSerialSeconds * 1000.0, result.m_mapSeconds / result.m_hashSerialSeconds));
+	PrintBenchmarkLine(Stringf("  Hash, %d threads : %8.2lf ms (x%.2lf)", result.m_numParallelThreads, result.m_hashParallelSeconds * 1000.0, result.m_mapSeconds / result.m_hashParallelSeconds));
+	PrintBenchmarkLine(Stringf("  Index buffer identical %s, render vertices identical %s", GetBenchmarkCheckString(result.m_areIndicesIdentical), GetBenchmarkCheckString(result.m_areVerticesIdentical)));
+	return result.m_areIndicesIdentical && result.m_areVerticesIdentical;
+}
+
+struct BenchmarkCharacter {
+	std::vector<BenchmarkTreeJoint*> m_joints;	//Like FBXModel::m_joints
+	FBXSkeleton m_skeleton;
+	std::vector<Vec4> m_localScalings;	//The pose, like FBXPose
+	std::vector<Quaternion> m_localQuats;
+	std::vector<Vec4> m_localLocs;
+};
+
+static int GetBenchmarkJointIndex(const BenchmarkCharacter& character, const BenchmarkTreeJoint* joint)	//FBXModel::GetIndexOfJoint
+{
+	for (int jointIdx = 0; jointIdx < (int)character.m_joints.size(); jointIdx++) {
+		if (character.m_joints[jointIdx] == joint) {
+			return jointIdx;
+		}
+	}
+	return -1;
+}
+
+//FBXJoint::SetPoseIfThisIsRoot on the root, then FBXModel's per joint gathering of the skinning matrices and the structured buffer list
+static void UpdateBenchmarkJointTree(const BenchmarkCharacter& character, std::vector<Mat44>& outGlobalTransforms, std::vector<Mat44>& outSkinningMatrices)
+{
+	struct JointAndParentTransform {
+		BenchmarkTreeJoint* m_joint = nullptr;
+		Mat44 m_parentTransform;
+	};
+	std::queue<JointAndParentTransform> jointsToProcess;
+	jointsToProcess.push({ character.m_joints[0], Mat44() });
+	while (!jointsToProcess.empty()) {
+		JointAndParentTransform jointAndParent = jointsToProcess.front();
+		jointsToProcess.pop();
+		BenchmarkTreeJoint* joint = jointAndParent.m_joint;
+		int jointIdx = GetBenchmarkJointIndex(character, joint);
+		GUARANTEE_OR_DIE(jointIdx != -1, "Benchmark joint doesn't exist in its character");
+
+		const Mat44 S = Mat44::CreateNonUniformScale3D(Vec3(character.m_localScalings[jointIdx]));
+		const Mat44 R = character.m_localQuats[jointIdx].GetRotationMatrix();
+		Mat44 T = Mat44::CreateTranslation3D(Vec3(character.m_localLocs[jointIdx]));
+		if (joint->m_isRoot && joint->m_isTranslationModified) {
+			T.Append(Mat44::CreateTranslation3D(joint->m_localDeltaTranslate));
+		}
+		Mat44 localTransform = T;
+		localTransform.Append(R);
+		localTransform.Append(S);
+		joint->m_globalTransformForThisFrame = jointAndParent.m_parentTransform;
+		joint->m_globalTransformForThisFrame.Append(localTransform);
+		if (joint->m_isRotationModified) {
+			joint->m_globalTransformForThisFrame.Append(joint->m_localDeltaRotate.GetRotationMatrix());
+		}
+		for (BenchmarkTreeJoint* childJoint : joint->m_childJoints) {
+			jointsToProcess.push({ childJoint, joint->m_globalTransformForThisFrame });
+		}
+	}
+
+	outGlobalTransforms.clear();
+	outSkinningMatrices.clear();
+	for (const BenchmarkTreeJoint* joint : character.m_joints) {
+		Mat44 skinningMatrix = joint->m_globalTransformForThisFrame;
+		skinningMatrix.Append(joint->m_globalBindPoseInverse);
+		outSkinningMatrices.emplace_back(skinningMatrix);
+	}
+	for (const BenchmarkTreeJoint* joint : character.m_joints) {
+		outGlobalTransforms.emplace_back(joint->m_globalTransformForThisFrame);
+	}
+}
+
+//FBXModel::UpdateSkeleton: the pose and the deltas into the flat arrays, one pass, and the global transforms handed back to the joints.
+//Every joint is recomputed like on an animated frame, where the whole pose changes
+static void UpdateBenchmarkFlatSkeleton(BenchmarkCharacter& character)
+{
+	FBXSkeleton& skeleton = character.m_skeleton;
+	for (int jointIdx = 0; jointIdx < skeleton.GetNumJoints(); jointIdx++) {
+		const BenchmarkTreeJoint& joint = *character.m_joints[jointIdx];
+		Vec3 localTranslation(character.m_localLocs[jointIdx]);
+		if (joint.m_isTranslationModified) {
+			localTranslation += joint.m_localDeltaTranslate;
+		}
+		skeleton.SetLocalTransform(jointIdx, localTranslation, character.m_localQuats[jointIdx], Vec3(character.m_localScalings[jointIdx]));
+		if (joint.m_isRotationModified) {
+			skeleton.SetLocalPostRotation(jointIdx, joint.m_localDeltaRotate);
+		}
+		else {
+			skeleton.ClearLocalPostRotation(jointIdx);
+		}
+	}
+	skeleton.UpdateAllGlobalTransforms();
+	for (int jointIdx = 0; jointIdx < skeleton.GetNumJoints(); jointIdx++) {
+		character.m_joints[jointIdx]->m_globalTransformForThisFrame = skeleton.m_globalTransforms[jointIdx];
+	}
+}
+
+static double GetMaxMatrixDifference(const Mat44& a, const Mat44& b)
+{
+	double maxDifference = 0.0;
+	for (int valueIdx = 0; valueIdx < 16; valueIdx++) {
+		maxDifference = std::max(maxDifference, (double)fabsf(a.m_values[valueIdx] - b.m_values[valueIdx]));
+	}
+	return maxDifference;
+}
+
+FBXSkeletonBenchmarkResult RunFBXSkeletonBenchmark(int numJoints, const std::vector<int>& numCharactersToRun, int numRepeats)
+{
+	GUARANTEE_OR_DIE(numJoints > 0 && numRepeats > 0, "RunFBXSkeletonBenchmark needs joints and repeats");
+	FBXSkeletonBenchmarkResult result;
+	result.m_numJoints = numJoints;
+
+	//Bones reach back a few joints, so the hierarchy both branches and gets deep. Every parent comes before its children like FBXParser's joints
+	RandomNumberGenerator rng(0);
+	std::vector<int> parentIndices(numJoints, -1);
+	std::vector<int> depths(numJoints, 0);
+	for (int jointIdx = 1; jointIdx < numJoints; jointIdx++) {
+		parentIndices[jointIdx] = rng.RollRandomIntInRange(std::max(jointIdx - 4, 0), jointIdx - 1);
+		depths[jointIdx] = depths[parentIndices[jointIdx]] + 1;
+		result.m_maxDepth = std::max(result.m_maxDepth, depths[jointIdx]);
+	}
+	std::vector<Mat44> globalBindPoseInverses(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		globalBindPoseInverses[jointIdx] = Mat44::CreateTranslation3D(Vec3(0.0f, 0.0f, -0.05f * (float)depths[jointIdx]));
+		globalBindPoseInverses[jointIdx].Append(GetRandomBenchmarkRotation(rng, 10.0f).GetRotationMatrix());
+	}
+
+	int maxNumCharacters = 0;
+	for (int numCharacters : numCharactersToRun) {
+		maxNumCharacters = std::max(maxNumCharacters, numCharacters);
+	}
+	std::vector<BenchmarkCharacter> characters(maxNumCharacters);
+	for (int characterIdx = 0; characterIdx < maxNumCharacters; characterIdx++) {
+		BenchmarkCharacter& character = characters[characterIdx];
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			BenchmarkTreeJoint* joint = new BenchmarkTreeJoint();
+			joint->m_globalBindPoseInverse = globalBindPoseInverses[jointIdx];
+			joint->m_isRoot = jointIdx == 0;
+			joint->m_isTranslationModified = jointIdx == 0;	//CreateCopy offsets every copy
+			joint->m_localDeltaTranslate = Vec3(2.0f * (float)characterIdx, 0.0f, 0.0f);
+			joint->m_isRotationModified = rng.RollRandomFloatZeroToOne() < 0.1f;	//Gizmo or IK edits on a few joints
+			joint->m_localDeltaRotate = joint->m_isRotationModified ? GetRandomBenchmarkRotation(rng, 45.0f) : Quaternion();
+			if (parentIndices[jointIdx] >= 0) {
+				joint->m_parentJoint = character.m_joints[parentIndices[jointIdx]];
+				joint->m_parentJoint->m_childJoints.push_back(joint);
+			}
+			character.m_joints.push_back(joint);
+			character.m_localScalings.emplace_back(Vec4(rng.RollRandomFloatInRange(0.9f, 1.1f), rng.RollRandomFloatInRange(0.9f, 1.1f), rng.RollRandomFloatInRange(0.9f, 1.1f), 0.0f));
+			character.m_localQuats.push_back(GetRandomBenchmarkRotation(rng, 30.0f));
+			character.m_localLocs.emplace_back(Vec4(rng.RollRandomFloatInRange(-0.1f, 0.1f), rng.RollRandomFloatInRange(-0.1f, 0.1f), 0.1f, 0.0f));
+		}
+		character.m_skeleton.SetJoints(parentIndices, globalBindPoseInverses);
+	}
+
+	std::vector<Mat44> globalTransforms;
+	std::vector<Mat44> skinningMatrices;
+	for (BenchmarkCharacter& character : characters) {
+		UpdateBenchmarkJointTree(character, globalTransforms, skinningMatrices);
+		UpdateBenchmarkFlatSkeleton(character);
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			result.m_maxGlobalTransformError = std::max(result.m_maxGlobalTransformError, GetMaxMatrixDifference(globalTransforms[jointIdx], character.m_skeleton.m_globalTransforms[jointIdx]));
+			result.m_maxSkinningMatrixError = std::max(result.m_maxSkinningMatrixError, GetMaxMatrixDifference(skinningMatrices[jointIdx], character.m_skeleton.m_skinningMatrices[jointIdx]));
+		}
+	}
+
+	for (int numCharacters : numCharactersToRun) {
+		FBXSkeletonThroughputResult throughput;
+		throughput.m_numCharacters = numCharacters;
+		double startTime = GetCurrentTimeSeconds();
+		for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+			for (int characterIdx = 0; characterIdx < numCharacters; characterIdx++) {
+				UpdateBenchmarkJointTree(characters[characterIdx], globalTransforms, skinningMatrices);
+			}
+		}
+		throughput.m_jointTreeSeconds = (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		startTime = GetCurrentTimeSeconds();
+		for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+			for (int characterIdx = 0; characterIdx < numCharacters; characterIdx++) {
+				UpdateBenchmarkFlatSkeleton(characters[characterIdx]);
+			}
+		}
+		throughput.m_flatSeconds = (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		result.m_throughputs.push_back(throughput);
+	}
+
+	for (BenchmarkCharacter& character : characters) {
+		for (BenchmarkTreeJoint* joint : character.m_joints) {
+			delete joint;
+		}
+	}
+	return result;
+}
+
+bool Command_FBXSkeletonBenchmark(EventArgs& args)
+{
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("120")).c_str());
+	int numCharacters = atoi(args.GetValue("NumCharacters", std::string("0")).c_str());	//0: 1, 10, 100 and 1000
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("20")).c_str());
+	double tolerance = atof(args.GetValue("Tolerance", std::string("0.0001")).c_str());
+
+	std::vector<int> numCharactersToRun = { 1, 10, 100, 1000 };
+	if (numCharacters > 0) {
+		numCharactersToRun = { numCharacters };
+	}
+
+	FBXSkeletonBenchmarkResult result = RunFBXSkeletonBenchmark(numJoints, numCharactersToRun, std::max(numRepeats, 1));
+	bool hasPassed = result.m_maxGlobalTransformError <= tolerance && result.m_maxSkinningMatrixError <= tolerance;
+	PrintBenchmarkLine(Stringf("FBXSkeletonBenchmark: %d joints, %d deep, max error global %.2e skinning %.2e %s", result.m_numJoints, result.m_maxDepth,
+		result.m_maxGlobalTransformError, result.m_maxSkinningMatrixError, GetBenchmarkCheckString(hasPassed)));
+	PrintBenchmarkLine("  Joint tree timed on BenchmarkTreeJoint, a stand in for FBXJoint with the same walk but not its layout");
+	for (const FBXSkeletonThroughputResult& throughput : result.m_throughputs) {
+		double numJointUpdates = (double)throughput.m_numCharacters * (double)result.m_numJoints;
+		PrintBenchmarkLine(Stringf("  %4d characters: joint tree %9.3lf ms (%6.1lf ns per joint), flat %9.3lf ms (%6.1lf ns per joint), x%.2lf", throughput.m_numCharacters,
+			throughput.m_jointTreeSeconds * 1000.0, throughput.m_jointTreeSeconds * 1.0e9 / numJointUpdates, throughput.m_flatSeconds * 1000.0,
+			throughput.m_flatSeconds * 1.0e9 / numJointUpdates, throughput.m_jointTreeSeconds / throughput.m_flatSeconds));
+	}
+	return hasPassed;
+}
+
+static size_t GetBenchmarkPoseBytes(const BenchmarkPose& pose)
+{
+	return (pose.m_localScalings.capacity() + pose.m_localLocs.capacity()) * sizeof(Vec4) + pose.m_localQuats.capacity() * sizeof(Quaternion);
+}
+
+static size_t GetBenchmarkPoseSequenceBytes(const std::vector<BenchmarkPose>& poseSequence)
+{
+	size_t numBytes = poseSequence.capacity() * sizeof(BenchmarkPose);
+	for (const BenchmarkPose& pose : poseSequence) {
+		numBytes += GetBenchmarkPoseBytes(pose);
+	}
+	return numBytes;
+}
+
+static size_t GetBenchmarkInstanceBytes(const BenchmarkModelInstance& instance)	//Without the mesh asset and the pose sequence
+{
+	size_t numBytes = sizeof(BenchmarkModelInstance) + instance.m_renderVertices.capacity() * sizeof(Vertex_FBX) + instance.m_joints.capacity() * sizeof(BenchmarkTreeJoint*);
+	for (const BenchmarkTreeJoint* joint : instance.m_joints) {
+		numBytes += sizeof(BenchmarkTreeJoint) + joint->m_childJoints.capacity() * sizeof(BenchmarkTreeJoint*);
+	}
+	const FBXSkeleton& skeleton = instance.m_skeleton;
+	numBytes += (skeleton.m_parentIndices.capacity() + skeleton.m_changedJointIndices.capacity()) * sizeof(int);
+	numBytes += (skeleton.m_globalBindPoseInverses.capacity() + skeleton.m_globalTransforms.capacity() + skeleton.m_skinningMatrices.capacity()) * sizeof(Mat44);
+	numBytes += (skeleton.m_localTranslations.capacity() + skeleton.m_localScales.capacity()) * sizeof(Vec3);
+	numBytes += (skeleton.m_localRotations.capacity() + skeleton.m_localPostRotations.capacity()) * sizeof(Quaternion);
+	numBytes += skeleton.m_hasLocalPostRotations.capacity() + skeleton.m_isLocalTransformDirty.capacity();
+	numBytes += GetBenchmarkPoseBytes(instance.m_poseForThisFrame);
+	return numBytes;
+}
+
+//Every instance's own part, plus each mesh asset and pose sequence once no matter how many instances point at it
+static size_t GetBenchmarkInstancesBytes(const std::vector<const BenchmarkModelInstance*>& instances)
+{
+	size_t numBytes = 0;
+	std::set<const void*> countedSharedData;
+	for (const BenchmarkModelInstance* instance : instances) {
+		numBytes += GetBenchmarkInstanceBytes(*instance);
+		if (countedSharedData.insert(instance->m_meshAsset.get()).second) {
+			numBytes += instance->m_meshAsset->GetNumBytes();
+		}
+		if (countedSharedData.insert(instance->m_poseSequence.get()).second) {
+			numBytes += GetBenchmarkPoseSequenceBytes(*instance->m_poseSequence);
+		}
+	}
+	return numBytes;
+}
+
+static bool AreSkinWeightsBitIdentical(const DDMSkinWeights& a, const DDMSkinWeights& b)
+{
+	return a.rows() == b.rows() && a.cols() == b.cols() && a.nonZeros() == b.nonZeros()
+		&& memcmp(a.outerIndexPtr(), b.outerIndexPtr(), (size_t)(a.outerSize() + 1) * sizeof(int)) == 0
+		&& memcmp(a.innerIndexPtr(), b.innerIndexPtr(), (size_t)a.nonZeros() * sizeof(int)) == 0
+		&& memcmp(a.valuePtr(), b.valuePtr(), (size_t)a.nonZeros() * sizeof(double)) == 0;
+}
+
+static bool AreFBXMeshAssetsBitIdentical(const FBXMeshAsset& a, const FBXMeshAsset& b)
+{
+	if (a.m_controlPointsRestPose.size() != b.m_controlPointsRestPose.size()) {
+		return false;
+	}
+	for (int ctrlPointIdx = 0; ctrlPointIdx < (int)a.m_controlPointsRestPose.size(); ctrlPointIdx++) {
+		const FBXControlPoint& controlPointA = *a.m_controlPointsRestPose[ctrlPointIdx];
+		const FBXControlPoint& controlPointB = *b.m_controlPointsRestPose[ctrlPointIdx];
+		if (memcmp(&controlPointA.m_position, &controlPointB.m_position, sizeof(Vec3)) != 0 || controlPointA.m_jointWeightPairs.size() != controlPointB.m_jointWeightPairs.size()
+			|| memcmp(controlPointA.m_jointWeightPairs.data(), controlPointB.m_jointWeightPairs.data(), controlPointA.m_jointWeightPairs.size() * sizeof(JointWeightPair)) != 0) {
+			return false;
+		}
+	}
+	return a.m_controlPointsMatrixRestPose == b.m_controlPointsMatrixRestPose && a.m_facesMatrix == b.m_facesMatrix
+		&& a.m_renderVertexToControlPointMap == b.m_renderVertexToControlPointMap && a.m_renderIndices == b.m_renderIndices
+		&& a.m_diffuseTexturePaths == b.m_diffuseTexturePaths && a.m_specularTexturePaths == b.m_specularTexturePaths && a.m_normalTexturePaths == b.m_normalTexturePaths
+		&& a.m_glossTexturePaths == b.m_glossTexturePaths && a.m_ambientTexturePaths == b.m_ambientTexturePaths
+		&& AreSkinWeightsBitIdentical(a.m_weightsMatrix, b.m_weightsMatrix) && AreSkinWeightsBitIdentical(a.m_rigidWeightsMatrix, b.m_rigidWeightsMatrix)
+		&& memcmp(&a.m_boundingBox, &b.m_boundingBox, sizeof(AABB3)) == 0;
+}
+
+FBXModelInstancingBenchmarkResult RunFBXModelInstancingBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, const std::vector<int>& numCopiesToRun, int numRepeats)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0 && numJoints > 0 && numPoses > 0 && numRepeats > 0, "RunFBXModelInstancingBenchmark needs control points, joints, poses and repeats");
+	FBXModelInstancingBenchmarkResult result;
+	result.m_numJoints = numJoints;
+	result.m_numPoses = numPoses;
+
+	//The source model the way FBXParser leaves it: the tube as ProcessFbxMesh reads it, its joint chain and an animation bending it
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	BenchmarkModelInstance* source = new BenchmarkModelInstance();
+	std::shared_ptr<FBXMeshAsset> meshAsset = GetSyntheticFBXMeshAsset(jobSystem, mesh, numJoints, source->m_renderVertices);
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	result.m_numRenderVertices = (int)source->m_renderVertices.size();
+	source->m_meshAsset = meshAsset;
+
+	std::vector<int> parentIndices(numJoints);
+	std::vector<Mat44> globalBindPoseInverses(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		BenchmarkTreeJoint* joint = new BenchmarkTreeJoint();
+		joint->m_isRoot = jointIdx == 0;
+		joint->m_globalBindPoseInverse = Mat44::CreateTranslation3D(Vec3(0.0f, -(float)mesh.m_jointHeights[jointIdx], 0.0f));
+		parentIndices[jointIdx] = jointIdx - 1;
+		globalBindPoseInverses[jointIdx] = joint->m_globalBindPoseInverse;
+		if (jointIdx > 0) {
+			joint->m_parentJoint = source->m_joints[jointIdx - 1];
+			joint->m_parentJoint->m_childJoints.push_back(joint);
+		}
+		source->m_joints.push_back(joint);
+	}
+	source->m_skeleton.SetJoints(parentIndices, globalBindPoseInverses);
+
+	std::shared_ptr<std::vector<BenchmarkPose>> poseSequence = std::make_shared<std::vector<BenchmarkPose>>(numPoses);
+	for (int poseIdx = 0; poseIdx < numPoses; poseIdx++) {
+		BenchmarkPose& pose = (*poseSequence)[poseIdx];
+		float degrees = 30.0f * SinDegrees(360.0f * (float)poseIdx / (float)numPoses);
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			float parentHeight = jointIdx > 0 ? (float)mesh.m_jointHeights[jointIdx - 1] : 0.0f;
+			pose.m_localScalings.emplace_back(Vec4(1.0f, 1.0f, 1.0f, 0.0f));
+			pose.m_localQuats.push_back(Quaternion::CreateFromAxisAndDegrees(degrees / (float)numJoints, Vec3(0.0f, 0.0f, 1.0f)));
+			pose.m_localLocs.emplace_back(Vec4(0.0f, (float)mesh.m_jointHeights[jointIdx] - parentHeight, 0.0f, 1.0f));
+		}
+	}
+	source->m_poseSequence = poseSequence;
+	source->m_poseForThisFrame.m_localScalings = (*poseSequence)[0].m_localScalings;
+	source->m_poseForThisFrame.m_localQuats = (*poseSequence)[0].m_localQuats;
+	source->m_poseForThisFrame.m_localLocs = (*poseSequence)[0].m_localLocs;
+
+	result.m_meshAssetBytes = meshAsset->GetNumBytes();
+	result.m_poseSequenceBytes = GetBenchmarkPoseSequenceBytes(*poseSequence);
+	result.m_instanceBytes = GetBenchmarkInstanceBytes(*source);
+
+	BenchmarkModelInstance* deepCopy = CreateBenchmarkModelCopy(*source, true);
+	result.m_areDeepCopiesIdentical = deepCopy->m_meshAsset != meshAsset && AreFBXMeshAssetsBitIdentical(*deepCopy->m_meshAsset, *meshAsset);
+	delete deepCopy;
+
+	for (int numCopies : numCopiesToRun) {
+		FBXModelInstancingThroughputResult throughput;
+		throughput.m_numCopies = numCopies;
+		for (int copyModeIdx = 0; copyModeIdx < 2; copyModeIdx++) {
+			bool isDeepCopy = copyModeIdx == 0;
+			double& seconds = isDeepCopy ? throughput.m_deepCopySeconds : throughput.m_sharedSeconds;
+			size_t& numBytes = isDeepCopy ? throughput.m_deepCopyBytes : throughput.m_sharedBytes;
+			for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+				std::vector<const BenchmarkModelInstance*> instances;
+				instances.reserve((size_t)numCopies + 1);
+				instances.push_back(source);
+				double startTime = GetCurrentTimeSeconds();
+				for (int copyIdx = 0; copyIdx < numCopies; copyIdx++) {
+					instances.push_back(CreateBenchmarkModelCopy(*source, isDeepCopy));
+				}
+				seconds += GetCurrentTimeSeconds() - startTime;
+				numBytes = GetBenchmarkInstancesBytes(instances);
+				for (int instanceIdx = 1; instanceIdx < (int)instances.size(); instanceIdx++) {
+					delete instances[instanceIdx];
+				}
+			}
+			seconds /= (double)numRepeats;
+		}
+		result.m_throughputs.push_back(throughput);
+	}
+
+	//The shared part has to outlive the model it was parsed for and go away with the last copy
+	std::weak_ptr<FBXMeshAsset> weakMeshAsset = meshAsset;
+	std::weak_ptr<const std::vector<BenchmarkPose>> weakPoseSequence = source->m_poseSequence;
+	std::vector<BenchmarkModelInstance*> copies;
+	for (int copyIdx = 0; copyIdx < 3; copyIdx++) {
+		copies.push_back(CreateBenchmarkModelCopy(*source, false));
+	}
+	meshAsset.reset();
+	poseSequence.reset();
+	delete source;
+	result.m_isSharedDataReleased = !weakMeshAsset.expired() && !weakPoseSequence.expired();
+	for (BenchmarkModelInstance* copy : copies) {
+		result.m_isSharedDataReleased = result.m_isSharedDataReleased && copy->m_meshAsset->m_controlPointsRestPose.size() == (size_t)result.m_numControlPoints
+			&& copy->m_poseSequence->size() == (size_t)numPoses;
+		delete copy;
+	}
+	result.m_isSharedDataReleased = result.m_isSharedDataReleased && weakMeshAsset.expired() && weakPoseSequence.expired();
+	return result;
+}
+
+bool Command_FBXModelInstancingBenchmark(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("5000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("60")).c_str());
+	int numPoses = atoi(args.GetValue("NumPoses", std::string("150")).c_str());
+	int numCopies = atoi(args.GetValue("NumCopies", std::string("0")).c_str());	//0: 1, 100 and 1000
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("3")).c_str());
+
+	std::vector<int> numCopiesToRun = { 1, 100, 1000 };
+	if (numCopies > 0) {
+		numCopiesToRun = { numCopies };
+	}
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "FBXModelInstancingBenchmark needs g_theJobSystem");
+	FBXModelInstancingBenchmarkResult result = RunFBXModelInstancingBenchmark(*g_theJobSystem, std::max(numControlPoints, 64), std::max(numJoints, 2), std::max(numPoses, 2),
+		numCopiesToRun, std::max(numRepeats, 1));
+	bool hasPassed = result.m_areDeepCopiesIdentical && result.m_isSharedDataReleased;
+	const double bytesToMB = 1.0 / (1024.0 * 1024.0);
+	PrintBenchmarkLine(Stringf("FBXModelInstancingBenchmark: %d control points, %d render vertices, %d joints, %d poses", result.m_numControlPoints, result.m_numRenderVertices,
+		result.m_numJoints, result.m_numPoses));
+	PrintBenchmarkLine("  Copies made by a CPU only model of FBXModel::CreateCopy, without the GPU buffers, joint gizmos or stencil ref lookup");
+	PrintBenchmarkLine(Stringf("  Shared: mesh asset %.2lf MB, pose sequence %.2lf MB. Per instance %.2lf MB", (double)result.m_meshAssetBytes * bytesToMB,
+		(double)result.m_poseSequenceBytes * bytesToMB, (double)result.m_instanceBytes * bytesToMB));
+	PrintBenchmarkLine(Stringf("  Deep copy matches the source %s, shared data outlives the source and goes with the last copy %s", GetBenchmarkCheckString(result.m_areDeepCopiesIdentical),
+		GetBenchmarkCheckString(result.m_isSharedDataReleased)));
+	for (const FBXModelInstancingThroughputResult& throughput : result.m_throughputs) {
+		PrintBenchmarkLine(Stringf("  %4d copies: deep %9.3lf ms %9.2lf MB, shared %9.3lf ms %9.2lf MB, x%.2lf time x%.2lf memory", throughput.m_numCopies,
+			throughput.m_deepCopySeconds * 1000.0, (double)throughput.m_deepCopyBytes * bytesToMB, throughput.m_sharedSeconds * 1000.0, (double)throughput.m_sharedBytes * bytesToMB,
+			throughput.m_deepCopySeconds / throughput.m_sharedSeconds, (double)throughput.m_deepCopyBytes / (double)throughput.m_sharedBytes));
+	}
+	return hasPassed;
+}
@@ -0,0 +1,209 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Fbx/FBXSkinningCPU.hpp"
+
+class JobSystem;
+
+//Timing benchmarks of the FBX modules, with the error checks that keep the numbers honest. They run on the synthetic meshes of FBXTestFixtures, so no FBX file or renderer is needed.
+//The correctness tests of a module are in <module>Tests next to it
+
+struct DDMv0KernelBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	size_t m_numDenseOmegaBytes = 0;	//What the n x 10m double matrix would take
+	size_t m_numSparseOmegaBytes = 0;
+	size_t m_numPacketBytes = 0;
+	int m_numInfluences = 0;	//Kept omega blocks over all control points
+	int m_numPacketJoints = 0;	//Joints over all packets, which is what the kernels loop over
+	bool m_isSimdLevelSupported[(int)DDMSimdLevel::COUNT] = {};
+	double m_singleThreadSeconds[(int)DDMSimdLevel::COUNT] = {};
+	double m_maxErrorToReference[(int)DDMSimdLevel::COUNT] = {};	//Largest distance to the double precision path with every joint, over the reference control points
+	double m_parallelSeconds = 0.0;	//Highest supported level through ParallelForRange
+	int m_numParallelThreads = 0;
+	int m_numReferenceControlPoints = 0;	//The double precision path only runs on the first few control points, it is slow
+	double m_referenceSeconds = 0.0;
+};
+
+//The synthetic mesh is a helix wrapped around a chain of joints, with weights falling off smoothly along the chain the way they do after the Laplacian smoothing.
+//omegaEpsilon is the cutoff of DDMSparseOmegas, a negative one keeps every joint of every control point
+DDMv0KernelBenchmarkResult RunDDMv0KernelBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, double omegaEpsilon, int maxNumReferenceControlPoints, unsigned int seed);
+
+struct DDMv1KernelBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	double m_legacySeconds = 0.0;	//Eigen per control point with the general inverse and determinant, one thread
+	bool m_isSimdLevelSupported[(int)DDMSimdLevel::COUNT] = {};
+	double m_singleThreadSeconds[(int)DDMSimdLevel::COUNT] = {};
+	double m_maxErrorToReference[(int)DDMSimdLevel::COUNT] = {};	//Largest distance to the double precision path with every joint and an exact polar rotation
+	double m_maxDistanceToLegacy = 0.0;	//What making R_i a rotation changed, highest supported level
+	double m_parallelSeconds = 0.0;
+	int m_numParallelThreads = 0;
+	int m_numReferenceControlPoints = 0;
+};
+
+//Same synthetic mesh as RunDDMv0KernelBenchmark, with the v1 constants of its neighborhoods
+DDMv1KernelBenchmarkResult RunDDMv1KernelBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, double omegaEpsilon, int maxNumReferenceControlPoints, unsigned int seed);
+
+struct DDMPrecomputeBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	DDMPrecomputeStageTimings m_timings;
+	DDMPrecomputeStageTimings m_serialTimings;	//The serial pipeline with the dense n x 10m Psi matrix Precompute used to run
+	size_t m_numSerialPsiBytes = 0;	//The dense UxUMultipliedWithW matrix alone, its sparse copy and the solved Psi come on top
+	bool m_doInfluencesMatch = false;
+	double m_maxOmegaError = 0.0;	//Largest difference of an omega entry to the serial pipeline
+	double m_maxV1ConstantRelativeError = 0.0;
+};
+
+//The synthetic mesh is a tube around a chain of joints with 4 skin weights per control point
+DDMPrecomputeBenchmarkResult RunDDMPrecomputeBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numLaplacianIterations, bool runSerialPipeline);
+
+struct DDMBakerBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	int m_numPoses = 0;
+	double m_ddmSeconds = 0.0;	//Deforming every pose with the v0 kernel, which both solve modes share
+	bool m_didRunSolveMode[(int)DDMBakerSolveMode::COUNT] = {};	//QR is skipped when it would go over the memory limit
+	size_t m_numBakerBytes[(int)DDMBakerSolveMode::COUNT] = {};	//High water mark of the baker systems. The DDM positions of one pose come on top in both modes
+	double m_fillSeconds[(int)DDMBakerSolveMode::COUNT] = {};	//AddPoseLHS and AddPoseRHS over every pose
+	double m_solveSeconds[(int)DDMBakerSolveMode::COUNT] = {};
+	double m_heldOutRMSError[(int)DDMBakerSolveMode::COUNT] = {};	//LBS with the baked weights against DDM, on a pose that was not baked
+	double m_maxWeightDifference = 0.0;	//Between the two solve modes, when both ran
+};
+
+//Bakes the precompute benchmark's tube against random poses of its joint chain, the way FBXDDMBakingJob does, once per solve mode
+DDMBakerBenchmarkResult RunDDMBakerBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, float twistLimit, size_t maxNumQRBytes, unsigned int seed);
+
+struct DDMBakerCandidateBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	int m_numPoses = 0;
+	int m_maxNumCandidates = 0;	//0 is the full solve
+	double m_averageNumCandidates = 0.0;
+	double m_candidateSeconds = 0.0;	//ComputeDDMBakerJointCandidates
+	double m_fillSeconds = 0.0;	//Prepare, AddPoseLHS and AddPoseRHS over every pose
+	double m_solveSeconds = 0.0;
+	size_t m_numBakerBytes = 0;
+	double m_heldOutRMSError = 0.0;	//LBS with the solved weights against DDM, on a pose that was not baked
+	double m_heldOutRMSErrorLargestWeights = 0.0;	//The same after keeping the numMaxBones largest weights and normalizing, like FBXMesh does
+	double m_maxWeightDifferenceToFull = 0.0;	//Of the kept and normalized weights
+};
+
+//Bakes the tube of RunDDMBakerBenchmark once solving for every joint, then once per entry of maxNumCandidatesToRun with ComputeDDMBakerJointCandidates. The full solve comes first
+std::vector<DDMBakerCandidateBenchmarkResult> RunDDMBakerCandidateBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, float twistLimit,
+	DDMBakerSolveMode solveMode, int numMaxBones, const std::vector<int>& maxNumCandidatesToRun, unsigned int seed);
+
+struct DDMSkinWeightsBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	size_t m_numDenseBytes = 0;
+	size_t m_numSparseBytes = 0;	//Values, joint indices and row starts
+	double m_denseAccessorSeconds = 0.0;	//What FBXMesh::GetWeightsMatrix cost per call when it built a dense matrix
+	double m_sparseBuildSeconds = 0.0;	//GetDDMSkinWeights, once per mesh at load
+	double m_restPositionCopySeconds = 0.0;	//What GetControlPointsMatrixRestPose cost per call when it returned a copy
+	double m_denseScanSeconds = 0.0;	//Visiting every weight
+	double m_sparseScanSeconds = 0.0;
+	bool m_doWeightsMatch = false;
+	double m_checksum = 0.0;	//Keeps the timed loops from being optimized away
+};
+
+//Control points with numWeightsPerControlPoint joint weight pairs each, like an FBX skin
+DDMSkinWeightsBenchmarkResult RunDDMSkinWeightsBenchmark(int numControlPoints, int numJoints, int numWeightsPerControlPoint, int numRepeats);
+
+struct CPUSkinningThroughputResult {
+	int m_numCharacters = 0;
+	double m_skinningSeconds[(int)CPUSkinningMethod::COUNT] = {};	//Per frame, every character with its own pose, highest supported level on every thread
+	double m_ddmSeconds = 0.0;	//The v0 kernel on the same characters, as the comparison
+};
+
+struct CPUSkinningBenchmarkResult {
+	int m_numVertices = 0;	//Per character
+	int m_numJoints = 0;
+	size_t m_numBlockBytes = 0;
+	double m_averageNumInfluences = 0.0;	//Per vertex block, which is what the kernels loop over
+	bool m_isSimdLevelSupported[(int)DDMSimdLevel::COUNT] = {};
+	double m_singleThreadSeconds[(int)CPUSkinningMethod::COUNT][(int)DDMSimdLevel::COUNT] = {};	//One character
+	double m_maxPositionError[(int)CPUSkinningMethod::COUNT][(int)DDMSimdLevel::COUNT] = {};	//Largest distance to ComputeCPUSkinnedVertexReference over every vertex
+	double m_maxNormalError[(int)CPUSkinningMethod::COUNT][(int)DDMSimdLevel::COUNT] = {};
+	int m_numParallelThreads = 0;
+	std::vector<CPUSkinningThroughputResult> m_throughputs;	//One per entry of numCharactersToRun
+};
+
+//The precompute benchmark's tube with the 8 largest weights of every control point, as Vertex_FBX. Every character bends it by a different amount
+CPUSkinningBenchmarkResult RunCPUSkinningBenchmark(JobSystem& jobSystem, int numVertices, int numJoints, const std::vector<int>& numCharactersToRun, int numRepeats);
+
+struct FBXVertexDedupBenchmarkResult {
+	int m_numPolygonVertices = 0;
+	int m_numRenderVertices = 0;
+	int m_numChunks = 0;
+	double m_mapSeconds = 0.0;	//std::map<Vertex_FBX, unsigned int>, what ProcessFbxMesh used before DeduplicateFBXVertices
+	double m_hashSerialSeconds = 0.0;	//DeduplicateFBXVertices without a job system
+	double m_hashParallelSeconds = 0.0;
+	int m_numParallelThreads = 0;
+	bool m_areIndicesIdentical = false;	//Both hash runs against the map
+	bool m_areVerticesIdentical = false;	//Render vertices byte for byte, and the control points they map to
+};
+
+//The precompute benchmark's tube as triangle corners the way ProcessFbxMesh reads them, with UV seams like RunDDMVertexWritebackTest and a -0 in the normal of every other face
+FBXVertexDedupBenchmarkResult RunFBXVertexDedupBenchmark(JobSystem& jobSystem, int numControlPoints, int chunkSize, int numRepeats);
+
+struct FBXSkeletonThroughputResult {
+	int m_numCharacters = 0;
+	double m_jointTreeSeconds = 0.0;	//Per frame, every character with its own pose
+	double m_flatSeconds = 0.0;
+};
+
+struct FBXSkeletonBenchmarkResult {
+	int m_numJoints = 0;	//Per character
+	int m_maxDepth = 0;
+	double m_maxGlobalTransformError = 0.0;	//Largest difference of any matrix element between the two, over every joint of every character
+	double m_maxSkinningMatrixError = 0.0;
+	std::vector<FBXSkeletonThroughputResult> m_throughputs;	//One per entry of numCharactersToRun
+};
+
+//Random skeletons with a few delta rotates and a random pose each. The joint tree is what FBXModel::Update did before FBXSkeleton: FBXJoint::SetPoseIfThisIsRoot's
+//walk over heap allocated joints, then the skinning matrices and the structured buffer list gathered joint by joint. The flat side is FBXModel::UpdateSkeleton.
+//The joint tree side runs on BenchmarkTreeJoint, not FBXJoint, so its times are of a copy of that walk: the same math and index lookups, not the same memory layout
+FBXSkeletonBenchmarkResult RunFBXSkeletonBenchmark(int numJoints, const std::vector<int>& numCharactersToRun, int numRepeats);
+
+struct FBXModelInstancingThroughputResult {
+	int m_numCopies = 0;
+	double m_deepCopySeconds = 0.0;	//Making all of them
+	double m_sharedSeconds = 0.0;
+	size_t m_deepCopyBytes = 0;	//The source model and all of the copies
+	size_t m_sharedBytes = 0;
+};
+
+struct FBXModelInstancingBenchmarkResult {
+	int m_numControlPoints = 0;
+	int m_numRenderVertices = 0;
+	int m_numJoints = 0;
+	int m_numPoses = 0;
+	size_t m_meshAssetBytes = 0;
+	size_t m_poseSequenceBytes = 0;
+	size_t m_instanceBytes = 0;	//What every copy still pays for: joints, skeleton, current pose and render vertices
+	bool m_areDeepCopiesIdentical = false;	//The deep copy really copies the whole mesh asset
+	bool m_isSharedDataReleased = false;	//Outlives the source model, goes away with the last copy
+	std::vector<FBXModelInstancingThroughputResult> m_throughputs;	//One per entry of numCopiesToRun
+};
+
+//One mesh on the precompute benchmark's tube with its joint chain and an animation, copied by CreateBenchmarkModelCopy, a model of FBXModel::CreateCopy without its GPU work.
+//The times and sizes are the model's, not a measurement of FBXModel::CreateCopy. The deep copies own their FBXMeshAsset and pose sequence like every copy did before they were shared, the shared copies only own the per-instance part
+FBXModelInstancingBenchmarkResult RunFBXModelInstancingBenchmark(JobSystem& jobSystem, int numControlPoints, int numJoints, int numPoses, const std::vector<int>& numCopiesToRun, int numRepeats);
+
+void RegisterFBXDDMBenchmarkCommands();	//The benchmarks and the tests of every FBX module. FBXParser registers them when the game defines ENGINE_ENABLE_BENCHMARK_COMMANDS
+bool Command_DDMv0KernelBenchmark(EventArgs& args);
+bool Command_DDMSparseOmegaReport(EventArgs& args);
+bool Command_DDMPrecomputeBenchmark(EventArgs& args);
+bool Command_DDMv1KernelBenchmark(EventArgs& args);
+bool Command_DDMHeadlessBenchmark(EventArgs& args);	//Same options as RunDDMHeadlessBenchmarkMain, with Output relative to the working directory
+bool Command_DDMBakerBenchmark(EventArgs& args);
+bool Command_DDMBakerCandidateBenchmark(EventArgs& args);
+bool Command_DDMSkinWeightsBenchmark(EventArgs& args);	//Defaults to 100k control points and 150 joints
+bool Command_CPUSkinningBenchmark(EventArgs& args);	//1 to 100 characters, or NumCharacters
+bool Command_FBXVertexDedupBenchmark(EventArgs& args);	//Defaults to 1.2M polygon vertices
+bool Command_FBXSkeletonBenchmark(EventArgs& args);	//1 to 1000 characters of 120 joints, or NumCharacters
+bool Command_FBXModelInstancingBenchmark(EventArgs& args);	//1, 100 and 1000 copies of a 5k control point, 60 joint model, or NumCopies
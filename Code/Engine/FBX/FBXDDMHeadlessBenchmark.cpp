@@ -0,0 +1,679 @@
+#include "Engine/Fbx/FBXDDMHeadlessBenchmark.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <unordered_map>
+
+static constexpr double PI = 3.14159265358979323846;
+
+//The parameters FBXDDMModifier::Precompute gets from the FBX loader
+static constexpr double HEADLESS_LAMBDA = 0.5;
+static constexpr double HEADLESS_KAPPA = 0.1;
+static constexpr double HEADLESS_ALPHA = 0.5;
+static constexpr int DEFORM_PARALLEL_FOR_GRAIN_SIZE = 64;	//Control points, as in FBXDDMModifierCPU
+
+static const char* const SYNTHETIC_MESH_TYPE_NAMES[(int)DDMSyntheticMeshType::COUNT] = { "GridCylinder", "SubdividedSphere", "Limb" };
+
+const char* GetDDMSyntheticMeshTypeName(DDMSyntheticMeshType type)
+{
+	if (type < DDMSyntheticMeshType::GRID_CYLINDER || type >= DDMSyntheticMeshType::COUNT) {
+		return "Unknown";
+	}
+	return SYNTHETIC_MESH_TYPE_NAMES[(int)type];
+}
+
+bool GetDDMSyntheticMeshTypeFromName(const std::string& name, DDMSyntheticMeshType& outType)
+{
+	for (int typeIdx = 0; typeIdx < (int)DDMSyntheticMeshType::COUNT; typeIdx++) {
+		if (AreStringsEqualCaseInsensitive(name, SYNTHETIC_MESH_TYPE_NAMES[typeIdx])) {
+			outType = (DDMSyntheticMeshType)typeIdx;
+			return true;
+		}
+	}
+	return false;
+}
+
+void GetDDMSyntheticChainWeights(double height, int numJoints, std::vector<double>& outWeights)
+{
+	double jointSpacing = 2.0 / (double)numJoints;
+	double weightSum = 0.0;
+	outWeights.resize(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		double jointHeight = -1.0 + ((double)jointIdx + 0.5) * jointSpacing;
+		double distance = (height - jointHeight) / jointSpacing;
+		outWeights[jointIdx] = exp(-0.5 * distance * distance);
+		weightSum += outWeights[jointIdx];
+	}
+	for (double& weight : outWeights) {
+		weight /= weightSum;
+	}
+}
+
+static std::vector<double> GetEvenlySpacedJointHeights(int numJoints)
+{
+	std::vector<double> jointHeights(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		jointHeights[jointIdx] = -1.0 + ((double)jointIdx + 0.5) * 2.0 / (double)numJoints;
+	}
+	return jointHeights;
+}
+
+//The 4 strongest chain weights at this height, renormalized, the way an exporter limits the influences per vertex
+static void SetChainSkinWeights(DDMSyntheticSkinnedMesh& mesh, int ctrlPointIdx, double height, std::vector<double>& jointWeights, std::vector<int>& jointOrder)
+{
+	constexpr int NUM_SKIN_WEIGHTS = 4;
+	int numJoints = (int)mesh.m_weights.cols();
+	GetDDMSyntheticChainWeights(height, numJoints, jointWeights);
+	jointOrder.resize(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		jointOrder[jointIdx] = jointIdx;
+	}
+	int numSkinWeights = std::min(NUM_SKIN_WEIGHTS, numJoints);
+	std::partial_sort(jointOrder.begin(), jointOrder.begin() + numSkinWeights, jointOrder.end(), [&](int a, int b) { return jointWeights[a] > jointWeights[b]; });
+	double skinWeightSum = 0.0;
+	for (int i = 0; i < numSkinWeights; i++) {
+		skinWeightSum += jointWeights[jointOrder[i]];
+	}
+	for (int i = 0; i < numSkinWeights; i++) {
+		mesh.m_weights(ctrlPointIdx, jointOrder[i]) = jointWeights[jointOrder[i]] / skinWeightSum;
+	}
+}
+
+//Two triangles per quad between ring r and r + 1, wrapping around the segments
+static void SetTubeFaces(DDMSyntheticSkinnedMesh& mesh, int numRings, int numSegments)
+{
+	mesh.m_faces.resize((numRings - 1) * numSegments * 2, 3);
+	for (int ringIdx = 0; ringIdx + 1 < numRings; ringIdx++) {
+		for (int segmentIdx = 0; segmentIdx < numSegments; segmentIdx++) {
+			int ctrlPointIdx = ringIdx * numSegments + segmentIdx;
+			int nextSegmentIdx = (segmentIdx + 1) % numSegments;
+			int faceIdx = (ringIdx * numSegments + segmentIdx) * 2;
+			mesh.m_faces.row(faceIdx) = Eigen::RowVector3i(ctrlPointIdx, ctrlPointIdx + numSegments, ringIdx * numSegments + nextSegmentIdx);
+			mesh.m_faces.row(faceIdx + 1) = Eigen::RowVector3i(ringIdx * numSegments + nextSegmentIdx, ctrlPointIdx + numSegments, (ringIdx + 1) * numSegments + nextSegmentIdx);
+		}
+	}
+}
+
+DDMSyntheticSkinnedMesh BuildDDMGridCylinder(int numRings, int numSegments, int numJoints)
+{
+	GUARANTEE_OR_DIE(numRings >= 2 && numSegments >= 3 && numJoints > 0, "A grid cylinder needs 2 rings, 3 segments and a joint");
+	constexpr double TUBE_RADIUS = 0.25;
+
+	DDMSyntheticSkinnedMesh mesh;
+	mesh.m_type = DDMSyntheticMeshType::GRID_CYLINDER;
+	mesh.m_restPositions.resize(numRings * numSegments, 3);
+	mesh.m_weights.setZero(numRings * numSegments, numJoints);
+	mesh.m_jointHeights = GetEvenlySpacedJointHeights(numJoints);
+	std::vector<double> jointWeights;
+	std::vector<int> jointOrder;
+	for (int ringIdx = 0; ringIdx < numRings; ringIdx++) {
+		double height = -1.0 + 2.0 * (double)ringIdx / (double)(numRings - 1);
+		for (int segmentIdx = 0; segmentIdx < numSegments; segmentIdx++) {
+			int ctrlPointIdx = ringIdx * numSegments + segmentIdx;
+			double angle = 2.0 * PI * (double)segmentIdx / (double)numSegments;
+			mesh.m_restPositions.row(ctrlPointIdx) = Eigen::RowVector3d(TUBE_RADIUS * cos(angle), height, TUBE_RADIUS * sin(angle));
+			SetChainSkinWeights(mesh, ctrlPointIdx, height, jointWeights, jointOrder);
+		}
+	}
+	SetTubeFaces(mesh, numRings, numSegments);
+	return mesh;
+}
+
+DDMSyntheticSkinnedMesh BuildDDMSubdividedSphere(int numSubdivisions, int numJoints)
+{
+	GUARANTEE_OR_DIE(numSubdivisions >= 0 && numSubdivisions <= 10 && numJoints > 0, "numSubdivisions has to be in [0, 10] and numJoints positive");
+
+	//Icosahedron
+	const double goldenRatio = (1.0 + sqrt(5.0)) * 0.5;
+	std::vector<Eigen::RowVector3d> positions = {
+		{ -1.0, goldenRatio, 0.0 }, { 1.0, goldenRatio, 0.0 }, { -1.0, -goldenRatio, 0.0 }, { 1.0, -goldenRatio, 0.0 },
+		{ 0.0, -1.0, goldenRatio }, { 0.0, 1.0, goldenRatio }, { 0.0, -1.0, -goldenRatio }, { 0.0, 1.0, -goldenRatio },
+		{ goldenRatio, 0.0, -1.0 }, { goldenRatio, 0.0, 1.0 }, { -goldenRatio, 0.0, -1.0 }, { -goldenRatio, 0.0, 1.0 }
+	};
+	std::vector<Eigen::RowVector3i> faces = {
+		{ 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 }, { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+		{ 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 }, { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+	};
+	for (Eigen::RowVector3d& position : positions) {
+		position.normalize();
+	}
+
+	//Every edge is split once, the midpoints are shared between the two faces of an edge
+	std::unordered_map<uint64_t, int> midpointIndices;
+	auto getMidpointIdx = [&](int a, int b) {
+		uint64_t edgeKey = ((uint64_t)std::min(a, b) << 32) | (uint64_t)std::max(a, b);
+		auto found = midpointIndices.find(edgeKey);
+		if (found != midpointIndices.end()) {
+			return found->second;
+		}
+		int midpointIdx = (int)positions.size();
+		positions.push_back((positions[a] + positions[b]).normalized());
+		midpointIndices.emplace(edgeKey, midpointIdx);
+		return midpointIdx;
+	};
+	for (int subdivisionIdx = 0; subdivisionIdx < numSubdivisions; subdivisionIdx++) {
+		midpointIndices.clear();
+		std::vector<Eigen::RowVector3i> subdividedFaces;
+		subdividedFaces.reserve(faces.size() * 4);
+		for (const Eigen::RowVector3i& face : faces) {
+			int ab = getMidpointIdx(face(0), face(1));
+			int bc = getMidpointIdx(face(1), face(2));
+			int ca = getMidpointIdx(face(2), face(0));
+			subdividedFaces.emplace_back(face(0), ab, ca);
+			subdividedFaces.emplace_back(face(1), bc, ab);
+			subdividedFaces.emplace_back(face(2), ca, bc);
+			subdividedFaces.emplace_back(ab, bc, ca);
+		}
+		faces.swap(subdividedFaces);
+	}
+
+	DDMSyntheticSkinnedMesh mesh;
+	mesh.m_type = DDMSyntheticMeshType::SUBDIVIDED_SPHERE;
+	mesh.m_restPositions.resize((Eigen::Index)positions.size(), 3);
+	mesh.m_faces.resize((Eigen::Index)faces.size(), 3);
+	mesh.m_weights.setZero((Eigen::Index)positions.size(), numJoints);
+	mesh.m_jointHeights = GetEvenlySpacedJointHeights(numJoints);
+	std::vector<double> jointWeights;
+	std::vector<int> jointOrder;
+	for (int ctrlPointIdx = 0; ctrlPointIdx < (int)positions.size(); ctrlPointIdx++) {
+		mesh.m_restPositions.row(ctrlPointIdx) = positions[ctrlPointIdx];
+		SetChainSkinWeights(mesh, ctrlPointIdx, positions[ctrlPointIdx](1), jointWeights, jointOrder);
+	}
+	for (int faceIdx = 0; faceIdx < (int)faces.size(); faceIdx++) {
+		mesh.m_faces.row(faceIdx) = faces[faceIdx];
+	}
+	return mesh;
+}
+
+DDMSyntheticSkinnedMesh BuildDDMLimb(int numRings, int numSegments, int numJoints)
+{
+	GUARANTEE_OR_DIE(numRings >= 2 && numSegments >= 3 && numJoints > 0, "A limb needs 2 rings, 3 segments and a joint");
+	constexpr double BONE_LENGTH_FALLOFF = 0.8;	//Upper arm, forearm, hand, fingers...
+	constexpr double BASE_RADIUS = 0.25;
+	constexpr double TIP_RADIUS = 0.1;
+	constexpr double BULGE = 0.2;	//Relative to the radius, at the joints
+	constexpr double BLEND_FRACTION = 0.25;	//Of the shorter bone at a joint, on either side of it
+
+	DDMSyntheticSkinnedMesh mesh;
+	mesh.m_type = DDMSyntheticMeshType::LIMB;
+	mesh.m_restPositions.resize(numRings * numSegments, 3);
+	mesh.m_weights.setZero(numRings * numSegments, numJoints);
+
+	//Joint j is where bone j starts. The bones cover y in [-1, 1]
+	std::vector<double> boneLengths(numJoints);
+	double boneLengthSum = 0.0;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		boneLengths[jointIdx] = pow(BONE_LENGTH_FALLOFF, (double)jointIdx);
+		boneLengthSum += boneLengths[jointIdx];
+	}
+	mesh.m_jointHeights.resize(numJoints);
+	double boneStart = -1.0;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		boneLengths[jointIdx] *= 2.0 / boneLengthSum;
+		mesh.m_jointHeights[jointIdx] = boneStart;
+		boneStart += boneLengths[jointIdx];
+	}
+	std::vector<double> blendHalfWidths(numJoints, 0.0);	//None at the root
+	for (int jointIdx = 1; jointIdx < numJoints; jointIdx++) {
+		blendHalfWidths[jointIdx] = BLEND_FRACTION * std::min(boneLengths[jointIdx - 1], boneLengths[jointIdx]);
+	}
+
+	for (int ringIdx = 0; ringIdx < numRings; ringIdx++) {
+		double height = -1.0 + 2.0 * (double)ringIdx / (double)(numRings - 1);
+		int boneIdx = (int)(std::upper_bound(mesh.m_jointHeights.begin(), mesh.m_jointHeights.end(), height) - mesh.m_jointHeights.begin()) - 1;
+		boneIdx = std::clamp(boneIdx, 0, numJoints - 1);
+
+		//Only the joints at both ends of the bone can be close enough to blend or bulge
+		double radius = BASE_RADIUS + (TIP_RADIUS - BASE_RADIUS) * (height + 1.0) * 0.5;
+		double jointWeights[2] = { 1.0, 0.0 };
+		int blendJointIndices[2] = { boneIdx, boneIdx };
+		double bulge = 0.0;
+		for (int jointIdx = std::max(boneIdx, 1); jointIdx <= std::min(boneIdx + 1, numJoints - 1); jointIdx++) {
+			double distance = (height - mesh.m_jointHeights[jointIdx]) / blendHalfWidths[jointIdx];
+			bulge = std::max(bulge, BULGE * exp(-distance * distance));
+			if (fabs(distance) < 1.0) {
+				double t = (distance + 1.0) * 0.5;
+				t = t * t * (3.0 - 2.0 * t);
+				blendJointIndices[0] = jointIdx - 1;
+				blendJointIndices[1] = jointIdx;
+				jointWeights[0] = 1.0 - t;
+				jointWeights[1] = t;
+			}
+		}
+		radius *= 1.0 + bulge;
+
+		for (int segmentIdx = 0; segmentIdx < numSegments; segmentIdx++) {
+			int ctrlPointIdx = ringIdx * numSegments + segmentIdx;
+			double angle = 2.0 * PI * (double)segmentIdx / (double)numSegments;
+			mesh.m_restPositions.row(ctrlPointIdx) = Eigen::RowVector3d(radius * cos(angle), height, radius * sin(angle));
+			mesh.m_weights(ctrlPointIdx, blendJointIndices[0]) += jointWeights[0];
+			mesh.m_weights(ctrlPointIdx, blendJointIndices[1]) += jointWeights[1];
+		}
+	}
+	SetTubeFaces(mesh, numRings, numSegments);
+	return mesh;
+}
+
+DDMSyntheticSkinnedMesh BuildDDMSyntheticSkinnedMesh(DDMSyntheticMeshType type, int approxNumControlPoints, int numJoints)
+{
+	GUARANTEE_OR_DIE(approxNumControlPoints > 0, "approxNumControlPoints <= 0");
+	switch (type) {
+	case DDMSyntheticMeshType::SUBDIVIDED_SPHERE: {
+		//Each subdivision quadruples the count, so compare on a log scale
+		int numSubdivisions = 0;
+		while (numSubdivisions < 10 && 10.0 * pow(4.0, numSubdivisions + 0.5) + 2.0 < (double)approxNumControlPoints) {
+			numSubdivisions++;
+		}
+		return BuildDDMSubdividedSphere(numSubdivisions, numJoints);
+	}
+	case DDMSyntheticMeshType::GRID_CYLINDER:
+	case DDMSyntheticMeshType::LIMB: {
+		//Quads about as tall as they are wide: the tube is 2 * PI * 0.25 around and 2 high
+		int numSegments = std::max((int)std::lround(sqrt((double)approxNumControlPoints * PI * 0.25)), 3);
+		int numRings = std::max((approxNumControlPoints + numSegments / 2) / numSegments, 2);
+		return type == DDMSyntheticMeshType::LIMB ? BuildDDMLimb(numRings, numSegments, numJoints) : BuildDDMGridCylinder(numRings, numSegments, numJoints);
+	}
+	default:
+		ERROR_AND_DIE(Stringf("Unknown synthetic mesh type %d", (int)type));
+	}
+}
+
+std::vector<Mat44> GetDDMSyntheticPose(const DDMSyntheticSkinnedMesh& mesh, float bendDegrees)
+{
+	std::vector<Mat44> skinningMatrices(mesh.m_jointHeights.size());
+	Mat44 globalTransform;
+	double parentHeight = 0.0;
+	for (size_t jointIdx = 0; jointIdx < mesh.m_jointHeights.size(); jointIdx++) {
+		double jointHeight = mesh.m_jointHeights[jointIdx];
+		globalTransform.AppendTranslation3D(Vec3(0.0f, (float)(jointHeight - parentHeight), 0.0f));
+		globalTransform.AppendXRotation(bendDegrees);
+		globalTransform.AppendYRotation(bendDegrees / 3.0f);
+		skinningMatrices[jointIdx] = globalTransform;
+		skinningMatrices[jointIdx].AppendTranslation3D(Vec3(0.0f, (float)-jointHeight, 0.0f));	//Inverse bind: the joint sits at (0, jointHeight, 0) in the rest pose
+		parentHeight = jointHeight;
+	}
+	return skinningMatrices;
+}
+
+static bool ParseIntList(const std::string& value, std::vector<int>& outValues)
+{
+	outValues.clear();
+	for (const std::string& entry : SplitStringOnDelimeter(value, ',')) {
+		if (entry.empty()) {
+			continue;
+		}
+		bool wasSuccessful = false;
+		int parsedValue = ConvertStringToInt(entry, wasSuccessful);
+		if (!wasSuccessful || parsedValue <= 0) {
+			return false;
+		}
+		outValues.push_back(parsedValue);
+	}
+	return true;
+}
+
+const std::vector<std::string>& GetDDMHeadlessBenchmarkOptionNames()
+{
+	static const std::vector<std::string> s_optionNames = { "Meshes", "NumControlPoints", "Threads", "NumJoints", "Iterations", "Repeats", "ReferenceControlPoints",
+		"Tolerance", "Bend", "Output" };
+	return s_optionNames;
+}
+
+bool SetDDMHeadlessBenchmarkOption(DDMHeadlessBenchmarkConfig& config, const std::string& name, const std::string& value, std::string* errorStr)
+{
+	auto fail = [&](const std::string& error) {
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+	auto parsePositiveInt = [&](int& outValue) {
+		bool wasSuccessful = false;
+		int parsedValue = ConvertStringToInt(value, wasSuccessful);
+		if (!wasSuccessful || parsedValue <= 0) {
+			return fail(Stringf("%s has to be a positive integer, got \"%s\"", name.c_str(), value.c_str()));
+		}
+		outValue = parsedValue;
+		return true;
+	};
+
+	if (AreStringsEqualCaseInsensitive(name, "Meshes")) {
+		std::vector<DDMSyntheticMeshType> meshTypes;
+		for (const std::string& meshName : SplitStringOnDelimeter(value, ',')) {
+			DDMSyntheticMeshType meshType;
+			if (!GetDDMSyntheticMeshTypeFromName(meshName, meshType)) {
+				return fail(Stringf("Unknown mesh \"%s\", has to be GridCylinder, SubdividedSphere or Limb", meshName.c_str()));
+			}
+			meshTypes.push_back(meshType);
+		}
+		config.m_meshTypes = meshTypes;
+		return true;
+	}
+	if (AreStringsEqualCaseInsensitive(name, "NumControlPoints")) {
+		std::vector<int> numControlPoints;
+		if (!ParseIntList(value, numControlPoints) || numControlPoints.empty()) {
+			return fail(Stringf("NumControlPoints has to be a list of positive integers, got \"%s\"", value.c_str()));
+		}
+		config.m_numControlPoints = numControlPoints;
+		return true;
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Threads")) {
+		if (!ParseIntList(value, config.m_numThreads)) {
+			return fail(Stringf("Threads has to be a list of positive integers, got \"%s\"", value.c_str()));
+		}
+		return true;
+	}
+	if (AreStringsEqualCaseInsensitive(name, "NumJoints")) {
+		return parsePositiveInt(config.m_numJoints);
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Iterations")) {
+		return parsePositiveInt(config.m_numLaplacianIterations);
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Repeats")) {
+		return parsePositiveInt(config.m_numDeformRepeats);
+	}
+	if (AreStringsEqualCaseInsensitive(name, "ReferenceControlPoints")) {
+		return parsePositiveInt(config.m_numReferenceControlPoints);
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Tolerance")) {
+		config.m_tolerance = atof(value.c_str());
+		return true;
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Bend")) {
+		config.m_bendDegrees = (float)atof(value.c_str());
+		return true;
+	}
+	if (AreStringsEqualCaseInsensitive(name, "Output")) {
+		config.m_outputPath = value;
+		return true;
+	}
+	return fail(Stringf("Unknown option \"%s\"", name.c_str()));
+}
+
+bool DDMHeadlessBenchmarkReport::HasPassed() const
+{
+	if (m_runs.empty()) {
+		return false;
+	}
+	for (const DDMHeadlessBenchmarkRun& run : m_runs) {
+		if (!run.m_hasPassed) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static double GetMedian(std::vector<double> values)
+{
+	std::sort(values.begin(), values.end());
+	size_t middleIdx = values.size() / 2;
+	return (values.size() % 2 == 1) ? values[middleIdx] : 0.5 * (values[middleIdx - 1] + values[middleIdx]);
+}
+
+static std::vector<int> GetDefaultThreadCounts(int numHardwareThreads)
+{
+	std::vector<int> numThreads;
+	for (int numThreadsOfRun = 1; numThreadsOfRun < numHardwareThreads; numThreadsOfRun *= 2) {
+		numThreads.push_back(numThreadsOfRun);
+	}
+	numThreads.push_back(numHardwareThreads);
+	return numThreads;
+}
+
+//Deforms every control point numRepeats times and keeps the positions of the last repeat
+static void TimeDeform(JobSystem& jobSystem, const DDMControlPointPackets& packets, const std::vector<float>& jointTransforms, bool isVariant1, int numRepeats,
+	std::vector<float>& outPositions, double& outMedianSeconds, double& outMinSeconds)
+{
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	int grainSizeInPackets = std::max(DEFORM_PARALLEL_FOR_GRAIN_SIZE / DDMControlPointPackets::PACKET_SIZE, 1);
+	outPositions.assign((size_t)packets.GetNumControlPoints() * 3, 0.0f);
+	std::vector<double> repeatSeconds(numRepeats);
+	for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+		double startTime = GetCurrentTimeSeconds();
+		jobSystem.ParallelForRange(0, packets.GetNumPackets(), grainSizeInPackets, [&](int beginPacketIdx, int endPacketIdx) {
+			if (isVariant1) {
+				ComputeDDMv1DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, outPositions.data(), 3, 1, simdLevel);
+			}
+			else {
+				ComputeDDMv0DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, outPositions.data(), 3, 1, simdLevel);
+			}
+		});
+		repeatSeconds[repeatIdx] = GetCurrentTimeSeconds() - startTime;
+	}
+	outMedianSeconds = GetMedian(repeatSeconds);
+	outMinSeconds = *std::min_element(repeatSeconds.begin(), repeatSeconds.end());
+}
+
+DDMHeadlessBenchmarkReport RunDDMHeadlessBenchmark(const DDMHeadlessBenchmarkConfig& config)
+{
+	GUARANTEE_OR_DIE(config.m_numJoints > 0, "numJoints <= 0");
+	GUARANTEE_OR_DIE(config.m_numDeformRepeats > 0, "numDeformRepeats <= 0");
+
+	DDMHeadlessBenchmarkReport report;
+	report.m_config = config;
+	report.m_simdLevelName = GetDDMSimdLevelName(GetHighestSupportedDDMSimdLevel());
+	report.m_numHardwareThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+	std::vector<int> numThreadsToRun = config.m_numThreads.empty() ? GetDefaultThreadCounts(report.m_numHardwareThreads) : config.m_numThreads;
+
+	for (DDMSyntheticMeshType meshType : config.m_meshTypes) {
+		for (int approxNumControlPoints : config.m_numControlPoints) {
+			DDMSyntheticSkinnedMesh mesh = BuildDDMSyntheticSkinnedMesh(meshType, approxNumControlPoints, config.m_numJoints);
+			int numControlPoints = (int)mesh.m_restPositions.rows();
+			std::vector<Mat44> pose = GetDDMSyntheticPose(mesh, config.m_bendDegrees);
+			std::vector<float> jointTransforms;
+			ConvertJointTransformsToFloats(pose, jointTransforms);
+			std::vector<Eigen::Matrix<double, 4, 4>> jointTransformsEigen(pose.size());
+			for (size_t jointIdx = 0; jointIdx < pose.size(); jointIdx++) {
+				jointTransformsEigen[jointIdx] = FBXDDMModifier::ConvertMat44ToEigen(pose[jointIdx]);
+			}
+
+			DDMSparseOmegas firstOmegas;
+			Eigen::MatrixXd firstV1ConstantMatrix;
+			bool isFirstRunOfMesh = true;
+			for (int numThreads : numThreadsToRun) {
+				if (numThreads > report.m_numHardwareThreads) {
+					continue;
+				}
+				JobSystem jobSystem(JobSystemConfig(numThreads - 1));
+				jobSystem.Startup();
+
+				DDMHeadlessBenchmarkRun run;
+				run.m_meshType = meshType;
+				run.m_numControlPoints = numControlPoints;
+				run.m_numFaces = (int)mesh.m_faces.rows();
+				run.m_numJoints = config.m_numJoints;
+				run.m_numThreads = jobSystem.GetNumWorkerThreads() + 1;
+
+				DDMSparseOmegas omegas;
+				Eigen::MatrixXd v1ConstantMatrix;
+				ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, config.m_numLaplacianIterations, HEADLESS_LAMBDA, HEADLESS_KAPPA,
+					HEADLESS_ALPHA, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix, &run.m_precomputeTimings);
+				run.m_numInfluences = (int)omegas.GetJointIndices().size();
+				if (isFirstRunOfMesh) {
+					firstOmegas = omegas;
+					firstV1ConstantMatrix = v1ConstantMatrix;
+					isFirstRunOfMesh = false;
+				}
+				else {
+					run.m_doesPrecomputeMatchFirstRun = omegas.GetFirstInfluenceIndices() == firstOmegas.GetFirstInfluenceIndices()
+						&& omegas.GetJointIndices() == firstOmegas.GetJointIndices() && omegas.GetOmegas() == firstOmegas.GetOmegas()
+						&& v1ConstantMatrix.size() == firstV1ConstantMatrix.size()
+						&& memcmp(v1ConstantMatrix.data(), firstV1ConstantMatrix.data(), v1ConstantMatrix.size() * sizeof(double)) == 0;
+				}
+
+				double startTime = GetCurrentTimeSeconds();
+				DDMControlPointPackets packets;
+				packets.Build(omegas, mesh.m_restPositions, &v1ConstantMatrix);
+				run.m_packetBuildSeconds = GetCurrentTimeSeconds() - startTime;
+
+				int numReferenceControlPoints = std::min(config.m_numReferenceControlPoints, numControlPoints);
+				std::vector<float> deformedPositions;
+				TimeDeform(jobSystem, packets, jointTransforms, false, config.m_numDeformRepeats, deformedPositions, run.m_v0MedianSeconds, run.m_v0MinSeconds);
+				for (int ctrlPointIdx = 0; ctrlPointIdx < numReferenceControlPoints; ctrlPointIdx++) {
+					Eigen::Map<const Eigen::Matrix<float, 1, 3>> deformedPosition(deformedPositions.data() + (size_t)ctrlPointIdx * 3);
+					Eigen::Matrix<float, 1, 3> referencePosition = ComputeDDMv0DeformedControlPointReference(omegas, ctrlPointIdx, mesh.m_restPositions.row(ctrlPointIdx),
+						jointTransformsEigen);
+					run.m_v0MaxErrorToReference = std::max(run.m_v0MaxErrorToReference, (double)(deformedPosition - referencePosition).norm());
+				}
+				TimeDeform(jobSystem, packets, jointTransforms, true, config.m_numDeformRepeats, deformedPositions, run.m_v1MedianSeconds, run.m_v1MinSeconds);
+				for (int ctrlPointIdx = 0; ctrlPointIdx < numReferenceControlPoints; ctrlPointIdx++) {
+					Eigen::Map<const Eigen::Matrix<float, 1, 3>> deformedPosition(deformedPositions.data() + (size_t)ctrlPointIdx * 3);
+					Eigen::Matrix<float, 1, 3> referencePosition = ComputeDDMv1DeformedControlPointReference(omegas, ctrlPointIdx, mesh.m_restPositions.row(ctrlPointIdx),
+						v1ConstantMatrix.row(ctrlPointIdx), jointTransformsEigen);
+					run.m_v1MaxErrorToReference = std::max(run.m_v1MaxErrorToReference, (double)(deformedPosition - referencePosition).norm());
+				}
+				jobSystem.Shutdown();
+
+				//Negated comparisons, so a Nan error fails
+				run.m_hasPassed = run.m_doesPrecomputeMatchFirstRun && !(run.m_v0MaxErrorToReference > config.m_tolerance)
+					&& !(run.m_v1MaxErrorToReference > config.m_tolerance) && std::isfinite(run.m_v0MaxErrorToReference) && std::isfinite(run.m_v1MaxErrorToReference);
+				report.m_runs.push_back(run);
+			}
+		}
+	}
+	return report;
+}
+
+//%.9g round trips every value a benchmark can produce closely enough, and never prints the inf or nan that JSON has no literal for
+static std::string GetJsonNumber(double value)
+{
+	if (!std::isfinite(value)) {
+		return "null";
+	}
+	return Stringf("%.9g", value);
+}
+
+static std::string GetJsonString(const std::string& value)
+{
+	std::string escaped = "\"";
+	for (char character : value) {
+		if (character == '"' || character == '\\') {
+			escaped += '\\';
+			escaped += character;
+		}
+		else if ((unsigned char)character < 0x20) {
+			escaped += Stringf("\\u%04x", (unsigned int)(unsigned char)character);
+		}
+		else {
+			escaped += character;
+		}
+	}
+	return escaped + "\"";
+}
+
+std::string GetDDMHeadlessBenchmarkJson(const DDMHeadlessBenchmarkReport& report)
+{
+	constexpr int FORMAT_VERSION = 1;
+	const DDMHeadlessBenchmarkConfig& config = report.m_config;
+	std::string json = "{\n";
+	json += Stringf("\t\"benchmark\": \"DDMHeadlessBenchmark\",\n\t\"formatVersion\": %d,\n", FORMAT_VERSION);
+	json += Stringf("\t\"simdLevel\": %s,\n\t\"numHardwareThreads\": %d,\n", GetJsonString(report.m_simdLevelName).c_str(), report.m_numHardwareThreads);
+	json += Stringf("\t\"config\": { \"numJoints\": %d, \"numLaplacianIterations\": %d, \"numDeformRepeats\": %d, \"numReferenceControlPoints\": %d, \"tolerance\": %s, \"bendDegrees\": %s },\n",
+		config.m_numJoints, config.m_numLaplacianIterations, config.m_numDeformRepeats, config.m_numReferenceControlPoints, GetJsonNumber(config.m_tolerance).c_str(),
+		GetJsonNumber(config.m_bendDegrees).c_str());
+	json += Stringf("\t\"passed\": %s,\n", report.HasPassed() ? "true" : "false");
+	json += "\t\"runs\": [";
+	for (size_t runIdx = 0; runIdx < report.m_runs.size(); runIdx++) {
+		const DDMHeadlessBenchmarkRun& run = report.m_runs[runIdx];
+		const DDMPrecomputeStageTimings& timings = run.m_precomputeTimings;
+		json += (runIdx == 0) ? "\n" : ",\n";
+		json += "\t\t{\n";
+		json += Stringf("\t\t\t\"mesh\": %s, \"numControlPoints\": %d, \"numFaces\": %d, \"numJoints\": %d, \"numThreads\": %d, \"numInfluences\": %d,\n",
+			GetJsonString(GetDDMSyntheticMeshTypeName(run.m_meshType)).c_str(), run.m_numControlPoints, run.m_numFaces, run.m_numJoints, run.m_numThreads, run.m_numInfluences);
+		json += Stringf("\t\t\t\"precompute\": { \"laplacianSeconds\": %s, \"smoothedWeightsSeconds\": %s, \"pMatrixSeconds\": %s, \"omegasSeconds\": %s, \"totalSeconds\": %s, \"matchesFirstRun\": %s },\n",
+			GetJsonNumber(timings.m_laplacianSeconds).c_str(), GetJsonNumber(timings.m_smoothedWeightsSeconds).c_str(), GetJsonNumber(timings.m_pMatrixSeconds).c_str(),
+			GetJsonNumber(timings.m_omegasSeconds).c_str(), GetJsonNumber(timings.GetTotalSeconds()).c_str(), run.m_doesPrecomputeMatchFirstRun ? "true" : "false");
+		json += Stringf("\t\t\t\"packetBuildSeconds\": %s,\n", GetJsonNumber(run.m_packetBuildSeconds).c_str());
+		const char* variantNames[2] = { "v0", "v1" };
+		double medianSeconds[2] = { run.m_v0MedianSeconds, run.m_v1MedianSeconds };
+		double minSeconds[2] = { run.m_v0MinSeconds, run.m_v1MinSeconds };
+		double maxErrors[2] = { run.m_v0MaxErrorToReference, run.m_v1MaxErrorToReference };
+		for (int variantIdx = 0; variantIdx < 2; variantIdx++) {
+			double nanosecondsPerControlPoint = medianSeconds[variantIdx] * 1.0e9 / (double)std::max(run.m_numControlPoints, 1);
+			json += Stringf("\t\t\t\"%s\": { \"medianSeconds\": %s, \"minSeconds\": %s, \"nanosecondsPerControlPoint\": %s, \"maxErrorToReference\": %s },\n", variantNames[variantIdx],
+				GetJsonNumber(medianSeconds[variantIdx]).c_str(), GetJsonNumber(minSeconds[variantIdx]).c_str(), GetJsonNumber(nanosecondsPerControlPoint).c_str(),
+				GetJsonNumber(maxErrors[variantIdx]).c_str());
+		}
+		json += Stringf("\t\t\t\"passed\": %s\n", run.m_hasPassed ? "true" : "false");
+		json += "\t\t}";
+	}
+	json += "\n\t]\n}\n";
+	return json;
+}
+
+bool SaveDDMHeadlessBenchmarkJson(const std::string& filePath, const DDMHeadlessBenchmarkReport& report, std::string* errorStr)
+{
+	std::string json = GetDDMHeadlessBenchmarkJson(report);
+	std::vector<unsigned char> buffer(json.begin(), json.end());
+	std::error_code errorCode;
+	std::filesystem::path parentPath = std::filesystem::path(filePath).parent_path();
+	if (!parentPath.empty()) {
+		std::filesystem::create_directories(parentPath, errorCode);
+	}
+	if (!FileWriteFromBuffer(buffer, filePath)) {
+		if (errorStr) {
+			*errorStr = Stringf("Unable to write %s", filePath.c_str());
+		}
+		return false;
+	}
+	return true;
+}
+
+std::vector<std::string> GetDDMHeadlessBenchmarkSummaryLines(const DDMHeadlessBenchmarkReport& report)
+{
+	std::vector<std::string> lines;
+	lines.push_back(Stringf("DDMHeadlessBenchmark: %s, %d hardware threads, %d joints, %d Laplacian iterations, median of %d deforms", report.m_simdLevelName.c_str(),
+		report.m_numHardwareThreads, report.m_config.m_numJoints, report.m_config.m_numLaplacianIterations, report.m_config.m_numDeformRepeats));
+	for (const DDMHeadlessBenchmarkRun& run : report.m_runs) {
+		double v0NanosecondsPerControlPoint = run.m_v0MedianSeconds * 1.0e9 / (double)run.m_numControlPoints;
+		double v1NanosecondsPerControlPoint = run.m_v1MedianSeconds * 1.0e9 / (double)run.m_numControlPoints;
+		lines.push_back(Stringf("  %-16s %7d control points, %2d threads: precompute %9.1lf ms, v0 %6.1lf ns (error %.1e), v1 %6.1lf ns (error %.1e) per control point%s %s",
+			GetDDMSyntheticMeshTypeName(run.m_meshType), run.m_numControlPoints, run.m_numThreads, run.m_precomputeTimings.GetTotalSeconds() * 1000.0,
+			v0NanosecondsPerControlPoint, run.m_v0MaxErrorToReference, v1NanosecondsPerControlPoint, run.m_v1MaxErrorToReference,
+			run.m_doesPrecomputeMatchFirstRun ? "" : ", precompute differs from the first thread count", run.m_hasPassed ? "PASSED" : "FAILED"));
+	}
+	return lines;
+}
+
+int RunDDMHeadlessBenchmarkMain(int argc, char** argv)
+{
+	DDMHeadlessBenchmarkConfig config;
+	for (int argIdx = 1; argIdx < argc; argIdx++) {
+		std::string argument = argv[argIdx];
+		size_t equalsPos = argument.find('=');
+		std::string errorStr = Stringf("Expected Name=Value, got \"%s\"", argument.c_str());
+		if (equalsPos == std::string::npos || !SetDDMHeadlessBenchmarkOption(config, argument.substr(0, equalsPos), argument.substr(equalsPos + 1), &errorStr)) {
+			printf("%s\nOptions:", errorStr.c_str());
+			for (const std::string& optionName : GetDDMHeadlessBenchmarkOptionNames()) {
+				printf(" %s", optionName.c_str());
+			}
+			printf("\n");
+			return 2;
+		}
+	}
+
+	DDMHeadlessBenchmarkReport report = RunDDMHeadlessBenchmark(config);
+	for (const std::string& line : GetDDMHeadlessBenchmarkSummaryLines(report)) {
+		printf("%s\n", line.c_str());
+	}
+	if (!config.m_outputPath.empty()) {
+		std::string errorStr;
+		if (!SaveDDMHeadlessBenchmarkJson(config.m_outputPath, report, &errorStr)) {
+			printf("%s\n", errorStr.c_str());
+			return 1;
+		}
+		printf("Wrote %s\n", config.m_outputPath.c_str());
+	}
+	return report.HasPassed() ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+//Times the DDM precompute and the CPU v0/v1 deform kernels on procedural skinned meshes over several thread counts, and writes the results as JSON.
+//Only Eigen, the job system and the DDM math are involved: no FBX file or SDK, renderer, CUDA device or dev console, so a console host can run it without a window
+//and keep the JSON files around to catch performance regressions
+
+enum class DDMSyntheticMeshType {
+	GRID_CYLINDER,		//Rings of a tube around the joint chain, Gaussian weights on the 4 closest joints
+	SUBDIVIDED_SPHERE,	//Icosphere, so the triangles are irregular in the parameter space of the chain. Same weights as the cylinder
+	LIMB,				//Tapered tube with bones of shrinking length, bulges at the joints and at most 2 weights blended across each joint
+	COUNT
+};
+
+struct DDMSyntheticSkinnedMesh {
+	DDMSyntheticMeshType m_type = DDMSyntheticMeshType::GRID_CYLINDER;
+	Eigen::MatrixX3d m_restPositions;
+	Eigen::MatrixX3i m_faces;
+	Eigen::MatrixXd m_weights;	//numControlPoints x numJoints, every row sums to 1. Dense so the tests can edit it, the precompute takes m_weights.sparseView()
+	std::vector<double> m_jointHeights;	//The joints sit on the y axis, ascending, each one the parent of the next
+};
+
+const char* GetDDMSyntheticMeshTypeName(DDMSyntheticMeshType type);
+bool GetDDMSyntheticMeshTypeFromName(const std::string& name, DDMSyntheticMeshType& outType);	//Case insensitive
+
+//Joints spread evenly over y in [-1, 1] with a Gaussian falloff one joint spacing wide, normalized. Every joint gets some weight, most of it tiny
+void GetDDMSyntheticChainWeights(double height, int numJoints, std::vector<double>& outWeights);
+
+DDMSyntheticSkinnedMesh BuildDDMGridCylinder(int numRings, int numSegments, int numJoints);
+DDMSyntheticSkinnedMesh BuildDDMSubdividedSphere(int numSubdivisions, int numJoints);	//10 * 4^numSubdivisions + 2 control points
+DDMSyntheticSkinnedMesh BuildDDMLimb(int numRings, int numSegments, int numJoints);
+DDMSyntheticSkinnedMesh BuildDDMSyntheticSkinnedMesh(DDMSyntheticMeshType type, int approxNumControlPoints, int numJoints);	//Picks the resolution closest to approxNumControlPoints
+
+//Skinning matrices (current global transform times inverse bind) that bend every joint of the chain by bendDegrees about x, with a third of that as twist about y
+std::vector<Mat44> GetDDMSyntheticPose(const DDMSyntheticSkinnedMesh& mesh, float bendDegrees);
+
+struct DDMHeadlessBenchmarkConfig {
+	std::vector<DDMSyntheticMeshType> m_meshTypes = { DDMSyntheticMeshType::GRID_CYLINDER, DDMSyntheticMeshType::SUBDIVIDED_SPHERE, DDMSyntheticMeshType::LIMB };
+	std::vector<int> m_numControlPoints = { 10000, 100000 };	//Approximate, every mesh type rounds to its own resolution
+	std::vector<int> m_numThreads;	//Calling thread included. Empty: 1, 2, 4, ... and the hardware thread count. Counts above the hardware are skipped
+	int m_numJoints = 16;
+	int m_numLaplacianIterations = 8;
+	int m_numDeformRepeats = 10;	//The deform timings are the median and the minimum over these
+	int m_numReferenceControlPoints = 2000;	//The double precision paths only check the first few control points, they are slow
+	double m_tolerance = 1.0e-3;	//Largest distance to the double precision paths that still passes
+	float m_bendDegrees = 10.0f;	//Per joint, see GetDDMSyntheticPose
+	std::string m_outputPath = "DDMHeadlessBenchmark.json";	//Empty writes nothing
+};
+
+//Sets one option from its command line name: Meshes, NumControlPoints, Threads (comma separated lists), NumJoints, Iterations, Repeats, ReferenceControlPoints,
+//Tolerance, Bend, Output
+bool SetDDMHeadlessBenchmarkOption(DDMHeadlessBenchmarkConfig& config, const std::string& name, const std::string& value, std::string* errorStr = nullptr);
+const std::vector<std::string>& GetDDMHeadlessBenchmarkOptionNames();
+
+struct DDMHeadlessBenchmarkRun {
+	DDMSyntheticMeshType m_meshType = DDMSyntheticMeshType::GRID_CYLINDER;
+	int m_numControlPoints = 0;
+	int m_numFaces = 0;
+	int m_numJoints = 0;
+	int m_numThreads = 0;
+	int m_numInfluences = 0;	//Omega blocks kept over all control points
+	DDMPrecomputeStageTimings m_precomputeTimings;
+	bool m_doesPrecomputeMatchFirstRun = true;	//Omegas and v1 constants bit identical to the first thread count of the same mesh
+	double m_packetBuildSeconds = 0.0;
+	double m_v0MedianSeconds = 0.0;
+	double m_v0MinSeconds = 0.0;
+	double m_v0MaxErrorToReference = 0.0;
+	double m_v1MedianSeconds = 0.0;
+	double m_v1MinSeconds = 0.0;
+	double m_v1MaxErrorToReference = 0.0;
+	bool m_hasPassed = false;
+};
+
+struct DDMHeadlessBenchmarkReport {
+	std::string m_simdLevelName;
+	int m_numHardwareThreads = 0;
+	DDMHeadlessBenchmarkConfig m_config;
+	std::vector<DDMHeadlessBenchmarkRun> m_runs;
+
+	bool HasPassed() const;
+};
+
+//Every thread count gets its own JobSystem, so this neither needs nor touches g_theJobSystem
+DDMHeadlessBenchmarkReport RunDDMHeadlessBenchmark(const DDMHeadlessBenchmarkConfig& config);
+std::string GetDDMHeadlessBenchmarkJson(const DDMHeadlessBenchmarkReport& report);	//Field names stay stable across versions, new ones only get added
+bool SaveDDMHeadlessBenchmarkJson(const std::string& filePath, const DDMHeadlessBenchmarkReport& report, std::string* errorStr = nullptr);
+std::vector<std::string> GetDDMHeadlessBenchmarkSummaryLines(const DDMHeadlessBenchmarkReport& report);
+
+//What a console host's main calls: the arguments are the options above as Name=Value. Prints the summary to stdout and writes the JSON.
+//Returns 0 when every check passed, 1 when one failed and 2 for bad arguments
+int RunDDMHeadlessBenchmarkMain(int argc, char** argv);
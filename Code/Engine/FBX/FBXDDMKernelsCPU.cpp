@@ -0,0 +1,880 @@
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXSimdLanes.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+constexpr int PACKET_SIZE = DDMControlPointPackets::PACKET_SIZE;
+
+//Index into the 10 stored floats for entry (row, col) of the symmetric 4x4 omega block. Same layout as FBXDDMModifier::GetSymmetricMatrix4x4From10Floats
+static constexpr int SYMMETRIC_4X4_INDICES[4][4] = {
+	{ 0, 1, 2, 3 },
+	{ 1, 4, 5, 6 },
+	{ 2, 5, 7, 8 },
+	{ 3, 6, 8, 9 }
+};
+
+static bool IsAVX2Supported()
+{
+#if !defined(DDM_HAS_X86_SIMD)
+	return false;
+#elif defined(_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] < 7) {
+		return false;
+	}
+	__cpuid(cpuInfo, 1);
+	bool hasFMA = (cpuInfo[2] & (1 << 12)) != 0;
+	bool hasOSXSAVE = (cpuInfo[2] & (1 << 27)) != 0;
+	__cpuidex(cpuInfo, 7, 0);
+	bool hasAVX2 = (cpuInfo[1] & (1 << 5)) != 0;
+	if (!hasFMA || !hasOSXSAVE || !hasAVX2) {
+		return false;
+	}
+	return (_xgetbv(0) & 0x6) == 0x6;	//The OS has to save the ymm registers on context switches
+#else
+	return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+DDMSimdLevel GetHighestSupportedDDMSimdLevel()
+{
+	static const DDMSimdLevel s_highestSupportedLevel = []() {
+#if defined(DDM_HAS_X86_SIMD)
+		return IsAVX2Supported() ? DDMSimdLevel::AVX2 : DDMSimdLevel::SSE;	//Every x86 target this engine builds for has SSE2
+#else
+		return DDMSimdLevel::SCALAR;
+#endif
+	}();
+	return s_highestSupportedLevel;
+}
+
+const char* GetDDMSimdLevelName(DDMSimdLevel simdLevel)
+{
+	switch (simdLevel) {
+	case DDMSimdLevel::SCALAR:	return "Scalar";
+	case DDMSimdLevel::SSE:		return "SSE";
+	case DDMSimdLevel::AVX2:	return "AVX2";
+	default:					return "Unknown";
+	}
+}
+
+void DDMControlPointPackets::Build(const DDMSparseOmegas& omegas, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixXd* v1ConstantMatrix)
+{
+	GUARANTEE_OR_DIE(omegas.GetNumControlPoints() == (int)restPositions.rows(), "omegas and restPositions need the same number of control points");
+	if (v1ConstantMatrix) {
+		GUARANTEE_OR_DIE(v1ConstantMatrix->rows() == restPositions.rows() && v1ConstantMatrix->cols() == 6, "v1ConstantMatrix has to be numControlPoints x 6");
+	}
+
+	m_numControlPoints = omegas.GetNumControlPoints();
+	int numPackets = (m_numControlPoints + PACKET_SIZE - 1) / PACKET_SIZE;
+
+	//Union of the joints of every lane, ascending
+	m_firstPacketJointIndices.resize((size_t)numPackets + 1);
+	m_firstPacketJointIndices[0] = 0;
+	m_jointIndices.clear();
+	for (int packetIdx = 0; packetIdx < numPackets; packetIdx++) {
+		int firstCtrlPointIdx = packetIdx * PACKET_SIZE;
+		int endCtrlPointIdx = std::min(firstCtrlPointIdx + PACKET_SIZE, m_numControlPoints);
+		size_t firstJointIdx = m_jointIndices.size();
+		for (int influenceIdx = omegas.GetFirstInfluenceIdx(firstCtrlPointIdx); influenceIdx < omegas.GetFirstInfluenceIdx(endCtrlPointIdx); influenceIdx++) {
+			m_jointIndices.push_back(omegas.GetJointIdx(influenceIdx));
+		}
+		std::sort(m_jointIndices.begin() + firstJointIdx, m_jointIndices.end());
+		m_jointIndices.erase(std::unique(m_jointIndices.begin() + firstJointIdx, m_jointIndices.end()), m_jointIndices.end());
+		m_firstPacketJointIndices[(size_t)packetIdx + 1] = (int)m_jointIndices.size();
+	}
+
+	m_omegas.assign(m_jointIndices.size() * 10 * PACKET_SIZE, 0.0f);
+	m_restPositions.assign((size_t)numPackets * 3 * PACKET_SIZE, 0.0f);
+	m_packetCenters.assign((size_t)numPackets * 3, 0.0f);
+	m_v1Constants.assign(v1ConstantMatrix ? (size_t)numPackets * 6 * PACKET_SIZE : 0, 0.0f);
+	for (int packetIdx = 0; packetIdx < numPackets; packetIdx++) {
+		int firstCtrlPointIdx = packetIdx * PACKET_SIZE;
+		int endCtrlPointIdx = std::min(firstCtrlPointIdx + PACKET_SIZE, m_numControlPoints);
+		Eigen::Matrix<double, 1, 3> center = restPositions.middleRows(firstCtrlPointIdx, endCtrlPointIdx - firstCtrlPointIdx).colwise().mean();
+		float* packetCenter = m_packetCenters.data() + (size_t)packetIdx * 3;
+		for (int i = 0; i < 3; i++) {
+			packetCenter[i] = (float)center(i);
+		}
+	}
+
+	for (int ctrlPointIdx = 0; ctrlPointIdx < m_numControlPoints; ctrlPointIdx++) {
+		int packetIdx = ctrlPointIdx / PACKET_SIZE;
+		int laneIdx = ctrlPointIdx % PACKET_SIZE;
+		const int* packetJointIndices = GetPacketJointIndices(packetIdx);
+		int numPacketJoints = GetNumJointsOfPacket(packetIdx);
+		//The float center, so that the kernel's M_j * T(c) matches this exactly
+		const float* packetCenter = GetPacketCenter(packetIdx);
+		double c[3] = { packetCenter[0], packetCenter[1], packetCenter[2] };
+		int packetJointIdx = 0;
+		int endInfluenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx) + omegas.GetNumInfluencesOfControlPoint(ctrlPointIdx);
+		for (int influenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx); influenceIdx < endInfluenceIdx; influenceIdx++) {
+			//Both lists are ascending, so the slot of the next influence is always further along
+			while (packetJointIndices[packetJointIdx] != omegas.GetJointIdx(influenceIdx)) {
+				packetJointIdx++;
+			}
+			GUARANTEE_OR_DIE(packetJointIdx < numPacketJoints, "Influence missing from its packet");
+			float* jointOmegas = m_omegas.data() + ((size_t)m_firstPacketJointIndices[packetIdx] + packetJointIdx) * 10 * PACKET_SIZE;
+			const float* omega = omegas.GetOmega(influenceIdx);
+
+			//T(-c) * Omega * T(-c)^T. With Omega = [A b; b^T w] that is [A - b c^T - c b^T + w c c^T, b - w c; ..., w]
+			double b[3] = { omega[3], omega[6], omega[8] };
+			double w = omega[9];
+			double centeredOmega[10];
+			for (int row = 0; row < 3; row++) {
+				for (int col = row; col < 3; col++) {
+					centeredOmega[SYMMETRIC_4X4_INDICES[row][col]] = (double)omega[SYMMETRIC_4X4_INDICES[row][col]] - b[row] * c[col] - c[row] * b[col] + w * c[row] * c[col];
+				}
+				centeredOmega[SYMMETRIC_4X4_INDICES[row][3]] = b[row] - w * c[row];
+			}
+			centeredOmega[9] = w;
+			for (int i = 0; i < 10; i++) {
+				jointOmegas[i * PACKET_SIZE + laneIdx] = (float)centeredOmega[i];
+			}
+		}
+
+		float* packetRestPositions = m_restPositions.data() + (size_t)packetIdx * 3 * PACKET_SIZE;
+		for (int i = 0; i < 3; i++) {
+			packetRestPositions[i * PACKET_SIZE + laneIdx] = (float)(restPositions(ctrlPointIdx, i) - c[i]);
+		}
+
+		if (v1ConstantMatrix) {
+			float* packetV1Constants = m_v1Constants.data() + (size_t)packetIdx * 6 * PACKET_SIZE;
+			for (int i = 0; i < 6; i++) {
+				packetV1Constants[i * PACKET_SIZE + laneIdx] = (float)(*v1ConstantMatrix)(ctrlPointIdx, i);
+			}
+		}
+	}
+}
+
+const float* DDMControlPointPackets::GetPacketOmegas(int packetIdx) const
+{
+	return m_omegas.data() + (size_t)m_firstPacketJointIndices[packetIdx] * 10 * PACKET_SIZE;
+}
+
+const float* DDMControlPointPackets::GetPacketRestPositions(int packetIdx) const
+{
+	return m_restPositions.data() + (size_t)packetIdx * 3 * PACKET_SIZE;
+}
+
+const float* DDMControlPointPackets::GetPacketV1Constants(int packetIdx) const
+{
+	if (m_v1Constants.empty()) {
+		return nullptr;
+	}
+	return m_v1Constants.data() + (size_t)packetIdx * 6 * PACKET_SIZE;
+}
+
+size_t DDMControlPointPackets::GetNumBytes() const
+{
+	return (m_omegas.size() + m_restPositions.size() + m_packetCenters.size() + m_v1Constants.size()) * sizeof(float) + (m_firstPacketJointIndices.size() + m_jointIndices.size()) * sizeof(int);
+}
+
+void ConvertJointTransformsToFloats(const std::vector<Mat44>& allJointTransforms, std::vector<float>& outJointTransforms)
+{
+	outJointTransforms.resize(allJointTransforms.size() * 16);
+	for (size_t jointIdx = 0; jointIdx < allJointTransforms.size(); jointIdx++) {
+		const float* values = allJointTransforms[jointIdx].m_values;
+		float* jointTransform = outJointTransforms.data() + jointIdx * 16;
+		jointTransform[0] = values[Mat44::Ix];	jointTransform[1] = values[Mat44::Jx];	jointTransform[2] = values[Mat44::Kx];	jointTransform[3] = values[Mat44::Tx];
+		jointTransform[4] = values[Mat44::Iy];	jointTransform[5] = values[Mat44::Jy];	jointTransform[6] = values[Mat44::Ky];	jointTransform[7] = values[Mat44::Ty];
+		jointTransform[8] = values[Mat44::Iz];	jointTransform[9] = values[Mat44::Jz];	jointTransform[10] = values[Mat44::Kz];	jointTransform[11] = values[Mat44::Tz];
+		jointTransform[12] = values[Mat44::Iw];	jointTransform[13] = values[Mat44::Jw];	jointTransform[14] = values[Mat44::Kw];	jointTransform[15] = values[Mat44::Tw];
+	}
+}
+
+//Q_i = sum over the packet's joints of M_j * Omega_ij for every lane of a packet. packetJointTransforms are the M_j of the packet's joints in order, outQ is [16][lane], row major over the 4x4 entries
+static void AccumulatePacketQScalar(const float* packetOmegas, const float* packetJointTransforms, int numPacketJoints, float* outQ)
+{
+	for (int i = 0; i < 16 * PACKET_SIZE; i++) {
+		outQ[i] = 0.0f;
+	}
+	for (int packetJointIdx = 0; packetJointIdx < numPacketJoints; packetJointIdx++) {
+		const float* M = packetJointTransforms + 16 * packetJointIdx;
+		const float* omegas = packetOmegas + packetJointIdx * 10 * PACKET_SIZE;
+		for (int row = 0; row < 4; row++) {
+			for (int col = 0; col < 4; col++) {
+				float* Q = outQ + (row * 4 + col) * PACKET_SIZE;
+				for (int laneIdx = 0; laneIdx < PACKET_SIZE; laneIdx++) {
+					Q[laneIdx] += M[row * 4 + 0] * omegas[SYMMETRIC_4X4_INDICES[0][col] * PACKET_SIZE + laneIdx]
+						+ M[row * 4 + 1] * omegas[SYMMETRIC_4X4_INDICES[1][col] * PACKET_SIZE + laneIdx]
+						+ M[row * 4 + 2] * omegas[SYMMETRIC_4X4_INDICES[2][col] * PACKET_SIZE + laneIdx]
+						+ M[row * 4 + 3] * omegas[SYMMETRIC_4X4_INDICES[3][col] * PACKET_SIZE + laneIdx];
+				}
+			}
+		}
+	}
+}
+
+#if defined(DDM_HAS_X86_SIMD)
+//Row by row, so only 4 accumulators are live at a time instead of 16 (which would not fit in the 16 vector registers next to the omega loads)
+static void AccumulatePacketQSSE(const float* packetOmegas, const float* packetJointTransforms, int numPacketJoints, float* outQ)
+{
+	for (int halfIdx = 0; halfIdx < PACKET_SIZE / 4; halfIdx++) {
+		int laneOffset = halfIdx * 4;
+		for (int row = 0; row < 4; row++) {
+			__m128 Q0 = _mm_setzero_ps();
+			__m128 Q1 = _mm_setzero_ps();
+			__m128 Q2 = _mm_setzero_ps();
+			__m128 Q3 = _mm_setzero_ps();
+			for (int packetJointIdx = 0; packetJointIdx < numPacketJoints; packetJointIdx++) {
+				const float* M = packetJointTransforms + 16 * packetJointIdx + row * 4;
+				const float* omegas = packetOmegas + packetJointIdx * 10 * PACKET_SIZE + laneOffset;
+				__m128 M0 = _mm_set1_ps(M[0]);
+				__m128 M1 = _mm_set1_ps(M[1]);
+				__m128 M2 = _mm_set1_ps(M[2]);
+				__m128 M3 = _mm_set1_ps(M[3]);
+				__m128 omega0 = _mm_loadu_ps(omegas + 0 * PACKET_SIZE);
+				__m128 omega1 = _mm_loadu_ps(omegas + 1 * PACKET_SIZE);
+				__m128 omega2 = _mm_loadu_ps(omegas + 2 * PACKET_SIZE);
+				__m128 omega3 = _mm_loadu_ps(omegas + 3 * PACKET_SIZE);
+				__m128 omega4 = _mm_loadu_ps(omegas + 4 * PACKET_SIZE);
+				__m128 omega5 = _mm_loadu_ps(omegas + 5 * PACKET_SIZE);
+				__m128 omega6 = _mm_loadu_ps(omegas + 6 * PACKET_SIZE);
+				__m128 omega7 = _mm_loadu_ps(omegas + 7 * PACKET_SIZE);
+				__m128 omega8 = _mm_loadu_ps(omegas + 8 * PACKET_SIZE);
+				__m128 omega9 = _mm_loadu_ps(omegas + 9 * PACKET_SIZE);
+				//Columns of the symmetric block: (0,1,2,3), (1,4,5,6), (2,5,7,8), (3,6,8,9)
+				Q0 = _mm_add_ps(Q0, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M0, omega0), _mm_mul_ps(M1, omega1)), _mm_add_ps(_mm_mul_ps(M2, omega2), _mm_mul_ps(M3, omega3))));
+				Q1 = _mm_add_ps(Q1, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M0, omega1), _mm_mul_ps(M1, omega4)), _mm_add_ps(_mm_mul_ps(M2, omega5), _mm_mul_ps(M3, omega6))));
+				Q2 = _mm_add_ps(Q2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M0, omega2), _mm_mul_ps(M1, omega5)), _mm_add_ps(_mm_mul_ps(M2, omega7), _mm_mul_ps(M3, omega8))));
+				Q3 = _mm_add_ps(Q3, _mm_add_ps(_mm_add_ps(_mm_mul_ps(M0, omega3), _mm_mul_ps(M1, omega6)), _mm_add_ps(_mm_mul_ps(M2, omega8), _mm_mul_ps(M3, omega9))));
+			}
+			_mm_storeu_ps(outQ + (row * 4 + 0) * PACKET_SIZE + laneOffset, Q0);
+			_mm_storeu_ps(outQ + (row * 4 + 1) * PACKET_SIZE + laneOffset, Q1);
+			_mm_storeu_ps(outQ + (row * 4 + 2) * PACKET_SIZE + laneOffset, Q2);
+			_mm_storeu_ps(outQ + (row * 4 + 3) * PACKET_SIZE + laneOffset, Q3);
+		}
+	}
+}
+
+DDM_TARGET_AVX2 static void AccumulatePacketQAVX2(const float* packetOmegas, const float* packetJointTransforms, int numPacketJoints, float* outQ)
+{
+	static_assert(PACKET_SIZE == 8, "The AVX2 kernel handles exactly one packet per register");
+	for (int row = 0; row < 4; row++) {
+		__m256 Q0 = _mm256_setzero_ps();
+		__m256 Q1 = _mm256_setzero_ps();
+		__m256 Q2 = _mm256_setzero_ps();
+		__m256 Q3 = _mm256_setzero_ps();
+		for (int packetJointIdx = 0; packetJointIdx < numPacketJoints; packetJointIdx++) {
+			const float* M = packetJointTransforms + 16 * packetJointIdx + row * 4;
+			const float* omegas = packetOmegas + packetJointIdx * 10 * PACKET_SIZE;
+			__m256 M0 = _mm256_broadcast_ss(M + 0);
+			__m256 M1 = _mm256_broadcast_ss(M + 1);
+			__m256 M2 = _mm256_broadcast_ss(M + 2);
+			__m256 M3 = _mm256_broadcast_ss(M + 3);
+			__m256 omega0 = _mm256_loadu_ps(omegas + 0 * PACKET_SIZE);
+			__m256 omega1 = _mm256_loadu_ps(omegas + 1 * PACKET_SIZE);
+			__m256 omega2 = _mm256_loadu_ps(omegas + 2 * PACKET_SIZE);
+			__m256 omega3 = _mm256_loadu_ps(omegas + 3 * PACKET_SIZE);
+			__m256 omega4 = _mm256_loadu_ps(omegas + 4 * PACKET_SIZE);
+			__m256 omega5 = _mm256_loadu_ps(omegas + 5 * PACKET_SIZE);
+			__m256 omega6 = _mm256_loadu_ps(omegas + 6 * PACKET_SIZE);
+			__m256 omega7 = _mm256_loadu_ps(omegas + 7 * PACKET_SIZE);
+			__m256 omega8 = _mm256_loadu_ps(omegas + 8 * PACKET_SIZE);
+			__m256 omega9 = _mm256_loadu_ps(omegas + 9 * PACKET_SIZE);
+			Q0 = _mm256_fmadd_ps(M3, omega3, _mm256_fmadd_ps(M2, omega2, _mm256_fmadd_ps(M1, omega1, _mm256_fmadd_ps(M0, omega0, Q0))));
+			Q1 = _mm256_fmadd_ps(M3, omega6, _mm256_fmadd_ps(M2, omega5, _mm256_fmadd_ps(M1, omega4, _mm256_fmadd_ps(M0, omega1, Q1))));
+			Q2 = _mm256_fmadd_ps(M3, omega8, _mm256_fmadd_ps(M2, omega7, _mm256_fmadd_ps(M1, omega5, _mm256_fmadd_ps(M0, omega2, Q2))));
+			Q3 = _mm256_fmadd_ps(M3, omega9, _mm256_fmadd_ps(M2, omega8, _mm256_fmadd_ps(M1, omega6, _mm256_fmadd_ps(M0, omega3, Q3))));
+		}
+		_mm256_storeu_ps(outQ + (row * 4 + 0) * PACKET_SIZE, Q0);
+		_mm256_storeu_ps(outQ + (row * 4 + 1) * PACKET_SIZE, Q1);
+		_mm256_storeu_ps(outQ + (row * 4 + 2) * PACKET_SIZE, Q2);
+		_mm256_storeu_ps(outQ + (row * 4 + 3) * PACKET_SIZE, Q3);
+	}
+}
+#endif
+
+//Port of the SVD in CudaFiles/FastSVD3.cuh (McAdams et al. 2011, "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching and elementary
+//floating point operations"). Every branch of the original is a select here, so all lanes take the same path. 3x3 matrices are 9 lane values, row major
+constexpr float SVD_FOUR_GAMMA_SQUARED = 5.828427124f;	//sqrt(8) + 3
+constexpr float SVD_COS_PI_OVER_8 = 0.923879532f;
+constexpr float SVD_SIN_PI_OVER_8 = 0.3826834323f;
+constexpr float SVD_QR_EPSILON = 1e-6f;
+constexpr int SVD_NUM_JACOBI_SWEEPS = 5;	//The original does 4. The fifth takes the worst case error on random matrices from about 4e-2 to 2e-5 for a few percent of the kernel time
+
+template <typename Mask, typename F>
+static inline void CondSwap(Mask condition, F& x, F& y)
+{
+	F z = x;
+	x = LaneSelect(condition, y, x);
+	y = LaneSelect(condition, z, y);
+}
+
+template <typename Mask, typename F>
+static inline void CondNegSwap(Mask condition, F& x, F& y)
+{
+	F z = -x;
+	x = LaneSelect(condition, y, x);
+	y = LaneSelect(condition, z, y);
+}
+
+//Givens quaternion (ch, sh) that approximately zeroes a12 of the symmetric 2x2 block. Falls back to a rotation by pi/8 where the approximation is poor
+template <typename F>
+static inline void ComputeApproximateGivensQuaternion(F a11, F a12, F a22, F& ch, F& sh)
+{
+	ch = 2.0f * (a11 - a22);
+	sh = a12;
+	F chSquared = ch * ch;
+	F normSquared = chSquared + sh * sh;
+	//The original only checks the angle. Tiny (denormal) ch and sh would make the rsqrt blow up, so they take the fallback too
+	auto useGivensAngle = (SVD_FOUR_GAMMA_SQUARED * (sh * sh) < chSquared) & (F(FLT_MIN) < normSquared);
+	F w = LaneRsqrt(LaneMax(normSquared, F(FLT_MIN)));
+	ch = LaneSelect(useGivensAngle, w * ch, F(SVD_COS_PI_OVER_8));
+	sh = LaneSelect(useGivensAngle, w * sh, F(SVD_SIN_PI_OVER_8));
+}
+
+//One Jacobi rotation on the pair (p, q) = (X, Y) of the symmetric matrix S, accumulated into the quaternion qV (x, y, z, w), then S is cycled so the next pair comes first
+template <int X, int Y, int Z, typename F>
+static inline void JacobiConjugation(F& s11, F& s21, F& s22, F& s31, F& s32, F& s33, F qV[4])
+{
+	F ch;
+	F sh;
+	ComputeApproximateGivensQuaternion(s11, s21, s22, ch, sh);
+	F chSquared = ch * ch;
+	F shSquared = sh * sh;
+	F inverseScale = 1.0f / (chSquared + shSquared);
+	F a = (chSquared - shSquared) * inverseScale;
+	F b = 2.0f * (sh * ch) * inverseScale;
+
+	//S = Q^T * S * Q
+	F t11 = s11;
+	F t21 = s21;
+	F t22 = s22;
+	F t31 = s31;
+	F t32 = s32;
+	s11 = a * (a * t11 + b * t21) + b * (a * t21 + b * t22);
+	s21 = a * (a * t21 - b * t11) + b * (a * t22 - b * t21);
+	s22 = a * (a * t22 - b * t21) - b * (a * t21 - b * t11);
+	s31 = a * t31 + b * t32;
+	s32 = a * t32 - b * t31;
+
+	F tmp[3] = { qV[0] * sh, qV[1] * sh, qV[2] * sh };
+	sh = sh * qV[3];
+	qV[0] = qV[0] * ch;
+	qV[1] = qV[1] * ch;
+	qV[2] = qV[2] * ch;
+	qV[3] = qV[3] * ch;
+	qV[Z] = qV[Z] + sh;
+	qV[3] = qV[3] - tmp[Z];
+	qV[X] = qV[X] + tmp[Y];
+	qV[Y] = qV[Y] - tmp[X];
+
+	F u11 = s22;
+	F u21 = s32;
+	F u22 = s33;
+	F u31 = s21;
+	F u32 = s31;
+	F u33 = s11;
+	s11 = u11;
+	s21 = u21;
+	s22 = u22;
+	s31 = u31;
+	s32 = u32;
+	s33 = u33;
+}
+
+template <typename F>
+static inline void QuaternionToMatrix(const F qV[4], F outM[9])
+{
+	F x = qV[0];
+	F y = qV[1];
+	F z = qV[2];
+	F w = qV[3];
+	outM[0] = 1.0f - 2.0f * (y * y + z * z);	outM[1] = 2.0f * (x * y - w * z);			outM[2] = 2.0f * (x * z + w * y);
+	outM[3] = 2.0f * (x * y + w * z);			outM[4] = 1.0f - 2.0f * (x * x + z * z);	outM[5] = 2.0f * (y * z - w * x);
+	outM[6] = 2.0f * (x * z - w * y);			outM[7] = 2.0f * (y * z + w * x);			outM[8] = 1.0f - 2.0f * (x * x + y * y);
+}
+
+//Orders the columns of B by decreasing length, V along with it. The negations keep both rotations
+template <typename F>
+static inline void SortSingularValues(F B[9], F V[9])
+{
+	F rho[3];
+	for (int col = 0; col < 3; col++) {
+		rho[col] = B[col] * B[col] + B[3 + col] * B[3 + col] + B[6 + col] * B[6 + col];
+	}
+	constexpr int COLUMN_PAIRS[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+	for (int pairIdx = 0; pairIdx < 3; pairIdx++) {
+		int colA = COLUMN_PAIRS[pairIdx][0];
+		int colB = COLUMN_PAIRS[pairIdx][1];
+		auto condition = rho[colA] < rho[colB];
+		for (int row = 0; row < 3; row++) {
+			CondNegSwap(condition, B[row * 3 + colA], B[row * 3 + colB]);
+			CondNegSwap(condition, V[row * 3 + colA], V[row * 3 + colB]);
+		}
+		CondSwap(condition, rho[colA], rho[colB]);
+	}
+}
+
+//Givens quaternion that zeroes a2 against the pivot a1
+template <typename F>
+static inline void ComputeQRGivensQuaternion(F a1, F a2, F& ch, F& sh)
+{
+	F rho = LaneSqrt(a1 * a1 + a2 * a2);
+	sh = LaneSelect(F(SVD_QR_EPSILON) < rho, a2, F(0.0f));
+	ch = LaneAbs(a1) + LaneMax(rho, F(SVD_QR_EPSILON));
+	CondSwap(a1 < F(0.0f), sh, ch);
+	F w = LaneRsqrt(ch * ch + sh * sh);
+	ch = ch * w;
+	sh = sh * w;
+}
+
+//Q of B = Q * R through three Givens rotations. Only Q is needed for the polar rotation
+template <typename F>
+static inline void QRDecompositionQ(const F B[9], F outQ[9])
+{
+	F ch1;
+	F sh1;
+	ComputeQRGivensQuaternion(B[0], B[3], ch1, sh1);
+	F a = 1.0f - 2.0f * (sh1 * sh1);
+	F b = 2.0f * (ch1 * sh1);
+	F R1[9] = {
+		a * B[0] + b * B[3], a * B[1] + b * B[4], a * B[2] + b * B[5],
+		a * B[3] - b * B[0], a * B[4] - b * B[1], a * B[5] - b * B[2],
+		B[6], B[7], B[8]
+	};
+
+	F ch2;
+	F sh2;
+	ComputeQRGivensQuaternion(R1[0], R1[6], ch2, sh2);
+	a = 1.0f - 2.0f * (sh2 * sh2);
+	b = 2.0f * (ch2 * sh2);
+	F R2[9] = {
+		a * R1[0] + b * R1[6], a * R1[1] + b * R1[7], a * R1[2] + b * R1[8],
+		R1[3], R1[4], R1[5],
+		a * R1[6] - b * R1[0], a * R1[7] - b * R1[1], a * R1[8] - b * R1[2]
+	};
+
+	F ch3;
+	F sh3;
+	ComputeQRGivensQuaternion(R2[4], R2[7], ch3, sh3);
+
+	//Q = Q1 * Q2 * Q3, written out
+	F sh1Squared = sh1 * sh1;
+	F sh2Squared = sh2 * sh2;
+	F sh3Squared = sh3 * sh3;
+	F c1 = 2.0f * sh1Squared - 1.0f;
+	F c2 = 2.0f * sh2Squared - 1.0f;
+	F c3 = 2.0f * sh3Squared - 1.0f;
+	outQ[0] = c1 * c2;
+	outQ[1] = 4.0f * (ch2 * ch3) * c1 * (sh2 * sh3) + 2.0f * (ch1 * sh1) * c3;
+	outQ[2] = 4.0f * (ch1 * ch3) * (sh1 * sh3) - 2.0f * ch2 * c1 * sh2 * c3;
+	outQ[3] = -2.0f * (ch1 * sh1) * c2;
+	outQ[4] = -8.0f * (ch1 * ch2 * ch3) * (sh1 * sh2 * sh3) + c1 * c3;
+	outQ[5] = -2.0f * (ch3 * sh3) + 4.0f * sh1 * (ch3 * sh1 * sh3 + ch1 * ch2 * sh2 * c3);
+	outQ[6] = 2.0f * (ch2 * sh2);
+	outQ[7] = -2.0f * ch3 * c2 * sh3;
+	outQ[8] = c2 * c3;
+}
+
+//R = U * V^T of A = U * S * V^T
+template <typename F>
+static inline void ComputePolarRotation(const F A[9], F outR[9])
+{
+	//Scaling A by a positive number doesn't change R. Bringing the largest entry to 1 keeps A^T * A clear of overflow and denormals whatever units the mesh uses
+	F maxAbs = LaneAbs(A[0]);
+	for (int i = 1; i < 9; i++) {
+		maxAbs = LaneMax(maxAbs, LaneAbs(A[i]));
+	}
+	auto isNonZero = F(FLT_MIN) < maxAbs;
+	F scale = 1.0f / LaneMax(maxAbs, F(FLT_MIN));
+	F a[9];
+	for (int i = 0; i < 9; i++) {
+		a[i] = A[i] * scale;
+	}
+
+	//Eigenvectors of A^T * A are V
+	F s11 = a[0] * a[0] + a[3] * a[3] + a[6] * a[6];
+	F s21 = a[1] * a[0] + a[4] * a[3] + a[7] * a[6];
+	F s22 = a[1] * a[1] + a[4] * a[4] + a[7] * a[7];
+	F s31 = a[2] * a[0] + a[5] * a[3] + a[8] * a[6];
+	F s32 = a[2] * a[1] + a[5] * a[4] + a[8] * a[7];
+	F s33 = a[2] * a[2] + a[5] * a[5] + a[8] * a[8];
+	F qV[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	for (int sweepIdx = 0; sweepIdx < SVD_NUM_JACOBI_SWEEPS; sweepIdx++) {
+		JacobiConjugation<0, 1, 2>(s11, s21, s22, s31, s32, s33, qV);
+		JacobiConjugation<1, 2, 0>(s11, s21, s22, s31, s32, s33, qV);
+		JacobiConjugation<2, 0, 1>(s11, s21, s22, s31, s32, s33, qV);
+	}
+	//Every Givens quaternion is only normalized as well as the rsqrt estimate goes, and those errors add up over the sweeps
+	F inverseNorm = LaneRsqrt(qV[0] * qV[0] + qV[1] * qV[1] + qV[2] * qV[2] + qV[3] * qV[3]);
+	for (int i = 0; i < 4; i++) {
+		qV[i] = qV[i] * inverseNorm;
+	}
+	F V[9];
+	QuaternionToMatrix(qV, V);
+
+	//B = A * V = U * S, and its QR decomposition gives U even when A is rank deficient
+	F B[9];
+	for (int row = 0; row < 3; row++) {
+		for (int col = 0; col < 3; col++) {
+			B[row * 3 + col] = a[row * 3 + 0] * V[0 * 3 + col] + a[row * 3 + 1] * V[1 * 3 + col] + a[row * 3 + 2] * V[2 * 3 + col];
+		}
+	}
+	SortSingularValues(B, V);
+	F U[9];
+	QRDecompositionQ(B, U);
+
+	//A zero matrix has no rotation to speak of, it keeps the identity
+	for (int row = 0; row < 3; row++) {
+		for (int col = 0; col < 3; col++) {
+			F R = U[row * 3 + 0] * V[col * 3 + 0] + U[row * 3 + 1] * V[col * 3 + 1] + U[row * 3 + 2] * V[col * 3 + 2];
+			outR[row * 3 + col] = LaneSelect(isNonZero, R, F(row == col ? 1.0f : 0.0f));
+		}
+	}
+}
+
+template <typename F>
+static inline void ComputePacketPolarRotationsLanes(const float* packetA, float* outPacketR)
+{
+	constexpr int NUM_LANES = (int)(sizeof(F) / sizeof(float));
+	for (int laneOffset = 0; laneOffset < PACKET_SIZE; laneOffset += NUM_LANES) {
+		F A[9];
+		for (int i = 0; i < 9; i++) {
+			LoadLanes(packetA + i * PACKET_SIZE + laneOffset, A[i]);
+		}
+		F R[9];
+		ComputePolarRotation(A, R);
+		for (int i = 0; i < 9; i++) {
+			StoreLanes(outPacketR + i * PACKET_SIZE + laneOffset, R[i]);
+		}
+	}
+}
+
+//From the packet's accumulated Q_i to its deformed positions ([3][lane]): normalize Q_i, R_i is the polar rotation of Q_i - q_i * p_i^T (variant 0)
+//or of its cofactor matrix times the v1 constants (variant 1), t_i = q_i - R_i * p_i, then the rest position is transformed
+template <typename F>
+static inline void ComputePacketDeformedPositionsLanes(const float* packetQ, const float* packetRestPositions, const float* packetV1Constants, float* outPacketPositions)
+{
+	constexpr int NUM_LANES = (int)(sizeof(F) / sizeof(float));
+	for (int laneOffset = 0; laneOffset < PACKET_SIZE; laneOffset += NUM_LANES) {
+		F Q[16];
+		for (int i = 0; i < 16; i++) {
+			LoadLanes(packetQ + i * PACKET_SIZE + laneOffset, Q[i]);
+		}
+		F normalizer = 1.0f / Q[15];
+		F q[3] = { Q[3] * normalizer, Q[7] * normalizer, Q[11] * normalizer };
+		F p[3] = { Q[12] * normalizer, Q[13] * normalizer, Q[14] * normalizer };
+		F A[9];
+		for (int row = 0; row < 3; row++) {
+			for (int col = 0; col < 3; col++) {
+				A[row * 3 + col] = Q[row * 4 + col] * normalizer - q[row] * p[col];
+			}
+		}
+
+		if (packetV1Constants) {
+			//det(A) * A^-T is the cofactor matrix, whose rows are cross products of the rows of A
+			F C[9];
+			for (int row = 0; row < 3; row++) {
+				const F* rowA = A + ((row + 1) % 3) * 3;
+				const F* rowB = A + ((row + 2) % 3) * 3;
+				C[row * 3 + 0] = rowA[1] * rowB[2] - rowA[2] * rowB[1];
+				C[row * 3 + 1] = rowA[2] * rowB[0] - rowA[0] * rowB[2];
+				C[row * 3 + 2] = rowA[0] * rowB[1] - rowA[1] * rowB[0];
+			}
+			F constants[6];
+			for (int i = 0; i < 6; i++) {
+				LoadLanes(packetV1Constants + i * PACKET_SIZE + laneOffset, constants[i]);
+			}
+			F M[9] = {
+				constants[0], constants[1], constants[2],
+				constants[1], constants[3], constants[4],
+				constants[2], constants[4], constants[5]
+			};
+			for (int row = 0; row < 3; row++) {
+				for (int col = 0; col < 3; col++) {
+					A[row * 3 + col] = C[row * 3 + 0] * M[0 * 3 + col] + C[row * 3 + 1] * M[1 * 3 + col] + C[row * 3 + 2] * M[2 * 3 + col];
+				}
+			}
+		}
+
+		F R[9];
+		ComputePolarRotation(A, R);
+
+		F restPosition[3];
+		for (int i = 0; i < 3; i++) {
+			LoadLanes(packetRestPositions + i * PACKET_SIZE + laneOffset, restPosition[i]);
+		}
+		//p_i and the rest positions are both relative to the packet center, which cancels out of R_i * (u - p_i) + q_i
+		for (int row = 0; row < 3; row++) {
+			F t = q[row] - (R[row * 3 + 0] * p[0] + R[row * 3 + 1] * p[1] + R[row * 3 + 2] * p[2]);
+			F position = R[row * 3 + 0] * restPosition[0] + R[row * 3 + 1] * restPosition[1] + R[row * 3 + 2] * restPosition[2] + t;
+			StoreLanes(outPacketPositions + row * PACKET_SIZE + laneOffset, position);
+		}
+	}
+}
+
+#if defined(DDM_HAS_X86_SIMD)
+//The templates have no target attribute of their own, so gcc and clang only get AVX2 code out of them once they are flattened into these
+DDM_TARGET_AVX2 DDM_FLATTEN static void ComputePacketPolarRotationsAVX2(const float* packetA, float* outPacketR)
+{
+	ComputePacketPolarRotationsLanes<DDMFloat8>(packetA, outPacketR);
+}
+
+DDM_TARGET_AVX2 DDM_FLATTEN static void ComputePacketDeformedPositionsAVX2(const float* packetQ, const float* packetRestPositions, const float* packetV1Constants, float* outPacketPositions)
+{
+	ComputePacketDeformedPositionsLanes<DDMFloat8>(packetQ, packetRestPositions, packetV1Constants, outPacketPositions);
+}
+#endif
+
+//Denormals take a slow microcode path on x86, and the Jacobi sweeps push the converged off diagonal entries of A^T * A right into that range.
+//Flushing them to zero changes nothing the results depend on. The caller's mode is restored on the way out
+class ScopedDenormalsAreZero {
+public:
+	ScopedDenormalsAreZero()
+	{
+#if defined(DDM_HAS_X86_SIMD)
+		m_previousControlStatus = _mm_getcsr();
+		_mm_setcsr(m_previousControlStatus | FLUSH_TO_ZERO_AND_DENORMALS_ARE_ZERO_BITS);
+#endif
+	}
+	~ScopedDenormalsAreZero()
+	{
+#if defined(DDM_HAS_X86_SIMD)
+		_mm_setcsr(m_previousControlStatus);
+#endif
+	}
+	ScopedDenormalsAreZero(const ScopedDenormalsAreZero& copyFrom) = delete;
+	ScopedDenormalsAreZero& operator=(const ScopedDenormalsAreZero& copyFrom) = delete;
+
+private:
+#if defined(DDM_HAS_X86_SIMD)
+	static constexpr unsigned int FLUSH_TO_ZERO_AND_DENORMALS_ARE_ZERO_BITS = 0x8040;
+	unsigned int m_previousControlStatus = 0;
+#endif
+};
+
+static void ComputePacketPolarRotations(const float* packetA, float* outPacketR, DDMSimdLevel simdLevel)
+{
+	switch (simdLevel) {
+#if defined(DDM_HAS_X86_SIMD)
+	case DDMSimdLevel::AVX2:
+		ComputePacketPolarRotationsAVX2(packetA, outPacketR);
+		break;
+	case DDMSimdLevel::SSE:
+		ComputePacketPolarRotationsLanes<DDMFloat4>(packetA, outPacketR);
+		break;
+#endif
+	default:
+		ComputePacketPolarRotationsLanes<float>(packetA, outPacketR);
+		break;
+	}
+}
+
+static void ComputePacketDeformedPositions(const float* packetQ, const float* packetRestPositions, const float* packetV1Constants, float* outPacketPositions, DDMSimdLevel simdLevel)
+{
+	switch (simdLevel) {
+#if defined(DDM_HAS_X86_SIMD)
+	case DDMSimdLevel::AVX2:
+		ComputePacketDeformedPositionsAVX2(packetQ, packetRestPositions, packetV1Constants, outPacketPositions);
+		break;
+	case DDMSimdLevel::SSE:
+		ComputePacketDeformedPositionsLanes<DDMFloat4>(packetQ, packetRestPositions, packetV1Constants, outPacketPositions);
+		break;
+#endif
+	default:
+		ComputePacketDeformedPositionsLanes<float>(packetQ, packetRestPositions, packetV1Constants, outPacketPositions);
+		break;
+	}
+}
+
+//writePacket(firstCtrlPointIdx, numLanes, packetPositions) gets the positions of every packet as [3][lane]
+template<typename PacketWriter>
+static void ComputeDeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	const PacketWriter& writePacket, DDMSimdLevel simdLevel, bool isVariant1)
+{
+	if (simdLevel > GetHighestSupportedDDMSimdLevel()) {
+		ERROR_AND_DIE(Stringf("%s is not supported on this CPU", GetDDMSimdLevelName(simdLevel)));
+	}
+
+	ScopedDenormalsAreZero denormalsAreZero;
+	int numControlPoints = packets.GetNumControlPoints();
+	float packetQ[16 * PACKET_SIZE];
+	float packetPositions[3 * PACKET_SIZE];
+	std::vector<float> packetJointTransforms;
+	for (int packetIdx = beginPacketIdx; packetIdx < endPacketIdx; packetIdx++) {
+		const float* packetOmegas = packets.GetPacketOmegas(packetIdx);
+		const int* packetJointIndices = packets.GetPacketJointIndices(packetIdx);
+		int numPacketJoints = packets.GetNumJointsOfPacket(packetIdx);
+
+		//The omegas are centered on c, so they pair with M_j * T(c): the same matrix with its translation moved to M_j * (c, 1)
+		const float* center = packets.GetPacketCenter(packetIdx);
+		packetJointTransforms.resize((size_t)numPacketJoints * 16);
+		for (int packetJointIdx = 0; packetJointIdx < numPacketJoints; packetJointIdx++) {
+			const float* M = jointTransforms + 16 * packetJointIndices[packetJointIdx];
+			float* centeredM = packetJointTransforms.data() + (size_t)packetJointIdx * 16;
+			for (int row = 0; row < 4; row++) {
+				centeredM[row * 4 + 0] = M[row * 4 + 0];
+				centeredM[row * 4 + 1] = M[row * 4 + 1];
+				centeredM[row * 4 + 2] = M[row * 4 + 2];
+				centeredM[row * 4 + 3] = M[row * 4 + 0] * center[0] + M[row * 4 + 1] * center[1] + M[row * 4 + 2] * center[2] + M[row * 4 + 3];
+			}
+		}
+
+		switch (simdLevel) {
+#if defined(DDM_HAS_X86_SIMD)
+		case DDMSimdLevel::AVX2:
+			AccumulatePacketQAVX2(packetOmegas, packetJointTransforms.data(), numPacketJoints, packetQ);
+			break;
+		case DDMSimdLevel::SSE:
+			AccumulatePacketQSSE(packetOmegas, packetJointTransforms.data(), numPacketJoints, packetQ);
+			break;
+#endif
+		default:
+			AccumulatePacketQScalar(packetOmegas, packetJointTransforms.data(), numPacketJoints, packetQ);
+			break;
+		}
+
+		//The padding lanes of the last packet are all zero. Whatever they turn into is never written out
+		const float* packetV1Constants = isVariant1 ? packets.GetPacketV1Constants(packetIdx) : nullptr;
+		ComputePacketDeformedPositions(packetQ, packets.GetPacketRestPositions(packetIdx), packetV1Constants, packetPositions, simdLevel);
+
+		int firstCtrlPointIdx = packetIdx * PACKET_SIZE;
+		writePacket(firstCtrlPointIdx, std::min(PACKET_SIZE, numControlPoints - firstCtrlPointIdx), packetPositions);
+	}
+}
+
+static void ComputeStridedDeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	float* outPositions, int pointStride, int componentStride, DDMSimdLevel simdLevel, bool isVariant1)
+{
+	auto writePacket = [&](int firstCtrlPointIdx, int numLanes, const float* packetPositions) {
+		for (int laneIdx = 0; laneIdx < numLanes; laneIdx++) {
+			float* outPosition = outPositions + (size_t)(firstCtrlPointIdx + laneIdx) * pointStride;
+			outPosition[0] = packetPositions[0 * PACKET_SIZE + laneIdx];
+			outPosition[componentStride] = packetPositions[1 * PACKET_SIZE + laneIdx];
+			outPosition[2 * componentStride] = packetPositions[2 * PACKET_SIZE + laneIdx];
+		}
+	};
+	ComputeDeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, writePacket, simdLevel, isVariant1);
+}
+
+void ComputeDDMv0DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	float* outPositions, int pointStride, int componentStride, DDMSimdLevel simdLevel)
+{
+	ComputeStridedDeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, outPositions, pointStride, componentStride, simdLevel, false);
+}
+
+void ComputeDDMv1DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	float* outPositions, int pointStride, int componentStride, DDMSimdLevel simdLevel)
+{
+	GUARANTEE_OR_DIE(packets.HasV1Constants(), "The packets were built without the v1 constants");
+	ComputeStridedDeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, outPositions, pointStride, componentStride, simdLevel, true);
+}
+
+void ComputeDDMv0DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	const DDMPacketPositionsWriter& writePacket, DDMSimdLevel simdLevel)
+{
+	ComputeDeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, writePacket, simdLevel, false);
+}
+
+void ComputeDDMv1DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	const DDMPacketPositionsWriter& writePacket, DDMSimdLevel simdLevel)
+{
+	GUARANTEE_OR_DIE(packets.HasV1Constants(), "The packets were built without the v1 constants");
+	ComputeDeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, writePacket, simdLevel, true);
+}
+
+void ComputeDDMPolarRotations(const float* matrices, int numMatrices, float* outRotations, DDMSimdLevel simdLevel)
+{
+	if (simdLevel > GetHighestSupportedDDMSimdLevel()) {
+		ERROR_AND_DIE(Stringf("%s is not supported on this CPU", GetDDMSimdLevelName(simdLevel)));
+	}
+
+	ScopedDenormalsAreZero denormalsAreZero;
+	float packetA[9 * PACKET_SIZE];
+	float packetR[9 * PACKET_SIZE];
+	for (int firstMatrixIdx = 0; firstMatrixIdx < numMatrices; firstMatrixIdx += PACKET_SIZE) {
+		int numLanes = std::min(PACKET_SIZE, numMatrices - firstMatrixIdx);
+		std::fill(packetA, packetA + 9 * PACKET_SIZE, 0.0f);
+		for (int laneIdx = 0; laneIdx < numLanes; laneIdx++) {
+			for (int i = 0; i < 9; i++) {
+				packetA[i * PACKET_SIZE + laneIdx] = matrices[(size_t)(firstMatrixIdx + laneIdx) * 9 + i];
+			}
+		}
+		ComputePacketPolarRotations(packetA, packetR, simdLevel);
+		for (int laneIdx = 0; laneIdx < numLanes; laneIdx++) {
+			for (int i = 0; i < 9; i++) {
+				outRotations[(size_t)(firstMatrixIdx + laneIdx) * 9 + i] = packetR[i * PACKET_SIZE + laneIdx];
+			}
+		}
+	}
+}
+
+Eigen::Matrix<float, 1, 3> ComputeDDMv0DeformedControlPointReference(const DDMSparseOmegas& omegas, int ctrlPointIdx, const Eigen::Matrix<double, 1, 3>& restPosition,
+	const std::vector<Eigen::Matrix<double, 4, 4>>& allJointTransformsEigen)
+{
+	Eigen::Matrix<double, 4, 4> QMatrix_i;
+	QMatrix_i.setZero();
+	int endInfluenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx) + omegas.GetNumInfluencesOfControlPoint(ctrlPointIdx);
+	for (int influenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx); influenceIdx < endInfluenceIdx; influenceIdx++) {
+		Eigen::Matrix<double, 1, 10> omega = Eigen::Map<const Eigen::Matrix<float, 1, 10>>(omegas.GetOmega(influenceIdx)).cast<double>();
+		Eigen::Matrix4d symMat = FBXDDMModifier::GetSymmetricMatrix4x4From10Floats(omega);
+		Eigen::Matrix4d productMat = allJointTransformsEigen[omegas.GetJointIdx(influenceIdx)] * symMat;
+		QMatrix_i += productMat;
+	}
+
+	QMatrix_i /= QMatrix_i(QMatrix_i.rows() - 1, QMatrix_i.cols() - 1);	//Normalize it
+
+	Eigen::Matrix<double, 3, 3> Q_i = QMatrix_i.block(0, 0, 3, 3);
+	Eigen::Matrix<double, 3, 1> q_i = QMatrix_i.block(0, 3, 3, 1);
+	Eigen::Matrix<double, 3, 1> p_i = QMatrix_i.block(3, 0, 1, 3).transpose();
+	Eigen::Matrix<double, 3, 3> U_S_Vt = Q_i - q_i * p_i.transpose();
+
+	Eigen::Matrix<double, 3, 3> R_i = ComputeDDMPolarRotationReference(U_S_Vt);
+	Eigen::Matrix<double, 3, 1> t_i = q_i - R_i * p_i;
+
+	Eigen::Matrix<double, 4, 4> gamma_i;
+	gamma_i.block(0, 0, 3, 3) = R_i;
+	gamma_i.block(3, 0, 1, 3).setZero();
+	gamma_i.block(3, 3, 1, 1).setOnes();
+	gamma_i.block(0, 3, 3, 1) = t_i;
+
+	Eigen::Matrix<double, 4, 1> affineCurrentControlPoint;
+	affineCurrentControlPoint.block(0, 0, 3, 1) = restPosition.transpose();
+	affineCurrentControlPoint.block(3, 0, 1, 1).setOnes();
+
+	return (gamma_i * affineCurrentControlPoint).block(0, 0, 3, 1).transpose().cast<float>();
+}
+
+Eigen::Matrix<float, 1, 3> ComputeDDMv1DeformedControlPointReference(const DDMSparseOmegas& omegas, int ctrlPointIdx, const Eigen::Matrix<double, 1, 3>& restPosition,
+	const Eigen::Matrix<double, 1, 6>& v1Constants, const std::vector<Eigen::Matrix<double, 4, 4>>& allJointTransformsEigen)
+{
+	Eigen::Matrix<double, 4, 4> QMatrix_i;
+	QMatrix_i.setZero();
+	int endInfluenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx) + omegas.GetNumInfluencesOfControlPoint(ctrlPointIdx);
+	for (int influenceIdx = omegas.GetFirstInfluenceIdx(ctrlPointIdx); influenceIdx < endInfluenceIdx; influenceIdx++) {
+		Eigen::Matrix<double, 1, 10> omega = Eigen::Map<const Eigen::Matrix<float, 1, 10>>(omegas.GetOmega(influenceIdx)).cast<double>();
+		QMatrix_i += allJointTransformsEigen[omegas.GetJointIdx(influenceIdx)] * FBXDDMModifier::GetSymmetricMatrix4x4From10Floats(omega);
+	}
+	QMatrix_i /= QMatrix_i(3, 3);
+
+	Eigen::Matrix<double, 3, 1> q_i = QMatrix_i.block(0, 3, 3, 1);
+	Eigen::Matrix<double, 3, 1> p_i = QMatrix_i.block(3, 0, 1, 3).transpose();
+	Eigen::Matrix<double, 3, 3> Q_qp = QMatrix_i.block(0, 0, 3, 3) - q_i * p_i.transpose();
+	Eigen::Matrix<double, 3, 3> cofactorMatrix;
+	cofactorMatrix.row(0) = Q_qp.row(1).cross(Q_qp.row(2));
+	cofactorMatrix.row(1) = Q_qp.row(2).cross(Q_qp.row(0));
+	cofactorMatrix.row(2) = Q_qp.row(0).cross(Q_qp.row(1));
+	Eigen::Matrix<double, 3, 3> R_i = ComputeDDMPolarRotationReference(cofactorMatrix * FBXDDMModifier::GetSymmetricMatrix3x3From6Floats(v1Constants));
+	Eigen::Matrix<double, 3, 1> t_i = q_i - R_i * p_i;
+
+	return (R_i * restPosition.transpose() + t_i).transpose().cast<float>();
+}
+
+Eigen::Matrix<double, 3, 3> ComputeDDMPolarRotationReference(const Eigen::Matrix<double, 3, 3>& A)
+{
+	if (A.cwiseAbs().maxCoeff() == 0.0) {
+		return Eigen::Matrix<double, 3, 3>::Identity();
+	}
+	Eigen::JacobiSVD<Eigen::Matrix<double, 3, 3>> svdSolver(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	//Flipping the axis of the smallest singular value turns a reflection into the closest rotation
+	Eigen::Matrix<double, 3, 1> signs(1.0, 1.0, (svdSolver.matrixU() * svdSolver.matrixV().transpose()).determinant() < 0.0 ? -1.0 : 1.0);
+	return svdSolver.matrixU() * signs.asDiagonal() * svdSolver.matrixV().transpose();
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Fbx/FBXDDMSparseOmegas.hpp"
+#include <Eigen/Dense>
+#include <functional>
+#include <vector>
+
+//Vectorized CPU kernels for direct delta mush. They work on flat float buffers instead of Eigen matrices so one instruction handles a whole packet of control points
+
+enum class DDMSimdLevel {
+	SCALAR,
+	SSE,	//4 lanes
+	AVX2,	//8 lanes + FMA
+	COUNT
+};
+
+DDMSimdLevel GetHighestSupportedDDMSimdLevel();	//Checked once at runtime, so the same binary runs on machines without AVX2
+const char* GetDDMSimdLevelName(DDMSimdLevel simdLevel);
+
+//Omega blocks and rest positions regrouped into packets of PACKET_SIZE control points (array of structures of arrays).
+//Within a packet, the same omega entry of all lanes is contiguous, so a packet's whole working set sits in one block of memory.
+//A packet only stores the joints influencing at least one of its lanes; neighboring control points mostly share them, so the cost follows the influences and not the rig size
+class DDMControlPointPackets {
+public:
+	static constexpr int PACKET_SIZE = 8;
+
+	//Lanes a joint doesn't influence and the lanes past the last control point stay zero. The v1 constants are only needed by the variant 1 kernel.
+	//Omegas and rest positions are stored relative to the centroid of their packet. Q_i - q_i * p_i^T is a small difference of large terms far from the origin,
+	//which float loses most of otherwise (and variant 1 amplifies through the cofactor matrix)
+	void Build(const DDMSparseOmegas& omegas, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixXd* v1ConstantMatrix = nullptr);
+
+	int GetNumControlPoints() const { return m_numControlPoints; };
+	int GetNumPackets() const { return (int)m_firstPacketJointIndices.size() - 1; };
+	int GetNumJointsOfPacket(int packetIdx) const { return m_firstPacketJointIndices[packetIdx + 1] - m_firstPacketJointIndices[packetIdx]; };
+	const int* GetPacketJointIndices(int packetIdx) const { return m_jointIndices.data() + m_firstPacketJointIndices[packetIdx]; };
+	const float* GetPacketOmegas(int packetIdx) const;	//[packet joint][10][lane]
+	const float* GetPacketRestPositions(int packetIdx) const;	//[3][lane], relative to the packet center
+	const float* GetPacketCenter(int packetIdx) const { return m_packetCenters.data() + (size_t)packetIdx * 3; };
+	const float* GetPacketV1Constants(int packetIdx) const;	//[6][lane], nullptr when Build got no v1 constants
+	bool HasV1Constants() const { return !m_v1Constants.empty() || m_numControlPoints == 0; };
+	size_t GetNumBytes() const;
+
+private:
+	int m_numControlPoints = 0;
+	std::vector<int> m_firstPacketJointIndices = { 0 };	//numPackets + 1 entries
+	std::vector<int> m_jointIndices;
+	std::vector<float> m_omegas;
+	std::vector<float> m_restPositions;
+	std::vector<float> m_packetCenters;
+	std::vector<float> m_v1Constants;
+};
+
+//16 floats per joint, row major (the order Eigen's (row, col) uses), so the kernels can broadcast single entries
+void ConvertJointTransformsToFloats(const std::vector<Mat44>& allJointTransforms, std::vector<float>& outJointTransforms);
+
+//Deforms the control points of packets [beginPacketIdx, endPacketIdx). Component c of control point i goes to outPositions[i * pointStride + c * componentStride],
+//which covers interleaved xyz (3, 1) as well as a column major Eigen::MatrixX3f (1, numControlPoints)
+void ComputeDDMv0DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	float* outPositions, int pointStride, int componentStride, DDMSimdLevel simdLevel);
+
+//Variant 1 replaces the SVD of Q_i - q_i * p_i^T by det(Q_i - q_i * p_i^T) * (Q_i - q_i * p_i^T)^-T times the precomputed v1 constants. That product is the cofactor matrix,
+//which needs neither an inverse nor a determinant and stays finite when Q_i - q_i * p_i^T is singular. It is only a rotation for rigid motion, so R_i is its polar rotation.
+//Same output layout as ComputeDDMv0DeformedControlPoints. The packets have to be built with the v1 constants
+void ComputeDDMv1DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	float* outPositions, int pointStride, int componentStride, DDMSimdLevel simdLevel);
+
+//Gets the positions of one packet as [3][PACKET_SIZE] while they are still hot in cache, for callers that put them somewhere other than one entry per control point.
+//Only the first numLanes lanes are control points
+typedef std::function<void(int firstCtrlPointIdx, int numLanes, const float* packetPositions)> DDMPacketPositionsWriter;
+
+//Same kernels, handing every packet to writePacket instead of storing it
+void ComputeDDMv0DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	const DDMPacketPositionsWriter& writePacket, DDMSimdLevel simdLevel);
+void ComputeDDMv1DeformedControlPoints(const DDMControlPointPackets& packets, const float* jointTransforms, int beginPacketIdx, int endPacketIdx,
+	const DDMPacketPositionsWriter& writePacket, DDMSimdLevel simdLevel);
+
+//Rotation R of the polar decomposition A = R * S (closest rotation, det(R) = 1) for numMatrices row major 3x3 matrices, through the branch free SVD the deform kernels use.
+//A zero matrix gives the identity
+void ComputeDDMPolarRotations(const float* matrices, int numMatrices, float* outRotations, DDMSimdLevel simdLevel);
+
+//Double precision paths the kernels are checked against. Takes the same omegas and joint transforms FBXDDMModifier works with
+Eigen::Matrix<float, 1, 3> ComputeDDMv0DeformedControlPointReference(const DDMSparseOmegas& omegas, int ctrlPointIdx, const Eigen::Matrix<double, 1, 3>& restPosition,
+	const std::vector<Eigen::Matrix<double, 4, 4>>& allJointTransformsEigen);
+Eigen::Matrix<float, 1, 3> ComputeDDMv1DeformedControlPointReference(const DDMSparseOmegas& omegas, int ctrlPointIdx, const Eigen::Matrix<double, 1, 3>& restPosition,
+	const Eigen::Matrix<double, 1, 6>& v1Constants, const std::vector<Eigen::Matrix<double, 4, 4>>& allJointTransformsEigen);
+Eigen::Matrix<double, 3, 3> ComputeDDMPolarRotationReference(const Eigen::Matrix<double, 3, 3>& A);	//Through Eigen's JacobiSVD
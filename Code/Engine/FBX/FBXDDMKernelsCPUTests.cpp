@@ -0,0 +1,126 @@
+#include "Engine/Fbx/FBXDDMKernelsCPUTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+static Eigen::Matrix<double, 3, 3> GetRandomRotationMatrix(RandomNumberGenerator& rng)
+{
+	Eigen::Quaterniond rotation(rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f),
+		rng.RollRandomFloatInRange(-1.0f, 1.0f));
+	if (rotation.norm() < 1.0e-3) {
+		return Eigen::Matrix<double, 3, 3>::Identity();
+	}
+	return rotation.normalized().toRotationMatrix();
+}
+
+//U * diag(singularValues) * V^T with random rotations U and V. isReflection flips one axis of U, so the determinant turns negative
+static Eigen::Matrix<double, 3, 3> GetRandomMatrixWithSingularValues(RandomNumberGenerator& rng, const Eigen::Vector3d& singularValues, bool isReflection)
+{
+	Eigen::Matrix<double, 3, 3> U = GetRandomRotationMatrix(rng);
+	if (isReflection) {
+		U.col(2) *= -1.0;
+	}
+	return U * singularValues.asDiagonal() * GetRandomRotationMatrix(rng).transpose();
+}
+
+bool Command_DDMPolarDecompositionTest(EventArgs& args)
+{
+	int numMatricesPerCase = atoi(args.GetValue("NumMatricesPerCase", std::string("1000")).c_str());
+	int numTimedMatrices = atoi(args.GetValue("NumTimedMatrices", std::string("200000")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	GUARANTEE_OR_DIE(numMatricesPerCase > 0 && numTimedMatrices > 0, "DDMPolarDecompositionTest needs positive NumMatricesPerCase and NumTimedMatrices");
+	constexpr double ROTATION_TOLERANCE = 1.0e-5;	//How far R^T * R may be from the identity
+
+	//A negative tolerance means the rotation isn't unique (rank 1), so only being a rotation is checked
+	struct PolarTestCase {
+		const char* m_name;
+		double m_tolerance;
+		std::function<Eigen::Matrix<double, 3, 3>()> m_getMatrix;
+	};
+	RandomNumberGenerator rng(seed);
+	auto rollSingularValue = [&](float minValue, float maxValue) { return (double)rng.RollRandomFloatInRange(minValue, maxValue); };
+	std::vector<PolarTestCase> testCases = {
+		{ "Identity", 1.0e-6, [&]() { return Eigen::Matrix<double, 3, 3>::Identity(); } },
+		{ "Rotations", 1.0e-5, [&]() { return GetRandomRotationMatrix(rng); } },
+		{ "Stretched rotations", 1.0e-5, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f)), false); } },
+		{ "Repeated singular values", 1.0e-5, [&]() { double s = rollSingularValue(0.5f, 2.0f); return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(s, s, rollSingularValue(0.5f, 2.0f)), false); } },
+		{ "Reflections", 1.0e-4, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(rollSingularValue(1.0f, 2.0f), rollSingularValue(0.5f, 1.0f), rollSingularValue(0.01f, 0.25f)), true); } },
+		{ "Near singular 1e-3", 1.0e-4, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(1.0, rollSingularValue(0.25f, 1.0f), 1.0e-3), rng.RollRandomIntLessThan(2) == 1); } },
+		{ "Near singular 1e-6", 1.0e-4, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(1.0, rollSingularValue(0.25f, 1.0f), 1.0e-6), rng.RollRandomIntLessThan(2) == 1); } },
+		{ "Rank 2", 1.0e-4, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(1.0, rollSingularValue(0.25f, 1.0f), 0.0), false); } },
+		{ "Rank 1", -1.0, [&]() { return GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(1.0, 0.0, 0.0), rng.RollRandomIntLessThan(2) == 1); } },
+		{ "Zero", 0.0, [&]() { return Eigen::Matrix<double, 3, 3>::Zero().eval(); } },
+		{ "Tiny scale 1e-30", 1.0e-5, [&]() { return (1.0e-30 * GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f)), false)).eval(); } },
+		{ "Huge scale 1e30", 1.0e-5, [&]() { return (1.0e30 * GetRandomMatrixWithSingularValues(rng, Eigen::Vector3d(rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f), rollSingularValue(0.25f, 4.0f)), false)).eval(); } },
+	};
+
+	bool hasPassed = true;
+	DDMSimdLevel highestSimdLevel = GetHighestSupportedDDMSimdLevel();
+	PrintBenchmarkLine(Stringf("DDMPolarDecompositionTest: %d matrices per case against Eigen's JacobiSVD, max |R - R_ref| and max |R^T * R - I|", numMatricesPerCase));
+	std::vector<float> matrices((size_t)numMatricesPerCase * 9);
+	std::vector<float> rotations((size_t)numMatricesPerCase * 9);
+	for (const PolarTestCase& testCase : testCases) {
+		std::vector<Eigen::Matrix<double, 3, 3>> referenceRotations(numMatricesPerCase);
+		for (int matrixIdx = 0; matrixIdx < numMatricesPerCase; matrixIdx++) {
+			Eigen::Matrix<double, 3, 3> A = testCase.m_getMatrix();
+			Eigen::Matrix<float, 3, 3, Eigen::RowMajor> floatA = A.cast<float>();
+			std::copy(floatA.data(), floatA.data() + 9, matrices.data() + (size_t)matrixIdx * 9);
+			referenceRotations[matrixIdx] = ComputeDDMPolarRotationReference(floatA.cast<double>());	//What the kernels can see of A
+		}
+
+		std::string line = Stringf("  %-26s", testCase.m_name);
+		for (int simdLevelIdx = 0; simdLevelIdx <= (int)highestSimdLevel; simdLevelIdx++) {
+			ComputeDDMPolarRotations(matrices.data(), numMatricesPerCase, rotations.data(), (DDMSimdLevel)simdLevelIdx);
+			double maxError = 0.0;
+			double maxRotationError = 0.0;
+			bool areRotations = true;
+			for (int matrixIdx = 0; matrixIdx < numMatricesPerCase; matrixIdx++) {
+				Eigen::Matrix<double, 3, 3> R = Eigen::Map<const Eigen::Matrix<float, 3, 3, Eigen::RowMajor>>(rotations.data() + (size_t)matrixIdx * 9).cast<double>();
+				double rotationError = (R.transpose() * R - Eigen::Matrix<double, 3, 3>::Identity()).cwiseAbs().maxCoeff();
+				areRotations = areRotations && R.allFinite() && R.determinant() > 0.0;
+				maxRotationError = std::max(maxRotationError, rotationError);
+				maxError = std::max(maxError, (R - referenceRotations[matrixIdx]).cwiseAbs().maxCoeff());
+			}
+			areRotations = areRotations && maxRotationError <= ROTATION_TOLERANCE;
+			bool hasCasePassed = areRotations && (testCase.m_tolerance < 0.0 || maxError <= testCase.m_tolerance);
+			hasPassed = hasPassed && hasCasePassed;
+			std::string errorStr = testCase.m_tolerance < 0.0 ? std::string("not unique") : Stringf("%.1e", maxError);
+			line += Stringf(" %s %-10s %.1e %s,", GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx), errorStr.c_str(), maxRotationError, GetBenchmarkCheckString(hasCasePassed));
+		}
+		line.pop_back();
+		PrintBenchmarkLine(line);
+	}
+
+	//Timing on stretched rotations, what Q_i - q_i * p_i^T mostly looks like
+	std::vector<Eigen::Matrix<double, 3, 3>> timedMatrices(numTimedMatrices);
+	matrices.resize((size_t)numTimedMatrices * 9);
+	rotations.resize((size_t)numTimedMatrices * 9);
+	for (int matrixIdx = 0; matrixIdx < numTimedMatrices; matrixIdx++) {
+		timedMatrices[matrixIdx] = testCases[2].m_getMatrix();
+		Eigen::Matrix<float, 3, 3, Eigen::RowMajor> floatA = timedMatrices[matrixIdx].cast<float>();
+		std::copy(floatA.data(), floatA.data() + 9, matrices.data() + (size_t)matrixIdx * 9);
+	}
+	double startTime = GetCurrentTimeSeconds();
+	double checksum = 0.0;
+	for (const Eigen::Matrix<double, 3, 3>& A : timedMatrices) {
+		checksum += ComputeDDMPolarRotationReference(A)(0, 0);
+	}
+	double referenceNanoseconds = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / (double)numTimedMatrices;
+	std::string line = Stringf("  Per matrix: Eigen JacobiSVD %.1lf ns", referenceNanoseconds);
+	for (int simdLevelIdx = 0; simdLevelIdx <= (int)highestSimdLevel; simdLevelIdx++) {
+		startTime = GetCurrentTimeSeconds();
+		ComputeDDMPolarRotations(matrices.data(), numTimedMatrices, rotations.data(), (DDMSimdLevel)simdLevelIdx);
+		double nanoseconds = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / (double)numTimedMatrices;
+		line += Stringf(", %s %.1lf ns (x%.1lf)", GetDDMSimdLevelName((DDMSimdLevel)simdLevelIdx), nanoseconds, referenceNanoseconds / nanoseconds);
+	}
+	PrintBenchmarkLine(line);
+	DebuggerPrintf("(checksum %f)\n", checksum);	//Keeps the reference loop from being optimized away
+	return hasPassed;
+}
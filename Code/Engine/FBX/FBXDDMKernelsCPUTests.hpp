@@ -0,0 +1,4 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+bool Command_DDMPolarDecompositionTest(EventArgs& args);	//Random matrices with known singular values, reflections and rank deficient ones through every SIMD level
@@ -2,31 +2,53 @@
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
+#include "Engine/Fbx/FBXDDMSparseOmegas.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Fbx/FBXMeshAsset.hpp"
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
 #include <vector>
+#include <memory>
+#include <atomic>
 
-class FBXMesh;
 class Shader;
 class Renderer;
 
+//What a mesh deforming with a modifier keeps of its own. The modifier only holds its precompute, so every copy of a mesh can share it
+struct DDMModifierInstanceState {
+public:
+	void SetNeedsRecalculation() { m_needsRecalculation = true; }
+
+public:
+	bool m_needsRecalculation = true;
+	uint64_t m_deformedPrecomputeId = 0;	//FBXDDMModifier::GetPrecomputeId of the last deform, anything else deforms every control point again
+	Eigen::MatrixX3f m_deformedControlPoints;	//Only the GetVariant*Deform paths fill this
+	std::vector<float> m_jointTransformsFloats;
+};
+
 class FBXDDMModifier {
 public:
-	FBXDDMModifier(FBXMesh& mesh);
+	//Precomputes from asset alone, with its rigid or its skinned weights, so it stays valid after the mesh that made it is gone
+	FBXDDMModifier(const std::shared_ptr<const FBXMeshAsset>& asset, bool isRigidBinding, int numJoints, double omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON);
 	virtual ~FBXDDMModifier();
 
 	virtual void Precompute(bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha);
 	virtual bool IsPrecomputed() const final;
-	void ResetIsPrecomputed();
+	uint64_t GetPrecomputeId() const;	//Different after every Precompute of any modifier
+	bool DidLoadPrecomputeFromCache() const;	//The last Precompute was a cache hit
+	bool IsRigidBinding() const;
+	double GetOmegaEpsilon() const;	//Omega blocks whose smoothed weight is at or below this get dropped
+	static void SetPrecomputeCacheDirectory(const std::string& cacheDirectory);	//Where Precompute looks for and saves its results. Empty, the default, turns the cache off
+	static const std::string& GetPrecomputeCacheDirectory();
 
 	virtual Eigen::Index GetNumJoints() const final;
-	virtual const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& GetConstRefToOmegaMatrix() const final;
+	virtual const DDMSparseOmegas& GetConstRefToOmegas() const final;
 	virtual const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& GetConstRefToV1ConstantMatrix() const final;
 	virtual const Eigen::Matrix<double, 1, 3> GetControlPoint(unsigned int index) const final;
-	virtual void SetNeedsRecalculation() final;
 
-	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) = 0;
-	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) = 0;
+	//Fill instanceState.m_deformedControlPoints when it is outdated, then return it
+	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) = 0;
+	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) = 0;
 
 	//static helper functions
 	static Eigen::VectorXd GetUpperTriangleOfSymmetric4x4Matrix(const Eigen::Matrix<double, 4, 4>& matrix);
@@ -41,18 +63,25 @@ public:
 	static void DebugPrintEigenMatrix(const Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>& inquiryMatrix);
 
 protected:
-	FBXMesh& m_mesh;
-	const Eigen::MatrixX3d m_controlPointsMatrixRestPose;
-	Eigen::SparseMatrix<double> m_normalizedLaplacian;
-	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> m_omegaMatrix;
+	bool IsInstanceStateOutdated(const DDMModifierInstanceState& instanceState) const;	//Needs recalculation, or last deformed with another precompute
+
+protected:
+	const std::shared_ptr<const FBXMeshAsset> m_asset;
+	const Eigen::MatrixX3d& m_controlPointsMatrixRestPose;	//m_asset's
+	const bool m_isRigidBinding = false;
+	const double m_omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON;
+	DDMSparseOmegas m_omegas;	//The paper's n x 10m omega matrix, minus the blocks of joints that barely influence a control point
 	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> m_v1ConstantMatrix; //This is (P_i - p_i*p_i^T)/det(P_i - p_i*p_i^T)
+	DDMPrecomputeState m_precomputeState;	//Lets Precompute with tweaked parameters redo only what changed
 	bool m_isPrecomputed = false;
+	bool m_didLoadPrecomputeFromCache = false;
+	uint64_t m_precomputeId = 0;
 	int m_numJoints = 0;
 
 	const Eigen::IOFormat m_debugPrintFmt = Eigen::IOFormat(2, 0, "\t", "\n", "", "", "", "");
 
-	bool m_needsRecalculation = true;
-	Eigen::MatrixX3f m_deformedControlPoints;
+	static std::string s_precomputeCacheDirectory;
+	static std::atomic<uint64_t> s_lastPrecomputeId;
 };
 
 template<typename Scalar>
@@ -1,22 +1,12 @@
 #include "Engine/Fbx/FBXDDMModifierCPU.hpp"
-#include "Engine/Fbx/FBXMesh.hpp"
-#include "Engine/Fbx/FBXDDMOmegaPrecomputeJob.hpp"
-#include "Engine/Fbx/FBXDDMV0CPUJob.hpp"
-#include "Engine/Fbx/FBXDDMV1CPUJob.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Time.hpp"
-#include "Engine/Renderer/Renderer.hpp"
-#include "Engine/Renderer/DebugRender.hpp"
-#include "ThirdParty/igl/cotmatrix.h"
-#include "ThirdParty/igl/adjacency_matrix.h"
-#include "ThirdParty/igl/sum.h"
-#include "ThirdParty/igl/direct_delta_mush.h"
 #include <Eigen/SparseCholesky>
-#include <Eigen/SVD>
 
-FBXDDMModifierCPU::FBXDDMModifierCPU(FBXMesh& mesh) : FBXDDMModifier(mesh)
+FBXDDMModifierCPU::FBXDDMModifierCPU(const std::shared_ptr<const FBXMeshAsset>& asset, bool isRigidBinding, int numJoints, double omegaEpsilon)
+	: FBXDDMModifier(asset, isRigidBinding, numJoints, omegaEpsilon)
 {
 }
 
@@ -24,129 +14,149 @@ FBXDDMModifierCPU::~FBXDDMModifierCPU()
 {
 }
 
-Eigen::MatrixX3f FBXDDMModifierCPU::GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame)
+void FBXDDMModifierCPU::Precompute(bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha)
 {
-	if (m_needsRecalculation == false) {
-		recalculatedThisFrame = false;
-		return m_deformedControlPoints;
-	}
+	FBXDDMModifier::Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
+	m_packets.Build(m_omegas, m_controlPointsMatrixRestPose, &m_v1ConstantMatrix);
+}
 
-	if (m_isPrecomputed == false) {
-		ERROR_AND_DIE("Have to precompute first!");
-	}
-	if (allJointTransforms.size() != static_cast<size_t>(m_numJoints)) {
-		ERROR_AND_DIE("allJointTransforms.size() != m_numJoints!");
+Eigen::MatrixX3f FBXDDMModifierCPU::GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame)
+{
+	if (IsInstanceStateOutdated(instanceState) == false) {
+		recalculatedThisFrame = false;
+		return instanceState.m_deformedControlPoints;
 	}
 
-	//DebugAddMessage(Stringf("NumQueuedJobs: %d, NumClaimedJobs: %d, NumCompletedJobs: %d", g_theJobSystem->GetNumQueuedJobs(), g_theJobSystem->GetNumClaimedJobs(), g_theJobSystem->GetNumCompletedJobs()), 1.0f);
-	
-	std::vector<Eigen::Matrix<double, 4, 4>> allJointTransformsEigen;
-	for (int i = 0; i < allJointTransforms.size(); i++) {
-		allJointTransformsEigen.push_back(ConvertMat44ToEigen(allJointTransforms[i]));
-	}
+	//DebugAddMessage(Stringf("NumQueuedJobs: %d, NumClaimedJobs: %d", g_theJobSystem->GetNumQueuedJobs(), g_theJobSystem->GetNumClaimedJobs()), 1.0f);
 
 	int numControlPoints = static_cast<int>(m_controlPointsMatrixRestPose.rows());
+	instanceState.m_deformedControlPoints.resize(numControlPoints, 3);
 
 	float beforeDDMTime = (float)GetCurrentTimeSeconds();
-	//m_omegaMatrix <- This was a n x 10m matrix. '10' cause the matrix is symmetrical
-	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
-		g_theJobSystem->PostNewJob(new FBXDDMV0CPUJob(*this, ctrlPointIdx, allJointTransformsEigen));
-	}
-	
-	while (g_theJobSystem->GetNumCompletedJobs() != numControlPoints) {} // Wait until all jobs complete
-	
+	//m_deformedControlPoints is column major, so x, y and z each sit in their own contiguous column
+	ComputeVariantv0Deform(allJointTransforms, instanceState.m_jointTransformsFloats, instanceState.m_deformedControlPoints.data(), 1, numControlPoints);
 	float afterDDMTime = (float)GetCurrentTimeSeconds();
 
-	DebuggerPrintf("Mesh: %s\n", m_mesh.GetName().c_str());
 	DebuggerPrintf("DDMV0 CPU time: %f\n", afterDDMTime - beforeDDMTime);
-	
-	while (true) {
-		Job* completedJob = g_theJobSystem->GetCompletedJob();
-		if (completedJob) {
-			FBXDDMV0CPUJob* v0CPUJob = dynamic_cast<FBXDDMV0CPUJob*>(completedJob);
-			if (v0CPUJob) {
-				m_deformedControlPoints.row(v0CPUJob->m_ctrlPointIdx) = v0CPUJob->m_deformedControlPoint;
-				delete v0CPUJob;
-			}
-			else {
-				ERROR_AND_DIE("Doesn't make sense...");
-			}
-		}
-		else {
-			break;
-		}
-	}
 
-	m_needsRecalculation = false;
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
 	recalculatedThisFrame = true;
 
-	return m_deformedControlPoints;
+	return instanceState.m_deformedControlPoints;
 }
 
-Eigen::MatrixX3f FBXDDMModifierCPU::GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame)
+Eigen::MatrixX3f FBXDDMModifierCPU::GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame)
 {
-	if (m_needsRecalculation == false) {
+	if (IsInstanceStateOutdated(instanceState) == false) {
 		recalculatedThisFrame = false;
-		return m_deformedControlPoints;
+		return instanceState.m_deformedControlPoints;
 	}
 
+	int numControlPoints = static_cast<int>(m_controlPointsMatrixRestPose.rows());
+	instanceState.m_deformedControlPoints.resize(numControlPoints, 3);
+
+	float beforeDDMTime = (float)GetCurrentTimeSeconds();
+	ComputeVariantv1Deform(allJointTransforms, instanceState.m_jointTransformsFloats, instanceState.m_deformedControlPoints.data(), 1, numControlPoints);
+	float afterDDMTime = (float)GetCurrentTimeSeconds();
+
+	DebuggerPrintf("DDMV1 CPU time: %f\n", afterDDMTime - beforeDDMTime);
+
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
+	recalculatedThisFrame = true;
+
+	return instanceState.m_deformedControlPoints;
+}
+
+void FBXDDMModifierCPU::ComputeVariantv0Deform(const std::vector<Mat44>& allJointTransforms, std::vector<float>& jointTransformsFloats, float* outPositions, int pointStride, int componentStride) const
+{
 	if (m_isPrecomputed == false) {
 		ERROR_AND_DIE("Have to precompute first!");
 	}
 	if (allJointTransforms.size() != static_cast<size_t>(m_numJoints)) {
 		ERROR_AND_DIE("allJointTransforms.size() != m_numJoints!");
 	}
-	std::vector<Eigen::Matrix<double, 4, 4>> allJointTransformsEigen;
-	for (int i = 0; i < allJointTransforms.size(); i++) {
-		allJointTransformsEigen.push_back(ConvertMat44ToEigen(allJointTransforms[i]));
-	}
-
-	int numControlPoints = static_cast<int>(m_controlPointsMatrixRestPose.rows());
 
-	m_deformedControlPoints.resize(numControlPoints, 3);
-	m_deformedControlPoints.setZero();
+	ConvertJointTransformsToFloats(allJointTransforms, jointTransformsFloats);
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	int grainSizeInPackets = std::max(DEFORM_PARALLEL_FOR_GRAIN_SIZE / DDMControlPointPackets::PACKET_SIZE, 1);
+	g_theJobSystem->ParallelForRange(0, m_packets.GetNumPackets(), grainSizeInPackets, [&](int beginPacketIdx, int endPacketIdx) {
+		ComputeDDMv0DeformedControlPoints(m_packets, jointTransformsFloats.data(), beginPacketIdx, endPacketIdx, outPositions, pointStride, componentStride, simdLevel);
+	});
+}
 
-	/*
-	Eigen::MatrixX3d deformedControlPoints(numControlPoints, 3);
-	deformedControlPoints.setZero();
+void FBXDDMModifierCPU::ComputeVariantv1Deform(const std::vector<Mat44>& allJointTransforms, std::vector<float>& jointTransformsFloats, float* outPositions, int pointStride, int componentStride) const
+{
+	if (m_isPrecomputed == false) {
+		ERROR_AND_DIE("Have to precompute first!");
+	}
+	if (allJointTransforms.size() != static_cast<size_t>(m_numJoints)) {
+		ERROR_AND_DIE("allJointTransforms.size() != m_numJoints!");
+	}
 
-	Eigen::MatrixX4d affineControlPointsMatrix(numControlPoints, 4);
-	affineControlPointsMatrix.leftCols(3) = m_controlPointsMatrixRestPose;
-	affineControlPointsMatrix.rightCols(1).setOnes();
-	*/
-	float beforeDDMTime = (float)GetCurrentTimeSeconds();
+	ConvertJointTransformsToFloats(allJointTransforms, jointTransformsFloats);
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	int grainSizeInPackets = std::max(DEFORM_PARALLEL_FOR_GRAIN_SIZE / DDMControlPointPackets::PACKET_SIZE, 1);
+	g_theJobSystem->ParallelForRange(0, m_packets.GetNumPackets(), grainSizeInPackets, [&](int beginPacketIdx, int endPacketIdx) {
+		ComputeDDMv1DeformedControlPoints(m_packets, jointTransformsFloats.data(), beginPacketIdx, endPacketIdx, outPositions, pointStride, componentStride, simdLevel);
+	});
+}
 
-	//m_omegaMatrix <- This was a n x 10m matrix. '10' cause the matrix is symmetrical
-	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
-		g_theJobSystem->PostNewJob(new FBXDDMV1CPUJob(*this, ctrlPointIdx, allJointTransformsEigen));
+bool FBXDDMModifierCPU::WriteVariantv0DeformToRenderVertices(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, DDMRenderVertexWriteback& writeback,
+	float* positions, int vertexStride, const std::vector<int>* changedJointIndices) const
+{
+	if (IsInstanceStateOutdated(instanceState) == false) {
+		return false;
+	}
+	if (instanceState.m_deformedPrecomputeId != m_precomputeId) {
+		changedJointIndices = nullptr;	//The control points the changed joints don't influence were deformed with another precompute
+	}
+	if (m_isPrecomputed == false) {
+		ERROR_AND_DIE("Have to precompute first!");
+	}
+	if (allJointTransforms.size() != static_cast<size_t>(m_numJoints)) {
+		ERROR_AND_DIE("allJointTransforms.size() != m_numJoints!");
 	}
 
-	while (g_theJobSystem->GetNumCompletedJobs() != numControlPoints) {} // Wait until all jobs complete
-
+	float beforeDDMTime = (float)GetCurrentTimeSeconds();
+	ConvertJointTransformsToFloats(allJointTransforms, instanceState.m_jointTransformsFloats);
+	writeback.WriteVariantv0(*g_theJobSystem, m_packets, instanceState.m_jointTransformsFloats.data(), GetHighestSupportedDDMSimdLevel(), positions, vertexStride, changedJointIndices);
 	float afterDDMTime = (float)GetCurrentTimeSeconds();
 
-	DebuggerPrintf("Mesh: %s\n", m_mesh.GetName().c_str());
-	DebuggerPrintf("DDMV1 CPU time: %f\n", afterDDMTime - beforeDDMTime);
+	DebuggerPrintf("DDMV0 CPU time: %f, deformed packets: %d of %d, dirty render vertices: %d of %d\n", afterDDMTime - beforeDDMTime, writeback.GetNumDeformedPackets(), m_packets.GetNumPackets(),
+		writeback.GetNumDirtyRenderVertices(), writeback.GetNumRenderVertices());
+
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
+	return true;
+}
 
-	while (true) {
-		Job* completedJob = g_theJobSystem->GetCompletedJob();
-		if (completedJob) {
-			FBXDDMV1CPUJob* v1CPUJob = dynamic_cast<FBXDDMV1CPUJob*>(completedJob);
-			if (v1CPUJob) {
-				m_deformedControlPoints.row(v1CPUJob->m_ctrlPointIdx) = v1CPUJob->m_deformedControlPoint;
-				delete v1CPUJob;
-			}
-			else {
-				ERROR_AND_DIE("Doesn't make sense...");
-			}
-		}
-		else {
-			break;
-		}
+bool FBXDDMModifierCPU::WriteVariantv1DeformToRenderVertices(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, DDMRenderVertexWriteback& writeback,
+	float* positions, int vertexStride, const std::vector<int>* changedJointIndices) const
+{
+	if (IsInstanceStateOutdated(instanceState) == false) {
+		return false;
+	}
+	if (instanceState.m_deformedPrecomputeId != m_precomputeId) {
+		changedJointIndices = nullptr;	//The control points the changed joints don't influence were deformed with another precompute
+	}
+	if (m_isPrecomputed == false) {
+		ERROR_AND_DIE("Have to precompute first!");
+	}
+	if (allJointTransforms.size() != static_cast<size_t>(m_numJoints)) {
+		ERROR_AND_DIE("allJointTransforms.size() != m_numJoints!");
 	}
 
-	m_needsRecalculation = false;
-	recalculatedThisFrame = true;
+	float beforeDDMTime = (float)GetCurrentTimeSeconds();
+	ConvertJointTransformsToFloats(allJointTransforms, instanceState.m_jointTransformsFloats);
+	writeback.WriteVariantv1(*g_theJobSystem, m_packets, instanceState.m_jointTransformsFloats.data(), GetHighestSupportedDDMSimdLevel(), positions, vertexStride, changedJointIndices);
+	float afterDDMTime = (float)GetCurrentTimeSeconds();
 
-	return m_deformedControlPoints;
-}
\ No newline at end of file
+	DebuggerPrintf("DDMV1 CPU time: %f, deformed packets: %d of %d, dirty render vertices: %d of %d\n", afterDDMTime - beforeDDMTime, writeback.GetNumDeformedPackets(), m_packets.GetNumPackets(),
+		writeback.GetNumDirtyRenderVertices(), writeback.GetNumRenderVertices());
+
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
+	return true;
+}
@@ -1,19 +1,36 @@
 #pragma once
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Fbx/FBXDDMVertexWriteback.hpp"
 #include <Eigen/Sparse>
 #include <Eigen/Dense>
 #include <vector>
 
 class Renderer;
-class FBXMesh;
 
 class FBXDDMModifierCPU : public FBXDDMModifier {
-	friend class FBXMesh;
 public:
-	FBXDDMModifierCPU(FBXMesh& mesh);
+	FBXDDMModifierCPU(const std::shared_ptr<const FBXMeshAsset>& asset, bool isRigidBinding, int numJoints, double omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON);
 	virtual ~FBXDDMModifierCPU();
 
-	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) override;
-	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) override;
+	virtual void Precompute(bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha) override;
+
+	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) override;
+	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) override;
+
+	//Always recalculates. Writes control point i to outPositions[i * pointStride + component * componentStride], see ComputeDDMv0DeformedControlPoints
+	void ComputeVariantv0Deform(const std::vector<Mat44>& allJointTransforms, std::vector<float>& jointTransformsFloats, float* outPositions, int pointStride, int componentStride) const;
+	void ComputeVariantv1Deform(const std::vector<Mat44>& allJointTransforms, std::vector<float>& jointTransformsFloats, float* outPositions, int pointStride, int componentStride) const;
+
+	//Deforms straight into render vertex positions through writeback (see DDMRenderVertexWriteback::WriteVariantv0), without filling instanceState.m_deformedControlPoints.
+	//Returns false and writes nothing when nothing changed since the last deform. With changedJointIndices, only the control points those joints influence are deformed again
+	bool WriteVariantv0DeformToRenderVertices(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, DDMRenderVertexWriteback& writeback,
+		float* positions, int vertexStride, const std::vector<int>* changedJointIndices = nullptr) const;
+	bool WriteVariantv1DeformToRenderVertices(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, DDMRenderVertexWriteback& writeback,
+		float* positions, int vertexStride, const std::vector<int>* changedJointIndices = nullptr) const;
+
+private:
+	DDMControlPointPackets m_packets;	//m_omegas, the rest pose and the v1 constants regrouped for the SIMD kernels
+	static constexpr int DEFORM_PARALLEL_FOR_GRAIN_SIZE = 64;	//Control points per chunk at the very least
 };
\ No newline at end of file
@@ -1,6 +1,4 @@
 #include "Engine/Fbx/FBXDDMModifierGPU.hpp"
-#include "Engine/Fbx/FBXMesh.hpp"
-#include "Engine/Fbx/FBXDDMOmegaPrecomputeJob.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/EngineCommon.hpp"
@@ -19,7 +17,8 @@
 #include <Eigen/SparseCholesky>
 #include <Eigen/SVD>
 
-FBXDDMModifierGPU::FBXDDMModifierGPU(FBXMesh& mesh) : FBXDDMModifier(mesh)
+FBXDDMModifierGPU::FBXDDMModifierGPU(const std::shared_ptr<const FBXMeshAsset>& asset, bool isRigidBinding, int numJoints, double omegaEpsilon)
+	: FBXDDMModifier(asset, isRigidBinding, numJoints, omegaEpsilon)
 {
 	CudaErrorCheck(cudaMallocManaged((void**)&m_controlPointsMatrixRestPoseGPU, m_controlPointsMatrixRestPose.size() * sizeof(double)));
 
@@ -45,23 +44,25 @@ void FBXDDMModifierGPU::Precompute(bool useCotangentLaplacian, int numLaplacianI
 {
 	FBXDDMModifier::Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
 
-	CudaErrorCheck(cudaMallocManaged((void**)&m_omegaMatrixGPU, m_omegaMatrix.size() * sizeof(double)));
-
-	Eigen::MatrixXd omegaMatrixTranspose = m_omegaMatrix.transpose();
+	//The CUDA kernels still walk every joint of a control point, so they get the dense n x 10m layout
+	Eigen::MatrixXd omegaMatrixTranspose = m_omegas.GetDenseOmegaMatrix().transpose();
+	CudaErrorCheck(cudaFree(m_omegaMatrixGPU));	//From the last Precompute, if any
+	CudaErrorCheck(cudaMallocManaged((void**)&m_omegaMatrixGPU, omegaMatrixTranspose.size() * sizeof(double)));
 	CudaErrorCheck(cudaMemcpy(m_omegaMatrixGPU, omegaMatrixTranspose.data(), omegaMatrixTranspose.size() * sizeof(double), cudaMemcpyKind::cudaMemcpyHostToDevice));
 
+	CudaErrorCheck(cudaFree(m_v1ConstantMatrixGPU));
 	CudaErrorCheck(cudaMallocManaged((void**)&m_v1ConstantMatrixGPU, m_v1ConstantMatrix.size() * sizeof(double)));
 
 	Eigen::MatrixXd v1ConstantMatrixTranspose = m_v1ConstantMatrix.transpose();
 	CudaErrorCheck(cudaMemcpy(m_v1ConstantMatrixGPU, v1ConstantMatrixTranspose.data(), v1ConstantMatrixTranspose.size() * sizeof(double), cudaMemcpyKind::cudaMemcpyHostToDevice));
 }
 
-Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame)
+Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame)
 {
 	//Disable this for renderdoc debug
-	if (m_needsRecalculation == false) {
+	if (IsInstanceStateOutdated(instanceState) == false) {
 		recalculatedThisFrame = false;
-		return m_deformedControlPoints;
+		return instanceState.m_deformedControlPoints;
 	}
 	if (m_isPrecomputed == false) {
 		ERROR_AND_DIE("Have to precompute first!");
@@ -75,8 +76,7 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0Deform(const std::vector<Mat44>&
 	CudaErrorCheck(cudaMallocManaged((void**)&allJointTransformsGPU, allJointTransforms.size() * sizeof(Mat44)));
 	CudaErrorCheck(cudaMemcpy(allJointTransformsGPU, allJointTransforms.data(), allJointTransforms.size() * sizeof(Mat44), cudaMemcpyKind::cudaMemcpyHostToDevice));
 
-	DebuggerPrintf("Mesh: %s\n", m_mesh.GetName().c_str());
-	ComputeV0_CUDA(allJointTransformsGPU, 512, 128, m_mesh.GetNumJoints(), (int)m_mesh.GetControlPointsMatrixRestPose().rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_deformedControlPointsGPU);
+	ComputeV0_CUDA(allJointTransformsGPU, 512, 128, m_numJoints, (int)m_controlPointsMatrixRestPose.rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_deformedControlPointsGPU);
 	cudaDeviceSynchronize();
 
 	CudaErrorCheck(cudaFree(allJointTransformsGPU));
@@ -86,19 +86,20 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0Deform(const std::vector<Mat44>&
 	//CudaErrorCheck(cudaMemcpy(deformedControlPointsTranspose.data(), m_deformedControlPointsGPU, deformedControlPointsTranspose.size() * sizeof(float), cudaMemcpyKind::cudaMemcpyDeviceToHost));
 	deformedControlPointsTranspose = Eigen::Map<Eigen::MatrixXf>(m_deformedControlPointsGPU, 3, m_controlPointsMatrixRestPose.rows());
 
-	m_deformedControlPoints = deformedControlPointsTranspose.transpose();
-	m_needsRecalculation = false;
+	instanceState.m_deformedControlPoints = deformedControlPointsTranspose.transpose();
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
 
 	recalculatedThisFrame = true;
-	return m_deformedControlPoints;
+	return instanceState.m_deformedControlPoints;
 }
 
-Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame)
+Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame)
 {
 	//Disable this for renderdoc debug
-	if (m_needsRecalculation == false) {
+	if (IsInstanceStateOutdated(instanceState) == false) {
 		recalculatedThisFrame = false;
-		return m_deformedControlPoints;
+		return instanceState.m_deformedControlPoints;
 	}
 	if (m_isPrecomputed == false) {
 		ERROR_AND_DIE("Have to precompute first!");
@@ -112,8 +113,7 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv1Deform(const std::vector<Mat44>&
 	CudaErrorCheck(cudaMallocManaged((void**)&allJointTransformsGPU, allJointTransforms.size() * sizeof(Mat44)));
 	CudaErrorCheck(cudaMemcpy(allJointTransformsGPU, allJointTransforms.data(), allJointTransforms.size() * sizeof(Mat44), cudaMemcpyKind::cudaMemcpyHostToDevice));
 
-	DebuggerPrintf("Mesh: %s\n", m_mesh.GetName().c_str());
-	ComputeV1_CUDA(allJointTransformsGPU, 512, 128, m_mesh.GetNumJoints(), (int)m_mesh.GetControlPointsMatrixRestPose().rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_v1ConstantMatrixGPU, m_deformedControlPointsGPU);
+	ComputeV1_CUDA(allJointTransformsGPU, 512, 128, m_numJoints, (int)m_controlPointsMatrixRestPose.rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_v1ConstantMatrixGPU, m_deformedControlPointsGPU);
 	cudaDeviceSynchronize();
 
 	CudaErrorCheck(cudaFree(allJointTransformsGPU));
@@ -123,11 +123,12 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv1Deform(const std::vector<Mat44>&
 	//CudaErrorCheck(cudaMemcpy(deformedControlPointsTranspose.data(), m_deformedControlPointsGPU, deformedControlPointsTranspose.size() * sizeof(float), cudaMemcpyKind::cudaMemcpyDeviceToHost));
 	deformedControlPointsTranspose = Eigen::Map<Eigen::MatrixXf>(m_deformedControlPointsGPU, 3, m_controlPointsMatrixRestPose.rows());
 
-	m_deformedControlPoints = deformedControlPointsTranspose.transpose();
-	m_needsRecalculation = false;
+	instanceState.m_deformedControlPoints = deformedControlPointsTranspose.transpose();
+	instanceState.m_needsRecalculation = false;
+	instanceState.m_deformedPrecomputeId = m_precomputeId;
 	recalculatedThisFrame = true;
 
-	return m_deformedControlPoints;
+	return instanceState.m_deformedControlPoints;
 }
 
 Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0DeformAlwaysCalculated(const std::vector<Mat44>& allJointTransforms)
@@ -144,7 +145,7 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0DeformAlwaysCalculated(const std
 	CudaErrorCheck(cudaMallocManaged((void**)&allJointTransformsGPU, allJointTransforms.size() * sizeof(Mat44)));
 	CudaErrorCheck(cudaMemcpy(allJointTransformsGPU, allJointTransforms.data(), allJointTransforms.size() * sizeof(Mat44), cudaMemcpyKind::cudaMemcpyHostToDevice));
 
-	ComputeV0_CUDA(allJointTransformsGPU, 256, 256, m_mesh.GetNumJoints(), (int)m_mesh.GetControlPointsMatrixRestPose().rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_deformedControlPointsGPU);
+	ComputeV0_CUDA(allJointTransformsGPU, 256, 256, m_numJoints, (int)m_controlPointsMatrixRestPose.rows(), m_omegaMatrixGPU, m_controlPointsMatrixRestPoseGPU, m_deformedControlPointsGPU);
 	cudaDeviceSynchronize();
 
 	CudaErrorCheck(cudaFree(allJointTransformsGPU));
@@ -154,8 +155,7 @@ Eigen::MatrixX3f FBXDDMModifierGPU::GetVariantv0DeformAlwaysCalculated(const std
 	//CudaErrorCheck(cudaMemcpy(deformedControlPointsTranspose.data(), m_deformedControlPointsGPU, deformedControlPointsTranspose.size() * sizeof(float), cudaMemcpyKind::cudaMemcpyDeviceToHost));
 	deformedControlPointsTranspose = Eigen::Map<Eigen::MatrixXf>(m_deformedControlPointsGPU, 3, m_controlPointsMatrixRestPose.rows());
 
-	m_deformedControlPoints = deformedControlPointsTranspose.transpose();
-	return m_deformedControlPoints;
+	return deformedControlPointsTranspose.transpose();
 }
 
 void FBXDDMModifierGPU::CudaErrorCheck(cudaError_t callCudaFunctionHere)
@@ -7,7 +7,6 @@
 #include <cuda_runtime.h>
 
 class Renderer;
-class FBXMesh;
 class StructuredBuffer;
 class ConstantBuffer;
 class ComputeOutputBuffer;
@@ -24,13 +23,13 @@ struct DDMConstants {
 class FBXDDMModifierGPU : public FBXDDMModifier{
 	friend class FBXMesh;
 public:
-	FBXDDMModifierGPU(FBXMesh& mesh);
+	FBXDDMModifierGPU(const std::shared_ptr<const FBXMeshAsset>& asset, bool isRigidBinding, int numJoints, double omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON);
 	~FBXDDMModifierGPU();
 
 	virtual void Precompute(bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha) override;
 	
-	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) override;
-	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, bool& recalculatedThisFrame) override;
+	virtual Eigen::MatrixX3f GetVariantv0Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) override;
+	virtual Eigen::MatrixX3f GetVariantv1Deform(const std::vector<Mat44>& allJointTransforms, DDMModifierInstanceState& instanceState, bool& recalculatedThisFrame) override;
 
 	virtual Eigen::MatrixX3f GetVariantv0DeformAlwaysCalculated(const std::vector<Mat44>& allJointTransforms);
 
@@ -41,5 +40,5 @@ private:
 	double* m_omegaMatrixGPU = nullptr;
 	double* m_controlPointsMatrixRestPoseGPU = nullptr;
 	double* m_v1ConstantMatrixGPU = nullptr;
-	float* m_deformedControlPointsGPU = nullptr;
+	float* m_deformedControlPointsGPU = nullptr;	//Scratch of one deform at a time, every deform syncs and copies it out before returning
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+//The static helpers of FBXDDMModifier. They only need Eigen and Mat44, and live apart from FBXDDMModifier.cpp so the precompute and the CPU kernels
+//link without FBXMesh (and with it the FBX SDK and the renderer)
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include <cmath>
+
+Eigen::VectorXd FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(const Eigen::Matrix<double, 4, 4>& matrix)
+{
+	Eigen::VectorXd result(10);
+	result << matrix(0, 0), matrix(0, 1), matrix(0, 2), matrix(0, 3), matrix(1, 1), matrix(1, 2), matrix(1, 3), matrix(2, 2), matrix(2, 3), matrix(3, 3);
+	return result;
+}
+
+Eigen::VectorXd FBXDDMModifier::GetUpperTriangleOfSymmetric3x3Matrix(const Eigen::Matrix<double, 3, 3>& matrix)
+{
+	Eigen::VectorXd result(6);
+	result << matrix(0, 0), matrix(0, 1), matrix(0, 2), matrix(1, 1), matrix(1, 2), matrix(2, 2);
+	return result;
+}
+
+Eigen::Matrix<double, 4, 4> FBXDDMModifier::ConvertMat44ToEigen(const Mat44& mat)
+{
+	Eigen::Matrix<double, 4, 4> matToReturn;
+
+	matToReturn << mat.m_values[Mat44::Ix], mat.m_values[Mat44::Jx], mat.m_values[Mat44::Kx], mat.m_values[Mat44::Tx],
+		mat.m_values[Mat44::Iy], mat.m_values[Mat44::Jy], mat.m_values[Mat44::Ky], mat.m_values[Mat44::Ty],
+		mat.m_values[Mat44::Iz], mat.m_values[Mat44::Jz], mat.m_values[Mat44::Kz], mat.m_values[Mat44::Tz],
+		mat.m_values[Mat44::Iw], mat.m_values[Mat44::Jw], mat.m_values[Mat44::Kw], mat.m_values[Mat44::Tw];
+
+	return matToReturn;
+}
+
+Eigen::Matrix<double, 4, 4> FBXDDMModifier::GetSymmetricMatrix4x4From10Floats(const Eigen::Matrix<double, 1, 10>& floats)
+{
+	Eigen::Matrix<double, 4, 4> symmetricMatrix;
+
+	symmetricMatrix << floats(0), floats(1), floats(2), floats(3),
+		floats(1), floats(4), floats(5), floats(6),
+		floats(2), floats(5), floats(7), floats(8),
+		floats(3), floats(6), floats(8), floats(9);
+
+	return symmetricMatrix;
+}
+
+Eigen::Matrix<double, 3, 3> FBXDDMModifier::GetSymmetricMatrix3x3From6Floats(const Eigen::Matrix<double, 1, 6>& floats)
+{
+	Eigen::Matrix<double, 3, 3> symmetricMatrix;
+
+	symmetricMatrix << floats(0), floats(1), floats(2),
+		floats(1), floats(3), floats(4),
+		floats(2), floats(4), floats(5);
+
+	return symmetricMatrix;
+}
+
+bool FBXDDMModifier::DoesMatrixHaveNans(const Eigen::SparseMatrix<double>& inquiryMatrix)
+{
+	for (int k = 0; k < inquiryMatrix.outerSize(); ++k)
+	{
+		for (Eigen::SparseMatrix<double>::InnerIterator it(inquiryMatrix, k); it; ++it)
+		{
+			if (std::isnan(it.value()))
+			{
+				return true; // Found a NaN value, return true
+			}
+		}
+	}
+
+	return false; // No NaN values found
+}
\ No newline at end of file
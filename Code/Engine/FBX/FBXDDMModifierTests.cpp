@@ -0,0 +1,140 @@
+#include "Engine/Fbx/FBXDDMModifierTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+
+//FBXMesh::GetDDMModifierCPU
+static std::shared_ptr<FBXDDMModifierCPU> GetBenchmarkDDMModifierCPU(const BenchmarkModelInstance& instance)
+{
+	return instance.m_isRigidBinding ? instance.m_rigidDDMModifierCPU : instance.m_ddmModifierCPU;
+}
+
+//FBXModel::PrecomputeDDM, then a GetVariantv0Deform of the whole mesh
+static Eigen::MatrixX3f DeformBenchmarkInstance(BenchmarkModelInstance& instance, const std::vector<Mat44>& jointTransforms)
+{
+	std::shared_ptr<FBXDDMModifierCPU> modifier = GetBenchmarkDDMModifierCPU(instance);
+	if (modifier->IsPrecomputed() == false) {
+		modifier->Precompute(true, 8, 0.5, 0.1, 0.5);
+	}
+	bool didRecalculate = false;
+	instance.m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	return modifier->GetVariantv0Deform(jointTransforms, instance.m_ddmInstanceStateCPU, didRecalculate);
+}
+
+//FBXMesh::ApplyDDMv1_CPU, returns false when nothing was written
+static bool WriteBenchmarkInstanceDDM(BenchmarkModelInstance& instance, const std::vector<Mat44>& jointTransforms, const std::vector<int>* changedJointIndices)
+{
+	DDMRenderVertexWriteback& writeback = instance.m_ddmRenderVertexWriteback;
+	if (writeback.GetNumRenderVertices() != (int)instance.m_renderVertices.size()) {
+		writeback.Build(instance.m_meshAsset->m_renderVertexToControlPointMap, (int)instance.m_meshAsset->m_controlPointsRestPose.size());
+	}
+	return GetBenchmarkDDMModifierCPU(instance)->WriteVariantv1DeformToRenderVertices(jointTransforms, instance.m_ddmInstanceStateCPU, writeback,
+		&instance.m_renderVertices[0].m_position.x, (int)(sizeof(Vertex_FBX) / sizeof(float)), changedJointIndices);
+}
+
+static bool AreRenderVertexPositionsBitIdentical(const std::vector<Vertex_FBX>& a, const std::vector<Vertex_FBX>& b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (int renderVertexIdx = 0; renderVertexIdx < (int)a.size(); renderVertexIdx++) {
+		if (memcmp(&a[renderVertexIdx].m_position, &b[renderVertexIdx].m_position, sizeof(Vec3)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+DDMModifierSharingTestResult RunDDMModifierSharingTest(JobSystem& jobSystem, int numControlPoints, int numJoints, unsigned int seed)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0 && numJoints > 1, "RunDDMModifierSharingTest needs control points and at least 2 joints");
+	DDMModifierSharingTestResult result;
+	result.m_numJoints = numJoints;
+
+	//Every precompute below has to really run, not come from a file an earlier run left
+	std::string precomputeCacheDirectory = FBXDDMModifier::GetPrecomputeCacheDirectory();
+	FBXDDMModifier::SetPrecomputeCacheDirectory("");
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	BenchmarkModelInstance* source = new BenchmarkModelInstance();
+	std::shared_ptr<FBXMeshAsset> meshAsset = GetSyntheticFBXMeshAsset(jobSystem, mesh, numJoints, source->m_renderVertices);
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	source->m_meshAsset = meshAsset;
+	source->m_ddmModifierCPU = std::make_shared<FBXDDMModifierCPU>(meshAsset, false, numJoints);
+	source->m_rigidDDMModifierCPU = std::make_shared<FBXDDMModifierCPU>(meshAsset, true, numJoints);
+	RandomNumberGenerator rng(seed);
+	std::vector<Mat44> jointTransforms = GetSyntheticJointTransforms(numJoints, rng);
+
+	//The copies still hold the rest pose, so matching the source afterwards means they deformed on their own
+	std::vector<BenchmarkModelInstance*> copies;
+	for (int copyIdx = 0; copyIdx < 3; copyIdx++) {
+		copies.push_back(CreateBenchmarkModelCopy(*source, false));
+	}
+	Eigen::MatrixX3f sourceDeformed = DeformBenchmarkInstance(*source, jointTransforms);
+	source->m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	WriteBenchmarkInstanceDDM(*source, jointTransforms, nullptr);
+	std::vector<Vertex_FBX> sourceRenderVertices = source->m_renderVertices;
+	std::weak_ptr<FBXDDMModifierCPU> weakModifier = source->m_ddmModifierCPU;
+	std::weak_ptr<FBXMeshAsset> weakMeshAsset = meshAsset;
+	meshAsset.reset();
+	delete source;
+	result.m_doesCopyOutliveSource = !weakModifier.expired() && !weakMeshAsset.expired() && DeformBenchmarkInstance(*copies[0], jointTransforms) == sourceDeformed;
+	copies[0]->m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	result.m_doesCopyOutliveSource = result.m_doesCopyOutliveSource && WriteBenchmarkInstanceDDM(*copies[0], jointTransforms, nullptr)
+		&& AreRenderVertexPositionsBitIdentical(copies[0]->m_renderVertices, sourceRenderVertices);
+
+	//Rigid binding on one copy takes the other modifier, the skinned one and whatever the other copies deform with it stay as they were
+	uint64_t skinnedPrecomputeId = copies[1]->m_ddmModifierCPU->GetPrecomputeId();
+	Eigen::MatrixX3f skinnedDeformed = DeformBenchmarkInstance(*copies[1], jointTransforms);
+	copies[0]->m_isRigidBinding = true;
+	copies[0]->m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	Eigen::MatrixX3f rigidDeformed = DeformBenchmarkInstance(*copies[0], jointTransforms);
+	result.m_isRigidBindingPerCopy = GetBenchmarkDDMModifierCPU(*copies[0])->IsRigidBinding() && !(rigidDeformed == skinnedDeformed)
+		&& GetBenchmarkDDMModifierCPU(*copies[1])->IsRigidBinding() == false && copies[1]->m_ddmModifierCPU->GetPrecomputeId() == skinnedPrecomputeId
+		&& DeformBenchmarkInstance(*copies[1], jointTransforms) == skinnedDeformed && DeformBenchmarkInstance(*copies[2], jointTransforms) == skinnedDeformed;
+
+	//A second copy going rigid finds the precompute the first one made
+	uint64_t rigidPrecomputeId = copies[0]->m_rigidDDMModifierCPU->GetPrecomputeId();
+	copies[2]->m_isRigidBinding = true;
+	copies[2]->m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	result.m_isPrecomputeSharedPerBinding = GetBenchmarkDDMModifierCPU(*copies[2]) == GetBenchmarkDDMModifierCPU(*copies[0])
+		&& DeformBenchmarkInstance(*copies[2], jointTransforms) == rigidDeformed && copies[2]->m_rigidDDMModifierCPU->GetPrecomputeId() == rigidPrecomputeId;
+
+	//Once a copy precomputes the shared modifier again, the others can't keep the control points their changed joints don't move
+	std::vector<int> noChangedJointIndices;
+	int numPackets = (result.m_numControlPoints + DDMControlPointPackets::PACKET_SIZE - 1) / DDMControlPointPackets::PACKET_SIZE;
+	copies[1]->m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	bool didWrite = WriteBenchmarkInstanceDDM(*copies[1], jointTransforms, nullptr);
+	bool didWriteUnchanged = WriteBenchmarkInstanceDDM(*copies[1], jointTransforms, &noChangedJointIndices);
+	copies[0]->m_isRigidBinding = false;
+	copies[0]->m_ddmModifierCPU->Precompute(true, 8, 0.5, 0.1, 0.5);
+	bool didWriteAfterPrecompute = WriteBenchmarkInstanceDDM(*copies[1], jointTransforms, &noChangedJointIndices);
+	result.m_doesPrecomputeRedeformCopies = didWrite && !didWriteUnchanged && didWriteAfterPrecompute && copies[1]->m_ddmRenderVertexWriteback.GetNumDeformedPackets() == numPackets;
+
+	for (BenchmarkModelInstance* copy : copies) {
+		delete copy;
+	}
+	result.m_doesCopyOutliveSource = result.m_doesCopyOutliveSource && weakModifier.expired() && weakMeshAsset.expired();
+	FBXDDMModifier::SetPrecomputeCacheDirectory(precomputeCacheDirectory);
+	return result;
+}
+
+bool Command_DDMModifierSharingTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("5000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	int seed = atoi(args.GetValue("Seed", std::string("1234")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMModifierSharingTest needs g_theJobSystem");
+	DDMModifierSharingTestResult result = RunDDMModifierSharingTest(*g_theJobSystem, std::max(numControlPoints, 64), std::max(numJoints, 2), (unsigned int)seed);
+	PrintBenchmarkLine(Stringf("DDMModifierSharingTest: %d control points, %d joints, seed %d", result.m_numControlPoints, result.m_numJoints, seed));
+	PrintBenchmarkLine(Stringf("  Copy deforms after the source is deleted %s", GetBenchmarkCheckString(result.m_doesCopyOutliveSource)));
+	PrintBenchmarkLine(Stringf("  Rigid binding on one copy leaves the others unchanged %s", GetBenchmarkCheckString(result.m_isRigidBindingPerCopy)));
+	PrintBenchmarkLine(Stringf("  Copies of the same binding share its precompute %s", GetBenchmarkCheckString(result.m_isPrecomputeSharedPerBinding)));
+	PrintBenchmarkLine(Stringf("  A precompute through one copy deforms the others again %s", GetBenchmarkCheckString(result.m_doesPrecomputeRedeformCopies)));
+	return result.m_doesCopyOutliveSource && result.m_isRigidBindingPerCopy && result.m_isPrecomputeSharedPerBinding && result.m_doesPrecomputeRedeformCopies;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+class JobSystem;
+
+struct DDMModifierSharingTestResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	bool m_doesCopyOutliveSource = false;	//A copy deforms bit identically to the deleted source, and the modifier and mesh asset go away with the last copy
+	bool m_isRigidBindingPerCopy = false;	//One copy going rigid leaves the precompute and the deformation of the others as they were
+	bool m_isPrecomputeSharedPerBinding = false;	//A second copy going rigid reuses the first one's rigid precompute
+	bool m_doesPrecomputeRedeformCopies = false;	//Precomputing a shared modifier again through one copy makes the others deform every control point again
+};
+
+//The precompute benchmark's tube with its DDM modifiers, copied the way FBXModel::CreateCopy does, then the source deleted and the copies deformed on their own
+DDMModifierSharingTestResult RunDDMModifierSharingTest(JobSystem& jobSystem, int numControlPoints, int numJoints, unsigned int seed);
+
+bool Command_DDMModifierSharingTest(EventArgs& args);	//Deletes the source model then deforms its copies, and toggles rigid binding on one of them
@@ -0,0 +1,532 @@
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXControlPoint.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include "ThirdParty/igl/cotmatrix.h"
+#include "ThirdParty/igl/adjacency_matrix.h"
+#include "ThirdParty/igl/sum.h"
+#include <algorithm>
+
+typedef Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> DDMSmoothingSolver;
+
+static constexpr int SOLVE_PARALLEL_FOR_GRAIN_SIZE = 2;	//Right hand side columns per chunk at the very least. Every column is a full pass over the factor
+static constexpr int CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE = 32;
+
+//Solves (smoothingMatrix^numIterations) * X = inOutColumns in place. The columns are independent, so chunks of them are solved on different threads
+static void SolveColumnsInParallel(JobSystem& jobSystem, const DDMSmoothingSolver& ldltSolver, int numIterations, Eigen::MatrixXd& inOutColumns)
+{
+	jobSystem.ParallelForRange(0, (int)inOutColumns.cols(), SOLVE_PARALLEL_FOR_GRAIN_SIZE, [&](int beginColIdx, int endColIdx) {
+		Eigen::MatrixXd columns = inOutColumns.middleCols(beginColIdx, endColIdx - beginColIdx);
+		for (int iter = 0; iter < numIterations; iter++) {
+			columns = ldltSolver.solve(columns);
+		}
+		inOutColumns.middleCols(beginColIdx, endColIdx - beginColIdx) = columns;
+	});
+}
+
+static void FactorizeSmoothingMatrix(DDMSmoothingSolver& ldltSolver, const Eigen::SparseMatrix<double>& smoothingMatrix, const char* matrixName)
+{
+	ldltSolver.factorize(smoothingMatrix);
+	if (ldltSolver.info() != Eigen::Success) {
+		ERROR_AND_DIE(Stringf("Couldn't factorize %s", matrixName));
+	}
+}
+
+static void ComputeAdjacencyLaplacian(const Eigen::MatrixX3i& faces, Eigen::SparseMatrix<double>& outLaplacian)
+{
+	outLaplacian.setZero();
+	igl::adjacency_matrix(faces, outLaplacian);
+	Eigen::SparseVector<double> rowSum(outLaplacian.rows());
+	rowSum.setZero();
+	igl::sum(outLaplacian, 1, rowSum);
+
+	Eigen::SparseMatrix<double> rowSumDiagonal(rowSum.size(), rowSum.size());
+	rowSumDiagonal.setZero();
+	for (int i = 0; i < rowSum.size(); ++i) {
+		rowSumDiagonal.coeffRef(i, i) = rowSum.coeff(i);
+	}
+	outLaplacian = rowSumDiagonal - outLaplacian;
+	if (FBXDDMModifier::DoesMatrixHaveNans(outLaplacian)) {
+		ERROR_AND_DIE("Adjancency matrix based laplacian cannot have nans!");
+	}
+}
+
+void ComputeDDMNormalizedLaplacian(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, bool useCotangentLaplacian, Eigen::SparseMatrix<double>& outNormalizedLaplacian)
+{
+	Eigen::SparseMatrix<double> laplacian;
+	laplacian.setZero();
+	if (useCotangentLaplacian) {
+		igl::cotmatrix(restPositions, faces, laplacian);
+
+		laplacian = -laplacian;	//Have to make it a positive semidefinite matrix! (igl makes it negative semidefinite)
+		if (FBXDDMModifier::DoesMatrixHaveNans(laplacian)) {
+			ERROR_RECOVERABLE("cotWeightedLaplacian has Nans. Using adjacency matrices instead!");
+			ComputeAdjacencyLaplacian(faces, laplacian);
+		}
+	}
+	else {
+		ComputeAdjacencyLaplacian(faces, laplacian);
+	}
+
+	//Calculate L_bar
+	Eigen::SparseMatrix<double> laplDiagonalInv(laplacian.rows(), laplacian.cols());
+	laplDiagonalInv.setZero();
+	for (int k = 0; k < laplacian.outerSize(); ++k) {
+		for (Eigen::SparseMatrix<double>::InnerIterator it(laplacian, k); it; ++it) {
+			if ((it.row() == it.col()) && (it.value() != 0.0)) {
+				laplDiagonalInv.insert(it.row(), it.col()) = 1.0 / it.value();
+			}
+		}
+	}
+	outNormalizedLaplacian = (laplacian * laplDiagonalInv);	//Order might be switched
+	if (FBXDDMModifier::DoesMatrixHaveNans(outNormalizedLaplacian)) {
+		ERROR_AND_DIE("normalizedLaplacian has Nans");
+	}
+}
+
+void GetDDMSkinWeightsArrays(const DDMSkinWeights& weights, std::vector<int>& outRowStarts, std::vector<int>& outJointIndices, std::vector<double>& outWeights)
+{
+	DDMSkinWeights compressedWeights;
+	const DDMSkinWeights* rowsSource = &weights;
+	if (!weights.isCompressed()) {
+		compressedWeights = weights;
+		compressedWeights.makeCompressed();
+		rowsSource = &compressedWeights;
+	}
+	Eigen::Index numWeights = rowsSource->nonZeros();
+	outRowStarts.assign(rowsSource->outerIndexPtr(), rowsSource->outerIndexPtr() + rowsSource->rows() + 1);
+	outJointIndices.assign(rowsSource->innerIndexPtr(), rowsSource->innerIndexPtr() + numWeights);
+	outWeights.assign(rowsSource->valuePtr(), rowsSource->valuePtr() + numWeights);
+}
+
+DDMSkinWeights GetDDMSkinWeightsFromArrays(int numControlPoints, int numJoints, int numWeights, const int* rowStarts, const int* jointIndices, const double* weights)
+{
+	GUARANTEE_OR_DIE(rowStarts[0] == 0 && rowStarts[numControlPoints] == numWeights, "Skin weight row starts don't cover the weights");
+	return DDMSkinWeights(Eigen::Map<const DDMSkinWeights>(numControlPoints, numJoints, numWeights, rowStarts, jointIndices, weights));
+}
+
+template<typename DerivedA, typename DerivedB>
+static bool AreMatricesEqual(const Eigen::MatrixBase<DerivedA>& a, const Eigen::MatrixBase<DerivedB>& b)
+{
+	return a.rows() == b.rows() && a.cols() == b.cols() && a == b;
+}
+
+DDMSkinWeights GetDDMSkinWeights(const std::vector<FBXControlPoint*>& controlPoints, int numJoints, bool isRigidBinding)
+{
+	int numControlPoints = (int)controlPoints.size();
+	DDMSkinWeights weights(numControlPoints, numJoints);
+	size_t numPairs = 0;
+	for (const FBXControlPoint* controlPoint : controlPoints) {
+		GUARANTEE_OR_DIE(controlPoint != nullptr, "controlPoint == nullptr");
+		numPairs += isRigidBinding ? std::min(controlPoint->m_jointWeightPairs.size(), (size_t)1) : controlPoint->m_jointWeightPairs.size();
+	}
+	weights.reserve((Eigen::Index)numPairs);
+
+	std::vector<JointWeightPair> sortedPairs;
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		const std::vector<JointWeightPair>& jointWeightPairs = controlPoints[ctrlPointIdx]->m_jointWeightPairs;
+		sortedPairs.clear();
+		for (const JointWeightPair& jointWeightPair : jointWeightPairs) {
+			GUARANTEE_OR_DIE(jointWeightPair.m_jointIndex < (unsigned int)numJoints, "Joint index of a joint weight pair out of range");
+			if (!isRigidBinding) {
+				sortedPairs.push_back(jointWeightPair);
+			}
+			else if (sortedPairs.empty() || sortedPairs[0].m_weight < jointWeightPair.m_weight) {
+				sortedPairs.assign(1, jointWeightPair);	//The first of equal largest weights, like FBXMesh::GetMaxInfluenceJointWeightPair
+			}
+		}
+		std::stable_sort(sortedPairs.begin(), sortedPairs.end(), [](const JointWeightPair& a, const JointWeightPair& b) { return a.m_jointIndex < b.m_jointIndex; });
+
+		weights.startVec(ctrlPointIdx);
+		for (size_t pairIdx = 0; pairIdx < sortedPairs.size(); pairIdx++) {
+			bool isOverwritten = pairIdx + 1 < sortedPairs.size() && sortedPairs[pairIdx + 1].m_jointIndex == sortedPairs[pairIdx].m_jointIndex;
+			if (!isOverwritten && sortedPairs[pairIdx].m_weight != 0.0f) {
+				weights.insertBack(ctrlPointIdx, (Eigen::Index)sortedPairs[pairIdx].m_jointIndex) = (double)sortedPairs[pairIdx].m_weight;
+			}
+		}
+	}
+	weights.finalize();
+	return weights;
+}
+
+//Same pattern and values, explicit zeros included
+static bool AreSparseColumnsEqual(const Eigen::SparseMatrix<double>& a, const Eigen::SparseMatrix<double>& b, int colIdx)
+{
+	Eigen::SparseMatrix<double>::InnerIterator bIter(b, colIdx);
+	for (Eigen::SparseMatrix<double>::InnerIterator aIter(a, colIdx); aIter; ++aIter, ++bIter) {
+		if (!bIter || aIter.index() != bIter.index() || aIter.value() != bIter.value()) {
+			return false;
+		}
+	}
+	return !bIter;
+}
+
+void DDMPrecomputeState::Update(JobSystem& jobSystem, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights,
+	const DDMPrecomputeParameters& parameters, DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix, DDMPrecomputeStageTimings* outTimings)
+{
+	int numControlPoints = (int)restPositions.rows();
+	int numJoints = (int)weights.cols();
+	if (weights.rows() != numControlPoints) {
+		ERROR_AND_DIE("weightsMatrix #rows and m_controlPointsMatrixRestPose #rows should be the same");
+	}
+	DDMPrecomputeStageTimings timings;
+
+	//Anything about the mesh itself changing means starting over
+	double startTime = GetCurrentTimeSeconds();
+	bool isMeshChanged = IsEmpty() || parameters.m_useCotangentLaplacian != m_parameters.m_useCotangentLaplacian || numJoints != m_weightColumns.cols()
+		|| !AreMatricesEqual(restPositions, m_restPositions) || !AreMatricesEqual(faces, m_faces);
+	if (isMeshChanged) {
+		Clear();
+		m_restPositions = restPositions;
+		m_faces = faces;
+		ComputeDDMNormalizedLaplacian(restPositions, faces, parameters.m_useCotangentLaplacian, m_normalizedLaplacian);
+
+		//I + kappa * L_bar and I + lambda * L_bar have the same pattern (kappa can be 0, but Eigen keeps explicit zeros), so the ordering and elimination tree serve both factorizations
+		Eigen::SparseMatrix<double> identity(m_normalizedLaplacian.rows(), m_normalizedLaplacian.cols());
+		identity.setIdentity();
+		Eigen::SparseMatrix<double> smoothingPattern = (identity + m_normalizedLaplacian).transpose();
+		m_ldltSolver.analyzePattern(smoothingPattern);
+
+		//Next is u_k * u_k^T
+		m_UxUCached.resize(numControlPoints, 10);
+		for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+			Eigen::Matrix<double, 1, 4> affineCtrlPoint(restPositions(ctrlPointIdx, 0), restPositions(ctrlPointIdx, 1), restPositions(ctrlPointIdx, 2), 1.0);
+			Eigen::Matrix<double, 4, 4> u_k_x_u_k_transpose = (affineCtrlPoint.transpose() * affineCtrlPoint);
+			m_UxUCached.row(ctrlPointIdx) = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(u_k_x_u_k_transpose);
+		}
+		m_weightsPrimeMatrix.resize(numControlPoints, numJoints);
+		m_Psi9Matrix.resize(numControlPoints, numJoints);
+		m_jointPsiCtrlPointIndices.resize(numJoints);
+		m_jointPsis.resize(numJoints);
+		m_isJointPsiValid.assign(numJoints, 0);
+	}
+	timings.m_didReuseLaplacian = !isMeshChanged;
+	timings.m_laplacianSeconds = GetCurrentTimeSeconds() - startTime;
+
+	std::vector<int> allJoints(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		allJoints[jointIdx] = jointIdx;
+	}
+	Eigen::SparseMatrix<double> weightColumns = weights;
+	weightColumns.makeCompressed();
+	std::vector<int> changedJoints;
+	if (isMeshChanged) {
+		changedJoints = allJoints;
+	}
+	else {
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			if (!AreSparseColumnsEqual(m_weightColumns, weightColumns, jointIdx)) {
+				changedJoints.push_back(jointIdx);
+			}
+		}
+	}
+	bool areIterationsChanged = isMeshChanged || parameters.m_numLaplacianIterations != m_parameters.m_numLaplacianIterations;
+	bool isWeightsPrimeChanged = areIterationsChanged || parameters.m_kappa != m_parameters.m_kappa;
+	bool isPsiChanged = areIterationsChanged || parameters.m_lambda != m_parameters.m_lambda;
+	m_weightColumns.swap(weightColumns);
+	m_parameters = parameters;
+
+	//Skip calculating C^(-p) directly and get the W' matrix iteratively
+	startTime = GetCurrentTimeSeconds();
+	const std::vector<int>& weightsPrimeJoints = isWeightsPrimeChanged ? allJoints : changedJoints;
+	if (!weightsPrimeJoints.empty()) {
+		FactorizeSmoothingMatrix(parameters.m_kappa);
+		SolveWeightColumns(jobSystem, weightsPrimeJoints, m_weightsPrimeMatrix);
+		if (FBXDDMModifier::DoesMatrixHaveNans(m_weightsPrimeMatrix)) {
+			ERROR_AND_DIE("weightsPrimeMatrix has Nans");
+		}
+	}
+	timings.m_numSmoothedWeightColumns = (int)weightsPrimeJoints.size();
+	timings.m_smoothedWeightsSeconds = GetCurrentTimeSeconds() - startTime;
+
+	//P only sees the weights through their sum per control point
+	startTime = GetCurrentTimeSeconds();
+	Eigen::VectorXd rowWeightSums(numControlPoints);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		double rowWeightSum = 0.0;
+		for (DDMSkinWeights::InnerIterator weightIter(weights, ctrlPointIdx); weightIter; ++weightIter) {
+			rowWeightSum += weightIter.value();
+		}
+		rowWeightSums(ctrlPointIdx) = rowWeightSum;
+	}
+	if (isPsiChanged || !AreMatricesEqual(rowWeightSums, m_rowWeightSums)) {
+		FactorizeSmoothingMatrix(parameters.m_lambda);
+		ComputePMatrix(jobSystem, rowWeightSums);
+		m_rowWeightSums = rowWeightSums;
+	}
+	timings.m_pMatrixSeconds = GetCurrentTimeSeconds() - startTime;
+
+	//u_k * u_k^T has a 1 in entry 9, so Psi_9 of every joint is one solve of its weights. The Psi blocks solved for those joints are stale now
+	startTime = GetCurrentTimeSeconds();
+	const std::vector<int>& psiJoints = isPsiChanged ? allJoints : changedJoints;
+	if (!psiJoints.empty()) {
+		FactorizeSmoothingMatrix(parameters.m_lambda);
+		SolveWeightColumns(jobSystem, psiJoints, m_Psi9Matrix);
+		for (int jointIdx : psiJoints) {
+			m_isJointPsiValid[jointIdx] = 0;
+		}
+	}
+	ComputeOmegas(jobSystem, outOmegas, timings);
+	timings.m_omegasSeconds = GetCurrentTimeSeconds() - startTime;
+
+	outV1ConstantMatrix = m_v1ConstantMatrix;
+	if (outTimings) {
+		*outTimings = timings;
+	}
+}
+
+void DDMPrecomputeState::Clear()
+{
+	m_restPositions.resize(0, 3);
+	m_faces.resize(0, 3);
+	m_weightColumns = Eigen::SparseMatrix<double>();
+	m_rowWeightSums.resize(0);
+	m_parameters = DDMPrecomputeParameters();
+	m_normalizedLaplacian = Eigen::SparseMatrix<double>();
+	m_factorizedLaplacianScale = -1.0;
+	m_UxUCached.resize(0, 10);
+	m_weightsPrimeMatrix.resize(0, 0);
+	m_PMatrix.resize(0, 10);
+	m_v1ConstantMatrix.resize(0, 0);
+	m_Psi9Matrix.resize(0, 0);
+	m_jointPsiCtrlPointIndices.clear();
+	m_jointPsis.clear();
+	m_isJointPsiValid.clear();
+}
+
+size_t DDMPrecomputeState::GetNumBytes() const
+{
+	size_t numBytes = (size_t)(m_restPositions.size() + m_rowWeightSums.size() + m_UxUCached.size() + m_weightsPrimeMatrix.size() + m_PMatrix.size()
+		+ m_v1ConstantMatrix.size() + m_Psi9Matrix.size()) * sizeof(double);
+	numBytes += (size_t)m_faces.size() * sizeof(int);
+	numBytes += (size_t)m_normalizedLaplacian.nonZeros() * (sizeof(double) + sizeof(int));
+	numBytes += (size_t)m_weightColumns.nonZeros() * (sizeof(double) + sizeof(int)) + (size_t)(m_weightColumns.outerSize() + 1) * sizeof(int);
+	if (m_factorizedLaplacianScale >= 0.0) {
+		numBytes += (size_t)m_ldltSolver.matrixL().nestedExpression().nonZeros() * (sizeof(double) + sizeof(int));
+	}
+	for (int jointIdx = 0; jointIdx < (int)m_jointPsis.size(); jointIdx++) {
+		numBytes += m_jointPsiCtrlPointIndices[jointIdx].size() * sizeof(int) + m_jointPsis[jointIdx].size() * sizeof(double);
+	}
+	return numBytes;
+}
+
+void DDMPrecomputeState::FactorizeSmoothingMatrix(double laplacianScale)
+{
+	if (laplacianScale == m_factorizedLaplacianScale) {
+		return;
+	}
+	Eigen::SparseMatrix<double> identity(m_normalizedLaplacian.rows(), m_normalizedLaplacian.cols());
+	identity.setIdentity();
+	Eigen::SparseMatrix<double> smoothingMatrix = (identity + laplacianScale * m_normalizedLaplacian).transpose();
+	m_ldltSolver.factorize(smoothingMatrix);
+	if (m_ldltSolver.info() != Eigen::Success) {
+		ERROR_AND_DIE(Stringf("Couldn't factorize I + %.3lf * L_bar", laplacianScale));
+	}
+	m_factorizedLaplacianScale = laplacianScale;
+}
+
+void DDMPrecomputeState::SolveWeightColumns(JobSystem& jobSystem, const std::vector<int>& jointIndices, Eigen::MatrixXd& inOutSolvedColumns) const
+{
+	Eigen::MatrixXd columns = Eigen::MatrixXd::Zero(m_weightColumns.rows(), (Eigen::Index)jointIndices.size());
+	for (int i = 0; i < (int)jointIndices.size(); i++) {
+		for (Eigen::SparseMatrix<double>::InnerIterator weightIter(m_weightColumns, jointIndices[i]); weightIter; ++weightIter) {
+			columns(weightIter.index(), i) = weightIter.value();
+		}
+	}
+	SolveColumnsInParallel(jobSystem, m_ldltSolver, m_parameters.m_numLaplacianIterations, columns);
+	for (int i = 0; i < (int)jointIndices.size(); i++) {
+		inOutSolvedColumns.col(jointIndices[i]) = columns.col(i);
+	}
+}
+
+void DDMPrecomputeState::ComputePMatrix(JobSystem& jobSystem, const Eigen::VectorXd& rowWeightSums)
+{
+	int numControlPoints = (int)m_UxUCached.rows();
+
+	//P only needs the Psi blocks summed over the joints. The solve is linear, so that is one 10 column solve of u_k * u_k^T scaled by the summed weights
+	Eigen::MatrixXd PsiSumMatrix = m_UxUCached.array().colwise() * rowWeightSums.array();
+	SolveColumnsInParallel(jobSystem, m_ldltSolver, m_parameters.m_numLaplacianIterations, PsiSumMatrix);
+	if (FBXDDMModifier::DoesMatrixHaveNans(PsiSumMatrix)) {
+		ERROR_AND_DIE("PsiSumMatrix has Nans");
+	}
+
+	m_PMatrix.resize(numControlPoints, 10);	//This corresponds to the matrix [p_i * p_i^T, p_i // p_i^T, 1] in the paper
+	m_v1ConstantMatrix.resize(numControlPoints, 6);
+	jobSystem.ParallelForRange(0, numControlPoints, CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCtrlPointIdx, int endCtrlPointIdx) {
+		for (int ctrlPointIndex = beginCtrlPointIdx; ctrlPointIndex < endCtrlPointIdx; ctrlPointIndex++) {
+			const auto& psiSum = PsiSumMatrix.row(ctrlPointIndex);
+			Eigen::Matrix<double, 3, 1> p_i(psiSum(3), psiSum(6), psiSum(8));
+			Eigen::Matrix<double, 3, 3> P_i;
+			P_i << psiSum(0), psiSum(1), psiSum(2),
+				psiSum(1), psiSum(4), psiSum(5),
+				psiSum(2), psiSum(5), psiSum(7);
+			double normalizerValue = psiSum(9);
+			if (normalizerValue == 0.0) {
+				ERROR_AND_DIE("Have to deal with this situation where normalizerValue is 0.0f!");
+			}
+			p_i /= normalizerValue;
+			P_i /= normalizerValue;
+
+			Eigen::Matrix<double, 4, 4> p_i_matrix;
+			p_i_matrix.block(0, 0, 3, 3) = p_i * p_i.transpose();
+			p_i_matrix.block(0, 3, 3, 1) = p_i;
+			p_i_matrix.block(3, 0, 1, 3) = p_i.transpose();
+			p_i_matrix(3, 3) = 1.0;
+			m_PMatrix.row(ctrlPointIndex) = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(p_i_matrix);
+
+			//For variant1 precomputation...
+			Eigen::Matrix<double, 3, 3> P_i_matrix = P_i;
+			P_i_matrix = P_i_matrix - (p_i * p_i.transpose());
+			if (FBXDDMModifier::DoesMatrixHaveNans<double>(P_i_matrix)) {
+				ERROR_AND_DIE("P_i_matrix_preNormalization has Nans");
+			}
+			if (P_i_matrix.determinant() != 0.0) {
+				P_i_matrix = P_i_matrix / P_i_matrix.determinant();
+			}
+			else {
+				double regularization_constant = 1e-6;	//Adding a small regularization constant to avoid singularity
+				P_i_matrix += P_i_matrix + regularization_constant * Eigen::Matrix<double, 3, 3>::Identity();
+				if (P_i_matrix.determinant() == 0.0) {
+					ERROR_AND_DIE("Need to add a bigger regularization constant!");
+				}
+				P_i_matrix = P_i_matrix / P_i_matrix.determinant();
+			}
+			if (FBXDDMModifier::DoesMatrixHaveNans<double>(P_i_matrix)) {
+				ERROR_AND_DIE("P_i_matrix_postNormalization has Nans");
+			}
+			m_v1ConstantMatrix.row(ctrlPointIndex) = FBXDDMModifier::GetUpperTriangleOfSymmetric3x3Matrix(P_i_matrix);
+		}
+	});
+}
+
+void DDMPrecomputeState::ComputeOmegas(JobSystem& jobSystem, DDMSparseOmegas& outOmegas, DDMPrecomputeStageTimings& inOutTimings)
+{
+	int numControlPoints = (int)m_UxUCached.rows();
+	int numJoints = (int)m_weightColumns.cols();
+	double alpha = m_parameters.m_alpha;
+	double omegaEpsilon = m_parameters.m_omegaEpsilon;
+
+	//Entry 9 of an omega block is (1 - alpha) * Psi_9 + alpha * w'_ij * 1, the smoothed weight of the joint. It decides which blocks are kept
+	Eigen::MatrixXd omegaWeightsMatrix = ((1.0 - alpha) * m_Psi9Matrix) + (alpha * m_weightsPrimeMatrix);
+
+	//Control points get their influences, then every joint gets the list of influences it has to fill in
+	std::vector<int> numInfluencesPerControlPoint(numControlPoints);
+	jobSystem.ParallelForRange(0, numControlPoints, CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCtrlPointIdx, int endCtrlPointIdx) {
+		std::vector<double> omegaWeights(numJoints);
+		std::vector<int> influencingJoints;
+		for (int ctrlPointIdx = beginCtrlPointIdx; ctrlPointIdx < endCtrlPointIdx; ctrlPointIdx++) {
+			Eigen::Map<Eigen::RowVectorXd>(omegaWeights.data(), numJoints) = omegaWeightsMatrix.row(ctrlPointIdx);
+			DDMSparseOmegas::GetInfluencingJoints(omegaWeights.data(), numJoints, omegaEpsilon, influencingJoints);
+			numInfluencesPerControlPoint[ctrlPointIdx] = (int)influencingJoints.size();
+		}
+	});
+	outOmegas.Resize(numJoints, numInfluencesPerControlPoint);
+
+	std::vector<int> influenceJointIndices(outOmegas.GetNumInfluences());
+	jobSystem.ParallelForRange(0, numControlPoints, CONTROL_POINT_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCtrlPointIdx, int endCtrlPointIdx) {
+		std::vector<double> omegaWeights(numJoints);
+		std::vector<int> influencingJoints;
+		for (int ctrlPointIdx = beginCtrlPointIdx; ctrlPointIdx < endCtrlPointIdx; ctrlPointIdx++) {
+			Eigen::Map<Eigen::RowVectorXd>(omegaWeights.data(), numJoints) = omegaWeightsMatrix.row(ctrlPointIdx);
+			DDMSparseOmegas::GetInfluencingJoints(omegaWeights.data(), numJoints, omegaEpsilon, influencingJoints);
+			std::copy(influencingJoints.begin(), influencingJoints.end(), influenceJointIndices.begin() + outOmegas.GetFirstInfluenceIdx(ctrlPointIdx));
+		}
+	});
+
+	std::vector<int> firstJointInfluenceIndices(numJoints + 1, 0);	//CSR by joint of (control point, influence) pairs
+	for (int jointIdx : influenceJointIndices) {
+		firstJointInfluenceIndices[jointIdx + 1]++;
+	}
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		firstJointInfluenceIndices[jointIdx + 1] += firstJointInfluenceIndices[jointIdx];
+	}
+	std::vector<int> jointInfluenceCtrlPointIndices(influenceJointIndices.size());
+	std::vector<int> jointInfluenceIndices(influenceJointIndices.size());
+	std::vector<int> nextJointInfluenceIndices(firstJointInfluenceIndices.begin(), firstJointInfluenceIndices.end() - 1);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		for (int influenceIdx = outOmegas.GetFirstInfluenceIdx(ctrlPointIdx); influenceIdx < outOmegas.GetFirstInfluenceIdx(ctrlPointIdx + 1); influenceIdx++) {
+			int& nextIdx = nextJointInfluenceIndices[influenceJointIndices[influenceIdx]];
+			jointInfluenceCtrlPointIndices[nextIdx] = ctrlPointIdx;
+			jointInfluenceIndices[nextIdx] = influenceIdx;
+			nextIdx++;
+		}
+	}
+
+	//A joint's Psi blocks are reused when every control point it influences now already had them solved. Otherwise it is its own 9 column solve (entry 9 is known already).
+	//Joints that influence nothing are skipped
+	std::vector<unsigned char> doesJointNeedPsi(numJoints, 0);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		const int* beginCtrlPointIdx = jointInfluenceCtrlPointIndices.data() + firstJointInfluenceIndices[jointIdx];
+		const int* endCtrlPointIdx = jointInfluenceCtrlPointIndices.data() + firstJointInfluenceIndices[jointIdx + 1];
+		const std::vector<int>& solvedCtrlPointIndices = m_jointPsiCtrlPointIndices[jointIdx];
+		bool areSolved = m_isJointPsiValid[jointIdx] && std::includes(solvedCtrlPointIndices.begin(), solvedCtrlPointIndices.end(), beginCtrlPointIdx, endCtrlPointIdx);
+		doesJointNeedPsi[jointIdx] = (beginCtrlPointIdx != endCtrlPointIdx) && !areSolved;
+		inOutTimings.m_numPsiJoints += doesJointNeedPsi[jointIdx];
+	}
+	if (inOutTimings.m_numPsiJoints > 0) {
+		FactorizeSmoothingMatrix(m_parameters.m_lambda);
+	}
+
+	jobSystem.ParallelForRange(0, numJoints, 1, [&](int beginJointIdx, int endJointIdx) {
+		Eigen::MatrixXd PsiOfJoint;
+		for (int jointIdx = beginJointIdx; jointIdx < endJointIdx; jointIdx++) {
+			int firstIdx = firstJointInfluenceIndices[jointIdx];
+			int lastIdx = firstJointInfluenceIndices[jointIdx + 1];
+			std::vector<int>& solvedCtrlPointIndices = m_jointPsiCtrlPointIndices[jointIdx];
+			std::vector<double>& solvedPsis = m_jointPsis[jointIdx];
+			if (doesJointNeedPsi[jointIdx]) {
+				PsiOfJoint.setZero(numControlPoints, 9);	//u_k * u_k^T scaled by the joint's weights, which are zero on most control points
+				for (Eigen::SparseMatrix<double>::InnerIterator weightIter(m_weightColumns, jointIdx); weightIter; ++weightIter) {
+					PsiOfJoint.row(weightIter.index()) = m_UxUCached.row(weightIter.index()).leftCols<9>() * weightIter.value();
+				}
+				for (int iter = 0; iter < m_parameters.m_numLaplacianIterations; iter++) {
+					PsiOfJoint = m_ldltSolver.solve(PsiOfJoint);
+				}
+				solvedCtrlPointIndices.assign(jointInfluenceCtrlPointIndices.begin() + firstIdx, jointInfluenceCtrlPointIndices.begin() + lastIdx);
+				solvedPsis.resize(solvedCtrlPointIndices.size() * 9);
+				for (size_t i = 0; i < solvedCtrlPointIndices.size(); i++) {
+					for (int x = 0; x < 9; x++) {
+						solvedPsis[i * 9 + x] = PsiOfJoint(solvedCtrlPointIndices[i], x);
+					}
+				}
+				m_isJointPsiValid[jointIdx] = 1;
+			}
+
+			//Both lists ascend, and the solved one holds every control point of the current one
+			size_t solvedIdx = 0;
+			for (int i = firstIdx; i < lastIdx; i++) {
+				int ctrlPointIdx = jointInfluenceCtrlPointIndices[i];
+				while (solvedCtrlPointIndices[solvedIdx] != ctrlPointIdx) {
+					solvedIdx++;
+				}
+				const double* psi = solvedPsis.data() + solvedIdx * 9;
+				const auto& pRow = m_PMatrix.row(ctrlPointIdx);
+				double weightPrime = m_weightsPrimeMatrix(ctrlPointIdx, jointIdx);
+				double currentOmega[DDMSparseOmegas::NUM_OMEGA_FLOATS];
+				for (int x = 0; x < 9; x++) {
+					currentOmega[x] = ((1.0 - alpha) * psi[x]) + (alpha * weightPrime * pRow(x));
+				}
+				currentOmega[DDMSparseOmegas::OMEGA_WEIGHT_IDX] = omegaWeightsMatrix(ctrlPointIdx, jointIdx);
+				outOmegas.SetInfluence(jointInfluenceIndices[i], jointIdx, currentOmega);
+			}
+		}
+	});
+}
+
+void ComputeDDMPrecompute(JobSystem& jobSystem, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights,
+	bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha, double omegaEpsilon,
+	DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix, DDMPrecomputeStageTimings* outTimings)
+{
+	DDMPrecomputeParameters parameters;
+	parameters.m_useCotangentLaplacian = useCotangentLaplacian;
+	parameters.m_numLaplacianIterations = numLaplacianIterations;
+	parameters.m_lambda = lambda;
+	parameters.m_kappa = kappa;
+	parameters.m_alpha = alpha;
+	parameters.m_omegaEpsilon = omegaEpsilon;
+	DDMPrecomputeState state;
+	state.Update(jobSystem, restPositions, faces, weights, parameters, outOmegas, outV1ConstantMatrix, outTimings);
+}
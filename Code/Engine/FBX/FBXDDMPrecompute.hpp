@@ -0,0 +1,99 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMSparseOmegas.hpp"
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+#include <Eigen/Dense>
+#include <vector>
+
+class JobSystem;
+struct FBXControlPoint;
+
+//The math behind FBXDDMModifier::Precompute, kept apart from FBXMesh so it can run on any mesh (benchmarks, cache tests)
+
+typedef Eigen::SparseMatrix<double, Eigen::RowMajor> DDMSkinWeights;	//numControlPoints x numJoints skin weights in compressed rows, a handful per control point
+
+//One row per control point from its joint weight pairs. When a joint shows up twice the last pair wins. isRigidBinding keeps only the largest weight of every control point,
+//the way FBXMesh::SetRigidBinding binds the vertices. Zero weights are not stored
+DDMSkinWeights GetDDMSkinWeights(const std::vector<FBXControlPoint*>& controlPoints, int numJoints, bool isRigidBinding);
+
+//The compressed rows of skin weights as plain arrays (FBXCookedModel) and back. outRowStarts gets numControlPoints + 1 entries
+void GetDDMSkinWeightsArrays(const DDMSkinWeights& weights, std::vector<int>& outRowStarts, std::vector<int>& outJointIndices, std::vector<double>& outWeights);
+DDMSkinWeights GetDDMSkinWeightsFromArrays(int numControlPoints, int numJoints, int numWeights, const int* rowStarts, const int* jointIndices, const double* weights);
+
+struct DDMPrecomputeParameters {
+	bool m_useCotangentLaplacian = true;
+	int m_numLaplacianIterations = 1;
+	double m_lambda = 0.5;
+	double m_kappa = 0.1;
+	double m_alpha = 0.5;
+	double m_omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON;
+};
+
+struct DDMPrecomputeStageTimings {
+	double m_laplacianSeconds = 0.0;
+	double m_smoothedWeightsSeconds = 0.0;	//Factorizing I + kappa * L_bar and solving for W'
+	double m_pMatrixSeconds = 0.0;	//Factorizing I + lambda * L_bar, then the Psi blocks summed over the joints and the P matrix and v1 constants built from them
+	double m_omegasSeconds = 0.0;	//Picking the influences and solving Psi per joint for them
+
+	//What an incremental update had to redo
+	bool m_didReuseLaplacian = false;
+	int m_numSmoothedWeightColumns = 0;	//Columns of W' solved
+	int m_numPsiJoints = 0;	//Joints whose Psi blocks were solved
+
+	double GetTotalSeconds() const { return m_laplacianSeconds + m_smoothedWeightsSeconds + m_pMatrixSeconds + m_omegasSeconds; };
+};
+
+//L_bar of the paper. Falls back to the adjacency matrix based Laplacian when the cotangent weights have Nans
+void ComputeDDMNormalizedLaplacian(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, bool useCotangentLaplacian, Eigen::SparseMatrix<double>& outNormalizedLaplacian);
+
+//Keeps the Laplacian, its symbolic factorization and the intermediate results of the last Update around, so the next Update only redoes what its changes reach:
+//- alpha or the omega epsilon: only the omegas are combined again. Psi blocks are solved only for joints that gained influences
+//- kappa: W' is solved again with the same symbolic factorization
+//- lambda or the iteration count: everything but the Laplacian
+//- some weight columns: W' and Psi of those joints, plus P when the weight sums of the control points changed
+//Results are bit identical to an Update on an empty state
+class DDMPrecomputeState {
+public:
+	DDMPrecomputeState() = default;
+	DDMPrecomputeState(const DDMPrecomputeState& copyFrom) = delete;
+	DDMPrecomputeState& operator=(const DDMPrecomputeState& copyFrom) = delete;
+
+	void Update(JobSystem& jobSystem, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights, const DDMPrecomputeParameters& parameters,
+		DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix, DDMPrecomputeStageTimings* outTimings = nullptr);
+	void Clear();
+	bool IsEmpty() const { return m_restPositions.rows() == 0; };
+	size_t GetNumBytes() const;
+
+private:
+	void FactorizeSmoothingMatrix(double laplacianScale);	//I + laplacianScale * L_bar. Only the numeric part, the pattern is analyzed once per mesh
+	void SolveWeightColumns(JobSystem& jobSystem, const std::vector<int>& jointIndices, Eigen::MatrixXd& inOutSolvedColumns) const;	//Columns of m_weightColumns
+	void ComputePMatrix(JobSystem& jobSystem, const Eigen::VectorXd& rowWeightSums);
+	void ComputeOmegas(JobSystem& jobSystem, DDMSparseOmegas& outOmegas, DDMPrecomputeStageTimings& inOutTimings);
+
+	//Inputs of the last Update
+	Eigen::MatrixX3d m_restPositions;
+	Eigen::MatrixX3i m_faces;
+	Eigen::SparseMatrix<double> m_weightColumns;	//Column major, the solves go joint by joint
+	Eigen::VectorXd m_rowWeightSums;
+	DDMPrecomputeParameters m_parameters;
+
+	Eigen::SparseMatrix<double> m_normalizedLaplacian;
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> m_ldltSolver;
+	double m_factorizedLaplacianScale = -1.0;	//Which smoothing matrix m_ldltSolver holds. Negative when none
+	Eigen::Matrix<double, Eigen::Dynamic, 10> m_UxUCached;
+	Eigen::MatrixXd m_weightsPrimeMatrix;
+	Eigen::Matrix<double, Eigen::Dynamic, 10> m_PMatrix;
+	Eigen::MatrixXd m_v1ConstantMatrix;
+	Eigen::MatrixXd m_Psi9Matrix;	//Entry 9 of every Psi block, one column per joint
+
+	//Entries 0 to 8 of the Psi blocks of each joint, only for the control points it influenced when they were solved (ascending)
+	std::vector<std::vector<int>> m_jointPsiCtrlPointIndices;
+	std::vector<std::vector<double>> m_jointPsis;
+	std::vector<unsigned char> m_isJointPsiValid;
+};
+
+//Update on a fresh DDMPrecomputeState. Both smoothing matrices share the sparsity pattern of L_bar, so the symbolic factorization is done once.
+//Right hand sides are solved in column blocks on the job system, and Psi is solved joint by joint straight into the omegas of that joint, so the n x 10m Psi matrix never exists
+void ComputeDDMPrecompute(JobSystem& jobSystem, const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights,
+	bool useCotangentLaplacian, int numLaplacianIterations, double lambda, double kappa, double alpha, double omegaEpsilon,
+	DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix, DDMPrecomputeStageTimings* outTimings = nullptr);
@@ -0,0 +1,243 @@
+#include "Engine/Fbx/FBXDDMPrecomputeCache.hpp"
+#include "Engine/Fbx/FBXCacheHasher.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/MemoryMappedFile.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+
+static constexpr char DDM_PRECOMPUTE_CACHE_MAGIC[4] = { 'D', 'D', 'M', 'C' };
+
+struct DDMPrecomputeCacheHeader {
+	char m_magic[4];
+	uint32_t m_version = 0;
+	uint64_t m_key = 0;
+	int32_t m_numControlPoints = 0;
+	int32_t m_numFaces = 0;
+	int32_t m_numJoints = 0;
+	int32_t m_numInfluences = 0;
+	int32_t m_numV1Constants = 0;	//Per control point
+	int32_t m_numLaplacianIterations = 0;
+	uint32_t m_useCotangentLaplacian = 0;
+	uint32_t m_padding = 0;
+	double m_lambda = 0.0;
+	double m_kappa = 0.0;
+	double m_alpha = 0.0;
+	double m_omegaEpsilon = 0.0;
+	uint64_t m_payloadNumBytes = 0;
+	uint64_t m_payloadChecksum = 0;
+};
+static_assert(sizeof(DDMPrecomputeCacheHeader) == 96, "The header is written as is, so it can't have compiler dependent padding");
+
+//Byte offsets of the sections after the header. The sections start 8 byte aligned so the mapped data could be read in place
+struct DDMPrecomputeCacheLayout {
+	size_t m_firstInfluenceIndicesOffset = 0;
+	size_t m_jointIndicesOffset = 0;
+	size_t m_omegasOffset = 0;
+	size_t m_v1ConstantsOffset = 0;
+	size_t m_numBytes = 0;
+};
+
+static size_t AlignTo8Bytes(size_t numBytes)
+{
+	return (numBytes + 7) & ~(size_t)7;
+}
+
+static DDMPrecomputeCacheLayout GetDDMPrecomputeCacheLayout(size_t numControlPoints, size_t numInfluences, size_t numV1Constants)
+{
+	DDMPrecomputeCacheLayout layout;
+	layout.m_firstInfluenceIndicesOffset = 0;
+	layout.m_jointIndicesOffset = AlignTo8Bytes(layout.m_firstInfluenceIndicesOffset + (numControlPoints + 1) * sizeof(int32_t));
+	layout.m_omegasOffset = AlignTo8Bytes(layout.m_jointIndicesOffset + numInfluences * sizeof(int32_t));
+	layout.m_v1ConstantsOffset = AlignTo8Bytes(layout.m_omegasOffset + numInfluences * DDMSparseOmegas::NUM_OMEGA_FLOATS * sizeof(float));
+	layout.m_numBytes = layout.m_v1ConstantsOffset + numControlPoints * numV1Constants * sizeof(double);
+	return layout;
+}
+
+//The parameters bit for bit, a tweak in the last digit is another precompute
+static bool DoesDDMPrecomputeCacheHeaderMatch(const DDMPrecomputeCacheHeader& header, const DDMPrecomputeCacheInputs& inputs)
+{
+	const DDMPrecomputeParameters& parameters = inputs.m_parameters;
+	return header.m_numControlPoints == inputs.m_numControlPoints && header.m_numFaces == inputs.m_numFaces && header.m_numJoints == inputs.m_numJoints
+		&& header.m_numLaplacianIterations == parameters.m_numLaplacianIterations && header.m_useCotangentLaplacian == (uint32_t)parameters.m_useCotangentLaplacian
+		&& memcmp(&header.m_lambda, &parameters.m_lambda, sizeof(double)) == 0 && memcmp(&header.m_kappa, &parameters.m_kappa, sizeof(double)) == 0
+		&& memcmp(&header.m_alpha, &parameters.m_alpha, sizeof(double)) == 0 && memcmp(&header.m_omegaEpsilon, &parameters.m_omegaEpsilon, sizeof(double)) == 0;
+}
+
+DDMPrecomputeCacheInputs GetDDMPrecomputeCacheInputs(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights, const DDMPrecomputeParameters& parameters)
+{
+	DDMPrecomputeCacheInputs inputs;
+	inputs.m_numControlPoints = (int)restPositions.rows();
+	inputs.m_numFaces = (int)faces.rows();
+	inputs.m_numJoints = (int)weights.cols();
+	inputs.m_parameters = parameters;
+	return inputs;
+}
+
+uint64_t GetDDMPrecomputeCacheKey(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights, const DDMPrecomputeParameters& parameters)
+{
+	FBXCacheHasher hasher;
+	hasher.AppendValue(DDM_PRECOMPUTE_CACHE_VERSION);
+	hasher.AppendValue((int64_t)restPositions.rows());
+	hasher.Append(restPositions.data(), restPositions.size() * sizeof(double));
+	hasher.AppendValue((int64_t)faces.rows());
+	hasher.Append(faces.data(), faces.size() * sizeof(int));
+	hasher.AppendValue((int64_t)weights.rows());
+	hasher.AppendValue((int64_t)weights.cols());
+	for (int ctrlPointIdx = 0; ctrlPointIdx < (int)weights.rows(); ctrlPointIdx++) {	//Works on uncompressed matrices too
+		hasher.AppendValue((int64_t)-1);
+		for (DDMSkinWeights::InnerIterator weightIter(weights, ctrlPointIdx); weightIter; ++weightIter) {
+			hasher.AppendValue((int64_t)weightIter.index());
+			hasher.AppendValue(weightIter.value());
+		}
+	}
+	hasher.AppendValue((uint8_t)parameters.m_useCotangentLaplacian);
+	hasher.AppendValue(parameters.m_numLaplacianIterations);
+	hasher.AppendValue(parameters.m_lambda);
+	hasher.AppendValue(parameters.m_kappa);
+	hasher.AppendValue(parameters.m_alpha);
+	hasher.AppendValue(parameters.m_omegaEpsilon);
+	return hasher.GetHash();
+}
+
+std::string GetDDMPrecomputeCacheFilePath(const std::string& cacheDirectory, uint64_t key)
+{
+	return Stringf("%s/%016llx.ddmcache", cacheDirectory.c_str(), (unsigned long long)key);
+}
+
+bool SaveDDMPrecomputeCache(const std::string& filePath, uint64_t key, const DDMPrecomputeCacheInputs& inputs, const DDMSparseOmegas& omegas, const Eigen::MatrixXd& v1ConstantMatrix,
+	std::string* errorStr)
+{
+	int numControlPoints = omegas.GetNumControlPoints();
+	if (v1ConstantMatrix.rows() != numControlPoints) {
+		if (errorStr) {
+			*errorStr = Stringf("omegas have %d control points whereas v1ConstantMatrix has %d rows", numControlPoints, (int)v1ConstantMatrix.rows());
+		}
+		return false;
+	}
+	if (numControlPoints != inputs.m_numControlPoints || omegas.GetNumJoints() != inputs.m_numJoints) {
+		if (errorStr) {
+			*errorStr = Stringf("omegas have %d control points and %d joints whereas the inputs have %d and %d", numControlPoints, omegas.GetNumJoints(),
+				inputs.m_numControlPoints, inputs.m_numJoints);
+		}
+		return false;
+	}
+
+	DDMPrecomputeCacheHeader header;
+	memcpy(header.m_magic, DDM_PRECOMPUTE_CACHE_MAGIC, sizeof(header.m_magic));
+	header.m_version = DDM_PRECOMPUTE_CACHE_VERSION;
+	header.m_key = key;
+	header.m_numControlPoints = numControlPoints;
+	header.m_numFaces = inputs.m_numFaces;
+	header.m_numJoints = omegas.GetNumJoints();
+	header.m_numInfluences = omegas.GetNumInfluences();
+	header.m_numV1Constants = (int32_t)v1ConstantMatrix.cols();
+	header.m_numLaplacianIterations = inputs.m_parameters.m_numLaplacianIterations;
+	header.m_useCotangentLaplacian = (uint32_t)inputs.m_parameters.m_useCotangentLaplacian;
+	header.m_lambda = inputs.m_parameters.m_lambda;
+	header.m_kappa = inputs.m_parameters.m_kappa;
+	header.m_alpha = inputs.m_parameters.m_alpha;
+	header.m_omegaEpsilon = inputs.m_parameters.m_omegaEpsilon;
+	DDMPrecomputeCacheLayout layout = GetDDMPrecomputeCacheLayout(numControlPoints, header.m_numInfluences, header.m_numV1Constants);
+	header.m_payloadNumBytes = layout.m_numBytes;
+
+	std::vector<uint8_t> buffer(sizeof(DDMPrecomputeCacheHeader) + layout.m_numBytes, 0);
+	uint8_t* payload = buffer.data() + sizeof(DDMPrecomputeCacheHeader);
+	memcpy(payload + layout.m_firstInfluenceIndicesOffset, omegas.GetFirstInfluenceIndices().data(), omegas.GetFirstInfluenceIndices().size() * sizeof(int32_t));
+	memcpy(payload + layout.m_jointIndicesOffset, omegas.GetJointIndices().data(), omegas.GetJointIndices().size() * sizeof(int32_t));
+	memcpy(payload + layout.m_omegasOffset, omegas.GetOmegas().data(), omegas.GetOmegas().size() * sizeof(float));
+	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> v1ConstantsRowMajor = v1ConstantMatrix;	//Each control point's constants together
+	memcpy(payload + layout.m_v1ConstantsOffset, v1ConstantsRowMajor.data(), v1ConstantsRowMajor.size() * sizeof(double));
+
+	FBXCacheHasher checksumHasher;
+	checksumHasher.Append(payload, layout.m_numBytes);
+	header.m_payloadChecksum = checksumHasher.GetHash();
+	memcpy(buffer.data(), &header, sizeof(DDMPrecomputeCacheHeader));
+
+	std::error_code errorCode;
+	std::filesystem::path parentPath = std::filesystem::path(filePath).parent_path();
+	if (!parentPath.empty()) {
+		std::filesystem::create_directories(parentPath, errorCode);
+	}
+	std::string tempFilePath = filePath + ".tmp";
+	if (!FileWriteFromBuffer(buffer, tempFilePath)) {
+		if (errorStr) {
+			*errorStr = Stringf("Unable to write %s", tempFilePath.c_str());
+		}
+		return false;
+	}
+	std::remove(filePath.c_str());
+	if (std::rename(tempFilePath.c_str(), filePath.c_str()) != 0) {
+		std::remove(tempFilePath.c_str());
+		if (errorStr) {
+			*errorStr = Stringf("Unable to rename %s to %s", tempFilePath.c_str(), filePath.c_str());
+		}
+		return false;
+	}
+	return true;
+}
+
+bool LoadDDMPrecomputeCache(const std::string& filePath, uint64_t key, const DDMPrecomputeCacheInputs& inputs, DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix,
+	std::string* errorStr)
+{
+	auto fail = [errorStr](const std::string& error) {
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+
+	MemoryMappedFile file;
+	if (!file.Open(filePath)) {
+		return fail(Stringf("No cache file %s", filePath.c_str()));
+	}
+	if (file.GetSize() < sizeof(DDMPrecomputeCacheHeader)) {
+		return fail("File is smaller than the header");
+	}
+
+	DDMPrecomputeCacheHeader header;
+	memcpy(&header, file.GetData(), sizeof(DDMPrecomputeCacheHeader));
+	if (memcmp(header.m_magic, DDM_PRECOMPUTE_CACHE_MAGIC, sizeof(header.m_magic)) != 0) {
+		return fail("Not a DDM precompute cache file");
+	}
+	if (header.m_version != DDM_PRECOMPUTE_CACHE_VERSION) {
+		return fail(Stringf("Cache version is %u whereas the current version is %u", header.m_version, DDM_PRECOMPUTE_CACHE_VERSION));
+	}
+	if (header.m_key != key) {
+		return fail("Cache key doesn't match");
+	}
+	if (!DoesDDMPrecomputeCacheHeaderMatch(header, inputs)) {
+		return fail(Stringf("Cache was computed from %d control points, %d faces and %d joints whereas the mesh has %d, %d and %d, or with other parameters",
+			header.m_numControlPoints, header.m_numFaces, header.m_numJoints, inputs.m_numControlPoints, inputs.m_numFaces, inputs.m_numJoints));
+	}
+	if (header.m_numControlPoints < 0 || header.m_numJoints < 0 || header.m_numInfluences < 0 || header.m_numV1Constants < 0) {
+		return fail("Negative counts in the header");
+	}
+	DDMPrecomputeCacheLayout layout = GetDDMPrecomputeCacheLayout(header.m_numControlPoints, header.m_numInfluences, header.m_numV1Constants);
+	if (header.m_payloadNumBytes != layout.m_numBytes || file.GetSize() != sizeof(DDMPrecomputeCacheHeader) + layout.m_numBytes) {
+		return fail(Stringf("File is %llu bytes whereas the header describes %llu bytes", (unsigned long long)file.GetSize(),
+			(unsigned long long)(sizeof(DDMPrecomputeCacheHeader) + layout.m_numBytes)));
+	}
+
+	const uint8_t* payload = file.GetData() + sizeof(DDMPrecomputeCacheHeader);
+	FBXCacheHasher checksumHasher;
+	checksumHasher.Append(payload, layout.m_numBytes);
+	if (checksumHasher.GetHash() != header.m_payloadChecksum) {
+		return fail("Payload checksum doesn't match");
+	}
+
+	std::vector<int> firstInfluenceIndices((size_t)header.m_numControlPoints + 1);
+	std::vector<int> jointIndices(header.m_numInfluences);
+	std::vector<float> omegas((size_t)header.m_numInfluences * DDMSparseOmegas::NUM_OMEGA_FLOATS);
+	memcpy(firstInfluenceIndices.data(), payload + layout.m_firstInfluenceIndicesOffset, firstInfluenceIndices.size() * sizeof(int32_t));
+	memcpy(jointIndices.data(), payload + layout.m_jointIndicesOffset, jointIndices.size() * sizeof(int32_t));
+	memcpy(omegas.data(), payload + layout.m_omegasOffset, omegas.size() * sizeof(float));
+	if (!outOmegas.Assign(header.m_numJoints, std::move(firstInfluenceIndices), std::move(jointIndices), std::move(omegas))) {
+		return fail("Inconsistent omega rows");
+	}
+
+	const double* v1Constants = reinterpret_cast<const double*>(payload + layout.m_v1ConstantsOffset);
+	outV1ConstantMatrix = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(v1Constants, header.m_numControlPoints, header.m_numV1Constants);
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMSparseOmegas.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include <Eigen/Dense>
+#include <string>
+#include <cstdint>
+
+//On disk cache of FBXDDMModifier::Precompute results (the omegas and the v1 constants).
+//Files are named after a hash of everything Precompute reads, so a changed mesh or parameter simply misses instead of loading stale data
+
+constexpr uint32_t DDM_PRECOMPUTE_CACHE_VERSION = 4;	//Bump whenever the file layout or what Precompute produces changes
+
+//The sizes and parameters Precompute ran with. The header keeps them and a load checks them, so even two meshes whose keys collide can't swap results
+struct DDMPrecomputeCacheInputs {
+	int m_numControlPoints = 0;
+	int m_numFaces = 0;
+	int m_numJoints = 0;
+	DDMPrecomputeParameters m_parameters;
+};
+
+DDMPrecomputeCacheInputs GetDDMPrecomputeCacheInputs(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights, const DDMPrecomputeParameters& parameters);
+uint64_t GetDDMPrecomputeCacheKey(const Eigen::MatrixX3d& restPositions, const Eigen::MatrixX3i& faces, const DDMSkinWeights& weights, const DDMPrecomputeParameters& parameters);
+std::string GetDDMPrecomputeCacheFilePath(const std::string& cacheDirectory, uint64_t key);
+
+//Writes to a temporary file first and renames it, so a crash never leaves a half written cache behind
+bool SaveDDMPrecomputeCache(const std::string& filePath, uint64_t key, const DDMPrecomputeCacheInputs& inputs, const DDMSparseOmegas& omegas, const Eigen::MatrixXd& v1ConstantMatrix,
+	std::string* errorStr = nullptr);
+//Maps the file and checks the header, its inputs, the section sizes and the payload checksum before copying anything out. Outputs are untouched on failure
+bool LoadDDMPrecomputeCache(const std::string& filePath, uint64_t key, const DDMPrecomputeCacheInputs& inputs, DDMSparseOmegas& outOmegas, Eigen::MatrixXd& outV1ConstantMatrix,
+	std::string* errorStr = nullptr);
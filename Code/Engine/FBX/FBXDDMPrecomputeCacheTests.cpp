@@ -0,0 +1,202 @@
+#include "Engine/Fbx/FBXDDMPrecomputeCacheTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMPrecomputeCache.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <filesystem>
+
+bool Command_DDMPrecomputeCacheTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("100000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("50")).c_str());
+	std::string cacheDirectory = args.GetValue("Directory", std::string("Data/Cache/DDMTest"));
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+	GUARANTEE_OR_DIE(numControlPoints > 0 && numJoints > 0, "DDMPrecomputeCacheTest needs positive NumControlPoints and NumJoints");
+
+	//Stand ins for what Precompute produces. The cache doesn't care where the numbers came from
+	RandomNumberGenerator rng(seed);
+	std::vector<Mat44> jointTransforms = GetSyntheticJointTransforms(numJoints, rng);
+	std::vector<float> jointTransformsFloats;
+	ConvertJointTransformsToFloats(jointTransforms, jointTransformsFloats);
+	SyntheticDDMMesh mesh = GetSyntheticMesh(numControlPoints, numJoints, rng);
+	DDMSparseOmegas omegas;
+	BuildSyntheticOmegas(mesh, numControlPoints, DDMSparseOmegas::DEFAULT_EPSILON, omegas);
+	Eigen::MatrixXd v1ConstantMatrix(numControlPoints, 6);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		for (int constantIdx = 0; constantIdx < 6; constantIdx++) {
+			v1ConstantMatrix(ctrlPointIdx, constantIdx) = (double)rng.RollRandomFloatInRange(-1.0f, 1.0f);
+		}
+	}
+	Eigen::MatrixX3i facesMatrix(numControlPoints / 3, 3);
+	for (int faceIdx = 0; faceIdx < (int)facesMatrix.rows(); faceIdx++) {
+		facesMatrix.row(faceIdx) = Eigen::RowVector3i(3 * faceIdx, 3 * faceIdx + 1, 3 * faceIdx + 2);
+	}
+	DDMSkinWeights weightsMatrix = Eigen::MatrixXd::Constant(numControlPoints, numJoints, 1.0 / (double)numJoints).sparseView();
+	DDMPrecomputeParameters parameters;
+	parameters.m_useCotangentLaplacian = true;
+	parameters.m_numLaplacianIterations = 3;
+	parameters.m_lambda = 0.5;
+	parameters.m_kappa = 0.1;
+	parameters.m_alpha = 0.5;
+	parameters.m_omegaEpsilon = DDMSparseOmegas::DEFAULT_EPSILON;
+	DDMPrecomputeParameters otherAlphaParameters = parameters;
+	otherAlphaParameters.m_alpha = 0.6;
+	Eigen::MatrixX3d mirroredRestPositions = mesh.m_restPositions;
+	mirroredRestPositions.col(0) = -mirroredRestPositions.col(0);
+	DDMPrecomputeCacheInputs inputs = GetDDMPrecomputeCacheInputs(mesh.m_restPositions, facesMatrix, weightsMatrix, parameters);
+	uint64_t key = GetDDMPrecomputeCacheKey(mesh.m_restPositions, facesMatrix, weightsMatrix, parameters);
+	uint64_t otherAlphaKey = GetDDMPrecomputeCacheKey(mesh.m_restPositions, facesMatrix, weightsMatrix, otherAlphaParameters);
+	uint64_t mirroredKey = GetDDMPrecomputeCacheKey(mirroredRestPositions, facesMatrix, weightsMatrix, parameters);
+	std::string filePath = GetDDMPrecomputeCacheFilePath(cacheDirectory, key);
+
+	BenchmarkCheckList report;
+	PrintBenchmarkLine(Stringf("DDMPrecomputeCacheTest: %d control points, %d joints, %s", numControlPoints, numJoints, filePath.c_str()));
+	report.Check("A parameter change changes the key", key != otherAlphaKey);
+	report.Check("A mesh mirrored in x changes the key", key != mirroredKey);
+
+	std::string errorStr;
+	double startTime = GetCurrentTimeSeconds();
+	bool hasSaved = SaveDDMPrecomputeCache(filePath, key, inputs, omegas, v1ConstantMatrix, &errorStr);
+	double saveSeconds = GetCurrentTimeSeconds() - startTime;
+	report.Check("Save", hasSaved);
+	if (!hasSaved) {
+		PrintBenchmarkLine("  " + errorStr);
+		return false;
+	}
+
+	DDMSparseOmegas loadedOmegas;
+	Eigen::MatrixXd loadedV1ConstantMatrix;
+	startTime = GetCurrentTimeSeconds();
+	bool hasLoaded = LoadDDMPrecomputeCache(filePath, key, inputs, loadedOmegas, loadedV1ConstantMatrix, &errorStr);
+	double loadSeconds = GetCurrentTimeSeconds() - startTime;
+	report.Check("Load", hasLoaded);
+	if (hasLoaded) {
+		report.Check("Omegas are bit identical", loadedOmegas.GetNumJoints() == omegas.GetNumJoints() && loadedOmegas.GetMaxNumInfluencesPerControlPoint() == omegas.GetMaxNumInfluencesPerControlPoint()
+			&& AreVectorsBitIdentical(loadedOmegas.GetFirstInfluenceIndices(), omegas.GetFirstInfluenceIndices())
+			&& AreVectorsBitIdentical(loadedOmegas.GetJointIndices(), omegas.GetJointIndices()) && AreVectorsBitIdentical(loadedOmegas.GetOmegas(), omegas.GetOmegas()));
+		report.Check("v1 constants are bit identical", loadedV1ConstantMatrix.rows() == v1ConstantMatrix.rows() && loadedV1ConstantMatrix.cols() == v1ConstantMatrix.cols()
+			&& memcmp(loadedV1ConstantMatrix.data(), v1ConstantMatrix.data(), (size_t)v1ConstantMatrix.size() * sizeof(double)) == 0);
+
+		DDMControlPointPackets packets;
+		packets.Build(omegas, mesh.m_restPositions);
+		DDMControlPointPackets loadedPackets;
+		loadedPackets.Build(loadedOmegas, mesh.m_restPositions);
+		std::vector<float> deformedPositions((size_t)numControlPoints * 3);
+		std::vector<float> loadedDeformedPositions((size_t)numControlPoints * 3);
+		DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+		ComputeDDMv0DeformedControlPoints(packets, jointTransformsFloats.data(), 0, packets.GetNumPackets(), deformedPositions.data(), 3, 1, simdLevel);
+		ComputeDDMv0DeformedControlPoints(loadedPackets, jointTransformsFloats.data(), 0, loadedPackets.GetNumPackets(), loadedDeformedPositions.data(), 3, 1, simdLevel);
+		report.Check("Deformations are bit identical", AreVectorsBitIdentical(deformedPositions, loadedDeformedPositions));
+	}
+	else {
+		PrintBenchmarkLine("  " + errorStr);
+	}
+
+	//Every way a file can go stale or bad has to miss instead of loading garbage
+	report.Check("Wrong key misses", !LoadDDMPrecomputeCache(filePath, otherAlphaKey, inputs, loadedOmegas, loadedV1ConstantMatrix));
+	//A key collision alone must not hand out another mesh's precompute, so the header inputs are checked too
+	DDMPrecomputeCacheInputs otherLambdaInputs = inputs;
+	otherLambdaInputs.m_parameters.m_lambda = 0.6;
+	report.Check("Same key, other lambda misses", !LoadDDMPrecomputeCache(filePath, key, otherLambdaInputs, loadedOmegas, loadedV1ConstantMatrix));
+	DDMPrecomputeCacheInputs otherFacesInputs = inputs;
+	otherFacesInputs.m_numFaces++;
+	report.Check("Same key, other face count misses", !LoadDDMPrecomputeCache(filePath, key, otherFacesInputs, loadedOmegas, loadedV1ConstantMatrix));
+	std::vector<uint8_t> fileBuffer;
+	FileReadToBuffer(fileBuffer, filePath);
+	std::string corruptFilePath = filePath + ".corrupt";
+	std::vector<uint8_t> truncatedBuffer(fileBuffer.begin(), fileBuffer.begin() + fileBuffer.size() / 2);
+	FileWriteFromBuffer(truncatedBuffer, corruptFilePath);
+	report.Check("Truncated file misses", !LoadDDMPrecomputeCache(corruptFilePath, key, inputs, loadedOmegas, loadedV1ConstantMatrix));
+	std::vector<uint8_t> flippedBuffer = fileBuffer;
+	flippedBuffer[flippedBuffer.size() - 1] ^= 0x01;
+	FileWriteFromBuffer(flippedBuffer, corruptFilePath);
+	report.Check("Flipped payload byte misses", !LoadDDMPrecomputeCache(corruptFilePath, key, inputs, loadedOmegas, loadedV1ConstantMatrix));
+	std::vector<uint8_t> otherVersionBuffer = fileBuffer;
+	otherVersionBuffer[4] ^= 0xFF;	//The version follows the 4 byte magic
+	FileWriteFromBuffer(otherVersionBuffer, corruptFilePath);
+	report.Check("Other version misses", !LoadDDMPrecomputeCache(corruptFilePath, key, inputs, loadedOmegas, loadedV1ConstantMatrix));
+
+	const double bytesToMB = 1.0 / (1024.0 * 1024.0);
+	PrintBenchmarkLine(Stringf("  %.1lf MB file, save %.3lf ms, load %.3lf ms", (double)fileBuffer.size() * bytesToMB, saveSeconds * 1000.0, loadSeconds * 1000.0));
+
+	std::error_code errorCode;
+	std::filesystem::remove(filePath, errorCode);
+	std::filesystem::remove(corruptFilePath, errorCode);
+	return report.m_hasPassed;
+}
+
+static bool AreMatricesBitIdentical(const Eigen::MatrixX3f& a, const Eigen::MatrixX3f& b)
+{
+	return a.rows() == b.rows() && memcmp(a.data(), b.data(), (size_t)a.size() * sizeof(float)) == 0;
+}
+
+DDMPrecomputeCacheRoundTripTestResult RunDDMPrecomputeCacheRoundTripTest(JobSystem& jobSystem, int numControlPoints, int numJoints, const std::string& cacheDirectory, unsigned int seed)
+{
+	GUARANTEE_OR_DIE(numControlPoints > 0 && numJoints > 1, "RunDDMPrecomputeCacheRoundTripTest needs control points and at least 2 joints");
+	DDMPrecomputeCacheRoundTripTestResult result;
+	result.m_numJoints = numJoints;
+
+	//A file an earlier run left would make the first Precompute a hit too
+	std::error_code errorCode;
+	std::filesystem::remove_all(cacheDirectory, errorCode);
+	std::string precomputeCacheDirectory = FBXDDMModifier::GetPrecomputeCacheDirectory();
+	FBXDDMModifier::SetPrecomputeCacheDirectory(cacheDirectory);
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	std::vector<Vertex_FBX> renderVertices;
+	std::shared_ptr<const FBXMeshAsset> meshAsset = GetSyntheticFBXMeshAsset(jobSystem, mesh, numJoints, renderVertices);
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	RandomNumberGenerator rng(seed);
+	std::vector<Mat44> jointTransforms = GetSyntheticJointTransforms(numJoints, rng);
+
+	FBXDDMModifierCPU computedModifier(meshAsset, false, numJoints);
+	double startTime = GetCurrentTimeSeconds();
+	computedModifier.Precompute(true, 8, 0.5, 0.1, 0.5);
+	result.m_computeSeconds = GetCurrentTimeSeconds() - startTime;
+	DDMModifierInstanceState computedInstanceState;
+	bool didRecalculate = false;
+	Eigen::MatrixX3f computedv0Deformed = computedModifier.GetVariantv0Deform(jointTransforms, computedInstanceState, didRecalculate);
+	computedInstanceState.SetNeedsRecalculation();
+	Eigen::MatrixX3f computedv1Deformed = computedModifier.GetVariantv1Deform(jointTransforms, computedInstanceState, didRecalculate);
+
+	//A fresh modifier of the same mesh, like the next run of the game would make
+	FBXDDMModifierCPU loadedModifier(meshAsset, false, numJoints);
+	startTime = GetCurrentTimeSeconds();
+	loadedModifier.Precompute(true, 8, 0.5, 0.1, 0.5);
+	result.m_loadSeconds = GetCurrentTimeSeconds() - startTime;
+	DDMModifierInstanceState loadedInstanceState;
+	Eigen::MatrixX3f loadedv0Deformed = loadedModifier.GetVariantv0Deform(jointTransforms, loadedInstanceState, didRecalculate);
+	loadedInstanceState.SetNeedsRecalculation();
+	Eigen::MatrixX3f loadedv1Deformed = loadedModifier.GetVariantv1Deform(jointTransforms, loadedInstanceState, didRecalculate);
+
+	result.m_didFirstPrecomputeMiss = computedModifier.DidLoadPrecomputeFromCache() == false;
+	result.m_didSecondPrecomputeHit = loadedModifier.DidLoadPrecomputeFromCache();
+	result.m_isv0DeformBitIdentical = AreMatricesBitIdentical(computedv0Deformed, loadedv0Deformed);
+	result.m_isv1DeformBitIdentical = AreMatricesBitIdentical(computedv1Deformed, loadedv1Deformed);
+
+	FBXDDMModifier::SetPrecomputeCacheDirectory(precomputeCacheDirectory);
+	std::filesystem::remove_all(cacheDirectory, errorCode);
+	return result;
+}
+
+bool Command_DDMPrecomputeCacheRoundTripTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("5000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	std::string cacheDirectory = args.GetValue("Directory", std::string("Data/Cache/DDMRoundTripTest"));
+	int seed = atoi(args.GetValue("Seed", std::string("1234")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMPrecomputeCacheRoundTripTest needs g_theJobSystem");
+	DDMPrecomputeCacheRoundTripTestResult result = RunDDMPrecomputeCacheRoundTripTest(*g_theJobSystem, std::max(numControlPoints, 64), std::max(numJoints, 2), cacheDirectory,
+		(unsigned int)seed);
+	PrintBenchmarkLine(Stringf("DDMPrecomputeCacheRoundTripTest: %d control points, %d joints, %s", result.m_numControlPoints, result.m_numJoints, cacheDirectory.c_str()));
+	PrintBenchmarkLine(Stringf("  First Precompute misses and computes (%.3lf ms) %s", result.m_computeSeconds * 1000.0, GetBenchmarkCheckString(result.m_didFirstPrecomputeMiss)));
+	PrintBenchmarkLine(Stringf("  Second Precompute hits (%.3lf ms) %s", result.m_loadSeconds * 1000.0, GetBenchmarkCheckString(result.m_didSecondPrecomputeHit)));
+	PrintBenchmarkLine(Stringf("  v0 deformations are bit identical %s", GetBenchmarkCheckString(result.m_isv0DeformBitIdentical)));
+	PrintBenchmarkLine(Stringf("  v1 deformations are bit identical %s", GetBenchmarkCheckString(result.m_isv1DeformBitIdentical)));
+	return result.m_didFirstPrecomputeMiss && result.m_didSecondPrecomputeHit && result.m_isv0DeformBitIdentical && result.m_isv1DeformBitIdentical;
+}
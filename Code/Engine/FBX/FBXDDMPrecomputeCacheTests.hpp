@@ -0,0 +1,22 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+#include <string>
+
+class JobSystem;
+
+struct DDMPrecomputeCacheRoundTripTestResult {
+	int m_numControlPoints = 0;
+	int m_numJoints = 0;
+	double m_computeSeconds = 0.0;
+	double m_loadSeconds = 0.0;
+	bool m_didFirstPrecomputeMiss = false;	//Nothing in the directory yet, so Precompute computed and saved
+	bool m_didSecondPrecomputeHit = false;	//Another modifier of the same mesh loaded what the first one saved
+	bool m_isv0DeformBitIdentical = false;
+	bool m_isv1DeformBitIdentical = false;
+};
+
+//Precomputes the precompute benchmark's tube through an empty cache directory, then again through a fresh modifier, and deforms both
+DDMPrecomputeCacheRoundTripTestResult RunDDMPrecomputeCacheRoundTripTest(JobSystem& jobSystem, int numControlPoints, int numJoints, const std::string& cacheDirectory, unsigned int seed);
+
+bool Command_DDMPrecomputeCacheTest(EventArgs& args);	//Saves and loads synthetic omegas and v1 constants, and checks that stale or damaged cache files miss
+bool Command_DDMPrecomputeCacheRoundTripTest(EventArgs& args);	//FBXDDMModifierCPU::Precompute for a miss then a hit, and the deformations of both compared bit for bit
@@ -0,0 +1,76 @@
+#include "Engine/Fbx/FBXDDMPrecomputeTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <functional>
+
+bool Command_DDMIncrementalPrecomputeTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("20000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "DDMIncrementalPrecomputeTest needs g_theJobSystem");
+	GUARANTEE_OR_DIE(numJoints >= 4, "DDMIncrementalPrecomputeTest needs at least 4 joints");
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	numControlPoints = (int)mesh.m_restPositions.rows();
+	DDMPrecomputeParameters parameters;
+	parameters.m_numLaplacianIterations = 8;
+
+	//Every step changes something on top of the previous one, the way tweaking in the editor does
+	struct Step {
+		const char* m_name;
+		std::function<void()> m_change;
+	};
+	int firstMovedCtrlPointIdx = numControlPoints / 3;
+	int lastMovedCtrlPointIdx = numControlPoints / 2;
+	int movedJointIdx = numJoints / 2;
+	std::vector<Step> steps = {
+		{ "Everything", []() {} },
+		{ "alpha 0.5 -> 0.3", [&]() { parameters.m_alpha = 0.3; } },
+		{ "alpha 0.3 -> 0.8", [&]() { parameters.m_alpha = 0.8; } },
+		{ "kappa 0.1 -> 0.2", [&]() { parameters.m_kappa = 0.2; } },
+		{ "epsilon 1e-5 -> 1e-3", [&]() { parameters.m_omegaEpsilon = 1.0e-3; } },
+		{ "epsilon 1e-3 -> 1e-5", [&]() { parameters.m_omegaEpsilon = 1.0e-5; } },
+		{ "2 joint weights moved", [&]() {
+			for (int ctrlPointIdx = firstMovedCtrlPointIdx; ctrlPointIdx < lastMovedCtrlPointIdx; ctrlPointIdx++) {
+				double movedWeight = 0.5 * mesh.m_weights(ctrlPointIdx, movedJointIdx);
+				mesh.m_weights(ctrlPointIdx, movedJointIdx) -= movedWeight;
+				mesh.m_weights(ctrlPointIdx, movedJointIdx + 1) += movedWeight;
+			}
+		} },
+		{ "1 joint weights scaled", [&]() { mesh.m_weights.col(movedJointIdx - 1) *= 1.5; } },
+		{ "lambda 0.5 -> 0.6", [&]() { parameters.m_lambda = 0.6; } },
+		{ "iterations 8 -> 6", [&]() { parameters.m_numLaplacianIterations = 6; } },
+	};
+
+	PrintBenchmarkLine(Stringf("DDMIncrementalPrecomputeTest: %d control points, %d joints", numControlPoints, numJoints));
+	bool hasPassed = true;
+	DDMPrecomputeState state;
+	for (const Step& step : steps) {
+		step.m_change();
+		DDMSparseOmegas omegas;
+		Eigen::MatrixXd v1ConstantMatrix;
+		DDMPrecomputeStageTimings timings;
+		state.Update(*g_theJobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), parameters, omegas, v1ConstantMatrix, &timings);
+
+		DDMSparseOmegas fullOmegas;
+		Eigen::MatrixXd fullV1ConstantMatrix;
+		DDMPrecomputeStageTimings fullTimings;
+		ComputeDDMPrecompute(*g_theJobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), parameters.m_useCotangentLaplacian, parameters.m_numLaplacianIterations,
+			parameters.m_lambda, parameters.m_kappa, parameters.m_alpha, parameters.m_omegaEpsilon, fullOmegas, fullV1ConstantMatrix, &fullTimings);
+
+		bool areIdentical = AreVectorsBitIdentical(omegas.GetFirstInfluenceIndices(), fullOmegas.GetFirstInfluenceIndices())
+			&& AreVectorsBitIdentical(omegas.GetJointIndices(), fullOmegas.GetJointIndices()) && AreVectorsBitIdentical(omegas.GetOmegas(), fullOmegas.GetOmegas())
+			&& v1ConstantMatrix.size() == fullV1ConstantMatrix.size()
+			&& memcmp(v1ConstantMatrix.data(), fullV1ConstantMatrix.data(), (size_t)v1ConstantMatrix.size() * sizeof(double)) == 0;
+		hasPassed = hasPassed && areIdentical;
+		PrintBenchmarkLine(Stringf("  %-22s %9.2lf ms (W' columns %2d, Psi joints %2d), from scratch %9.2lf ms (x%.1lf), bit identical %s", step.m_name, timings.GetTotalSeconds() * 1000.0,
+			timings.m_numSmoothedWeightColumns, timings.m_numPsiJoints, fullTimings.GetTotalSeconds() * 1000.0, fullTimings.GetTotalSeconds() / std::max(timings.GetTotalSeconds(), 1.0e-9),
+			GetBenchmarkCheckString(areIdentical)));
+	}
+	PrintBenchmarkLine(Stringf("  State kept for the incremental updates: %.1lf MB", (double)state.GetNumBytes() / (1024.0 * 1024.0)));
+	return hasPassed;
+}
@@ -0,0 +1,4 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+bool Command_DDMIncrementalPrecomputeTest(EventArgs& args);	//Changes the parameters and weights step by step and checks DDMPrecomputeState stays bit identical to a full precompute
@@ -0,0 +1,114 @@
+#include "Engine/Fbx/FBXDDMSparseOmegas.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <cmath>
+
+void DDMSparseOmegas::GetInfluencingJoints(const double* omegaWeights, int numJoints, double epsilon, std::vector<int>& outJointIndices)
+{
+	outJointIndices.clear();
+	int strongestJointIdx = 0;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		double absWeight = fabs(omegaWeights[jointIdx]);
+		if (absWeight > epsilon) {
+			outJointIndices.push_back(jointIdx);
+		}
+		if (absWeight > fabs(omegaWeights[strongestJointIdx])) {
+			strongestJointIdx = jointIdx;
+		}
+	}
+	if (outJointIndices.empty() && numJoints > 0) {
+		outJointIndices.push_back(strongestJointIdx);
+	}
+}
+
+size_t DDMSparseOmegas::GetNumDenseBytes(int numControlPoints, int numJoints)
+{
+	return (size_t)numControlPoints * numJoints * NUM_OMEGA_FLOATS * sizeof(double);
+}
+
+void DDMSparseOmegas::Resize(int numJoints, const std::vector<int>& numInfluencesPerControlPoint)
+{
+	m_numJoints = numJoints;
+	m_maxNumInfluencesPerControlPoint = 0;
+	m_firstInfluenceIndices.resize(numInfluencesPerControlPoint.size() + 1);
+	m_firstInfluenceIndices[0] = 0;
+	for (size_t ctrlPointIdx = 0; ctrlPointIdx < numInfluencesPerControlPoint.size(); ctrlPointIdx++) {
+		int numInfluences = numInfluencesPerControlPoint[ctrlPointIdx];
+		if (numInfluences < 0 || numInfluences > numJoints) {
+			ERROR_AND_DIE(Stringf("Control point %d has %d influences with %d joints", (int)ctrlPointIdx, numInfluences, numJoints));
+		}
+		m_firstInfluenceIndices[ctrlPointIdx + 1] = m_firstInfluenceIndices[ctrlPointIdx] + numInfluences;
+		m_maxNumInfluencesPerControlPoint = std::max(m_maxNumInfluencesPerControlPoint, numInfluences);
+	}
+	m_jointIndices.assign(m_firstInfluenceIndices.back(), 0);
+	m_omegas.assign((size_t)m_firstInfluenceIndices.back() * NUM_OMEGA_FLOATS, 0.0f);
+}
+
+void DDMSparseOmegas::SetInfluence(int influenceIdx, int jointIdx, const double* omega10)
+{
+	m_jointIndices[influenceIdx] = jointIdx;
+	float* omega = m_omegas.data() + (size_t)influenceIdx * NUM_OMEGA_FLOATS;
+	for (int i = 0; i < NUM_OMEGA_FLOATS; i++) {
+		omega[i] = (float)omega10[i];
+	}
+}
+
+bool DDMSparseOmegas::Assign(int numJoints, std::vector<int>&& firstInfluenceIndices, std::vector<int>&& jointIndices, std::vector<float>&& omegas)
+{
+	if (numJoints < 0 || firstInfluenceIndices.empty() || firstInfluenceIndices[0] != 0 || firstInfluenceIndices.back() != (int)jointIndices.size()
+		|| omegas.size() != jointIndices.size() * NUM_OMEGA_FLOATS) {
+		return false;
+	}
+	int maxNumInfluencesPerControlPoint = 0;
+	for (size_t ctrlPointIdx = 0; ctrlPointIdx + 1 < firstInfluenceIndices.size(); ctrlPointIdx++) {
+		int numInfluences = firstInfluenceIndices[ctrlPointIdx + 1] - firstInfluenceIndices[ctrlPointIdx];
+		if (numInfluences < 0 || numInfluences > numJoints) {
+			return false;
+		}
+		maxNumInfluencesPerControlPoint = std::max(maxNumInfluencesPerControlPoint, numInfluences);
+	}
+	for (int jointIdx : jointIndices) {
+		if (jointIdx < 0 || jointIdx >= numJoints) {
+			return false;
+		}
+	}
+
+	m_numJoints = numJoints;
+	m_maxNumInfluencesPerControlPoint = maxNumInfluencesPerControlPoint;
+	m_firstInfluenceIndices = std::move(firstInfluenceIndices);
+	m_jointIndices = std::move(jointIndices);
+	m_omegas = std::move(omegas);
+	return true;
+}
+
+void DDMSparseOmegas::Clear()
+{
+	m_numJoints = 0;
+	m_maxNumInfluencesPerControlPoint = 0;
+	m_firstInfluenceIndices.assign(1, 0);
+	m_jointIndices.clear();
+	m_jointIndices.shrink_to_fit();
+	m_omegas.clear();
+	m_omegas.shrink_to_fit();
+}
+
+size_t DDMSparseOmegas::GetNumBytes() const
+{
+	return (m_firstInfluenceIndices.size() + m_jointIndices.size()) * sizeof(int) + m_omegas.size() * sizeof(float);
+}
+
+Eigen::MatrixXd DDMSparseOmegas::GetDenseOmegaMatrix() const
+{
+	Eigen::MatrixXd omegaMatrix(GetNumControlPoints(), (Eigen::Index)m_numJoints * NUM_OMEGA_FLOATS);
+	omegaMatrix.setZero();
+	for (int ctrlPointIdx = 0; ctrlPointIdx < GetNumControlPoints(); ctrlPointIdx++) {
+		for (int influenceIdx = m_firstInfluenceIndices[ctrlPointIdx]; influenceIdx < m_firstInfluenceIndices[ctrlPointIdx + 1]; influenceIdx++) {
+			const float* omega = GetOmega(influenceIdx);
+			for (int i = 0; i < NUM_OMEGA_FLOATS; i++) {
+				omegaMatrix(ctrlPointIdx, NUM_OMEGA_FLOATS * m_jointIndices[influenceIdx] + i) = omega[i];
+			}
+		}
+	}
+	return omegaMatrix;
+}
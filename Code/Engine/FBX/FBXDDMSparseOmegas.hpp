@@ -0,0 +1,43 @@
+#pragma once
+#include <Eigen/Dense>
+#include <vector>
+
+//Per control point omega blocks, only for the joints that actually influence it (compressed sparse rows).
+//After the Laplacian smoothing every joint technically touches every control point, but almost all of those blocks are tiny, so they get cut off with an epsilon
+class DDMSparseOmegas {
+public:
+	static constexpr int NUM_OMEGA_FLOATS = 10;	//Upper triangle of the symmetric 4x4 block, same order as FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix
+	static constexpr int OMEGA_WEIGHT_IDX = 9;	//Entry (3, 3) of the block, which is the smoothed skinning weight of the joint
+	static constexpr double DEFAULT_EPSILON = 1e-5;
+
+	//omegaWeights[j] is the OMEGA_WEIGHT_IDX entry of joint j's block. Keeps the joints whose |weight| is above epsilon (a negative epsilon keeps every joint),
+	//or just the strongest one if none is, since Q_i gets normalized by the sum of these weights
+	static void GetInfluencingJoints(const double* omegaWeights, int numJoints, double epsilon, std::vector<int>& outJointIndices);
+	static size_t GetNumDenseBytes(int numControlPoints, int numJoints);	//Size of the n x 10m double matrix this replaces
+
+	void Resize(int numJoints, const std::vector<int>& numInfluencesPerControlPoint);	//Sets up the rows. The blocks are then filled through SetInfluence
+	void SetInfluence(int influenceIdx, int jointIdx, const double* omega10);
+	bool Assign(int numJoints, std::vector<int>&& firstInfluenceIndices, std::vector<int>&& jointIndices, std::vector<float>&& omegas);	//Takes raw rows, e.g. from the precompute cache. False if they are inconsistent
+	void Clear();
+
+	int GetNumControlPoints() const { return (int)m_firstInfluenceIndices.size() - 1; };
+	int GetNumJoints() const { return m_numJoints; };
+	int GetNumInfluences() const { return (int)m_jointIndices.size(); };
+	int GetMaxNumInfluencesPerControlPoint() const { return m_maxNumInfluencesPerControlPoint; };
+	int GetFirstInfluenceIdx(int ctrlPointIdx) const { return m_firstInfluenceIndices[ctrlPointIdx]; };
+	int GetNumInfluencesOfControlPoint(int ctrlPointIdx) const { return m_firstInfluenceIndices[ctrlPointIdx + 1] - m_firstInfluenceIndices[ctrlPointIdx]; };
+	int GetJointIdx(int influenceIdx) const { return m_jointIndices[influenceIdx]; };
+	const float* GetOmega(int influenceIdx) const { return m_omegas.data() + (size_t)influenceIdx * NUM_OMEGA_FLOATS; };
+	const std::vector<int>& GetFirstInfluenceIndices() const { return m_firstInfluenceIndices; };
+	const std::vector<int>& GetJointIndices() const { return m_jointIndices; };
+	const std::vector<float>& GetOmegas() const { return m_omegas; };
+	size_t GetNumBytes() const;
+	Eigen::MatrixXd GetDenseOmegaMatrix() const;	//n x 10m, for the CUDA kernels which still index every joint
+
+private:
+	int m_numJoints = 0;
+	int m_maxNumInfluencesPerControlPoint = 0;
+	std::vector<int> m_firstInfluenceIndices = { 0 };	//numControlPoints + 1 entries
+	std::vector<int> m_jointIndices;	//Ascending within a control point
+	std::vector<float> m_omegas;	//NUM_OMEGA_FLOATS per influence
+};
@@ -0,0 +1,212 @@
+#include "Engine/Fbx/FBXDDMVertexWriteback.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+#include <cstring>
+
+void DDMRenderVertexWriteback::Build(const std::vector<unsigned int>& renderVertexToControlPointMap, int numControlPoints)
+{
+	int numRenderVertices = (int)renderVertexToControlPointMap.size();
+	m_firstRenderVertexIndices.assign((size_t)numControlPoints + 1, 0);
+	for (int renderVertexIdx = 0; renderVertexIdx < numRenderVertices; renderVertexIdx++) {
+		unsigned int ctrlPointIdx = renderVertexToControlPointMap[renderVertexIdx];
+		GUARANTEE_OR_DIE(ctrlPointIdx < (unsigned int)numControlPoints, Stringf("Render vertex %d maps to control point %u of %d", renderVertexIdx, ctrlPointIdx, numControlPoints));
+		m_firstRenderVertexIndices[ctrlPointIdx + 1]++;
+	}
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		m_firstRenderVertexIndices[ctrlPointIdx + 1] += m_firstRenderVertexIndices[ctrlPointIdx];
+	}
+
+	//Ascending per control point, so a control point touches its render vertices front to back
+	m_renderVertexIndices.resize(numRenderVertices);
+	std::vector<int> nextIndices(m_firstRenderVertexIndices.begin(), m_firstRenderVertexIndices.end() - 1);
+	for (int renderVertexIdx = 0; renderVertexIdx < numRenderVertices; renderVertexIdx++) {
+		m_renderVertexIndices[nextIndices[renderVertexToControlPointMap[renderVertexIdx]]++] = renderVertexIdx;
+	}
+
+	m_isRenderVertexChanged.assign(numRenderVertices, 0);
+	m_isBlockDirty.assign((size_t)(numRenderVertices + DIRTY_BLOCK_SIZE - 1) / DIRTY_BLOCK_SIZE, 0);
+	m_dirtyRanges.clear();
+	m_numDeformedPackets = 0;
+}
+
+void DDMRenderVertexWriteback::Clear()
+{
+	m_firstRenderVertexIndices = { 0 };
+	m_renderVertexIndices.clear();
+	m_isRenderVertexChanged.clear();
+	m_isBlockDirty.clear();
+	m_dirtyRanges.clear();
+	m_isPacketToDeform.clear();
+	m_isJointChanged.clear();
+	m_numDeformedPackets = 0;
+}
+
+void DDMRenderVertexWriteback::WriteVariantv0(JobSystem& jobSystem, const DDMControlPointPackets& packets, const float* jointTransforms, DDMSimdLevel simdLevel, float* positions, int vertexStride,
+	const std::vector<int>* changedJointIndices)
+{
+	WritePackets(jobSystem, packets, changedJointIndices, positions, vertexStride, [&](int beginPacketIdx, int endPacketIdx, const DDMPacketPositionsWriter& writePacket) {
+		ComputeDDMv0DeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, writePacket, simdLevel);
+	});
+}
+
+void DDMRenderVertexWriteback::WriteVariantv1(JobSystem& jobSystem, const DDMControlPointPackets& packets, const float* jointTransforms, DDMSimdLevel simdLevel, float* positions, int vertexStride,
+	const std::vector<int>* changedJointIndices)
+{
+	WritePackets(jobSystem, packets, changedJointIndices, positions, vertexStride, [&](int beginPacketIdx, int endPacketIdx, const DDMPacketPositionsWriter& writePacket) {
+		ComputeDDMv1DeformedControlPoints(packets, jointTransforms, beginPacketIdx, endPacketIdx, writePacket, simdLevel);
+	});
+}
+
+void DDMRenderVertexWriteback::WriteControlPoints(JobSystem& jobSystem, const Eigen::MatrixX3f& deformedControlPoints, float* positions, int vertexStride)
+{
+	GUARANTEE_OR_DIE(deformedControlPoints.rows() == GetNumControlPoints(), "The deformed control points and the writeback are of different meshes");
+	jobSystem.ParallelForRange(0, GetNumControlPoints(), PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			float newPosition[3] = { deformedControlPoints(cpIdx, 0), deformedControlPoints(cpIdx, 1), deformedControlPoints(cpIdx, 2) };
+			WriteControlPoint(cpIdx, newPosition, positions, vertexStride);
+		}
+	});
+	UpdateDirtyRanges(jobSystem);
+}
+
+int DDMRenderVertexWriteback::GetNumDirtyRenderVertices() const
+{
+	int numDirtyRenderVertices = 0;
+	for (const IntRange& dirtyRange : m_dirtyRanges) {
+		numDirtyRenderVertices += dirtyRange.m_max - dirtyRange.m_min + 1;
+	}
+	return numDirtyRenderVertices;
+}
+
+size_t DDMRenderVertexWriteback::GetNumBytes() const
+{
+	return m_firstRenderVertexIndices.size() * sizeof(int) + m_renderVertexIndices.size() * sizeof(int) + m_isRenderVertexChanged.size() + m_isBlockDirty.size()
+		+ m_dirtyRanges.capacity() * sizeof(IntRange) + m_isPacketToDeform.capacity() + m_isJointChanged.capacity();
+}
+
+void DDMRenderVertexWriteback::WriteControlPoint(int ctrlPointIdx, const float* newPosition, float* positions, int vertexStride)
+{
+	for (int idx = m_firstRenderVertexIndices[ctrlPointIdx]; idx < m_firstRenderVertexIndices[ctrlPointIdx + 1]; idx++) {
+		int renderVertexIdx = m_renderVertexIndices[idx];
+		float* position = positions + (size_t)renderVertexIdx * vertexStride;
+		//Bitwise, so -0 and 0 count as different and what was uploaded always matches the staging vertices exactly
+		bool isChanged = memcmp(position, newPosition, 3 * sizeof(float)) != 0;
+		if (isChanged) {
+			position[0] = newPosition[0];
+			position[1] = newPosition[1];
+			position[2] = newPosition[2];
+		}
+		m_isRenderVertexChanged[renderVertexIdx] = isChanged ? 1 : 0;
+	}
+}
+
+void DDMRenderVertexWriteback::WritePacket(int firstCtrlPointIdx, int numLanes, const float* packetPositions, float* positions, int vertexStride)
+{
+	constexpr int PACKET_SIZE = DDMControlPointPackets::PACKET_SIZE;
+	for (int laneIdx = 0; laneIdx < numLanes; laneIdx++) {
+		float newPosition[3] = { packetPositions[0 * PACKET_SIZE + laneIdx], packetPositions[1 * PACKET_SIZE + laneIdx], packetPositions[2 * PACKET_SIZE + laneIdx] };
+		WriteControlPoint(firstCtrlPointIdx + laneIdx, newPosition, positions, vertexStride);
+	}
+}
+
+void DDMRenderVertexWriteback::WritePackets(JobSystem& jobSystem, const DDMControlPointPackets& packets, const std::vector<int>* changedJointIndices, float* positions, int vertexStride,
+	const std::function<void(int beginPacketIdx, int endPacketIdx, const DDMPacketPositionsWriter& writePacket)>& computePackets)
+{
+	GUARANTEE_OR_DIE(packets.GetNumControlPoints() == GetNumControlPoints(), "The packets and the writeback were built for different meshes");
+	constexpr int PACKET_SIZE = DDMControlPointPackets::PACKET_SIZE;
+	int numPackets = packets.GetNumPackets();
+	DDMPacketPositionsWriter writePacket = [&](int firstCtrlPointIdx, int numLanes, const float* packetPositions) {
+		WritePacket(firstCtrlPointIdx, numLanes, packetPositions, positions, vertexStride);
+	};
+	int grainSizeInPackets = std::max(PARALLEL_FOR_GRAIN_SIZE / PACKET_SIZE, 1);
+	if (changedJointIndices == nullptr) {
+		m_numDeformedPackets = numPackets;
+		jobSystem.ParallelForRange(0, numPackets, grainSizeInPackets, [&](int beginPacketIdx, int endPacketIdx) {
+			computePackets(beginPacketIdx, endPacketIdx, writePacket);
+		});
+		UpdateDirtyRanges(jobSystem);
+		return;
+	}
+
+	MarkPacketsToDeform(packets, *changedJointIndices);
+	jobSystem.ParallelForRange(0, numPackets, grainSizeInPackets, [&](int beginPacketIdx, int endPacketIdx) {
+		int packetIdx = beginPacketIdx;
+		while (packetIdx < endPacketIdx) {
+			//Runs of packets to deform go to the kernel in one call, the render vertices of the ones in between are left alone and cleared of the previous write's changes
+			int endRunPacketIdx = packetIdx + 1;
+			while (endRunPacketIdx < endPacketIdx && m_isPacketToDeform[endRunPacketIdx] == m_isPacketToDeform[packetIdx]) {
+				endRunPacketIdx++;
+			}
+			if (m_isPacketToDeform[packetIdx]) {
+				computePackets(packetIdx, endRunPacketIdx, writePacket);
+			}
+			else {
+				int endCtrlPointIdx = std::min(endRunPacketIdx * PACKET_SIZE, GetNumControlPoints());
+				for (int idx = m_firstRenderVertexIndices[packetIdx * PACKET_SIZE]; idx < m_firstRenderVertexIndices[endCtrlPointIdx]; idx++) {
+					m_isRenderVertexChanged[m_renderVertexIndices[idx]] = 0;
+				}
+			}
+			packetIdx = endRunPacketIdx;
+		}
+	});
+	UpdateDirtyRanges(jobSystem);
+}
+
+void DDMRenderVertexWriteback::MarkPacketsToDeform(const DDMControlPointPackets& packets, const std::vector<int>& changedJointIndices)
+{
+	int numJoints = 0;
+	for (int jointIdx : changedJointIndices) {
+		GUARANTEE_OR_DIE(jointIdx >= 0, "Negative changed joint index");
+		numJoints = std::max(numJoints, jointIdx + 1);
+	}
+	m_isJointChanged.assign(numJoints, 0);
+	for (int jointIdx : changedJointIndices) {
+		m_isJointChanged[jointIdx] = 1;
+	}
+
+	m_isPacketToDeform.assign(packets.GetNumPackets(), 0);
+	m_numDeformedPackets = 0;
+	for (int packetIdx = 0; packetIdx < packets.GetNumPackets(); packetIdx++) {
+		const int* packetJointIndices = packets.GetPacketJointIndices(packetIdx);
+		int numPacketJoints = packets.GetNumJointsOfPacket(packetIdx);
+		for (int packetJointIdx = 0; packetJointIdx < numPacketJoints; packetJointIdx++) {
+			int jointIdx = packetJointIndices[packetJointIdx];
+			if (jointIdx < numJoints && m_isJointChanged[jointIdx]) {
+				m_isPacketToDeform[packetIdx] = 1;
+				m_numDeformedPackets++;
+				break;
+			}
+		}
+	}
+}
+
+void DDMRenderVertexWriteback::UpdateDirtyRanges(JobSystem& jobSystem)
+{
+	int numRenderVertices = GetNumRenderVertices();
+	int numBlocks = (int)m_isBlockDirty.size();
+	jobSystem.ParallelForRange(0, numBlocks, 16, [&](int beginBlockIdx, int endBlockIdx) {
+		for (int blockIdx = beginBlockIdx; blockIdx < endBlockIdx; blockIdx++) {
+			int beginRenderVertexIdx = blockIdx * DIRTY_BLOCK_SIZE;
+			int endRenderVertexIdx = std::min(beginRenderVertexIdx + DIRTY_BLOCK_SIZE, numRenderVertices);
+			const unsigned char* isChanged = m_isRenderVertexChanged.data();
+			m_isBlockDirty[blockIdx] = std::any_of(isChanged + beginRenderVertexIdx, isChanged + endRenderVertexIdx, [](unsigned char isVertexChanged) { return isVertexChanged != 0; }) ? 1 : 0;
+		}
+	});
+
+	m_dirtyRanges.clear();
+	for (int blockIdx = 0; blockIdx < numBlocks; blockIdx++) {
+		if (m_isBlockDirty[blockIdx] == 0) {
+			continue;
+		}
+		int beginRenderVertexIdx = blockIdx * DIRTY_BLOCK_SIZE;
+		int lastRenderVertexIdx = std::min(beginRenderVertexIdx + DIRTY_BLOCK_SIZE, numRenderVertices) - 1;
+		if (!m_dirtyRanges.empty() && m_dirtyRanges.back().m_max + 1 == beginRenderVertexIdx) {
+			m_dirtyRanges.back().m_max = lastRenderVertexIdx;
+		}
+		else {
+			m_dirtyRanges.push_back(IntRange(beginRenderVertexIdx, lastRenderVertexIdx));
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Math/IntRange.hpp"
+#include <Eigen/Dense>
+#include <vector>
+
+class JobSystem;
+
+//Writes deformed control points straight into the positions of the render vertices, in render vertex order. The deform kernels hand over every packet
+//and the same job copies it to the render vertices of those control points, so there is no deformed control point matrix and no serial pass over the render vertices.
+//Every render vertex belongs to exactly one control point, so it is written by exactly one chunk and the result does not depend on the thread count.
+//A render vertex whose position bits changed marks its block dirty, and runs of dirty blocks become the ranges the vertex buffer update is limited to
+class DDMRenderVertexWriteback {
+public:
+	static constexpr int DIRTY_BLOCK_SIZE = 256;	//Render vertices
+	static constexpr int PARALLEL_FOR_GRAIN_SIZE = 64;	//Control points per chunk at the very least
+
+	void Build(const std::vector<unsigned int>& renderVertexToControlPointMap, int numControlPoints);
+	void Clear();
+
+	//positions: x of render vertex 0, vertexStride: floats from one render vertex to the next (sizeof(Vertex_FBX) / sizeof(float) for FBXMesh's render vertices).
+	//jointTransforms like ConvertJointTransformsToFloats.
+	//changedJointIndices: the joints whose transforms differ from the ones positions were deformed with by the previous write of the same variant and packets.
+	//Only the packets influenced by one of them are deformed again, the render vertices of the rest keep their positions and stay clean. nullptr deforms every packet
+	void WriteVariantv0(JobSystem& jobSystem, const DDMControlPointPackets& packets, const float* jointTransforms, DDMSimdLevel simdLevel, float* positions, int vertexStride,
+		const std::vector<int>* changedJointIndices = nullptr);
+	void WriteVariantv1(JobSystem& jobSystem, const DDMControlPointPackets& packets, const float* jointTransforms, DDMSimdLevel simdLevel, float* positions, int vertexStride,
+		const std::vector<int>* changedJointIndices = nullptr);
+	void WriteControlPoints(JobSystem& jobSystem, const Eigen::MatrixX3f& deformedControlPoints, float* positions, int vertexStride);	//For deformations that come back as a matrix, like the CUDA ones
+
+	int GetNumControlPoints() const { return (int)m_firstRenderVertexIndices.size() - 1; };
+	int GetNumRenderVertices() const { return (int)m_isRenderVertexChanged.size(); };
+	const std::vector<IntRange>& GetDirtyRanges() const { return m_dirtyRanges; };	//Of the last write. Inclusive like IntRange::IsOnRange, ascending, with at least one clean block in between
+	int GetNumDirtyRenderVertices() const;
+	int GetNumDeformedPackets() const { return m_numDeformedPackets; };	//By the last WriteVariantv0 or WriteVariantv1
+	size_t GetNumBytes() const;
+
+private:
+	void WriteControlPoint(int ctrlPointIdx, const float* newPosition, float* positions, int vertexStride);
+	void WritePacket(int firstCtrlPointIdx, int numLanes, const float* packetPositions, float* positions, int vertexStride);
+	void WritePackets(JobSystem& jobSystem, const DDMControlPointPackets& packets, const std::vector<int>* changedJointIndices, float* positions, int vertexStride,
+		const std::function<void(int beginPacketIdx, int endPacketIdx, const DDMPacketPositionsWriter& writePacket)>& computePackets);
+	void MarkPacketsToDeform(const DDMControlPointPackets& packets, const std::vector<int>& changedJointIndices);
+	void UpdateDirtyRanges(JobSystem& jobSystem);
+
+	std::vector<int> m_firstRenderVertexIndices = { 0 };	//numControlPoints + 1 entries. The render vertices of control point i are m_renderVertexIndices[m_firstRenderVertexIndices[i]] up to [i + 1]
+	std::vector<int> m_renderVertexIndices;
+	std::vector<unsigned char> m_isRenderVertexChanged;	//By the last write. Bytes and not bits, so two chunks never write the same memory location
+	std::vector<unsigned char> m_isBlockDirty;
+	std::vector<IntRange> m_dirtyRanges;
+	std::vector<unsigned char> m_isPacketToDeform;	//Of a partial write
+	std::vector<unsigned char> m_isJointChanged;
+	int m_numDeformedPackets = 0;
+};
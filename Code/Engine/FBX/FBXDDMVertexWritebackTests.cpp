@@ -0,0 +1,163 @@
+#include "Engine/Fbx/FBXDDMVertexWritebackTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXDDMVertexWriteback.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+
+//What FBXMesh::ApplyDDMv0_CPU did before the writeback
+static void CopyDeformedControlPointsToRenderVertices(const Eigen::MatrixX3f& deformedControlPoints, const std::vector<unsigned int>& renderVertexToControlPointMap,
+	std::vector<Vertex_FBX>& inOutRenderVertices)
+{
+	for (int i = 0; i < (int)renderVertexToControlPointMap.size(); i++) {
+		auto newCtrlPoint = deformedControlPoints.row(renderVertexToControlPointMap[i]);
+		inOutRenderVertices[i].m_position.x = newCtrlPoint[0];
+		inOutRenderVertices[i].m_position.y = newCtrlPoint[1];
+		inOutRenderVertices[i].m_position.z = newCtrlPoint[2];
+	}
+}
+
+DDMVertexWritebackTestResult RunDDMVertexWritebackTest(JobSystem& jobSystem, int numControlPoints, int numJoints, int numRepeats)
+{
+	constexpr int NUM_FACES_PER_ISLAND = 500;
+	constexpr float BEND_DEGREES = 10.0f;
+	numRepeats = std::max(numRepeats, 1);
+
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numJoints);
+	DDMVertexWritebackTestResult result;
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	result.m_numJoints = numJoints;
+
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions, &v1ConstantMatrix);
+
+	std::vector<unsigned int> renderVertexToControlPointMap;
+	GetSyntheticRenderVertexMap(mesh.m_faces, NUM_FACES_PER_ISLAND, renderVertexToControlPointMap);
+	result.m_numRenderVertices = (int)renderVertexToControlPointMap.size();
+	std::vector<Vertex_FBX> restRenderVertices((size_t)result.m_numRenderVertices);
+	for (int renderVertexIdx = 0; renderVertexIdx < result.m_numRenderVertices; renderVertexIdx++) {
+		int cpIdx = (int)renderVertexToControlPointMap[renderVertexIdx];
+		Vec3 position((float)mesh.m_restPositions(cpIdx, 0), (float)mesh.m_restPositions(cpIdx, 1), (float)mesh.m_restPositions(cpIdx, 2));
+		restRenderVertices[renderVertexIdx] = Vertex_FBX(position, Vec3(0.0f, 0.0f, 1.0f), Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+		restRenderVertices[renderVertexIdx].m_materialIdx = renderVertexIdx;	//So a write past the position would show up
+	}
+
+	DDMRenderVertexWriteback writeback;
+	writeback.Build(renderVertexToControlPointMap, result.m_numControlPoints);
+	int vertexStride = (int)(sizeof(Vertex_FBX) / sizeof(float));
+
+	//Frame 1 bends the whole chain, frame 2 only moves the top quarter of the joints on top of that, frame 3 repeats frame 2
+	std::vector<Mat44> fullPose = GetDDMSyntheticPose(mesh, BEND_DEGREES);
+	std::vector<Mat44> partialPose = fullPose;
+	std::vector<Mat44> moreBentPose = GetDDMSyntheticPose(mesh, 2.0f * BEND_DEGREES);
+	for (int jointIdx = numJoints - numJoints / 4; jointIdx < numJoints; jointIdx++) {
+		partialPose[jointIdx] = moreBentPose[jointIdx];
+	}
+	std::vector<std::vector<Mat44>> framePoses = { fullPose, partialPose, partialPose };
+
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	std::vector<float> jointTransforms;
+	Eigen::MatrixX3f deformedControlPoints(result.m_numControlPoints, 3);
+	result.m_doDirtyRangesCoverChanges = true;
+	result.m_isSamePoseClean = true;
+	result.m_doesMatrixWriteMatch = true;
+	for (int variantIdx = 0; variantIdx < 2; variantIdx++) {
+		bool isVariant1 = variantIdx == 1;
+		result.m_isBitIdentical[variantIdx] = true;
+		std::vector<Vertex_FBX> mapCopyVertices = restRenderVertices;
+		std::vector<Vertex_FBX> writebackVertices = restRenderVertices;
+		std::vector<Vertex_FBX> matrixWriteVertices = restRenderVertices;
+		std::vector<Vertex_FBX> uploadedVertices = restRenderVertices;	//What the vertex buffer would hold with only the dirty ranges uploaded
+		writeback.Build(renderVertexToControlPointMap, result.m_numControlPoints);
+		for (int frameIdx = 0; frameIdx < (int)framePoses.size(); frameIdx++) {
+			ConvertJointTransformsToFloats(framePoses[frameIdx], jointTransforms);
+			jobSystem.ParallelForRange(0, packets.GetNumPackets(), 8, [&](int beginPacketIdx, int endPacketIdx) {
+				if (isVariant1) {
+					ComputeDDMv1DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, deformedControlPoints.data(), 1, result.m_numControlPoints, simdLevel);
+				}
+				else {
+					ComputeDDMv0DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, deformedControlPoints.data(), 1, result.m_numControlPoints, simdLevel);
+				}
+			});
+			CopyDeformedControlPointsToRenderVertices(deformedControlPoints, renderVertexToControlPointMap, mapCopyVertices);
+
+			if (isVariant1) {
+				writeback.WriteVariantv1(jobSystem, packets, jointTransforms.data(), simdLevel, &writebackVertices[0].m_position.x, vertexStride);
+			}
+			else {
+				writeback.WriteVariantv0(jobSystem, packets, jointTransforms.data(), simdLevel, &writebackVertices[0].m_position.x, vertexStride);
+			}
+			result.m_isBitIdentical[variantIdx] = result.m_isBitIdentical[variantIdx] && AreRenderVerticesBitIdentical(mapCopyVertices, writebackVertices);
+			for (const IntRange& dirtyRange : writeback.GetDirtyRanges()) {
+				std::copy(writebackVertices.begin() + dirtyRange.m_min, writebackVertices.begin() + dirtyRange.m_max + 1, uploadedVertices.begin() + dirtyRange.m_min);
+			}
+			result.m_doDirtyRangesCoverChanges = result.m_doDirtyRangesCoverChanges && AreRenderVerticesBitIdentical(uploadedVertices, writebackVertices);
+			if (frameIdx == 1 && !isVariant1) {
+				result.m_numDirtyRenderVerticesPartialPose = writeback.GetNumDirtyRenderVertices();
+				result.m_numDirtyRangesPartialPose = (int)writeback.GetDirtyRanges().size();
+			}
+			if (frameIdx == 2) {
+				result.m_isSamePoseClean = result.m_isSamePoseClean && writeback.GetDirtyRanges().empty();
+			}
+
+			DDMRenderVertexWriteback matrixWriteback;
+			matrixWriteback.Build(renderVertexToControlPointMap, result.m_numControlPoints);
+			matrixWriteback.WriteControlPoints(jobSystem, deformedControlPoints, &matrixWriteVertices[0].m_position.x, vertexStride);
+			result.m_doesMatrixWriteMatch = result.m_doesMatrixWriteMatch && AreRenderVerticesBitIdentical(mapCopyVertices, matrixWriteVertices);
+		}
+
+		//Timed on the full pose from the rest pose every repeat, so every render vertex changes in both paths
+		ConvertJointTransformsToFloats(fullPose, jointTransforms);
+		for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+			mapCopyVertices = restRenderVertices;
+			double startTime = GetCurrentTimeSeconds();
+			jobSystem.ParallelForRange(0, packets.GetNumPackets(), 8, [&](int beginPacketIdx, int endPacketIdx) {
+				if (isVariant1) {
+					ComputeDDMv1DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, deformedControlPoints.data(), 1, result.m_numControlPoints, simdLevel);
+				}
+				else {
+					ComputeDDMv0DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, deformedControlPoints.data(), 1, result.m_numControlPoints, simdLevel);
+				}
+			});
+			Eigen::MatrixX3f returnedControlPoints = deformedControlPoints;
+			CopyDeformedControlPointsToRenderVertices(returnedControlPoints, renderVertexToControlPointMap, mapCopyVertices);
+			result.m_mapCopySeconds[variantIdx] += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+
+			writebackVertices = restRenderVertices;
+			startTime = GetCurrentTimeSeconds();
+			if (isVariant1) {
+				writeback.WriteVariantv1(jobSystem, packets, jointTransforms.data(), simdLevel, &writebackVertices[0].m_position.x, vertexStride);
+			}
+			else {
+				writeback.WriteVariantv0(jobSystem, packets, jointTransforms.data(), simdLevel, &writebackVertices[0].m_position.x, vertexStride);
+			}
+			result.m_writebackSeconds[variantIdx] += (GetCurrentTimeSeconds() - startTime) / (double)numRepeats;
+		}
+	}
+	return result;
+}
+
+bool Command_DDMVertexWritebackTest(EventArgs& args)
+{
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("100000")).c_str());
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("16")).c_str());
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("10")).c_str());
+
+	DDMVertexWritebackTestResult result = RunDDMVertexWritebackTest(*g_theJobSystem, numControlPoints, numJoints, numRepeats);
+	PrintBenchmarkLine(Stringf("DDMVertexWritebackTest: %d control points, %d render vertices, %d joints", result.m_numControlPoints, result.m_numRenderVertices, result.m_numJoints));
+	for (int variantIdx = 0; variantIdx < 2; variantIdx++) {
+		PrintBenchmarkLine(Stringf("  v%d: matrix and map copy %8.2lf ms, writeback %8.2lf ms, bit identical %s", variantIdx, result.m_mapCopySeconds[variantIdx] * 1000.0,
+			result.m_writebackSeconds[variantIdx] * 1000.0, GetBenchmarkCheckString(result.m_isBitIdentical[variantIdx])));
+	}
+	int numRenderVertices = std::max(result.m_numRenderVertices, 1);
+	PrintBenchmarkLine(Stringf("  Top quarter of the joints moved: %d dirty render vertices (%.1lf%%) in %d ranges, %.2lf of %.2lf MB uploaded",
+		result.m_numDirtyRenderVerticesPartialPose, 100.0 * (double)result.m_numDirtyRenderVerticesPartialPose / (double)numRenderVertices, result.m_numDirtyRangesPartialPose,
+		(double)result.m_numDirtyRenderVerticesPartialPose * sizeof(Vertex_FBX) / (1024.0 * 1024.0), (double)result.m_numRenderVertices * sizeof(Vertex_FBX) / (1024.0 * 1024.0)));
+	PrintBenchmarkLine(Stringf("  Matrix writeback %s, dirty ranges cover every change %s, same pose twice clean %s", GetBenchmarkCheckString(result.m_doesMatrixWriteMatch),
+		GetBenchmarkCheckString(result.m_doDirtyRangesCoverChanges), GetBenchmarkCheckString(result.m_isSamePoseClean)));
+	return result.m_isBitIdentical[0] && result.m_isBitIdentical[1] && result.m_doesMatrixWriteMatch && result.m_doDirtyRangesCoverChanges && result.m_isSamePoseClean;
+}
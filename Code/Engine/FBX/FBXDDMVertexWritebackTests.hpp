@@ -0,0 +1,23 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+class JobSystem;
+
+struct DDMVertexWritebackTestResult {
+	int m_numControlPoints = 0;
+	int m_numRenderVertices = 0;
+	int m_numJoints = 0;
+	bool m_isBitIdentical[2] = {};	//v0, v1: every render vertex byte for byte the same as deforming into a matrix and copying through the render vertex map
+	bool m_doesMatrixWriteMatch = false;	//WriteControlPoints, the path of the CUDA deformations
+	bool m_doDirtyRangesCoverChanges = false;	//Copying only the dirty ranges into the previous vertices gives the new ones, on every frame
+	bool m_isSamePoseClean = false;	//Deforming the same pose twice leaves no dirty range
+	int m_numDirtyRenderVerticesPartialPose = 0;	//When only the top quarter of the joints moved
+	int m_numDirtyRangesPartialPose = 0;
+	double m_mapCopySeconds[2] = {};	//Deforming into the matrix, copying it out like GetVariantv0Deform did, then the serial loop over the render vertices
+	double m_writebackSeconds[2] = {};
+};
+
+//The precompute benchmark's tube, with its control points split into render vertices along seams the way ProcessFbxMesh does for UV islands
+DDMVertexWritebackTestResult RunDDMVertexWritebackTest(JobSystem& jobSystem, int numControlPoints, int numJoints, int numRepeats);
+
+bool Command_DDMVertexWritebackTest(EventArgs& args);
@@ -69,6 +69,16 @@ void FBXJoint::SetGlobalBindPoseInverse(const FbxAMatrix& globalBindPoseInverse)
 	m_globalBindPoseInverse = ConvertFbxAMatrixToMat44(globalBindPoseInverse);
 }
 
+void FBXJoint::SetGlobalBindPose(const Mat44& globalBindPose)
+{
+	m_globalBindPose = globalBindPose;
+}
+
+void FBXJoint::SetGlobalBindPoseInverse(const Mat44& globalBindPoseInverse)
+{
+	m_globalBindPoseInverse = globalBindPoseInverse;
+}
+
 void FBXJoint::SetStencilRefForThisJoint(unsigned int stencilRef)
 {
 	m_stencilRefForThisJoint = stencilRef;
@@ -221,6 +231,11 @@ void FBXJoint::SetOriginalLocalTranslate(const FbxVector4& originalLocalTranslat
 	m_originalLocalTranslate = Vec3((float)originalLocalTranslate.mData[0], (float)originalLocalTranslate.mData[1], (float)originalLocalTranslate.mData[2]);
 }
 
+void FBXJoint::SetOriginalLocalTranslate(const Vec3& originalLocalTranslate)
+{
+	m_originalLocalTranslate = originalLocalTranslate;
+}
+
 Vec3 FBXJoint::GetOriginalLocalTranslate() const
 {
 	return m_originalLocalTranslate;
@@ -233,6 +248,11 @@ void FBXJoint::SetLocalDeltaTranslate(const Vec3& localDeltaTranslate)
 	m_isTranslationModified = true;
 }
 
+Vec3 FBXJoint::GetLocalDeltaTranslate() const
+{
+	return m_localDeltaTranslateFromTranslatorGizmo;
+}
+
 void FBXJoint::ResetLocalDeltaTranslate()
 {
 	m_model->SetDDMNeedsRecalculation();
@@ -264,6 +284,11 @@ void FBXJoint::SetOriginalLocalRotate(const FbxQuaternion& originalLocalRotate)
 	m_originalLocalRotate = Quaternion((float)originalLocalRotate.mData[3], (float)originalLocalRotate.mData[0], (float)originalLocalRotate.mData[1], (float)originalLocalRotate.mData[2]);
 }
 
+void FBXJoint::SetOriginalLocalRotate(const Quaternion& originalLocalRotate)
+{
+	m_originalLocalRotate = originalLocalRotate;
+}
+
 Quaternion FBXJoint::GetLocalDeltaRotate() const
 {
 	return m_localDeltaRotateFromRotatorGizmo;
@@ -291,13 +316,19 @@ void FBXJoint::ResetLocalDeltaRotate()
 	m_isRotationModified = false;
 }
 
-Mat44 FBXJoint::GetLocalBindPoseTransform() const
+Mat44 FBXJoint::GetLocalBindPoseTransformWithoutDeltaRotate() const
 {
 	Mat44 localTransformToReturn = Mat44::CreateTranslation3D(m_originalLocalTranslate);
 	if (m_isTranslationModified)
 		localTransformToReturn.Append(Mat44::CreateTranslation3D(m_localDeltaTranslateFromTranslatorGizmo));
 
 	localTransformToReturn.Append(m_originalLocalRotate.GetRotationMatrix());
+	return localTransformToReturn;
+}
+
+Mat44 FBXJoint::GetLocalBindPoseTransform() const
+{
+	Mat44 localTransformToReturn = GetLocalBindPoseTransformWithoutDeltaRotate();
 	if(m_isRotationModified)
 		localTransformToReturn.Append(m_localDeltaRotateFromRotatorGizmo.GetRotationMatrix());
 
@@ -420,6 +451,11 @@ Mat44 FBXJoint::GetSkinningMatrixForThisFrame() const
 	return skinningMatrix;
 }
 
+void FBXJoint::SetGlobalTransformForThisFrame(const Mat44& globalTransform)
+{
+	m_globalTransformForThisFrame = globalTransform;
+}
+
 int FBXJoint::GetNumChildJoints() const
 {
 	return (int)m_childJoints.size();
@@ -466,6 +502,11 @@ bool FBXJoint::IsRoot() const
 	return m_isRoot;
 }
 
+bool FBXJoint::IsEndJoint() const
+{
+	return m_isEndJoint;
+}
+
 void FBXJoint::GetDOFAxisSettings(bool& isXAxisDOF, bool& isYAxisDOF, bool& isZAxisDOF) const
 {
 	isXAxisDOF = m_isXAxisDOF;
@@ -27,6 +27,8 @@ public:
 	void SetGPUData(Renderer& renderer);
 	void SetGlobalBindPose(const FbxAMatrix& globalBindPose);
 	void SetGlobalBindPoseInverse(const FbxAMatrix& globalBindPoseInverse);
+	void SetGlobalBindPose(const Mat44& globalBindPose);
+	void SetGlobalBindPoseInverse(const Mat44& globalBindPoseInverse);
 	void SetStencilRefForThisJoint(unsigned int stencilRef);
 	unsigned int GetStencilRefForThisJoint() const;
 
@@ -57,6 +59,7 @@ public:
 
 	Mat44 GetGlobalTransformForThisFrame() const;
 	Mat44 GetSkinningMatrixForThisFrame() const;
+	void SetGlobalTransformForThisFrame(const Mat44& globalTransform);	//From FBXModel's flattened skeleton update
 	
 	Mat44 GetGlobalBindPose() const;
 	Mat44 GetGlobalBindPoseInverse() const;
@@ -67,8 +70,10 @@ public:
 	*/
 
 	void SetOriginalLocalTranslate(const FbxVector4& originalLocalTranslate);
+	void SetOriginalLocalTranslate(const Vec3& originalLocalTranslate);
 	Vec3 GetOriginalLocalTranslate() const;
 	void SetLocalDeltaTranslate(const Vec3& localDeltaTranslate);
+	Vec3 GetLocalDeltaTranslate() const;
 	void ResetLocalDeltaTranslate();
 	/*
 	Vec3 GetLocalDeltaTranslate() const;
@@ -77,10 +82,12 @@ public:
 
 	Quaternion GetOriginalLocalRotate() const;
 	void SetOriginalLocalRotate(const FbxQuaternion& originalLocalRotate);
+	void SetOriginalLocalRotate(const Quaternion& originalLocalRotate);
 	Quaternion GetLocalDeltaRotate() const;
 	void SetLocalDeltaRotate(const Quaternion& localDeltaTransform);
 	Quaternion GetTotalLocalRotate() const;
 	void ResetLocalDeltaRotate();
+	Mat44 GetLocalBindPoseTransformWithoutDeltaRotate() const;	//What a delta rotate gets appended to
 
 	void SetIsRoot(bool isRoot);
 	void SetIsEndJoint(bool isEndJoint);
@@ -98,6 +105,7 @@ public:
 	void SetConeSphereRadius(float newConeSphereRadius);
 
 	bool IsRoot() const;
+	bool IsEndJoint() const;
 
 	void GetDOFAxisSettings(bool& isXAxisDOF, bool& isYAxisDOF, bool& isZAxisDOF) const;
 	void SetDOFAxisSettings(bool isXAxisDOF, bool isYAxisDOF, bool isZAxisDOF);
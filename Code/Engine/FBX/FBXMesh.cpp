@@ -4,6 +4,8 @@
 #include "Engine/Fbx/FBXDDMModifierCPU.hpp"
 #include "Engine/Fbx/FBXDDMModifierGPU.hpp"
 #include "Engine/Fbx/FBXParser.hpp"
+#include "Engine/Fbx/FBXVertexDedup.hpp"
+#include "Engine/Fbx/FBXCookedModel.hpp"
 #include "Engine/FBX/FBXAnimManager.hpp"
 /*
 #include "Engine/Mesh/Face.hpp"
@@ -12,26 +14,32 @@
 #include "Engine/Mesh/MeshOperationUtils.hpp"
 */
 #include "Engine/Core/GPUMesh.hpp"
+#include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/ConstantBuffer.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 #include "Engine/Renderer/DebugRender.hpp"
 #include <map>
+#include <cstring>
 
 const int FBXMesh::MAXTEXTURENUM = 3;
+static constexpr int DDM_BAKER_SOLVE_PARALLEL_FOR_GRAIN_SIZE = 16;	//Control points. A solve is a small dense factorization
+static constexpr int RENDER_VERTEX_STRIDE_IN_FLOATS = (int)(sizeof(Vertex_FBX) / sizeof(float));	//What DDMRenderVertexWriteback steps from one m_position to the next
+static_assert(sizeof(Vertex_FBX) % sizeof(float) == 0, "DDMRenderVertexWriteback steps through the render vertices in floats");
+static constexpr int CPU_SKINNING_PARALLEL_FOR_GRAIN_SIZE = 32;	//Vertex blocks
+static constexpr int VERTEX_DEDUP_CHUNK_SIZE = 65536;	//Polygon vertices. Smaller meshes are a single chunk
 
-FBXMesh::FBXMesh(FBXParser& creatorParser, const std::string& name, int nodeIdx) : m_creatorParser(creatorParser), m_name(name), m_nodeIdx(nodeIdx)
+FBXMesh::FBXMesh(FBXParser& creatorParser, const std::string& name, int nodeIdx) : m_creatorParser(creatorParser), m_name(name), m_nodeIdx(nodeIdx), m_writableAsset(std::make_shared<FBXMeshAsset>()), m_asset(m_writableAsset)
+{
+}
+
+FBXMesh::FBXMesh(FBXParser& creatorParser, const std::string& name, int nodeIdx, const std::shared_ptr<const FBXMeshAsset>& asset) : m_creatorParser(creatorParser), m_name(name), m_nodeIdx(nodeIdx), m_asset(asset)
 {
 }
 
 FBXMesh::~FBXMesh()
 {
-	for (int i = 0; i < m_controlPointsRestPose.size() ; i++) {
-		if (m_controlPointsRestPose[i]) {
-			delete m_controlPointsRestPose[i];
-		}
-	}
 	delete m_fbxMeshCBO;
 	delete m_debugGPUMesh;
 	delete m_gpuMesh;
@@ -39,6 +47,8 @@ FBXMesh::~FBXMesh()
 
 void FBXMesh::ProcessFbxMesh(FbxNode& node, FbxMesh& mesh, const std::vector<FBXJoint*>& joints, std::vector<FBXPose>& inout_poseSequence, FbxScene& scene)
 {
+	GUARANTEE_OR_DIE(m_writableAsset != nullptr, "Only a mesh FBXParser made can be processed, a copy shares its source's asset");
+
 	//Store the coordinate change of mesh (Remove the translation) 
 	FbxAMatrix meshGlobalTransform = node.EvaluateGlobalTransform();
 	Mat44 meshGlobalTransformGH = ConvertFbxAMatrixToMat44(meshGlobalTransform);
@@ -50,25 +60,27 @@ void FBXMesh::ProcessFbxMesh(FbxNode& node, FbxMesh& mesh, const std::vector<FBX
 
 	//Store the control points in a long vector and also in matrix rows so that I can use it for laplacian matrix calculation
 	int numControlPoints = mesh.GetControlPointsCount();
-	m_controlPointsMatrixRestPose.resize(numControlPoints, Eigen::NoChange);
+	m_writableAsset->m_controlPointsMatrixRestPose.resize(numControlPoints, Eigen::NoChange);
 
 	for (int i = 0; i < numControlPoints; i++) {
 		FbxVector4 controlPointPos = mesh.GetControlPointAt(i);
 		Vec3 controlPointGHPos = fbxToGHCoordSysMatrixForMesh.TransformPosition3D(Vec3((float)controlPointPos.mData[0], (float)controlPointPos.mData[1], (float)controlPointPos.mData[2]));
 
-		if (m_boundingBox.m_mins != Vec3() || m_boundingBox.m_maxs != Vec3()) {
-			m_boundingBox.StretchToIncludePoint(controlPointGHPos);
+		if (m_writableAsset->m_boundingBox.m_mins != Vec3() || m_writableAsset->m_boundingBox.m_maxs != Vec3()) {
+			m_writableAsset->m_boundingBox.StretchToIncludePoint(controlPointGHPos);
 		}
 		else {
-			m_boundingBox.m_mins = controlPointGHPos;
-			m_boundingBox.m_maxs = controlPointGHPos;
+			m_writableAsset->m_boundingBox.m_mins = controlPointGHPos;
+			m_writableAsset->m_boundingBox.m_maxs = controlPointGHPos;
 		}
-		m_controlPointsRestPose.push_back(new FBXControlPoint(controlPointGHPos));
-		m_controlPointsMatrixRestPose.row(i) = Eigen::RowVector3d((double)controlPointGHPos.x, (double)controlPointGHPos.y, (double)controlPointGHPos.z);
+		m_writableAsset->m_controlPointsRestPose.push_back(new FBXControlPoint(controlPointGHPos));
+		m_writableAsset->m_controlPointsMatrixRestPose.row(i) = Eigen::RowVector3d((double)controlPointGHPos.x, (double)controlPointGHPos.y, (double)controlPointGHPos.z);
 	}
 
 	//Process skinning data first cause you need to store them in control points when you make the vertices!
 	ProcessSkinningDataOfMesh(mesh, joints);
+	m_writableAsset->m_weightsMatrix = GetDDMSkinWeights(m_writableAsset->m_controlPointsRestPose, (int)joints.size(), false);
+	m_writableAsset->m_rigidWeightsMatrix = GetDDMSkinWeights(m_writableAsset->m_controlPointsRestPose, (int)joints.size(), true);
 	ProcessMaterialOfMesh(mesh);
 
 	bool isMeshMappingModeAllTheSame = IsMeshMappingModeAllTheSame(mesh);
@@ -93,7 +105,7 @@ void FBXMesh::ProcessFbxMesh(FbxNode& node, FbxMesh& mesh, const std::vector<FBX
 	*/
 
 	int polygonCount = mesh.GetPolygonCount();
-	m_facesMatrix.resize(polygonCount, Eigen::NoChange);
+	m_writableAsset->m_facesMatrix.resize(polygonCount, Eigen::NoChange);
 
 	/*
 	//Create normals, tangents if it doesn't exist
@@ -112,9 +124,11 @@ void FBXMesh::ProcessFbxMesh(FbxNode& node, FbxMesh& mesh, const std::vector<FBX
 	*/
 
 	int vertexCounter = 0;
-	m_renderVertexToControlPointMap.reserve(polygonCount * 3);
-	//For each triangle...
-	std::map<Vertex_FBX, unsigned int> verticesToIndicesMap;
+	//For each triangle... The fbx sdk is read on this thread only, the deduplication afterwards is what runs in parallel
+	std::vector<Vertex_FBX> polygonVertices;
+	std::vector<int> polygonVertexControlPointIndices;
+	polygonVertices.reserve(polygonCount * 3);
+	polygonVertexControlPointIndices.reserve(polygonCount * 3);
 	for (int triangleIndex = 0; triangleIndex < polygonCount; triangleIndex++) {	//For each face
 		//Create half edge, face, and vertices
 		int controlPointIndices[3] = {};
@@ -125,54 +139,141 @@ void FBXMesh::ProcessFbxMesh(FbxNode& node, FbxMesh& mesh, const std::vector<FBX
 		for (int i = 0; i < 3; i++) {	//A triangle has 3 verts (duh)
 			//Creating vertices from all triangle face data
 			controlPointIndices[i] = mesh.GetPolygonVertex(triangleIndex, i);
-			CreateVertexAndPushToRenderDataArray(mesh, verticesToIndicesMap, vertexCounter, controlPointIndices[i], materialIdx);
+			polygonVertices.push_back(CreateVertex(mesh, vertexCounter, controlPointIndices[i], materialIdx));
+			polygonVertexControlPointIndices.push_back(controlPointIndices[i]);
 			vertexCounter++;
 		}
-		m_facesMatrix.row(triangleIndex) = Eigen::RowVector3i(controlPointIndices[0], controlPointIndices[1], controlPointIndices[2]);
+		m_writableAsset->m_facesMatrix.row(triangleIndex) = Eigen::RowVector3i(controlPointIndices[0], controlPointIndices[1], controlPointIndices[2]);
+	}
+
+	std::vector<unsigned int> firstPolygonVertexIndices;
+	DeduplicateFBXVertices(g_theJobSystem, polygonVertices, VERTEX_DEDUP_CHUNK_SIZE, m_writableAsset->m_renderIndices, firstPolygonVertexIndices);
+	m_renderVertices.resize(firstPolygonVertexIndices.size());
+	m_writableAsset->m_renderVertexToControlPointMap.resize(firstPolygonVertexIndices.size());
+	for (int renderVertexIdx = 0; renderVertexIdx < (int)firstPolygonVertexIndices.size(); renderVertexIdx++) {
+		m_renderVertices[renderVertexIdx] = polygonVertices[firstPolygonVertexIndices[renderVertexIdx]];
+		m_writableAsset->m_renderVertexToControlPointMap[renderVertexIdx] = polygonVertexControlPointIndices[firstPolygonVertexIndices[renderVertexIdx]];
 	}
 
-	CalculateFBXAveragedNormals(m_renderVertices, m_renderIndices);
-	CalculateFBXTangents(m_renderVertices, m_renderIndices);
+	CalculateFBXAveragedNormals(m_renderVertices, m_writableAsset->m_renderIndices);
+	CalculateFBXTangents(m_renderVertices, m_writableAsset->m_renderIndices);
 	ProcessKeyAnimOfMesh(mesh, joints, inout_poseSequence, scene);
 }
 
+void FBXMesh::ProcessCookedMesh(const FBXCookedModel& cookedModel, const FBXCookedMeshView& cookedMesh, int numJoints)
+{
+	GUARANTEE_OR_DIE(m_writableAsset != nullptr, "Only a mesh FBXParser made can be processed, a copy shares its source's asset");
+
+	const FBXCookedMesh& mesh = *cookedMesh.m_mesh;
+	int numControlPoints = mesh.m_numControlPoints;
+	m_writableAsset->m_controlPointsMatrixRestPose.resize(numControlPoints, Eigen::NoChange);
+	m_writableAsset->m_controlPointsRestPose.reserve(numControlPoints);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		const Vec3& position = cookedMesh.m_controlPoints[ctrlPointIdx];
+		FBXControlPoint* controlPoint = new FBXControlPoint(position);
+		unsigned int firstPairIdx = cookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx];
+		unsigned int endPairIdx = cookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx + 1];
+		controlPoint->m_jointWeightPairs.reserve(endPairIdx - firstPairIdx);
+		for (unsigned int pairIdx = firstPairIdx; pairIdx < endPairIdx; pairIdx++) {
+			controlPoint->m_jointWeightPairs.emplace_back(cookedMesh.m_jointWeightPairs[pairIdx].m_jointIdx, cookedMesh.m_jointWeightPairs[pairIdx].m_weight);
+		}
+		m_writableAsset->m_controlPointsRestPose.push_back(controlPoint);
+		m_writableAsset->m_controlPointsMatrixRestPose.row(ctrlPointIdx) = Eigen::RowVector3d((double)position.x, (double)position.y, (double)position.z);
+	}
+	m_writableAsset->m_boundingBox.m_mins = mesh.m_boundingBoxMins;
+	m_writableAsset->m_boundingBox.m_maxs = mesh.m_boundingBoxMaxs;
+	const FBXCookedSkinWeightsView& skinWeights = cookedMesh.m_skinWeights;
+	const FBXCookedSkinWeightsView& rigidSkinWeights = cookedMesh.m_rigidSkinWeights;
+	m_writableAsset->m_weightsMatrix = GetDDMSkinWeightsFromArrays(numControlPoints, numJoints, skinWeights.m_numWeights, skinWeights.m_rowStarts, skinWeights.m_jointIndices, skinWeights.m_weights);
+	m_writableAsset->m_rigidWeightsMatrix = GetDDMSkinWeightsFromArrays(numControlPoints, numJoints, rigidSkinWeights.m_numWeights, rigidSkinWeights.m_rowStarts, rigidSkinWeights.m_jointIndices, rigidSkinWeights.m_weights);
+
+	m_writableAsset->m_diffuseTexturePaths = cookedModel.GetTexturePaths(mesh, FBXCookedTextureSlot::DIFFUSE);
+	m_writableAsset->m_specularTexturePaths = cookedModel.GetTexturePaths(mesh, FBXCookedTextureSlot::SPECULAR);
+	m_writableAsset->m_normalTexturePaths = cookedModel.GetTexturePaths(mesh, FBXCookedTextureSlot::NORMAL);
+	m_writableAsset->m_glossTexturePaths = cookedModel.GetTexturePaths(mesh, FBXCookedTextureSlot::GLOSS);
+	m_writableAsset->m_ambientTexturePaths = cookedModel.GetTexturePaths(mesh, FBXCookedTextureSlot::AMBIENT);
+
+	m_writableAsset->m_facesMatrix = Eigen::Map<const Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor>>(cookedMesh.m_faceControlPointIndices, mesh.m_numFaces, 3);
+	//Already deduplicated, with the averaged normals and tangents
+	m_renderVertices.assign(cookedMesh.m_renderVertices, cookedMesh.m_renderVertices + mesh.m_numRenderVertices);
+	m_writableAsset->m_renderIndices.assign(cookedMesh.m_renderIndices, cookedMesh.m_renderIndices + mesh.m_numRenderIndices);
+	m_writableAsset->m_renderVertexToControlPointMap.assign(cookedMesh.m_renderVertexToControlPointMap, cookedMesh.m_renderVertexToControlPointMap + mesh.m_numRenderVertices);
+}
+
+void FBXMesh::FillCookedMeshData(FBXCookedMeshData& out_cookedMesh) const
+{
+	out_cookedMesh.m_name = m_name;
+	out_cookedMesh.m_nodeIdx = m_nodeIdx;
+	int numControlPoints = (int)m_asset->m_controlPointsRestPose.size();
+	out_cookedMesh.m_controlPoints.resize(numControlPoints);
+	out_cookedMesh.m_firstJointWeightPairIndices.resize((size_t)numControlPoints + 1);
+	out_cookedMesh.m_jointWeightPairs.clear();
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		out_cookedMesh.m_controlPoints[ctrlPointIdx] = m_asset->m_controlPointsRestPose[ctrlPointIdx]->m_position;
+		out_cookedMesh.m_firstJointWeightPairIndices[ctrlPointIdx] = (unsigned int)out_cookedMesh.m_jointWeightPairs.size();
+		for (const JointWeightPair& jointWeightPair : m_asset->m_controlPointsRestPose[ctrlPointIdx]->m_jointWeightPairs) {
+			FBXCookedJointWeightPair cookedPair;
+			cookedPair.m_jointIdx = jointWeightPair.m_jointIndex;
+			cookedPair.m_weight = jointWeightPair.m_weight;
+			out_cookedMesh.m_jointWeightPairs.push_back(cookedPair);
+		}
+	}
+	out_cookedMesh.m_firstJointWeightPairIndices[numControlPoints] = (unsigned int)out_cookedMesh.m_jointWeightPairs.size();
+	GetDDMSkinWeightsArrays(m_asset->m_weightsMatrix, out_cookedMesh.m_skinWeights.m_rowStarts, out_cookedMesh.m_skinWeights.m_jointIndices, out_cookedMesh.m_skinWeights.m_weights);
+	GetDDMSkinWeightsArrays(m_asset->m_rigidWeightsMatrix, out_cookedMesh.m_rigidSkinWeights.m_rowStarts, out_cookedMesh.m_rigidSkinWeights.m_jointIndices, out_cookedMesh.m_rigidSkinWeights.m_weights);
+
+	Eigen::Matrix<int, Eigen::Dynamic, 3, Eigen::RowMajor> facesRowMajor = m_asset->m_facesMatrix;
+	out_cookedMesh.m_faceControlPointIndices.assign(facesRowMajor.data(), facesRowMajor.data() + facesRowMajor.size());
+	out_cookedMesh.m_renderVertices = m_renderVertices;
+	out_cookedMesh.m_renderIndices = m_asset->m_renderIndices;
+	out_cookedMesh.m_renderVertexToControlPointMap = m_asset->m_renderVertexToControlPointMap;
+
+	out_cookedMesh.m_texturePaths[(int)FBXCookedTextureSlot::DIFFUSE] = m_asset->m_diffuseTexturePaths;
+	out_cookedMesh.m_texturePaths[(int)FBXCookedTextureSlot::SPECULAR] = m_asset->m_specularTexturePaths;
+	out_cookedMesh.m_texturePaths[(int)FBXCookedTextureSlot::NORMAL] = m_asset->m_normalTexturePaths;
+	out_cookedMesh.m_texturePaths[(int)FBXCookedTextureSlot::GLOSS] = m_asset->m_glossTexturePaths;
+	out_cookedMesh.m_texturePaths[(int)FBXCookedTextureSlot::AMBIENT] = m_asset->m_ambientTexturePaths;
+	out_cookedMesh.m_boundingBoxMins = m_asset->m_boundingBox.m_mins;
+	out_cookedMesh.m_boundingBoxMaxs = m_asset->m_boundingBox.m_maxs;
+}
+
 void FBXMesh::SetGPUData(Renderer& renderer)
 {
 	GUARANTEE_OR_DIE(m_diffuseTextures.size() == 0, "Calling FBXMesh::SetGPUData() twice!");
-	for (int i = 0; i < m_diffuseTexturePaths.size(); i++) {
-		if (DoesFileExistOnDisk(m_diffuseTexturePaths[i])) {
-			m_diffuseTextures.push_back(renderer.CreateOrGetTextureFromFile(m_diffuseTexturePaths[i].c_str()));
+	for (int i = 0; i < m_asset->m_diffuseTexturePaths.size(); i++) {
+		if (DoesFileExistOnDisk(m_asset->m_diffuseTexturePaths[i])) {
+			m_diffuseTextures.push_back(renderer.CreateOrGetTextureFromFile(m_asset->m_diffuseTexturePaths[i].c_str()));
 		}
 	}
 	if (m_diffuseTextures.size() == 0) {
 		m_diffuseTextures.push_back(renderer.CreateOrGetTextureFromFile("Data/Images/PureIvory.png"));
 	}
 
-	for (int i = 0; i < m_specularTexturePaths.size(); i++) {
-		if (DoesFileExistOnDisk(m_specularTexturePaths[i])) {
-			m_specularTextures.push_back(renderer.CreateOrGetTextureFromFile(m_specularTexturePaths[i].c_str()));
+	for (int i = 0; i < m_asset->m_specularTexturePaths.size(); i++) {
+		if (DoesFileExistOnDisk(m_asset->m_specularTexturePaths[i])) {
+			m_specularTextures.push_back(renderer.CreateOrGetTextureFromFile(m_asset->m_specularTexturePaths[i].c_str()));
 		}
 	}
 
-	for (int i = 0; i < m_normalTexturePaths.size(); i++) {
-		if (DoesFileExistOnDisk(m_normalTexturePaths[i])) {
-			m_normalTextures.push_back(renderer.CreateOrGetTextureFromFile(m_normalTexturePaths[i].c_str()));
+	for (int i = 0; i < m_asset->m_normalTexturePaths.size(); i++) {
+		if (DoesFileExistOnDisk(m_asset->m_normalTexturePaths[i])) {
+			m_normalTextures.push_back(renderer.CreateOrGetTextureFromFile(m_asset->m_normalTexturePaths[i].c_str()));
 		}
 	}
 
-	for (int i = 0; i < m_glossTexturePaths.size(); i++) {
-		if (DoesFileExistOnDisk(m_glossTexturePaths[i])) {
-			m_glossTextures.push_back(renderer.CreateOrGetTextureFromFile(m_glossTexturePaths[i].c_str()));
+	for (int i = 0; i < m_asset->m_glossTexturePaths.size(); i++) {
+		if (DoesFileExistOnDisk(m_asset->m_glossTexturePaths[i])) {
+			m_glossTextures.push_back(renderer.CreateOrGetTextureFromFile(m_asset->m_glossTexturePaths[i].c_str()));
 		}
 	}
 
-	for (int i = 0; i < m_ambientTexturePaths.size(); i++) {
-		if (DoesFileExistOnDisk(m_ambientTexturePaths[i])) {
-			m_ambientTextures.push_back(renderer.CreateOrGetTextureFromFile(m_ambientTexturePaths[i].c_str()));
+	for (int i = 0; i < m_asset->m_ambientTexturePaths.size(); i++) {
+		if (DoesFileExistOnDisk(m_asset->m_ambientTexturePaths[i])) {
+			m_ambientTextures.push_back(renderer.CreateOrGetTextureFromFile(m_asset->m_ambientTexturePaths[i].c_str()));
 		}
 	}
 
-	m_gpuMesh = new GPUMesh<Vertex_FBX>(GPUMeshConfig(renderer), m_renderVertices, m_renderIndices);
+	m_gpuMesh = new GPUMesh<Vertex_FBX>(GPUMeshConfig(renderer), m_renderVertices, m_asset->m_renderIndices);
 
 	std::vector<Vertex_PCU> meshDebugVerts;
 	for (int i = 0; i < m_renderVertices.size(); i++) {
@@ -260,144 +361,228 @@ void FBXMesh::SetFBXModel(FBXModel& model)
 
 void FBXMesh::AddDDMModifier()
 {
-	m_ddmModifierCPU = std::make_shared<FBXDDMModifierCPU>(*this);
-	m_ddmModifierGPU = std::make_shared<FBXDDMModifierGPU>(*this);
+	CreateDDMModifiers(DDMSparseOmegas::DEFAULT_EPSILON);
+}
+
+void FBXMesh::CreateDDMModifiers(double omegaEpsilon)
+{
+	int numJoints = GetNumJoints();
+	m_ddmModifierCPU = std::make_shared<FBXDDMModifierCPU>(m_asset, false, numJoints, omegaEpsilon);
+	m_ddmModifierGPU = std::make_shared<FBXDDMModifierGPU>(m_asset, false, numJoints, omegaEpsilon);
+	m_rigidDDMModifierCPU = std::make_shared<FBXDDMModifierCPU>(m_asset, true, numJoints, omegaEpsilon);
+	m_rigidDDMModifierGPU = std::make_shared<FBXDDMModifierGPU>(m_asset, true, numJoints, omegaEpsilon);
+	SetDDMNeedsRecalculation();
+	InvalidateDDMWrittenJointSkinningMatrices();
 }
 
 std::shared_ptr<FBXDDMModifierCPU> FBXMesh::GetDDMModifierCPU() const
 {
-	return m_ddmModifierCPU;
+	return m_isRigidBinding ? m_rigidDDMModifierCPU : m_ddmModifierCPU;
 }
 
 std::shared_ptr<FBXDDMModifierGPU> FBXMesh::GetDDMModifierGPU() const
 {
-	return m_ddmModifierGPU;
+	return m_isRigidBinding ? m_rigidDDMModifierGPU : m_ddmModifierGPU;
+}
+
+void FBXMesh::SetDDMOmegaEpsilon(double omegaEpsilon)
+{
+	if (m_ddmModifierCPU == nullptr || m_ddmModifierCPU->GetOmegaEpsilon() == omegaEpsilon)
+		return;
+
+	//The copies sharing the modifiers keep their epsilon, so this mesh moves to modifiers of its own
+	CreateDDMModifiers(omegaEpsilon);
+}
+
+void FBXMesh::SetDDMNeedsRecalculation()
+{
+	m_ddmInstanceStateCPU.SetNeedsRecalculation();
+	m_ddmInstanceStateGPU.SetNeedsRecalculation();
+}
+
+void FBXMesh::SetDDMCPUNeedsRecalculation()
+{
+	m_ddmInstanceStateCPU.SetNeedsRecalculation();
 }
 
 void FBXMesh::PrecomputeDDM(bool isCPUSide, bool useCotangentLaplacian, int numLaplacianIterations, float lambda, float kappa, float alpha)
 {
 	if (isCPUSide) {
-		if (m_ddmModifierCPU == nullptr)
+		std::shared_ptr<FBXDDMModifierCPU> ddmModifierCPU = GetDDMModifierCPU();
+		if (ddmModifierCPU == nullptr)
 			ERROR_AND_DIE("Cannot precompute ddm stuff when FBXMesh::m_ddmModifierCPU == nullptr");
-		m_ddmModifierCPU->Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
+		ddmModifierCPU->Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
+		InvalidateDDMWrittenJointSkinningMatrices();	//New packets, so every control point gets deformed again
 	}
 	else {
-		if (m_ddmModifierGPU == nullptr)
+		std::shared_ptr<FBXDDMModifierGPU> ddmModifierGPU = GetDDMModifierGPU();
+		if (ddmModifierGPU == nullptr)
 			ERROR_AND_DIE("Cannot precompute ddm stuff when FBXMesh::m_ddmModifierGPU == nullptr");
-		m_ddmModifierGPU->Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
+		ddmModifierGPU->Precompute(useCotangentLaplacian, numLaplacianIterations, lambda, kappa, alpha);
 	}
 }
 
 void FBXMesh::ApplyDDMv0_CPU(const std::vector<Mat44>& allJointSkinningMatrices)
 {
-	if (m_ddmModifierCPU == nullptr)
+	std::shared_ptr<FBXDDMModifierCPU> ddmModifierCPU = GetDDMModifierCPU();
+	if (ddmModifierCPU == nullptr)
 		ERROR_AND_DIE("Cannot compute ddm stuff when FBXMesh::m_ddmModifierCPU == nullptr");
 
-	bool didRecalculateThisFrame = false;
-	Eigen::MatrixX3f deformedControlPointsMatrix = m_ddmModifierCPU->GetVariantv0Deform(allJointSkinningMatrices, didRecalculateThisFrame);
-
-	//Eigen::MatrixX3d dummyData = m_ddmModifierGPU->GetVariantv0Deform(allJointSkinningMatrices);
-	if (didRecalculateThisFrame == false)
+	//The kernel writes into m_renderVertices itself, so there is no deformed control point matrix to copy from
+	DDMRenderVertexWriteback& writeback = GetDDMRenderVertexWriteback();
+	const std::vector<int>* changedJointIndices = GetDDMChangedJointIndices(allJointSkinningMatrices, 0);
+	if (ddmModifierCPU->WriteVariantv0DeformToRenderVertices(allJointSkinningMatrices, m_ddmInstanceStateCPU, writeback, &m_renderVertices[0].m_position.x, RENDER_VERTEX_STRIDE_IN_FLOATS, changedJointIndices) == false)
 		return;
 
-	for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-		auto newCtrlPoint = deformedControlPointsMatrix.row(m_renderVertexToControlPointMap[i]);
-		m_renderVertices[i].m_position.x = newCtrlPoint[0];
-		m_renderVertices[i].m_position.y = newCtrlPoint[1];
-		m_renderVertices[i].m_position.z = newCtrlPoint[2];
-	}
-
-	m_gpuMesh->UpdateVerticesData(m_renderVertices);
+	DebuggerPrintf("Mesh: %s\n", m_name.c_str());
+	m_ddmWrittenJointSkinningMatrices = allJointSkinningMatrices;
+	m_ddmWrittenVariant = 0;
+	UploadDDMDirtyRenderVertices();
 }
 
 void FBXMesh::ApplyDDMv1_CPU(const std::vector<Mat44>& allJointSkinningMatrices)
 {
-	if (m_ddmModifierCPU == nullptr)
+	std::shared_ptr<FBXDDMModifierCPU> ddmModifierCPU = GetDDMModifierCPU();
+	if (ddmModifierCPU == nullptr)
 		ERROR_AND_DIE("Cannot compute ddm stuff when FBXMesh::m_ddmModifierCPU == nullptr");
 
-	bool didRecalculateThisFrame = false;
-	Eigen::MatrixX3f deformedControlPointsMatrix = m_ddmModifierCPU->GetVariantv1Deform(allJointSkinningMatrices, didRecalculateThisFrame);
-	
-	if (didRecalculateThisFrame == false)
+	DDMRenderVertexWriteback& writeback = GetDDMRenderVertexWriteback();
+	const std::vector<int>* changedJointIndices = GetDDMChangedJointIndices(allJointSkinningMatrices, 1);
+	if (ddmModifierCPU->WriteVariantv1DeformToRenderVertices(allJointSkinningMatrices, m_ddmInstanceStateCPU, writeback, &m_renderVertices[0].m_position.x, RENDER_VERTEX_STRIDE_IN_FLOATS, changedJointIndices) == false)
 		return;
 
-	for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-		auto newCtrlPoint = deformedControlPointsMatrix.row(m_renderVertexToControlPointMap[i]);
-		m_renderVertices[i].m_position.x = newCtrlPoint[0];
-		m_renderVertices[i].m_position.y = newCtrlPoint[1];
-		m_renderVertices[i].m_position.z = newCtrlPoint[2];
-	}
-
-	m_gpuMesh->UpdateVerticesData(m_renderVertices);
+	DebuggerPrintf("Mesh: %s\n", m_name.c_str());
+	m_ddmWrittenJointSkinningMatrices = allJointSkinningMatrices;
+	m_ddmWrittenVariant = 1;
+	UploadDDMDirtyRenderVertices();
 }
 
 void FBXMesh::ApplyDDMv0_GPU(const std::vector<Mat44>& allJointSkinningMatrices)
 {
-	if (m_ddmModifierGPU == nullptr)
+	std::shared_ptr<FBXDDMModifierGPU> ddmModifierGPU = GetDDMModifierGPU();
+	if (ddmModifierGPU == nullptr)
 		ERROR_AND_DIE("Cannot compute ddm stuff when FBXMesh::m_ddmModifierGPU == nullptr");
 
 	bool didRecalculateThisFrame = false;
-	Eigen::MatrixX3f deformedControlPointsMatrix = m_ddmModifierGPU->GetVariantv0Deform(allJointSkinningMatrices, didRecalculateThisFrame);
+	Eigen::MatrixX3f deformedControlPointsMatrix = ddmModifierGPU->GetVariantv0Deform(allJointSkinningMatrices, m_ddmInstanceStateGPU, didRecalculateThisFrame);
 
 	if (didRecalculateThisFrame == false)
 		return;
 
-	for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-		auto newCtrlPoint = deformedControlPointsMatrix.row(m_renderVertexToControlPointMap[i]);
-		m_renderVertices[i].m_position.x = newCtrlPoint[0];
-		m_renderVertices[i].m_position.y = newCtrlPoint[1];
-		m_renderVertices[i].m_position.z = newCtrlPoint[2];
-	}
-
-	m_gpuMesh->UpdateVerticesData(m_renderVertices);
+	DebuggerPrintf("Mesh: %s\n", m_name.c_str());
+	GetDDMRenderVertexWriteback().WriteControlPoints(*g_theJobSystem, deformedControlPointsMatrix, &m_renderVertices[0].m_position.x, RENDER_VERTEX_STRIDE_IN_FLOATS);
+	InvalidateDDMWrittenJointSkinningMatrices();
+	UploadDDMDirtyRenderVertices();
 }
 
 void FBXMesh::ApplyDDMv1_GPU(const std::vector<Mat44>& allJointSkinningMatrices)
 {
-	if (m_ddmModifierGPU == nullptr)
+	std::shared_ptr<FBXDDMModifierGPU> ddmModifierGPU = GetDDMModifierGPU();
+	if (ddmModifierGPU == nullptr)
 		ERROR_AND_DIE("Cannot compute ddm stuff when FBXMesh::m_ddmModifierGPU == nullptr");
 
 	bool didRecalculateThisFrame = false;
-	Eigen::MatrixX3f deformedControlPointsMatrix = m_ddmModifierGPU->GetVariantv1Deform(allJointSkinningMatrices, didRecalculateThisFrame);
+	Eigen::MatrixX3f deformedControlPointsMatrix = ddmModifierGPU->GetVariantv1Deform(allJointSkinningMatrices, m_ddmInstanceStateGPU, didRecalculateThisFrame);
 
 	if (didRecalculateThisFrame == false)
 		return;
 
-	for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-		auto newCtrlPoint = deformedControlPointsMatrix.row(m_renderVertexToControlPointMap[i]);
-		m_renderVertices[i].m_position.x = newCtrlPoint[0];
-		m_renderVertices[i].m_position.y = newCtrlPoint[1];
-		m_renderVertices[i].m_position.z = newCtrlPoint[2];
+	DebuggerPrintf("Mesh: %s\n", m_name.c_str());
+	GetDDMRenderVertexWriteback().WriteControlPoints(*g_theJobSystem, deformedControlPointsMatrix, &m_renderVertices[0].m_position.x, RENDER_VERTEX_STRIDE_IN_FLOATS);
+	InvalidateDDMWrittenJointSkinningMatrices();
+	UploadDDMDirtyRenderVertices();
+}
+
+DDMRenderVertexWriteback& FBXMesh::GetDDMRenderVertexWriteback()
+{
+	if (m_ddmRenderVertexWriteback.GetNumRenderVertices() != (int)m_renderVertices.size() || m_ddmRenderVertexWriteback.GetNumControlPoints() != (int)m_asset->m_controlPointsRestPose.size()) {
+		m_ddmRenderVertexWriteback.Build(m_asset->m_renderVertexToControlPointMap, (int)m_asset->m_controlPointsRestPose.size());
+	}
+	return m_ddmRenderVertexWriteback;
+}
+
+const std::vector<int>* FBXMesh::GetDDMChangedJointIndices(const std::vector<Mat44>& allJointSkinningMatrices, int ddmVariant)
+{
+	if (m_ddmWrittenVariant != ddmVariant || m_ddmWrittenJointSkinningMatrices.size() != allJointSkinningMatrices.size()) {
+		return nullptr;
+	}
+	//Bitwise, like the writeback compares positions. A joint that moved and came back is left alone, its control points would come out the same bits
+	m_ddmChangedJointIndices.clear();
+	for (int jointIdx = 0; jointIdx < (int)allJointSkinningMatrices.size(); jointIdx++) {
+		if (memcmp(&allJointSkinningMatrices[jointIdx], &m_ddmWrittenJointSkinningMatrices[jointIdx], sizeof(Mat44)) != 0) {
+			m_ddmChangedJointIndices.push_back(jointIdx);
+		}
 	}
+	return &m_ddmChangedJointIndices;
+}
+
+void FBXMesh::InvalidateDDMWrittenJointSkinningMatrices()
+{
+	m_ddmWrittenJointSkinningMatrices.clear();
+	m_ddmWrittenVariant = -1;
+}
 
+void FBXMesh::UploadDDMDirtyRenderVertices()
+{
+	//m_renderVertices is the staging copy of the vertex buffer, so only what the last write changed has to go up
+	m_gpuMesh->UpdateVerticesData(m_renderVertices, m_ddmRenderVertexWriteback.GetDirtyRanges());
+}
+
+void FBXMesh::ApplySkinning_CPU(const std::vector<Mat44>& allJointSkinningMatrices, CPUSkinningMethod method)
+{
+	const CPUSkinningVertexBlocks& blocks = GetCPUSkinningVertexBlocks();
+	std::vector<float> jointData;
+	ConvertJointTransformsForCPUSkinning(method, allJointSkinningMatrices, jointData);
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	float* positions = &m_renderVertices[0].m_position.x;
+	g_theJobSystem->ParallelForRange(0, blocks.GetNumBlocks(), CPU_SKINNING_PARALLEL_FOR_GRAIN_SIZE, [&](int beginBlockIdx, int endBlockIdx) {
+		ComputeCPUSkinnedVertices(blocks, method, jointData.data(), beginBlockIdx, endBlockIdx, positions, nullptr, RENDER_VERTEX_STRIDE_IN_FLOATS, simdLevel);
+	});
+	InvalidateDDMWrittenJointSkinningMatrices();
 	m_gpuMesh->UpdateVerticesData(m_renderVertices);
 }
 
+const CPUSkinningVertexBlocks& FBXMesh::GetCPUSkinningVertexBlocks()
+{
+	if (m_areCPUSkinningVertexBlocksOutdated || m_cpuSkinningVertexBlocks.GetNumVertices() != (int)m_renderVertices.size()) {
+		//m_renderVertices holds whatever the last deformation wrote, the rest positions come from the control points
+		std::vector<Vertex_FBX> restVertices = m_renderVertices;
+		for (int i = 0; i < restVertices.size(); i++) {
+			restVertices[i].m_position = m_asset->m_controlPointsRestPose[m_asset->m_renderVertexToControlPointMap[i]]->m_position;
+		}
+		m_cpuSkinningVertexBlocks.Build(restVertices);
+		m_areCPUSkinningVertexBlocksOutdated = false;
+	}
+	return m_cpuSkinningVertexBlocks;
+}
+
 Eigen::MatrixX3f FBXMesh::GetDDMv0_GPU_Deformation(const std::vector<Mat44>& allJointSkinningMatrices)
 {
-	if (m_ddmModifierGPU == nullptr)
+	std::shared_ptr<FBXDDMModifierGPU> ddmModifierGPU = GetDDMModifierGPU();
+	if (ddmModifierGPU == nullptr)
 		ERROR_AND_DIE("Cannot compute ddm stuff when FBXMesh::m_ddmModifierGPU == nullptr");
-	Eigen::MatrixX3f deformedControlPointsMatrix = m_ddmModifierGPU->GetVariantv0DeformAlwaysCalculated(allJointSkinningMatrices);
+	Eigen::MatrixX3f deformedControlPointsMatrix = ddmModifierGPU->GetVariantv0DeformAlwaysCalculated(allJointSkinningMatrices);
 	return deformedControlPointsMatrix;
 }
 
 void FBXMesh::RestoreGPUVerticesToRestPose()
 {
-	for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-		auto newCtrlPoint = m_controlPointsRestPose[m_renderVertexToControlPointMap[i]];
+	for (int i = 0; i < m_asset->m_renderVertexToControlPointMap.size(); i++) {
+		auto newCtrlPoint = m_asset->m_controlPointsRestPose[m_asset->m_renderVertexToControlPointMap[i]];
 		if (newCtrlPoint)
 			m_renderVertices[i].m_position = newCtrlPoint->m_position;
 		else
-			ERROR_AND_DIE("There is a nullptr in m_controlPointsRestPose");
+			ERROR_AND_DIE("There is a nullptr in m_asset->m_controlPointsRestPose");
 	}
+	InvalidateDDMWrittenJointSkinningMatrices();
 	m_gpuMesh->UpdateVerticesData(m_renderVertices);
 }
 
 void FBXMesh::SetRigidBinding(bool isRigidBound)
 {
 	if (isRigidBound) {
-		for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-			auto newCtrlPoint = m_controlPointsRestPose[m_renderVertexToControlPointMap[i]];
+		for (int i = 0; i < m_asset->m_renderVertexToControlPointMap.size(); i++) {
+			auto newCtrlPoint = m_asset->m_controlPointsRestPose[m_asset->m_renderVertexToControlPointMap[i]];
 			if (newCtrlPoint) {
 				JointWeightPair jwPair = GetMaxInfluenceJointWeightPair(newCtrlPoint->m_jointWeightPairs);
 				m_renderVertices[i].m_jointIndices1.Clear();
@@ -408,13 +593,13 @@ void FBXMesh::SetRigidBinding(bool isRigidBound)
 				m_renderVertices[i].m_jointWeights1[0] = 1.0f;
 			}
 			else {
-				ERROR_AND_DIE("There is a nullptr in m_controlPointsRestPose");
+				ERROR_AND_DIE("There is a nullptr in m_asset->m_controlPointsRestPose");
 			}
 		}
 	}
 	else {
-		for (int i = 0; i < m_renderVertexToControlPointMap.size(); i++) {
-			auto restCtrlPoint = m_controlPointsRestPose[m_renderVertexToControlPointMap[i]];
+		for (int i = 0; i < m_asset->m_renderVertexToControlPointMap.size(); i++) {
+			auto restCtrlPoint = m_asset->m_controlPointsRestPose[m_asset->m_renderVertexToControlPointMap[i]];
 			if (restCtrlPoint) {
 				const std::vector<JointWeightPair>& jointWeightPairs = restCtrlPoint->m_jointWeightPairs;
 				for (int jwPairIdx = 0; jwPairIdx < jointWeightPairs.size(); jwPairIdx++) {
@@ -432,61 +617,33 @@ void FBXMesh::SetRigidBinding(bool isRigidBound)
 				}
 			}
 			else {
-				ERROR_AND_DIE("There is a nullptr in m_controlPointsRestPose");
+				ERROR_AND_DIE("There is a nullptr in m_asset->m_controlPointsRestPose");
 			}
 		}
 	}
 
 	m_isRigidBinding = isRigidBound;
+	m_areCPUSkinningVertexBlocksOutdated = true;
 	m_gpuMesh->UpdateVerticesData(m_renderVertices);
 
-	m_ddmModifierCPU->ResetIsPrecomputed();
-	m_ddmModifierGPU->ResetIsPrecomputed();
+	//The modifiers of the other binding are shared with the copies of this mesh too, only this mesh's deform starts over
+	SetDDMNeedsRecalculation();
+	InvalidateDDMWrittenJointSkinningMatrices();
 }
 
-Eigen::MatrixX3d FBXMesh::GetControlPointsMatrixRestPose() const
+const Eigen::MatrixX3d& FBXMesh::GetControlPointsMatrixRestPose() const
 {
-	return m_controlPointsMatrixRestPose;
+	return m_asset->m_controlPointsMatrixRestPose;
 }
 
-Eigen::MatrixX3i FBXMesh::GetFacesMatrix() const
+const Eigen::MatrixX3i& FBXMesh::GetFacesMatrix() const
 {
-	return m_facesMatrix;
+	return m_asset->m_facesMatrix;
 }
 
-Eigen::MatrixXd FBXMesh::GetWeightsMatrix() const
+const DDMSkinWeights& FBXMesh::GetWeightsMatrix() const
 {
-	if (m_model == nullptr) {
-		ERROR_AND_DIE("FBXMesh::m_model is nullptr but is calling FBXMesh::GetWeightsMatrix()!");
-	}
-	if ((size_t)m_controlPointsMatrixRestPose.rows() != m_controlPointsRestPose.size()) {
-		ERROR_AND_DIE("FBXMesh fucked up because m_controlPointsMatrixRestPose.rows() != m_controlPointsRestPose.size()");
-	}
-	Eigen::MatrixXd weightsMatrix;
-	int numJoints = m_model->GetNumJoints();
-	weightsMatrix.resize(m_controlPointsMatrixRestPose.rows(), numJoints);
-	weightsMatrix.setZero();
-
-	if (m_isRigidBinding == false) {
-		for (int rowIdx = 0; rowIdx < m_controlPointsMatrixRestPose.rows(); rowIdx++) {
-			const FBXControlPoint& currentCtrlPoint = *m_controlPointsRestPose[rowIdx];
-			for (const auto& jointWeightPair : currentCtrlPoint.m_jointWeightPairs) {
-				if (jointWeightPair.m_jointIndex >= (unsigned int)numJoints) {
-					ERROR_AND_DIE("Sth fucked up in your ctrl point settings");
-				}
-				weightsMatrix(rowIdx, jointWeightPair.m_jointIndex) = jointWeightPair.m_weight;
-			}
-		}
-	}
-	else {
-		for (int rowIdx = 0; rowIdx < m_controlPointsMatrixRestPose.rows(); rowIdx++) {
-			const FBXControlPoint& currentCtrlPoint = *m_controlPointsRestPose[rowIdx];
-			JointWeightPair jwPair = GetMaxInfluenceJointWeightPair(currentCtrlPoint.m_jointWeightPairs);
-			weightsMatrix(rowIdx, jwPair.m_jointIndex) = jwPair.m_weight;
-		}
-	}
-
-	return weightsMatrix;
+	return m_isRigidBinding ? m_asset->m_rigidWeightsMatrix : m_asset->m_weightsMatrix;
 }
 
 int FBXMesh::GetNumVertices() const
@@ -506,7 +663,7 @@ int FBXMesh::GetNumJoints() const
 
 std::vector<unsigned int> FBXMesh::GetRenderVertexToControlPointMap() const
 {
-	return m_renderVertexToControlPointMap;
+	return m_asset->m_renderVertexToControlPointMap;
 }
 
 void FBXMesh::ToggleMeshDebugMode()
@@ -514,55 +671,39 @@ void FBXMesh::ToggleMeshDebugMode()
 	m_isMeshDebugMode = !m_isMeshDebugMode;
 }
 
-void FBXMesh::PrepareDDMBaker(int numPoses)
+void FBXMesh::PrepareDDMBaker(int numPoses, DDMBakerSolveMode solveMode, const DDMBakerCandidateParameters* candidateParameters, const std::vector<int>& jointParentIndices)
 {
-	m_ddmBakerLHSMatrices.clear();
-	m_ddmBakerRHSMatrices.clear();
-	GUARANTEE_OR_DIE(numPoses > 0, "numPoses <= 0");
-	int numControlPoints = (int)m_controlPointsRestPose.size();
-	int numJoints = m_model->GetNumJoints();
-	for (int i = 0; i < numControlPoints; i++) {
-		Eigen::MatrixXf newLHSMat;
-		newLHSMat.resize(3 * numPoses, numJoints);
-		newLHSMat.setZero();
-		m_ddmBakerLHSMatrices.push_back(newLHSMat);
-
-		Eigen::MatrixXf newRHSMat;
-		newRHSMat.resize(3 * numPoses, 1);
-		newRHSMat.setZero();
-		m_ddmBakerRHSMatrices.push_back(newRHSMat);
+	std::vector<Vec3> restPositions;
+	restPositions.reserve(m_asset->m_controlPointsRestPose.size());
+	for (const FBXControlPoint* cp : m_asset->m_controlPointsRestPose) {
+		GUARANTEE_OR_DIE(cp != nullptr, "cp == nullptr");
+		restPositions.push_back(cp->m_position);
 	}
+	if (candidateParameters == nullptr) {
+		m_ddmBakerSystems.Prepare(solveMode, restPositions, m_model->GetNumJoints(), numPoses);
+		return;
+	}
+	DDMBakerJointCandidates candidates;
+	ComputeDDMBakerJointCandidates(*g_theJobSystem, m_asset->m_facesMatrix, GetWeightsMatrix(), jointParentIndices, *candidateParameters, candidates);
+	m_ddmBakerSystems.Prepare(solveMode, restPositions, m_model->GetNumJoints(), numPoses, &candidates);
 }
 
 void FBXMesh::FillLHSMatForDDMBaker(const std::vector<Mat44>& allJointSkinningMatrices, int poseIdx)
 {
 	int jointNum = m_model->GetNumJoints();
 	GUARANTEE_OR_DIE(jointNum == (int)allJointSkinningMatrices.size(), "jointNum != allJointSkinningMatrices.size()");
-	int numControlPoints = (int)m_controlPointsRestPose.size();
-	GUARANTEE_OR_DIE(numControlPoints == (int)m_ddmBakerLHSMatrices.size(), "Check m_ddmBakerLHSMatrices.size()");
-
-	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
-		const FBXControlPoint* cp = m_controlPointsRestPose[cpIdx];
-		GUARANTEE_OR_DIE(cp != nullptr, "cp == nullptr");
-		for (int jointIdx = 0; jointIdx < jointNum; jointIdx++) {
-			Vec3 transformedPos = allJointSkinningMatrices[jointIdx].TransformPosition3D(cp->m_position);
-			m_ddmBakerLHSMatrices[cpIdx].block(poseIdx * 3, jointIdx, 3, 1) << transformedPos.x, transformedPos.y, transformedPos.z;
-		}
-	}
+	GUARANTEE_OR_DIE((int)m_asset->m_controlPointsRestPose.size() == m_ddmBakerSystems.GetNumControlPoints(), "Check m_ddmBakerSystems.GetNumControlPoints()");
+	m_ddmBakerSystems.AddPoseLHS(*g_theJobSystem, poseIdx, allJointSkinningMatrices);
 }
 
 void FBXMesh::FillRHSMatForDDMBaker(const std::vector<Mat44>& allJointSkinningMatrices, int poseIdx)
 {
 	int jointNum = m_model->GetNumJoints();
 	GUARANTEE_OR_DIE(jointNum == (int)allJointSkinningMatrices.size(), "jointNum != allJointSkinningMatrices.size()");
-	int numControlPoints = (int)m_controlPointsRestPose.size();
-	GUARANTEE_OR_DIE(numControlPoints == (int)m_ddmBakerRHSMatrices.size(), "Check m_ddmBakerRHSMatrices.size()");
+	GUARANTEE_OR_DIE((int)m_asset->m_controlPointsRestPose.size() == m_ddmBakerSystems.GetNumControlPoints(), "Check m_ddmBakerSystems.GetNumControlPoints()");
 
 	Eigen::MatrixX3f deformedCPsMat = GetDDMv0_GPU_Deformation(allJointSkinningMatrices);
-	
-	for (int cpIdx = 0; cpIdx < numControlPoints; cpIdx++) {
-		m_ddmBakerRHSMatrices[cpIdx].block(3 * poseIdx, 0, 3, 1) << deformedCPsMat(cpIdx, 0), deformedCPsMat(cpIdx, 1), deformedCPsMat(cpIdx, 2);
-	}
+	m_ddmBakerSystems.AddPoseRHS(*g_theJobSystem, poseIdx, allJointSkinningMatrices, deformedCPsMat);
 }
 
 void FBXMesh::SolveDDMBakerLinearSystems(int numMaxBones, float pruneThreshold)
@@ -573,38 +714,45 @@ void FBXMesh::SolveDDMBakerLinearSystems(int numMaxBones, float pruneThreshold)
 	m_ddmBakerWeightsForCPs.clear();
 	m_ddmBakerCPWeightPairsForJoints.clear();
 
-	int numCPs = (int)m_controlPointsRestPose.size();
-	for (int cpIdx = 0; cpIdx < numCPs; cpIdx++) {
-		Eigen::MatrixXf finalWeightsForThisCP = m_ddmBakerLHSMatrices[cpIdx].colPivHouseholderQr().solve(m_ddmBakerRHSMatrices[cpIdx]);
-
-		if (numMaxBones < m_model->GetNumJoints()) {
-			//For the finalWeightsForThisCP vector, remove the weights that are not the numMaxBones
-			std::vector<float> weightsArray(finalWeightsForThisCP.data(), finalWeightsForThisCP.data() + finalWeightsForThisCP.size());
-			std::partial_sort(weightsArray.begin(), weightsArray.begin() + numMaxBones, weightsArray.end(), std::greater<float>());
+	int numCPs = (int)m_asset->m_controlPointsRestPose.size();
+	int numJoints = m_model->GetNumJoints();
+	m_ddmBakerWeightsForCPs.resize((size_t)numCPs);
+	//Every control point only writes its own weights, so the result does not depend on how the range gets split
+	g_theJobSystem->ParallelForRange(0, numCPs, DDM_BAKER_SOLVE_PARALLEL_FOR_GRAIN_SIZE, [&](int beginCPIdx, int endCPIdx) {
+		for (int cpIdx = beginCPIdx; cpIdx < endCPIdx; cpIdx++) {
+			Eigen::VectorXf solvedWeights;
+			m_ddmBakerSystems.Solve(cpIdx, solvedWeights);
+			Eigen::MatrixXf finalWeightsForThisCP = solvedWeights;
+
+			if (numMaxBones < numJoints) {
+				//For the finalWeightsForThisCP vector, remove the weights that are not the numMaxBones
+				std::vector<float> weightsArray(finalWeightsForThisCP.data(), finalWeightsForThisCP.data() + finalWeightsForThisCP.size());
+				std::partial_sort(weightsArray.begin(), weightsArray.begin() + numMaxBones, weightsArray.end(), std::greater<float>());
+
+				for (int i = 0; i < finalWeightsForThisCP.rows(); i++) {
+					if (std::find(weightsArray.begin(), weightsArray.begin() + numMaxBones, finalWeightsForThisCP(i, 0)) == weightsArray.begin() + numMaxBones) {
+						finalWeightsForThisCP(i, 0) = 0.0f;
+					}
+				}
+			}
 
 			for (int i = 0; i < finalWeightsForThisCP.rows(); i++) {
-				if (std::find(weightsArray.begin(), weightsArray.begin() + numMaxBones, finalWeightsForThisCP(i, 0)) == weightsArray.begin() + numMaxBones) {
+				//Prune the threshold values
+				if (finalWeightsForThisCP(i, 0) <= pruneThreshold) {
 					finalWeightsForThisCP(i, 0) = 0.0f;
 				}
 			}
-		}
 
-		for (int i = 0; i < finalWeightsForThisCP.rows(); i++) {
-			//Prune the threshold values
-			if (finalWeightsForThisCP(i, 0) <= pruneThreshold) {
-				finalWeightsForThisCP(i, 0) = 0.0f;
+			//Make the sum to 1.0
+			float sum = finalWeightsForThisCP.sum();
+			if (sum > 0.0f) {
+				finalWeightsForThisCP /= sum;
 			}
+			m_ddmBakerWeightsForCPs[cpIdx] = finalWeightsForThisCP;
 		}
+	});
+	m_ddmBakerSystems.Clear();	//Only the weights are needed from here on, and QR systems of many poses are big
 
-		//Make the sum to 1.0
-		float sum = finalWeightsForThisCP.sum();
-		if (sum > 0.0f) {
-			finalWeightsForThisCP /= sum;
-		}
-		m_ddmBakerWeightsForCPs.push_back(finalWeightsForThisCP);
-	}
-
-	int numJoints = m_model->GetNumJoints();
 	m_ddmBakerCPWeightPairsForJoints.resize((size_t)numJoints);
 
 	//Reorganize it so that each joint stores a pair of control point index and a weight
@@ -622,7 +770,7 @@ void FBXMesh::SolveDDMBakerLinearSystems(int numMaxBones, float pruneThreshold)
 
 void FBXMesh::UpdateSceneBakedSkinningData()
 {
-	GUARANTEE_OR_DIE(m_ddmBakerWeightsForCPs.size() == m_controlPointsRestPose.size(), "Didn't bake yet but FbxMesh::UpdateSceneBakedSkinningData() called!");
+	GUARANTEE_OR_DIE(m_ddmBakerWeightsForCPs.size() == m_asset->m_controlPointsRestPose.size(), "Didn't bake yet but FbxMesh::UpdateSceneBakedSkinningData() called!");
 
 	FbxScene* scene = m_creatorParser.GetScene();
 	GUARANTEE_OR_DIE(scene != nullptr, "m_creatorParser.GetScene() returned nullptr");
@@ -680,7 +828,7 @@ void FBXMesh::UpdateSceneBakedSkinningData()
 
 void FBXMesh::UpdateFBXMeshCBOConstants(Renderer& renderer)
 {
-	if (m_model->GetSkinningModifierState() == FBXModelSkinningModifier::LBS) {
+	if (m_model->GetSkinningModifierState() == FBXModelSkinningModifier::LBS) {	//Everything else already wrote the deformed positions into the vertex buffer
 		m_fbxMeshConstants.IsFBXMeshLBS = 1;
 	}
 	else {
@@ -721,16 +869,16 @@ void FBXMesh::ProcessSkinningDataOfMesh(FbxMesh& mesh, const std::vector<FBXJoin
 			*/
 
 			for (int j = 0; j < currCluster->GetControlPointIndicesCount(); j++) {
-				m_controlPointsRestPose[controlPointIndices[j]]->m_jointWeightPairs.emplace_back(currJointIndex, (float)controlPointWeights[j]);
+				m_writableAsset->m_controlPointsRestPose[controlPointIndices[j]]->m_jointWeightPairs.emplace_back(currJointIndex, (float)controlPointWeights[j]);
 			}
 		}
 	}
 
 	//Debugging if skinning data reading was correct
-	for (int i = 0; i < m_controlPointsRestPose.size(); i++) {
+	for (int i = 0; i < m_writableAsset->m_controlPointsRestPose.size(); i++) {
 		float weightSum = 0.0f;
-		for (int jwPairIdx = 0; jwPairIdx < m_controlPointsRestPose[i]->m_jointWeightPairs.size(); jwPairIdx++) {
-			weightSum += m_controlPointsRestPose[i]->m_jointWeightPairs[jwPairIdx].m_weight;
+		for (int jwPairIdx = 0; jwPairIdx < m_writableAsset->m_controlPointsRestPose[i]->m_jointWeightPairs.size(); jwPairIdx++) {
+			weightSum += m_writableAsset->m_controlPointsRestPose[i]->m_jointWeightPairs[jwPairIdx].m_weight;
 		}
 		if (GetAbsf(weightSum - 1.0f) >= 0.1f) {
 			DebuggerPrintf("For control point idx %d, weightSum value is %.3f\n", i, weightSum);
@@ -754,31 +902,31 @@ void FBXMesh::ProcessMaterialOfMesh(FbxMesh& mesh)
 		FbxProperty diffuseMaterialProp = material->FindProperty(FbxSurfaceMaterial::sDiffuse);
 		FbxFileTexture* fileTexture = FbxCast<FbxFileTexture>(diffuseMaterialProp.GetSrcObject<FbxTexture>());
 		if (fileTexture) {
-			m_diffuseTexturePaths.push_back(fileTexture->GetFileName());
+			m_writableAsset->m_diffuseTexturePaths.push_back(fileTexture->GetFileName());
 		}
 
 		FbxProperty specularMaterialProp = material->FindProperty(FbxSurfaceMaterial::sSpecular);
 		fileTexture = FbxCast<FbxFileTexture>(specularMaterialProp.GetSrcObject<FbxTexture>());
 		if (fileTexture) {
-			m_specularTexturePaths.push_back(fileTexture->GetFileName());
+			m_writableAsset->m_specularTexturePaths.push_back(fileTexture->GetFileName());
 		}
 
 		FbxProperty normalMaterialProp = material->FindProperty(FbxSurfaceMaterial::sNormalMap);
 		fileTexture = FbxCast<FbxFileTexture>(normalMaterialProp.GetSrcObject<FbxTexture>());
 		if (fileTexture) {
-			m_normalTexturePaths.push_back(fileTexture->GetFileName());
+			m_writableAsset->m_normalTexturePaths.push_back(fileTexture->GetFileName());
 		}
 
 		FbxProperty ambientMaterialProp = material->FindProperty(FbxSurfaceMaterial::sAmbient);
 		fileTexture = FbxCast<FbxFileTexture>(ambientMaterialProp.GetSrcObject<FbxTexture>());
 		if (fileTexture) {
-			m_ambientTexturePaths.push_back(fileTexture->GetFileName());
+			m_writableAsset->m_ambientTexturePaths.push_back(fileTexture->GetFileName());
 		}
 
 		FbxProperty glossMaterialProp = material->FindProperty(FbxSurfaceMaterial::sShininess);
 		fileTexture = FbxCast<FbxFileTexture>(glossMaterialProp.GetSrcObject<FbxTexture>());
 		if (fileTexture) {
-			m_glossTexturePaths.push_back(fileTexture->GetFileName());
+			m_writableAsset->m_glossTexturePaths.push_back(fileTexture->GetFileName());
 		}
 	}
 }
@@ -887,48 +1035,22 @@ float FBXMesh::GetAnimTimeSpan() const
 
 AABB3 FBXMesh::GetBoundingBox() const
 {
-	return m_boundingBox;
+	return m_asset->m_boundingBox;
 }
 
 FBXMesh* FBXMesh::CreateCopy() const
 {
-	FBXMesh* copy = new FBXMesh(m_creatorParser, m_name, m_nodeIdx);
-
-	copy->m_controlPointsRestPose.reserve(m_controlPointsRestPose.size());
-	for (const FBXControlPoint* controlPoint : m_controlPointsRestPose) {
-		FBXControlPoint* copiedControlPoint = new FBXControlPoint(controlPoint->m_position);
-		copiedControlPoint->m_jointWeightPairs = controlPoint->m_jointWeightPairs;
-		copy->m_controlPointsRestPose.push_back(copiedControlPoint);
-	}
-
-	copy->m_controlPointsMatrixRestPose = m_controlPointsMatrixRestPose;
-	copy->m_facesMatrix = m_facesMatrix;
-
-	copy->m_renderVertexToControlPointMap = m_renderVertexToControlPointMap;
+	//Only what the copy writes on its own is copied, the rest pose, topology, skin weights and DDM precompute are shared
+	FBXMesh* copy = new FBXMesh(m_creatorParser, m_name, m_nodeIdx, m_asset);
 	copy->m_renderVertices = m_renderVertices;
-	copy->m_renderIndices = m_renderIndices;
-
-	copy->m_diffuseTexturePaths = m_diffuseTexturePaths;
-	copy->m_specularTexturePaths = m_specularTexturePaths;
-	copy->m_normalTexturePaths = m_normalTexturePaths;
-	copy->m_glossTexturePaths = m_glossTexturePaths;
-	copy->m_ambientTexturePaths = m_ambientTexturePaths;
 
-	//NOT! copying the modifier!
 	copy->m_ddmModifierCPU = m_ddmModifierCPU;
 	copy->m_ddmModifierGPU = m_ddmModifierGPU;
+	copy->m_rigidDDMModifierCPU = m_rigidDDMModifierCPU;
+	copy->m_rigidDDMModifierGPU = m_rigidDDMModifierGPU;
 
 	copy->m_isMeshDebugMode = m_isMeshDebugMode;
-
-	copy->m_ddmBakerLHSMatrices = m_ddmBakerLHSMatrices;
-	copy->m_ddmBakerRHSMatrices = m_ddmBakerRHSMatrices;
-	copy->m_ddmBakerWeightsForCPs = m_ddmBakerWeightsForCPs;
-
-	copy->m_ddmBakerCPWeightPairsForJoints = m_ddmBakerCPWeightPairsForJoints;
-
-	//For GetWeightsMatrix
 	copy->m_isRigidBinding = m_isRigidBinding;
-	copy->m_boundingBox = m_boundingBox;
 
 	return copy;
 }
@@ -942,8 +1064,8 @@ void FBXMesh::UpdateSceneRigidlySkinnedData()
 {
 	if (m_rigidCPWeightPairsForJoints.size() == 0) {
 		m_rigidCPWeightPairsForJoints.resize(m_model->GetNumJoints());
-		for (int i = 0; i < m_controlPointsRestPose.size(); i++) {
-			JointWeightPair pair = GetMaxInfluenceJointWeightPair(m_controlPointsRestPose[i]->m_jointWeightPairs);
+		for (int i = 0; i < m_asset->m_controlPointsRestPose.size(); i++) {
+			JointWeightPair pair = GetMaxInfluenceJointWeightPair(m_asset->m_controlPointsRestPose[i]->m_jointWeightPairs);
 			m_rigidCPWeightPairsForJoints[pair.m_jointIndex].push_back(CPIdxWeightPair(i, 1.0f));
 		}
 	}
@@ -978,7 +1100,7 @@ void FBXMesh::UpdateSceneRigidlySkinnedData()
 	}
 }
 
-void FBXMesh::CreateVertexAndPushToRenderDataArray(FbxMesh& mesh, std::map<Vertex_FBX, unsigned int>& verticesToIndicesMap, int vertexIndex, int controlPointIndex, int materialIdx)
+Vertex_FBX FBXMesh::CreateVertex(FbxMesh& mesh, int vertexIndex, int controlPointIndex, int materialIdx)
 {
 	Vec3 position;
 	Vec3 normal;
@@ -991,7 +1113,7 @@ void FBXMesh::CreateVertexAndPushToRenderDataArray(FbxMesh& mesh, std::map<Verte
 	Vec4 jointWeights1;
 	Vec4 jointWeights2;
 
-	position = m_controlPointsRestPose[controlPointIndex]->m_position;
+	position = m_asset->m_controlPointsRestPose[controlPointIndex]->m_position;
 	/*
 	normal = ReadNormal(*mesh.GetElementNormal(0), controlPointIndex, vertexIndex);
 	tangent = ReadTangent(*mesh.GetElementTangent(0), controlPointIndex, vertexIndex);
@@ -1020,7 +1142,7 @@ void FBXMesh::CreateVertexAndPushToRenderDataArray(FbxMesh& mesh, std::map<Verte
 		uv = ReadUV(*mesh.GetElementUV(0), controlPointIndex, vertexIndex);
 	}
 
-	const std::vector<JointWeightPair>& jointWeightPairs = m_controlPointsRestPose[controlPointIndex]->m_jointWeightPairs;
+	const std::vector<JointWeightPair>& jointWeightPairs = m_asset->m_controlPointsRestPose[controlPointIndex]->m_jointWeightPairs;
 	int jointWeightPairsNum = GetMin((int)jointWeightPairs.size(), 8);
 	for (int jwPairIdx = 0; jwPairIdx < jointWeightPairsNum; jwPairIdx++) {
 		if (jwPairIdx < 4) {
@@ -1043,18 +1165,7 @@ void FBXMesh::CreateVertexAndPushToRenderDataArray(FbxMesh& mesh, std::map<Verte
 	}
 	*/
 
-	Vertex_FBX newVertex(position, normal, tangent, binormal, color, uv, jointIndices1, jointIndices2, jointWeights1, jointWeights2, materialIdx);
-
-	auto foundNewVertexIndexPair = verticesToIndicesMap.find(newVertex);
-	if (foundNewVertexIndexPair == verticesToIndicesMap.end()) {
-		verticesToIndicesMap[newVertex] = (unsigned int)m_renderVertices.size();
-		m_renderIndices.push_back((unsigned int)m_renderVertices.size());
-		m_renderVertices.push_back(newVertex);
-		m_renderVertexToControlPointMap.push_back(controlPointIndex); 
-	}
-	else {
-		m_renderIndices.push_back(foundNewVertexIndexPair->second);
-	}
+	return Vertex_FBX(position, normal, tangent, binormal, color, uv, jointIndices1, jointIndices2, jointWeights1, jointWeights2, materialIdx);
 }
 
 Vec3 FBXMesh::ReadNormal(const FbxGeometryElementNormal& normalElement, int ctrlPointIndex, int vertexIndex)
@@ -1,8 +1,13 @@
 #pragma once
 #include "Engine/Fbx/Vertex_FBX.hpp"
 #include "Engine/Fbx/FBXControlPoint.hpp"
+#include "Engine/Fbx/FBXMeshAsset.hpp"
 #include "Engine/Fbx/FBXModel.hpp"
 #include "Engine/Fbx/FBXPose.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXDDMVertexWriteback.hpp"
+#include "Engine/Fbx/FBXSkinningCPU.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/AABB3.hpp"
@@ -25,6 +30,9 @@ class FBXJoint;
 class FBXDDMModifierCPU;
 class FBXDDMModifierGPU;
 class FBXParser;
+class FBXCookedModel;
+struct FBXCookedMeshView;
+struct FBXCookedMeshData;
 
 class FBXMesh {
 	friend class FBXParser;
@@ -38,20 +46,24 @@ public:
 	void Render(Renderer& renderer) const;
 	void SetFBXModel(FBXModel& model);
 	void AddDDMModifier();
-	std::shared_ptr<FBXDDMModifierCPU> GetDDMModifierCPU() const;
+	std::shared_ptr<FBXDDMModifierCPU> GetDDMModifierCPU() const;	//Of the current binding, see SetRigidBinding
 	std::shared_ptr<FBXDDMModifierGPU> GetDDMModifierGPU() const;
+	void SetDDMOmegaEpsilon(double omegaEpsilon);	//See FBXDDMModifier::GetOmegaEpsilon. Needs PrecomputeDDM again when it changes
+	void SetDDMNeedsRecalculation();	//Both the CPU and the GPU deform
+	void SetDDMCPUNeedsRecalculation();
 	void PrecomputeDDM(bool isCPUSide, bool useCotangentLaplacian, int numLaplacianIterations, float lambda, float kappa, float alpha);
 	void ApplyDDMv0_CPU(const std::vector<Mat44>& allJointSkinningMatrices);
 	void ApplyDDMv1_CPU(const std::vector<Mat44>& allJointSkinningMatrices);
 	void ApplyDDMv0_GPU(const std::vector<Mat44>& allJointSkinningMatrices);
 	void ApplyDDMv1_GPU(const std::vector<Mat44>& allJointSkinningMatrices);
+	void ApplySkinning_CPU(const std::vector<Mat44>& allJointSkinningMatrices, CPUSkinningMethod method);	//Only the positions, like DDM
 
 	void RestoreGPUVerticesToRestPose();
 	void SetRigidBinding(bool isRigidBound);
 
-	Eigen::MatrixX3d GetControlPointsMatrixRestPose() const;
-	Eigen::MatrixX3i GetFacesMatrix() const;
-	Eigen::MatrixXd GetWeightsMatrix() const;
+	const Eigen::MatrixX3d& GetControlPointsMatrixRestPose() const;
+	const Eigen::MatrixX3i& GetFacesMatrix() const;
+	const DDMSkinWeights& GetWeightsMatrix() const;	//Follows SetRigidBinding
 
 	int GetNumVertices() const;
 	int GetNumJoints() const;
@@ -59,7 +71,7 @@ public:
 
 	void ToggleMeshDebugMode();
 
-	void PrepareDDMBaker(int numPoses);
+	void PrepareDDMBaker(int numPoses, DDMBakerSolveMode solveMode, const DDMBakerCandidateParameters* candidateParameters, const std::vector<int>& jointParentIndices);	//nullptr: every joint
 	void FillLHSMatForDDMBaker(const std::vector<Mat44>& allJointSkinningMatrices, int poseIdx);
 	void FillRHSMatForDDMBaker(const std::vector<Mat44>& allJointSkinningMatrices, int poseIdx);
 	void SolveDDMBakerLinearSystems(int numMaxBones, float pruneThreshold);
@@ -81,12 +93,21 @@ public:
 
 private:
 	FBXMesh(FBXParser& creatorParser, const std::string& name, int nodeIdx);	//Only FBXParser can make this
+	FBXMesh(FBXParser& creatorParser, const std::string& name, int nodeIdx, const std::shared_ptr<const FBXMeshAsset>& asset);	//For CreateCopy
+	void CreateDDMModifiers(double omegaEpsilon);	//Of both bindings, not precomputed yet
+	void ProcessCookedMesh(const FBXCookedModel& cookedModel, const FBXCookedMeshView& cookedMesh, int numJoints);	//Ends up where ProcessFbxMesh does, without a scene
+	void FillCookedMeshData(FBXCookedMeshData& out_cookedMesh) const;
 	Eigen::MatrixX3f GetDDMv0_GPU_Deformation(const std::vector<Mat44>& allJointSkinningMatrices);	//ALWAYS calculate
+	DDMRenderVertexWriteback& GetDDMRenderVertexWriteback();	//Built on first use
+	void UploadDDMDirtyRenderVertices();
+	const std::vector<int>* GetDDMChangedJointIndices(const std::vector<Mat44>& allJointSkinningMatrices, int ddmVariant);	//Since the last CPU DDM write of that variant, nullptr when the whole mesh has to be deformed
+	void InvalidateDDMWrittenJointSkinningMatrices();	//Whenever something other than the CPU DDM writes the positions of m_renderVertices, or the DDM precompute changes
+	const CPUSkinningVertexBlocks& GetCPUSkinningVertexBlocks();	//Built on first use, again after SetRigidBinding
 
 private:
 	void ProcessSkinningDataOfMesh(FbxMesh& mesh, const std::vector<FBXJoint*>& joints);
 	void ProcessMaterialOfMesh(FbxMesh& mesh);
-	void CreateVertexAndPushToRenderDataArray(FbxMesh& mesh, std::map<Vertex_FBX, unsigned int>& verticesToIndicesMap, int vertexIndex, int controlPointIndex, int materialIdx);
+	Vertex_FBX CreateVertex(FbxMesh& mesh, int vertexIndex, int controlPointIndex, int materialIdx);
 	bool IsMeshMappingModeAllTheSame(FbxMesh& mesh) const;
 
 	template<typename ReturnType, typename ElementType, typename ElementFbxVectorType>
@@ -106,19 +127,16 @@ private:
 	const int m_nodeIdx = -1;
 	FBXModel* m_model = nullptr;
 
-	std::vector<FBXControlPoint*> m_controlPointsRestPose;
-	Eigen::MatrixX3d m_controlPointsMatrixRestPose;
-	Eigen::MatrixX3i m_facesMatrix;
+	std::shared_ptr<FBXMeshAsset> m_writableAsset;	//Only set on the meshes FBXParser makes, ProcessFbxMesh and ProcessCookedMesh fill it in through this
+	std::shared_ptr<const FBXMeshAsset> m_asset;	//m_writableAsset, shared read only with every CreateCopy of this mesh
 
-	std::vector<unsigned int> m_renderVertexToControlPointMap;
 	std::vector<Vertex_FBX> m_renderVertices;
-	std::vector<unsigned int> m_renderIndices;
-
-	std::vector<std::string> m_diffuseTexturePaths;
-	std::vector<std::string> m_specularTexturePaths;
-	std::vector<std::string> m_normalTexturePaths;
-	std::vector<std::string> m_glossTexturePaths;
-	std::vector<std::string> m_ambientTexturePaths;
+	DDMRenderVertexWriteback m_ddmRenderVertexWriteback;	//Where the DDM deformations go into m_renderVertices
+	std::vector<Mat44> m_ddmWrittenJointSkinningMatrices;	//What the positions of m_renderVertices were deformed with by the last CPU DDM write
+	int m_ddmWrittenVariant = -1;	//Of that write, -1 when the positions came from somewhere else
+	std::vector<int> m_ddmChangedJointIndices;
+	CPUSkinningVertexBlocks m_cpuSkinningVertexBlocks;
+	bool m_areCPUSkinningVertexBlocksOutdated = true;
 
 	std::vector<Texture*> m_diffuseTextures;
 	std::vector<Texture*> m_specularTextures;
@@ -133,13 +151,18 @@ private:
 	//float m_animStartTime = 0.0f;
 	//float m_animEndTime = 0.0f;
 
+	//Built from m_asset alone, so CreateCopy shares them and they outlive this mesh. One per binding since the skinned and the rigid weights
+	//precompute to different omegas: SetRigidBinding picks the other one instead of redoing the precompute every copy deforms with
 	std::shared_ptr<FBXDDMModifierCPU> m_ddmModifierCPU = nullptr;
 	std::shared_ptr<FBXDDMModifierGPU> m_ddmModifierGPU = nullptr;
+	std::shared_ptr<FBXDDMModifierCPU> m_rigidDDMModifierCPU = nullptr;
+	std::shared_ptr<FBXDDMModifierGPU> m_rigidDDMModifierGPU = nullptr;
+	DDMModifierInstanceState m_ddmInstanceStateCPU;	//This mesh's own, whichever modifier it deforms with
+	DDMModifierInstanceState m_ddmInstanceStateGPU;
 
 	bool m_isMeshDebugMode = false;
 
-	std::vector<Eigen::MatrixXf> m_ddmBakerLHSMatrices;	//length should be num control points
-	std::vector<Eigen::MatrixXf> m_ddmBakerRHSMatrices;	//length should be num control points
+	DDMBakerLinearSystems m_ddmBakerSystems;
 	std::vector<Eigen::MatrixXf> m_ddmBakerWeightsForCPs;	//length should be num control points
 	struct CPIdxWeightPair {
 	public:
@@ -164,10 +187,7 @@ private:
 	ConstantBuffer* m_fbxMeshCBO = nullptr;
 	const int k_fbxMeshConstantsSlot = 4;
 
-	//For GetWeightsMatrix
-	bool m_isRigidBinding = false;
-
-	AABB3 m_boundingBox;
+	bool m_isRigidBinding = false;	//Which of m_asset's weights matrices GetWeightsMatrix returns
 };
 
 //Template member function implementation
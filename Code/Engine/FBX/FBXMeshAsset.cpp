@@ -0,0 +1,39 @@
+#include "Engine/Fbx/FBXMeshAsset.hpp"
+
+FBXMeshAsset::~FBXMeshAsset()
+{
+	for (int i = 0; i < (int)m_controlPointsRestPose.size(); i++) {
+		if (m_controlPointsRestPose[i]) {
+			delete m_controlPointsRestPose[i];
+			m_controlPointsRestPose[i] = nullptr;
+		}
+	}
+}
+
+static size_t GetNumBytesOfSkinWeights(const DDMSkinWeights& weights)
+{
+	return (size_t)weights.nonZeros() * (sizeof(double) + sizeof(int)) + (size_t)(weights.outerSize() + 1) * sizeof(int);
+}
+
+static size_t GetNumBytesOfTexturePaths(const std::vector<std::string>& texturePaths)
+{
+	size_t numBytes = texturePaths.capacity() * sizeof(std::string);
+	for (const std::string& texturePath : texturePaths) {
+		numBytes += texturePath.capacity();
+	}
+	return numBytes;
+}
+
+size_t FBXMeshAsset::GetNumBytes() const
+{
+	size_t numBytes = m_controlPointsRestPose.capacity() * sizeof(FBXControlPoint*);
+	for (const FBXControlPoint* controlPoint : m_controlPointsRestPose) {
+		numBytes += sizeof(FBXControlPoint) + controlPoint->m_jointWeightPairs.capacity() * sizeof(JointWeightPair);
+	}
+	numBytes += (size_t)m_controlPointsMatrixRestPose.size() * sizeof(double) + (size_t)m_facesMatrix.size() * sizeof(int);
+	numBytes += (m_renderVertexToControlPointMap.capacity() + m_renderIndices.capacity()) * sizeof(unsigned int);
+	numBytes += GetNumBytesOfTexturePaths(m_diffuseTexturePaths) + GetNumBytesOfTexturePaths(m_specularTexturePaths) + GetNumBytesOfTexturePaths(m_normalTexturePaths)
+		+ GetNumBytesOfTexturePaths(m_glossTexturePaths) + GetNumBytesOfTexturePaths(m_ambientTexturePaths);
+	numBytes += GetNumBytesOfSkinWeights(m_weightsMatrix) + GetNumBytesOfSkinWeights(m_rigidWeightsMatrix);
+	return numBytes;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Engine/Fbx/FBXControlPoint.hpp"
+#include "Engine/Fbx/FBXDDMPrecompute.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include <Eigen/Dense>
+#include <vector>
+#include <string>
+
+//The part of an FBXMesh that is read only once the mesh is loaded: the rest pose, the topology, the skin weights and the texture paths.
+//FBXModel::CreateCopy hands the same one to every copy through a std::shared_ptr, and it goes away with the last mesh holding it.
+//What a copy writes on its own (the render vertices, the GPU buffers, the DDM writeback and deform state, the rigid binding toggle) stays in FBXMesh
+struct FBXMeshAsset {
+public:
+	FBXMeshAsset() {};
+	~FBXMeshAsset();
+	FBXMeshAsset(const FBXMeshAsset& copyFrom) = delete;
+	FBXMeshAsset& operator=(const FBXMeshAsset& copyFrom) = delete;
+
+	size_t GetNumBytes() const;	//Heap memory, which is what every copy would pay for without sharing
+
+public:
+	std::vector<FBXControlPoint*> m_controlPointsRestPose;	//Owned
+	Eigen::MatrixX3d m_controlPointsMatrixRestPose;
+	Eigen::MatrixX3i m_facesMatrix;
+
+	std::vector<unsigned int> m_renderVertexToControlPointMap;
+	std::vector<unsigned int> m_renderIndices;
+
+	std::vector<std::string> m_diffuseTexturePaths;
+	std::vector<std::string> m_specularTexturePaths;
+	std::vector<std::string> m_normalTexturePaths;
+	std::vector<std::string> m_glossTexturePaths;
+	std::vector<std::string> m_ambientTexturePaths;
+
+	//Both are built once the skinning data is read, the joint weight pairs never change after that
+	DDMSkinWeights m_weightsMatrix;
+	DDMSkinWeights m_rigidWeightsMatrix;
+
+	AABB3 m_boundingBox;
+};
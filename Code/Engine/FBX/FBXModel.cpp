@@ -5,10 +5,9 @@
 #include "Engine/Fbx/FBXDDMModifierCPU.hpp"
 #include "Engine/Fbx/FBXDDMModifierGPU.hpp"
 #include "Engine/Fbx/FBXDDMBakingJob.hpp"
-#include "Engine/Fbx/FBXDDMV0CPUJob.hpp"
-#include "Engine/Fbx/FBXDDMV1CPUJob.hpp"
-#include "Engine/Fbx/FBXDDMOmegaPrecomputeJob.hpp"
 #include "Engine/Fbx/FBXParser.hpp"
+#include "Engine/Fbx/FBXPose.hpp"
+#include "Engine/Fbx/FBXSkinningCPU.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/GPUMesh.hpp"
@@ -18,6 +17,21 @@
 #include "Engine/Renderer/DebugRender.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/MathUtils.hpp"
+#include <algorithm>
+#include <cstring>
+
+bool IsDDMSkinningModifier(FBXModelSkinningModifier modifier)
+{
+	switch (modifier) {
+	case FBXModelSkinningModifier::DDM_CPU_v0:
+	case FBXModelSkinningModifier::DDM_CPU_v1:
+	case FBXModelSkinningModifier::DDM_GPU_v0:
+	case FBXModelSkinningModifier::DDM_GPU_v1:
+		return true;
+	default:
+		return false;
+	}
+}
 
 FBXModel::FBXModel(const FBXModelConfig& config, const std::string& fileName)
 	: m_config(config), m_jointGizmosManager(*this, config.m_renderer), m_fileName(fileName), m_ikSolver(nullptr)
@@ -52,7 +66,7 @@ void FBXModel::SetRigidBinding(bool isRigidBind)
 	}
 
 	//Have to precompute again if it's not lbs
-	if (m_skinningModifier != FBXModelSkinningModifier::LBS) {
+	if (IsDDMSkinningModifier(m_skinningModifier)) {
 		PrecomputeDDM(
 			m_latestPrecomputeConstants.m_isCPUSide,
 			m_latestPrecomputeConstants.m_useCotangentLaplacian,
@@ -64,8 +78,7 @@ void FBXModel::SetRigidBinding(bool isRigidBind)
 	}
 
 	for (int i = 0; i < m_meshes.size(); i++) {
-		m_meshes[i]->GetDDMModifierCPU()->SetNeedsRecalculation();
-		m_meshes[i]->GetDDMModifierGPU()->SetNeedsRecalculation();
+		m_meshes[i]->SetDDMNeedsRecalculation();
 	}
 }
 
@@ -102,6 +115,12 @@ int FBXModel::GetNumControlPoints() const
 
 FBXModel::~FBXModel()
 {
+	if (m_bakingJob) {
+		g_theJobSystem->Wait(m_bakingJobHandle);	//The baking job works on this model's meshes
+		delete m_bakingJob;
+		m_bakingJob = nullptr;
+	}
+
 	if (m_sboForJointGlobalTransforms) {
 		delete m_sboForJointGlobalTransforms;
 		m_sboForJointGlobalTransforms = nullptr;
@@ -141,8 +160,9 @@ void FBXModel::Startup()
 		m_joints[i]->SetConeSphereRadius( newRadius );
 	}
 
+	SetSkeletonFromJoints();
 	InstantiateGPUData();
-	std::vector<Mat44> jointGlobalBindInverseList = GetJointGlobalBindPoseInverseList();
+	const std::vector<Mat44>& jointGlobalBindInverseList = m_skeleton.m_globalBindPoseInverses;
 	m_config.m_renderer.CopyCPUToGPU(jointGlobalBindInverseList.data(), jointGlobalBindInverseList.size() * sizeof(Mat44), unsigned int(sizeof(Mat44)), (unsigned int)jointGlobalBindInverseList.size(), m_sboForJointGlobalBindInverses);
 	m_config.m_renderer.BindStructuredBufferToVS(m_sboForJointGlobalBindInverses, SLOT_SBO_JOINTGLOBALBINDPOSEINVERSES);	//This should NOT be called every frame
 }
@@ -153,8 +173,7 @@ void FBXModel::ToggleAnimationMode()
 	
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
-			m_meshes[i]->GetDDMModifierCPU()->SetNeedsRecalculation();
-			m_meshes[i]->GetDDMModifierGPU()->SetNeedsRecalculation();
+			m_meshes[i]->SetDDMNeedsRecalculation();
 		}
 		else {
 			ERROR_AND_DIE("FBXModel::m_meshes[i] == nullptr");
@@ -171,20 +190,14 @@ void FBXModel::Update(const Camera& worldCamera)
 {
 	//Check if baking is in progress
 	if (m_isBakingInProgress) {
-		Job* completedBakingJob = g_theJobSystem->GetCompletedJob();
-		GUARANTEE_OR_DIE(dynamic_cast<FBXDDMV0CPUJob*>(completedBakingJob) == nullptr, "Make sure no other job is in progress when baking job is happening!");
-		GUARANTEE_OR_DIE(dynamic_cast<FBXDDMV1CPUJob*>(completedBakingJob) == nullptr, "Make sure no other job is in progress when baking job is happening!");
-		GUARANTEE_OR_DIE(dynamic_cast<FBXDDMOmegaPrecomputeJob*>(completedBakingJob) == nullptr, "Make sure no other job is in progress when baking job is happening!");
 		GUARANTEE_OR_DIE(m_skinningModifier == FBXModelSkinningModifier::LBS, "When baking stats, the modifier should change to LBS!");
 
-		FBXDDMBakingJob* realBakingJob = dynamic_cast<FBXDDMBakingJob*>(completedBakingJob);
-
 		if (m_joints.size() > 0 && m_joints[0]) {
-			m_joints[0]->RecursivelyUpdateGlobalTransformBindPoseForThisFrame(Mat44());
+			UpdateSkeleton(nullptr);
 			UpdateJointGlobalTransformsStructuredBuffer();
 		}
 
-		if (realBakingJob) {
+		if (m_bakingJobHandle.IsCompleted()) {
 			int numJoints = (int)GetNumJoints();
 			//Restore joint transformations
 			for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
@@ -195,7 +208,9 @@ void FBXModel::Update(const Camera& worldCamera)
 				m_meshes[meshIdx]->RestoreGPUVerticesToRestPose();
 			}
 
-			delete realBakingJob;
+			delete m_bakingJob;
+			m_bakingJob = nullptr;
+			m_bakingJobHandle = JobHandle();
 			m_isBakingInProgress = false;
 			SetSkinningModifierState(m_preBakingSkinningModifier);
 		}
@@ -208,22 +223,22 @@ void FBXModel::Update(const Camera& worldCamera)
 
 		//DebuggerPrintf("m_keyframeIdx0ToPlay: %d\n", m_keyframeIdx0ToPlay);
 
-		if (m_skinningModifier != FBXModelSkinningModifier::LBS) {
-			SetDDMNeedsRecalculation();
-		}
-
 		if (m_joints.size() > 0 && m_joints[0]) {
 			const FBXPose& pose = m_animManager->GetPoseForThisFrame();
-			m_joints[0]->SetPoseIfThisIsRoot(pose);
+			UpdateSkeleton(&pose);
 		}
 	}
 	else {
 		if (m_joints.size() > 0 && m_joints[0]) {
-			m_joints[0]->RecursivelyUpdateGlobalTransformBindPoseForThisFrame(Mat44());
+			UpdateSkeleton(nullptr);
 		}
 	}
 	if (m_isIKOn) {
 		m_ikSolver.Solve();
+		ReadSkeletonGlobalTransformsFromJoints();
+	}
+	if (IsDDMSkinningModifier(m_skinningModifier) && !m_skeleton.m_changedJointIndices.empty()) {
+		SetDDMNeedsRecalculation();	//A paused animation or an untouched rig leaves the deformation as it is
 	}
 
 	switch (m_skinningModifier) {
@@ -241,6 +256,12 @@ void FBXModel::Update(const Camera& worldCamera)
 	case FBXModelSkinningModifier::DDM_GPU_v1:
 		ApplyDDMv1_GPU();
 		break;
+	case FBXModelSkinningModifier::LBS_CPU:
+		ApplySkinning_CPU(CPUSkinningMethod::LINEAR_BLEND);
+		break;
+	case FBXModelSkinningModifier::DQS_CPU:
+		ApplySkinning_CPU(CPUSkinningMethod::DUAL_QUATERNION);
+		break;
 	default:
 		ERROR_AND_DIE("Invalid skinning state!");
 	}
@@ -286,7 +307,7 @@ void FBXModel::SetIsAnimationMode(bool isAnimationMode)
 	if (m_animManager->IsActive() != isAnimationMode) {
 		for (int i = 0; i < m_meshes.size(); i++) {
 			if (m_meshes[i]) {
-				m_meshes[i]->GetDDMModifierCPU()->SetNeedsRecalculation();
+				m_meshes[i]->SetDDMCPUNeedsRecalculation();
 			}
 			else {
 				ERROR_AND_DIE("FBXModel::m_meshes[i] == nullptr");
@@ -408,7 +429,7 @@ void FBXModel::ToggleRigidBinding()
 
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
-			m_meshes[i]->GetDDMModifierCPU()->SetNeedsRecalculation();
+			m_meshes[i]->SetDDMCPUNeedsRecalculation();
 		}
 		else {
 			ERROR_AND_DIE("FBXModel::m_meshes[i] == nullptr");
@@ -433,6 +454,9 @@ void FBXModel::SetSkinningModifierState(FBXModelSkinningModifier modifier)
 			m_meshes[i]->RestoreGPUVerticesToRestPose();
 		}
 	}
+	if (IsDDMSkinningModifier(m_skinningModifier)) {
+		SetDDMNeedsRecalculation();	//Update only asks for it when a joint moved, and the vertices hold what the previous modifier left
+	}
 }
 
 FBXModelSkinningModifier FBXModel::GetSkinningModifierState() const
@@ -499,8 +523,9 @@ void FBXModel::SetIsIKOn(bool isIKOn)
 
 FBXModel* FBXModel::CreateCopy(const Vec3& offset) const
 {
+	//The joints, the skeleton, the animation clock and the meshes' render vertices and GPU buffers are the copy's own.
+	//The meshes' FBXMeshAsset, the DDM modifiers and the pose sequence are shared with this model and every other copy of it
 	FBXModel* copiedModel = new FBXModel(m_config, m_fileName);
-	//TODO: Deep copiedModel m_meshes and m_joints
 	copiedModel->m_joints.reserve(m_joints.size());
 	copiedModel->m_meshes.reserve(m_meshes.size());
 	for (FBXJoint* joint : m_joints) {
@@ -525,11 +550,8 @@ FBXModel* FBXModel::CreateCopy(const Vec3& offset) const
 		}
 	}
 
-	copiedModel->m_animManager = m_animManager->CreateCopy();
-	std::vector<FBXPose>& poses = copiedModel->m_animManager->GetFBXPoseSequence();
-	for (FBXPose& pose : poses) {
-		pose.SetRootJoint(*copiedModel->m_joints[0]);
-	}
+	copiedModel->m_animManager = m_animManager->CreateCopy();	//Shares the pose sequence
+	copiedModel->m_animManager->SetFBXModel(*copiedModel);
 
 	copiedModel->Startup();
 	copiedModel->m_joints[0]->SetLocalDeltaTranslate(offset);
@@ -580,24 +602,39 @@ int FBXModel::GetNumVertices() const
 	return numVertices;
 }
 
+void FBXModel::SetDDMOmegaEpsilon(float omegaEpsilon)
+{
+	for (int i = 0; i < m_meshes.size(); i++) {
+		if (m_meshes[i] == nullptr) {
+			continue;
+		}
+		m_meshes[i]->SetDDMOmegaEpsilon(omegaEpsilon);
+	}
+
+	//Same as SetRigidBinding, the omegas have to be precomputed again
+	if (IsDDMSkinningModifier(m_skinningModifier)) {
+		PrecomputeDDM(
+			m_latestPrecomputeConstants.m_isCPUSide,
+			m_latestPrecomputeConstants.m_useCotangentLaplacian,
+			m_latestPrecomputeConstants.m_numLaplacianIterations,
+			m_latestPrecomputeConstants.m_lambda,
+			m_latestPrecomputeConstants.m_kappa,
+			m_latestPrecomputeConstants.m_alpha
+		);
+	}
+}
+
 void FBXModel::SetDDMNeedsRecalculation()
 {
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
-			std::shared_ptr<FBXDDMModifierCPU> ddmModifierCPU = m_meshes[i]->GetDDMModifierCPU();
-			if (ddmModifierCPU) {
-				ddmModifierCPU->SetNeedsRecalculation();
-			}
-			else {
+			if (m_meshes[i]->GetDDMModifierCPU() == nullptr) {
 				ERROR_AND_DIE("Mesh should have FBXDDMModifierCPU!");
 			}
-			std::shared_ptr<FBXDDMModifierGPU> ddmModifierGPU = m_meshes[i]->GetDDMModifierGPU();
-			if (ddmModifierGPU) {
-				ddmModifierGPU->SetNeedsRecalculation();
-			}
-			else {
+			if (m_meshes[i]->GetDDMModifierGPU() == nullptr) {
 				ERROR_AND_DIE("Mesh should have FBXDDMModifierCPU!");
 			}
+			m_meshes[i]->SetDDMNeedsRecalculation();
 		}
 		else {
 			ERROR_AND_DIE("FBXModel::m_meshes[i] can't be nullptr");
@@ -614,18 +651,21 @@ void FBXModel::ToggleMeshDebugMode()
 	}
 }
 
-void FBXModel::InitiateDDMBaking(FBXParser& fbxParser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold)
+void FBXModel::InitiateDDMBaking(FBXParser& fbxParser, const std::string& exportFileName, int numPoses, int numMaxBones, float twistLimit, float pruneThreshold,
+	DDMBakerSolveMode solveMode, unsigned int seed, int maxNumCandidateJoints)
 {
-	GUARANTEE_OR_DIE(m_skinningModifier != FBXModelSkinningModifier::LBS, "m_skinningModifier is LBS");
+	GUARANTEE_OR_DIE(IsDDMSkinningModifier(m_skinningModifier), "m_skinningModifier is not a DDM one");
 	GUARANTEE_OR_DIE(numPoses > 0, "numPoses <= 0");
 	GUARANTEE_OR_DIE(numMaxBones > 0, "numMaxBones <= 0");
 	GUARANTEE_OR_DIE(twistLimit > 0.0f, "twistLimit <= 0.0f");
 	GUARANTEE_OR_DIE(pruneThreshold >= 0.0f, "pruneThreshold < 0.0f");
+	GUARANTEE_OR_DIE(maxNumCandidateJoints >= 0, "maxNumCandidateJoints < 0");
 
 	g_theJobSystem->WaitUntilAllJobsCompleted();
 
-	FBXDDMBakingJob* bakingJob = new FBXDDMBakingJob(*this, fbxParser, exportFileName, numPoses, numMaxBones, twistLimit, pruneThreshold);
-	g_theJobSystem->PostNewJob(bakingJob);
+	m_bakingJob = new FBXDDMBakingJob(*this, fbxParser, exportFileName, numPoses, numMaxBones, twistLimit, pruneThreshold, solveMode, seed, maxNumCandidateJoints);
+	m_bakingJob->SetCategory(JobCategory::BACKGROUND);	//Takes many frames, must not hold up frame critical jobs
+	m_bakingJobHandle = g_theJobSystem->PostNewJob(m_bakingJob);
 	m_isBakingInProgress = true;
 	m_animManager->SetIsActive(false);
 	m_jointGizmosManager.SetSelectedJoint(nullptr);
@@ -697,21 +737,100 @@ void FBXModel::RenderAllJoints() const
 	}
 }
 
-void FBXModel::UpdateJointGlobalTransformsStructuredBuffer()
+void FBXModel::SetSkeletonFromJoints()
 {
-	std::vector<Mat44> keys = GetJointGlobalTransformList();
-	m_config.m_renderer.CopyCPUToGPU(keys.data(), keys.size() * sizeof(Mat44), unsigned int(sizeof(Mat44)), (unsigned int)keys.size(), m_sboForJointGlobalTransforms);
+	int numJoints = (int)m_joints.size();
+	std::vector<int> parentIndices(numJoints, -1);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		GUARANTEE_OR_DIE(m_joints[jointIdx] != nullptr, "m_joints should NOT have a nullptr element");
+		const FBXJoint* parentJoint = m_joints[jointIdx]->GetParentJoint();
+		for (int parentIdx = 0; parentIdx < jointIdx && parentJoint != nullptr; parentIdx++) {
+			if (m_joints[parentIdx] == parentJoint) {
+				parentIndices[jointIdx] = parentIdx;
+				break;
+			}
+		}
+		GUARANTEE_OR_DIE(parentJoint == nullptr || parentIndices[jointIdx] >= 0, "A joint of the model comes before its parent");
+	}
+	m_skeleton.SetJoints(parentIndices, GetJointGlobalBindPoseInverseList());
+	UpdateSkeleton(nullptr);
 }
 
-void FBXModel::ApplyDDMv0_CPU()
+void FBXModel::UpdateSkeleton(const FBXPose* pose)
 {
-	std::vector<Mat44> allJointSkinningMatrices;
-	for (int i = 0; i < m_joints.size(); i++) {
-		if (m_joints[i]) {
-			allJointSkinningMatrices.emplace_back(m_joints[i]->GetSkinningMatrixForThisFrame());
+	int numJoints = m_skeleton.GetNumJoints();
+	GUARANTEE_OR_DIE(numJoints == (int)m_joints.size(), "Call FBXModel::SetSkeletonFromJoints() first");
+	GUARANTEE_OR_DIE(pose == nullptr || pose->GetRootJoint() == m_joints[0], "Pose applied to a different skeleton");
+	int numPoseJoints = pose != nullptr ? (int)pose->GetNumJoints() : 0;	//The joints under m_joints[0], same indices
+	Vec4 localScaling;
+	Quaternion localQuat;
+	Vec4 localLoc;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		const FBXJoint& joint = *m_joints[jointIdx];
+		Vec3 localTranslation = joint.GetOriginalLocalTranslate();
+		Quaternion localRotation = joint.GetOriginalLocalRotate();
+		Vec3 localScale(1.0f, 1.0f, 1.0f);
+		if (jointIdx < numPoseJoints) {
+			pose->GetJointPoseEntry(jointIdx, localScaling, localQuat, localLoc);
+			localTranslation = Vec3(localLoc);
+			localRotation = localQuat;
+			localScale = Vec3(localScaling);
+		}
+		if (joint.IsTranslationModifiedByGizmo()) {
+			localTranslation += joint.GetLocalDeltaTranslate();
+		}
+		m_skeleton.SetLocalTransform(jointIdx, localTranslation, localRotation, localScale);	//Only dirties the joint when something actually changed
+		if (joint.IsRotationModifiedByGizmo()) {
+			m_skeleton.SetLocalPostRotation(jointIdx, joint.GetLocalDeltaRotate());
 		}
+		else {
+			m_skeleton.ClearLocalPostRotation(jointIdx);
+		}
+	}
+	m_skeleton.UpdateGlobalTransforms();
+	for (int jointIdx : m_skeleton.m_changedJointIndices) {
+		m_joints[jointIdx]->SetGlobalTransformForThisFrame(m_skeleton.m_globalTransforms[jointIdx]);
+	}
+	if (!m_skeleton.m_changedJointIndices.empty()) {
+		m_areJointGlobalTransformsChanged = true;
+	}
+}
+
+void FBXModel::ReadSkeletonGlobalTransformsFromJoints()
+{
+	std::vector<int>& changedJointIndices = m_skeleton.m_changedJointIndices;
+	size_t numUpdatedJoints = changedJointIndices.size();	//The sorted part, what gets read is appended after it
+	for (int jointIdx = 0; jointIdx < m_skeleton.GetNumJoints(); jointIdx++) {
+		Mat44 globalTransform = m_joints[jointIdx]->GetGlobalTransformForThisFrame();
+		if (memcmp(&globalTransform, &m_skeleton.m_globalTransforms[jointIdx], sizeof(Mat44)) == 0) {
+			continue;
+		}
+		m_skeleton.m_globalTransforms[jointIdx] = globalTransform;
+		m_skeleton.m_skinningMatrices[jointIdx] = m_joints[jointIdx]->GetSkinningMatrixForThisFrame();
+		m_skeleton.MarkLocalTransformDirty(jointIdx);	//No longer what its local transform gives, so the next update recomputes it even if nothing else moves
+		if (!std::binary_search(changedJointIndices.begin(), changedJointIndices.begin() + numUpdatedJoints, jointIdx)) {
+			changedJointIndices.push_back(jointIdx);
+		}
+	}
+	if (changedJointIndices.size() > numUpdatedJoints) {
+		std::inplace_merge(changedJointIndices.begin(), changedJointIndices.begin() + numUpdatedJoints, changedJointIndices.end());
+		m_areJointGlobalTransformsChanged = true;
+	}
+}
+
+void FBXModel::UpdateJointGlobalTransformsStructuredBuffer()
+{
+	if (m_areJointGlobalTransformsChanged == false) {
+		return;
 	}
+	const std::vector<Mat44>& globalTransforms = m_skeleton.m_globalTransforms;
+	m_config.m_renderer.CopyCPUToGPU(globalTransforms.data(), globalTransforms.size() * sizeof(Mat44), unsigned int(sizeof(Mat44)), (unsigned int)globalTransforms.size(), m_sboForJointGlobalTransforms);
+	m_areJointGlobalTransformsChanged = false;
+}
 
+void FBXModel::ApplyDDMv0_CPU()
+{
+	const std::vector<Mat44>& allJointSkinningMatrices = m_skeleton.m_skinningMatrices;
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
 			m_meshes[i]->ApplyDDMv0_CPU(allJointSkinningMatrices);
@@ -772,13 +891,7 @@ Clock& FBXModel::GetRefToAnimPlayerClock()
 
 void FBXModel::ApplyDDMv1_CPU()
 {
-	std::vector<Mat44> allJointSkinningMatrices;
-	for (int i = 0; i < m_joints.size(); i++) {
-		if (m_joints[i]) {
-			allJointSkinningMatrices.emplace_back(m_joints[i]->GetSkinningMatrixForThisFrame());
-		}
-	}
-
+	const std::vector<Mat44>& allJointSkinningMatrices = m_skeleton.m_skinningMatrices;
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
 			m_meshes[i]->ApplyDDMv1_CPU(allJointSkinningMatrices);
@@ -788,13 +901,7 @@ void FBXModel::ApplyDDMv1_CPU()
 
 void FBXModel::ApplyDDMv0_GPU()
 {
-	std::vector<Mat44> allJointSkinningMatrices;
-	for (int i = 0; i < m_joints.size(); i++) {
-		if (m_joints[i]) {
-			allJointSkinningMatrices.emplace_back(m_joints[i]->GetSkinningMatrixForThisFrame());
-		}
-	}
-
+	const std::vector<Mat44>& allJointSkinningMatrices = m_skeleton.m_skinningMatrices;
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
 			m_meshes[i]->ApplyDDMv0_GPU(allJointSkinningMatrices);
@@ -804,13 +911,7 @@ void FBXModel::ApplyDDMv0_GPU()
 
 void FBXModel::ApplyDDMv1_GPU()
 {
-	std::vector<Mat44> allJointSkinningMatrices;
-	for (int i = 0; i < m_joints.size(); i++) {
-		if (m_joints[i]) {
-			allJointSkinningMatrices.emplace_back(m_joints[i]->GetSkinningMatrixForThisFrame());
-		}
-	}
-
+	const std::vector<Mat44>& allJointSkinningMatrices = m_skeleton.m_skinningMatrices;
 	for (int i = 0; i < m_meshes.size(); i++) {
 		if (m_meshes[i]) {
 			m_meshes[i]->ApplyDDMv1_GPU(allJointSkinningMatrices);
@@ -818,26 +919,22 @@ void FBXModel::ApplyDDMv1_GPU()
 	}
 }
 
-std::vector<Mat44> FBXModel::GetJointGlobalBindPoseInverseList() const
+void FBXModel::ApplySkinning_CPU(CPUSkinningMethod method)
 {
-	std::vector<Mat44> list;
-	for (int i = 0; i < m_joints.size(); i++) {
-		if (m_joints[i]) {
-			list.emplace_back(m_joints[i]->GetGlobalBindPoseInverse());
-		}
-		else {
-			ERROR_AND_DIE("m_joints should NOT have a nullptr element");
+	const std::vector<Mat44>& allJointSkinningMatrices = m_skeleton.m_skinningMatrices;
+	for (int i = 0; i < m_meshes.size(); i++) {
+		if (m_meshes[i]) {
+			m_meshes[i]->ApplySkinning_CPU(allJointSkinningMatrices, method);
 		}
 	}
-	return list;
 }
 
-std::vector<Mat44> FBXModel::GetJointGlobalTransformList() const
+std::vector<Mat44> FBXModel::GetJointGlobalBindPoseInverseList() const
 {
 	std::vector<Mat44> list;
 	for (int i = 0; i < m_joints.size(); i++) {
 		if (m_joints[i]) {
-			list.emplace_back(m_joints[i]->GetGlobalTransformForThisFrame());
+			list.emplace_back(m_joints[i]->GetGlobalBindPoseInverse());
 		}
 		else {
 			ERROR_AND_DIE("m_joints should NOT have a nullptr element");
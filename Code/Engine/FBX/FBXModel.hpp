@@ -3,7 +3,10 @@
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Fbx/FBXJointGizmosManager.hpp"
 #include "Engine/FBX/FBXAnimManager.hpp"
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Fbx/FBXSkeleton.hpp"
 #include "Engine/IKSolver/JacobianIKSolver.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
 #include "ThirdParty/fbxsdk/fbxsdk.h"
 #include <vector>
 #include <string>
@@ -16,6 +19,9 @@ class FBXMesh;
 class FBXParser;
 class Camera;
 class FBXAnimManager;
+class FBXDDMBakingJob;
+class FBXPose;
+enum class CPUSkinningMethod;
 
 class FBXModelConfig {
 public:
@@ -29,9 +35,13 @@ enum class FBXModelSkinningModifier {
 	DDM_CPU_v0,
 	DDM_CPU_v1,
 	DDM_GPU_v0,
-	DDM_GPU_v1
+	DDM_GPU_v1,
+	LBS_CPU,	//FBXSkinningCPU, for when the GPU is not the one skinning
+	DQS_CPU
 };
 
+bool IsDDMSkinningModifier(FBXModelSkinningModifier modifier);	//The ones that need PrecomputeDDM
+
 class FBXModel {
 public:
 	friend class FBXParser;
@@ -69,10 +79,14 @@ public:
 	int GetNumFaces() const;
 	int GetNumVertices() const;
 	void SetDDMNeedsRecalculation();
+	void SetDDMOmegaEpsilon(float omegaEpsilon);	//See FBXMesh::SetDDMOmegaEpsilon
 
 	void ToggleMeshDebugMode();
 
-	void InitiateDDMBaking(FBXParser& fbxParser, const std::string& exportFileName, int numPoses, int numMaxBoneNums, float twistLimit, float pruneThreshold);
+	//NORMAL_EQUATIONS keeps the baker's memory independent of numPoses, so thousands of poses fit. The random poses only depend on seed.
+	//Each control point only solves for up to maxNumCandidateJoints joints near its rest weights (see DDMBakerCandidateParameters), 0 solves for all of them
+	void InitiateDDMBaking(FBXParser& fbxParser, const std::string& exportFileName, int numPoses, int numMaxBoneNums, float twistLimit, float pruneThreshold,
+		DDMBakerSolveMode solveMode = DDMBakerSolveMode::COLUMN_PIVOTING_QR, unsigned int seed = 0, int maxNumCandidateJoints = 8);
 
 	const std::vector<FBXJoint*>& GetJointsArray() const;
 
@@ -107,15 +121,18 @@ private:
 	//unsigned int GetKeyframeIndexToPlayBasedOnElapsedTime() const;
 	void RenderAllMeshes() const;
 	void RenderAllJoints() const;
-	void UpdateJointGlobalTransformsStructuredBuffer();
+	void SetSkeletonFromJoints();
+	void UpdateSkeleton(const FBXPose* pose);	//nullptr: the bind pose. Adds the joints' gizmo and IK deltas, then hands the changed global transforms back to the FBXJoints
+	void ReadSkeletonGlobalTransformsFromJoints();	//After something moved the FBXJoints on its own, like the IK solver. Adds the joints it moved to m_skeleton.m_changedJointIndices
+	void UpdateJointGlobalTransformsStructuredBuffer();	//Skipped when no joint changed since the last upload
 	void ApplyDDMv0_CPU();
 	void ApplyDDMv1_CPU();
 	void ApplyDDMv0_GPU();
 	void ApplyDDMv1_GPU();
+	void ApplySkinning_CPU(CPUSkinningMethod method);
 
 	//Helper functions
 	std::vector<Mat44> GetJointGlobalBindPoseInverseList() const;
-	std::vector<Mat44> GetJointGlobalTransformList() const;
 
 public:
 	Shader* m_blinnPhongAnimShader = nullptr;
@@ -129,6 +146,8 @@ private:
 	//Clock m_animPlayerClock;
 	std::vector<FBXJoint*> m_joints;
 	std::vector<FBXMesh*> m_meshes;
+	FBXSkeleton m_skeleton;	//m_joints flattened. Where the joint structured buffer and the skinning matrices come from
+	bool m_areJointGlobalTransformsChanged = true;	//Since the last joint structured buffer upload
 
 	//bool m_isAnimationMode = false;	//Don't need anymore since I have an animmanager now
 
@@ -156,6 +175,8 @@ private:
 	FBXModelSkinningModifier m_preBakingSkinningModifier = FBXModelSkinningModifier::LBS;
 
 	bool m_isBakingInProgress = false;
+	FBXDDMBakingJob* m_bakingJob = nullptr;
+	JobHandle m_bakingJobHandle;
 
 	//For rigid binding and gpu recompute
 	struct FBXDDMPrecomputeConstants {
@@ -3,15 +3,24 @@
 #include "Engine/Fbx/FBXModel.hpp"
 #include "Engine/Fbx/FBXMesh.hpp"
 #include "Engine/Fbx/FBXUtils.hpp"
+#include "Engine/Fbx/FBXDDMBenchmarks.hpp"
+#include "Engine/Fbx/FBXCookedModel.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/GPUMesh.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Renderer/Renderer.hpp"
 
+//Note that this #include is an exception to the rule "engine code doesn't know about game code", see AudioSystem.cpp.
+//Define ENGINE_ENABLE_BENCHMARK_COMMANDS there to register the FBX benchmark commands
+#include "Game/EngineBuildPreferences.hpp"
+
 #pragma comment( lib, "ThirdParty/fbxsdk/libfbxsdk.lib" )
 
 FBXParser::FBXParser(const FBXParserConfig& config) : m_config(config)
 {
+#if defined(ENGINE_ENABLE_BENCHMARK_COMMANDS)
+	RegisterFBXDDMBenchmarkCommands();
+#endif
 }
 
 FBXParser::~FBXParser()
@@ -131,6 +140,136 @@ FbxScene* FBXParser::GetScene() const
 	return m_scene;
 }
 
+bool FBXParser::CookParsedFile(const std::string& cookedFilePath, std::string* errorStr) const
+{
+	auto fail = [errorStr](const std::string& error) {
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+	if (m_joints.empty() || m_meshes.empty()) {
+		return fail("Nothing to cook. Either nothing was parsed or CreateFBXModelWithOwnership already took the meshes and joints");
+	}
+
+	FBXCookedModelData cookedData;
+	cookedData.m_sourceFileName = m_latestParsedFileName;
+	std::map<const FBXJoint*, int> jointIndices;
+	for (int jointIdx = 0; jointIdx < (int)m_joints.size(); jointIdx++) {
+		jointIndices[m_joints[jointIdx]] = jointIdx;
+	}
+	cookedData.m_joints.resize(m_joints.size());
+	cookedData.m_jointNames.resize(m_joints.size());
+	for (int jointIdx = 0; jointIdx < (int)m_joints.size(); jointIdx++) {
+		const FBXJoint& joint = *m_joints[jointIdx];
+		FBXCookedJoint& cookedJoint = cookedData.m_joints[jointIdx];
+		cookedJoint.m_globalBindPose = joint.GetGlobalBindPose();
+		cookedJoint.m_globalBindPoseInverse = joint.GetGlobalBindPoseInverse();
+		cookedJoint.m_originalLocalRotate = joint.GetOriginalLocalRotate();
+		cookedJoint.m_originalLocalTranslate = joint.GetOriginalLocalTranslate();
+		cookedJoint.m_parentJointIdx = joint.GetParentJoint() ? jointIndices.at(joint.GetParentJoint()) : -1;
+		if (cookedJoint.m_parentJointIdx >= jointIdx) {
+			return fail(Stringf("Joint %s comes before its parent", joint.GetName().c_str()));
+		}
+		cookedJoint.m_stencilRef = joint.GetStencilRefForThisJoint();
+		cookedJoint.m_isRoot = joint.IsRoot() ? 1 : 0;
+		cookedJoint.m_isEndJoint = joint.IsEndJoint() ? 1 : 0;
+		cookedData.m_jointNames[jointIdx] = joint.GetName();
+	}
+
+	cookedData.m_animTimeMode = (int)m_animTimeMode;
+	cookedData.m_animStartTime = m_animStartTime;
+	cookedData.m_animEndTime = m_animEndTime;
+	cookedData.m_numPoseJoints = m_poseSequence.empty() ? 0 : (int)m_poseSequence[0].GetNumJoints();
+	cookedData.m_jointPoses.reserve(m_poseSequence.size() * cookedData.m_numPoseJoints);
+	for (const FBXPose& pose : m_poseSequence) {
+		if (pose.GetRootJoint() != m_joints[0] || (int)pose.GetNumJoints() != cookedData.m_numPoseJoints) {
+			return fail("Every pose has to be of the skeleton under the first joint");
+		}
+		for (unsigned int jointIdx = 0; jointIdx < pose.GetNumJoints(); jointIdx++) {
+			FBXCookedJointPose cookedJointPose;
+			pose.GetJointPoseEntry(jointIdx, cookedJointPose.m_localScaling, cookedJointPose.m_localQuat, cookedJointPose.m_localLoc);
+			cookedData.m_jointPoses.push_back(cookedJointPose);
+		}
+	}
+
+	cookedData.m_meshes.resize(m_meshes.size());
+	for (int meshIdx = 0; meshIdx < (int)m_meshes.size(); meshIdx++) {
+		m_meshes[meshIdx]->FillCookedMeshData(cookedData.m_meshes[meshIdx]);
+	}
+	return SaveFBXCookedModel(cookedFilePath, cookedData, errorStr);
+}
+
+bool FBXParser::LoadCookedFile(const std::string& cookedFilePath, std::string* errorStr)
+{
+	auto fail = [errorStr](const std::string& error) {
+		if (errorStr) {
+			*errorStr = error;
+		}
+		return false;
+	};
+	GUARANTEE_OR_DIE(m_joints.empty() && m_meshes.empty(), "FBXParser::LoadCookedFile() called on a parser that still holds a model");
+
+	FBXCookedModel cookedModel;
+	if (!cookedModel.Load(cookedFilePath, errorStr)) {
+		return false;
+	}
+	int numJoints = cookedModel.GetNumJoints();
+	if (numJoints == 0 || cookedModel.GetNumMeshes() == 0) {
+		return fail("Cooked model has no skeleton or no meshes");
+	}
+	//FBXPose::SetRootJoint dies on these, so they get checked before anything is built
+	int numJointsUnderFirstJoint = 1;
+	while (numJointsUnderFirstJoint < numJoints && cookedModel.GetJoint(numJointsUnderFirstJoint).m_parentJointIdx != -1) {
+		numJointsUnderFirstJoint++;	//Depth first order, so the skeleton of the first joint ends at the next root
+	}
+	if (cookedModel.GetNumPoses() > 0 && (cookedModel.GetJoint(0).m_isRoot == 0 || cookedModel.GetNumPoseJoints() != numJointsUnderFirstJoint)) {
+		return fail("Poses don't match the skeleton under the first joint");
+	}
+
+	m_joints.reserve(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		const FBXCookedJoint& cookedJoint = cookedModel.GetJoint(jointIdx);
+		FBXJoint* joint = new FBXJoint();
+		joint->SetName(cookedModel.GetString(cookedJoint.m_name));
+		joint->SetStencilRefForThisJoint(cookedJoint.m_stencilRef);
+		joint->SetIsRoot(cookedJoint.m_isRoot != 0);
+		joint->SetIsEndJoint(cookedJoint.m_isEndJoint != 0);
+		joint->SetOriginalLocalTranslate(cookedJoint.m_originalLocalTranslate);
+		joint->SetOriginalLocalRotate(cookedJoint.m_originalLocalRotate);
+		joint->SetGlobalBindPose(cookedJoint.m_globalBindPose);
+		joint->SetGlobalBindPoseInverse(cookedJoint.m_globalBindPoseInverse);
+		if (cookedJoint.m_parentJointIdx >= 0) {
+			m_joints[cookedJoint.m_parentJointIdx]->AddChildJoints(*joint);	//Same child order as the parse, since the children come in it
+		}
+		m_joints.push_back(joint);
+	}
+
+	m_animTimeMode = (FbxTime::EMode)cookedModel.GetAnimTimeMode();
+	m_animStartTime = cookedModel.GetAnimStartTime();
+	m_animEndTime = cookedModel.GetAnimEndTime();
+	m_poseSequence.resize(cookedModel.GetNumPoses());
+	for (int poseIdx = 0; poseIdx < (int)m_poseSequence.size(); poseIdx++) {
+		m_poseSequence[poseIdx].SetRootJoint(*m_joints[0]);
+		const FBXCookedJointPose* cookedJointPoses = cookedModel.GetPoseJoints(poseIdx);
+		for (int jointIdx = 0; jointIdx < cookedModel.GetNumPoseJoints(); jointIdx++) {
+			const FBXCookedJointPose& cookedJointPose = cookedJointPoses[jointIdx];
+			m_poseSequence[poseIdx].SetJointPoseEntry(jointIdx, cookedJointPose.m_localScaling, cookedJointPose.m_localQuat, cookedJointPose.m_localLoc);
+		}
+	}
+
+	m_meshes.reserve(cookedModel.GetNumMeshes());
+	for (int meshIdx = 0; meshIdx < cookedModel.GetNumMeshes(); meshIdx++) {
+		FBXCookedMeshView cookedMesh = cookedModel.GetMesh(meshIdx);
+		FBXMesh* mesh = new FBXMesh(*this, cookedModel.GetString(cookedMesh.m_mesh->m_name), cookedMesh.m_mesh->m_nodeIdx);
+		mesh->ProcessCookedMesh(cookedModel, cookedMesh, numJoints);
+		m_meshes.push_back(mesh);
+	}
+
+	m_latestParsedFileName = cookedModel.GetSourceFileName();	//FBXModel names its outputs after the .fbx
+	return true;
+}
+
 bool FBXParser::LoadCompatibleAnimationDataToModel(FBXModel& model, const std::string& fbxFilePath, std::string* errorStr)
 {
 	FbxImporter* fbxImporter = FbxImporter::Create(m_fbxManager, "importer");
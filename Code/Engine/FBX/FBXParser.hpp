@@ -32,6 +32,11 @@ public:
 	FBXModel* CreateFBXModelWithOwnership(const FBXModelConfig& modelConfig);
 	bool ExportParsedFile(const std::string& filePath);
 	FbxScene* GetScene() const;
+
+	//Cooked models (FBXCookedModel.hpp) skip the fbx sdk and every processing step of ParseFile. Cook right after ParseFile, since CreateFBXModelWithOwnership takes the meshes and joints.
+	//LoadCookedFile replaces ParseFile, except that there is no scene: ExportParsedFile and the functions that write skinning data back into the scene are off limits
+	bool CookParsedFile(const std::string& cookedFilePath, std::string* errorStr = nullptr) const;
+	bool LoadCookedFile(const std::string& cookedFilePath, std::string* errorStr = nullptr);
 	bool LoadCompatibleAnimationDataToModel(FBXModel& model, const std::string& filePath, std::string* errorStr = nullptr);
 
 private:
@@ -64,6 +64,19 @@ void FBXPose::SetJointPoseEntry(unsigned int jointIdx, const FbxVector4& localSc
 	m_localLocs[jointIdx] = Vec4((float)localLoc.mData[0], (float)localLoc.mData[1], (float)localLoc.mData[2], (float)localLoc.mData[3]);
 }
 
+void FBXPose::GetJointPoseEntry(unsigned int jointIdx, Vec4& out_localScaling, Quaternion& out_localQuat, Vec4& out_localLoc) const
+{
+	GUARANTEE_OR_DIE(jointIdx < m_numJoints, "JointIdx >= m_numJoints!");
+	out_localScaling = m_localScalings[jointIdx];
+	out_localQuat = m_localQuats[jointIdx];
+	out_localLoc = m_localLocs[jointIdx];
+}
+
+unsigned int FBXPose::GetNumJoints() const
+{
+	return m_numJoints;
+}
+
 const FBXJoint* FBXPose::GetRootJoint() const
 {
 	return m_rootJoint;
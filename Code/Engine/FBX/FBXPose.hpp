@@ -26,6 +26,9 @@ public:
 	void SetJointPoseEntry(unsigned int jointIdx, const Vec4& localScaling, const Quaternion& localQuat, const Vec4& localLoc);
 	void SetJointPoseEntry(unsigned int jointIdx, const FbxVector4& localScaling, const FbxQuaternion& localQuat, const FbxVector4& localLoc);
 
+	void GetJointPoseEntry(unsigned int jointIdx, Vec4& out_localScaling, Quaternion& out_localQuat, Vec4& out_localLoc) const;
+	unsigned int GetNumJoints() const;
+
 	const FBXJoint* GetRootJoint() const;
 
 	void CopyFrom(const FBXPose& rhs);
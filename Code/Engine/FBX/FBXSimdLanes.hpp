@@ -0,0 +1,87 @@
+#pragma once
+#include <cmath>
+
+//SIMD plumbing the CPU kernels share. Only included by .cpp files, everything in here is internal to the translation unit that includes it
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DDM_HAS_X86_SIMD
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+//MSVC lets any function use AVX2 intrinsics; gcc and clang have to be told per function
+#if defined(_MSC_VER)
+#define DDM_TARGET_AVX2
+#define DDM_FLATTEN
+#else
+#define DDM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define DDM_FLATTEN __attribute__((flatten))
+#endif
+
+//Lane types. The math is written once as templates over the lane type: float for one element, DDMFloat4 and DDMFloat8 for a register of them.
+//Masks are the same type as the values (all bits set where a comparison holds), for float they are bools
+#if defined(DDM_HAS_X86_SIMD)
+struct DDMFloat4 {
+	__m128 m_value;
+
+	DDMFloat4() = default;
+	DDMFloat4(__m128 value) : m_value(value) {}
+	DDMFloat4(float value) : m_value(_mm_set1_ps(value)) {}
+};
+
+static inline DDMFloat4 operator+(DDMFloat4 a, DDMFloat4 b) { return _mm_add_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 operator-(DDMFloat4 a, DDMFloat4 b) { return _mm_sub_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 operator*(DDMFloat4 a, DDMFloat4 b) { return _mm_mul_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 operator/(DDMFloat4 a, DDMFloat4 b) { return _mm_div_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 operator-(DDMFloat4 a) { return _mm_xor_ps(a.m_value, _mm_set1_ps(-0.0f)); }
+static inline DDMFloat4 operator<(DDMFloat4 a, DDMFloat4 b) { return _mm_cmplt_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 operator&(DDMFloat4 a, DDMFloat4 b) { return _mm_and_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 LaneSelect(DDMFloat4 mask, DDMFloat4 ifTrue, DDMFloat4 ifFalse) { return _mm_or_ps(_mm_and_ps(mask.m_value, ifTrue.m_value), _mm_andnot_ps(mask.m_value, ifFalse.m_value)); }	//SSE2 has no blend
+static inline DDMFloat4 LaneAbs(DDMFloat4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.m_value); }
+static inline DDMFloat4 LaneMax(DDMFloat4 a, DDMFloat4 b) { return _mm_max_ps(a.m_value, b.m_value); }
+static inline DDMFloat4 LaneSqrt(DDMFloat4 a) { return _mm_sqrt_ps(a.m_value); }
+static inline DDMFloat4 LaneRsqrt(DDMFloat4 a)
+{
+	DDMFloat4 estimate = _mm_rsqrt_ps(a.m_value);
+	return estimate * (1.5f - 0.5f * a * estimate * estimate);	//One Newton step takes the 12 bit estimate to about 23 bits
+}
+static inline void LoadLanes(const float* source, DDMFloat4& out) { out = _mm_loadu_ps(source); }
+static inline void StoreLanes(float* destination, DDMFloat4 value) { _mm_storeu_ps(destination, value.m_value); }
+
+struct DDMFloat8 {
+	__m256 m_value;
+
+	DDMFloat8() = default;
+	DDM_TARGET_AVX2 DDMFloat8(__m256 value) : m_value(value) {}
+	DDM_TARGET_AVX2 DDMFloat8(float value) : m_value(_mm256_set1_ps(value)) {}
+};
+
+DDM_TARGET_AVX2 static inline DDMFloat8 operator+(DDMFloat8 a, DDMFloat8 b) { return _mm256_add_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator-(DDMFloat8 a, DDMFloat8 b) { return _mm256_sub_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator*(DDMFloat8 a, DDMFloat8 b) { return _mm256_mul_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator/(DDMFloat8 a, DDMFloat8 b) { return _mm256_div_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator-(DDMFloat8 a) { return _mm256_xor_ps(a.m_value, _mm256_set1_ps(-0.0f)); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator<(DDMFloat8 a, DDMFloat8 b) { return _mm256_cmp_ps(a.m_value, b.m_value, _CMP_LT_OQ); }
+DDM_TARGET_AVX2 static inline DDMFloat8 operator&(DDMFloat8 a, DDMFloat8 b) { return _mm256_and_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 LaneSelect(DDMFloat8 mask, DDMFloat8 ifTrue, DDMFloat8 ifFalse) { return _mm256_blendv_ps(ifFalse.m_value, ifTrue.m_value, mask.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 LaneAbs(DDMFloat8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 LaneMax(DDMFloat8 a, DDMFloat8 b) { return _mm256_max_ps(a.m_value, b.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 LaneSqrt(DDMFloat8 a) { return _mm256_sqrt_ps(a.m_value); }
+DDM_TARGET_AVX2 static inline DDMFloat8 LaneRsqrt(DDMFloat8 a)
+{
+	DDMFloat8 estimate = _mm256_rsqrt_ps(a.m_value);
+	return estimate * (1.5f - 0.5f * a * estimate * estimate);
+}
+DDM_TARGET_AVX2 static inline void LoadLanes(const float* source, DDMFloat8& out) { out = _mm256_loadu_ps(source); }
+DDM_TARGET_AVX2 static inline void StoreLanes(float* destination, DDMFloat8 value) { _mm256_storeu_ps(destination, value.m_value); }
+#endif
+
+static inline float LaneSelect(bool mask, float ifTrue, float ifFalse) { return mask ? ifTrue : ifFalse; }
+static inline float LaneAbs(float a) { return fabsf(a); }
+static inline float LaneMax(float a, float b) { return a > b ? a : b; }
+static inline float LaneSqrt(float a) { return sqrtf(a); }
+static inline float LaneRsqrt(float a) { return 1.0f / sqrtf(a); }
+static inline void LoadLanes(const float* source, float& out) { out = *source; }
+static inline void StoreLanes(float* destination, float value) { *destination = value; }
@@ -0,0 +1,125 @@
+#include "Engine/Fbx/FBXSkeleton.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <cstring>
+
+//Bitwise, so setting the same pose again never dirties anything and a changed sign of zero still counts as a change
+template<typename T>
+static bool AreBitwiseEqual(const T& a, const T& b)
+{
+	return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+void FBXSkeleton::SetJoints(const std::vector<int>& parentIndices, const std::vector<Mat44>& globalBindPoseInverses)
+{
+	GUARANTEE_OR_DIE(parentIndices.size() == globalBindPoseInverses.size(), "FBXSkeleton needs a bind pose inverse per joint");
+	int numJoints = (int)parentIndices.size();
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		GUARANTEE_OR_DIE(parentIndices[jointIdx] >= -1 && parentIndices[jointIdx] < jointIdx, "FBXSkeleton joints have to come after their parents");
+	}
+	m_parentIndices = parentIndices;
+	m_globalBindPoseInverses = globalBindPoseInverses;
+	m_localTranslations.assign(numJoints, Vec3());
+	m_localRotations.assign(numJoints, Quaternion());
+	m_localScales.assign(numJoints, Vec3(1.0f, 1.0f, 1.0f));
+	m_localPostRotations.assign(numJoints, Quaternion());
+	m_hasLocalPostRotations.assign(numJoints, 0);
+	m_globalTransforms.assign(numJoints, Mat44());
+	m_skinningMatrices = m_globalBindPoseInverses;
+	m_changedJointIndices.clear();
+	m_changedJointIndices.reserve(numJoints);
+	MarkAllDirty();
+}
+
+void FBXSkeleton::SetLocalTransform(int jointIdx, const Vec3& translation, const Quaternion& rotation, const Vec3& scale)
+{
+	if (AreBitwiseEqual(m_localTranslations[jointIdx], translation) && AreBitwiseEqual(m_localRotations[jointIdx], rotation) && AreBitwiseEqual(m_localScales[jointIdx], scale)) {
+		return;
+	}
+	m_localTranslations[jointIdx] = translation;
+	m_localRotations[jointIdx] = rotation;
+	m_localScales[jointIdx] = scale;
+	m_isLocalTransformDirty[jointIdx] = 1;
+}
+
+void FBXSkeleton::SetLocalPostRotation(int jointIdx, const Quaternion& postRotation)
+{
+	if (m_hasLocalPostRotations[jointIdx] && AreBitwiseEqual(m_localPostRotations[jointIdx], postRotation)) {
+		return;
+	}
+	m_localPostRotations[jointIdx] = postRotation;
+	m_hasLocalPostRotations[jointIdx] = 1;
+	m_isLocalTransformDirty[jointIdx] = 1;
+}
+
+void FBXSkeleton::ClearLocalPostRotation(int jointIdx)
+{
+	if (m_hasLocalPostRotations[jointIdx] == 0) {
+		return;
+	}
+	m_localPostRotations[jointIdx] = Quaternion();
+	m_hasLocalPostRotations[jointIdx] = 0;
+	m_isLocalTransformDirty[jointIdx] = 1;
+}
+
+void FBXSkeleton::MarkLocalTransformDirty(int jointIdx)
+{
+	m_isLocalTransformDirty[jointIdx] = 1;
+}
+
+void FBXSkeleton::MarkAllDirty()
+{
+	m_isLocalTransformDirty.assign(m_parentIndices.size(), 1);
+}
+
+void FBXSkeleton::UpdateGlobalTransforms()
+{
+	m_changedJointIndices.clear();
+	int numJoints = GetNumJoints();
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		//The parent's flag is final by now, and stays set for the rest of the pass when the parent was recomputed, so a change reaches the whole subtree
+		int parentIdx = m_parentIndices[jointIdx];
+		if (m_isLocalTransformDirty[jointIdx] == 0 && (parentIdx < 0 || m_isLocalTransformDirty[parentIdx] == 0)) {
+			continue;
+		}
+		m_isLocalTransformDirty[jointIdx] = 1;
+		UpdateGlobalTransform(jointIdx);
+		m_changedJointIndices.push_back(jointIdx);
+	}
+	for (int jointIdx : m_changedJointIndices) {
+		m_isLocalTransformDirty[jointIdx] = 0;
+	}
+}
+
+void FBXSkeleton::UpdateAllGlobalTransforms()
+{
+	MarkAllDirty();
+	UpdateGlobalTransforms();
+}
+
+void FBXSkeleton::UpdateGlobalTransform(int jointIdx)
+{
+	//T * R * S without multiplying them out: the rotation's basis scaled per axis, with the translation in the last column
+	Mat44 localTransform = m_localRotations[jointIdx].GetRotationMatrix();
+	const Vec3& scale = m_localScales[jointIdx];
+	const Vec3& translation = m_localTranslations[jointIdx];
+	float* values = localTransform.m_values;
+	values[Mat44::Ix] *= scale.x;	values[Mat44::Iy] *= scale.x;	values[Mat44::Iz] *= scale.x;
+	values[Mat44::Jx] *= scale.y;	values[Mat44::Jy] *= scale.y;	values[Mat44::Jz] *= scale.y;
+	values[Mat44::Kx] *= scale.z;	values[Mat44::Ky] *= scale.z;	values[Mat44::Kz] *= scale.z;
+	values[Mat44::Tx] = translation.x;	values[Mat44::Ty] = translation.y;	values[Mat44::Tz] = translation.z;
+
+	int parentIdx = m_parentIndices[jointIdx];
+	Mat44& globalTransform = m_globalTransforms[jointIdx];
+	if (parentIdx >= 0) {
+		globalTransform = m_globalTransforms[parentIdx];
+		globalTransform.Append(localTransform);
+	}
+	else {
+		globalTransform = localTransform;
+	}
+	if (m_hasLocalPostRotations[jointIdx]) {
+		globalTransform.Append(m_localPostRotations[jointIdx].GetRotationMatrix());
+	}
+	m_skinningMatrices[jointIdx] = globalTransform;
+	m_skinningMatrices[jointIdx].Append(m_globalBindPoseInverses[jointIdx]);
+}
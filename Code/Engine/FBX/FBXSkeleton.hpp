@@ -0,0 +1,41 @@
+#pragma once
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <vector>
+#include <cstdint>
+
+//The joint hierarchy of an FBXModel as flat arrays, so a frame's global and skinning matrices come out of one pass in index order instead of a walk over the FBXJoint tree.
+//Joint indices are the model's. FBXParser adds joints depth first, so every parent already comes before its children.
+//Only joints whose local transform changed since the last update, and everything under them, are recomputed, so an IK chain or a gizmo edit doesn't redo the whole rig
+struct FBXSkeleton {
+	std::vector<int> m_parentIndices;	//-1 for roots, otherwise smaller than the joint's own index
+	std::vector<Mat44> m_globalBindPoseInverses;
+
+	//Local transform of joint i: T(m_localTranslations[i]) * R(m_localRotations[i]) * S(m_localScales[i]), then R(m_localPostRotations[i]) once it is under its parent.
+	//The post rotation is the delta rotate of the gizmos and the IK solver, which FBXJoint appends after the pose's scale
+	std::vector<Vec3> m_localTranslations;
+	std::vector<Quaternion> m_localRotations;
+	std::vector<Vec3> m_localScales;
+	std::vector<Quaternion> m_localPostRotations;
+	std::vector<uint8_t> m_hasLocalPostRotations;
+
+	std::vector<Mat44> m_globalTransforms;	//What goes into the joint structured buffer
+	std::vector<Mat44> m_skinningMatrices;	//m_globalTransforms[i] * m_globalBindPoseInverses[i]
+
+	std::vector<uint8_t> m_isLocalTransformDirty;	//Set by the setters when a value actually changes, cleared by UpdateGlobalTransforms
+	std::vector<int> m_changedJointIndices;	//Joints whose global and skinning matrices the last UpdateGlobalTransforms recomputed, ascending
+
+	int GetNumJoints() const { return (int)m_parentIndices.size(); };
+	void SetJoints(const std::vector<int>& parentIndices, const std::vector<Mat44>& globalBindPoseInverses);	//Every local transform starts out as the identity
+	void SetLocalTransform(int jointIdx, const Vec3& translation, const Quaternion& rotation, const Vec3& scale);
+	void SetLocalPostRotation(int jointIdx, const Quaternion& postRotation);
+	void ClearLocalPostRotation(int jointIdx);
+	void MarkLocalTransformDirty(int jointIdx);	//For when m_globalTransforms[jointIdx] was overwritten from outside and has to come from its local transform again
+	void MarkAllDirty();
+	void UpdateGlobalTransforms();	//Partial, see m_changedJointIndices
+	void UpdateAllGlobalTransforms();	//Recomputes every joint, what the partial update has to match
+
+private:
+	void UpdateGlobalTransform(int jointIdx);
+};
@@ -0,0 +1,293 @@
+#include "Engine/Fbx/FBXSkeletonTests.hpp"
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXSkeleton.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+
+//One frame of edits. A joint shows up at most once
+struct SkeletonEditFrame {
+	std::vector<int> m_jointIndices;
+	std::vector<Quaternion> m_postRotations;
+	bool m_isNewPose = false;	//Every local transform comes from m_poseIdx instead
+	int m_poseIdx = 0;
+};
+
+static void ApplySkeletonEditFrame(FBXSkeleton& skeleton, const SkeletonEditFrame& frame, const std::vector<std::vector<Quaternion>>& poses, const std::vector<Vec3>& localTranslations)
+{
+	if (frame.m_isNewPose) {
+		const std::vector<Quaternion>& pose = poses[frame.m_poseIdx];
+		for (int jointIdx = 0; jointIdx < skeleton.GetNumJoints(); jointIdx++) {
+			skeleton.SetLocalTransform(jointIdx, localTranslations[jointIdx], pose[jointIdx], Vec3(1.0f, 1.0f, 1.0f));
+		}
+	}
+	for (int editIdx = 0; editIdx < (int)frame.m_jointIndices.size(); editIdx++) {
+		skeleton.SetLocalPostRotation(frame.m_jointIndices[editIdx], frame.m_postRotations[editIdx]);
+	}
+}
+
+static bool AreMatrixListsBitIdentical(const std::vector<Mat44>& a, const std::vector<Mat44>& b)
+{
+	return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Mat44)) == 0;
+}
+
+//The IK solver's edits: the delta rotates of a chain from a random joint up to 4 of its ancestors
+static SkeletonEditFrame GetRandomIKEditFrame(const std::vector<int>& parentIndices, RandomNumberGenerator& rng)
+{
+	SkeletonEditFrame frame;
+	int jointIdx = rng.RollRandomIntInRange(0, (int)parentIndices.size() - 1);
+	for (int chainIdx = 0; chainIdx < 4 && jointIdx >= 0; chainIdx++) {
+		frame.m_jointIndices.push_back(jointIdx);
+		frame.m_postRotations.push_back(GetRandomBenchmarkRotation(rng, 20.0f));
+		jointIdx = parentIndices[jointIdx];
+	}
+	return frame;
+}
+
+FBXSkeletonPartialUpdateTestResult RunFBXSkeletonPartialUpdateTest(JobSystem& jobSystem, int numJoints, int numControlPoints, int numDDMJoints, int numFrames, int numRepeats)
+{
+	GUARANTEE_OR_DIE(numJoints > 0 && numDDMJoints > 1 && numFrames > 0 && numRepeats > 0, "RunFBXSkeletonPartialUpdateTest needs joints, frames and repeats");
+	constexpr int NUM_POSES = 4;
+	constexpr int NUM_FACES_PER_ISLAND = 500;
+	FBXSkeletonPartialUpdateTestResult result;
+	result.m_numJoints = numJoints;
+	result.m_numFrames = numFrames;
+
+	//Same kind of rig as RunFBXSkeletonBenchmark
+	RandomNumberGenerator rng(0);
+	std::vector<int> parentIndices(numJoints, -1);
+	for (int jointIdx = 1; jointIdx < numJoints; jointIdx++) {
+		parentIndices[jointIdx] = rng.RollRandomIntInRange(std::max(jointIdx - 4, 0), jointIdx - 1);
+	}
+	std::vector<Mat44> globalBindPoseInverses(numJoints);
+	std::vector<Vec3> localTranslations(numJoints);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		globalBindPoseInverses[jointIdx].Append(GetRandomBenchmarkRotation(rng, 10.0f).GetRotationMatrix());
+		localTranslations[jointIdx] = Vec3(rng.RollRandomFloatInRange(-0.1f, 0.1f), rng.RollRandomFloatInRange(-0.1f, 0.1f), 0.1f);
+	}
+	std::vector<std::vector<Quaternion>> poses(NUM_POSES, std::vector<Quaternion>(numJoints));
+	for (std::vector<Quaternion>& pose : poses) {
+		for (Quaternion& localRotation : pose) {
+			localRotation = GetRandomBenchmarkRotation(rng, 30.0f);
+		}
+	}
+
+	//Frame 0 sets a pose. After that a tenth of the frames set nothing, a tenth set the previous frame's values again, a tenth switch poses and the rest are IK edits
+	std::vector<SkeletonEditFrame> frames;
+	SkeletonEditFrame firstFrame;
+	firstFrame.m_isNewPose = true;
+	frames.push_back(firstFrame);
+	std::vector<uint8_t> isUnchangedFrame(1, 0);
+	for (int frameIdx = 1; frameIdx < numFrames; frameIdx++) {
+		float roll = rng.RollRandomFloatZeroToOne();
+		SkeletonEditFrame frame;
+		bool isUnchanged = false;
+		if (roll < 0.1f) {
+			isUnchanged = true;
+		}
+		else if (roll < 0.2f) {
+			frame = frames.back();
+			isUnchanged = true;
+		}
+		else if (roll < 0.3f) {
+			frame.m_isNewPose = true;
+			frame.m_poseIdx = rng.RollRandomIntInRange(0, NUM_POSES - 1);
+		}
+		else {
+			frame = GetRandomIKEditFrame(parentIndices, rng);
+		}
+		frames.push_back(frame);
+		isUnchangedFrame.push_back(isUnchanged ? 1 : 0);
+	}
+
+	FBXSkeleton partialSkeleton;
+	FBXSkeleton fullSkeleton;
+	partialSkeleton.SetJoints(parentIndices, globalBindPoseInverses);
+	fullSkeleton.SetJoints(parentIndices, globalBindPoseInverses);
+	result.m_doMatricesMatch = true;
+	result.m_doChangedJointsCoverChanges = true;
+	result.m_isSamePoseUnchanged = true;
+	std::vector<Mat44> previousGlobalTransforms = partialSkeleton.m_globalTransforms;
+	std::vector<Mat44> previousSkinningMatrices = partialSkeleton.m_skinningMatrices;
+	int numIKFrames = 0;
+	for (int frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+		ApplySkeletonEditFrame(partialSkeleton, frames[frameIdx], poses, localTranslations);
+		ApplySkeletonEditFrame(fullSkeleton, frames[frameIdx], poses, localTranslations);
+		partialSkeleton.UpdateGlobalTransforms();
+		fullSkeleton.UpdateAllGlobalTransforms();
+		result.m_doMatricesMatch = result.m_doMatricesMatch && AreMatrixListsBitIdentical(partialSkeleton.m_globalTransforms, fullSkeleton.m_globalTransforms)
+			&& AreMatrixListsBitIdentical(partialSkeleton.m_skinningMatrices, fullSkeleton.m_skinningMatrices);
+
+		const std::vector<int>& changedJointIndices = partialSkeleton.m_changedJointIndices;
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			bool isChanged = memcmp(&previousGlobalTransforms[jointIdx], &partialSkeleton.m_globalTransforms[jointIdx], sizeof(Mat44)) != 0
+				|| memcmp(&previousSkinningMatrices[jointIdx], &partialSkeleton.m_skinningMatrices[jointIdx], sizeof(Mat44)) != 0;
+			if (isChanged && !std::binary_search(changedJointIndices.begin(), changedJointIndices.end(), jointIdx)) {
+				result.m_doChangedJointsCoverChanges = false;
+			}
+		}
+		if (isUnchangedFrame[frameIdx] && !changedJointIndices.empty()) {
+			result.m_isSamePoseUnchanged = false;
+		}
+		if (!frames[frameIdx].m_isNewPose && !isUnchangedFrame[frameIdx]) {
+			result.m_averageNumChangedJoints += (double)changedJointIndices.size();
+			numIKFrames++;
+		}
+		previousGlobalTransforms = partialSkeleton.m_globalTransforms;
+		previousSkinningMatrices = partialSkeleton.m_skinningMatrices;
+	}
+	result.m_averageNumChangedJoints /= (double)std::max(numIKFrames, 1);
+
+	//Timed on IK frames only, which is what the partial update is for
+	std::vector<SkeletonEditFrame> ikFrames;
+	for (int frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+		ikFrames.push_back(GetRandomIKEditFrame(parentIndices, rng));
+	}
+	double startTime = GetCurrentTimeSeconds();
+	for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+		for (const SkeletonEditFrame& frame : ikFrames) {
+			ApplySkeletonEditFrame(fullSkeleton, frame, poses, localTranslations);
+			fullSkeleton.UpdateAllGlobalTransforms();
+		}
+	}
+	result.m_fullSeconds = (GetCurrentTimeSeconds() - startTime) / ((double)numRepeats * (double)numFrames);
+	startTime = GetCurrentTimeSeconds();
+	for (int repeatIdx = 0; repeatIdx < numRepeats; repeatIdx++) {
+		for (const SkeletonEditFrame& frame : ikFrames) {
+			ApplySkeletonEditFrame(partialSkeleton, frame, poses, localTranslations);
+			partialSkeleton.UpdateGlobalTransforms();
+		}
+	}
+	result.m_partialSeconds = (GetCurrentTimeSeconds() - startTime) / ((double)numRepeats * (double)numFrames);
+
+	//DDM: the tube's joint chain as an FBXSkeleton, bent a little at every joint, then one joint of the top half rotated per frame like a hand or a head
+	DDMSyntheticSkinnedMesh mesh = GetSyntheticSkinnedMesh(numControlPoints, numDDMJoints);
+	result.m_numControlPoints = (int)mesh.m_restPositions.rows();
+	result.m_numDDMJoints = numDDMJoints;
+	DDMSparseOmegas omegas;
+	Eigen::MatrixXd v1ConstantMatrix;
+	ComputeDDMPrecompute(jobSystem, mesh.m_restPositions, mesh.m_faces, mesh.m_weights.sparseView(), true, 8, 0.5, 0.1, 0.5, DDMSparseOmegas::DEFAULT_EPSILON, omegas, v1ConstantMatrix);
+	DDMControlPointPackets packets;
+	packets.Build(omegas, mesh.m_restPositions, &v1ConstantMatrix);
+	result.m_numPackets = packets.GetNumPackets();
+
+	std::vector<unsigned int> renderVertexToControlPointMap;
+	GetSyntheticRenderVertexMap(mesh.m_faces, NUM_FACES_PER_ISLAND, renderVertexToControlPointMap);
+	int numRenderVertices = (int)renderVertexToControlPointMap.size();
+	std::vector<Vertex_FBX> restRenderVertices((size_t)numRenderVertices);
+	for (int renderVertexIdx = 0; renderVertexIdx < numRenderVertices; renderVertexIdx++) {
+		int cpIdx = (int)renderVertexToControlPointMap[renderVertexIdx];
+		Vec3 position((float)mesh.m_restPositions(cpIdx, 0), (float)mesh.m_restPositions(cpIdx, 1), (float)mesh.m_restPositions(cpIdx, 2));
+		restRenderVertices[renderVertexIdx] = Vertex_FBX(position, Vec3(0.0f, 0.0f, 1.0f), Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+	}
+	int vertexStride = (int)(sizeof(Vertex_FBX) / sizeof(float));
+
+	std::vector<int> chainParentIndices(numDDMJoints);
+	std::vector<Mat44> chainBindPoseInverses(numDDMJoints);
+	std::vector<Vec3> chainLocalTranslations(numDDMJoints);
+	double parentHeight = 0.0;
+	for (int jointIdx = 0; jointIdx < numDDMJoints; jointIdx++) {
+		double jointHeight = mesh.m_jointHeights[jointIdx];
+		chainParentIndices[jointIdx] = jointIdx - 1;
+		chainBindPoseInverses[jointIdx] = Mat44::CreateTranslation3D(Vec3(0.0f, (float)-jointHeight, 0.0f));
+		chainLocalTranslations[jointIdx] = Vec3(0.0f, (float)(jointHeight - parentHeight), 0.0f);
+		parentHeight = jointHeight;
+	}
+	std::vector<std::vector<Quaternion>> chainPoses(1, std::vector<Quaternion>(numDDMJoints));
+	for (Quaternion& localRotation : chainPoses[0]) {
+		localRotation = Quaternion::CreateFromAxisAndDegrees(5.0f, Vec3(1.0f, 0.0f, 0.0f));
+	}
+	std::vector<SkeletonEditFrame> chainFrames(1);
+	chainFrames[0].m_isNewPose = true;
+	for (int frameIdx = 1; frameIdx < numFrames; frameIdx++) {
+		SkeletonEditFrame frame;
+		frame.m_jointIndices.push_back(rng.RollRandomIntInRange(numDDMJoints / 2, numDDMJoints - 1));
+		frame.m_postRotations.push_back(GetRandomBenchmarkRotation(rng, 20.0f));
+		chainFrames.push_back(frame);
+	}
+
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	std::vector<float> jointTransforms;
+	result.m_doDirtyRangesCoverChanges = true;
+	int numPartialWrites = 0;
+	for (int variantIdx = 0; variantIdx < 2; variantIdx++) {
+		bool isVariant1 = variantIdx == 1;
+		result.m_isDDMBitIdentical[variantIdx] = true;
+		FBXSkeleton chainSkeleton;
+		chainSkeleton.SetJoints(chainParentIndices, chainBindPoseInverses);
+		DDMRenderVertexWriteback partialWriteback;
+		DDMRenderVertexWriteback fullWriteback;
+		partialWriteback.Build(renderVertexToControlPointMap, result.m_numControlPoints);
+		fullWriteback.Build(renderVertexToControlPointMap, result.m_numControlPoints);
+		std::vector<Vertex_FBX> partialVertices = restRenderVertices;
+		std::vector<Vertex_FBX> fullVertices = restRenderVertices;
+		std::vector<Vertex_FBX> uploadedVertices = restRenderVertices;	//What the vertex buffer would hold with only the partial write's dirty ranges uploaded
+		for (int frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+			ApplySkeletonEditFrame(chainSkeleton, chainFrames[frameIdx], chainPoses, chainLocalTranslations);
+			chainSkeleton.UpdateGlobalTransforms();
+			ConvertJointTransformsToFloats(chainSkeleton.m_skinningMatrices, jointTransforms);
+			const std::vector<int>* changedJointIndices = frameIdx > 0 ? &chainSkeleton.m_changedJointIndices : nullptr;	//Nothing was written before the first frame
+
+			double startTime = GetCurrentTimeSeconds();
+			if (isVariant1) {
+				fullWriteback.WriteVariantv1(jobSystem, packets, jointTransforms.data(), simdLevel, &fullVertices[0].m_position.x, vertexStride);
+			}
+			else {
+				fullWriteback.WriteVariantv0(jobSystem, packets, jointTransforms.data(), simdLevel, &fullVertices[0].m_position.x, vertexStride);
+			}
+			double fullSeconds = GetCurrentTimeSeconds() - startTime;
+			startTime = GetCurrentTimeSeconds();
+			if (isVariant1) {
+				partialWriteback.WriteVariantv1(jobSystem, packets, jointTransforms.data(), simdLevel, &partialVertices[0].m_position.x, vertexStride, changedJointIndices);
+			}
+			else {
+				partialWriteback.WriteVariantv0(jobSystem, packets, jointTransforms.data(), simdLevel, &partialVertices[0].m_position.x, vertexStride, changedJointIndices);
+			}
+			double partialSeconds = GetCurrentTimeSeconds() - startTime;
+
+			result.m_isDDMBitIdentical[variantIdx] = result.m_isDDMBitIdentical[variantIdx] && AreRenderVerticesBitIdentical(fullVertices, partialVertices);
+			for (const IntRange& dirtyRange : partialWriteback.GetDirtyRanges()) {
+				std::copy(partialVertices.begin() + dirtyRange.m_min, partialVertices.begin() + dirtyRange.m_max + 1, uploadedVertices.begin() + dirtyRange.m_min);
+			}
+			result.m_doDirtyRangesCoverChanges = result.m_doDirtyRangesCoverChanges && AreRenderVerticesBitIdentical(uploadedVertices, partialVertices);
+			if (frameIdx > 0) {
+				result.m_fullDDMSeconds[variantIdx] += fullSeconds / (double)(numFrames - 1);
+				result.m_partialDDMSeconds[variantIdx] += partialSeconds / (double)(numFrames - 1);
+				result.m_averageNumDeformedPackets += (double)partialWriteback.GetNumDeformedPackets();
+				numPartialWrites++;
+			}
+		}
+	}
+	result.m_averageNumDeformedPackets /= (double)std::max(numPartialWrites, 1);
+	return result;
+}
+
+bool Command_FBXSkeletonPartialUpdateTest(EventArgs& args)
+{
+	int numJoints = atoi(args.GetValue("NumJoints", std::string("120")).c_str());
+	int numControlPoints = atoi(args.GetValue("NumControlPoints", std::string("100000")).c_str());
+	int numDDMJoints = atoi(args.GetValue("NumDDMJoints", std::string("16")).c_str());
+	int numFrames = atoi(args.GetValue("Frames", std::string("200")).c_str());
+	int numRepeats = atoi(args.GetValue("Repeats", std::string("20")).c_str());
+
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "FBXSkeletonPartialUpdateTest needs g_theJobSystem");
+	FBXSkeletonPartialUpdateTestResult result = RunFBXSkeletonPartialUpdateTest(*g_theJobSystem, numJoints, numControlPoints, std::max(numDDMJoints, 2), std::max(numFrames, 2),
+		std::max(numRepeats, 1));
+	PrintBenchmarkLine(Stringf("FBXSkeletonPartialUpdateTest: %d joints, %d frames", result.m_numJoints, result.m_numFrames));
+	PrintBenchmarkLine(Stringf("  Matches a full recompute %s, changed joints cover every change %s, same pose changes nothing %s", GetBenchmarkCheckString(result.m_doMatricesMatch),
+		GetBenchmarkCheckString(result.m_doChangedJointsCoverChanges), GetBenchmarkCheckString(result.m_isSamePoseUnchanged)));
+	PrintBenchmarkLine(Stringf("  IK frame: full %8.3lf us, partial %8.3lf us (%.1lf of %d joints recomputed), x%.2lf", result.m_fullSeconds * 1.0e6, result.m_partialSeconds * 1.0e6,
+		result.m_averageNumChangedJoints, result.m_numJoints, result.m_fullSeconds / result.m_partialSeconds));
+	PrintBenchmarkLine(Stringf("  DDM: %d control points, %d joints, %.1lf of %d packets deformed per frame, dirty ranges cover every change %s", result.m_numControlPoints,
+		result.m_numDDMJoints, result.m_averageNumDeformedPackets, result.m_numPackets, GetBenchmarkCheckString(result.m_doDirtyRangesCoverChanges)));
+	for (int variantIdx = 0; variantIdx < 2; variantIdx++) {
+		PrintBenchmarkLine(Stringf("  v%d: full write %8.2lf ms, changed joints only %8.2lf ms, x%.2lf, bit identical %s", variantIdx, result.m_fullDDMSeconds[variantIdx] * 1000.0,
+			result.m_partialDDMSeconds[variantIdx] * 1000.0, result.m_fullDDMSeconds[variantIdx] / result.m_partialDDMSeconds[variantIdx],
+			GetBenchmarkCheckString(result.m_isDDMBitIdentical[variantIdx])));
+	}
+	return result.m_doMatricesMatch && result.m_doChangedJointsCoverChanges && result.m_isSamePoseUnchanged && result.m_doDirtyRangesCoverChanges
+		&& result.m_isDDMBitIdentical[0] && result.m_isDDMBitIdentical[1];
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+
+class JobSystem;
+
+struct FBXSkeletonPartialUpdateTestResult {
+	int m_numJoints = 0;
+	int m_numFrames = 0;
+	bool m_doMatricesMatch = false;	//Global and skinning matrices of the partial update byte for byte the same as a full recompute, on every frame
+	bool m_doChangedJointsCoverChanges = false;	//Every joint whose matrices changed since the previous frame is in m_changedJointIndices
+	bool m_isSamePoseUnchanged = false;	//Frames that set nothing or the same values again change no joint
+	double m_averageNumChangedJoints = 0.0;	//On the IK frames
+	double m_fullSeconds = 0.0;	//Per IK frame: the edits, then UpdateAllGlobalTransforms
+	double m_partialSeconds = 0.0;	//The edits, then UpdateGlobalTransforms
+
+	int m_numControlPoints = 0;	//The DDM side, on the precompute benchmark's tube and its joint chain
+	int m_numDDMJoints = 0;
+	int m_numPackets = 0;
+	bool m_isDDMBitIdentical[2] = {};	//v0, v1: the render vertices of writes limited to the changed joints byte for byte the same as full writes, on every frame
+	bool m_doDirtyRangesCoverChanges = false;
+	double m_averageNumDeformedPackets = 0.0;	//Per partial write
+	double m_fullDDMSeconds[2] = {};	//Per frame
+	double m_partialDDMSeconds[2] = {};
+};
+
+//Random skeletons edited the way the IK solver and the gizmos do: the delta rotates of a short chain, sometimes a whole new pose, sometimes nothing.
+//Then the tube's joint chain with one joint of its top half rotated per frame, deformed by DDMRenderVertexWriteback with and without the changed joints
+FBXSkeletonPartialUpdateTestResult RunFBXSkeletonPartialUpdateTest(JobSystem& jobSystem, int numJoints, int numControlPoints, int numDDMJoints, int numFrames, int numRepeats);
+
+bool Command_FBXSkeletonPartialUpdateTest(EventArgs& args);	//Defaults to 120 joints, and 100k control points with 16 joints for DDM
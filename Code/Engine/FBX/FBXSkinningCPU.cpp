@@ -0,0 +1,467 @@
+#include "Engine/Fbx/FBXSkinningCPU.hpp"
+#include "Engine/Fbx/FBXSimdLanes.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+
+constexpr int BLOCK_SIZE = CPUSkinningVertexBlocks::BLOCK_SIZE;
+constexpr int MAX_NUM_INFLUENCES = CPUSkinningVertexBlocks::MAX_NUM_INFLUENCES;
+constexpr int LBS_FLOATS_PER_JOINT = 16;
+constexpr int DQS_FLOATS_PER_JOINT = 8;
+constexpr float MIN_LENGTH_SQUARED = 1e-30f;	//Keeps the normalizations of zero vectors finite
+
+static const char* s_skinningMethodNames[] = { "LBS", "DQS" };
+static_assert(sizeof(s_skinningMethodNames) / sizeof(s_skinningMethodNames[0]) == (size_t)CPUSkinningMethod::COUNT, "Every CPUSkinningMethod needs a name");
+
+const char* GetCPUSkinningMethodName(CPUSkinningMethod method)
+{
+	GUARANTEE_OR_DIE(method >= CPUSkinningMethod::LINEAR_BLEND && method < CPUSkinningMethod::COUNT, "Invalid CPUSkinningMethod");
+	return s_skinningMethodNames[(int)method];
+}
+
+bool GetCPUSkinningMethodFromName(const std::string& name, CPUSkinningMethod& outMethod)
+{
+	for (int methodIdx = 0; methodIdx < (int)CPUSkinningMethod::COUNT; methodIdx++) {
+		if (AreStringsEqualCaseInsensitive(name, s_skinningMethodNames[methodIdx])) {
+			outMethod = (CPUSkinningMethod)methodIdx;
+			return true;
+		}
+	}
+	return false;
+}
+
+//The 8 influences in the order SetRigidBinding stores them
+static void GetVertexInfluences(const Vertex_FBX& vertex, int* outJointIndices, float* outWeights)
+{
+	const int jointIndices[MAX_NUM_INFLUENCES] = { vertex.m_jointIndices1.x, vertex.m_jointIndices1.y, vertex.m_jointIndices1.z, vertex.m_jointIndices1.w,
+		vertex.m_jointIndices2.x, vertex.m_jointIndices2.y, vertex.m_jointIndices2.z, vertex.m_jointIndices2.w };
+	const float weights[MAX_NUM_INFLUENCES] = { vertex.m_jointWeights1.x, vertex.m_jointWeights1.y, vertex.m_jointWeights1.z, vertex.m_jointWeights1.w,
+		vertex.m_jointWeights2.x, vertex.m_jointWeights2.y, vertex.m_jointWeights2.z, vertex.m_jointWeights2.w };
+	std::copy(jointIndices, jointIndices + MAX_NUM_INFLUENCES, outJointIndices);
+	std::copy(weights, weights + MAX_NUM_INFLUENCES, outWeights);
+}
+
+void CPUSkinningVertexBlocks::Build(const std::vector<Vertex_FBX>& restVertices)
+{
+	m_numVertices = (int)restVertices.size();
+	int numBlocks = (m_numVertices + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	m_numBlockInfluences.assign(numBlocks, 0);
+	m_jointIndices.assign((size_t)numBlocks * MAX_NUM_INFLUENCES * BLOCK_SIZE, 0);
+	m_weights.assign((size_t)numBlocks * MAX_NUM_INFLUENCES * BLOCK_SIZE, 0.0f);
+	m_restPositions.assign((size_t)numBlocks * 3 * BLOCK_SIZE, 0.0f);
+	m_restNormals.assign((size_t)numBlocks * 3 * BLOCK_SIZE, 0.0f);
+
+	for (int vertexIdx = 0; vertexIdx < m_numVertices; vertexIdx++) {
+		int blockIdx = vertexIdx / BLOCK_SIZE;
+		int laneIdx = vertexIdx % BLOCK_SIZE;
+		const Vertex_FBX& vertex = restVertices[vertexIdx];
+
+		int jointIndices[MAX_NUM_INFLUENCES];
+		float weights[MAX_NUM_INFLUENCES];
+		GetVertexInfluences(vertex, jointIndices, weights);
+		int order[MAX_NUM_INFLUENCES] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		std::stable_sort(order, order + MAX_NUM_INFLUENCES, [&](int a, int b) { return weights[a] > weights[b]; });	//The first one is the dual quaternion pivot
+
+		int numInfluences = 0;
+		int* blockJointIndices = m_jointIndices.data() + (size_t)blockIdx * MAX_NUM_INFLUENCES * BLOCK_SIZE;
+		float* blockWeights = m_weights.data() + (size_t)blockIdx * MAX_NUM_INFLUENCES * BLOCK_SIZE;
+		for (int influenceIdx = 0; influenceIdx < MAX_NUM_INFLUENCES; influenceIdx++) {
+			int sourceIdx = order[influenceIdx];
+			if (weights[sourceIdx] == 0.0f) {
+				continue;
+			}
+			blockJointIndices[numInfluences * BLOCK_SIZE + laneIdx] = jointIndices[sourceIdx];
+			blockWeights[numInfluences * BLOCK_SIZE + laneIdx] = weights[sourceIdx];
+			numInfluences++;
+		}
+		m_numBlockInfluences[blockIdx] = (unsigned char)std::max((int)m_numBlockInfluences[blockIdx], numInfluences);
+
+		float* blockRestPositions = m_restPositions.data() + (size_t)blockIdx * 3 * BLOCK_SIZE;
+		float* blockRestNormals = m_restNormals.data() + (size_t)blockIdx * 3 * BLOCK_SIZE;
+		blockRestPositions[0 * BLOCK_SIZE + laneIdx] = vertex.m_position.x;
+		blockRestPositions[1 * BLOCK_SIZE + laneIdx] = vertex.m_position.y;
+		blockRestPositions[2 * BLOCK_SIZE + laneIdx] = vertex.m_position.z;
+		blockRestNormals[0 * BLOCK_SIZE + laneIdx] = vertex.m_normal.x;
+		blockRestNormals[1 * BLOCK_SIZE + laneIdx] = vertex.m_normal.y;
+		blockRestNormals[2 * BLOCK_SIZE + laneIdx] = vertex.m_normal.z;
+	}
+}
+
+size_t CPUSkinningVertexBlocks::GetNumBytes() const
+{
+	return m_numBlockInfluences.size() + m_jointIndices.size() * sizeof(int) + (m_weights.size() + m_restPositions.size() + m_restNormals.size()) * sizeof(float);
+}
+
+//Unit rotation quaternion (x, y, z, w) of a row major 3x3 matrix (Shepperd's method, which divides by the largest of the four possible terms)
+static void GetQuaternionFromRotationMatrix(const float* R, int rowStride, float* outQuaternion)
+{
+	float m00 = R[0], m01 = R[1], m02 = R[2];
+	float m10 = R[rowStride + 0], m11 = R[rowStride + 1], m12 = R[rowStride + 2];
+	float m20 = R[2 * rowStride + 0], m21 = R[2 * rowStride + 1], m22 = R[2 * rowStride + 2];
+	float trace = m00 + m11 + m22;
+	float x, y, z, w;
+	if (trace > 0.0f) {
+		float s = 2.0f * sqrtf(trace + 1.0f);
+		w = 0.25f * s;
+		x = (m21 - m12) / s;
+		y = (m02 - m20) / s;
+		z = (m10 - m01) / s;
+	}
+	else if (m00 > m11 && m00 > m22) {
+		float s = 2.0f * sqrtf(1.0f + m00 - m11 - m22);
+		w = (m21 - m12) / s;
+		x = 0.25f * s;
+		y = (m01 + m10) / s;
+		z = (m02 + m20) / s;
+	}
+	else if (m11 > m22) {
+		float s = 2.0f * sqrtf(1.0f + m11 - m00 - m22);
+		w = (m02 - m20) / s;
+		x = (m01 + m10) / s;
+		y = 0.25f * s;
+		z = (m12 + m21) / s;
+	}
+	else {
+		float s = 2.0f * sqrtf(1.0f + m22 - m00 - m11);
+		w = (m10 - m01) / s;
+		x = (m02 + m20) / s;
+		y = (m12 + m21) / s;
+		z = 0.25f * s;
+	}
+	float invLength = 1.0f / sqrtf(x * x + y * y + z * z + w * w);
+	outQuaternion[0] = x * invLength;
+	outQuaternion[1] = y * invLength;
+	outQuaternion[2] = z * invLength;
+	outQuaternion[3] = w * invLength;
+}
+
+void ConvertJointTransformsForCPUSkinning(CPUSkinningMethod method, const std::vector<Mat44>& allJointSkinningMatrices, std::vector<float>& outJointData)
+{
+	if (method == CPUSkinningMethod::LINEAR_BLEND) {
+		ConvertJointTransformsToFloats(allJointSkinningMatrices, outJointData);
+		return;
+	}
+
+	std::vector<float> rowMajorTransforms;
+	ConvertJointTransformsToFloats(allJointSkinningMatrices, rowMajorTransforms);
+	int numJoints = (int)allJointSkinningMatrices.size();
+	outJointData.resize((size_t)numJoints * DQS_FLOATS_PER_JOINT);
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		const float* M = rowMajorTransforms.data() + (size_t)jointIdx * LBS_FLOATS_PER_JOINT;
+		float* dualQuaternion = outJointData.data() + (size_t)jointIdx * DQS_FLOATS_PER_JOINT;
+		float* qr = dualQuaternion;
+		float* qd = dualQuaternion + 4;
+		GetQuaternionFromRotationMatrix(M, 4, qr);
+
+		//qd = 0.5 * (t, 0) * qr
+		float tx = M[3], ty = M[7], tz = M[11];
+		qd[0] = 0.5f * (qr[3] * tx + ty * qr[2] - tz * qr[1]);
+		qd[1] = 0.5f * (qr[3] * ty + tz * qr[0] - tx * qr[2]);
+		qd[2] = 0.5f * (qr[3] * tz + tx * qr[1] - ty * qr[0]);
+		qd[3] = -0.5f * (tx * qr[0] + ty * qr[1] + tz * qr[2]);
+	}
+}
+
+int GetNumCPUSkinningFloatsPerJoint(CPUSkinningMethod method)
+{
+	return method == CPUSkinningMethod::LINEAR_BLEND ? LBS_FLOATS_PER_JOINT : DQS_FLOATS_PER_JOINT;
+}
+
+//Entry jointIndices[lane] * stride of base for every lane. Different lanes usually read different joints, so this is a gather
+static inline void GatherLanes(const float* base, const int* jointIndices, int stride, float& out) { out = base[jointIndices[0] * stride]; }
+#if defined(DDM_HAS_X86_SIMD)
+static inline void GatherLanes(const float* base, const int* jointIndices, int stride, DDMFloat4& out)
+{
+	out = _mm_setr_ps(base[jointIndices[0] * stride], base[jointIndices[1] * stride], base[jointIndices[2] * stride], base[jointIndices[3] * stride]);	//SSE has no gather
+}
+DDM_TARGET_AVX2 static inline void GatherLanes(const float* base, const int* jointIndices, int stride, DDMFloat8& out)
+{
+	__m256i offsets = _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)jointIndices), _mm256_set1_epi32(stride));
+	out = _mm256_i32gather_ps(base, offsets, 4);
+}
+#endif
+
+template<typename F>
+static inline void StoreNormalized(const F* v, float* outBlockVectors, int laneOffset)
+{
+	F invLength = LaneRsqrt(LaneMax(v[0] * v[0] + v[1] * v[1] + v[2] * v[2], F(MIN_LENGTH_SQUARED)));
+	for (int i = 0; i < 3; i++) {
+		StoreLanes(outBlockVectors + i * BLOCK_SIZE + laneOffset, v[i] * invLength);
+	}
+}
+
+template<typename F>
+static void SkinBlockLBSLanes(const CPUSkinningVertexBlocks& blocks, int blockIdx, const float* jointTransforms, float* outBlockPositions, float* outBlockNormals)
+{
+	constexpr int LANE_WIDTH = (int)(sizeof(F) / sizeof(float));
+	int numInfluences = blocks.GetNumInfluencesOfBlock(blockIdx);
+	const int* blockJointIndices = blocks.GetBlockJointIndices(blockIdx);
+	const float* blockWeights = blocks.GetBlockWeights(blockIdx);
+	const float* blockRestPositions = blocks.GetBlockRestPositions(blockIdx);
+	const float* blockRestNormals = blocks.GetBlockRestNormals(blockIdx);
+	for (int laneOffset = 0; laneOffset < BLOCK_SIZE; laneOffset += LANE_WIDTH) {
+		//Top 3 rows of the blended matrix, row major
+		F M[12];
+		for (int entryIdx = 0; entryIdx < 12; entryIdx++) {
+			M[entryIdx] = F(0.0f);
+		}
+		for (int influenceIdx = 0; influenceIdx < numInfluences; influenceIdx++) {
+			const int* jointIndices = blockJointIndices + influenceIdx * BLOCK_SIZE + laneOffset;
+			F weight;
+			LoadLanes(blockWeights + influenceIdx * BLOCK_SIZE + laneOffset, weight);
+			for (int entryIdx = 0; entryIdx < 12; entryIdx++) {
+				F entry;
+				GatherLanes(jointTransforms + entryIdx, jointIndices, LBS_FLOATS_PER_JOINT, entry);
+				M[entryIdx] = M[entryIdx] + weight * entry;
+			}
+		}
+
+		F p[3];
+		for (int i = 0; i < 3; i++) {
+			LoadLanes(blockRestPositions + i * BLOCK_SIZE + laneOffset, p[i]);
+		}
+		for (int row = 0; row < 3; row++) {
+			StoreLanes(outBlockPositions + row * BLOCK_SIZE + laneOffset, M[row * 4 + 0] * p[0] + M[row * 4 + 1] * p[1] + M[row * 4 + 2] * p[2] + M[row * 4 + 3]);
+		}
+		if (outBlockNormals) {
+			F n[3];
+			for (int i = 0; i < 3; i++) {
+				LoadLanes(blockRestNormals + i * BLOCK_SIZE + laneOffset, n[i]);
+			}
+			F skinnedNormal[3];
+			for (int row = 0; row < 3; row++) {
+				skinnedNormal[row] = M[row * 4 + 0] * n[0] + M[row * 4 + 1] * n[1] + M[row * 4 + 2] * n[2];
+			}
+			StoreNormalized(skinnedNormal, outBlockNormals, laneOffset);
+		}
+	}
+}
+
+//v + 2 * r.xyz x (r.xyz x v + r.w * v)
+template<typename F>
+static inline void RotateByQuaternion(const F* r, const F* v, F* outV)
+{
+	F c[3] = {
+		r[1] * v[2] - r[2] * v[1] + r[3] * v[0],
+		r[2] * v[0] - r[0] * v[2] + r[3] * v[1],
+		r[0] * v[1] - r[1] * v[0] + r[3] * v[2]
+	};
+	outV[0] = v[0] + 2.0f * (r[1] * c[2] - r[2] * c[1]);
+	outV[1] = v[1] + 2.0f * (r[2] * c[0] - r[0] * c[2]);
+	outV[2] = v[2] + 2.0f * (r[0] * c[1] - r[1] * c[0]);
+}
+
+template<typename F>
+static void SkinBlockDQSLanes(const CPUSkinningVertexBlocks& blocks, int blockIdx, const float* jointDualQuaternions, float* outBlockPositions, float* outBlockNormals)
+{
+	constexpr int LANE_WIDTH = (int)(sizeof(F) / sizeof(float));
+	int numInfluences = blocks.GetNumInfluencesOfBlock(blockIdx);
+	const int* blockJointIndices = blocks.GetBlockJointIndices(blockIdx);
+	const float* blockWeights = blocks.GetBlockWeights(blockIdx);
+	const float* blockRestPositions = blocks.GetBlockRestPositions(blockIdx);
+	const float* blockRestNormals = blocks.GetBlockRestNormals(blockIdx);
+	for (int laneOffset = 0; laneOffset < BLOCK_SIZE; laneOffset += LANE_WIDTH) {
+		F blendedQ[8];
+		for (int entryIdx = 0; entryIdx < 8; entryIdx++) {
+			blendedQ[entryIdx] = F(0.0f);
+		}
+		F pivot[4];
+		for (int influenceIdx = 0; influenceIdx < numInfluences; influenceIdx++) {
+			const int* jointIndices = blockJointIndices + influenceIdx * BLOCK_SIZE + laneOffset;
+			F weight;
+			LoadLanes(blockWeights + influenceIdx * BLOCK_SIZE + laneOffset, weight);
+			F q[8];
+			for (int entryIdx = 0; entryIdx < 8; entryIdx++) {
+				GatherLanes(jointDualQuaternions + entryIdx, jointIndices, DQS_FLOATS_PER_JOINT, q[entryIdx]);
+			}
+			//q and -q are the same rotation. Taking the one on the side of the heaviest influence keeps the blend from going the long way around
+			if (influenceIdx == 0) {
+				for (int i = 0; i < 4; i++) {
+					pivot[i] = q[i];
+				}
+			}
+			F dot = pivot[0] * q[0] + pivot[1] * q[1] + pivot[2] * q[2] + pivot[3] * q[3];
+			F signedWeight = LaneSelect(dot < F(0.0f), -weight, weight);
+			for (int entryIdx = 0; entryIdx < 8; entryIdx++) {
+				blendedQ[entryIdx] = blendedQ[entryIdx] + signedWeight * q[entryIdx];
+			}
+		}
+
+		F invLength = LaneRsqrt(LaneMax(blendedQ[0] * blendedQ[0] + blendedQ[1] * blendedQ[1] + blendedQ[2] * blendedQ[2] + blendedQ[3] * blendedQ[3], F(MIN_LENGTH_SQUARED)));
+		F r[4];
+		F d[4];
+		for (int i = 0; i < 4; i++) {
+			r[i] = blendedQ[i] * invLength;
+			d[i] = blendedQ[4 + i] * invLength;
+		}
+		//t = 2 * (r.w * d.xyz - d.w * r.xyz + r.xyz x d.xyz)
+		F t[3] = {
+			2.0f * (r[3] * d[0] - d[3] * r[0] + r[1] * d[2] - r[2] * d[1]),
+			2.0f * (r[3] * d[1] - d[3] * r[1] + r[2] * d[0] - r[0] * d[2]),
+			2.0f * (r[3] * d[2] - d[3] * r[2] + r[0] * d[1] - r[1] * d[0])
+		};
+
+		F p[3];
+		for (int i = 0; i < 3; i++) {
+			LoadLanes(blockRestPositions + i * BLOCK_SIZE + laneOffset, p[i]);
+		}
+		F rotatedP[3];
+		RotateByQuaternion(r, p, rotatedP);
+		for (int i = 0; i < 3; i++) {
+			StoreLanes(outBlockPositions + i * BLOCK_SIZE + laneOffset, rotatedP[i] + t[i]);
+		}
+		if (outBlockNormals) {
+			F n[3];
+			for (int i = 0; i < 3; i++) {
+				LoadLanes(blockRestNormals + i * BLOCK_SIZE + laneOffset, n[i]);
+			}
+			F rotatedN[3];
+			RotateByQuaternion(r, n, rotatedN);
+			StoreNormalized(rotatedN, outBlockNormals, laneOffset);
+		}
+	}
+}
+
+#if defined(DDM_HAS_X86_SIMD)
+//Same as the DDM kernels: the templates only become AVX2 code once they are flattened into a function with the target attribute
+DDM_TARGET_AVX2 DDM_FLATTEN static void SkinBlockLBSAVX2(const CPUSkinningVertexBlocks& blocks, int blockIdx, const float* jointTransforms, float* outBlockPositions, float* outBlockNormals)
+{
+	SkinBlockLBSLanes<DDMFloat8>(blocks, blockIdx, jointTransforms, outBlockPositions, outBlockNormals);
+}
+
+DDM_TARGET_AVX2 DDM_FLATTEN static void SkinBlockDQSAVX2(const CPUSkinningVertexBlocks& blocks, int blockIdx, const float* jointDualQuaternions, float* outBlockPositions, float* outBlockNormals)
+{
+	SkinBlockDQSLanes<DDMFloat8>(blocks, blockIdx, jointDualQuaternions, outBlockPositions, outBlockNormals);
+}
+#endif
+
+static void SkinBlock(const CPUSkinningVertexBlocks& blocks, int blockIdx, CPUSkinningMethod method, const float* jointData, float* outBlockPositions, float* outBlockNormals,
+	DDMSimdLevel simdLevel)
+{
+	bool isLinearBlend = method == CPUSkinningMethod::LINEAR_BLEND;
+	switch (simdLevel) {
+#if defined(DDM_HAS_X86_SIMD)
+	case DDMSimdLevel::AVX2:
+		if (isLinearBlend) {
+			SkinBlockLBSAVX2(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		else {
+			SkinBlockDQSAVX2(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		break;
+	case DDMSimdLevel::SSE:
+		if (isLinearBlend) {
+			SkinBlockLBSLanes<DDMFloat4>(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		else {
+			SkinBlockDQSLanes<DDMFloat4>(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		break;
+#endif
+	default:
+		if (isLinearBlend) {
+			SkinBlockLBSLanes<float>(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		else {
+			SkinBlockDQSLanes<float>(blocks, blockIdx, jointData, outBlockPositions, outBlockNormals);
+		}
+		break;
+	}
+}
+
+void ComputeCPUSkinnedVertices(const CPUSkinningVertexBlocks& blocks, CPUSkinningMethod method, const float* jointData, int beginBlockIdx, int endBlockIdx,
+	float* outPositions, float* outNormals, int vertexStride, DDMSimdLevel simdLevel)
+{
+	if (simdLevel > GetHighestSupportedDDMSimdLevel()) {
+		ERROR_AND_DIE(Stringf("%s is not supported on this CPU", GetDDMSimdLevelName(simdLevel)));
+	}
+
+	int numVertices = blocks.GetNumVertices();
+	float blockPositions[3 * BLOCK_SIZE];
+	float blockNormals[3 * BLOCK_SIZE];
+	for (int blockIdx = beginBlockIdx; blockIdx < endBlockIdx; blockIdx++) {
+		SkinBlock(blocks, blockIdx, method, jointData, blockPositions, outNormals ? blockNormals : nullptr, simdLevel);
+
+		int firstVertexIdx = blockIdx * BLOCK_SIZE;
+		int numLanes = std::min(BLOCK_SIZE, numVertices - firstVertexIdx);
+		for (int laneIdx = 0; laneIdx < numLanes; laneIdx++) {
+			float* outPosition = outPositions + (size_t)(firstVertexIdx + laneIdx) * vertexStride;
+			outPosition[0] = blockPositions[0 * BLOCK_SIZE + laneIdx];
+			outPosition[1] = blockPositions[1 * BLOCK_SIZE + laneIdx];
+			outPosition[2] = blockPositions[2 * BLOCK_SIZE + laneIdx];
+			if (outNormals) {
+				float* outNormal = outNormals + (size_t)(firstVertexIdx + laneIdx) * vertexStride;
+				outNormal[0] = blockNormals[0 * BLOCK_SIZE + laneIdx];
+				outNormal[1] = blockNormals[1 * BLOCK_SIZE + laneIdx];
+				outNormal[2] = blockNormals[2 * BLOCK_SIZE + laneIdx];
+			}
+		}
+	}
+}
+
+static Eigen::Matrix4d GetEigenMatrix(const Mat44& matrix)
+{
+	Eigen::Matrix4d eigenMatrix;
+	for (int row = 0; row < 4; row++) {
+		for (int col = 0; col < 4; col++) {
+			eigenMatrix(row, col) = (double)matrix.m_values[col * 4 + row];	//Mat44 is column major
+		}
+	}
+	return eigenMatrix;
+}
+
+void ComputeCPUSkinnedVertexReference(CPUSkinningMethod method, const Vertex_FBX& restVertex, const std::vector<Mat44>& allJointSkinningMatrices, Vec3& outPosition, Vec3& outNormal)
+{
+	int jointIndices[MAX_NUM_INFLUENCES];
+	float weights[MAX_NUM_INFLUENCES];
+	GetVertexInfluences(restVertex, jointIndices, weights);
+	Eigen::Vector3d p(restVertex.m_position.x, restVertex.m_position.y, restVertex.m_position.z);
+	Eigen::Vector3d n(restVertex.m_normal.x, restVertex.m_normal.y, restVertex.m_normal.z);
+	Eigen::Vector3d skinnedP;
+	Eigen::Vector3d skinnedN;
+
+	if (method == CPUSkinningMethod::LINEAR_BLEND) {
+		Eigen::Matrix4d M = Eigen::Matrix4d::Zero();
+		for (int influenceIdx = 0; influenceIdx < MAX_NUM_INFLUENCES; influenceIdx++) {
+			if (weights[influenceIdx] != 0.0f) {
+				M += (double)weights[influenceIdx] * GetEigenMatrix(allJointSkinningMatrices[jointIndices[influenceIdx]]);
+			}
+		}
+		skinnedP = M.topLeftCorner<3, 3>() * p + M.topRightCorner<3, 1>();
+		skinnedN = M.topLeftCorner<3, 3>() * n;
+	}
+	else {
+		int pivotIdx = (int)(std::max_element(weights, weights + MAX_NUM_INFLUENCES) - weights);
+		Eigen::Quaterniond pivot;
+		Eigen::Quaterniond blendedReal(0.0, 0.0, 0.0, 0.0);
+		Eigen::Quaterniond blendedDual(0.0, 0.0, 0.0, 0.0);
+		for (int step = 0; step < MAX_NUM_INFLUENCES; step++) {
+			int influenceIdx = (pivotIdx + step) % MAX_NUM_INFLUENCES;	//The pivot first
+			if (weights[influenceIdx] == 0.0f) {
+				continue;
+			}
+			Eigen::Matrix4d M = GetEigenMatrix(allJointSkinningMatrices[jointIndices[influenceIdx]]);
+			Eigen::Quaterniond real(Eigen::Matrix3d(M.topLeftCorner<3, 3>()));
+			real.normalize();
+			Eigen::Vector3d t = M.topRightCorner<3, 1>();
+			Eigen::Quaterniond dual = Eigen::Quaterniond(0.0, 0.5 * t.x(), 0.5 * t.y(), 0.5 * t.z()) * real;
+			if (step == 0) {
+				pivot = real;
+			}
+			double signedWeight = pivot.dot(real) < 0.0 ? -(double)weights[influenceIdx] : (double)weights[influenceIdx];
+			blendedReal.coeffs() += signedWeight * real.coeffs();
+			blendedDual.coeffs() += signedWeight * dual.coeffs();
+		}
+		double length = blendedReal.norm();
+		Eigen::Quaterniond r(blendedReal.coeffs() / length);
+		Eigen::Quaterniond d(blendedDual.coeffs() / length);
+		Eigen::Vector3d t = 2.0 * (d * r.conjugate()).vec();
+		skinnedP = r * p + t;
+		skinnedN = r * n;
+	}
+	skinnedN.normalize();
+	outPosition = Vec3((float)skinnedP.x(), (float)skinnedP.y(), (float)skinnedP.z());
+	outNormal = Vec3((float)skinnedN.x(), (float)skinnedN.y(), (float)skinnedN.z());
+}
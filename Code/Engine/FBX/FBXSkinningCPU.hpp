@@ -0,0 +1,58 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Fbx/Vertex_FBX.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include <string>
+#include <vector>
+
+//Vectorized CPU skinning with the 8 influences of Vertex_FBX, for headless tools and as the baseline DDM gets compared against. Same lane types and SIMD levels as the DDM kernels
+
+enum class CPUSkinningMethod {
+	LINEAR_BLEND,		//Sum of the weighted skinning matrices, like the LBS vertex shader
+	DUAL_QUATERNION,	//Blends unit dual quaternions instead, so twisting joints keep their volume. Assumes the skinning matrices are rigid, scale is dropped
+	COUNT
+};
+
+const char* GetCPUSkinningMethodName(CPUSkinningMethod method);
+bool GetCPUSkinningMethodFromName(const std::string& name, CPUSkinningMethod& outMethod);	//Case insensitive
+
+//Rest positions, normals and influences regrouped into blocks of BLOCK_SIZE vertices: [influence][lane] joint indices and weights, [3][lane] positions and normals.
+//The influences of every vertex are sorted by descending weight, so a block only loops over as many as its most influenced vertex has
+class CPUSkinningVertexBlocks {
+public:
+	static constexpr int BLOCK_SIZE = 8;
+	static constexpr int MAX_NUM_INFLUENCES = 8;	//m_jointIndices1/2 and m_jointWeights1/2
+
+	//Reads the influences from m_jointIndices1/2 and m_jointWeights1/2 the way FBXMesh::SetRigidBinding fills them. Influences of weight 0 are dropped
+	void Build(const std::vector<Vertex_FBX>& restVertices);
+
+	int GetNumVertices() const { return m_numVertices; };
+	int GetNumBlocks() const { return (int)m_numBlockInfluences.size(); };
+	int GetNumInfluencesOfBlock(int blockIdx) const { return m_numBlockInfluences[blockIdx]; };
+	const int* GetBlockJointIndices(int blockIdx) const { return m_jointIndices.data() + (size_t)blockIdx * MAX_NUM_INFLUENCES * BLOCK_SIZE; };
+	const float* GetBlockWeights(int blockIdx) const { return m_weights.data() + (size_t)blockIdx * MAX_NUM_INFLUENCES * BLOCK_SIZE; };
+	const float* GetBlockRestPositions(int blockIdx) const { return m_restPositions.data() + (size_t)blockIdx * 3 * BLOCK_SIZE; };
+	const float* GetBlockRestNormals(int blockIdx) const { return m_restNormals.data() + (size_t)blockIdx * 3 * BLOCK_SIZE; };
+	size_t GetNumBytes() const;
+
+private:
+	int m_numVertices = 0;
+	std::vector<unsigned char> m_numBlockInfluences;
+	std::vector<int> m_jointIndices;	//Padding lanes and unused influences point at joint 0 with weight 0
+	std::vector<float> m_weights;
+	std::vector<float> m_restPositions;
+	std::vector<float> m_restNormals;
+};
+
+//LINEAR_BLEND: 16 floats per joint, like ConvertJointTransformsToFloats. DUAL_QUATERNION: 8 floats per joint, the rotation quaternion (x, y, z, w) then the dual part
+void ConvertJointTransformsForCPUSkinning(CPUSkinningMethod method, const std::vector<Mat44>& allJointSkinningMatrices, std::vector<float>& outJointData);
+int GetNumCPUSkinningFloatsPerJoint(CPUSkinningMethod method);
+
+//Skins the vertices of blocks [beginBlockIdx, endBlockIdx). Vertex i goes to outPositions + i * vertexStride (and outNormals, unless it is nullptr), so the output
+//can be a float3 array (vertexStride 3) or the render vertices themselves (sizeof(Vertex_FBX) / sizeof(float)). Normals come out normalized
+void ComputeCPUSkinnedVertices(const CPUSkinningVertexBlocks& blocks, CPUSkinningMethod method, const float* jointData, int beginBlockIdx, int endBlockIdx,
+	float* outPositions, float* outNormals, int vertexStride, DDMSimdLevel simdLevel);
+
+//Double precision path the kernels are checked against, one vertex at a time straight from its Vertex_FBX
+void ComputeCPUSkinnedVertexReference(CPUSkinningMethod method, const Vertex_FBX& restVertex, const std::vector<Mat44>& allJointSkinningMatrices, Vec3& outPosition, Vec3& outNormal);
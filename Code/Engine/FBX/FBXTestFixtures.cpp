@@ -0,0 +1,348 @@
+#include "Engine/Fbx/FBXTestFixtures.hpp"
+#include "Engine/Fbx/FBXSkinningCPU.hpp"
+#include "Engine/Fbx/FBXVertexDedup.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+void PrintBenchmarkLine(const std::string& line)
+{
+	DebuggerPrintf("%s\n", line.c_str());
+	if (g_theDevConsole) {
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, line);
+	}
+}
+
+const char* GetBenchmarkCheckString(bool hasPassed)
+{
+	return hasPassed ? "PASSED" : "FAILED";
+}
+
+void BenchmarkCheckList::Check(const char* checkName, bool hasCheckPassed)
+{
+	m_hasPassed = m_hasPassed && hasCheckPassed;
+	PrintBenchmarkLine(Stringf("  %-40s %s", checkName, GetBenchmarkCheckString(hasCheckPassed)));
+}
+
+std::vector<Mat44> GetSyntheticJointTransforms(int numJoints, RandomNumberGenerator& rng)
+{
+	std::vector<Mat44> jointTransforms(numJoints);
+	for (Mat44& jointTransform : jointTransforms) {
+		jointTransform.AppendTranslation3D(Vec3(rng.RollRandomFloatInRange(-0.5f, 0.5f), rng.RollRandomFloatInRange(-0.5f, 0.5f), rng.RollRandomFloatInRange(-0.5f, 0.5f)));
+		jointTransform.AppendZRotation(rng.RollRandomFloatInRange(-60.0f, 60.0f));
+		jointTransform.AppendYRotation(rng.RollRandomFloatInRange(-60.0f, 60.0f));
+		jointTransform.AppendXRotation(rng.RollRandomFloatInRange(-60.0f, 60.0f));
+	}
+	return jointTransforms;
+}
+
+SyntheticDDMMesh GetSyntheticMesh(int numControlPoints, int numJoints, RandomNumberGenerator& rng)
+{
+	constexpr int NUM_NEIGHBORHOOD_SAMPLES = 6;
+	constexpr float NEIGHBORHOOD_RADIUS = 0.05f;
+	constexpr double HELIX_RADIUS = 0.5;
+
+	SyntheticDDMMesh mesh;
+	mesh.m_numJoints = numJoints;
+	mesh.m_restPositions.resize(numControlPoints, 3);
+	mesh.m_neighborhoods.resize((size_t)numControlPoints * 10);
+
+	double numTurns = 1.0 + sqrt((double)numControlPoints) * 0.25;
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		double helixParameter = ((double)ctrlPointIdx + 0.5) / (double)numControlPoints;
+		double angle = 2.0 * 3.14159265358979323846 * numTurns * helixParameter;
+		double radius = HELIX_RADIUS + rng.RollRandomFloatInRange(-0.02f, 0.02f);
+		Eigen::Matrix<double, 1, 3> restPosition(radius * cos(angle), -1.0 + 2.0 * helixParameter, radius * sin(angle));
+		mesh.m_restPositions.row(ctrlPointIdx) = restPosition;
+
+		Eigen::Matrix<double, 4, 4> neighborhood;
+		neighborhood.setZero();
+		for (int sampleIdx = 0; sampleIdx < NUM_NEIGHBORHOOD_SAMPLES; sampleIdx++) {
+			Eigen::Matrix<double, 4, 1> u_k;
+			u_k << restPosition(0) + rng.RollRandomFloatInRange(-NEIGHBORHOOD_RADIUS, NEIGHBORHOOD_RADIUS),
+				restPosition(1) + rng.RollRandomFloatInRange(-NEIGHBORHOOD_RADIUS, NEIGHBORHOOD_RADIUS),
+				restPosition(2) + rng.RollRandomFloatInRange(-NEIGHBORHOOD_RADIUS, NEIGHBORHOOD_RADIUS),
+				1.0;
+			neighborhood += u_k * u_k.transpose() / (double)NUM_NEIGHBORHOOD_SAMPLES;
+		}
+		Eigen::VectorXd neighborhood10 = FBXDDMModifier::GetUpperTriangleOfSymmetric4x4Matrix(neighborhood);
+		std::copy(neighborhood10.data(), neighborhood10.data() + 10, mesh.m_neighborhoods.data() + (size_t)ctrlPointIdx * 10);
+	}
+	return mesh;
+}
+
+void BuildSyntheticOmegas(const SyntheticDDMMesh& mesh, int numControlPoints, double omegaEpsilon, DDMSparseOmegas& outOmegas)
+{
+	std::vector<double> omegaWeights;
+	std::vector<int> influencingJoints;
+	std::vector<int> numInfluencesPerControlPoint(numControlPoints);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		GetDDMSyntheticChainWeights(mesh.m_restPositions(ctrlPointIdx, 1), mesh.m_numJoints, omegaWeights);
+		DDMSparseOmegas::GetInfluencingJoints(omegaWeights.data(), mesh.m_numJoints, omegaEpsilon, influencingJoints);
+		numInfluencesPerControlPoint[ctrlPointIdx] = (int)influencingJoints.size();
+	}
+	outOmegas.Resize(mesh.m_numJoints, numInfluencesPerControlPoint);
+
+	double omega10[10];
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		GetDDMSyntheticChainWeights(mesh.m_restPositions(ctrlPointIdx, 1), mesh.m_numJoints, omegaWeights);
+		DDMSparseOmegas::GetInfluencingJoints(omegaWeights.data(), mesh.m_numJoints, omegaEpsilon, influencingJoints);
+		const double* neighborhood10 = mesh.m_neighborhoods.data() + (size_t)ctrlPointIdx * 10;
+		int influenceIdx = outOmegas.GetFirstInfluenceIdx(ctrlPointIdx);
+		for (int jointIdx : influencingJoints) {
+			for (int i = 0; i < 10; i++) {
+				omega10[i] = omegaWeights[jointIdx] * neighborhood10[i];
+			}
+			outOmegas.SetInfluence(influenceIdx, jointIdx, omega10);
+			influenceIdx++;
+		}
+	}
+}
+
+DDMSyntheticSkinnedMesh GetSyntheticSkinnedMesh(int numControlPoints, int numJoints)
+{
+	constexpr int NUM_SEGMENTS = 32;
+	return BuildDDMGridCylinder(std::max(numControlPoints / NUM_SEGMENTS, 2), NUM_SEGMENTS, numJoints);
+}
+
+DDMBakerSkeleton GetSyntheticBakerSkeleton(const DDMSyntheticSkinnedMesh& mesh)
+{
+	DDMBakerSkeleton skeleton;
+	int numJoints = (int)mesh.m_jointHeights.size();
+	skeleton.m_parentIndices.resize(numJoints);
+	skeleton.m_localTransformsWithoutDeltaRotate.resize(numJoints);
+	skeleton.m_globalBindPoseInverses.resize(numJoints);
+	double parentHeight = 0.0;
+	for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+		double jointHeight = mesh.m_jointHeights[jointIdx];
+		skeleton.m_parentIndices[jointIdx] = jointIdx - 1;
+		skeleton.m_localTransformsWithoutDeltaRotate[jointIdx] = Mat44::CreateTranslation3D(Vec3(0.0f, (float)(jointHeight - parentHeight), 0.0f));
+		skeleton.m_globalBindPoseInverses[jointIdx] = Mat44::CreateTranslation3D(Vec3(0.0f, (float)-jointHeight, 0.0f));
+		parentHeight = jointHeight;
+	}
+	skeleton.ComputeEvaluationOrder();
+	return skeleton;
+}
+
+void ComputeDDMv0Positions(JobSystem& jobSystem, const DDMControlPointPackets& packets, const std::vector<Mat44>& allJointSkinningMatrices, Eigen::MatrixX3f& outPositions)
+{
+	std::vector<float> jointTransforms;
+	ConvertJointTransformsToFloats(allJointSkinningMatrices, jointTransforms);
+	outPositions.resize(packets.GetNumControlPoints(), 3);
+	DDMSimdLevel simdLevel = GetHighestSupportedDDMSimdLevel();
+	jobSystem.ParallelForRange(0, packets.GetNumPackets(), 8, [&](int beginPacketIdx, int endPacketIdx) {
+		ComputeDDMv0DeformedControlPoints(packets, jointTransforms.data(), beginPacketIdx, endPacketIdx, outPositions.data(), 1, (int)outPositions.rows(), simdLevel);
+	});
+}
+
+void GetSyntheticRenderVertexMap(const Eigen::MatrixX3i& faces, int numFacesPerIsland, std::vector<unsigned int>& outRenderVertexToControlPointMap)
+{
+	outRenderVertexToControlPointMap.clear();
+	std::map<std::pair<int, int>, int> ctrlPointAndIslandToRenderVertexIdx;
+	for (int faceIdx = 0; faceIdx < (int)faces.rows(); faceIdx++) {
+		int islandIdx = (faceIdx / numFacesPerIsland) % 2;
+		for (int cornerIdx = 0; cornerIdx < 3; cornerIdx++) {
+			std::pair<int, int> key(faces(faceIdx, cornerIdx), islandIdx);
+			if (ctrlPointAndIslandToRenderVertexIdx.find(key) == ctrlPointAndIslandToRenderVertexIdx.end()) {
+				ctrlPointAndIslandToRenderVertexIdx[key] = (int)outRenderVertexToControlPointMap.size();
+				outRenderVertexToControlPointMap.push_back((unsigned int)faces(faceIdx, cornerIdx));
+			}
+		}
+	}
+}
+
+bool AreRenderVerticesBitIdentical(const std::vector<Vertex_FBX>& a, const std::vector<Vertex_FBX>& b)
+{
+	return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(Vertex_FBX)) == 0;
+}
+
+void GetSyntheticSkinnedRenderVertices(const DDMSyntheticSkinnedMesh& mesh, std::vector<Vertex_FBX>& outVertices)
+{
+	constexpr int MAX_NUM_INFLUENCES = CPUSkinningVertexBlocks::MAX_NUM_INFLUENCES;
+	int numVertices = (int)mesh.m_restPositions.rows();
+	int numJoints = (int)mesh.m_weights.cols();
+	int numInfluences = std::min(numJoints, MAX_NUM_INFLUENCES);
+	outVertices.resize(numVertices);
+	std::vector<int> jointOrder(numJoints);
+	for (int vertexIdx = 0; vertexIdx < numVertices; vertexIdx++) {
+		Vec3 position((float)mesh.m_restPositions(vertexIdx, 0), (float)mesh.m_restPositions(vertexIdx, 1), (float)mesh.m_restPositions(vertexIdx, 2));
+		Vec3 normal = Vec3(position.x, 0.0f, position.z).GetNormalized();
+		Vertex_FBX& vertex = outVertices[vertexIdx];
+		vertex = Vertex_FBX(position, normal, Vec3(0.0f, 1.0f, 0.0f), CrossProduct3D(normal, Vec3(0.0f, 1.0f, 0.0f)));
+
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			jointOrder[jointIdx] = jointIdx;
+		}
+		std::partial_sort(jointOrder.begin(), jointOrder.begin() + numInfluences, jointOrder.end(), [&](int a, int b) { return mesh.m_weights(vertexIdx, a) > mesh.m_weights(vertexIdx, b); });
+		double weightSum = 0.0;
+		for (int influenceIdx = 0; influenceIdx < numInfluences; influenceIdx++) {
+			weightSum += mesh.m_weights(vertexIdx, jointOrder[influenceIdx]);
+		}
+		for (int influenceIdx = 0; influenceIdx < numInfluences; influenceIdx++) {
+			int jointIdx = jointOrder[influenceIdx];
+			float weight = (float)(mesh.m_weights(vertexIdx, jointIdx) / weightSum);
+			if (influenceIdx < 4) {
+				vertex.m_jointIndices1[influenceIdx] = jointIdx;
+				vertex.m_jointWeights1[influenceIdx] = weight;
+			}
+			else {
+				vertex.m_jointIndices2[influenceIdx - 4] = jointIdx;
+				vertex.m_jointWeights2[influenceIdx - 4] = weight;
+			}
+		}
+	}
+}
+
+void GetSyntheticPolygonVertices(const DDMSyntheticSkinnedMesh& mesh, std::vector<Vertex_FBX>& outPolygonVertices, std::vector<int>& outPolygonVertexControlPointIndices)
+{
+	constexpr int NUM_FACES_PER_ISLAND = 500;
+	std::vector<Vertex_FBX> controlPointVertices;
+	GetSyntheticSkinnedRenderVertices(mesh, controlPointVertices);
+	int numFaces = (int)mesh.m_faces.rows();
+	outPolygonVertices.clear();
+	outPolygonVertexControlPointIndices.clear();
+	outPolygonVertices.reserve((size_t)numFaces * 3);
+	outPolygonVertexControlPointIndices.reserve((size_t)numFaces * 3);
+	for (int faceIdx = 0; faceIdx < numFaces; faceIdx++) {
+		int islandIdx = (faceIdx / NUM_FACES_PER_ISLAND) % 2;
+		for (int cornerIdx = 0; cornerIdx < 3; cornerIdx++) {
+			int cpIdx = mesh.m_faces(faceIdx, cornerIdx);
+			Vertex_FBX vertex = controlPointVertices[cpIdx];
+			vertex.m_normal = Vec3(faceIdx % 2 == 0 ? 0.0f : -0.0f, 0.0f, 0.0f);	//ProcessFbxMesh leaves the normals at 0 until CalculateFBXAveragedNormals, -0 is the same key
+			vertex.m_tangent = Vec3();
+			vertex.m_binormal = Vec3();
+			vertex.m_uvTexCoords = Vec2((float)islandIdx * 0.5f + vertex.m_position.x * 0.25f, vertex.m_position.y * 0.5f + 0.5f);
+			outPolygonVertices.push_back(vertex);
+			outPolygonVertexControlPointIndices.push_back(cpIdx);
+		}
+	}
+}
+
+Quaternion GetRandomBenchmarkRotation(RandomNumberGenerator& rng, float maxDegrees)
+{
+	Vec3 axis(rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f), rng.RollRandomFloatInRange(-1.0f, 1.0f));
+	if (axis.GetLength() < 0.01f) {
+		axis = Vec3(0.0f, 0.0f, 1.0f);
+	}
+	return Quaternion::CreateFromAxisAndDegrees(rng.RollRandomFloatInRange(-maxDegrees, maxDegrees), axis.GetNormalized());
+}
+
+//What FBXMesh::CreateCopy did for every copy before FBXMeshAsset was shared
+static std::shared_ptr<FBXMeshAsset> CopyFBXMeshAssetDeep(const FBXMeshAsset& asset)
+{
+	std::shared_ptr<FBXMeshAsset> copy = std::make_shared<FBXMeshAsset>();
+	copy->m_controlPointsRestPose.reserve(asset.m_controlPointsRestPose.size());
+	for (const FBXControlPoint* controlPoint : asset.m_controlPointsRestPose) {
+		FBXControlPoint* copiedControlPoint = new FBXControlPoint(controlPoint->m_position);
+		copiedControlPoint->m_jointWeightPairs = controlPoint->m_jointWeightPairs;
+		copy->m_controlPointsRestPose.push_back(copiedControlPoint);
+	}
+	copy->m_controlPointsMatrixRestPose = asset.m_controlPointsMatrixRestPose;
+	copy->m_facesMatrix = asset.m_facesMatrix;
+	copy->m_renderVertexToControlPointMap = asset.m_renderVertexToControlPointMap;
+	copy->m_renderIndices = asset.m_renderIndices;
+	copy->m_diffuseTexturePaths = asset.m_diffuseTexturePaths;
+	copy->m_specularTexturePaths = asset.m_specularTexturePaths;
+	copy->m_normalTexturePaths = asset.m_normalTexturePaths;
+	copy->m_glossTexturePaths = asset.m_glossTexturePaths;
+	copy->m_ambientTexturePaths = asset.m_ambientTexturePaths;
+	copy->m_weightsMatrix = asset.m_weightsMatrix;
+	copy->m_rigidWeightsMatrix = asset.m_rigidWeightsMatrix;
+	copy->m_boundingBox.m_mins = asset.m_boundingBox.m_mins;
+	copy->m_boundingBox.m_maxs = asset.m_boundingBox.m_maxs;
+	return copy;
+}
+
+BenchmarkModelInstance* CreateBenchmarkModelCopy(const BenchmarkModelInstance& source, bool isDeepCopy)
+{
+	BenchmarkModelInstance* copy = new BenchmarkModelInstance();
+	const std::vector<int>& parentIndices = source.m_skeleton.m_parentIndices;
+	copy->m_joints.reserve(source.m_joints.size());
+	for (int jointIdx = 0; jointIdx < (int)source.m_joints.size(); jointIdx++) {
+		BenchmarkTreeJoint* joint = new BenchmarkTreeJoint(*source.m_joints[jointIdx]);
+		joint->m_childJoints.clear();
+		joint->m_parentJoint = nullptr;
+		if (parentIndices[jointIdx] >= 0) {
+			joint->m_parentJoint = copy->m_joints[parentIndices[jointIdx]];
+			joint->m_parentJoint->m_childJoints.push_back(joint);
+		}
+		copy->m_joints.push_back(joint);
+	}
+
+	copy->m_renderVertices = source.m_renderVertices;
+	if (isDeepCopy) {
+		copy->m_meshAsset = CopyFBXMeshAssetDeep(*source.m_meshAsset);
+		std::shared_ptr<std::vector<BenchmarkPose>> poseSequence = std::make_shared<std::vector<BenchmarkPose>>(source.m_poseSequence->size());
+		for (int poseIdx = 0; poseIdx < (int)poseSequence->size(); poseIdx++) {
+			const BenchmarkPose& sourcePose = (*source.m_poseSequence)[poseIdx];
+			BenchmarkPose& pose = (*poseSequence)[poseIdx];
+			pose.m_localScalings = sourcePose.m_localScalings;
+			pose.m_localQuats = sourcePose.m_localQuats;
+			pose.m_localLocs = sourcePose.m_localLocs;
+		}
+		copy->m_poseSequence = poseSequence;
+	}
+	else {
+		copy->m_meshAsset = source.m_meshAsset;
+		copy->m_poseSequence = source.m_poseSequence;
+	}
+	copy->m_poseForThisFrame.m_localScalings = source.m_poseForThisFrame.m_localScalings;
+	copy->m_poseForThisFrame.m_localQuats = source.m_poseForThisFrame.m_localQuats;
+	copy->m_poseForThisFrame.m_localLocs = source.m_poseForThisFrame.m_localLocs;
+
+	copy->m_skeleton.SetJoints(parentIndices, source.m_skeleton.m_globalBindPoseInverses);
+
+	copy->m_ddmModifierCPU = source.m_ddmModifierCPU;
+	copy->m_rigidDDMModifierCPU = source.m_rigidDDMModifierCPU;
+	copy->m_isRigidBinding = source.m_isRigidBinding;
+	return copy;
+}
+
+std::shared_ptr<FBXMeshAsset> GetSyntheticFBXMeshAsset(JobSystem& jobSystem, const DDMSyntheticSkinnedMesh& mesh, int numJoints, std::vector<Vertex_FBX>& out_renderVertices)
+{
+	constexpr double MIN_WEIGHT = 1e-3;
+	std::shared_ptr<FBXMeshAsset> meshAsset = std::make_shared<FBXMeshAsset>();
+	int numControlPoints = (int)mesh.m_restPositions.rows();
+	meshAsset->m_controlPointsMatrixRestPose = mesh.m_restPositions;
+	meshAsset->m_facesMatrix = mesh.m_faces;
+	meshAsset->m_controlPointsRestPose.reserve(numControlPoints);
+	for (int ctrlPointIdx = 0; ctrlPointIdx < numControlPoints; ctrlPointIdx++) {
+		Vec3 position((float)mesh.m_restPositions(ctrlPointIdx, 0), (float)mesh.m_restPositions(ctrlPointIdx, 1), (float)mesh.m_restPositions(ctrlPointIdx, 2));
+		FBXControlPoint* controlPoint = new FBXControlPoint(position);
+		for (int jointIdx = 0; jointIdx < numJoints; jointIdx++) {
+			if (mesh.m_weights(ctrlPointIdx, jointIdx) >= MIN_WEIGHT) {
+				controlPoint->m_jointWeightPairs.emplace_back((unsigned int)jointIdx, (float)mesh.m_weights(ctrlPointIdx, jointIdx));
+			}
+		}
+		meshAsset->m_controlPointsRestPose.push_back(controlPoint);
+		if (ctrlPointIdx == 0) {
+			meshAsset->m_boundingBox.m_mins = position;
+			meshAsset->m_boundingBox.m_maxs = position;
+		}
+		else {
+			meshAsset->m_boundingBox.StretchToIncludePoint(position);
+		}
+	}
+	meshAsset->m_weightsMatrix = GetDDMSkinWeights(meshAsset->m_controlPointsRestPose, numJoints, false);
+	meshAsset->m_rigidWeightsMatrix = GetDDMSkinWeights(meshAsset->m_controlPointsRestPose, numJoints, true);
+	meshAsset->m_diffuseTexturePaths.push_back("Data/Images/SyntheticTube_Diffuse.png");
+	meshAsset->m_normalTexturePaths.push_back("Data/Images/SyntheticTube_Normal.png");
+
+	std::vector<Vertex_FBX> polygonVertices;
+	std::vector<int> polygonVertexControlPointIndices;
+	GetSyntheticPolygonVertices(mesh, polygonVertices, polygonVertexControlPointIndices);
+	std::vector<unsigned int> firstPolygonVertexIndices;
+	DeduplicateFBXVertices(&jobSystem, polygonVertices, 65536, meshAsset->m_renderIndices, firstPolygonVertexIndices);
+	out_renderVertices.resize(firstPolygonVertexIndices.size());
+	meshAsset->m_renderVertexToControlPointMap.resize(firstPolygonVertexIndices.size());
+	for (int renderVertexIdx = 0; renderVertexIdx < (int)firstPolygonVertexIndices.size(); renderVertexIdx++) {
+		out_renderVertices[renderVertexIdx] = polygonVertices[firstPolygonVertexIndices[renderVertexIdx]];
+		meshAsset->m_renderVertexToControlPointMap[renderVertexIdx] = (unsigned int)polygonVertexControlPointIndices[firstPolygonVertexIndices[renderVertexIdx]];
+	}
+	return meshAsset;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "Engine/Fbx/FBXDDMBakerSolver.hpp"
+#include "Engine/Fbx/FBXDDMHeadlessBenchmark.hpp"
+#include "Engine/Fbx/FBXDDMKernelsCPU.hpp"
+#include "Engine/Fbx/FBXDDMModifier.hpp"
+#include "Engine/Fbx/FBXDDMModifierCPU.hpp"
+#include "Engine/Fbx/FBXDDMVertexWriteback.hpp"
+#include "Engine/Fbx/FBXMeshAsset.hpp"
+#include "Engine/Fbx/FBXSkeleton.hpp"
+#include "Engine/Fbx/Vertex_FBX.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Quaternion.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Math/Vec4.hpp"
+#include <Eigen/Dense>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JobSystem;
+class RandomNumberGenerator;
+
+//The synthetic meshes, skeletons and models the FBX benchmarks and tests run on, so none of them needs an FBX file, the SDK or a renderer.
+//The timing benchmarks are in FBXDDMBenchmarks, the correctness tests of a module in <module>Tests next to it
+
+void PrintBenchmarkLine(const std::string& line);
+const char* GetBenchmarkCheckString(bool hasPassed);	//PASSED or FAILED
+
+//Prints one PASSED or FAILED line per check of a test and remembers whether all of them passed
+struct BenchmarkCheckList {
+public:
+	void Check(const char* checkName, bool hasCheckPassed);
+
+public:
+	bool m_hasPassed = true;
+};
+
+//The helix the CPU kernel benchmarks and the precompute cache test deform: rest positions and the neighborhoods the omegas are built from, no faces
+struct SyntheticDDMMesh {
+	int m_numJoints = 0;
+	Eigen::MatrixX3d m_restPositions;
+	std::vector<double> m_neighborhoods;	//10 floats per control point, the average u_k * u_k^T over a small neighborhood around it
+};
+
+std::vector<Mat44> GetSyntheticJointTransforms(int numJoints, RandomNumberGenerator& rng);
+//Consecutive control points sit next to each other on the helix, like they mostly do in an FBX mesh, so a packet's lanes share their joints.
+//A single u_k would make Q_i - q_i * p_i^T vanish, so the neighborhood is what keeps the polar decomposition well defined
+SyntheticDDMMesh GetSyntheticMesh(int numControlPoints, int numJoints, RandomNumberGenerator& rng);
+//Same two passes as FBXDDMModifier::Precompute, over the first numControlPoints control points of the mesh
+void BuildSyntheticOmegas(const SyntheticDDMMesh& mesh, int numControlPoints, double omegaEpsilon, DDMSparseOmegas& outOmegas);
+//The tube DDMPrecomputeBenchmark has always used: 32 segments per ring
+DDMSyntheticSkinnedMesh GetSyntheticSkinnedMesh(int numControlPoints, int numJoints);
+
+template <typename T>
+bool AreVectorsBitIdentical(const std::vector<T>& a, const std::vector<T>& b)
+{
+	return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+//The joint chain of a synthetic mesh the way FBXDDMBakingJob flattens an FBXModel: each joint sits at its height on the y axis, and the root at the origin
+DDMBakerSkeleton GetSyntheticBakerSkeleton(const DDMSyntheticSkinnedMesh& mesh);
+void ComputeDDMv0Positions(JobSystem& jobSystem, const DDMControlPointPackets& packets, const std::vector<Mat44>& allJointSkinningMatrices, Eigen::MatrixX3f& outPositions);
+//Render vertices in the order ProcessFbxMesh makes them: corner by corner over the faces, a new one for every control point and UV island pair not seen yet.
+//The faces alternate between two islands in bands, so the control points along the band borders get two render vertices
+void GetSyntheticRenderVertexMap(const Eigen::MatrixX3i& faces, int numFacesPerIsland, std::vector<unsigned int>& outRenderVertexToControlPointMap);
+bool AreRenderVerticesBitIdentical(const std::vector<Vertex_FBX>& a, const std::vector<Vertex_FBX>& b);
+//Vertex_FBX the way FBXMesh::SetRigidBinding fills them, from the 8 largest weights of every control point normalized again. The tube runs along y, so the normals point away from it
+void GetSyntheticSkinnedRenderVertices(const DDMSyntheticSkinnedMesh& mesh, std::vector<Vertex_FBX>& outVertices);
+//Triangle corners the way ProcessFbxMesh reads them, with UV seams like RunDDMVertexWritebackTest and a -0 in the normal of every other face
+void GetSyntheticPolygonVertices(const DDMSyntheticSkinnedMesh& mesh, std::vector<Vertex_FBX>& outPolygonVertices, std::vector<int>& outPolygonVertexControlPointIndices);
+
+//Stands in for FBXJoint, whose walk looks every joint up through its FBXModel, which needs a renderer: its transforms on the heap next to everything else a joint carries,
+//children behind pointers. Only as faithful as its layout: m_otherJointData is a guess at FBXJoint's name, render data, IK socket and DOF settings, not its size,
+//and the joints come from new one after the other, so they sit closer together than joints FBXParser allocates between the rest of a parse
+struct BenchmarkTreeJoint {
+	BenchmarkTreeJoint* m_parentJoint = nullptr;
+	std::vector<BenchmarkTreeJoint*> m_childJoints;
+	uint8_t m_otherJointData[512] = {};	//Name, render data, IK socket and DOF settings
+	Mat44 m_globalTransformForThisFrame;
+	Mat44 m_globalBindPoseInverse;
+	Vec3 m_localDeltaTranslate;
+	Quaternion m_localDeltaRotate;
+	bool m_isRoot = false;
+	bool m_isTranslationModified = false;
+	bool m_isRotationModified = false;
+};
+
+Quaternion GetRandomBenchmarkRotation(RandomNumberGenerator& rng, float maxDegrees);
+
+//Stands in for FBXPose, which needs the fbx sdk
+struct BenchmarkPose {
+	std::vector<Vec4> m_localScalings;
+	std::vector<Quaternion> m_localQuats;
+	std::vector<Vec4> m_localLocs;
+};
+
+//A model of what FBXModel::CreateCopy makes for every copy, not an FBXModel, which needs the fbx sdk and a renderer: its joints, skeleton, current pose and render vertices,
+//next to the mesh asset and the pose sequence. A deep copy owns the last two, a shared one points at the source's
+struct BenchmarkModelInstance {
+	~BenchmarkModelInstance()
+	{
+		for (BenchmarkTreeJoint* joint : m_joints) {
+			delete joint;
+		}
+	}
+
+	std::shared_ptr<const FBXMeshAsset> m_meshAsset;	//Read only like FBXMesh's
+	std::shared_ptr<const std::vector<BenchmarkPose>> m_poseSequence;
+	std::vector<Vertex_FBX> m_renderVertices;
+	std::vector<BenchmarkTreeJoint*> m_joints;
+	FBXSkeleton m_skeleton;
+	BenchmarkPose m_poseForThisFrame;
+
+	//FBXMesh's DDM part: the modifiers of both bindings, shared like the mesh asset, and what this instance deforms with them on its own
+	std::shared_ptr<FBXDDMModifierCPU> m_ddmModifierCPU;
+	std::shared_ptr<FBXDDMModifierCPU> m_rigidDDMModifierCPU;
+	bool m_isRigidBinding = false;
+	DDMModifierInstanceState m_ddmInstanceStateCPU;
+	DDMRenderVertexWriteback m_ddmRenderVertexWriteback;
+};
+
+//Follows FBXModel::CreateCopy: the joints copied and linked again, then the meshes and the animation manager, then Startup's skeleton.
+//Leaves out what needs a renderer or FBXJoint: the joint gizmos, the GPU buffers InstantiateGPUData and RestoreGPUVerticesToRestPose make and fill,
+//and the child joint lookup by stencil ref, which is a linear search per child where this indexes the skeleton's parent indices
+BenchmarkModelInstance* CreateBenchmarkModelCopy(const BenchmarkModelInstance& source, bool isDeepCopy);
+//The tube as ProcessFbxMesh reads it: the control points with their joint weight pairs, both weights matrices and the deduplicated render vertices
+std::shared_ptr<FBXMeshAsset> GetSyntheticFBXMeshAsset(JobSystem& jobSystem, const DDMSyntheticSkinnedMesh& mesh, int numJoints, std::vector<Vertex_FBX>& out_renderVertices);
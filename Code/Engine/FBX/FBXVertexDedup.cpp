@@ -0,0 +1,170 @@
+#include "Engine/Fbx/FBXVertexDedup.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+bool AreFBXVerticesEquivalent(const Vertex_FBX& a, const Vertex_FBX& b)
+{
+	return a.m_position == b.m_position && a.m_normal == b.m_normal && a.m_tangent == b.m_tangent && !(a.m_color != b.m_color) && a.m_uvTexCoords == b.m_uvTexCoords
+		&& a.m_jointIndices1 == b.m_jointIndices1 && a.m_jointIndices2 == b.m_jointIndices2 && a.m_jointWeights1 == b.m_jointWeights1 && a.m_jointWeights2 == b.m_jointWeights2
+		&& a.m_materialIdx == b.m_materialIdx;
+}
+
+class FBXVertexHasher {
+public:
+	void AppendFloat(float value)
+	{
+		uint32_t word = 0;	//-0 == 0, so both have to hash the same
+		if (value != 0.0f) {
+			memcpy(&word, &value, sizeof(word));
+		}
+		AppendWord(word);
+	}
+
+	void AppendWord(uint32_t word) { m_hash = (m_hash ^ word) * FNV_PRIME; }
+
+	unsigned int GetHash() const
+	{
+		//FNV leaves the low bits weak, and the table masks them off
+		uint32_t hash = m_hash;
+		hash ^= hash >> 16;
+		hash *= 0x85ebca6bu;
+		hash ^= hash >> 13;
+		hash *= 0xc2b2ae35u;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+private:
+	static constexpr uint32_t FNV_PRIME = 16777619u;
+	uint32_t m_hash = 2166136261u;
+};
+
+unsigned int GetFBXVertexHash(const Vertex_FBX& vertex)
+{
+	FBXVertexHasher hasher;
+	const Vec3* vec3s[] = { &vertex.m_position, &vertex.m_normal, &vertex.m_tangent };
+	for (const Vec3* vec3 : vec3s) {
+		hasher.AppendFloat(vec3->x);
+		hasher.AppendFloat(vec3->y);
+		hasher.AppendFloat(vec3->z);
+	}
+	hasher.AppendWord(((uint32_t)vertex.m_color.r << 24) | ((uint32_t)vertex.m_color.g << 16) | ((uint32_t)vertex.m_color.b << 8) | (uint32_t)vertex.m_color.a);
+	hasher.AppendFloat(vertex.m_uvTexCoords.x);
+	hasher.AppendFloat(vertex.m_uvTexCoords.y);
+	const IntVec4* jointIndices[] = { &vertex.m_jointIndices1, &vertex.m_jointIndices2 };
+	for (const IntVec4* indices : jointIndices) {
+		hasher.AppendWord((uint32_t)indices->x);
+		hasher.AppendWord((uint32_t)indices->y);
+		hasher.AppendWord((uint32_t)indices->z);
+		hasher.AppendWord((uint32_t)indices->w);
+	}
+	const Vec4* jointWeights[] = { &vertex.m_jointWeights1, &vertex.m_jointWeights2 };
+	for (const Vec4* weights : jointWeights) {
+		hasher.AppendFloat(weights->x);
+		hasher.AppendFloat(weights->y);
+		hasher.AppendFloat(weights->z);
+		hasher.AppendFloat(weights->w);
+	}
+	hasher.AppendWord((uint32_t)vertex.m_materialIdx);
+	return hasher.GetHash();
+}
+
+void FBXVertexHashTable::Reset(int maxNumVertices)
+{
+	//At most half full, so probe sequences stay short
+	unsigned int numSlots = 16;
+	while (numSlots < 2u * (unsigned int)std::max(maxNumVertices, 1)) {
+		numSlots *= 2;
+	}
+	m_slotMask = numSlots - 1;
+	m_slotVertexIndices.assign(numSlots, EMPTY_SLOT);
+	m_slotHashes.assign(numSlots, 0);
+}
+
+unsigned int FBXVertexHashTable::FindOrInsert(const std::vector<Vertex_FBX>& vertices, unsigned int vertexIdx, unsigned int hash)
+{
+	for (unsigned int slotIdx = hash & m_slotMask;; slotIdx = (slotIdx + 1) & m_slotMask) {
+		unsigned int slotVertexIdx = m_slotVertexIndices[slotIdx];
+		if (slotVertexIdx == EMPTY_SLOT) {
+			m_slotVertexIndices[slotIdx] = vertexIdx;
+			m_slotHashes[slotIdx] = hash;
+			return vertexIdx;
+		}
+		if (m_slotHashes[slotIdx] == hash && AreFBXVerticesEquivalent(vertices[slotVertexIdx], vertices[vertexIdx])) {
+			return slotVertexIdx;
+		}
+	}
+}
+
+void DeduplicateFBXVertices(JobSystem* jobSystem, const std::vector<Vertex_FBX>& polygonVertices, int chunkSize, std::vector<unsigned int>& outIndices,
+	std::vector<unsigned int>& outFirstPolygonVertexIndices)
+{
+	GUARANTEE_OR_DIE(chunkSize > 0, "chunkSize <= 0");
+	int numPolygonVertices = (int)polygonVertices.size();
+	int numChunks = (numPolygonVertices + chunkSize - 1) / chunkSize;
+	std::vector<unsigned int> hashes(numPolygonVertices);
+	outIndices.resize(numPolygonVertices);
+	std::vector<std::vector<unsigned int>> chunkFirstPolygonVertexIndices(numChunks);
+
+	//Every corner points at the first equivalent corner of its chunk, and every chunk lists those first corners in order
+	auto deduplicateChunks = [&](int beginChunkIdx, int endChunkIdx) {
+		FBXVertexHashTable chunkTable;
+		for (int chunkIdx = beginChunkIdx; chunkIdx < endChunkIdx; chunkIdx++) {
+			int beginIdx = chunkIdx * chunkSize;
+			int endIdx = std::min(beginIdx + chunkSize, numPolygonVertices);
+			chunkTable.Reset(endIdx - beginIdx);
+			for (int polygonVertexIdx = beginIdx; polygonVertexIdx < endIdx; polygonVertexIdx++) {
+				hashes[polygonVertexIdx] = GetFBXVertexHash(polygonVertices[polygonVertexIdx]);
+				unsigned int firstIdx = chunkTable.FindOrInsert(polygonVertices, (unsigned int)polygonVertexIdx, hashes[polygonVertexIdx]);
+				if (firstIdx == (unsigned int)polygonVertexIdx) {
+					chunkFirstPolygonVertexIndices[chunkIdx].push_back(firstIdx);
+				}
+				outIndices[polygonVertexIdx] = firstIdx;
+			}
+		}
+	};
+	if (jobSystem) {
+		jobSystem->ParallelForRange(0, numChunks, 1, deduplicateChunks);
+	}
+	else {
+		deduplicateChunks(0, numChunks);
+	}
+
+	//Merging the chunks in order numbers the render vertices in order of first appearance, like one serial pass would
+	int maxNumRenderVertices = 0;
+	for (const std::vector<unsigned int>& firstIndices : chunkFirstPolygonVertexIndices) {
+		maxNumRenderVertices += (int)firstIndices.size();
+	}
+	FBXVertexHashTable mergeTable;
+	mergeTable.Reset(maxNumRenderVertices);
+	outFirstPolygonVertexIndices.clear();
+	outFirstPolygonVertexIndices.reserve(maxNumRenderVertices);
+	std::vector<unsigned int> renderVertexIndices(numPolygonVertices);	//Only filled for the first corners of the chunks
+	for (const std::vector<unsigned int>& firstIndices : chunkFirstPolygonVertexIndices) {
+		for (unsigned int polygonVertexIdx : firstIndices) {
+			unsigned int firstIdx = mergeTable.FindOrInsert(polygonVertices, polygonVertexIdx, hashes[polygonVertexIdx]);
+			if (firstIdx == polygonVertexIdx) {
+				renderVertexIndices[polygonVertexIdx] = (unsigned int)outFirstPolygonVertexIndices.size();
+				outFirstPolygonVertexIndices.push_back(polygonVertexIdx);
+			}
+			else {
+				renderVertexIndices[polygonVertexIdx] = renderVertexIndices[firstIdx];
+			}
+		}
+	}
+
+	auto remapIndices = [&](int beginIdx, int endIdx) {
+		for (int polygonVertexIdx = beginIdx; polygonVertexIdx < endIdx; polygonVertexIdx++) {
+			outIndices[polygonVertexIdx] = renderVertexIndices[outIndices[polygonVertexIdx]];
+		}
+	};
+	if (jobSystem) {
+		jobSystem->ParallelForRange(0, numPolygonVertices, chunkSize, remapIndices);
+	}
+	else {
+		remapIndices(0, numPolygonVertices);
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Engine/Fbx/Vertex_FBX.hpp"
+#include <vector>
+
+class JobSystem;
+
+//Render vertex deduplication for FBXMesh::ProcessFbxMesh. Two vertices are the same exactly when std::map<Vertex_FBX, unsigned int> treated them as the same key:
+//every attribute compares equal with ==, except m_binormal which Vertex_FBX::operator< never looked at. So 0 and -0 are the same, and nothing gets snapped to a grid
+bool AreFBXVerticesEquivalent(const Vertex_FBX& a, const Vertex_FBX& b);
+unsigned int GetFBXVertexHash(const Vertex_FBX& vertex);	//Over the bits AreFBXVerticesEquivalent compares, with -0 folded into 0 first
+
+//Open addressing with linear probing. Slots only hold the index of a vertex and its hash, the vertices themselves stay in the caller's array.
+//Sized once for the most vertices it will ever hold and never grows
+class FBXVertexHashTable {
+public:
+	void Reset(int maxNumVertices);
+
+	//Index of the vertex inserted before that is equivalent to vertices[vertexIdx], or vertexIdx itself after inserting it
+	unsigned int FindOrInsert(const std::vector<Vertex_FBX>& vertices, unsigned int vertexIdx, unsigned int hash);
+
+private:
+	static constexpr unsigned int EMPTY_SLOT = 0xFFFFFFFFu;
+
+	unsigned int m_slotMask = 0;
+	std::vector<unsigned int> m_slotVertexIndices;
+	std::vector<unsigned int> m_slotHashes;	//Compared before the vertices, so a probe rarely touches a vertex that is not a match
+};
+
+//polygonVertices: one vertex per triangle corner, in the order ProcessFbxMesh reads them. Gives the same result as inserting them one by one into the std::map:
+//outIndices[i] is the render vertex of corner i, and render vertex k is polygonVertices[outFirstPolygonVertexIndices[k]], numbered in order of first appearance.
+//Chunks of chunkSize corners are deduplicated in parallel, then merged in chunk order so the first appearances stay in order. jobSystem can be nullptr
+void DeduplicateFBXVertices(JobSystem* jobSystem, const std::vector<Vertex_FBX>& polygonVertices, int chunkSize, std::vector<unsigned int>& outIndices,
+	std::vector<unsigned int>& outFirstPolygonVertexIndices);
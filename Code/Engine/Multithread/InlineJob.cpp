@@ -0,0 +1,83 @@
+#include "Engine/Multithread/InlineJob.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+JobPool::~JobPool()
+{
+	Shutdown();
+}
+
+void JobPool::Startup(int numJobs)
+{
+	GUARANTEE_OR_DIE(m_jobs == nullptr, "JobPool::Startup() called twice");
+	GUARANTEE_OR_DIE(numJobs >= 0, "numJobs < 0");
+
+	m_numJobs = numJobs;
+	if (numJobs == 0) {
+		return;
+	}
+
+	m_jobs = new InlineJob[numJobs];
+	m_nextFreeJobIdx = new std::atomic<uint32_t>[numJobs];
+	for (int jobIdx = 0; jobIdx < numJobs; jobIdx++) {
+		m_nextFreeJobIdx[jobIdx] = (jobIdx + 1 < numJobs) ? (uint32_t)(jobIdx + 1) : INVALID_JOB_IDX;
+	}
+	m_freeListHead = PackHead(0, 0);
+}
+
+void JobPool::Shutdown()
+{
+	delete[] m_jobs;
+	m_jobs = nullptr;
+	delete[] m_nextFreeJobIdx;
+	m_nextFreeJobIdx = nullptr;
+	m_freeListHead = PackHead(0, INVALID_JOB_IDX);
+	m_numJobs = 0;
+}
+
+InlineJob* JobPool::AcquireJob()
+{
+	uint64_t head = m_freeListHead.load(std::memory_order_acquire);
+	while (true) {
+		uint32_t jobIdx = (uint32_t)head;
+		if (jobIdx == INVALID_JOB_IDX) {
+			return nullptr;
+		}
+		uint32_t nextJobIdx = m_nextFreeJobIdx[jobIdx].load(std::memory_order_relaxed);
+		uint64_t newHead = PackHead((uint32_t)(head >> 32) + 1, nextJobIdx);
+		if (m_freeListHead.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+			return &m_jobs[jobIdx];
+		}
+	}
+}
+
+void JobPool::ReleaseJob(InlineJob* job)
+{
+	GUARANTEE_OR_DIE(OwnsJob(job), "Releasing a job that doesn't belong to this JobPool");
+	uint32_t jobIdx = (uint32_t)(job - m_jobs);
+
+	uint64_t head = m_freeListHead.load(std::memory_order_relaxed);
+	while (true) {
+		m_nextFreeJobIdx[jobIdx].store((uint32_t)head, std::memory_order_relaxed);
+		uint64_t newHead = PackHead((uint32_t)(head >> 32) + 1, jobIdx);
+		if (m_freeListHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+bool JobPool::OwnsJob(const Job* job) const
+{
+	if (m_jobs == nullptr) {
+		return false;
+	}
+	//Address check only: job might not be an InlineJob at all
+	const unsigned char* jobAddress = reinterpret_cast<const unsigned char*>(job);
+	const unsigned char* poolBegin = reinterpret_cast<const unsigned char*>(m_jobs);
+	const unsigned char* poolEnd = reinterpret_cast<const unsigned char*>(m_jobs + m_numJobs);
+	return (jobAddress >= poolBegin) && (jobAddress < poolEnd);
+}
+
+int JobPool::GetNumJobs() const
+{
+	return m_numJobs;
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+#include "Engine/Multithread/Job.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+//Job that stores a callable (usually a lambda) in place, so posting one needs no heap allocation when it comes from the JobPool
+class InlineJob : public Job {
+	friend class JobSystem;
+	friend class JobPool;
+public:
+	static constexpr size_t MAX_CALLABLE_SIZE = 64;	//Capture pointers/references to big data instead of copying it
+
+	InlineJob() { m_isOwnedByJobSystem = true; };
+	~InlineJob() { DestroyCallable(); };
+
+	template<typename Func>
+	void SetCallable(Func&& func);
+
+	void Execute() override { m_invokeCallable(m_callableStorage); };
+	void OnComplete() override {};
+
+private:
+	void DestroyCallable();
+
+private:
+	alignas(std::max_align_t) unsigned char m_callableStorage[MAX_CALLABLE_SIZE];
+	void (*m_invokeCallable)(void* callable) = nullptr;
+	void (*m_destroyCallable)(void* callable) = nullptr;
+};
+
+template<typename Func>
+void InlineJob::SetCallable(Func&& func)
+{
+	using Callable = std::decay_t<Func>;
+	static_assert(sizeof(Callable) <= MAX_CALLABLE_SIZE, "Callable is too big to be stored in an InlineJob. Capture less, or capture by reference");
+	static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for an InlineJob");
+
+	DestroyCallable();
+	new (m_callableStorage) Callable(std::forward<Func>(func));
+	m_invokeCallable = [](void* callable) { (*static_cast<Callable*>(callable))(); };
+	m_destroyCallable = [](void* callable) { static_cast<Callable*>(callable)->~Callable(); };
+}
+
+inline void InlineJob::DestroyCallable()
+{
+	if (m_destroyCallable) {
+		m_destroyCallable(m_callableStorage);
+		m_destroyCallable = nullptr;
+		m_invokeCallable = nullptr;
+	}
+}
+
+//Fixed number of InlineJobs allocated once. Free slots form a lock-free stack (Treiber stack); the head carries a tag that changes on
+//every update so a slot that was popped and pushed back in between can't fool a compare-exchange (ABA)
+class JobPool {
+public:
+	JobPool() = default;
+	~JobPool();
+	JobPool(const JobPool& copyFrom) = delete;
+
+	void Startup(int numJobs);
+	void Shutdown();
+
+	InlineJob* AcquireJob();	//nullptr if every slot is in use
+	void ReleaseJob(InlineJob* job);
+	bool OwnsJob(const Job* job) const;
+
+	int GetNumJobs() const;
+
+private:
+	static uint64_t PackHead(uint32_t tag, uint32_t jobIdx) { return ((uint64_t)tag << 32) | jobIdx; };
+
+private:
+	static constexpr uint32_t INVALID_JOB_IDX = 0xFFFFFFFF;
+
+	InlineJob* m_jobs = nullptr;
+	std::atomic<uint32_t>* m_nextFreeJobIdx = nullptr;
+	std::atomic<uint64_t> m_freeListHead = PackHead(0, INVALID_JOB_IDX);
+	int m_numJobs = 0;
+};
\ No newline at end of file
@@ -1,8 +1,77 @@
 #pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Decides which worker threads may run a job. Workers look at the categories in this order
+enum class JobCategory
+{
+	FRAME_CRITICAL,	//Has to finish within the current frame (deformation, skinning, ...)
+	BACKGROUND,		//Long running work that may span many frames (baking, precompute, ...)
+	IO,				//Mostly waiting on the disk or the network
+	COUNT
+};
+
+//Order within a category. Jobs that wait long enough get treated as higher priority (aging), see JobSystemConfig::m_agingIntervalSeconds
+enum class JobPriority
+{
+	HIGH,
+	NORMAL,
+	LOW,
+	COUNT
+};
 
 class Job {
+	friend class JobSystem;
 public:
 	virtual ~Job() = default;
 	virtual void Execute() = 0;	//Client code has to implement this function
 	virtual void OnComplete() = 0;	//Client code has to implement this function
-};
\ No newline at end of file
+
+	void SetCategory(JobCategory category);	//Has to be set before the job is posted
+	void SetPriority(JobPriority priority);	//Has to be set before the job is posted
+	JobCategory GetCategory() const { return m_category; };
+	JobPriority GetPriority() const { return m_priority; };
+
+protected:
+	bool m_isOwnedByJobSystem = false;	//Internal jobs (e.g. ParallelFor helpers) are deleted by the job system after they ran
+
+private:
+	void ResetForReuse();	//Pooled jobs get recycled instead of deleted
+
+private:
+	std::shared_ptr<std::atomic<int>> m_numPendingJobsOfHandle;	//Decremented once the job has fully finished
+
+	//Dependency graph. Starts at 1 for "not posted yet", +1 per unfinished prerequisite. Whoever brings it to 0 queues the job
+	std::atomic<int> m_numPendingPrerequisites = 1;
+	std::vector<Job*> m_continuations;	//Jobs waiting on this one
+	std::mutex m_continuationsMutex;
+	bool m_hasFinished = false;	//Guarded by m_continuationsMutex
+	bool m_hasBeenPosted = false;
+
+	JobCategory m_category = JobCategory::FRAME_CRITICAL;
+	JobPriority m_priority = JobPriority::NORMAL;
+	double m_queuedTimeSeconds = 0.0;	//For aging
+};
+
+inline void Job::SetCategory(JobCategory category)
+{
+	m_category = category;
+}
+
+inline void Job::SetPriority(JobPriority priority)
+{
+	m_priority = priority;
+}
+
+inline void Job::ResetForReuse()
+{
+	m_numPendingJobsOfHandle = nullptr;
+	m_numPendingPrerequisites = 1;
+	m_continuations.clear();
+	m_hasFinished = false;
+	m_hasBeenPosted = false;
+	m_category = JobCategory::FRAME_CRITICAL;
+	m_priority = JobPriority::NORMAL;
+}
\ No newline at end of file
@@ -1,10 +1,62 @@
 #include "Engine/Multithread/JobSystem.hpp"
 #include "Engine/Multithread/Job.hpp"
+#include "Engine/Multithread/JobSystemBenchmarks.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
+#include <algorithm>
+#include <memory>
+#include <typeinfo>
+
+//Note that this #include is an exception to the rule "engine code doesn't know about game code", see AudioSystem.cpp.
+//Define ENGINE_ENABLE_JOB_TIMING there to compile in the job timing capture, and ENGINE_ENABLE_BENCHMARK_COMMANDS to register the benchmark commands
+#include "Game/EngineBuildPreferences.hpp"
 
 JobSystem* g_theJobSystem = nullptr;
 
+//Category and priority of the job the calling thread is executing right now. ParallelFor helpers inherit them
+static thread_local JobCategory s_categoryOfExecutingJob = JobCategory::FRAME_CRITICAL;
+static thread_local JobPriority s_priorityOfExecutingJob = JobPriority::NORMAL;
+
+static unsigned int GetCategoryBit(JobCategory category)
+{
+	return 1u << (int)category;
+}
+
+//Shared between the thread calling ParallelFor and its helper jobs. Chunks are handed out through m_nextChunkIdx, so a helper job that only gets
+//to run after the loop is already finished finds no chunk left and never touches m_rangeFunc (which lives on the caller's stack)
+struct ParallelForState {
+	const std::function<void(int, int)>* m_rangeFunc = nullptr;
+	int m_begin = 0;
+	int m_end = 0;
+	int m_chunkSize = 1;
+	int m_numChunks = 0;
+	std::atomic<int> m_nextChunkIdx = 0;
+	std::atomic<int> m_numCompletedChunks = 0;
+};
+
+JobHandle::JobHandle(const std::shared_ptr<std::atomic<int>>& numPendingJobs) : m_numPendingJobs(numPendingJobs)
+{
+}
+
+bool JobHandle::IsValid() const
+{
+	return m_numPendingJobs != nullptr;
+}
+
+bool JobHandle::IsCompleted() const
+{
+	return GetNumPendingJobs() == 0;
+}
+
+int JobHandle::GetNumPendingJobs() const
+{
+	if (m_numPendingJobs == nullptr) {
+		return 0;
+	}
+	return *m_numPendingJobs;
+}
+
 JobSystem::JobSystem(const JobSystemConfig& config):m_config(config)
 {
 }
@@ -22,22 +74,63 @@ void JobSystem::Startup()
 		numWorkers = m_numCpuCores - 1;	//-1 because you have to exclude the main thread
 	}
 
+	int numReservedWorkers = std::min(m_config.m_numReservedFrameCriticalWorkers, numWorkers - 1);	//At least one worker has to be left for the other categories
+	numReservedWorkers = std::max(numReservedWorkers, 0);
+	int numIOWorkers = std::max(m_config.m_numIOWorkerThreads, 0);	//Not clamped to the core count, they spend most of their time blocked
+
+	m_isQuitting = false;
+	m_jobPool.Startup(m_config.m_jobPoolSize);
+
 	for (int i = 0; i < numWorkers; i++) {
-		m_jobWorkerThreads.push_back(new JobWorkerThread(i, *this));
+		unsigned int categoryMask = (i < numReservedWorkers) ? GetCategoryBit(JobCategory::FRAME_CRITICAL) : ALL_JOB_CATEGORIES_MASK;
+		m_jobWorkerThreads.push_back(new JobWorkerThread(i, categoryMask, *this));
+	}
+	for (int i = 0; i < numIOWorkers; i++) {
+		m_jobWorkerThreads.push_back(new JobWorkerThread(numWorkers + i, GetCategoryBit(JobCategory::IO), *this));
 	}
 
-	m_isQuitting = false;
+	//Other threads always help with FRAME_CRITICAL jobs, and with whatever no worker runs (everything if there are no workers at all)
+	m_categoryMaskOfOtherThreads = GetCategoryBit(JobCategory::FRAME_CRITICAL);
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		int numWorkersForCategory = GetNumWorkerThreadsForCategory((JobCategory)categoryIdx);
+		m_isCategoryRunByAllWorkers[categoryIdx] = (numWorkersForCategory == (int)m_jobWorkerThreads.size());
+		if (numWorkersForCategory == 0) {
+			m_categoryMaskOfOtherThreads |= GetCategoryBit((JobCategory)categoryIdx);
+		}
+	}
+	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
+		workerThread->Start();
+	}
+
+#if defined(ENGINE_ENABLE_BENCHMARK_COMMANDS)
+	if (this == g_theJobSystem && g_theEventSystem) {
+		RegisterJobSystemBenchmarkCommands();
+	}
+#endif
 }
 
 void JobSystem::Shutdown()
 {
 	m_isQuitting = true;
 
+	m_sleepingWorkersMutex.lock();
 	m_areThereUnclaimedJobsCV.notify_all();
+	m_sleepingWorkersMutex.unlock();
 
 	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
 		if (workerThread) {
 			workerThread->Join();
+		}
+	}
+
+	//Jobs that never ran are dropped. Only the ones owned by the job system are deleted here, the rest still belong to whoever posted them
+	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
+		if (workerThread) {
+			while (Job* job = workerThread->StealLocalJob()) {
+				if (job->m_isOwnedByJobSystem) {
+					RecycleOwnedJob(job);
+				}
+			}
 			delete workerThread;
 		}
 	}
@@ -45,86 +138,474 @@ void JobSystem::Shutdown()
 	m_jobWorkerThreads.clear();
 
 	m_unclaimedJobsMutex.lock();
-	while (!m_unclaimedJobs.empty()) {
-		Job* job = m_unclaimedJobs.front();
-		m_unclaimedJobs.pop_front();
-		delete job;
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		for (int priorityIdx = 0; priorityIdx < (int)JobPriority::COUNT; priorityIdx++) {
+			std::deque<Job*>& unclaimedJobs = m_unclaimedJobs[categoryIdx][priorityIdx];
+			while (!unclaimedJobs.empty()) {
+				Job* job = unclaimedJobs.front();
+				unclaimedJobs.pop_front();
+				if (job->m_isOwnedByJobSystem) {
+					RecycleOwnedJob(job);
+				}
+			}
+		}
+		m_numQueuedJobsPerCategory[categoryIdx] = 0;
 	}
 	m_unclaimedJobsMutex.unlock();
+	m_numQueuedJobs = 0;
+	m_numUnfinishedJobs = 0;
 
-	m_claimedJobsMutex.lock();
-	for (Job* job: m_claimedJobs) {
-		delete job;
-	}
-	m_claimedJobsMutex.unlock();
-
-	m_completedJobsMutex.lock();
-	while (!m_completedJobs.empty()) {
-		Job* job = m_completedJobs.front();
-		m_completedJobs.pop_front();
-		delete job;
-	}
-	m_completedJobsMutex.unlock();
+	m_jobPool.Shutdown();
 }
 
-Job* JobSystem::GetCompletedJob()
+bool JobSystem::IsQuitting() const
 {
-	Job* completedJob = nullptr;
-	m_completedJobsMutex.lock();
-	if (!m_completedJobs.empty()) {
-		completedJob = m_completedJobs.front();
-		m_completedJobs.pop_front();
-	}
-	m_completedJobsMutex.unlock();
-	return completedJob;
+	return m_isQuitting;
 }
 
-bool JobSystem::IsQuitting() const
+Job* JobSystem::GetUnclaimedJobFromQueue(JobWorkerThread* workerThread)
 {
-	return m_isQuitting;
+	unsigned int categoryMask = workerThread ? workerThread->m_categoryMask : m_categoryMaskOfOtherThreads;
+	bool runsFrameCriticalJobs = (categoryMask & GetCategoryBit(JobCategory::FRAME_CRITICAL)) != 0;
+	if (!m_config.m_useWorkStealing || workerThread == nullptr || !runsFrameCriticalJobs) {
+		return GetUnclaimedJobFromGlobalQueue(categoryMask, nullptr);
+	}
+
+	//Own queue first, then the shared queues, then other workers' queues. Local queues only ever hold FRAME_CRITICAL jobs
+	Job* jobToDo = workerThread->PopLocalJob();
+	if (jobToDo == nullptr) {
+		jobToDo = GetUnclaimedJobFromGlobalQueue(categoryMask, workerThread);
+	}
+	if (jobToDo == nullptr) {
+		jobToDo = StealUnclaimedJob(workerThread->m_threadID + 1);
+	}
+	return jobToDo;
 }
 
-Job* JobSystem::GetUnclaimedJobFromQueue()
+Job* JobSystem::GetUnclaimedJobFromGlobalQueue(unsigned int categoryMask, JobWorkerThread* workerThreadToRefill)
 {
 	Job* jobToDo = nullptr;
 
 	m_unclaimedJobsMutex.lock();
-	if (!m_unclaimedJobs.empty()) {
-		jobToDo = m_unclaimedJobs.front();
-		m_unclaimedJobs.pop_front();
+
+	//Every queue is FIFO, so only the fronts can be the best pick. Rank = category, then priority, minus one step per aging interval waited (lower runs first)
+	std::deque<Job*>* bestQueue = nullptr;
+	int bestRank = 0;
+	double currentTimeSeconds = 0.0;
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		if ((categoryMask & GetCategoryBit((JobCategory)categoryIdx)) == 0 || m_numQueuedJobsPerCategory[categoryIdx] == 0) {
+			continue;
+		}
+		for (int priorityIdx = 0; priorityIdx < (int)JobPriority::COUNT; priorityIdx++) {
+			std::deque<Job*>& unclaimedJobs = m_unclaimedJobs[categoryIdx][priorityIdx];
+			if (unclaimedJobs.empty()) {
+				continue;
+			}
+			if (bestQueue == nullptr) {
+				bestQueue = &unclaimedJobs;	//Nothing ranks higher than the first non-empty queue unless it waited, so the clock is only read once there is a choice
+				bestRank = categoryIdx * (int)JobPriority::COUNT + priorityIdx;
+				continue;
+			}
+			if (currentTimeSeconds == 0.0) {
+				currentTimeSeconds = GetCurrentTimeSeconds();
+				bestRank -= GetNumAgingSteps(bestQueue->front(), currentTimeSeconds);
+			}
+			int rank = categoryIdx * (int)JobPriority::COUNT + priorityIdx - GetNumAgingSteps(unclaimedJobs.front(), currentTimeSeconds);
+			if (rank < bestRank) {
+				bestQueue = &unclaimedJobs;
+				bestRank = rank;
+			}
+		}
+	}
+
+	if (bestQueue) {
+		jobToDo = bestQueue->front();
+		bestQueue->pop_front();
+
+		//Take a fair share of the remaining jobs along so the next few jobs don't need the global lock. Only FRAME_CRITICAL jobs go to local queues
+		if (workerThreadToRefill && jobToDo->m_category == JobCategory::FRAME_CRITICAL) {
+			size_t fairShare = bestQueue->size() / m_jobWorkerThreads.size();
+			size_t numJobsToGrab = std::min(fairShare, (size_t)MAX_JOBS_GRABBED_FROM_GLOBAL_QUEUE);
+			if (numJobsToGrab > 0) {
+				std::lock_guard<std::mutex> localLock(workerThreadToRefill->m_localJobsMutex);
+				for (size_t i = 0; i < numJobsToGrab; i++) {
+					workerThreadToRefill->m_localJobs.push_back(bestQueue->front());
+					bestQueue->pop_front();
+				}
+			}
+		}
 	}
 	m_unclaimedJobsMutex.unlock();
 
 	return jobToDo;
 }
 
-void JobSystem::PostNewJob(Job* job)
+int JobSystem::GetNumAgingSteps(const Job* job, double currentTimeSeconds) const
+{
+	if (m_config.m_agingIntervalSeconds <= 0.0) {
+		return 0;
+	}
+	return (int)((currentTimeSeconds - job->m_queuedTimeSeconds) / m_config.m_agingIntervalSeconds);
+}
+
+Job* JobSystem::StealUnclaimedJob(int firstVictimThreadID)
+{
+	int numWorkers = (int)m_jobWorkerThreads.size();
+	for (int offset = 0; offset < numWorkers; offset++) {
+		JobWorkerThread* victimThread = m_jobWorkerThreads[(firstVictimThreadID + offset) % numWorkers];
+		Job* stolenJob = victimThread->StealLocalJob();
+		if (stolenJob) {
+			return stolenJob;
+		}
+	}
+	return nullptr;
+}
+
+JobWorkerThread* JobSystem::GetWorkerThreadOfCallingThread() const
+{
+	JobWorkerThread* workerThread = JobWorkerThread::GetWorkerThreadOfCallingThread();
+	if (workerThread && &workerThread->m_jobSystem == this) {
+		return workerThread;
+	}
+	return nullptr;
+}
+
+bool JobSystem::AreThereQueuedJobsForCategories(unsigned int categoryMask) const
+{
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		if ((categoryMask & GetCategoryBit((JobCategory)categoryIdx)) && m_numQueuedJobsPerCategory[categoryIdx] > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::WaitForUnclaimedJobs(unsigned int categoryMask)
+{
+	std::unique_lock<std::mutex> lock(m_sleepingWorkersMutex);
+	m_numSleepingWorkers++;
+	//Should keep waiting if jobSystem is NOT quitting and there are no queued jobs this worker may run
+	m_areThereUnclaimedJobsCV.wait(lock, [this, categoryMask]() {return (IsQuitting() || AreThereQueuedJobsForCategories(categoryMask)); });
+	m_numSleepingWorkers--;
+}
+
+void JobSystem::WakeUpSleepingWorkerThread(JobCategory category)
+{
+	//The queued counts are incremented before this check, so a worker that is about to sleep either sees the new job or is counted here
+	if (m_numSleepingWorkers > 0) {
+		m_sleepingWorkersMutex.lock();
+		m_sleepingWorkersMutex.unlock();
+		if (m_isCategoryRunByAllWorkers[(int)category]) {
+			m_areThereUnclaimedJobsCV.notify_one();
+		}
+		else {
+			m_areThereUnclaimedJobsCV.notify_all();	//notify_one could pick a worker that isn't allowed to run the job
+		}
+	}
+}
+
+void JobSystem::ParallelForRange(int begin, int end, int grainSize, const std::function<void(int, int)>& rangeFunc)
+{
+	int numIndices = end - begin;
+	if (numIndices <= 0) {
+		return;
+	}
+
+	JobCategory category = s_categoryOfExecutingJob;
+	JobPriority priority = s_priorityOfExecutingJob;
+
+	int chunkSize = GetParallelForChunkSize(numIndices, grainSize);
+	int numChunks = (numIndices + chunkSize - 1) / chunkSize;
+	int numWorkers = GetNumWorkerThreadsForCategory(category);
+	if (numChunks == 1 || numWorkers == 0) {
+		rangeFunc(begin, end);
+		return;
+	}
+
+	std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+	state->m_rangeFunc = &rangeFunc;
+	state->m_begin = begin;
+	state->m_end = end;
+	state->m_chunkSize = chunkSize;
+	state->m_numChunks = numChunks;
+
+	//The calling thread works on chunks too, so one helper less is enough to keep everybody busy
+	int numHelperJobs = std::min(numWorkers, numChunks - 1);
+	JobHandle helperJobsHandle;
+	for (int i = 0; i < numHelperJobs; i++) {
+		helperJobsHandle = PostNewInlineJob([state]() { RunParallelForChunks(*state); }, helperJobsHandle, category, priority);
+	}
+
+	RunParallelForChunks(*state);
+	while (state->m_numCompletedChunks < numChunks) {
+		std::this_thread::yield();	//Only waiting on chunks that are already being executed by other threads
+	}
+}
+
+int JobSystem::GetParallelForChunkSize(int numIndices, int grainSize) const
+{
+	int minChunkSize = std::max(grainSize, 1);
+	int numParticipatingThreads = GetNumWorkerThreads() + 1;
+	int targetNumChunks = numParticipatingThreads * PARALLEL_FOR_CHUNKS_PER_THREAD;
+	int adaptiveChunkSize = (numIndices + targetNumChunks - 1) / targetNumChunks;
+	return std::max(minChunkSize, adaptiveChunkSize);
+}
+
+void JobSystem::RunParallelForChunks(ParallelForState& state)
+{
+	while (true) {
+		int chunkIdx = state.m_nextChunkIdx.fetch_add(1);
+		if (chunkIdx >= state.m_numChunks) {
+			return;
+		}
+		int chunkBegin = state.m_begin + chunkIdx * state.m_chunkSize;
+		int chunkEnd = std::min(chunkBegin + state.m_chunkSize, state.m_end);
+		(*state.m_rangeFunc)(chunkBegin, chunkEnd);
+		state.m_numCompletedChunks++;
+	}
+}
+
+JobHandle JobSystem::PostNewJob(Job* job)
 {
 	if (job == nullptr)
 		ERROR_AND_DIE("You cannot post a nullptr as new job");
-	m_unclaimedJobsMutex.lock();
-	m_unclaimedJobs.push_back(job);
-	m_unclaimedJobsMutex.unlock();
-	m_areThereUnclaimedJobsCV.notify_all();
+
+	if (job->m_hasBeenPosted)
+		ERROR_AND_DIE("A job cannot be posted twice");
+
+	std::shared_ptr<std::atomic<int>> numPendingJobs = std::make_shared<std::atomic<int>>(1);
+	job->m_numPendingJobsOfHandle = numPendingJobs;
+	job->m_hasBeenPosted = true;
+
+	JobWorkerThread* workerThread = m_config.m_useWorkStealing ? GetWorkerThreadOfCallingThread() : nullptr;
+	ReleasePrerequisite(job, workerThread);
+	return JobHandle(numPendingJobs);
 }
 
-void JobSystem::WaitUntilAllJobsCompleted()
+JobHandle JobSystem::PostNewJobs(const std::vector<Job*>& jobs)
 {
-	while (true) {
-		bool unclaimedEmpty = false;
-		bool claimedEmpty = false;
+	std::shared_ptr<std::atomic<int>> numPendingJobs = std::make_shared<std::atomic<int>>((int)jobs.size());
+	for (Job* job : jobs) {
+		if (job == nullptr)
+			ERROR_AND_DIE("You cannot post a nullptr as new job");
+		if (job->m_hasBeenPosted)
+			ERROR_AND_DIE("A job cannot be posted twice");
+		job->m_numPendingJobsOfHandle = numPendingJobs;
+		job->m_hasBeenPosted = true;
+	}
+
+	JobWorkerThread* workerThread = m_config.m_useWorkStealing ? GetWorkerThreadOfCallingThread() : nullptr;
+	for (Job* job : jobs) {
+		ReleasePrerequisite(job, workerThread);
+	}
+	return JobHandle(numPendingJobs);
+}
+
+void JobSystem::AddJobDependency(Job* prerequisiteJob, Job* dependentJob)
+{
+	if (prerequisiteJob == nullptr || dependentJob == nullptr)
+		ERROR_AND_DIE("You cannot add a dependency on or to a nullptr job");
+	if (prerequisiteJob == dependentJob)
+		ERROR_AND_DIE("A job cannot depend on itself");
+	if (dependentJob->m_hasBeenPosted)
+		ERROR_AND_DIE("Dependencies have to be added before the dependent job is posted");
+
+#if defined(_DEBUG)
+	if (IsJobReachableThroughContinuations(dependentJob, prerequisiteJob))
+		ERROR_AND_DIE("Adding this job dependency would create a cycle");
+#endif
+
+	std::lock_guard<std::mutex> continuationsLock(prerequisiteJob->m_continuationsMutex);
+	if (prerequisiteJob->m_hasFinished) {
+		return;
+	}
+	dependentJob->m_numPendingPrerequisites++;
+	prerequisiteJob->m_continuations.push_back(dependentJob);
+}
 
-		{
-			std::lock_guard<std::mutex> unclaimedLock(m_unclaimedJobsMutex);
-			std::lock_guard<std::mutex> claimedLock(m_claimedJobsMutex);
-			unclaimedEmpty = m_unclaimedJobs.empty();
-			claimedEmpty = m_claimedJobs.empty();
+#if defined(_DEBUG)
+bool JobSystem::IsJobReachableThroughContinuations(Job* fromJob, Job* targetJob) const
+{
+	//Jobs sitting in a continuation list haven't run yet, so nobody can have deleted them while we walk the graph
+	std::vector<Job*> jobsToVisit = { fromJob };
+	std::set<Job*> visitedJobs;
+	while (!jobsToVisit.empty()) {
+		Job* currentJob = jobsToVisit.back();
+		jobsToVisit.pop_back();
+		if (currentJob == targetJob) {
+			return true;
 		}
+		if (!visitedJobs.insert(currentJob).second) {
+			continue;
+		}
+		std::lock_guard<std::mutex> continuationsLock(currentJob->m_continuationsMutex);
+		jobsToVisit.insert(jobsToVisit.end(), currentJob->m_continuations.begin(), currentJob->m_continuations.end());
+	}
+	return false;
+}
+#endif
+
+void JobSystem::ReleasePrerequisite(Job* job, JobWorkerThread* workerThread)
+{
+	if (--job->m_numPendingPrerequisites == 0) {
+		QueueJob(job, workerThread);
+	}
+}
+
+void JobSystem::ReleaseContinuations(Job* finishedJob)
+{
+	std::vector<Job*> continuations;
+	finishedJob->m_continuationsMutex.lock();
+	finishedJob->m_hasFinished = true;
+	continuations.swap(finishedJob->m_continuations);
+	finishedJob->m_continuationsMutex.unlock();
+
+	//Continuations go to the finishing worker's own queue: they most likely read what this job just wrote
+	JobWorkerThread* workerThread = m_config.m_useWorkStealing ? GetWorkerThreadOfCallingThread() : nullptr;
+	for (Job* continuation : continuations) {
+		ReleasePrerequisite(continuation, workerThread);
+	}
+}
+
+InlineJob* JobSystem::AcquireInlineJob()
+{
+	InlineJob* job = m_jobPool.AcquireJob();
+	if (job == nullptr) {
+		job = new InlineJob();	//Pool exhausted
+	}
+	return job;
+}
+
+JobHandle JobSystem::PostOwnedJob(Job* job, const JobHandle& joinHandle, JobCategory category, JobPriority priority)
+{
+	std::shared_ptr<std::atomic<int>> numPendingJobs = joinHandle.m_numPendingJobs;
+	if (numPendingJobs) {
+		(*numPendingJobs)++;
+	}
+	else {
+		numPendingJobs = std::make_shared<std::atomic<int>>(1);
+	}
+	job->m_numPendingJobsOfHandle = numPendingJobs;
+	job->m_hasBeenPosted = true;
+	job->m_category = category;
+	job->m_priority = priority;
+
+	JobWorkerThread* workerThread = m_config.m_useWorkStealing ? GetWorkerThreadOfCallingThread() : nullptr;
+	ReleasePrerequisite(job, workerThread);
+	return JobHandle(numPendingJobs);
+}
+
+void JobSystem::RecycleOwnedJob(Job* job)
+{
+	if (m_jobPool.OwnsJob(job)) {
+		InlineJob* inlineJob = static_cast<InlineJob*>(job);
+		inlineJob->DestroyCallable();
+		inlineJob->ResetForReuse();
+		m_jobPool.ReleaseJob(inlineJob);
+	}
+	else {
+		delete job;
+	}
+}
 
-		if (unclaimedEmpty && claimedEmpty) {
-			break;
+void JobSystem::QueueJob(Job* job, JobWorkerThread* workerThread)
+{
+	JobCategory category = job->m_category;
+	m_numUnfinishedJobs++;
+
+	//Only FRAME_CRITICAL jobs posted by a worker that runs them stay local. Everything else has to be visible to the workers of its category
+	bool isLocalJob = workerThread && category == JobCategory::FRAME_CRITICAL && (workerThread->m_categoryMask & GetCategoryBit(JobCategory::FRAME_CRITICAL));
+	if (isLocalJob) {
+#if defined(ENGINE_ENABLE_JOB_TIMING)
+		job->m_queuedTimeSeconds = GetCurrentTimeSeconds();	//Only needed for aging on the shared queues otherwise
+#endif
+		workerThread->PushLocalJob(job);
+	}
+	else {
+		job->m_queuedTimeSeconds = GetCurrentTimeSeconds();
+		m_unclaimedJobsMutex.lock();
+		m_unclaimedJobs[(int)category][(int)job->m_priority].push_back(job);
+		m_unclaimedJobsMutex.unlock();
+	}
+	m_numQueuedJobsPerCategory[(int)category]++;
+	m_numQueuedJobs++;
+	WakeUpSleepingWorkerThread(category);
+}
+
+void JobSystem::ExecuteJob(Job* job)
+{
+	//Copy these out first: once the handle's counter drops, the poster may delete the job
+	bool isOwnedByJobSystem = job->m_isOwnedByJobSystem;
+	std::shared_ptr<std::atomic<int>> numPendingJobsOfHandle = std::move(job->m_numPendingJobsOfHandle);
+
+	//Saved and restored because Wait() can run other jobs from inside a job
+	JobCategory categoryOfOuterJob = s_categoryOfExecutingJob;
+	JobPriority priorityOfOuterJob = s_priorityOfExecutingJob;
+	s_categoryOfExecutingJob = job->m_category;
+	s_priorityOfExecutingJob = job->m_priority;
+
+#if defined(ENGINE_ENABLE_JOB_TIMING)
+	bool isCapturingJobTiming = m_isCapturingJobTimings;
+	JobTimingEvent timingEvent;
+	if (isCapturingJobTiming) {
+		timingEvent.m_jobName = typeid(*job).name();
+		timingEvent.m_category = job->m_category;
+		timingEvent.m_queuedTimeSeconds = job->m_queuedTimeSeconds;
+		timingEvent.m_startTimeSeconds = GetCurrentTimeSeconds();
+	}
+#endif
+
+	MarkJobAsClaimed(job);
+	job->Execute();
+	job->OnComplete();
+	ReleaseContinuations(job);	//Before leaving the unfinished count, so WaitUntilAllJobsCompleted never sees the graph as empty in between
+	MarkJobAsCompleted(job);
+
+#if defined(ENGINE_ENABLE_JOB_TIMING)
+	if (isCapturingJobTiming) {
+		timingEvent.m_endTimeSeconds = GetCurrentTimeSeconds();
+		RecordJobTiming(timingEvent, GetWorkerThreadOfCallingThread());
+	}
+#endif
+
+	s_categoryOfExecutingJob = categoryOfOuterJob;
+	s_priorityOfExecutingJob = priorityOfOuterJob;
+
+	if (isOwnedByJobSystem) {
+		RecycleOwnedJob(job);
+	}
+	if (numPendingJobsOfHandle) {
+		(*numPendingJobsOfHandle)--;
+	}
+}
+
+void JobSystem::Wait(const JobHandle& handle)
+{
+	JobWorkerThread* workerThread = GetWorkerThreadOfCallingThread();
+	while (!handle.IsCompleted()) {
+		Job* jobToDo = nullptr;
+		if (workerThread) {
+			jobToDo = GetUnclaimedJobFromQueue(workerThread);
+		}
+		else {
+			jobToDo = GetUnclaimedJobFromGlobalQueue(m_categoryMaskOfOtherThreads, nullptr);
+			if (jobToDo == nullptr && m_config.m_useWorkStealing && !m_jobWorkerThreads.empty()) {
+				jobToDo = StealUnclaimedJob(0);
+			}
+		}
+
+		if (jobToDo) {
+			ExecuteJob(jobToDo);
 		}
+		else {
+			std::this_thread::yield();	//Whatever is left is already running on other threads
+		}
+	}
+}
 
+void JobSystem::WaitUntilAllJobsCompleted()
+{
+	while (m_numUnfinishedJobs > 0) {
 		// Wait or yield the current thread to avoid busy waiting
 		std::this_thread::yield();
 	}
@@ -132,59 +613,115 @@ void JobSystem::WaitUntilAllJobsCompleted()
 
 int JobSystem::GetNumQueuedJobs()
 {
-	m_unclaimedJobsMutex.lock();
-	int numQueuedJobs = (int)m_unclaimedJobs.size();
-	m_unclaimedJobsMutex.unlock();
-	return numQueuedJobs;
+	return m_numQueuedJobs;
 }
 
 int JobSystem::GetNumClaimedJobs()
 {
-	m_claimedJobsMutex.lock();
-	int numClaimedJobs = (int)m_claimedJobs.size();
-	m_claimedJobsMutex.unlock();
-	return numClaimedJobs;
+	return m_numClaimedJobs;
 }
 
-int JobSystem::GetNumCompletedJobs()
+int JobSystem::GetNumCpuCores() const
 {
-	m_completedJobsMutex.lock();
-	int numCompletedJobs = (int)m_completedJobs.size();
-	m_completedJobsMutex.unlock();
-	return numCompletedJobs;
+	return m_numCpuCores;
 }
 
-int JobSystem::GetNumCpuCores() const
+int JobSystem::GetNumWorkerThreads() const
 {
-	return m_numCpuCores;
+	return (int)m_jobWorkerThreads.size();
+}
+
+int JobSystem::GetNumWorkerThreadsForCategory(JobCategory category) const
+{
+	int numWorkers = 0;
+	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
+		if (workerThread->m_categoryMask & GetCategoryBit(category)) {
+			numWorkers++;
+		}
+	}
+	return numWorkers;
 }
 
 void JobSystem::MarkJobAsClaimed(Job* job)
 {
 	if (job == nullptr)
 		ERROR_AND_DIE("You cannot mark a nullptr as claimed job");
-	m_claimedJobsMutex.lock();
-	m_claimedJobs.insert(job);
-	m_claimedJobsMutex.unlock();
+	m_numClaimedJobs++;
+	m_numQueuedJobsPerCategory[(int)job->m_category]--;
+	m_numQueuedJobs--;
 }
 
 void JobSystem::MarkJobAsCompleted(Job* job)
 {
 	if (job == nullptr)
 		ERROR_AND_DIE("You cannot mark a nullptr as completed job");
+	m_numClaimedJobs--;
+	m_numUnfinishedJobs--;
+}
 
-	m_claimedJobsMutex.lock();
-	auto foundJobItr = m_claimedJobs.find(job);
-	if (foundJobItr != m_claimedJobs.end()) {
-		m_claimedJobs.erase(foundJobItr);
+void JobSystem::RecordJobTiming(const JobTimingEvent& event, JobWorkerThread* workerThread)
+{
+	if (workerThread) {
+		JobTimingEvent workerEvent = event;
+		workerEvent.m_threadID = workerThread->m_threadID;
+		workerThread->RecordJobTiming(workerEvent);
 	}
 	else {
-		m_claimedJobsMutex.unlock();
-		ERROR_AND_DIE("Job to be marked complete was not on the claimedJobs list");
+		m_otherThreadsJobTimingEventsMutex.lock();
+		m_otherThreadsJobTimingEvents.push_back(event);
+		m_otherThreadsJobTimingEventsMutex.unlock();
 	}
-	m_claimedJobsMutex.unlock();
+}
 
-	m_completedJobsMutex.lock();
-	m_completedJobs.push_back(job);
-	m_completedJobsMutex.unlock();
-}
\ No newline at end of file
+bool JobSystem::IsJobTimingCompiledIn()
+{
+#if defined(ENGINE_ENABLE_JOB_TIMING)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void JobSystem::StartJobTimingCapture()
+{
+	std::vector<JobTimingEvent> discardedEvents;
+	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
+		workerThread->TakeJobTimingEvents(discardedEvents);
+	}
+	m_otherThreadsJobTimingEventsMutex.lock();
+	m_otherThreadsJobTimingEvents.clear();
+	m_otherThreadsJobTimingEventsMutex.unlock();
+
+	m_jobTimingCaptureStartTimeSeconds = GetCurrentTimeSeconds();
+	m_isCapturingJobTimings = true;
+}
+
+JobTimingCapture JobSystem::StopJobTimingCapture()
+{
+	m_isCapturingJobTimings = false;
+
+	//Jobs that were already running when the capture stopped still get recorded, they show up in the next capture's discarded events
+	JobTimingCapture capture;
+	capture.m_captureStartTimeSeconds = m_jobTimingCaptureStartTimeSeconds;
+	capture.m_captureEndTimeSeconds = GetCurrentTimeSeconds();
+	capture.m_numWorkerThreads = GetNumWorkerThreads();
+	m_otherThreadsJobTimingEventsMutex.lock();
+	capture.m_events.swap(m_otherThreadsJobTimingEvents);
+	m_otherThreadsJobTimingEventsMutex.unlock();
+	for (JobWorkerThread* workerThread : m_jobWorkerThreads) {
+		workerThread->TakeJobTimingEvents(capture.m_events);
+	}
+
+	std::stable_sort(capture.m_events.begin(), capture.m_events.end(), [](const JobTimingEvent& a, const JobTimingEvent& b) {
+		if (a.m_threadID != b.m_threadID) {
+			return a.m_threadID < b.m_threadID;
+		}
+		return a.m_startTimeSeconds < b.m_startTimeSeconds;
+	});
+	return capture;
+}
+
+bool JobSystem::IsCapturingJobTimings() const
+{
+	return m_isCapturingJobTimings;
+}
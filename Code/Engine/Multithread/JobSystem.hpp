@@ -3,16 +3,46 @@
 #include <deque>
 #include <mutex>
 #include <set>
-//#include <condition_variable>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include "Engine/Multithread/JobWorkerThread.hpp"
+#include "Engine/Multithread/InlineJob.hpp"
 
 class Job;
+struct ParallelForState;
+
+//Returned when posting jobs. Counts how many of the jobs posted with it are still queued or running. Copies share the same counter
+class JobHandle {
+	friend class JobSystem;
+public:
+	JobHandle() = default;
+
+	bool IsValid() const;
+	bool IsCompleted() const;	//An invalid handle counts as completed
+	int GetNumPendingJobs() const;
+
+private:
+	JobHandle(const std::shared_ptr<std::atomic<int>>& numPendingJobs);
+
+private:
+	std::shared_ptr<std::atomic<int>> m_numPendingJobs;
+};
 
 struct JobSystemConfig
 {
 public:
-	JobSystemConfig(int numJobWorkerThreads):m_numJobWorkerThreads(numJobWorkerThreads){};
+	JobSystemConfig(int numJobWorkerThreads, bool useWorkStealing = true, int jobPoolSize = 4096):m_numJobWorkerThreads(numJobWorkerThreads), m_useWorkStealing(useWorkStealing), m_jobPoolSize(jobPoolSize){};
 	int m_numJobWorkerThreads = 0;
+	bool m_useWorkStealing = true;	//false: every worker pulls from the single shared queue (old scheduler, kept for benchmark comparisons)
+	int m_jobPoolSize = 4096;	//Number of pooled InlineJobs. Once they are all in flight, PostNewInlineJob falls back to the heap
+
+	//Worker pools. The first m_numReservedFrameCriticalWorkers workers only run FRAME_CRITICAL jobs, so background work can never occupy every worker.
+	//The remaining workers run every category, FRAME_CRITICAL first. IO workers are extra threads on top of m_numJobWorkerThreads that only run IO jobs
+	int m_numReservedFrameCriticalWorkers = 1;
+	int m_numIOWorkerThreads = 0;
+	double m_agingIntervalSeconds = 0.05;	//A queued job gains one priority step per interval waited. Categories are steps too: a BACKGROUND/HIGH job waits 3 intervals to tie with FRAME_CRITICAL/HIGH
 };
 
 class JobSystem {
@@ -24,23 +54,67 @@ public:
 	void Startup();
 	void Shutdown();
 
-	Job* GetCompletedJob();
+	//The poster keeps owning the job: once its handle reports completion, the results can be read straight from the job and it can be deleted
+	JobHandle PostNewJob(Job* job);	//Jobs posted from a worker thread go to that worker's local queue
+	JobHandle PostNewJobs(const std::vector<Job*>& jobs);	//One handle for the whole batch
+
+	//Posts func() as a pooled InlineJob that the job system recycles once it ran. Passing a valid joinHandle adds the job to that handle
+	//(and returns it) instead of creating a new one, so posting many small jobs under one handle doesn't touch the heap at all
+	template<typename Func>
+	JobHandle PostNewInlineJob(Func&& func, const JobHandle& joinHandle = JobHandle(), JobCategory category = JobCategory::FRAME_CRITICAL, JobPriority priority = JobPriority::NORMAL);
 
-	void PostNewJob(Job* job);	//Called by main thread to add Job to ToDo list
+	//dependentJob is queued only after prerequisiteJob finished. Has to be called before dependentJob is posted; prerequisiteJob may already be posted or even done.
+	//A dependent job whose prerequisite never gets posted never runs
+	void AddJobDependency(Job* prerequisiteJob, Job* dependentJob);
 
+	void Wait(const JobHandle& handle);	//Runs queued jobs on the calling thread until the handle completes, instead of idling
 	void WaitUntilAllJobsCompleted();
 
+	//Calls func(index) for every index in [begin, end) and returns once all of them are done. The range is split into contiguous chunks of at least grainSize indices;
+	//the actual chunk size grows with the range length so every participating thread (workers + the calling thread) gets a few chunks to balance the load.
+	//Helper jobs inherit the category of the job that calls ParallelFor (FRAME_CRITICAL when called outside of a job)
+	template<typename Func>
+	void ParallelFor(int begin, int end, int grainSize, Func&& func);
+	void ParallelForRange(int begin, int end, int grainSize, const std::function<void(int, int)>& rangeFunc);	//Same as ParallelFor, but rangeFunc receives a whole chunk [chunkBegin, chunkEnd)
+	int GetParallelForChunkSize(int numIndices, int grainSize) const;
+
 	int GetNumQueuedJobs();
 	int GetNumClaimedJobs();
-	int GetNumCompletedJobs();
 
 	int GetNumCpuCores() const;
+	int GetNumWorkerThreads() const;	//Including IO workers
+	int GetNumWorkerThreadsForCategory(JobCategory category) const;
+
+	//Records queue, start and end time of every job executed until the capture is stopped. Needs ENGINE_ENABLE_JOB_TIMING (see JobTiming.hpp)
+	static bool IsJobTimingCompiledIn();
+	void StartJobTimingCapture();	//Drops whatever an earlier capture left behind
+	JobTimingCapture StopJobTimingCapture();
+	bool IsCapturingJobTimings() const;
 
 private:
 	bool IsQuitting() const;
-	Job* GetUnclaimedJobFromQueue();
+	Job* GetUnclaimedJobFromQueue(JobWorkerThread* workerThread);
+	Job* GetUnclaimedJobFromGlobalQueue(unsigned int categoryMask, JobWorkerThread* workerThreadToRefill);
+	int GetNumAgingSteps(const Job* job, double currentTimeSeconds) const;
+	Job* StealUnclaimedJob(int firstVictimThreadID);
+	JobWorkerThread* GetWorkerThreadOfCallingThread() const;
+	bool AreThereQueuedJobsForCategories(unsigned int categoryMask) const;
+	void WaitForUnclaimedJobs(unsigned int categoryMask);
+	void WakeUpSleepingWorkerThread(JobCategory category);
+	void QueueJob(Job* job, JobWorkerThread* workerThread);
+	void ReleasePrerequisite(Job* job, JobWorkerThread* workerThread);
+	void ReleaseContinuations(Job* finishedJob);
+#if defined(_DEBUG)
+	bool IsJobReachableThroughContinuations(Job* fromJob, Job* targetJob) const;
+#endif
+	void ExecuteJob(Job* job);
+	InlineJob* AcquireInlineJob();
+	JobHandle PostOwnedJob(Job* job, const JobHandle& joinHandle, JobCategory category, JobPriority priority);
+	void RecycleOwnedJob(Job* job);
 	void MarkJobAsClaimed(Job* job);
 	void MarkJobAsCompleted(Job* job);
+	void RecordJobTiming(const JobTimingEvent& event, JobWorkerThread* workerThread);
+	static void RunParallelForChunks(ParallelForState& state);
 
 private:
 	JobSystemConfig m_config;
@@ -48,16 +122,49 @@ private:
 
 	int m_numCpuCores = 1;
 
-	std::deque<Job*> m_unclaimedJobs;
+	//Global queues for jobs posted from non-worker threads and for every non FRAME_CRITICAL job. Workers refill their local queues from here in batches
+	std::deque<Job*> m_unclaimedJobs[(int)JobCategory::COUNT][(int)JobPriority::COUNT];
 	std::mutex m_unclaimedJobsMutex;
+	std::atomic<int> m_numQueuedJobs = 0;	//Jobs sitting in the global queues or in any worker's local queue
+	std::atomic<int> m_numQueuedJobsPerCategory[(int)JobCategory::COUNT] = {};
+	unsigned int m_categoryMaskOfOtherThreads = 0;	//Threads that aren't workers (e.g. the main thread inside Wait()) only help with these categories
+	bool m_isCategoryRunByAllWorkers[(int)JobCategory::COUNT] = {};
 
-	std::set<Job*> m_claimedJobs;
-	std::mutex m_claimedJobsMutex;
+	std::atomic<int> m_numClaimedJobs = 0;
+	std::atomic<int> m_numUnfinishedJobs = 0;	//Queued + claimed. Only drops after a job released its continuations
 
-	std::deque<Job*> m_completedJobs;	//List of jobs finished, ready to be retrieved (Each thread worker pushes it here)
-	std::mutex m_completedJobsMutex;
+	JobPool m_jobPool;
 
 	std::atomic<bool> m_isQuitting = false;	//Main thread will set this variable through Shutdown() and other threads read from it. Therefore it must be atomic
 
+	std::mutex m_sleepingWorkersMutex;
+	std::atomic<int> m_numSleepingWorkers = 0;	//Posting only touches m_sleepingWorkersMutex when somebody is actually asleep
 	std::condition_variable m_areThereUnclaimedJobsCV;
-};
\ No newline at end of file
+
+	std::atomic<bool> m_isCapturingJobTimings = false;
+	double m_jobTimingCaptureStartTimeSeconds = 0.0;
+	std::vector<JobTimingEvent> m_otherThreadsJobTimingEvents;	//Jobs run by threads that aren't workers
+	std::mutex m_otherThreadsJobTimingEventsMutex;
+
+	static constexpr int MAX_JOBS_GRABBED_FROM_GLOBAL_QUEUE = 32;
+	static constexpr unsigned int ALL_JOB_CATEGORIES_MASK = (1u << (int)JobCategory::COUNT) - 1;
+	static constexpr int PARALLEL_FOR_CHUNKS_PER_THREAD = 4;	//More chunks than threads so a thread that got preempted doesn't hold up the whole loop
+};
+
+template<typename Func>
+JobHandle JobSystem::PostNewInlineJob(Func&& func, const JobHandle& joinHandle, JobCategory category, JobPriority priority)
+{
+	InlineJob* job = AcquireInlineJob();
+	job->SetCallable(std::forward<Func>(func));
+	return PostOwnedJob(job, joinHandle, category, priority);
+}
+
+template<typename Func>
+void JobSystem::ParallelFor(int begin, int end, int grainSize, Func&& func)
+{
+	ParallelForRange(begin, end, grainSize, [&func](int chunkBegin, int chunkEnd) {
+		for (int index = chunkBegin; index < chunkEnd; index++) {
+			func(index);
+		}
+	});
+}
@@ -0,0 +1,540 @@
+#include "Engine/Multithread/JobSystemBenchmarks.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
+#include "Engine/Multithread/Job.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Math/RandomNumberGenerator.hpp"
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+class TrivialBenchmarkJob : public Job {
+public:
+	TrivialBenchmarkJob(std::atomic<int>& numExecutedJobs) : m_numExecutedJobs(numExecutedJobs) {};
+	void Execute() override { m_numExecutedJobs.fetch_add(1, std::memory_order_relaxed); };
+	void OnComplete() override {};
+
+private:
+	std::atomic<int>& m_numExecutedJobs;
+};
+
+class FanOutBenchmarkJob : public Job {
+public:
+	FanOutBenchmarkJob(JobSystem& jobSystem, int numJobsToPost, std::atomic<int>& numExecutedJobs) : m_jobSystem(jobSystem), m_numJobsToPost(numJobsToPost), m_numExecutedJobs(numExecutedJobs) {};
+	~FanOutBenchmarkJob() {
+		for (Job* postedJob : m_postedJobs) {
+			delete postedJob;
+		}
+	};
+	void Execute() override {
+		m_postedJobs.reserve(m_numJobsToPost);
+		for (int i = 0; i < m_numJobsToPost; i++) {
+			m_postedJobs.push_back(new TrivialBenchmarkJob(m_numExecutedJobs));
+			m_jobSystem.PostNewJob(m_postedJobs.back());
+		}
+	};
+	void OnComplete() override {};
+
+private:
+	JobSystem& m_jobSystem;
+	int m_numJobsToPost = 0;
+	std::atomic<int>& m_numExecutedJobs;
+	std::vector<Job*> m_postedJobs;
+};
+
+//Stands in for a per-control-point deformation: a few dozen flops on a single element
+static float ComputeBenchmarkElement(int index)
+{
+	float value = (float)index;
+	for (int i = 0; i < 32; i++) {
+		value = sqrtf(value * 0.5f + 1.0f) + sinf(value);
+	}
+	return value;
+}
+
+class PerIndexBenchmarkJob : public Job {
+public:
+	PerIndexBenchmarkJob(int index) : m_index(index) {};
+	void Execute() override { m_result = ComputeBenchmarkElement(m_index); };
+	void OnComplete() override {};
+
+public:
+	int m_index = 0;
+	float m_result = 0.0f;
+};
+
+class GraphOrderingTestJob : public Job {
+public:
+	GraphOrderingTestJob(std::atomic<int>& numFinishedJobs, int amountOfWork) : m_numFinishedJobs(numFinishedJobs), m_amountOfWork(amountOfWork) {};
+	void Execute() override {
+		for (GraphOrderingTestJob* prerequisite : m_prerequisites) {
+			if (prerequisite->m_finishOrder < 0) {
+				m_startedBeforePrerequisite = true;
+			}
+		}
+		float value = 0.0f;
+		for (int i = 0; i < m_amountOfWork; i++) {
+			value = sqrtf(value + (float)i);
+		}
+		m_result = value;
+		m_finishOrder = m_numFinishedJobs++;
+	};
+	void OnComplete() override {};
+
+public:
+	std::vector<GraphOrderingTestJob*> m_prerequisites;
+	std::atomic<int> m_finishOrder = -1;
+	bool m_startedBeforePrerequisite = false;
+
+private:
+	std::atomic<int>& m_numFinishedJobs;
+	int m_amountOfWork = 0;
+	float m_result = 0.0f;
+};
+
+static void SpinForSeconds(double seconds)
+{
+	double endTime = GetCurrentTimeSeconds() + seconds;
+	while (GetCurrentTimeSeconds() < endTime) {
+	}
+}
+
+static double TimeTrivialJobs(const JobSystemConfig& config, int numJobs, bool postFromWorkerThread)
+{
+	JobSystem jobSystem(config);
+	jobSystem.Startup();
+
+	std::atomic<int> numExecutedJobs = 0;
+	std::vector<Job*> postedJobs;
+	postedJobs.reserve(numJobs);
+	double startTime = GetCurrentTimeSeconds();
+	if (postFromWorkerThread) {
+		postedJobs.push_back(new FanOutBenchmarkJob(jobSystem, numJobs, numExecutedJobs));
+		jobSystem.PostNewJob(postedJobs.back());
+	}
+	else {
+		for (int i = 0; i < numJobs; i++) {
+			postedJobs.push_back(new TrivialBenchmarkJob(numExecutedJobs));
+			jobSystem.PostNewJob(postedJobs.back());
+		}
+	}
+	jobSystem.WaitUntilAllJobsCompleted();
+	double endTime = GetCurrentTimeSeconds();
+
+	jobSystem.Shutdown();
+	for (Job* postedJob : postedJobs) {
+		delete postedJob;
+	}
+
+	GUARANTEE_OR_DIE(numExecutedJobs == numJobs, "Job system benchmark lost jobs!");
+	return endTime - startTime;
+}
+
+JobSystemContentionBenchmarkResult RunJobSystemContentionBenchmark(int numJobs, int numWorkerThreads)
+{
+	GUARANTEE_OR_DIE(numJobs > 0, "numJobs <= 0");
+
+	JobSystemContentionBenchmarkResult result;
+	result.m_numJobs = numJobs;
+
+	JobSystem workerCountProbe(JobSystemConfig(numWorkerThreads, true));
+	workerCountProbe.Startup();
+	result.m_numWorkerThreads = workerCountProbe.GetNumWorkerThreads();
+	workerCountProbe.Shutdown();
+	if (result.m_numWorkerThreads == 0) {
+		return result;	//Posted jobs would never be picked up
+	}
+
+	result.m_singleQueueSeconds = TimeTrivialJobs(JobSystemConfig(numWorkerThreads, false), numJobs, false);
+	result.m_workStealingSeconds = TimeTrivialJobs(JobSystemConfig(numWorkerThreads, true), numJobs, false);
+	result.m_workStealingFanOutSeconds = TimeTrivialJobs(JobSystemConfig(numWorkerThreads, true), numJobs, true);
+
+	return result;
+}
+
+std::vector<ParallelForScalingBenchmarkResult> RunParallelForScalingBenchmark(int numIndices, int maxNumThreads)
+{
+	GUARANTEE_OR_DIE(numIndices > 0, "numIndices <= 0");
+	if (maxNumThreads <= 0) {
+		maxNumThreads = (int)std::thread::hardware_concurrency();
+	}
+
+	std::vector<float> results(numIndices);
+	std::vector<ParallelForScalingBenchmarkResult> benchmarkResults;
+	for (int numThreads = 1; numThreads <= maxNumThreads; numThreads++) {
+		JobSystem jobSystem(JobSystemConfig(numThreads - 1));
+		jobSystem.Startup();
+		if (jobSystem.GetNumWorkerThreads() != numThreads - 1) {
+			jobSystem.Shutdown();
+			break;	//Hit the core count
+		}
+
+		ParallelForScalingBenchmarkResult benchmarkResult;
+		benchmarkResult.m_numThreads = numThreads;
+
+		double startTime = GetCurrentTimeSeconds();
+		jobSystem.ParallelFor(0, numIndices, 1, [&results](int index) {
+			results[index] = ComputeBenchmarkElement(index);
+		});
+		benchmarkResult.m_parallelForSeconds = GetCurrentTimeSeconds() - startTime;
+
+		startTime = GetCurrentTimeSeconds();
+		if (jobSystem.GetNumWorkerThreads() == 0) {
+			//Nobody would pick the jobs up, so the calling thread runs them. This still pays for the allocations
+			for (int index = 0; index < numIndices; index++) {
+				PerIndexBenchmarkJob* perIndexJob = new PerIndexBenchmarkJob(index);
+				perIndexJob->Execute();
+				results[perIndexJob->m_index] = perIndexJob->m_result;
+				delete perIndexJob;
+			}
+		}
+		else {
+			std::vector<Job*> perIndexJobs(numIndices);
+			for (int index = 0; index < numIndices; index++) {
+				perIndexJobs[index] = new PerIndexBenchmarkJob(index);
+			}
+			JobHandle perIndexJobsHandle = jobSystem.PostNewJobs(perIndexJobs);
+			jobSystem.Wait(perIndexJobsHandle);
+			for (int index = 0; index < numIndices; index++) {
+				results[index] = ((PerIndexBenchmarkJob*)perIndexJobs[index])->m_result;
+				delete perIndexJobs[index];
+			}
+		}
+		benchmarkResult.m_jobPerIndexSeconds = GetCurrentTimeSeconds() - startTime;
+
+		jobSystem.Shutdown();
+		benchmarkResults.push_back(benchmarkResult);
+	}
+	return benchmarkResults;
+}
+
+JobOverheadBenchmarkResult RunJobOverheadBenchmark(int numJobs, int numWorkerThreads)
+{
+	GUARANTEE_OR_DIE(numJobs > 0, "numJobs <= 0");
+
+	JobOverheadBenchmarkResult result;
+	result.m_numJobs = numJobs;
+
+	//Pool big enough for the whole batch, so the inline path never falls back to the heap
+	JobSystem jobSystem(JobSystemConfig(numWorkerThreads, true, numJobs));
+	jobSystem.Startup();
+	result.m_numWorkerThreads = jobSystem.GetNumWorkerThreads();
+	if (result.m_numWorkerThreads == 0) {
+		jobSystem.Shutdown();
+		return result;
+	}
+
+	std::atomic<int> numExecutedJobs = 0;
+	std::vector<Job*> heapJobs(numJobs);
+	double startTime = GetCurrentTimeSeconds();
+	for (int i = 0; i < numJobs; i++) {
+		heapJobs[i] = new TrivialBenchmarkJob(numExecutedJobs);
+		jobSystem.PostNewJob(heapJobs[i]);
+	}
+	jobSystem.WaitUntilAllJobsCompleted();
+	for (int i = 0; i < numJobs; i++) {
+		delete heapJobs[i];
+	}
+	result.m_heapJobNanoseconds = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / (double)numJobs;
+
+	startTime = GetCurrentTimeSeconds();
+	JobHandle inlineJobsHandle;
+	for (int i = 0; i < numJobs; i++) {
+		inlineJobsHandle = jobSystem.PostNewInlineJob([&numExecutedJobs]() { numExecutedJobs.fetch_add(1, std::memory_order_relaxed); }, inlineJobsHandle);
+	}
+	jobSystem.Wait(inlineJobsHandle);
+	result.m_inlineJobNanoseconds = (GetCurrentTimeSeconds() - startTime) * 1.0e9 / (double)numJobs;
+
+	jobSystem.Shutdown();
+	GUARANTEE_OR_DIE(numExecutedJobs == 2 * numJobs, "Job overhead benchmark lost jobs!");
+	return result;
+}
+
+JobGraphOrderingTestResult RunJobGraphOrderingTest(JobSystem& jobSystem, int numGraphs, int numJobsPerGraph, int maxNumPrerequisites, unsigned int seed)
+{
+	GUARANTEE_OR_DIE(numJobsPerGraph > 0, "numJobsPerGraph <= 0");
+	GUARANTEE_OR_DIE(maxNumPrerequisites >= 0, "maxNumPrerequisites < 0");
+
+	RandomNumberGenerator rng(seed);
+	JobGraphOrderingTestResult result;
+	result.m_numGraphs = numGraphs;
+
+	double startTime = GetCurrentTimeSeconds();
+	for (int graphIdx = 0; graphIdx < numGraphs; graphIdx++) {
+		std::atomic<int> numFinishedJobs = 0;
+		std::vector<GraphOrderingTestJob*> jobs;
+		std::vector<JobHandle> handles;
+		jobs.reserve(numJobsPerGraph);
+		handles.reserve(numJobsPerGraph);
+
+		//Prerequisites always come from earlier jobs, so the graph is acyclic. Each job is posted right after it is wired up,
+		//which means a good share of its prerequisites are already running or finished by then
+		for (int jobIdx = 0; jobIdx < numJobsPerGraph; jobIdx++) {
+			GraphOrderingTestJob* job = new GraphOrderingTestJob(numFinishedJobs, rng.RollRandomIntInRange(0, 2000));
+			if (jobIdx > 0) {
+				int numPrerequisites = rng.RollRandomIntInRange(0, maxNumPrerequisites);
+				for (int i = 0; i < numPrerequisites; i++) {
+					GraphOrderingTestJob* prerequisite = jobs[rng.RollRandomIntLessThan(jobIdx)];
+					job->m_prerequisites.push_back(prerequisite);
+					jobSystem.AddJobDependency(prerequisite, job);
+				}
+			}
+			jobs.push_back(job);
+			handles.push_back(jobSystem.PostNewJob(job));
+		}
+
+		for (const JobHandle& handle : handles) {
+			jobSystem.Wait(handle);
+		}
+
+		for (GraphOrderingTestJob* job : jobs) {
+			result.m_numJobsPosted++;
+			if (job->m_finishOrder >= 0) {
+				result.m_numJobsRun++;
+			}
+			bool isOrderViolated = job->m_startedBeforePrerequisite;
+			for (GraphOrderingTestJob* prerequisite : job->m_prerequisites) {
+				if (prerequisite->m_finishOrder >= job->m_finishOrder) {
+					isOrderViolated = true;
+				}
+			}
+			if (isOrderViolated) {
+				result.m_numOrderingViolations++;
+			}
+		}
+
+		for (GraphOrderingTestJob* job : jobs) {
+			delete job;
+		}
+	}
+	result.m_seconds = GetCurrentTimeSeconds() - startTime;
+	return result;
+}
+
+JobLatencyTestResult RunJobLatencyTest(const JobSystemConfig& config, bool postBackgroundJobsAsFrameCritical, double backgroundJobSeconds, int numFrames)
+{
+	GUARANTEE_OR_DIE(numFrames > 0, "numFrames <= 0");
+	constexpr double FRAME_SECONDS = 1.0 / 60.0;
+	constexpr double FRAME_JOB_SECONDS = 0.0005;
+	constexpr double SHORT_BACKGROUND_JOB_SECONDS = 0.0001;
+
+	JobLatencyTestResult result;
+	result.m_numFrames = numFrames;
+
+	JobSystem jobSystem(config);
+	jobSystem.Startup();
+	result.m_numWorkerThreads = jobSystem.GetNumWorkerThreads();
+	result.m_numReservedWorkers = result.m_numWorkerThreads - jobSystem.GetNumWorkerThreadsForCategory(JobCategory::BACKGROUND);
+	if (result.m_numWorkerThreads == 0) {
+		jobSystem.Shutdown();
+		return result;
+	}
+	JobCategory backgroundCategory = postBackgroundJobsAsFrameCritical ? JobCategory::FRAME_CRITICAL : JobCategory::BACKGROUND;
+
+	//One long job per worker: every worker that is allowed to take background work ends up busy with it
+	JobHandle backgroundJobsHandle;
+	for (int i = 0; i < result.m_numWorkerThreads; i++) {
+		backgroundJobsHandle = jobSystem.PostNewInlineJob([backgroundJobSeconds]() { SpinForSeconds(backgroundJobSeconds); }, backgroundJobsHandle, backgroundCategory, JobPriority::NORMAL);
+	}
+
+	//A LOW job first, then a HIGH one every frame. They all queue up behind the long jobs; aging should let the LOW job through early once a worker frees up
+	std::atomic<int> numHighPriorityJobsStarted = 0;
+	double lowPriorityJobPostTime = GetCurrentTimeSeconds();
+	double lowPriorityJobStartTime = 0.0;
+	int numHighPriorityJobsStartedBeforeLow = 0;
+	backgroundJobsHandle = jobSystem.PostNewInlineJob([&]() {
+		lowPriorityJobStartTime = GetCurrentTimeSeconds();
+		numHighPriorityJobsStartedBeforeLow = numHighPriorityJobsStarted;
+	}, backgroundJobsHandle, backgroundCategory, JobPriority::LOW);
+
+	//Polls instead of Wait() so the main thread doesn't run the frame jobs itself, which would hide the latency
+	std::vector<double> frameJobWaitSeconds(numFrames, -1.0);
+	for (int frameIdx = 0; frameIdx < numFrames; frameIdx++) {
+		double frameStartTime = GetCurrentTimeSeconds();
+		double* waitSeconds = &frameJobWaitSeconds[frameIdx];
+		JobHandle frameJobHandle = jobSystem.PostNewInlineJob([frameStartTime, waitSeconds]() {
+			*waitSeconds = GetCurrentTimeSeconds() - frameStartTime;
+			SpinForSeconds(FRAME_JOB_SECONDS);
+		});
+		backgroundJobsHandle = jobSystem.PostNewInlineJob([&numHighPriorityJobsStarted]() {
+			numHighPriorityJobsStarted++;
+			SpinForSeconds(SHORT_BACKGROUND_JOB_SECONDS);
+		}, backgroundJobsHandle, backgroundCategory, JobPriority::HIGH);
+		result.m_numHighPriorityJobsQueued++;
+
+		while (!frameJobHandle.IsCompleted()) {
+			std::this_thread::yield();
+		}
+		while (GetCurrentTimeSeconds() - frameStartTime < FRAME_SECONDS) {
+			std::this_thread::yield();
+		}
+	}
+	jobSystem.Wait(backgroundJobsHandle);
+	jobSystem.Shutdown();
+
+	for (double waitSeconds : frameJobWaitSeconds) {
+		result.m_averageFrameJobWaitSeconds += waitSeconds;
+		result.m_maxFrameJobWaitSeconds = std::max(result.m_maxFrameJobWaitSeconds, waitSeconds);
+	}
+	result.m_averageFrameJobWaitSeconds /= (double)numFrames;
+	result.m_lowPriorityJobWaitSeconds = lowPriorityJobStartTime - lowPriorityJobPostTime;
+	result.m_numHighPriorityJobsRunBeforeLowPriorityJob = numHighPriorityJobsStartedBeforeLow;
+	return result;
+}
+
+static void PrintBenchmarkLine(const std::string& line)
+{
+	DebuggerPrintf("%s\n", line.c_str());
+	if (g_theDevConsole) {
+		g_theDevConsole->AddLine(DevConsole::INFO_MINOR, line);
+	}
+}
+
+void RegisterJobSystemBenchmarkCommands()
+{
+	g_theEventSystem->SubscribeEventCallbackFunction("JobSystemBenchmark", Command_JobSystemBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("ParallelForBenchmark", Command_ParallelForBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("JobOverheadBenchmark", Command_JobOverheadBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("JobGraphTest", Command_JobGraphTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("JobLatencyTest", Command_JobLatencyTest);
+	g_theEventSystem->SubscribeEventCallbackFunction("JobTimingStart", Command_JobTimingStart);
+	g_theEventSystem->SubscribeEventCallbackFunction("JobTimingStop", Command_JobTimingStop);
+}
+
+bool Command_JobSystemBenchmark(EventArgs& args)
+{
+	int numJobs = atoi(args.GetValue("NumJobs", std::string("100000")).c_str());
+	int numWorkerThreads = atoi(args.GetValue("NumWorkers", std::string("-1")).c_str());
+
+	JobSystemContentionBenchmarkResult result = RunJobSystemContentionBenchmark(numJobs, numWorkerThreads);
+	if (result.m_numWorkerThreads == 0) {
+		PrintBenchmarkLine("JobSystemBenchmark: needs at least one worker thread");
+		return false;
+	}
+	PrintBenchmarkLine(Stringf("JobSystemBenchmark: %d trivial jobs, %d workers", result.m_numJobs, result.m_numWorkerThreads));
+	PrintBenchmarkLine(Stringf("  Single queue (old):          %.3lf ms (%.0lf jobs/s)", result.m_singleQueueSeconds * 1000.0, (double)numJobs / result.m_singleQueueSeconds));
+	PrintBenchmarkLine(Stringf("  Work stealing:               %.3lf ms (%.0lf jobs/s)", result.m_workStealingSeconds * 1000.0, (double)numJobs / result.m_workStealingSeconds));
+	PrintBenchmarkLine(Stringf("  Work stealing, worker fan-out: %.3lf ms (%.0lf jobs/s)", result.m_workStealingFanOutSeconds * 1000.0, (double)numJobs / result.m_workStealingFanOutSeconds));
+	return true;
+}
+
+bool Command_ParallelForBenchmark(EventArgs& args)
+{
+	int numIndices = atoi(args.GetValue("NumIndices", std::string("1000000")).c_str());
+	int maxNumThreads = atoi(args.GetValue("MaxThreads", std::string("-1")).c_str());
+
+	std::vector<ParallelForScalingBenchmarkResult> results = RunParallelForScalingBenchmark(numIndices, maxNumThreads);
+	PrintBenchmarkLine(Stringf("ParallelForBenchmark: %d indices", numIndices));
+	for (int i = 0; i < (int)results.size(); i++) {
+		const ParallelForScalingBenchmarkResult& result = results[i];
+		double speedUp = results[0].m_parallelForSeconds / result.m_parallelForSeconds;
+		PrintBenchmarkLine(Stringf("  %2d threads: ParallelFor %.3lf ms (x%.2lf), job per index %.3lf ms", result.m_numThreads, result.m_parallelForSeconds * 1000.0, speedUp, result.m_jobPerIndexSeconds * 1000.0));
+	}
+	return true;
+}
+
+bool Command_JobOverheadBenchmark(EventArgs& args)
+{
+	int numJobs = atoi(args.GetValue("NumJobs", std::string("100000")).c_str());
+	int numWorkerThreads = atoi(args.GetValue("NumWorkers", std::string("-1")).c_str());
+
+	JobOverheadBenchmarkResult result = RunJobOverheadBenchmark(numJobs, numWorkerThreads);
+	if (result.m_numWorkerThreads == 0) {
+		PrintBenchmarkLine("JobOverheadBenchmark: needs at least one worker thread");
+		return false;
+	}
+	PrintBenchmarkLine(Stringf("JobOverheadBenchmark: %d empty jobs, %d workers", result.m_numJobs, result.m_numWorkerThreads));
+	PrintBenchmarkLine(Stringf("  Heap job (new/PostNewJob/delete): %.1lf ns per job", result.m_heapJobNanoseconds));
+	PrintBenchmarkLine(Stringf("  Pooled inline job:                %.1lf ns per job", result.m_inlineJobNanoseconds));
+	return true;
+}
+
+bool Command_JobGraphTest(EventArgs& args)
+{
+	int numGraphs = atoi(args.GetValue("NumGraphs", std::string("20")).c_str());
+	int numJobsPerGraph = atoi(args.GetValue("NumJobs", std::string("2000")).c_str());
+	int maxNumPrerequisites = atoi(args.GetValue("MaxPrerequisites", std::string("4")).c_str());
+	unsigned int seed = (unsigned int)atoi(args.GetValue("Seed", std::string("0")).c_str());
+
+	//Runs on the engine's job system so the test also covers jobs posted while the game keeps it busy
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "JobGraphTest needs g_theJobSystem");
+	JobGraphOrderingTestResult result = RunJobGraphOrderingTest(*g_theJobSystem, numGraphs, numJobsPerGraph, maxNumPrerequisites, seed);
+	bool hasPassed = (result.m_numJobsRun == result.m_numJobsPosted) && (result.m_numOrderingViolations == 0);
+	PrintBenchmarkLine(Stringf("JobGraphTest %s: %d graphs, %d/%d jobs run, %d ordering violations, %.3lf ms", hasPassed ? "PASSED" : "FAILED",
+		result.m_numGraphs, result.m_numJobsRun, result.m_numJobsPosted, result.m_numOrderingViolations, result.m_seconds * 1000.0));
+	return hasPassed;
+}
+
+
+static void PrintJobLatencyTestResult(const char* label, const JobLatencyTestResult& result)
+{
+	PrintBenchmarkLine(Stringf("  %s (%d workers, %d reserved): frame job wait avg %.3lf ms, max %.3lf ms", label, result.m_numWorkerThreads, result.m_numReservedWorkers,
+		result.m_averageFrameJobWaitSeconds * 1000.0, result.m_maxFrameJobWaitSeconds * 1000.0));
+	PrintBenchmarkLine(Stringf("    LOW job waited %.3lf ms, %d/%d later HIGH jobs ran before it", result.m_lowPriorityJobWaitSeconds * 1000.0,
+		result.m_numHighPriorityJobsRunBeforeLowPriorityJob, result.m_numHighPriorityJobsQueued));
+}
+
+bool Command_JobLatencyTest(EventArgs& args)
+{
+	double backgroundJobSeconds = atof(args.GetValue("BackgroundSeconds", std::string("2.0")).c_str());
+	int numFrames = atoi(args.GetValue("NumFrames", std::string("120")).c_str());
+	int numWorkerThreads = atoi(args.GetValue("NumWorkers", std::string("-1")).c_str());
+
+	//Old behaviour: no reserved workers and everything posted into the same category
+	JobSystemConfig sharedConfig(numWorkerThreads);
+	sharedConfig.m_numReservedFrameCriticalWorkers = 0;
+	JobLatencyTestResult sharedResult = RunJobLatencyTest(sharedConfig, true, backgroundJobSeconds, numFrames);
+	if (sharedResult.m_numWorkerThreads < 2) {
+		PrintBenchmarkLine("JobLatencyTest: needs at least two worker threads");
+		return false;
+	}
+	JobLatencyTestResult reservedResult = RunJobLatencyTest(JobSystemConfig(numWorkerThreads), false, backgroundJobSeconds, numFrames);
+
+	PrintBenchmarkLine(Stringf("JobLatencyTest: %d frames, background jobs running for %.2lf s on every worker", numFrames, backgroundJobSeconds));
+	PrintJobLatencyTestResult("Shared workers, one category", sharedResult);
+	PrintJobLatencyTestResult("Reserved frame-critical worker", reservedResult);
+	return true;
+}
+
+bool Command_JobTimingStart(EventArgs& args)
+{
+	UNUSED(args);
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "JobTimingStart needs g_theJobSystem");
+	if (!JobSystem::IsJobTimingCompiledIn()) {
+		PrintBenchmarkLine("JobTimingStart: define ENGINE_ENABLE_JOB_TIMING in Game/EngineBuildPreferences.hpp to record job timings");
+		return false;
+	}
+	g_theJobSystem->StartJobTimingCapture();
+	PrintBenchmarkLine("JobTimingStart: capturing job timings");
+	return true;
+}
+
+bool Command_JobTimingStop(EventArgs& args)
+{
+	std::string fileName = args.GetValue("File", std::string("JobTiming.json"));
+	GUARANTEE_OR_DIE(g_theJobSystem != nullptr, "JobTimingStop needs g_theJobSystem");
+	if (!g_theJobSystem->IsCapturingJobTimings()) {
+		PrintBenchmarkLine("JobTimingStop: no capture running, use JobTimingStart first");
+		return false;
+	}
+
+	JobTimingCapture capture = g_theJobSystem->StopJobTimingCapture();
+	JobTimingSummary summary = capture.GetSummary();
+	bool hasWrittenFile = capture.WriteChromeTraceFile(fileName);
+	PrintBenchmarkLine(Stringf("JobTimingStop: %d jobs in %.3lf ms%s", summary.m_numJobs, summary.m_captureSeconds * 1000.0,
+		hasWrittenFile ? Stringf(", trace written to %s", fileName.c_str()).c_str() : ", could not write the trace file"));
+	for (const JobTimingThreadSummary& threadSummary : summary.m_threads) {
+		std::string threadName = (threadSummary.m_threadID >= 0) ? Stringf("Worker %2d", threadSummary.m_threadID) : std::string("Other    ");
+		PrintBenchmarkLine(Stringf("  %s: %6d jobs, busy %.3lf ms (%.1lf%%)", threadName.c_str(), threadSummary.m_numJobs, threadSummary.m_busySeconds * 1000.0, threadSummary.m_utilization * 100.0));
+	}
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		if (summary.m_numJobsPerCategory[categoryIdx] > 0) {
+			PrintBenchmarkLine(Stringf("  %s queue wait: avg %.3lf ms, max %.3lf ms over %d jobs", GetJobCategoryName((JobCategory)categoryIdx),
+				summary.m_averageQueueWaitSeconds[categoryIdx] * 1000.0, summary.m_maxQueueWaitSeconds[categoryIdx] * 1000.0, summary.m_numJobsPerCategory[categoryIdx]));
+		}
+	}
+	return hasWrittenFile;
+}
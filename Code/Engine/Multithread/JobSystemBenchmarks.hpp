@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Core/EventSystem.hpp"
+#include <vector>
+
+class JobSystem;
+struct JobSystemConfig;
+
+//Benchmarks for the job system, plus the console commands for job timing captures on g_theJobSystem. They spin up their own JobSystem instances, so they can run from the dev console or from a headless executable
+
+struct JobSystemContentionBenchmarkResult {
+	int m_numJobs = 0;
+	int m_numWorkerThreads = 0;
+	double m_singleQueueSeconds = 0.0;			//Old scheduler: every worker pops from one mutex-guarded queue
+	double m_workStealingSeconds = 0.0;			//Work-stealing scheduler, jobs posted from the main thread
+	double m_workStealingFanOutSeconds = 0.0;	//Work-stealing scheduler, jobs posted from inside a worker (local queue + stealing)
+};
+
+struct ParallelForScalingBenchmarkResult {
+	int m_numThreads = 0;	//Worker threads + the calling thread
+	double m_parallelForSeconds = 0.0;
+	double m_jobPerIndexSeconds = 0.0;	//Old pattern: one heap allocated job per index
+};
+
+struct JobOverheadBenchmarkResult {
+	int m_numJobs = 0;
+	int m_numWorkerThreads = 0;
+	double m_heapJobNanoseconds = 0.0;		//Per job: new + PostNewJob + delete
+	double m_inlineJobNanoseconds = 0.0;	//Per job: pooled PostNewInlineJob under one handle
+};
+
+struct JobGraphOrderingTestResult {
+	int m_numGraphs = 0;
+	int m_numJobsPosted = 0;
+	int m_numJobsRun = 0;
+	int m_numOrderingViolations = 0;	//A job that started before one of its prerequisites finished
+	double m_seconds = 0.0;
+};
+
+struct JobLatencyTestResult {
+	int m_numFrames = 0;
+	int m_numWorkerThreads = 0;
+	int m_numReservedWorkers = 0;
+	double m_averageFrameJobWaitSeconds = 0.0;	//Post -> start of a frame job while every unreserved worker is stuck on background work
+	double m_maxFrameJobWaitSeconds = 0.0;
+	double m_lowPriorityJobWaitSeconds = 0.0;	//Post -> start of a LOW background job posted ahead of a stream of HIGH ones
+	int m_numHighPriorityJobsQueued = 0;
+	int m_numHighPriorityJobsRunBeforeLowPriorityJob = 0;	//Without aging this would be all of them
+};
+
+JobSystemContentionBenchmarkResult RunJobSystemContentionBenchmark(int numJobs, int numWorkerThreads);
+std::vector<ParallelForScalingBenchmarkResult> RunParallelForScalingBenchmark(int numIndices, int maxNumThreads);
+JobOverheadBenchmarkResult RunJobOverheadBenchmark(int numJobs, int numWorkerThreads);
+JobGraphOrderingTestResult RunJobGraphOrderingTest(JobSystem& jobSystem, int numGraphs, int numJobsPerGraph, int maxNumPrerequisites, unsigned int seed);
+JobLatencyTestResult RunJobLatencyTest(const JobSystemConfig& config, bool postBackgroundJobsAsFrameCritical, double backgroundJobSeconds, int numFrames);
+
+//JobSystem::Startup of g_theJobSystem calls this when ENGINE_ENABLE_BENCHMARK_COMMANDS is defined in the game's Code/Game/EngineBuildPreferences.hpp.
+//A shipping build leaves the flag out and gets no benchmark commands in its dev console
+void RegisterJobSystemBenchmarkCommands();
+bool Command_JobSystemBenchmark(EventArgs& args);
+bool Command_ParallelForBenchmark(EventArgs& args);
+bool Command_JobOverheadBenchmark(EventArgs& args);
+bool Command_JobGraphTest(EventArgs& args);
+bool Command_JobLatencyTest(EventArgs& args);
+bool Command_JobTimingStart(EventArgs& args);
+bool Command_JobTimingStop(EventArgs& args);
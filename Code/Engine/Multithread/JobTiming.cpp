@@ -0,0 +1,92 @@
+#include "Engine/Multithread/JobTiming.hpp"
+#include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include <algorithm>
+
+const char* GetJobCategoryName(JobCategory category)
+{
+	switch (category) {
+	case JobCategory::FRAME_CRITICAL:	return "FRAME_CRITICAL";
+	case JobCategory::BACKGROUND:		return "BACKGROUND";
+	case JobCategory::IO:				return "IO";
+	default:							return "UNKNOWN";
+	}
+}
+
+static std::string GetJsonEscapedString(const char* text)
+{
+	std::string escapedText;
+	for (const char* character = text; character && *character; character++) {
+		if (*character == '"' || *character == '\\') {
+			escapedText.push_back('\\');
+		}
+		escapedText.push_back(*character);
+	}
+	return escapedText;
+}
+
+JobTimingSummary JobTimingCapture::GetSummary() const
+{
+	JobTimingSummary summary;
+	summary.m_captureSeconds = m_captureEndTimeSeconds - m_captureStartTimeSeconds;
+	summary.m_numJobs = (int)m_events.size();
+
+	//Index numWorkers collects the threads that aren't workers
+	summary.m_threads.resize(m_numWorkerThreads + 1);
+	for (int threadIdx = 0; threadIdx < m_numWorkerThreads; threadIdx++) {
+		summary.m_threads[threadIdx].m_threadID = threadIdx;
+	}
+
+	for (const JobTimingEvent& event : m_events) {
+		int threadIdx = (event.m_threadID >= 0 && event.m_threadID < m_numWorkerThreads) ? event.m_threadID : m_numWorkerThreads;
+		JobTimingThreadSummary& threadSummary = summary.m_threads[threadIdx];
+		threadSummary.m_numJobs++;
+		threadSummary.m_busySeconds += event.m_endTimeSeconds - event.m_startTimeSeconds;
+
+		int categoryIdx = (int)event.m_category;
+		double queueWaitSeconds = event.m_startTimeSeconds - event.m_queuedTimeSeconds;
+		summary.m_numJobsPerCategory[categoryIdx]++;
+		summary.m_averageQueueWaitSeconds[categoryIdx] += queueWaitSeconds;
+		summary.m_maxQueueWaitSeconds[categoryIdx] = std::max(summary.m_maxQueueWaitSeconds[categoryIdx], queueWaitSeconds);
+	}
+
+	if (summary.m_threads.back().m_numJobs == 0) {
+		summary.m_threads.pop_back();
+	}
+	for (JobTimingThreadSummary& threadSummary : summary.m_threads) {
+		threadSummary.m_utilization = (summary.m_captureSeconds > 0.0) ? threadSummary.m_busySeconds / summary.m_captureSeconds : 0.0;
+	}
+	for (int categoryIdx = 0; categoryIdx < (int)JobCategory::COUNT; categoryIdx++) {
+		if (summary.m_numJobsPerCategory[categoryIdx] > 0) {
+			summary.m_averageQueueWaitSeconds[categoryIdx] /= (double)summary.m_numJobsPerCategory[categoryIdx];
+		}
+	}
+	return summary;
+}
+
+std::string JobTimingCapture::GetChromeTraceJson() const
+{
+	//trace_event format: "X" events are complete slices, timestamps in microseconds. "M" events name the tracks
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":-1,\"args\":{\"name\":\"Other threads\"}}";
+	for (int threadIdx = 0; threadIdx < m_numWorkerThreads; threadIdx++) {
+		json += Stringf(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"Job worker %d\"}}", threadIdx, threadIdx);
+	}
+
+	for (const JobTimingEvent& event : m_events) {
+		double startMicroseconds = (event.m_startTimeSeconds - m_captureStartTimeSeconds) * 1.0e6;
+		double durationMicroseconds = (event.m_endTimeSeconds - event.m_startTimeSeconds) * 1.0e6;
+		double queueWaitMicroseconds = (event.m_startTimeSeconds - event.m_queuedTimeSeconds) * 1.0e6;
+		json += Stringf(",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3lf,\"dur\":%.3lf,\"args\":{\"queueWaitUs\":%.3lf}}",
+			GetJsonEscapedString(event.m_jobName).c_str(), GetJobCategoryName(event.m_category), event.m_threadID, startMicroseconds, durationMicroseconds, queueWaitMicroseconds);
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+bool JobTimingCapture::WriteChromeTraceFile(const std::string& fileName) const
+{
+	std::string json = GetChromeTraceJson();
+	std::vector<uint8_t> buffer(json.begin(), json.end());
+	return FileWriteFromBuffer(buffer, fileName);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Engine/Multithread/Job.hpp"
+#include <string>
+#include <vector>
+
+//Job timings are only recorded when ENGINE_ENABLE_JOB_TIMING is defined in the game's Code/Game/EngineBuildPreferences.hpp.
+//Without it the capture functions on JobSystem still exist but never record anything
+
+struct JobTimingEvent {
+	const char* m_jobName = nullptr;	//Type name of the job
+	JobCategory m_category = JobCategory::FRAME_CRITICAL;
+	int m_threadID = -1;	//Worker thread ID, -1 for threads that aren't workers (e.g. the main thread helping out inside Wait())
+	double m_queuedTimeSeconds = 0.0;
+	double m_startTimeSeconds = 0.0;
+	double m_endTimeSeconds = 0.0;
+};
+
+struct JobTimingThreadSummary {
+	int m_threadID = -1;
+	int m_numJobs = 0;
+	double m_busySeconds = 0.0;
+	double m_utilization = 0.0;	//Busy time / capture time
+};
+
+struct JobTimingSummary {
+	double m_captureSeconds = 0.0;
+	int m_numJobs = 0;
+	std::vector<JobTimingThreadSummary> m_threads;	//One entry per worker, then one for the other threads if they ran any jobs
+	double m_averageQueueWaitSeconds[(int)JobCategory::COUNT] = {};
+	double m_maxQueueWaitSeconds[(int)JobCategory::COUNT] = {};
+	int m_numJobsPerCategory[(int)JobCategory::COUNT] = {};
+};
+
+//A capture as handed out by JobSystem::StopJobTimingCapture(). Events are grouped per thread and sorted by start time within each thread
+struct JobTimingCapture {
+	double m_captureStartTimeSeconds = 0.0;
+	double m_captureEndTimeSeconds = 0.0;
+	int m_numWorkerThreads = 0;
+	std::vector<JobTimingEvent> m_events;
+
+	JobTimingSummary GetSummary() const;
+	std::string GetChromeTraceJson() const;	//Load in chrome://tracing or ui.perfetto.dev
+	bool WriteChromeTraceFile(const std::string& fileName) const;
+};
+
+const char* GetJobCategoryName(JobCategory category);
@@ -1,10 +1,11 @@
 #include "Engine/Multithread/JobWorkerThread.hpp"
 #include "Engine/Multithread/Job.hpp"
-#include "Engine/Multithread/Jobsystem.hpp"
+#include "Engine/Multithread/JobSystem.hpp"
 
-JobWorkerThread::JobWorkerThread(int threadID, JobSystem& jobSystem) : m_threadID(threadID), m_jobSystem(jobSystem)
+static thread_local JobWorkerThread* s_workerThreadOfCallingThread = nullptr;
+
+JobWorkerThread::JobWorkerThread(int threadID, unsigned int categoryMask, JobSystem& jobSystem) : m_jobSystem(jobSystem), m_threadID(threadID), m_categoryMask(categoryMask)
 {
-	m_thread = new std::thread(JobWorkerThread::ThreadMain, std::ref(jobSystem));
 }
 
 JobWorkerThread::~JobWorkerThread()
@@ -12,27 +13,94 @@ JobWorkerThread::~JobWorkerThread()
 	delete m_thread;
 }
 
+void JobWorkerThread::Start()
+{
+	//Threads are started only after every worker exists, since thieves iterate over all of them
+	m_thread = new std::thread(JobWorkerThread::ThreadMain, std::ref(*this));
+}
+
 void JobWorkerThread::Join() const
 {
 	if(m_thread)
 		m_thread->join();
 }
 
-void JobWorkerThread::ThreadMain(JobSystem& jobSystem)
+int JobWorkerThread::GetThreadID() const
 {
+	return m_threadID;
+}
+
+unsigned int JobWorkerThread::GetCategoryMask() const
+{
+	return m_categoryMask;
+}
+
+void JobWorkerThread::ThreadMain(JobWorkerThread& workerThread)
+{
+	s_workerThreadOfCallingThread = &workerThread;
+	JobSystem& jobSystem = workerThread.m_jobSystem;
+
 	while (!jobSystem.IsQuitting())
 	{
-		Job* jobToDo = jobSystem.GetUnclaimedJobFromQueue();
+		Job* jobToDo = jobSystem.GetUnclaimedJobFromQueue(&workerThread);
 		if (jobToDo) {
-			jobSystem.MarkJobAsClaimed(jobToDo);
-			jobToDo->Execute();
-			jobSystem.MarkJobAsCompleted(jobToDo);
-			jobToDo->OnComplete();
+			jobSystem.ExecuteJob(jobToDo);
 		}
 		else {
-			std::unique_lock<std::mutex> lock(jobSystem.m_unclaimedJobsMutex);
-			//Should keep waiting if jobSystem is NOT quitting and there are no queued jobs
-			jobSystem.m_areThereUnclaimedJobsCV.wait(lock, [&jobSystem]() {return (jobSystem.IsQuitting() || jobSystem.m_unclaimedJobs.size() > 0); });
+			jobSystem.WaitForUnclaimedJobs(workerThread.m_categoryMask);
 		}
 	}
-}
\ No newline at end of file
+
+	s_workerThreadOfCallingThread = nullptr;
+}
+
+JobWorkerThread* JobWorkerThread::GetWorkerThreadOfCallingThread()
+{
+	return s_workerThreadOfCallingThread;
+}
+
+void JobWorkerThread::PushLocalJob(Job* job)
+{
+	m_localJobsMutex.lock();
+	m_localJobs.push_back(job);
+	m_localJobsMutex.unlock();
+}
+
+Job* JobWorkerThread::PopLocalJob()
+{
+	Job* job = nullptr;
+	m_localJobsMutex.lock();
+	if (!m_localJobs.empty()) {
+		job = m_localJobs.back();
+		m_localJobs.pop_back();
+	}
+	m_localJobsMutex.unlock();
+	return job;
+}
+
+void JobWorkerThread::RecordJobTiming(const JobTimingEvent& event)
+{
+	m_jobTimingEventsMutex.lock();
+	m_jobTimingEvents.push_back(event);
+	m_jobTimingEventsMutex.unlock();
+}
+
+void JobWorkerThread::TakeJobTimingEvents(std::vector<JobTimingEvent>& outEvents)
+{
+	m_jobTimingEventsMutex.lock();
+	outEvents.insert(outEvents.end(), m_jobTimingEvents.begin(), m_jobTimingEvents.end());
+	m_jobTimingEvents.clear();
+	m_jobTimingEventsMutex.unlock();
+}
+
+Job* JobWorkerThread::StealLocalJob()
+{
+	Job* job = nullptr;
+	m_localJobsMutex.lock();
+	if (!m_localJobs.empty()) {
+		job = m_localJobs.front();
+		m_localJobs.pop_front();
+	}
+	m_localJobsMutex.unlock();
+	return job;
+}
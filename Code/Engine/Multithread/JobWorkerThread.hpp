@@ -1,19 +1,42 @@
 #pragma once
 #include <thread>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "Engine/Multithread/JobTiming.hpp"
 
 class Job;
 class JobSystem;
 
 class JobWorkerThread {
+	friend class JobSystem;
 public:
-	JobWorkerThread(int threadID, JobSystem& jobSystem);
+	JobWorkerThread(int threadID, unsigned int categoryMask, JobSystem& jobSystem);
 	~JobWorkerThread();
 
+	void Start();
 	void Join() const;
-	static void ThreadMain(JobSystem& jobSystem);
+	int GetThreadID() const;
+	unsigned int GetCategoryMask() const;	//Bit i set: runs jobs of JobCategory i
+	static void ThreadMain(JobWorkerThread& workerThread);
+	static JobWorkerThread* GetWorkerThreadOfCallingThread();	//nullptr if the calling thread is not a job worker thread
+
+private:
+	void PushLocalJob(Job* job);	//Only the thread owning this worker pushes here
+	Job* PopLocalJob();		//Owner side: takes the newest job (LIFO keeps the data it just touched hot in cache)
+	Job* StealLocalJob();	//Thief side: takes the oldest job so owner and thieves work on opposite ends of the deque
+	void RecordJobTiming(const JobTimingEvent& event);	//Only called from this worker's thread
+	void TakeJobTimingEvents(std::vector<JobTimingEvent>& outEvents);
 
 private:
 	JobSystem& m_jobSystem;
 	std::thread* m_thread = nullptr;
 	int m_threadID = -1;
-};
\ No newline at end of file
+	unsigned int m_categoryMask = 0;
+
+	std::deque<Job*> m_localJobs;	//Per-worker queue for FRAME_CRITICAL jobs. Only contended when another worker is stealing from it
+	std::mutex m_localJobsMutex;
+
+	std::vector<JobTimingEvent> m_jobTimingEvents;	//Filled while a job timing capture runs
+	std::mutex m_jobTimingEventsMutex;	//Only contended when the capture gets stopped
+};
@@ -19,6 +19,7 @@
 #include "Engine/Renderer/ComputeOutputBuffer.hpp"
 #include "Engine/Renderer/ComputeShader.hpp"
 #include "Engine/Renderer/ShadowMap.hpp"
+#include "Engine/Math/IntRange.hpp"
 #include "Engine/Core/FileUtils.hpp"
 #include "ThirdParty/stb/stb_image.h"
 
@@ -967,16 +968,16 @@ ComputeShader* Renderer::CreateComputeShader(char const* shaderName, char const*
 	return newShader;
 }
 
-VertexBuffer* Renderer::CreateVertexBuffer(const size_t size, const unsigned int stride, const std::string& vboDebugName, bool isTriangleList)
+VertexBuffer* Renderer::CreateVertexBuffer(const size_t size, const unsigned int stride, const std::string& vboDebugName, bool isTriangleList, bool isUpdatedInRanges)
 {
-	VertexBuffer* vertexBuffer = new VertexBuffer(size, stride, isTriangleList);
+	VertexBuffer* vertexBuffer = new VertexBuffer(size, stride, isTriangleList, isUpdatedInRanges);
 	//Create a vertex buffer
 	D3D11_BUFFER_DESC bufferDesc;
 	ZeroMemory(&bufferDesc, sizeof(bufferDesc));
-	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.Usage = isUpdatedInRanges ? D3D11_USAGE_DEFAULT : D3D11_USAGE_DYNAMIC;
 	bufferDesc.ByteWidth = (unsigned int)size;
 	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.CPUAccessFlags = isUpdatedInRanges ? 0 : D3D11_CPU_ACCESS_WRITE;
 	HRESULT hr = m_device->CreateBuffer(&bufferDesc, NULL, &vertexBuffer->m_buffer);
 	if (!SUCCEEDED(hr)) {
 		ERROR_AND_DIE("Could not create vertex buffer");
@@ -1259,8 +1260,15 @@ void Renderer::CopyCPUToGPU(const void* data, size_t size, unsigned int stride,
 		ERROR_AND_DIE("Need to specify your vbo when calling Renderer::CopyCPUToGPU()");
 	}
 	if ((vbo->m_size < size)||(vbo->m_stride != stride)) {
+		bool isTriangleList = vbo->m_isTriangleList;
+		bool isUpdatedInRanges = vbo->m_isUpdatedInRanges;
 		delete vbo;
-		vbo = CreateVertexBuffer(size, stride);
+		vbo = CreateVertexBuffer(size, stride, std::string(""), isTriangleList, isUpdatedInRanges);
+	}
+	if (vbo->m_isUpdatedInRanges) {
+		D3D11_BOX box = { 0, 0, 0, (UINT)size, 1, 1 };
+		m_deviceContext->UpdateSubresource(vbo->m_buffer, 0, &box, data, 0, 0);
+		return;
 	}
 	//Copy vertex buffer data from the CPU to the GPU
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource;
@@ -1269,6 +1277,32 @@ void Renderer::CopyCPUToGPU(const void* data, size_t size, unsigned int stride,
 	m_deviceContext->Unmap(vbo->m_buffer, 0);
 }
 
+void Renderer::CopyCPUToGPU(const void* data, unsigned int stride, const std::vector<IntRange>& elementRanges, VertexBuffer* vbo)
+{
+	if (vbo == nullptr) {
+		ERROR_AND_DIE("Need to specify your vbo when calling Renderer::CopyCPUToGPU()");
+	}
+	if (vbo->m_stride != stride) {
+		ERROR_AND_DIE("Renderer::CopyCPUToGPU() with element ranges can't change the stride of the vbo");
+	}
+	if (!vbo->m_isUpdatedInRanges) {
+		ERROR_AND_DIE("Renderer::CopyCPUToGPU() with element ranges needs a vbo created with isUpdatedInRanges");
+	}
+	if (elementRanges.empty()) {
+		return;
+	}
+	for (const IntRange& elementRange : elementRanges) {
+		if ((elementRange.m_min < 0) || (elementRange.m_min > elementRange.m_max) || ((size_t)(elementRange.m_max + 1) * stride > vbo->m_size)) {
+			ERROR_AND_DIE(Stringf("Element range [%d, %d] is outside the vbo", elementRange.m_min, elementRange.m_max));
+		}
+	}
+	for (const IntRange& elementRange : elementRanges) {
+		size_t byteOffset = (size_t)elementRange.m_min * stride;
+		D3D11_BOX box = { (UINT)byteOffset, 0, 0, (UINT)((size_t)(elementRange.m_max + 1) * stride), 1, 1 };
+		m_deviceContext->UpdateSubresource(vbo->m_buffer, 0, &box, (const unsigned char*)data + byteOffset, 0, 0);
+	}
+}
+
 void Renderer::CopyCPUToGPU(const void* data, size_t size, ConstantBuffer*& cbo)
 {
 	if (cbo == nullptr) {
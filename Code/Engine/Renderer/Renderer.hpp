@@ -34,6 +34,7 @@ class FrameBuffer;
 class StructuredBuffer;
 class ComputeOutputBuffer;
 class ShadowMap;
+struct IntRange;
 
 enum class BlendMode
 {
@@ -122,7 +123,8 @@ public:
 	ComputeShader* CreateOrGetComputeShader(char const* computeShaderPathWithoutExtension);
 	ComputeShader* CreateOrGetPrecompiledComputeShader(char const* precompiledCSPath);
 
-	VertexBuffer* CreateVertexBuffer(const size_t size, const unsigned int stride, const std::string& vboDebugName = std::string(""), bool isTriangleList = true);
+	//isUpdatedInRanges: D3D11_USAGE_DEFAULT instead of DYNAMIC, so the vertex buffer can take the element range CopyCPUToGPU
+	VertexBuffer* CreateVertexBuffer(const size_t size, const unsigned int stride, const std::string& vboDebugName = std::string(""), bool isTriangleList = true, bool isUpdatedInRanges = false);
 	IndexBuffer* CreateIndexBuffer(const size_t size);
 	ConstantBuffer* CreateConstantBuffer(const size_t size);
 	FrameBuffer* CreateFrameBuffer(const char* frameBufferName, const IntVec2& dimensions);
@@ -133,6 +135,9 @@ public:
 	void SetLightConstants(const Vec3& sunDirection = Vec3(0.0f, 0.0f, -1.0f), float sunIntensity = 1.0f, float ambientIntensity = 1.0f, const Vec3& worldEyePosition = Vec3(0.0f, 0.0f, 0.0f), bool hasNormalTexture = true, bool hasSpecularTexture = true, bool hasGlossTexture = true, float specularIntensity = 0.0f, float specularPower = 0.0f);
 	
 	void CopyCPUToGPU(const void* data, size_t size, unsigned int stride, VertexBuffer*& vbo);
+	//Only copies the vertices of elementRanges (m_min through m_max each) to the same place in vbo and keeps the rest of it. vbo has to be created with isUpdatedInRanges.
+	//Every range is an UpdateSubresource with its own box, which the driver orders after the draws already queued, so a draw still reading vbo is safe
+	void CopyCPUToGPU(const void* data, unsigned int stride, const std::vector<IntRange>& elementRanges, VertexBuffer* vbo);
 	void CopyCPUToGPU(const void* data, size_t size, ConstantBuffer*& cbo);
 	void CopyCPUToGPU(const void* data, size_t size, IndexBuffer*& ibo);
 	void CopyCPUToGPU(const void* data, size_t size, unsigned int byteStride, unsigned int numElements, StructuredBuffer*& sbo);
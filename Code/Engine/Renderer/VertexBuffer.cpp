@@ -9,7 +9,8 @@
 #pragma comment (lib, "dxgi.lib")
 #pragma comment (lib, "d3dcompiler.lib")
 
-VertexBuffer::VertexBuffer(size_t size, unsigned int stride, bool isTriangleList): m_size(size), m_stride(stride), m_isTriangleList(isTriangleList)
+VertexBuffer::VertexBuffer(size_t size, unsigned int stride, bool isTriangleList, bool isUpdatedInRanges): m_size(size), m_stride(stride), m_isTriangleList(isTriangleList),
+	m_isUpdatedInRanges(isUpdatedInRanges)
 {
 }
 
@@ -7,7 +7,7 @@ public:
 	unsigned int GetStride() const;
 
 private:
-	VertexBuffer(size_t size, unsigned int stride, bool isTriangleList = true);
+	VertexBuffer(size_t size, unsigned int stride, bool isTriangleList = true, bool isUpdatedInRanges = false);
 	VertexBuffer(const VertexBuffer& copy) = delete;
 
 private:
@@ -15,4 +15,5 @@ private:
 	size_t m_size = 0;
 	unsigned int m_stride = 0;
 	bool m_isTriangleList = true;
+	bool m_isUpdatedInRanges = false;	//D3D11_USAGE_DEFAULT and written with UpdateSubresource instead of mapped
 };
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+//The engine files of this tool include Game/EngineBuildPreferences.hpp like every game's do. Nothing is enabled:
+//no job timing capture and no benchmark commands, there is no dev console to run them from
@@ -0,0 +1,8 @@
+#include "Engine/Fbx/FBXDDMHeadlessBenchmark.hpp"
+
+//No window, renderer or dev console. The options are the ones of RunDDMHeadlessBenchmarkMain as Name=Value, e.g.
+//DDMHeadlessBenchmark Meshes=Limb NumControlPoints=10000 Threads=1,4 Output=DDMHeadlessBenchmark.json
+int main(int argc, char** argv)
+{
+	return RunDDMHeadlessBenchmarkMain(argc, argv);
+}